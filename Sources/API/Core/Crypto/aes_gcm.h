@@ -0,0 +1,102 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2015 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    agent
+*/
+
+
+#pragma once
+
+#include <memory>
+
+namespace clan
+{
+/// \addtogroup clanCore_Crypto clanCore Crypto
+/// \{
+
+class AES_GCM_Impl;
+
+/// \brief AES authenticated encryption class (running in Galois/Counter Mode)
+///
+/// The key size selects AES-128, AES-192 or AES-256. The cipher key is kept until the object is
+/// destroyed, so many messages can be encrypted without expanding the key again.
+class AES_GCM
+{
+/// \name Construction
+/// \{
+
+public:
+	/// \brief Constructs an AES-GCM cipher
+	AES_GCM();
+
+/// \}
+/// \name Operations
+/// \{
+
+public:
+	static const int iv_size = 12;
+	static const int tag_size = 16;
+
+	/// \brief Sets the cipher key
+	///
+	/// \param key = The key
+	/// \param key_size = 16, 24 or 32 bytes
+	void set_key(const unsigned char *key, int key_size);
+
+	/// \brief Encrypts data and calculates the authentication tag
+	///
+	/// \param iv = Initialisation vector. The same iv must never be used twice with the same key
+	/// \param aad = Additional data that is authenticated, but not encrypted
+	/// \param aad_size = Size of the additional data
+	/// \param input = Data to encrypt
+	/// \param output = Encrypted data (may be the same as input)
+	/// \param size = Size of the data
+	/// \param out_tag = Authentication tag
+	void encrypt(const unsigned char iv[iv_size], const void *aad, int aad_size, const void *input, void *output, int size, unsigned char out_tag[tag_size]);
+
+	/// \brief Verifies the authentication tag and decrypts data
+	///
+	/// \param iv = Initialisation vector used for the encryption
+	/// \param aad = Additional data that is authenticated, but not encrypted
+	/// \param aad_size = Size of the additional data
+	/// \param input = Data to decrypt
+	/// \param output = Decrypted data (may be the same as input)
+	/// \param size = Size of the data
+	/// \param tag = Authentication tag
+	/// \return false if the tag does not match. The decrypted data must then be discarded
+	bool decrypt(const unsigned char iv[iv_size], const void *aad, int aad_size, const void *input, void *output, int size, const unsigned char tag[tag_size]);
+
+/// \}
+/// \name Implementation
+/// \{
+
+private:
+	std::shared_ptr<AES_GCM_Impl> impl;
+/// \}
+};
+
+}
+
+/// \}
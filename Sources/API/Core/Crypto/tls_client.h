@@ -32,6 +32,7 @@
 #pragma once
 
 #include <memory>
+#include <string>
 
 namespace clan
 {
@@ -65,6 +66,9 @@ public:
 
 	/// \brief Returns how much encrypted data is available.
 	int get_encrypted_data_available() const;
+
+	/// \brief Returns true if the handshake resumed a previous session, skipping the key exchange.
+	bool is_session_resumed() const;
 /// \}
 
 /// \name Operations
@@ -81,6 +85,15 @@ public:
 
 	/// \brief Marks encrypted data as consumed.
 	void encrypted_data_consumed(int size);
+
+	/// \brief Enables session resumption.
+	///
+	/// Established sessions are kept in a process wide cache, indexed by the server name. Later clients for the
+	/// same server offer the cached session, which lets the server skip the certificate and RSA key exchange.
+	/// This must be called before any data is added.
+	///
+	/// \param server_name = Name identifying the server, for example "host:port"
+	void enable_session_resumption(const std::string &server_name);
 /// \}
 
 /// \name Implementation
@@ -54,6 +54,12 @@ public:
 
 	/// \brief Saves a byte buffer to file.
 	static void write_bytes(const std::string &filename, const DataBuffer &bytes);
+
+	/// \brief Returns the contents of a memory mapped device, or nullptr if the device is not memory mapped.
+	///
+	/// Works for files opened with flag_memory_mapped and for the devices ZipArchive::open_file returns for
+	/// stored entries of a memory mapped archive. The data is valid as long as a copy of the device exists.
+	static const char *get_mapped_data(const IODevice &device);
 /// \}
 
 /// \name Enumerations
@@ -114,7 +120,16 @@ public:
 		flag_write_through   = 1,
 		flag_no_buffering    = 2,
 		flag_random_access   = 4,
-		flag_sequential_scan = 8
+		flag_sequential_scan = 8,
+
+		/// \brief Map the file into memory instead of reading it with system calls.
+		///
+		/// The file must be opened read only with open_existing and access_read. Use get_mapped_data() to access
+		/// the contents without copying them. flag_random_access and flag_sequential_scan are passed on as access hints.
+		flag_memory_mapped   = 16,
+
+		/// \brief Start reading a memory mapped file into memory right away.
+		flag_will_need       = 32
 	};
 
 /// \}
@@ -178,6 +193,12 @@ public:
 /// \{
 
 private:
+	static IODeviceProvider *create_provider(
+		const std::string &filename,
+		OpenMode mode,
+		unsigned int access,
+		unsigned int share,
+		unsigned int flags);
 /// \}
 };
 
@@ -0,0 +1,119 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2015 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    agent
+*/
+
+
+#pragma once
+
+#include "vec2.h"
+#include "vec3.h"
+#include "vec4.h"
+#include "mat3.h"
+#include "mat4.h"
+#include "rect.h"
+#include "aabb.h"
+
+namespace clan
+{
+/// \addtogroup clanCore_Math clanCore Math
+/// \{
+
+/// \brief Math operations on arrays of vectors.
+///
+/// The functions use the widest SIMD instruction set supported by the CPU (SSE2, AVX2 or AVX-512).
+/// Input and output arrays may be the same, but must not otherwise overlap.
+class BatchMath
+{
+/// \name Enumerations
+/// \{
+public:
+	/// \brief Instruction sets used by the functions
+	enum InstructionSet
+	{
+		scalar,
+		sse2,
+		avx2,
+		avx512
+	};
+
+/// \}
+/// \name Attributes
+/// \{
+public:
+	/// \brief Returns the instruction set currently used
+	static InstructionSet get_instruction_set();
+
+	/// \brief Limits the instruction set used, for example to compare them in a benchmark
+	///
+	/// Instruction sets not supported by the CPU are never used. Can be called while other threads use
+	/// the functions; calls already running finish with the instruction set they started with.
+	static void set_max_instruction_set(InstructionSet instruction_set);
+
+/// \}
+/// \name Operations
+/// \{
+public:
+	/// \brief Transforms points as (x, y, 0, 1)
+	///
+	/// \param output_stride = Bytes between the output vectors, allowing them to be written directly into a vertex array
+	static void transform(const Mat4f &matrix, const Vec2f *input, Vec4f *output, int count, int output_stride = sizeof(Vec4f));
+
+	/// \brief Transforms points as (x, y, z, 1)
+	static void transform(const Mat4f &matrix, const Vec3f *input, Vec4f *output, int count, int output_stride = sizeof(Vec4f));
+
+	/// \brief Transforms vectors
+	static void transform(const Mat4f &matrix, const Vec4f *input, Vec4f *output, int count, int output_stride = sizeof(Vec4f));
+
+	/// \brief Transforms points as (x, y, 1), as Mat3f::operator*(Vec2f) does
+	static void transform(const Mat3f &matrix, const Vec2f *input, Vec2f *output, int count);
+
+	/// \brief Transforms vectors
+	static void transform(const Mat3f &matrix, const Vec3f *input, Vec3f *output, int count);
+
+	/// \brief Returns the smallest rectangle containing all points. Returns an empty rectangle if count is 0
+	static Rectf bounding_box(const Vec2f *points, int count);
+
+	/// \brief Returns the smallest box containing all points. Returns an empty box if count is 0
+	static AxisAlignedBoundingBox bounding_box(const Vec3f *points, int count);
+
+	/// \brief Splits points into separate x and y arrays (array of structures to structure of arrays)
+	static void deinterleave(const Vec2f *points, float *out_x, float *out_y, int count);
+
+	/// \brief Splits vectors into separate x, y, z and w arrays
+	static void deinterleave(const Vec4f *vectors, float *out_x, float *out_y, float *out_z, float *out_w, int count);
+
+	/// \brief Joins separate x and y arrays into points (structure of arrays to array of structures)
+	static void interleave(const float *x, const float *y, Vec2f *out_points, int count);
+
+	/// \brief Joins separate x, y, z and w arrays into vectors
+	static void interleave(const float *x, const float *y, const float *z, const float *w, Vec4f *out_vectors, int count);
+/// \}
+};
+
+}
+
+/// \}
@@ -147,11 +147,9 @@ public:
 
 	/// \brief  Compute c = (a ** b) mod m.
 	///
-	/// Uses a standard square-and-multiply
-	/// method with modular reductions at each step. (This is basically the
-	/// same code as expt(), except for the addition of the reductions)
-	///
-	/// The modular reductions are done using Barrett's algorithm (see reduce() for details)
+	/// An odd modulus uses Montgomery multiplication with a sliding window over the exponent bits.
+	/// Other moduli use a standard square-and-multiply method with modular reductions at each step,
+	/// done using Barrett's algorithm (see reduce() for details)
 	void exptmod(const BigInt *b, const BigInt *m, BigInt *c) const;
 
 	/// \brief  Compute c = a (mod m).  Result will always be 0 <= c < m.
@@ -30,6 +30,8 @@
 #pragma once
 
 #include <memory>
+#include <vector>
+#include "delauney_triangulator.h"
 
 namespace clan
 {
@@ -41,6 +43,10 @@ class OutlineTriangulator_Impl;
 /// \brief Polygon Tesselator.
 ///
 /// This class uses constrained delauney triangulation to convert polygon outlines into triangles.
+///
+/// Each contour is closed from its last vertex back to the first. The even-odd rule decides what is
+/// inside, so a contour inside another is a hole regardless of its direction. Edges may touch at their
+/// vertices, but must not cross each other.
 class OutlineTriangulator
 {
 /// \name Construction
@@ -57,6 +63,11 @@ public:
 /// \{
 
 public:
+	/// \brief Returns the vertices of the triangles, with vertices at the same position merged.
+	const std::vector<DelauneyTriangulator_Vertex> &get_vertices() const;
+
+	/// \brief Returns the triangles inside the polygons, in counter-clockwise order.
+	const std::vector<DelauneyTriangulator_Triangle> &get_triangles() const;
 
 /// \}
 /// \name Operations
@@ -73,6 +84,8 @@ public:
 	void next_polygon();
 
 	/// \brief Converts passed polygons into triangles.
+	///
+	/// Throws an exception if two edges of the outlines cross each other.
 	void generate();
 
 /// \}
@@ -54,6 +54,17 @@ public:
 		fail_if_full
 	};
 
+	/// \brief Packing method used within each group.
+	///
+	/// guillotine is the classic binary tree of cuts. skyline_bottom_left is the fastest and
+	/// suits many similarly sized rects such as font glyphs. max_rects packs the tightest.
+	enum PackingMethod
+	{
+		guillotine,
+		skyline_bottom_left,
+		max_rects
+	};
+
 	struct AllocatedRect
 	{
 	public:
@@ -70,7 +81,7 @@ public:
 	RectPacker();
 
 	/// \brief Constructs a rect group.
-	RectPacker(const Size &max_group_size, AllocationPolicy policy = create_new_group);
+	RectPacker(const Size &max_group_size, AllocationPolicy policy = create_new_group, PackingMethod method = guillotine);
 
 	~RectPacker();
 
@@ -87,6 +98,9 @@ public:
 	/// \brief Returns the allocation policy.
 	AllocationPolicy get_allocation_policy() const;
 
+	/// \brief Returns the packing method.
+	PackingMethod get_packing_method() const;
+
 	/// \brief Returns the max group size.
 	Size get_max_group_size() const;
 
@@ -99,6 +113,9 @@ public:
 	/// \brief Returns the amount of rects used by group.
 	int get_group_count() const;
 
+	/// \brief Returns the fraction of a group's area covered by allocated rects.
+	float get_occupancy(unsigned int group_index = 0) const;
+
 /// \}
 /// \name Operations
 /// \{
@@ -109,6 +126,9 @@ public:
 	/// \brief Allocate space for another rect.
 	AllocatedRect add(const Size &size);
 
+	/// \brief Free the space of a rect allocated by add(), so it can be used again.
+	void remove(const AllocatedRect &rect);
+
 /// \}
 /// \name Implementation
 /// \{
@@ -63,68 +63,172 @@ namespace clan
 		virtual ~SlotImpl() { }
 	};
 
-	template<typename SlotImplType>
-	class SignalImpl
+	template<typename FuncType>
+	class SlotCallback;
+
+	/// \brief Callback owned by a signal
+	template<typename R, typename... Args>
+	class SlotCallback<R(Args...)>
 	{
 	public:
-		std::vector<std::weak_ptr<SlotImplType>> slots;
+		SlotCallback() : index(0) { }
+		SlotCallback(const SlotCallback &) = delete;
+		SlotCallback &operator=(const SlotCallback &) = delete;
+		virtual ~SlotCallback() { }
+
+		virtual R invoke(Args... args) = 0;
+
+		size_t index;	// Position in SignalImpl::slots
 	};
 
+	/// \brief Callback storing the function object directly, without a std::function in between
+	template<typename CallbackType, typename FuncType>
+	class SlotCallbackT;
+
+	template<typename CallbackType, typename R, typename... Args>
+	class SlotCallbackT<CallbackType, R(Args...)> : public SlotCallback<R(Args...)>
+	{
+	public:
+		SlotCallbackT(CallbackType callback) : callback(std::move(callback)) { }
+
+		R invoke(Args... args) override { return static_cast<R>(callback(std::forward<Args>(args)...)); }
+
+		CallbackType callback;
+	};
+
+	/// \brief Slot list of a signal
+	///
+	/// Disconnecting clears the entry of the slot and the list is compacted once half of it is empty. Callbacks
+	/// disconnected while the signal is being emitted are destroyed when the emit ends, as one of them may be running.
 	template<typename FuncType>
-	class SlotImplT : public SlotImpl
+	class SignalImpl
 	{
 	public:
-		SlotImplT(const std::weak_ptr<SignalImpl<SlotImplT>> &signal, const std::function<FuncType> &callback) : signal(signal), callback(callback)
+		SignalImpl() : emit_depth(0), removed_count(0) { }
+		SignalImpl(const SignalImpl &) = delete;
+		SignalImpl &operator=(const SignalImpl &) = delete;
+
+		~SignalImpl()
 		{
+			for (auto callback : slots)
+				delete callback;
+			for (auto callback : removed_slots)
+				delete callback;
 		}
 
-		~SlotImplT()
+		void connect(SlotCallback<FuncType> *callback)
 		{
-			std::shared_ptr<SignalImpl<SlotImplT>> sig = signal.lock();
-			if (sig)
+			callback->index = slots.size();
+			slots.push_back(callback);
+		}
+
+		void disconnect(SlotCallback<FuncType> *callback)
+		{
+			slots[callback->index] = nullptr;
+			removed_count++;
+			if (emit_depth > 0)
+			{
+				removed_slots.push_back(callback);
+			}
+			else
+			{
+				delete callback;
+				compact();
+			}
+		}
+
+		void begin_emit()
+		{
+			emit_depth++;
+		}
+
+		void end_emit()
+		{
+			if (--emit_depth == 0 && !removed_slots.empty())
 			{
-				for (auto it = sig->slots.begin(); it != sig->slots.end(); ++it)
+				for (auto callback : removed_slots)
+					delete callback;
+				removed_slots.clear();
+				compact();
+			}
+		}
+
+		std::vector<SlotCallback<FuncType> *> slots;	// nullptr for disconnected slots
+
+	private:
+		void compact()
+		{
+			if (removed_count * 2 <= slots.size())
+				return;
+
+			size_t count = 0;
+			for (auto callback : slots)
+			{
+				if (callback)
 				{
-					// todo: investigate if "it->lock().get() == this" is required
-					if (it->expired() || it->lock().get() == this)
-					{
-						it = sig->slots.erase(it);
-						if (it == sig->slots.end())
-							break;
-					}
+					callback->index = count;
+					slots[count++] = callback;
 				}
 			}
+			slots.resize(count);
+			removed_count = 0;
 		}
 
-		std::weak_ptr<SignalImpl<SlotImplT>> signal;
-		std::function<FuncType> callback;
+		int emit_depth;
+		size_t removed_count;
+		std::vector<SlotCallback<FuncType> *> removed_slots;
+	};
+
+	template<typename FuncType>
+	class SlotImplT : public SlotImpl
+	{
+	public:
+		SlotImplT(const std::weak_ptr<SignalImpl<FuncType>> &signal, SlotCallback<FuncType> *callback) : signal(signal), callback(callback)
+		{
+		}
+
+		~SlotImplT()
+		{
+			std::shared_ptr<SignalImpl<FuncType>> sig = signal.lock();
+			if (sig)
+				sig->disconnect(callback);
+		}
+
+		std::weak_ptr<SignalImpl<FuncType>> signal;
+		SlotCallback<FuncType> *callback;
 	};
 
 	template<typename FuncType>
 	class Signal
 	{
 	public:
-		Signal() : impl(std::make_shared<SignalImpl<SlotImplT<FuncType>>>()) { }
+		Signal() : impl(std::make_shared<SignalImpl<FuncType>>()) { }
 
 		template<typename... Args>
 		void operator()(Args... args)
 		{
-			std::vector<std::weak_ptr<SlotImplT<FuncType>>> slots = impl->slots;
-			for (std::weak_ptr<SlotImplT<FuncType>> &weak_slot : slots)
+			if (impl->slots.empty())
+				return;
+
+			// Keeps the slot list alive in case a callback destroys the signal
+			EmitScope scope(impl);
+
+			// Slots connected by the callbacks are first invoked by the next emit
+			size_t count = scope.signal->slots.size();
+			for (size_t i = 0; i < count; i++)
 			{
-				std::shared_ptr<SlotImplT<FuncType>> slot = weak_slot.lock();
-				if (slot)
-				{
-					slot->callback(args...);
-				}
+				SlotCallback<FuncType> *callback = scope.signal->slots[i];
+				if (callback)
+					callback->invoke(args...);
 			}
 		}
 
-		Slot connect(const std::function<FuncType> &func)
+		template<typename CallbackType>
+		Slot connect(CallbackType func)
 		{
-			auto slot_impl = std::make_shared<SlotImplT<FuncType>>(impl, func);
-			impl->slots.push_back(slot_impl);
-			return Slot(slot_impl);
+			std::unique_ptr<SlotCallback<FuncType>> callback(new SlotCallbackT<CallbackType, FuncType>(std::move(func)));
+			impl->connect(callback.get());
+			return Slot(std::make_shared<SlotImplT<FuncType>>(impl, callback.release()));
 		}
 
 		template<typename InstanceType, typename MemberFuncType>
@@ -134,7 +238,16 @@ namespace clan
 		}
 
 	private:
-		std::shared_ptr<SignalImpl<SlotImplT<FuncType>>> impl;
+		class EmitScope
+		{
+		public:
+			EmitScope(const std::shared_ptr<SignalImpl<FuncType>> &signal) : signal(signal) { signal->begin_emit(); }
+			~EmitScope() { signal->end_emit(); }
+
+			std::shared_ptr<SignalImpl<FuncType>> signal;
+		};
+
+		std::shared_ptr<SignalImpl<FuncType>> impl;
 	};
 
 	class SlotContainer
@@ -0,0 +1,162 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2015 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    agent
+*/
+
+
+#pragma once
+
+#include "cl_platform.h"
+#include <atomic>
+#include <string>
+
+namespace clan
+{
+/// \addtogroup clanCore_System clanCore System
+/// \{
+
+/// \brief Hierarchical CPU profiler
+///
+/// Zones, counters and frame markers are recorded into a ring buffer owned by the calling thread,
+/// so recording never takes a lock. Each thread keeps the most recent events that fit in its buffer.
+/// The buffer of a thread that has exited is reused by a new thread once its events have been exported or cleared.
+///
+/// The profiler is disabled by default. While disabled, recording a zone costs a single relaxed load.
+///
+/// All names passed to the profiler must be string literals or otherwise outlive the profiler data,
+/// as only the pointer is recorded.
+class Profiler
+{
+public:
+	/// \brief Enables or disables recording
+	static void set_enabled(bool enable);
+
+	/// \brief Returns true if events are currently recorded
+	static bool is_enabled() { return enabled.load(std::memory_order_relaxed); }
+
+	/// \brief Sets the number of events kept per thread
+	///
+	/// Applies to threads that record their first event after this call. The size is rounded up to a power of two.
+	static void set_buffer_size(int events_per_thread);
+
+	/// \brief Names the calling thread in the exported trace
+	static void set_thread_name(const std::string &name);
+
+	/// \brief Marks the start of a zone on the calling thread
+	///
+	/// Zones are recorded even if the profiler is disabled. Use cl_profile_zone or ProfilerZone, which check is_enabled once and keep the pair balanced.
+	static void begin_zone(const char *name);
+
+	/// \brief Marks the end of the most recently started zone on the calling thread
+	static void end_zone(const char *name);
+
+	/// \brief Records the current value of a gauge
+	static void set_gauge(const char *name, double value);
+
+	/// \brief Marks the end of a frame
+	static void frame_mark(const char *name = "Frame");
+
+	/// \brief Discards all recorded events
+	static void clear();
+
+	/// \brief Returns the recorded events in the Chrome trace event format
+	///
+	/// The result can be loaded into chrome://tracing or ui.perfetto.dev.
+	static std::string get_chrome_trace();
+
+	/// \brief Saves the recorded events in the Chrome trace event format
+	static void save_chrome_trace(const std::string &filename);
+
+private:
+	static std::atomic<bool> enabled;
+};
+
+/// \brief Profiler zone covering the lifetime of the object
+class ProfilerZone
+{
+public:
+	ProfilerZone(const char *name) : name(Profiler::is_enabled() ? name : nullptr)
+	{
+		if (this->name)
+			Profiler::begin_zone(name);
+	}
+
+	~ProfilerZone()
+	{
+		if (name)
+			Profiler::end_zone(name);
+	}
+
+private:
+	ProfilerZone(const ProfilerZone &) = delete;
+	ProfilerZone &operator=(const ProfilerZone &) = delete;
+
+	const char *name;
+};
+
+/// \brief Counter recorded by the profiler
+///
+/// The value is kept even while the profiler is disabled. Each change is recorded as a counter event while it is enabled.
+class ProfilerCounter
+{
+public:
+	ProfilerCounter(const char *name) : name(name), value(0) { }
+
+	/// \brief Adds to the counter value
+	void add(byte64 amount = 1)
+	{
+		byte64 new_value = value.fetch_add(amount, std::memory_order_relaxed) + amount;
+		if (Profiler::is_enabled())
+			Profiler::set_gauge(name, (double) new_value);
+	}
+
+	/// \brief Returns the counter value
+	byte64 get() const { return value.load(std::memory_order_relaxed); }
+
+	/// \brief Returns the counter name
+	const char *get_name() const { return name; }
+
+private:
+	const char *name;
+	std::atomic<byte64> value;
+};
+
+#define cl_profile_concat_impl(a, b) a##b
+#define cl_profile_concat(a, b) cl_profile_concat_impl(a, b)
+
+#ifndef CL_DISABLE_PROFILER
+/// \brief Records a profiler zone from this line to the end of the enclosing scope
+#define cl_profile_zone(name) clan::ProfilerZone cl_profile_concat(cl_profile_zone_, __LINE__)(name)
+#else
+#define cl_profile_zone(name)
+#endif
+
+/// \brief Records a profiler zone named after the enclosing function
+#define cl_profile_function() cl_profile_zone(__FUNCTION__)
+
+}
+
+/// \}
@@ -54,7 +54,10 @@ public:
 	/// \brief Get the current time microseconds.
 	static ubyte64 get_microseconds();
 
-    enum CPU_ExtensionX86 { mmx, mmx_ex, _3d_now, _3d_now_ex, sse, sse2, sse3, ssse3, sse4_a, sse4_1, sse4_2, xop, avx, aes, fma3, fma4 };
+	/// \brief Get the current time in nanoseconds, from a monotonic clock.
+	static ubyte64 get_nanoseconds();
+
+    enum CPU_ExtensionX86 { mmx, mmx_ex, _3d_now, _3d_now_ex, sse, sse2, sse3, ssse3, sse4_a, sse4_1, sse4_2, xop, avx, aes, fma3, fma4, sha, pclmulqdq, avx2, avx512f };
     enum CPU_ExtensionPPC { altivec };
 
     static bool detect_cpu_extension(CPU_ExtensionX86 ext);
@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include "cl_platform.h"
 #include <memory>
 #include <functional>
 
@@ -68,6 +69,12 @@ public:
 	/// \brief Starts the timer. Timeout in milliseconds.
 	void start(unsigned int timeout, bool repeat=true);
 
+	/// \brief Starts the timer. Timeout in microseconds.
+	///
+	/// Timers are tracked with a resolution of 0.1 milliseconds on a monotonic clock. The callback is invoked from
+	/// KeepAlive::process, so how soon after the timeout it runs also depends on how often that is called.
+	void start_microseconds(ubyte64 timeout, bool repeat=true);
+
 	/// \brief Stop the timer.
 	void stop();
 /// \}
@@ -0,0 +1,121 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2015 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    agent
+*/
+
+
+#pragma once
+
+#include "logger.h"
+#include "../IOData/iodevice.h"
+#include <memory>
+
+namespace clan
+{
+/// \addtogroup clanCore_Text clanCore Text
+/// \{
+
+class AsyncLogger_Impl;
+
+/// \brief Logger writing from a background thread.
+///
+/// log_event hands the text to an async logger without taking Logger::mutex. Each thread queues its records
+/// into its own bounded queue, and a writer thread formats the timestamps and writes the records in large blocks.
+///
+/// Records from one thread are written in order. Records from different threads are written in the order
+/// the writer collects them, which may differ from the order they were logged in by up to the flush interval.
+class AsyncLogger : public Logger
+{
+/// \name Construction
+/// \{
+
+public:
+	/// \brief What log calls do when the queue of the calling thread is full
+	enum OverflowPolicy
+	{
+		/// \brief Discard the record. The writer logs how many records were dropped.
+		overflow_drop,
+
+		/// \brief Wait until the writer has made room
+		overflow_block
+	};
+
+	/// \brief Constructs an async logger appending to a file.
+	///
+	/// \param filename = File to append to
+	/// \param policy = What to do when a queue is full
+	/// \param queue_size = Number of records each thread can queue
+	/// \param flush_interval = Milliseconds between writes when the queues are not filling up
+	AsyncLogger(const std::string &filename, OverflowPolicy policy = overflow_drop, int queue_size = 1024, int flush_interval = 50);
+
+	/// \brief Constructs an async logger writing to a device.
+	AsyncLogger(IODevice device, OverflowPolicy policy = overflow_drop, int queue_size = 1024, int flush_interval = 50);
+
+	/// \brief Writes the queued records and stops the writer thread.
+	~AsyncLogger();
+
+/// \}
+/// \name Attributes
+/// \{
+
+public:
+	/// \brief Returns the number of records discarded because a queue was full
+	int get_dropped_count() const;
+
+/// \}
+/// \name Operations
+/// \{
+
+public:
+	/// \brief Enable logger for logging.
+	///
+	/// Hides Logger::enable, which is not virtual. Calling that one through a Logger reference makes log_event
+	/// reach this logger through Logger::mutex as well.
+	void enable();
+
+	/// \brief Disable logging.
+	///
+	/// Waits for log_event calls on other threads that may still be using the logger.
+	void disable();
+
+	/// \brief Queue text for logging.
+	void log(const std::string &type, const std::string &text) override;
+
+	/// \brief Waits until everything logged before the call has been written.
+	void flush();
+
+/// \}
+/// \name Implementation
+/// \{
+
+private:
+	std::shared_ptr<AsyncLogger_Impl> impl;
+/// \}
+};
+
+}
+
+/// \}
@@ -87,6 +87,7 @@ protected:
 
 /// \brief Log text to logger.
 ///
+/// Async loggers are called without taking Logger::mutex. The mutex is only taken if other loggers are enabled.
 void log_event(const std::string &type, const std::string &text);
 
 template <class Arg1>
@@ -62,7 +62,10 @@ public:
 	/// \brief Constructs a ZipArchive
 	///
 	/// \param filename = String Ref
-	ZipArchive(const std::string &filename);
+	/// \param memory_mapped = Map the archive into memory, so stored entries are returned without copying them.
+	///                        Falls back to regular file access if the archive cannot be mapped. The archive file
+	///                        must not be truncated or rewritten while it is mapped.
+	ZipArchive(const std::string &filename, bool memory_mapped = false);
 
 	/// \brief Constructs a ZipArchive
 	///
@@ -116,7 +119,7 @@ public:
 
 	/// \brief Save
 	///
-	/// \param filename = the filename to save to
+	/// \param filename = the filename to save to. Throws if it is the archive this object has memory mapped.
 	void save(const std::string &filename);
 
 	/// \brief Save
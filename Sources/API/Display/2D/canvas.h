@@ -424,6 +424,7 @@ private:
 	friend class Font_DrawSubPixel;
 	friend class Font_DrawFlat;
 	friend class Font_DrawScaled;
+	friend class Font_DrawSDF;
 	friend class Path;
 /// \}
 };
@@ -31,6 +31,7 @@
 #pragma once
 
 #include <memory>
+#include "../../Core/Math/rect_packer.h"
 
 namespace clan
 {
@@ -65,7 +66,10 @@ public:
 	TextureGroup();
 
 	/// \brief Constructs a texture group
-	TextureGroup(const Size &texture_sizes);
+	///
+	/// \param texture_sizes = Size of the textures created by the group
+	/// \param method = How sub-textures are packed into each texture
+	TextureGroup(const Size &texture_sizes, RectPacker::PackingMethod method = RectPacker::guillotine);
 
 	~TextureGroup();
 
@@ -109,7 +113,7 @@ public:
 	///
 	/// Warning - It is advised to set TextureAllocationPolicy to search_previous_textures
 	/// if using this function.  Also be aware of texture fragmentation.
-	/// Empty textures are not removed.
+	/// Textures left empty are removed from the group.
 	void remove(Subtexture &subtexture);
 
 	/// \brief Set the texture allocation policy.
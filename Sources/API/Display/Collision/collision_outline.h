@@ -171,6 +171,9 @@ public:
 	bool get_inside_test() const;
 
 	/// \brief Returns the contours in the outline.
+	///
+	/// Translations are applied to the contour points lazily; both versions bring the points up to date.
+	/// The non-const version also flags the cached collision data for rebuilding, since the points may be modified.
 	std::vector<Contour> &get_contours();
 	const std::vector<Contour> &get_contours() const;
 
@@ -334,6 +337,9 @@ public:
 /// \{
 private:
 	std::shared_ptr<CollisionOutline_Impl> impl;
+
+	friend class CollisionOutline_Impl;
+	friend class CollisionWorld_Impl;
 /// \}
 };
 
@@ -0,0 +1,127 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2015 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    agent
+*/
+
+#pragma once
+
+#include <vector>
+#include <memory>
+#include "collision_outline.h"
+
+namespace clan
+{
+/// \addtogroup clanDisplay_Collision clanDisplay Collision
+/// \{
+
+class CollisionWorld_Impl;
+
+/// \brief Pair of outline handles returned by CollisionWorld
+struct CollisionWorldPair
+{
+	CollisionWorldPair() : outline1(0), outline2(0) { }
+	CollisionWorldPair(int outline1, int outline2) : outline1(outline1), outline2(outline2) { }
+
+	int outline1;
+	int outline2;
+};
+
+/// \brief Broadphase for a large set of collision outlines.
+///
+/// <p>Outlines are kept in a uniform grid based on their minimum enclosing disc. Only outlines that
+///    were translated, rotated or scaled since the last update are moved to new cells. Candidate
+///    pairs are outlines with overlapping discs, which can then be tested with CollisionOutline::collide.</p>
+class CollisionWorld
+{
+/// \name Construction
+/// \{
+
+public:
+	/// \brief Constructs a collision world
+	///
+	/// \param cell_size = Width and height of a grid cell. Should be around the diameter of a typical outline.
+	CollisionWorld(float cell_size = 64.0f);
+
+	~CollisionWorld();
+
+/// \}
+/// \name Attributes
+/// \{
+
+public:
+	/// \brief Returns the width and height of a grid cell
+	float get_cell_size() const;
+
+	/// \brief Returns the number of outlines in the world
+	int get_outline_count() const;
+
+	/// \brief Returns the outline for a handle returned by add
+	CollisionOutline &get_outline(int handle);
+
+/// \}
+/// \name Operations
+/// \{
+
+public:
+	/// \brief Adds an outline to the world
+	///
+	/// The outline shares its state with the passed outline, so moving either one moves the outline in the world.
+	/// \return Handle used to identify the outline
+	int add(const CollisionOutline &outline);
+
+	/// \brief Removes an outline from the world
+	void remove(int handle);
+
+	/// \brief Removes all outlines
+	void clear();
+
+	/// \brief Updates the grid cells of the outlines changed since the last update
+	void update();
+
+	/// \brief Returns the pairs of outlines where the minimum enclosing discs overlap
+	///
+	/// Calls update first. Each pair is only reported once.
+	const std::vector<CollisionWorldPair> &find_candidate_pairs();
+
+	/// \brief Returns the pairs of outlines that collide
+	///
+	/// Runs CollisionOutline::collide on the candidate pairs. Pairs are tested on multiple threads, except
+	/// pairs where the first outline collects collision info.
+	/// \param num_threads = Threads to use, including the calling thread. 0 uses one per core. The other threads come from a work queue owned by the world.
+	const std::vector<CollisionWorldPair> &find_colliding_pairs(int num_threads = 0);
+
+/// \}
+/// \name Implementation
+/// \{
+
+private:
+	std::shared_ptr<CollisionWorld_Impl> impl;
+/// \}
+};
+
+}
+
+/// \}
@@ -133,6 +133,12 @@ public:
 	/// All font sizes are scalable when using sprite fonts
 	void set_scalable(float height_threshold = 32.0f);
 
+	/// \brief Draw the font using signed distance field glyphs
+	///
+	/// The distance field atlas is shared between all sizes of the font face, so zooming text does not create new glyph caches.
+	/// Requires a GLSL target. Other targets draw the glyphs as paths
+	void set_distance_field(bool enable = true);
+
 	/// \brief Print text 
 	///
 	/// \param canvas = Canvas
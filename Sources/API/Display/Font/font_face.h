@@ -72,6 +72,9 @@ public:
 	/// \brief Font family name used for this font face
 	const std::string &get_family_name() const;
 
+	/// \brief Returns the texture memory (in bytes) used by the glyph caches of this font face
+	int get_texture_memory_usage() const;
+
 /// \}
 /// \name Operations
 /// \{
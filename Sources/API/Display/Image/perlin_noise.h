@@ -40,8 +40,20 @@ namespace clan
 class PerlinNoise_Impl;
 
 /// \brief Perlin Noise Generator class
+///
+/// Large images are generated in blocks of rows on a thread pool. 2D and 3D perlin noise use SSE2 or AVX2 when available.
 class PerlinNoise
 {
+public:
+	/// \brief Noise function used by the create functions
+	enum NoiseType
+	{
+		/// \brief Classic gradient noise, sampling the 2^n corners of a grid cell
+		perlin,
+
+		/// \brief Simplex noise, sampling the n+1 corners of a simplex. Has fewer axis aligned artifacts
+		simplex
+	};
 
 /// \name Construction
 /// \{
@@ -114,6 +126,9 @@ public:
 	/// \brief Get the number of octaves of the perlin noise
 	int get_octaves() const;
 
+	/// \brief Get the noise function used
+	NoiseType get_noise_type() const;
+
 /// \name Operations
 /// \{
 
@@ -144,7 +159,9 @@ public:
 	/// \brief Set the format of the output pixelbuffer
 	///
 	/// If this function is not used, the format defaults to tf_rgb8\n
-	/// These following formats are supported:\n
+	/// All uncompressed formats are supported. Float and snorm formats receive the noise value as is,
+	/// the other normalized formats map -1 to 1 into 0 to 1 and integer formats map it into 0 to 255.\n
+	/// These following formats are written without conversion:\n
 	///		tf_rgba8, tf_rgb8, tf_r8, tf_r32f
 	///
 	/// \param format = The specified format
@@ -164,6 +181,13 @@ public:
 	/// \param octaves = The number of octaves to set
 	void set_octaves(int octaves = 1);
 
+	/// \brief Set the noise function
+	///
+	/// If this function is not used, the noise type defaults to perlin
+	///
+	/// \param noise_type = The noise function to use
+	void set_noise_type(NoiseType noise_type = perlin);
+
 /// \}
 /// \name Implementation
 /// \{
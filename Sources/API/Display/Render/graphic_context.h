@@ -241,7 +241,8 @@ enum StandardProgram
 	program_color_only,
 	program_single_texture,
 	program_sprite,
-	program_path
+	program_path,
+	program_sdf_glyph
 };
 
 /// \brief Shader language used
@@ -55,6 +55,33 @@ public:
 	virtual Resource<Texture> get_texture(GraphicContext &gc, const std::string &id) = 0;
 	virtual Resource<Font> get_font(Canvas &canvas, const FontDescription &desc) = 0;
 
+	/// \brief Starts loading a sprite in the background
+	///
+	/// The returned resource is set by process_async_loads when the sprite has been loaded. Use Resource::updated
+	/// to find out when that has happened. Requests for a resource already being loaded share the same load.
+	/// The default implementation loads the sprite immediately.
+	virtual Resource<Sprite> get_sprite_async(Canvas &canvas, const std::string &id);
+
+	/// \brief Starts loading an image in the background
+	virtual Resource<Image> get_image_async(Canvas &canvas, const std::string &id);
+
+	/// \brief Starts loading a texture in the background
+	virtual Resource<Texture> get_texture_async(GraphicContext &gc, const std::string &id);
+
+	/// \brief Starts loading all sprites, images and textures in a resource section and its subsections
+	///
+	/// Once loaded, get_sprite, get_image and get_texture return them from the cache.
+	virtual void prefetch_section(Canvas &canvas, const std::string &section);
+
+	/// \brief Creates the textures of resources loaded in the background and completes their resources
+	///
+	/// Call this once per frame on the rendering thread. Work stops when the time budget is used up, but at
+	/// least one texture or resource is completed per call. Errors from loading a resource are thrown here.
+	///
+	/// \param time_budget = Microseconds to spend
+	/// \return Number of resources still loading
+	virtual int process_async_loads(int time_budget);
+
 	static DisplayCache &get(const ResourceManager &resources);
 	static void set(ResourceManager &resources, const std::shared_ptr<DisplayCache> &cache);
 };
@@ -31,6 +31,8 @@
 
 #include <memory>
 #include <vector>
+#include <string>
+#include <functional>
 
 namespace clan
 {
@@ -39,9 +41,14 @@ namespace clan
 
 class DNSResourceRecord;
 class DNSPacket;
+class SocketName;
 class DNSResolver_Impl;
 
 /// \brief DNS resolver.
+///
+/// Answers are cached for the time to live given by the DNS server, and names that do not exist
+/// are cached for the negative time to live of their zone. Lookups of a name and type that is
+/// already being resolved wait for the outstanding query instead of sending another one.
 class DNSResolver
 {
 /// \name Construction
@@ -57,17 +64,45 @@ public:
 /// \{
 
 public:
+	/// \brief Returns the DNS servers used by lookup_resource
+	std::vector<SocketName> get_dns_servers() const;
 
 /// \}
 /// \name Operations
 /// \{
 
 public:
+	/// \brief Function called when lookup_resource_async completes
+	///
+	/// On failure the records are empty and error holds the message lookup_resource would have thrown.
+	typedef std::function<void(const std::vector<DNSResourceRecord> &records, const std::string &error)> LookupCallback;
+
+	/// \brief Function called when lookup_addresses_async completes
+	typedef std::function<void(const std::vector<std::string> &addresses, const std::string &error)> AddressesCallback;
+
 	std::vector<DNSResourceRecord> lookup_resource(
 		const std::string &domain_name,
 		const std::string &resource_type,
 		int timeout);
 
+	/// \brief Looks up resource records without blocking
+	///
+	/// The callback is invoked on the resolver thread, or before this function returns if the answer is cached.
+	void lookup_resource_async(
+		const std::string &domain_name,
+		const std::string &resource_type,
+		int timeout,
+		const LookupCallback &callback);
+
+	/// \brief Looks up the IPv4 and IPv6 addresses of a host
+	///
+	/// The A and AAAA queries are sent in parallel. IPv4 addresses are listed first.
+	/// An exception is only thrown if both lookups fail.
+	std::vector<std::string> lookup_addresses(const std::string &domain_name, int timeout);
+
+	/// \brief Looks up the IPv4 and IPv6 addresses of a host without blocking
+	void lookup_addresses_async(const std::string &domain_name, int timeout, const AddressesCallback &callback);
+
 	DNSPacket perform_query(
 		DNSPacket &packet,
 		int timeout,
@@ -79,6 +114,12 @@ public:
 		int timeout,
 		const std::string &dns_server_name);
 
+	/// \brief Replaces the DNS servers found in the system settings
+	void set_dns_servers(const std::vector<SocketName> &dns_servers);
+
+	/// \brief Removes all cached answers
+	void clear_cache();
+
 /// \}
 /// \name Implementation
 /// \{
@@ -155,6 +155,11 @@ public:
 	/// \return a_address_str
 	std::string get_a_address_str() const;
 
+	/// \brief Get AAAA address str
+	///
+	/// \return IPv6 address in the usual text form, for example 2001:db8::1
+	std::string get_aaaa_address_str() const;
+
 	unsigned int get_wks_address() const;
 
 	/// \brief Get Wks address str
@@ -38,6 +38,27 @@ namespace clan
 
 class SocketName;
 class Event;
+class File;
+class DataBuffer;
+
+/// \brief Buffer sent or received by the vectored TCPConnection::send and TCPConnection::receive.
+class SocketBuffer
+{
+public:
+	SocketBuffer() : data(nullptr), size(0) { }
+
+	/// \brief Constructs a SocketBuffer
+	///
+	/// \param data = Buffer to send or receive into
+	/// \param size = Size of the buffer
+	SocketBuffer(const void *data, int size) : data(const_cast<void *>(data)), size(size) { }
+
+	/// \brief Buffer data
+	void *data;
+
+	/// \brief Size of the buffer in bytes
+	int size;
+};
 
 /// \brief TCP connection socket I/O device.
 class TCPConnection : public IODevice
@@ -98,6 +119,9 @@ public:
 	/// \return write_event
 	Event get_write_event();
 
+	/// \brief Returns true if large sends are transmitted without copying (MSG_ZEROCOPY)
+	bool is_zero_copy_enabled() const;
+
 /// \}
 /// \name Operations
 /// \{
@@ -139,6 +163,55 @@ public:
 	/// Both timeout and interval must be set to a non-zero value before any of them are used.  They cannot be specified individually.
 	void set_keep_alive(bool enable, int timeout = 0, int interval = 0);
 
+	/// \brief Sends several buffers with a single system call (writev)
+	///
+	/// \param buffers = Buffers to send, in order
+	/// \param count = Number of buffers
+	/// \param send_all = Wait until all buffers have been sent
+	/// \return Total bytes sent
+	int send(const SocketBuffer *buffers, int count, bool send_all = true);
+	using IODevice::send;
+
+	/// \brief Receives into several buffers with a single system call (readv)
+	///
+	/// \param buffers = Buffers to fill, in order
+	/// \param count = Number of buffers
+	/// \param receive_all = Wait until all buffers have been filled
+	/// \return Total bytes received
+	int receive(const SocketBuffer *buffers, int count, bool receive_all = true);
+	using IODevice::receive;
+
+	/// \brief Sends part of a file without copying it through user memory (sendfile)
+	///
+	/// The position of the file is not changed. Falls back to reading and sending the file
+	/// where the platform has no sendfile.
+	///
+	/// \param file = File opened for reading
+	/// \param offset = Position in the file to start from
+	/// \param length = Bytes to send
+	/// \return Bytes sent
+	int send_file(File &file, int offset, int length);
+
+	/// \brief Sends a buffer without copying it into the kernel, if zero-copy is enabled
+	///
+	/// The connection keeps a reference to the buffer until the kernel has transmitted it, so its
+	/// contents must not be modified after the call. Released buffers are collected by later sends,
+	/// and disconnect_graceful waits for the remaining ones.
+	///
+	/// \param buffer = Data to send
+	/// \param send_all = Wait until all data has been sent
+	/// \return Bytes sent
+	int send_zero_copy(const DataBuffer &buffer, bool send_all = true);
+
+	/// \brief Enables sending large buffers without copying them into the kernel (MSG_ZEROCOPY)
+	///
+	/// Only send_zero_copy uses it, and only for at least 16 KB, as pinning the pages costs more
+	/// than copying smaller buffers. The other send functions always copy, so their buffers can be
+	/// reused as soon as they return.
+	///
+	/// \return false if the platform does not support it
+	bool set_zero_copy(bool enable);
+
 /// \}
 /// \name Implementation
 /// \{
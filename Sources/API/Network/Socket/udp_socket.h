@@ -40,6 +40,53 @@ class Event;
 class SocketName;
 class UDPSocket_Impl;
 
+/// \brief Datagram sent or received by UDPSocket::send_batch and UDPSocket::receive_batch.
+///
+/// The address is kept as a raw IPv4 address and port, so batches can be moved without
+/// creating a SocketName for every datagram.
+class UDPPacket
+{
+public:
+	UDPPacket() : data(nullptr), size(0), capacity(0), address(0), port(0), segment_size(0) { }
+
+	/// \brief Constructs a UDPPacket
+	///
+	/// \param data = Buffer for the datagram
+	/// \param size = Bytes to send from the buffer
+	/// \param capacity = Size of the buffer
+	UDPPacket(void *data, int size, int capacity) : data(data), size(size), capacity(capacity), address(0), port(0), segment_size(0) { }
+
+	/// \brief Get the address and port as a socket name
+	SocketName get_name() const;
+
+	/// \brief Set the address and port from a socket name
+	///
+	/// Host names are looked up, so do this once per destination and copy the address and port after that.
+	void set_name(const SocketName &name);
+
+	/// \brief Buffer holding the datagram
+	void *data;
+
+	/// \brief Bytes to send, or bytes received
+	int size;
+
+	/// \brief Size of the buffer when receiving
+	int capacity;
+
+	/// \brief IPv4 address in host byte order
+	unsigned int address;
+
+	/// \brief Port in host byte order
+	unsigned short port;
+
+	/// \brief Size of each datagram when several are sent or received as one large buffer
+	///
+	/// When sending, a non-zero value makes the kernel split the buffer into datagrams of this size
+	/// (UDP segmentation offload). When receiving with set_receive_coalescing enabled, it is the size
+	/// of the datagrams that were merged into the buffer, or 0 if the buffer holds a single datagram.
+	int segment_size;
+};
+
 /// \brief UDP socket.
 class UDPSocket
 {
@@ -89,6 +136,9 @@ public:
 	/// \return write_event
 	Event get_write_event();
 
+	/// \brief Returns true if send_batch can use UDPPacket::segment_size on this socket
+	bool is_segmentation_offload_supported() const;
+
 /// \}
 /// \name Operations
 /// \{
@@ -107,6 +157,22 @@ public:
 	/// \param close_socket = bool
 	void set_handle(int socket, bool close_socket);
 
+	/// \brief Allows several sockets to bind the same address and port (SO_REUSEPORT)
+	///
+	/// The kernel spreads the incoming datagrams between the sockets by source address, so each
+	/// socket can be read by its own thread. Call before bind on every socket sharing the port.
+	///
+	/// \return false if the platform does not support it
+	bool set_reuse_port(bool enable);
+
+	/// \brief Lets the kernel merge datagrams from the same sender into one received buffer (UDP GRO)
+	///
+	/// The merged datagrams all have the size given by UDPPacket::segment_size, except the last one
+	/// which may be shorter. Only receive_batch reports the segment size, so give its packets 64 KB buffers.
+	///
+	/// \return false if the platform does not support it
+	bool set_receive_coalescing(bool enable);
+
 	/// \brief Send
 	///
 	/// \param data = void
@@ -134,6 +200,22 @@ public:
 	/// \return int
 	int peek(void *data, int len, SocketName &out_from);
 
+	/// \brief Sends several datagrams, using a single system call where the platform allows it
+	///
+	/// \param packets = Datagrams to send. The address, port, data and size of each must be set.
+	/// \param count = Number of packets
+	///
+	/// \return Number of packets sent. Less than count if the socket send buffer is full.
+	int send_batch(const UDPPacket *packets, int count);
+
+	/// \brief Receives the datagrams waiting on the socket, using a single system call where the platform allows it
+	///
+	/// \param packets = Packets with data and capacity set. Size, address, port and segment size are filled in.
+	/// \param count = Number of packets
+	///
+	/// \return Number of packets received, 0 if no datagrams are waiting
+	int receive_batch(UDPPacket *packets, int count);
+
 /// \}
 /// \name Implementation
 /// \{
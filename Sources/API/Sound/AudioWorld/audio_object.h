@@ -57,11 +57,18 @@ public:
 	bool is_ambience() const;
 	bool is_playing() const;
 
+	/// \brief Returns true if the object is playing as a virtual voice (not mixed)
+	bool is_virtual() const;
+
+	/// \brief Returns the priority multiplied with the audible volume when selecting real voices
+	float get_priority() const;
+
 	void set_position(const Vec3f &position);
 
 	void set_attenuation_begin(float distance);
 	void set_attenuation_end(float distance);
 	void set_volume(float volume);
+	void set_priority(float priority);
 
 	void set_sound(const std::string &id);
 	void set_sound(const SoundBuffer &buffer);
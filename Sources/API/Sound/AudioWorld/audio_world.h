@@ -39,13 +39,54 @@ class ResourceManager;
 class SoundBuffer;
 class AudioWorld_Impl;
 
+/// \brief Voice statistics from the last AudioWorld::update
+class AudioWorldStats
+{
+public:
+	AudioWorldStats() : real_voices(0), virtual_voices(0), promoted_voices(0), demoted_voices(0), mixed_samples_per_second(0), update_time(0) { }
+
+	/// \brief Playing objects with a sound session being mixed
+	int real_voices;
+
+	/// \brief Playing objects that only advance their play position
+	int virtual_voices;
+
+	/// \brief Voices that went from virtual to real in the update
+	int promoted_voices;
+
+	/// \brief Voices that went from real to virtual in the update
+	int demoted_voices;
+
+	/// \brief Source samples the mixer has to resample per second for the real voices (an estimate of the mixing cost)
+	int mixed_samples_per_second;
+
+	/// \brief Time spent in AudioWorld::update, in microseconds
+	int update_time;
+};
+
 class AudioWorld
 {
 public:
 	AudioWorld(const ResourceManager &resources);
 
+	/// \brief Updates volume and panning, and decides which playing objects get a real voice
+	///
+	/// The most audible objects (volume after attenuation multiplied by priority) up to the real
+	/// voice budget are mixed. The others become virtual voices that only advance their play
+	/// position, and are promoted back at that position once they are among the most audible again.
 	void update();
 
+	/// \brief Sets the maximum number of objects mixed at the same time
+	void set_max_real_voices(int count);
+	int get_max_real_voices() const;
+
+	/// \brief Sets the volume below which an object is always a virtual voice
+	void set_audibility_threshold(float volume);
+	float get_audibility_threshold() const;
+
+	/// \brief Returns the voice statistics from the last update
+	AudioWorldStats get_stats() const;
+
 	void set_listener(const Vec3f &position, const Quaternionf &orientation);
 
 	void enable_ambience(bool enable);
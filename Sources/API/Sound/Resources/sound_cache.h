@@ -47,6 +47,13 @@ public:
 	virtual ~SoundCache() { }
 	virtual Resource<SoundBuffer> get_sound(const std::string &id) = 0;
 
+	/// \brief Starts loading a sound in the background
+	///
+	/// The returned resource is set from KeepAlive::process on the thread that created the cache when the sound
+	/// has been loaded. Use Resource::updated to find out when that has happened. The default implementation
+	/// loads the sound immediately.
+	virtual Resource<SoundBuffer> get_sound_async(const std::string &id);
+
 	static SoundCache &get(const ResourceManager &resources);
 	static void set(ResourceManager &resources, const std::shared_ptr<SoundCache> &cache);
 };
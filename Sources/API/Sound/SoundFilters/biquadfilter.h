@@ -0,0 +1,106 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2015 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    agent
+*/
+
+
+#pragma once
+
+#include "../soundfilter.h"
+
+namespace clan
+{
+/// \addtogroup clanSound_Filters clanSound Filters
+/// \{
+
+class BiquadFilterProvider;
+
+/// \brief Biquad filter response types
+enum BiquadFilterType
+{
+	biquad_lowpass,
+	biquad_highpass
+};
+
+/// \brief Biquad Filter Class
+///
+/// Second order low-pass or high-pass filter (as in the Audio EQ Cookbook), for muffling sounds behind walls or
+/// removing rumble from distant emitters.
+class BiquadFilter : public SoundFilter
+{
+/// \name Construction
+/// \{
+
+public:
+	/// \brief Biquad Filter Constructor
+	///
+	/// \param type = Low-pass or high-pass response
+	/// \param cutoff_frequency = Cutoff frequency in Hz
+	/// \param q = Resonance. 0.7071 gives a Butterworth response without a peak.
+	/// \param mixing_frequency = Frequency of the sound output the filter is used with
+	BiquadFilter(BiquadFilterType type, float cutoff_frequency, float q = 0.7071f, int mixing_frequency = 44100);
+
+	/// \brief Biquad Filter Destructor
+	virtual ~BiquadFilter();
+
+/// \}
+/// \name Attributes
+/// \{
+
+public:
+	/// \brief Returns the response type
+	BiquadFilterType get_type() const;
+
+	/// \brief Returns the cutoff frequency in Hz
+	float get_cutoff_frequency() const;
+
+	/// \brief Returns the resonance
+	float get_q() const;
+
+/// \}
+/// \name Operations
+/// \{
+
+public:
+	/// \brief Retrieves the provider.
+	BiquadFilterProvider *get_provider() const;
+
+	/// \brief Changes the response of the filter.
+	///
+	/// The filter state is kept, so the cutoff can be moved while a sound is playing.
+	void set_response(BiquadFilterType type, float cutoff_frequency, float q = 0.7071f);
+
+/// \}
+/// \name Implementation
+/// \{
+
+private:
+/// \}
+};
+
+}
+
+/// \}
@@ -0,0 +1,96 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2015 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    agent
+*/
+
+
+#pragma once
+
+#include "../soundfilter.h"
+#include <vector>
+
+namespace clan
+{
+/// \addtogroup clanSound_Filters clanSound Filters
+/// \{
+
+class ConvolutionReverbFilterProvider;
+
+/// \brief Convolution Reverb Filter Class
+///
+/// Convolves the sound with an impulse response recorded in (or generated for) a room. The impulse response is
+/// split into partitions that are convolved in the frequency domain, so long impulse responses stay affordable.
+/// The reverberated signal is delayed by one partition.
+class ConvolutionReverbFilter : public SoundFilter
+{
+/// \name Construction
+/// \{
+
+public:
+	/// \brief Convolution Reverb Filter Constructor
+	///
+	/// \param impulse_response = Impulse response at the mixing frequency, applied to every channel
+	/// \param wet = Volume of the reverberated signal
+	/// \param dry = Volume of the original signal
+	/// \param partition_size = Samples per partition (power of two). Larger partitions are faster but add latency.
+	ConvolutionReverbFilter(const std::vector<float> &impulse_response, float wet = 0.3f, float dry = 1.0f, int partition_size = 512);
+
+	/// \brief Convolution Reverb Filter Destructor
+	virtual ~ConvolutionReverbFilter();
+
+/// \}
+/// \name Attributes
+/// \{
+
+public:
+	/// \brief Returns the volume of the reverberated signal
+	float get_wet() const;
+
+	/// \brief Returns the volume of the original signal
+	float get_dry() const;
+
+/// \}
+/// \name Operations
+/// \{
+
+public:
+	/// \brief Retrieves the provider.
+	ConvolutionReverbFilterProvider *get_provider() const;
+
+	/// \brief Sets the volumes of the reverberated and the original signal
+	void set_mix(float wet, float dry);
+
+/// \}
+/// \name Implementation
+/// \{
+
+private:
+/// \}
+};
+
+}
+
+/// \}
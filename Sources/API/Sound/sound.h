@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include "../Core/System/cl_platform.h"
 
 namespace clan
 {
@@ -37,6 +38,37 @@ namespace clan
 
 class SoundOutput;
 
+/// \brief Decoding and mixing counters, accumulated since the program started
+class SoundStatistics
+{
+public:
+	SoundStatistics() : decode_time(0), mixer_decode_time(0), mix_time(0), mixed_fragments(0), pcm_cache_hits(0), pcm_cache_misses(0), pcm_cache_memory(0), prefetch_underruns(0) { }
+
+	/// \brief Microseconds spent decoding outside the mixer thread (PCM cache and stream prefetching)
+	ubyte64 decode_time;
+
+	/// \brief Microseconds the mixer thread spent fetching sample data from sessions
+	ubyte64 mixer_decode_time;
+
+	/// \brief Microseconds spent mixing fragments, including mixer_decode_time
+	ubyte64 mix_time;
+
+	/// \brief Number of fragments mixed
+	int mixed_fragments;
+
+	/// \brief Sessions started from already decoded data
+	int pcm_cache_hits;
+
+	/// \brief Sessions that had to decode their sound buffer first
+	int pcm_cache_misses;
+
+	/// \brief Bytes of decoded data currently in the cache
+	int pcm_cache_memory;
+
+	/// \brief Times the mixer had to decode a stream itself because the prefetch worker fell behind
+	int prefetch_underruns;
+};
+
 /// \brief Sound interface in ClanLib.
 ///
 //    <p>All the functions that share name with those in SoundOutput have the
@@ -63,6 +95,26 @@ public:
 	/// \param output The new current selected sound output.
 	static void select_output(const SoundOutput &output);
 /// \}
+
+/// \name Decoding
+/// \{
+
+public:
+	/// \brief Sets the memory used for decoded short sounds (default is 16 MB)
+	///
+	/// Sound buffers that are not streamed are decoded once when first played, if they are short
+	/// enough, and then played from memory. The least recently used ones are dropped when the cache
+	/// exceeds this budget. Streamed and longer sounds are decoded ahead by a worker thread instead.
+	static void set_pcm_cache_budget(int bytes);
+	static int get_pcm_cache_budget();
+
+	/// \brief Sets the maximum length, in samples, of sounds kept decoded (default is 441000)
+	static void set_pcm_cache_max_samples(int samples);
+	static int get_pcm_cache_max_samples();
+
+	/// \brief Returns the decode and mix time counters
+	static SoundStatistics get_statistics();
+/// \}
 };
 
 }
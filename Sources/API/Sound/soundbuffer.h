@@ -182,6 +182,8 @@ public:
 
 private:
 	std::shared_ptr<SoundBuffer_Impl> impl;
+
+	friend class SoundBuffer_Session_Impl;
 /// \}
 };
 
@@ -62,6 +62,13 @@ namespace clan
 
 		DisplayWindow get_display_window();
 
+		/// \brief Keep a copy of the window contents in a texture and only render the damaged area again on paint
+		///
+		/// The whole copy is still drawn to the window on every paint, so this only pays off when
+		/// small parts of a complex window change. Disabled by default.
+		bool retained_rendering_enabled() const;
+		void set_retained_rendering_enabled(bool value = true);
+
 		void set_needs_render() override;
 		bool local_root() override;
 		void layout_local() override;
@@ -69,6 +76,9 @@ namespace clan
 		Pointf to_screen_pos(const Pointf &pos) override;
 		Pointf from_screen_pos(const Pointf &pos) override;
 
+	protected:
+		void render_damaged(const Rectf &box) override;
+
 	private:
 		std::shared_ptr<WindowView_Impl> impl;
 	};
@@ -47,6 +47,8 @@ namespace clan
 		~BoxStyle();
 
 		/// \brief Copy assignment operator (does not copy the style, use clone() if you want that)
+		///
+		/// The style changed callback of this object is invoked.
 		BoxStyle &operator =(const BoxStyle &copy);
 
 		// \brief Copy the entire style (not just the implementation)
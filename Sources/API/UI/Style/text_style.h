@@ -30,6 +30,7 @@
 
 #include <string>
 #include <memory>
+#include <functional>
 #include "../../Display/Font/font_description.h"
 
 namespace clan
@@ -44,6 +45,12 @@ namespace clan
 	{
 	public:
 		TextStyle();
+		TextStyle(const TextStyle &copy) = default;
+
+		/// \brief Copy assignment operator (shares the style with copy)
+		///
+		/// The style changed callback of this object is invoked.
+		TextStyle &operator =(const TextStyle &copy);
 
 		void set_font(const std::string &family, float size);
 		void set_font(const std::string &family, float size, float line_height);
@@ -187,6 +194,8 @@ namespace clan
 
 		Font get_font(Canvas &canvas);
 
+		void set_style_changed(const std::function<void()> &callback);
+
 	private:
 		std::shared_ptr<TextStyleImpl> impl;
 	};
@@ -78,10 +78,25 @@ namespace clan
 		const BoxGeometry &geometry() const;
 		void set_geometry(const BoxGeometry &geometry);
 
+		/// \brief Requests the view to be rendered again
+		///
+		/// The ancestors up to the root view have set_needs_render called as well. The root view is not,
+		/// it receives the area to render again through render_damaged.
 		virtual void set_needs_render();
 
 		void render(Canvas &canvas);
 
+		/// \brief Keep the rendering of this view and its subviews in a texture
+		///
+		/// The texture is reused until set_needs_render is called on the view or one of its subviews, or
+		/// its geometry changes. Anything drawn outside the border box is clipped while the cache is enabled.
+		bool render_cache_enabled() const;
+		void set_render_cache_enabled(bool value = true);
+
+		/// \brief Number of times render reused or had to update the texture of the render cache
+		int render_cache_hits() const;
+		int render_cache_misses() const;
+
 		virtual void render_content(Canvas &canvas) { }
 
 		virtual float get_preferred_width(Canvas &canvas);
@@ -89,6 +104,21 @@ namespace clan
 		virtual float get_first_baseline_offset(Canvas &canvas, float width);
 		virtual float get_last_baseline_offset(Canvas &canvas, float width);
 
+		/// \brief Returns get_preferred_width, cached until set_needs_layout is called on this view or one of its subviews
+		///
+		/// Layouts measure their subviews with the measure functions. Views overriding the get_ functions
+		/// must call set_needs_layout when anything affecting their measurements changes.
+		float measure_preferred_width(Canvas &canvas);
+
+		/// \brief Returns get_preferred_height, cached per width until set_needs_layout is called on this view or one of its subviews
+		float measure_preferred_height(Canvas &canvas, float width);
+
+		/// \brief Returns get_first_baseline_offset, cached per width
+		float measure_first_baseline_offset(Canvas &canvas, float width);
+
+		/// \brief Returns get_last_baseline_offset, cached per width
+		float measure_last_baseline_offset(Canvas &canvas, float width);
+
 		virtual bool local_root();
 
 		void layout(Canvas &canvas);
@@ -145,6 +175,11 @@ namespace clan
 		virtual Pointf from_screen_pos(const Pointf &pos);
 
 	protected:
+		/// \brief Called on the root view when a part of it needs to be rendered again
+		///
+		/// \param box = area in the coordinate system the root view is placed in.
+		virtual void render_damaged(const Rectf &box) { set_needs_render(); }
+
 		virtual void subview_added(const std::shared_ptr<View> &view) { }
 		virtual void subview_removed(const std::shared_ptr<View> &view) { }
 
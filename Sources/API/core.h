@@ -58,6 +58,7 @@
 #endif
 
 #include "Core/Text/file_logger.h"
+#include "Core/Text/async_logger.h"
 #include "Core/Text/console.h"
 #include "Core/Text/console_logger.h"
 #include "Core/Text/logger.h"
@@ -86,6 +87,7 @@
 #include "Core/System/userdata.h"
 #include "Core/System/game_time.h"
 #include "Core/System/work_queue.h"
+#include "Core/System/profiler.h"
 #include "Core/ErrorReporting/crash_reporter.h"
 #include "Core/ErrorReporting/detect_hang.h"
 #include "Core/ErrorReporting/exception_dialog.h"
@@ -172,6 +174,7 @@
 #include "Core/Math/frustum_planes.h"
 #include "Core/Math/intersection_test.h"
 #include "Core/Math/aabb.h"
+#include "Core/Math/batch_math.h"
 #include "Core/Math/obb.h"
 #include "Core/Math/easing.h"
 #include "Core/Crypto/random.h"
@@ -190,6 +193,7 @@
 #include "Core/Crypto/aes192_decrypt.h"
 #include "Core/Crypto/aes256_encrypt.h"
 #include "Core/Crypto/aes256_decrypt.h"
+#include "Core/Crypto/aes_gcm.h"
 #include "Core/Crypto/rsa.h"
 #include "Core/Crypto/tls_client.h"
 #include "Core/Math/size.h"
@@ -61,6 +61,8 @@
 #include "Sound/SoundFilters/echofilter.h"
 #include "Sound/SoundFilters/inverse_echofilter.h"
 #include "Sound/SoundFilters/fadefilter.h"
+#include "Sound/SoundFilters/biquadfilter.h"
+#include "Sound/SoundFilters/convolution_reverbfilter.h"
 
 #include "Sound/AudioWorld/audio_definition.h"
 #include "Sound/AudioWorld/audio_object.h"
@@ -99,8 +99,10 @@ public:
 
 private:
 	void process_chunk();
+	void process_blocks(const unsigned char *data, int num_blocks);
 
 	ubyte32 key_expanded[aes192_nb_mult_nr_plus1];
+	unsigned char round_keys[aes192_nb_mult_nr_plus1 * 4];
 
 	unsigned char chunk[aes192_block_size_bytes];
 	ubyte32 initialisation_vector_1;
@@ -112,6 +114,7 @@ private:
 
 	bool initialisation_vector_set;
 	bool cipher_key_set;
+	bool use_aes_ni;
 	bool calculated;
 	bool padding_enabled;
 	bool padding_pkcs7;
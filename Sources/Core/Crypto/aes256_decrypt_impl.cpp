@@ -29,6 +29,7 @@
 
 #include "Core/precomp.h"
 #include "aes256_decrypt_impl.h"
+#include "aes_ni.h"
 
 #include "../../API/Core/Math/cl_math.h"
 
@@ -42,7 +43,7 @@ namespace clan
 /////////////////////////////////////////////////////////////////////////////
 // AES256_Decrypt_Impl Construction:
 
-AES256_Decrypt_Impl::AES256_Decrypt_Impl() : initialisation_vector_set(false), cipher_key_set(false), padding_enabled(true), 	padding_pkcs7(true)
+AES256_Decrypt_Impl::AES256_Decrypt_Impl() : initialisation_vector_set(false), cipher_key_set(false), use_aes_ni(false), padding_enabled(true), 	padding_pkcs7(true)
 {
 	reset();
 }
@@ -87,6 +88,10 @@ void AES256_Decrypt_Impl::set_key(const unsigned char key[32])
 	cipher_key_set = true;
 	extract_encrypt_key256(key, key_expanded);
 	extract_decrypt_key(key_expanded, aes256_num_rounds_nr);
+
+	use_aes_ni = AES_NI::is_supported();
+	if (use_aes_ni)
+		AES_NI::convert_key(key_expanded, aes256_num_rounds_nr, round_keys);
 }
 
 void AES256_Decrypt_Impl::add(const void *_data, int size)
@@ -104,6 +109,21 @@ void AES256_Decrypt_Impl::add(const void *_data, int size)
 	int pos = 0;
 	while (pos < size)
 	{
+		// Whole blocks are decrypted straight from the input, without copying them to the chunk first.
+		// With padding enabled, the last block is left in the chunk for calculate().
+		if (use_aes_ni && chunk_filled == 0 && size - pos >= aes256_block_size_bytes)
+		{
+			int num_blocks = (size - pos) / aes256_block_size_bytes;
+			if (padding_enabled && (size - pos) % aes256_block_size_bytes == 0)
+				num_blocks--;
+			if (num_blocks > 0)
+			{
+				process_blocks(data + pos, num_blocks);
+				pos += num_blocks * aes256_block_size_bytes;
+				continue;
+			}
+		}
+
 		int data_left = size - pos;
 		int buffer_space = aes256_block_size_bytes - chunk_filled;
 		int data_used = min(buffer_space, data_left);
@@ -185,6 +205,7 @@ bool AES256_Decrypt_Impl::calculate()
 	initialisation_vector_set = false;	// Force to reset after each call
 	cipher_key_set = false;				// Force to reset after each call (to avoid keeping the cipher key in memory)
 	memset(key_expanded, 0, sizeof(key_expanded));
+	memset(round_keys, 0, sizeof(round_keys));
 
 	return true;
 
@@ -195,6 +216,12 @@ bool AES256_Decrypt_Impl::calculate()
 
 void AES256_Decrypt_Impl::process_chunk()
 {
+	if (use_aes_ni)
+	{
+		process_blocks(chunk, 1);
+		return;
+	}
+
 	const ubyte32 *key_expanded_ptr = key_expanded;
 
 	ubyte32 chunk1 = get_word(chunk);
@@ -299,4 +326,21 @@ void AES256_Decrypt_Impl::process_chunk()
 
 }
 
+void AES256_Decrypt_Impl::process_blocks(const unsigned char *data, int num_blocks)
+{
+	unsigned char iv[aes256_block_size_bytes];
+	put_word(initialisation_vector_1, iv);
+	put_word(initialisation_vector_2, iv + 4);
+	put_word(initialisation_vector_3, iv + 8);
+	put_word(initialisation_vector_4, iv + 12);
+
+	unsigned char *dest_ptr = append_blocks(databuffer, num_blocks);
+	AES_NI::decrypt_cbc(round_keys, aes256_num_rounds_nr, iv, data, dest_ptr, num_blocks);
+
+	initialisation_vector_1 = get_word(iv);
+	initialisation_vector_2 = get_word(iv + 4);
+	initialisation_vector_3 = get_word(iv + 8);
+	initialisation_vector_4 = get_word(iv + 12);
+}
+
 }
@@ -0,0 +1,65 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2015 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    agent
+*/
+
+#include "Core/precomp.h"
+#include "API/Core/Crypto/aes_gcm.h"
+#include "aes_gcm_impl.h"
+
+namespace clan
+{
+
+/////////////////////////////////////////////////////////////////////////////
+// AES_GCM Construction:
+
+AES_GCM::AES_GCM()
+: impl(std::make_shared<AES_GCM_Impl>())
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// AES_GCM Operations:
+
+void AES_GCM::set_key(const unsigned char *key, int key_size)
+{
+	impl->set_key(key, key_size);
+}
+
+void AES_GCM::encrypt(const unsigned char iv[iv_size], const void *aad, int aad_size, const void *input, void *output, int size, unsigned char out_tag[tag_size])
+{
+	impl->encrypt(iv, aad, aad_size, input, output, size, out_tag);
+}
+
+bool AES_GCM::decrypt(const unsigned char iv[iv_size], const void *aad, int aad_size, const void *input, void *output, int size, const unsigned char tag[tag_size])
+{
+	return impl->decrypt(iv, aad, aad_size, input, output, size, tag);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// AES_GCM Implementation:
+
+}
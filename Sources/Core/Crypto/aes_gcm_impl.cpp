@@ -0,0 +1,313 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2015 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    agent
+*/
+
+#include "Core/precomp.h"
+#include "aes_gcm_impl.h"
+#include "aes_ni.h"
+
+#ifndef WIN32
+#include <cstring>
+#endif
+
+namespace clan
+{
+
+/////////////////////////////////////////////////////////////////////////////
+// AES_GCM_Impl Construction:
+
+AES_GCM_Impl::AES_GCM_Impl() : num_rounds(0), cipher_key_set(false), use_aes_ni(false), use_clmul(false)
+{
+}
+
+AES_GCM_Impl::~AES_GCM_Impl()
+{
+	// Remove the key from memory
+	memset(key_expanded, 0, sizeof(key_expanded));
+	memset(round_keys, 0, sizeof(round_keys));
+	memset(h_table_low, 0, sizeof(h_table_low));
+	memset(h_table_high, 0, sizeof(h_table_high));
+	memset(clmul_key_table, 0, sizeof(clmul_key_table));
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// AES_GCM_Impl Operations:
+
+void AES_GCM_Impl::set_key(const unsigned char *key, int key_size)
+{
+	switch (key_size)
+	{
+	case aes128_key_length_bytes:
+		extract_encrypt_key128(key, key_expanded);
+		num_rounds = aes128_num_rounds_nr;
+		break;
+	case aes192_key_length_bytes:
+		extract_encrypt_key192(key, key_expanded);
+		num_rounds = aes192_num_rounds_nr;
+		break;
+	case aes256_key_length_bytes:
+		extract_encrypt_key256(key, key_expanded);
+		num_rounds = aes256_num_rounds_nr;
+		break;
+	default:
+		throw Exception("AES-GCM key size must be 16, 24 or 32 bytes");
+	}
+	cipher_key_set = true;
+
+	use_aes_ni = AES_NI::is_supported();
+	if (use_aes_ni)
+		AES_NI::convert_key(key_expanded, num_rounds, round_keys);
+
+	// The hash subkey is the encrypted zero block
+	unsigned char h[16] = { 0 };
+	encrypt_block(key_expanded, num_rounds, h, h);
+
+	use_clmul = GHASH_CLMUL::is_supported();
+	if (use_clmul)
+	{
+		GHASH_CLMUL::init(h, clmul_key_table);
+	}
+	else
+	{
+		ubyte64 vh = 0, vl = 0;
+		for (int i = 0; i < 8; i++)
+		{
+			vh = (vh << 8) | h[i];
+			vl = (vl << 8) | h[i + 8];
+		}
+
+		// Entry 8 is H, entries 4, 2 and 1 are H times x, x^2 and x^3, and the others are sums of those
+		h_table_low[0] = 0;
+		h_table_high[0] = 0;
+		h_table_low[8] = vl;
+		h_table_high[8] = vh;
+		for (int i = 4; i > 0; i >>= 1)
+		{
+			ubyte32 reduce = (vl & 1) ? 0xe1000000 : 0;
+			vl = (vh << 63) | (vl >> 1);
+			vh = (vh >> 1) ^ ((ubyte64) reduce << 32);
+			h_table_low[i] = vl;
+			h_table_high[i] = vh;
+		}
+		for (int i = 2; i <= 8; i *= 2)
+		{
+			for (int j = 1; j < i; j++)
+			{
+				h_table_low[i + j] = h_table_low[i] ^ h_table_low[j];
+				h_table_high[i + j] = h_table_high[i] ^ h_table_high[j];
+			}
+		}
+	}
+	memset(h, 0, sizeof(h));
+}
+
+void AES_GCM_Impl::encrypt(const unsigned char iv[12], const void *aad, int aad_size, const void *input, void *output, int size, unsigned char out_tag[16])
+{
+	if (!cipher_key_set)
+		throw Exception("AES-GCM cipher key has not been set");
+
+	// The first counter block is used for the tag, the data starts at the second
+	unsigned char counter[16];
+	memcpy(counter, iv, 12);
+	counter[12] = 0;
+	counter[13] = 0;
+	counter[14] = 0;
+	counter[15] = 2;
+	encrypt_ctr(counter, (const unsigned char *) input, (unsigned char *) output, size);
+
+	calculate_tag(iv, (const unsigned char *) aad, aad_size, (const unsigned char *) output, size, out_tag);
+}
+
+bool AES_GCM_Impl::decrypt(const unsigned char iv[12], const void *aad, int aad_size, const void *input, void *output, int size, const unsigned char tag[16])
+{
+	if (!cipher_key_set)
+		throw Exception("AES-GCM cipher key has not been set");
+
+	// The tag covers the ciphertext, so it is checked before the input is decrypted (possibly in place)
+	unsigned char expected_tag[16];
+	calculate_tag(iv, (const unsigned char *) aad, aad_size, (const unsigned char *) input, size, expected_tag);
+
+	// Compare all bytes, so the time taken does not reveal where the first difference is
+	unsigned char difference = 0;
+	for (int i = 0; i < 16; i++)
+		difference |= expected_tag[i] ^ tag[i];
+	if (difference != 0)
+		return false;
+
+	unsigned char counter[16];
+	memcpy(counter, iv, 12);
+	counter[12] = 0;
+	counter[13] = 0;
+	counter[14] = 0;
+	counter[15] = 2;
+	encrypt_ctr(counter, (const unsigned char *) input, (unsigned char *) output, size);
+	return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// AES_GCM_Impl Implementation:
+
+void AES_GCM_Impl::encrypt_ctr(unsigned char counter[16], const unsigned char *input, unsigned char *output, int size)
+{
+	if (use_aes_ni)
+	{
+		int num_blocks = size / 16;
+		AES_NI::encrypt_ctr32(round_keys, num_rounds, counter, input, output, num_blocks);
+
+		int remaining = size - num_blocks * 16;
+		if (remaining > 0)
+		{
+			unsigned char block[16] = { 0 };
+			memcpy(block, input + num_blocks * 16, remaining);
+			AES_NI::encrypt_ctr32(round_keys, num_rounds, counter, block, block, 1);
+			memcpy(output + num_blocks * 16, block, remaining);
+		}
+	}
+	else
+	{
+		unsigned char key_stream[16];
+		for (int pos = 0; pos < size; pos += 16)
+		{
+			encrypt_block(key_expanded, num_rounds, counter, key_stream);
+			increment_counter(counter);
+
+			int length = size - pos < 16 ? size - pos : 16;
+			for (int i = 0; i < length; i++)
+				output[pos + i] = input[pos + i] ^ key_stream[i];
+		}
+	}
+}
+
+void AES_GCM_Impl::calculate_tag(const unsigned char iv[12], const unsigned char *aad, int aad_size, const unsigned char *ciphertext, int size, unsigned char out_tag[16])
+{
+	unsigned char state[16] = { 0 };
+	ghash(state, aad, aad_size);
+	ghash(state, ciphertext, size);
+
+	unsigned char lengths[16];
+	ubyte64 aad_bits = (ubyte64) aad_size * 8;
+	ubyte64 data_bits = (ubyte64) size * 8;
+	for (int i = 0; i < 8; i++)
+	{
+		lengths[i] = (unsigned char) (aad_bits >> (56 - i * 8));
+		lengths[i + 8] = (unsigned char) (data_bits >> (56 - i * 8));
+	}
+	ghash_blocks(state, lengths, 1);
+
+	unsigned char counter[16];
+	memcpy(counter, iv, 12);
+	counter[12] = 0;
+	counter[13] = 0;
+	counter[14] = 0;
+	counter[15] = 1;
+	encrypt_ctr(counter, state, out_tag, 16);
+}
+
+void AES_GCM_Impl::ghash(unsigned char state[16], const unsigned char *data, int size)
+{
+	int num_blocks = size / 16;
+	if (num_blocks > 0)
+		ghash_blocks(state, data, num_blocks);
+
+	int remaining = size - num_blocks * 16;
+	if (remaining > 0)
+	{
+		unsigned char block[16] = { 0 };
+		memcpy(block, data + num_blocks * 16, remaining);
+		ghash_blocks(state, block, 1);
+	}
+}
+
+void AES_GCM_Impl::ghash_blocks(unsigned char state[16], const unsigned char *data, int num_blocks)
+{
+	if (use_clmul)
+	{
+		GHASH_CLMUL::process_blocks(clmul_key_table, state, data, num_blocks);
+	}
+	else
+	{
+		for (int block = 0; block < num_blocks; block++)
+		{
+			for (int i = 0; i < 16; i++)
+				state[i] ^= data[block * 16 + i];
+			gf_multiply_h(state);
+		}
+	}
+}
+
+void AES_GCM_Impl::gf_multiply_h(unsigned char x[16]) const
+{
+	// Reduction of the four bits shifted out at the bottom, for each possible value of those bits
+	static const ubyte64 last4[16] =
+	{
+		0x0000, 0x1c20, 0x3840, 0x2460, 0x7080, 0x6ca0, 0x48c0, 0x54e0,
+		0xe100, 0xfd20, 0xd940, 0xc560, 0x9180, 0x8da0, 0xa9c0, 0xb5e0
+	};
+
+	int low_nibble = x[15] & 0xf;
+	ubyte64 zh = h_table_high[low_nibble];
+	ubyte64 zl = h_table_low[low_nibble];
+
+	for (int i = 15; i >= 0; i--)
+	{
+		low_nibble = x[i] & 0xf;
+		int high_nibble = (x[i] >> 4) & 0xf;
+
+		if (i != 15)
+		{
+			int remainder = (int) (zl & 0xf);
+			zl = (zh << 60) | (zl >> 4);
+			zh = (zh >> 4) ^ (last4[remainder] << 48);
+			zh ^= h_table_high[low_nibble];
+			zl ^= h_table_low[low_nibble];
+		}
+
+		int remainder = (int) (zl & 0xf);
+		zl = (zh << 60) | (zl >> 4);
+		zh = (zh >> 4) ^ (last4[remainder] << 48);
+		zh ^= h_table_high[high_nibble];
+		zl ^= h_table_low[high_nibble];
+	}
+
+	for (int i = 0; i < 8; i++)
+	{
+		x[i] = (unsigned char) (zh >> (56 - i * 8));
+		x[i + 8] = (unsigned char) (zl >> (56 - i * 8));
+	}
+}
+
+void AES_GCM_Impl::increment_counter(unsigned char counter[16])
+{
+	// Only the last 32 bits are a counter in GCM
+	for (int i = 15; i >= 12; i--)
+	{
+		if (++counter[i] != 0)
+			break;
+	}
+}
+
+}
@@ -0,0 +1,86 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2015 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    agent
+*/
+
+#pragma once
+
+#include "API/Core/System/cl_platform.h"
+#include "API/Core/System/databuffer.h"
+#include "aes_impl.h"
+#include "ghash_clmul.h"
+
+namespace clan
+{
+
+class AES_GCM_Impl : public AES_Impl
+{
+/// \name Construction
+/// \{
+
+public:
+	AES_GCM_Impl();
+	~AES_GCM_Impl();
+
+/// \}
+/// \name Operations
+/// \{
+
+public:
+	void set_key(const unsigned char *key, int key_size);
+	void encrypt(const unsigned char iv[12], const void *aad, int aad_size, const void *input, void *output, int size, unsigned char out_tag[16]);
+	bool decrypt(const unsigned char iv[12], const void *aad, int aad_size, const void *input, void *output, int size, const unsigned char tag[16]);
+
+/// \}
+/// \name Implementation
+/// \{
+
+private:
+	void encrypt_ctr(unsigned char counter[16], const unsigned char *input, unsigned char *output, int size);
+	void calculate_tag(const unsigned char iv[12], const unsigned char *aad, int aad_size, const unsigned char *ciphertext, int size, unsigned char out_tag[16]);
+	void ghash(unsigned char state[16], const unsigned char *data, int size);
+	void ghash_blocks(unsigned char state[16], const unsigned char *data, int num_blocks);
+	void gf_multiply_h(unsigned char x[16]) const;
+
+	static void increment_counter(unsigned char counter[16]);
+
+	ubyte32 key_expanded[aes256_nb_mult_nr_plus1];
+	unsigned char round_keys[aes256_nb_mult_nr_plus1 * 4];
+	int num_rounds;
+
+	// Multiples of the hash subkey H for the portable GHASH, four bits at a time (Shoup's method)
+	ubyte64 h_table_low[16];
+	ubyte64 h_table_high[16];
+
+	unsigned char clmul_key_table[GHASH_CLMUL::key_table_size];
+
+	bool cipher_key_set;
+	bool use_aes_ni;
+	bool use_clmul;
+/// \}
+};
+
+}
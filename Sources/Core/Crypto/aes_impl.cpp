@@ -173,16 +173,7 @@ void AES_Impl::store_block(ubyte32 s0, ubyte32 s1, ubyte32 s2, ubyte32 s3, DataB
 	// (Note AES 128, 192 and 256 all have the same block size)
 
 	// Store the data
-	int current_size = databuffer.get_size();
-	int current_capacity = databuffer.get_capacity();
-	int available = current_capacity - current_size;
-	if (available < aes128_block_size_bytes)	// Increase capacity required
-	{
-		databuffer.set_capacity(current_capacity + 1024);	// Increase in blocks of 1K
-	}
-	databuffer.set_size(current_size + aes128_block_size_bytes);
-	unsigned char *dest_ptr = (unsigned char *) databuffer.get_data();
-	dest_ptr += current_size;
+	unsigned char *dest_ptr = append_blocks(databuffer, 1);
 
 	put_word(s0, dest_ptr);
 	put_word(s1, dest_ptr+4);
@@ -190,6 +181,48 @@ void AES_Impl::store_block(ubyte32 s0, ubyte32 s1, ubyte32 s2, ubyte32 s3, DataB
 	put_word(s3, dest_ptr+12);
 }
 
+unsigned char *AES_Impl::append_blocks(DataBuffer &databuffer, int num_blocks)
+{
+	int current_size = databuffer.get_size();
+	int required_size = current_size + num_blocks * aes128_block_size_bytes;
+	int current_capacity = databuffer.get_capacity();
+	if (required_size > current_capacity)	// Increase capacity required
+	{
+		// Grow geometrically, as growing in fixed steps copies the data over and over for large inputs
+		databuffer.set_capacity(max(current_capacity * 2, required_size + 1024));
+	}
+	databuffer.set_size(required_size);
+	return (unsigned char *) databuffer.get_data() + current_size;
+}
+
+void AES_Impl::encrypt_block(const ubyte32 *key_expanded, int num_rounds, const unsigned char input[16], unsigned char output[16]) const
+{
+	ubyte32 s0 = get_word(input) ^ key_expanded[0];
+	ubyte32 s1 = get_word(input + 4) ^ key_expanded[1];
+	ubyte32 s2 = get_word(input + 8) ^ key_expanded[2];
+	ubyte32 s3 = get_word(input + 12) ^ key_expanded[3];
+
+	for (int round = 1; round < num_rounds; round++)
+	{
+		const ubyte32 *key_expanded_ptr = key_expanded + round * 4;
+		ubyte32 t0 = table_e0[s0 >> 24] ^ table_e1[(s1 >> 16) & 0xff] ^ table_e2[(s2 >>  8) & 0xff] ^ table_e3[s3 & 0xff] ^ key_expanded_ptr[0];
+		ubyte32 t1 = table_e0[s1 >> 24] ^ table_e1[(s2 >> 16) & 0xff] ^ table_e2[(s3 >>  8) & 0xff] ^ table_e3[s0 & 0xff] ^ key_expanded_ptr[1];
+		ubyte32 t2 = table_e0[s2 >> 24] ^ table_e1[(s3 >> 16) & 0xff] ^ table_e2[(s0 >>  8) & 0xff] ^ table_e3[s1 & 0xff] ^ key_expanded_ptr[2];
+		ubyte32 t3 = table_e0[s3 >> 24] ^ table_e1[(s0 >> 16) & 0xff] ^ table_e2[(s1 >>  8) & 0xff] ^ table_e3[s2 & 0xff] ^ key_expanded_ptr[3];
+		s0 = t0;
+		s1 = t1;
+		s2 = t2;
+		s3 = t3;
+	}
+
+	// Apply last round
+	const ubyte32 *key_expanded_ptr = key_expanded + num_rounds * 4;
+	put_word((sbox_substitution_values[(s0 >> 24) ] & 0xff000000) ^ (sbox_substitution_values[(s1 >> 16) & 0xff] & 0x00ff0000) ^ (sbox_substitution_values[(s2 >> 8) & 0xff] & 0x0000ff00) ^ (sbox_substitution_values[(s3 ) & 0xff] & 0x000000ff) ^ key_expanded_ptr[0], output);
+	put_word((sbox_substitution_values[(s1 >> 24) ] & 0xff000000) ^ (sbox_substitution_values[(s2 >> 16) & 0xff] & 0x00ff0000) ^ (sbox_substitution_values[(s3 >> 8) & 0xff] & 0x0000ff00) ^ (sbox_substitution_values[(s0 ) & 0xff] & 0x000000ff) ^ key_expanded_ptr[1], output + 4);
+	put_word((sbox_substitution_values[(s2 >> 24) ] & 0xff000000) ^ (sbox_substitution_values[(s3 >> 16) & 0xff] & 0x00ff0000) ^ (sbox_substitution_values[(s0 >> 8) & 0xff] & 0x0000ff00) ^ (sbox_substitution_values[(s1 ) & 0xff] & 0x000000ff) ^ key_expanded_ptr[2], output + 8);
+	put_word((sbox_substitution_values[(s3 >> 24) ] & 0xff000000) ^ (sbox_substitution_values[(s0 >> 16) & 0xff] & 0x00ff0000) ^ (sbox_substitution_values[(s1 >> 8) & 0xff] & 0x0000ff00) ^ (sbox_substitution_values[(s2 ) & 0xff] & 0x000000ff) ^ key_expanded_ptr[3], output + 12);
+}
+
 void AES_Impl::extract_decrypt_key(ubyte32 *key_expanded, int num_rounds)
 {
 	// Invert the order of the round keys
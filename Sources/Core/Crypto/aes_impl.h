@@ -90,6 +90,12 @@ public:
 	void extract_decrypt_key(ubyte32 *key_expanded, int num_rounds);
 	void store_block(ubyte32 s0, ubyte32 s1, ubyte32 s2, ubyte32 s3, DataBuffer &databuffer);
 
+	/// \brief Grows the databuffer by num_blocks blocks and returns a pointer to the first new block
+	unsigned char *append_blocks(DataBuffer &databuffer, int num_blocks);
+
+	/// \brief Encrypts a single block in Electronic Codebook Mode
+	void encrypt_block(const ubyte32 *key_expanded, int num_rounds, const unsigned char input[16], unsigned char output[16]) const;
+
 	inline ubyte32 get_word(const unsigned char *data) const
 	{
 		return ( (data[0] << 24) | (data[1] << 16) | (data[2] << 8) | (data[3]) );
@@ -0,0 +1,204 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2015 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    agent
+*/
+
+
+#include "Core/precomp.h"
+#include "aes_ni.h"
+#include "API/Core/System/system.h"
+
+#if !defined(CL_ARM_PLATFORM) && !defined(CL_DISABLE_SSE2)
+#define CL_AES_NI
+#include <wmmintrin.h>
+#include <tmmintrin.h>
+#endif
+
+// GCC and Clang only allow the AES intrinsics in functions compiled for a CPU that has them
+#if defined(CL_AES_NI) && defined(__GNUC__)
+#define CL_AES_NI_TARGET __attribute__((target("aes,ssse3")))
+#else
+#define CL_AES_NI_TARGET
+#endif
+
+namespace clan
+{
+
+bool AES_NI::is_supported()
+{
+#ifdef CL_AES_NI
+	static bool supported = System::detect_cpu_extension(System::aes) && System::detect_cpu_extension(System::ssse3);
+	return supported;
+#else
+	return false;
+#endif
+}
+
+void AES_NI::convert_key(const ubyte32 *key_expanded, int num_rounds, unsigned char *round_keys)
+{
+	for (int i = 0; i < (num_rounds + 1) * 4; i++)
+	{
+		round_keys[i * 4 + 0] = (unsigned char) (key_expanded[i] >> 24);
+		round_keys[i * 4 + 1] = (unsigned char) (key_expanded[i] >> 16);
+		round_keys[i * 4 + 2] = (unsigned char) (key_expanded[i] >> 8);
+		round_keys[i * 4 + 3] = (unsigned char) (key_expanded[i]);
+	}
+}
+
+#ifdef CL_AES_NI
+
+CL_AES_NI_TARGET void AES_NI::encrypt_cbc(const unsigned char *round_keys, int num_rounds, unsigned char iv[16], const unsigned char *input, unsigned char *output, int num_blocks)
+{
+	__m128i keys[15];
+	for (int i = 0; i <= num_rounds; i++)
+		keys[i] = _mm_loadu_si128((const __m128i *) (round_keys + i * 16));
+
+	// Every block depends on the previous one, so encryption cannot be pipelined
+	__m128i state = _mm_loadu_si128((const __m128i *) iv);
+	for (int block = 0; block < num_blocks; block++)
+	{
+		state = _mm_xor_si128(state, _mm_loadu_si128((const __m128i *) (input + block * 16)));
+		state = _mm_xor_si128(state, keys[0]);
+		for (int i = 1; i < num_rounds; i++)
+			state = _mm_aesenc_si128(state, keys[i]);
+		state = _mm_aesenclast_si128(state, keys[num_rounds]);
+		_mm_storeu_si128((__m128i *) (output + block * 16), state);
+	}
+	_mm_storeu_si128((__m128i *) iv, state);
+}
+
+CL_AES_NI_TARGET void AES_NI::decrypt_cbc(const unsigned char *round_keys, int num_rounds, unsigned char iv[16], const unsigned char *input, unsigned char *output, int num_blocks)
+{
+	__m128i keys[15];
+	for (int i = 0; i <= num_rounds; i++)
+		keys[i] = _mm_loadu_si128((const __m128i *) (round_keys + i * 16));
+
+	__m128i previous = _mm_loadu_si128((const __m128i *) iv);
+	int block = 0;
+
+	// The blocks decrypt independently, so eight are kept in flight to hide the latency of the AESDEC instruction
+	for (; block + 8 <= num_blocks; block += 8)
+	{
+		__m128i cipher[8], state[8];
+		for (int j = 0; j < 8; j++)
+		{
+			cipher[j] = _mm_loadu_si128((const __m128i *) (input + (block + j) * 16));
+			state[j] = _mm_xor_si128(cipher[j], keys[0]);
+		}
+		for (int i = 1; i < num_rounds; i++)
+		{
+			for (int j = 0; j < 8; j++)
+				state[j] = _mm_aesdec_si128(state[j], keys[i]);
+		}
+		for (int j = 0; j < 8; j++)
+			state[j] = _mm_aesdeclast_si128(state[j], keys[num_rounds]);
+
+		_mm_storeu_si128((__m128i *) (output + block * 16), _mm_xor_si128(state[0], previous));
+		for (int j = 1; j < 8; j++)
+			_mm_storeu_si128((__m128i *) (output + (block + j) * 16), _mm_xor_si128(state[j], cipher[j - 1]));
+		previous = cipher[7];
+	}
+
+	for (; block < num_blocks; block++)
+	{
+		__m128i cipher = _mm_loadu_si128((const __m128i *) (input + block * 16));
+		__m128i state = _mm_xor_si128(cipher, keys[0]);
+		for (int i = 1; i < num_rounds; i++)
+			state = _mm_aesdec_si128(state, keys[i]);
+		state = _mm_aesdeclast_si128(state, keys[num_rounds]);
+		_mm_storeu_si128((__m128i *) (output + block * 16), _mm_xor_si128(state, previous));
+		previous = cipher;
+	}
+	_mm_storeu_si128((__m128i *) iv, previous);
+}
+
+CL_AES_NI_TARGET void AES_NI::encrypt_ctr32(const unsigned char *round_keys, int num_rounds, unsigned char counter[16], const unsigned char *input, unsigned char *output, int num_blocks)
+{
+	__m128i keys[15];
+	for (int i = 0; i <= num_rounds; i++)
+		keys[i] = _mm_loadu_si128((const __m128i *) (round_keys + i * 16));
+
+	// The counter is kept with its bytes reversed, so the big endian block counter can be incremented with an integer add
+	const __m128i byte_swap = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+	const __m128i one = _mm_set_epi32(0, 0, 0, 1);
+	__m128i counter_swapped = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) counter), byte_swap);
+
+	int block = 0;
+	for (; block + 8 <= num_blocks; block += 8)
+	{
+		__m128i state[8];
+		for (int j = 0; j < 8; j++)
+		{
+			state[j] = _mm_xor_si128(_mm_shuffle_epi8(counter_swapped, byte_swap), keys[0]);
+			counter_swapped = _mm_add_epi32(counter_swapped, one);
+		}
+		for (int i = 1; i < num_rounds; i++)
+		{
+			for (int j = 0; j < 8; j++)
+				state[j] = _mm_aesenc_si128(state[j], keys[i]);
+		}
+		for (int j = 0; j < 8; j++)
+		{
+			state[j] = _mm_aesenclast_si128(state[j], keys[num_rounds]);
+			__m128i data = _mm_loadu_si128((const __m128i *) (input + (block + j) * 16));
+			_mm_storeu_si128((__m128i *) (output + (block + j) * 16), _mm_xor_si128(state[j], data));
+		}
+	}
+
+	for (; block < num_blocks; block++)
+	{
+		__m128i state = _mm_xor_si128(_mm_shuffle_epi8(counter_swapped, byte_swap), keys[0]);
+		counter_swapped = _mm_add_epi32(counter_swapped, one);
+		for (int i = 1; i < num_rounds; i++)
+			state = _mm_aesenc_si128(state, keys[i]);
+		state = _mm_aesenclast_si128(state, keys[num_rounds]);
+		__m128i data = _mm_loadu_si128((const __m128i *) (input + block * 16));
+		_mm_storeu_si128((__m128i *) (output + block * 16), _mm_xor_si128(state, data));
+	}
+
+	_mm_storeu_si128((__m128i *) counter, _mm_shuffle_epi8(counter_swapped, byte_swap));
+}
+
+#else
+
+void AES_NI::encrypt_cbc(const unsigned char *round_keys, int num_rounds, unsigned char iv[16], const unsigned char *input, unsigned char *output, int num_blocks)
+{
+	throw Exception("AES-NI is not available on this platform");
+}
+
+void AES_NI::decrypt_cbc(const unsigned char *round_keys, int num_rounds, unsigned char iv[16], const unsigned char *input, unsigned char *output, int num_blocks)
+{
+	throw Exception("AES-NI is not available on this platform");
+}
+
+void AES_NI::encrypt_ctr32(const unsigned char *round_keys, int num_rounds, unsigned char counter[16], const unsigned char *input, unsigned char *output, int num_blocks)
+{
+	throw Exception("AES-NI is not available on this platform");
+}
+
+#endif
+
+}
@@ -0,0 +1,61 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2015 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    agent
+*/
+
+
+#pragma once
+
+#include "API/Core/System/cl_platform.h"
+
+namespace clan
+{
+
+/// \brief AES using the AES-NI instructions
+///
+/// The functions must only be called when is_supported() returns true. Round keys are the expanded keys
+/// created by AES_Impl, converted with convert_key(). Decryption uses the expanded decryption key (the
+/// equivalent inverse cipher), which is the layout the AESDEC instruction expects.
+class AES_NI
+{
+public:
+	/// \brief Returns true if the CPU supports the AES instructions
+	static bool is_supported();
+
+	/// \brief Converts expanded key words to the byte order used by the AES instructions
+	static void convert_key(const ubyte32 *key_expanded, int num_rounds, unsigned char *round_keys);
+
+	/// \brief Cipher Block Chaining encryption. The iv is updated to the last output block.
+	static void encrypt_cbc(const unsigned char *round_keys, int num_rounds, unsigned char iv[16], const unsigned char *input, unsigned char *output, int num_blocks);
+
+	/// \brief Cipher Block Chaining decryption, eight blocks at a time. The iv is updated to the last input block.
+	static void decrypt_cbc(const unsigned char *round_keys, int num_rounds, unsigned char iv[16], const unsigned char *input, unsigned char *output, int num_blocks);
+
+	/// \brief Counter mode, eight blocks at a time. The last 32 bits of the counter are a big endian block counter (as in GCM) and are updated.
+	static void encrypt_ctr32(const unsigned char *round_keys, int num_rounds, unsigned char counter[16], const unsigned char *input, unsigned char *output, int num_blocks);
+};
+
+}
@@ -308,7 +308,7 @@ std::string ASN1::get_string() const
 	if (type_class != ASN1::class_universal)
 		throw_invalid();
 
-	if (!((tag == ASN1::tag_printablestring) || (tag == ASN1::tag_t61string)))
+	if (!((tag == ASN1::tag_printablestring) || (tag == ASN1::tag_t61string) || (tag == ASN1::tag_utf8string) || (tag == ASN1::tag_ia5string)))
 		throw_invalid();
 
 	const unsigned char *read_ptr = data_ptr;
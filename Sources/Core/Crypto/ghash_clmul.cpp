@@ -0,0 +1,186 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2015 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    agent
+*/
+
+#include "Core/precomp.h"
+#include "ghash_clmul.h"
+#include "API/Core/System/system.h"
+
+#if !defined(CL_ARM_PLATFORM) && !defined(CL_DISABLE_SSE2)
+#define CL_GHASH_CLMUL
+#include <wmmintrin.h>
+#include <tmmintrin.h>
+#endif
+
+// GCC and Clang only allow the PCLMULQDQ intrinsics in functions compiled for a CPU that has them
+#if defined(CL_GHASH_CLMUL) && defined(__GNUC__)
+#define CL_GHASH_CLMUL_TARGET __attribute__((target("pclmul,ssse3")))
+#else
+#define CL_GHASH_CLMUL_TARGET
+#endif
+
+namespace clan
+{
+
+bool GHASH_CLMUL::is_supported()
+{
+#ifdef CL_GHASH_CLMUL
+	static bool supported = System::detect_cpu_extension(System::pclmulqdq) && System::detect_cpu_extension(System::ssse3);
+	return supported;
+#else
+	return false;
+#endif
+}
+
+#ifdef CL_GHASH_CLMUL
+
+// GHASH works on bit reflected values. Reversing the bytes of a block gives a value where a carry-less
+// product, shifted left by one bit, is the reflected product (Intel white paper "Intel Carry-Less
+// Multiplication Instruction and its Usage for Computing the GCM Mode", algorithm 5).
+
+// Carry-less 128x128 bit multiplication, giving the 256 bit product as two halves
+static inline CL_GHASH_CLMUL_TARGET void clmul_multiply(__m128i a, __m128i b, __m128i &low, __m128i &high)
+{
+	__m128i t0 = _mm_clmulepi64_si128(a, b, 0x00);
+	__m128i t1 = _mm_clmulepi64_si128(a, b, 0x10);
+	__m128i t2 = _mm_clmulepi64_si128(a, b, 0x01);
+	__m128i t3 = _mm_clmulepi64_si128(a, b, 0x11);
+	t1 = _mm_xor_si128(t1, t2);
+	low = _mm_xor_si128(t0, _mm_slli_si128(t1, 8));
+	high = _mm_xor_si128(t3, _mm_srli_si128(t1, 8));
+}
+
+// Shifts the 256 bit product left by one bit and reduces it modulo the GCM polynomial x^128 + x^7 + x^2 + x + 1
+static inline CL_GHASH_CLMUL_TARGET __m128i clmul_reduce(__m128i low, __m128i high)
+{
+	__m128i carry_low = _mm_srli_epi32(low, 31);
+	__m128i carry_high = _mm_srli_epi32(high, 31);
+	low = _mm_slli_epi32(low, 1);
+	high = _mm_slli_epi32(high, 1);
+	__m128i carry_across = _mm_srli_si128(carry_low, 12);
+	carry_high = _mm_slli_si128(carry_high, 4);
+	carry_low = _mm_slli_si128(carry_low, 4);
+	low = _mm_or_si128(low, carry_low);
+	high = _mm_or_si128(high, carry_high);
+	high = _mm_or_si128(high, carry_across);
+
+	__m128i a = _mm_slli_epi32(low, 31);
+	__m128i b = _mm_slli_epi32(low, 30);
+	__m128i c = _mm_slli_epi32(low, 25);
+	a = _mm_xor_si128(a, b);
+	a = _mm_xor_si128(a, c);
+	__m128i d = _mm_srli_si128(a, 4);
+	a = _mm_slli_si128(a, 12);
+	low = _mm_xor_si128(low, a);
+
+	__m128i e = _mm_srli_epi32(low, 1);
+	__m128i f = _mm_srli_epi32(low, 2);
+	__m128i g = _mm_srli_epi32(low, 7);
+	e = _mm_xor_si128(e, f);
+	e = _mm_xor_si128(e, g);
+	e = _mm_xor_si128(e, d);
+	low = _mm_xor_si128(low, e);
+	return _mm_xor_si128(high, low);
+}
+
+static inline CL_GHASH_CLMUL_TARGET __m128i clmul_gfmul(__m128i a, __m128i b)
+{
+	__m128i low, high;
+	clmul_multiply(a, b, low, high);
+	return clmul_reduce(low, high);
+}
+
+CL_GHASH_CLMUL_TARGET void GHASH_CLMUL::init(const unsigned char h[16], unsigned char key_table[key_table_size])
+{
+	const __m128i byte_swap = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+	__m128i h1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) h), byte_swap);
+	__m128i h2 = clmul_gfmul(h1, h1);
+	__m128i h3 = clmul_gfmul(h2, h1);
+	__m128i h4 = clmul_gfmul(h3, h1);
+	_mm_storeu_si128((__m128i *) key_table, h1);
+	_mm_storeu_si128((__m128i *) (key_table + 16), h2);
+	_mm_storeu_si128((__m128i *) (key_table + 32), h3);
+	_mm_storeu_si128((__m128i *) (key_table + 48), h4);
+}
+
+CL_GHASH_CLMUL_TARGET void GHASH_CLMUL::process_blocks(const unsigned char key_table[key_table_size], unsigned char state[16], const unsigned char *data, int num_blocks)
+{
+	const __m128i byte_swap = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+	__m128i h1 = _mm_loadu_si128((const __m128i *) key_table);
+	__m128i h2 = _mm_loadu_si128((const __m128i *) (key_table + 16));
+	__m128i h3 = _mm_loadu_si128((const __m128i *) (key_table + 32));
+	__m128i h4 = _mm_loadu_si128((const __m128i *) (key_table + 48));
+	__m128i x = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) state), byte_swap);
+
+	// ((((x + d0) * H + d1) * H + d2) * H + d3) * H equals (x + d0) * H^4 + d1 * H^3 + d2 * H^2 + d3 * H,
+	// and as the reduction is linear the four products can be added together before reducing them once
+	int block = 0;
+	for (; block + 4 <= num_blocks; block += 4)
+	{
+		__m128i d0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) (data + block * 16)), byte_swap);
+		__m128i d1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) (data + block * 16 + 16)), byte_swap);
+		__m128i d2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) (data + block * 16 + 32)), byte_swap);
+		__m128i d3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) (data + block * 16 + 48)), byte_swap);
+
+		__m128i low, high, low_sum, high_sum;
+		clmul_multiply(_mm_xor_si128(x, d0), h4, low_sum, high_sum);
+		clmul_multiply(d1, h3, low, high);
+		low_sum = _mm_xor_si128(low_sum, low);
+		high_sum = _mm_xor_si128(high_sum, high);
+		clmul_multiply(d2, h2, low, high);
+		low_sum = _mm_xor_si128(low_sum, low);
+		high_sum = _mm_xor_si128(high_sum, high);
+		clmul_multiply(d3, h1, low, high);
+		low_sum = _mm_xor_si128(low_sum, low);
+		high_sum = _mm_xor_si128(high_sum, high);
+		x = clmul_reduce(low_sum, high_sum);
+	}
+
+	for (; block < num_blocks; block++)
+	{
+		__m128i d = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) (data + block * 16)), byte_swap);
+		x = clmul_gfmul(_mm_xor_si128(x, d), h1);
+	}
+
+	_mm_storeu_si128((__m128i *) state, _mm_shuffle_epi8(x, byte_swap));
+}
+
+#else
+
+void GHASH_CLMUL::init(const unsigned char h[16], unsigned char key_table[key_table_size])
+{
+	throw Exception("PCLMULQDQ is not available on this platform");
+}
+
+void GHASH_CLMUL::process_blocks(const unsigned char key_table[key_table_size], unsigned char state[16], const unsigned char *data, int num_blocks)
+{
+	throw Exception("PCLMULQDQ is not available on this platform");
+}
+
+#endif
+
+}
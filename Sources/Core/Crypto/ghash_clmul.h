@@ -0,0 +1,55 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2015 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    agent
+*/
+
+#pragma once
+
+#include "API/Core/System/cl_platform.h"
+
+namespace clan
+{
+
+/// \brief GHASH (the GCM authentication function) using the PCLMULQDQ carry-less multiplication instruction
+///
+/// The functions must only be called when is_supported() returns true. The hash key table holds the
+/// powers H, H^2, H^3 and H^4 of the hash subkey, so four blocks can share a single reduction.
+class GHASH_CLMUL
+{
+public:
+	static const int key_table_size = 4 * 16;
+
+	/// \brief Returns true if the CPU supports the carry-less multiplication instruction
+	static bool is_supported();
+
+	/// \brief Creates the hash key table from the hash subkey H
+	static void init(const unsigned char h[16], unsigned char key_table[key_table_size]);
+
+	/// \brief Hashes whole blocks, updating the 16 byte hash state
+	static void process_blocks(const unsigned char key_table[key_table_size], unsigned char state[16], const unsigned char *data, int num_blocks);
+};
+
+}
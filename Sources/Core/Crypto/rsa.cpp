@@ -46,6 +46,13 @@ void RSA::create_keypair(Random &random, Secret &out_private_exponent, DataBuffe
 	rsa_impl.create_keypair(random, out_private_exponent, out_public_exponent, out_modulus, key_size_in_bits, public_exponent_value);
 }
 
+void RSA::create_keypair(Random &random, Secret &out_private_exponent, DataBuffer &out_public_exponent, DataBuffer &out_modulus, Secret &out_prime1, Secret &out_prime2, Secret &out_exponent1, Secret &out_exponent2, Secret &out_coefficient, int key_size_in_bits, int public_exponent_value)
+{
+	RSA_Impl rsa_impl;
+	rsa_impl.create_keypair(random, out_private_exponent, out_public_exponent, out_modulus, key_size_in_bits, public_exponent_value);
+	rsa_impl.get_crt_key(out_prime1, out_prime2, out_exponent1, out_exponent2, out_coefficient);
+}
+
 DataBuffer RSA::encrypt(int block_type, Random &random, const DataBuffer &in_public_exponent, const DataBuffer &in_modulus, const Secret &in_data)
 {
 	return RSA_Impl::encrypt(block_type, random, in_public_exponent.get_data(), in_public_exponent.get_size(), in_modulus.get_data(), in_modulus.get_size(), in_data.get_data(), in_data.get_size());
@@ -66,4 +73,14 @@ Secret RSA::decrypt(const Secret &in_private_exponent, const void *in_modulus, u
 	return RSA_Impl::decrypt( in_private_exponent, in_modulus, in_modulus_size, in_data, in_data_size);
 }
 
+Secret RSA::decrypt(const Secret &in_prime1, const Secret &in_prime2, const Secret &in_exponent1, const Secret &in_exponent2, const Secret &in_coefficient, const DataBuffer &in_data)
+{
+	return RSA_Impl::decrypt(in_prime1, in_prime2, in_exponent1, in_exponent2, in_coefficient, in_data.get_data(), in_data.get_size());
+}
+
+Secret RSA::decrypt(const Secret &in_prime1, const Secret &in_prime2, const Secret &in_exponent1, const Secret &in_exponent2, const Secret &in_coefficient, const void *in_data, unsigned int in_data_size)
+{
+	return RSA_Impl::decrypt(in_prime1, in_prime2, in_exponent1, in_exponent2, in_coefficient, in_data, in_data_size);
+}
+
 }
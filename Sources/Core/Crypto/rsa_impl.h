@@ -84,6 +84,7 @@ public:
 
 	static DataBuffer encrypt(int block_type, Random &random, const void *in_public_exponent, unsigned int in_public_exponent_size, const void *in_modulus, unsigned int in_modulus_size, const void *in_data, unsigned int in_data_size);
 	static Secret decrypt(const Secret &in_private_exponent, const void *in_modulus, unsigned int in_modulus_size, const void *in_data, unsigned int in_data_size);
+	static Secret decrypt(const Secret &in_prime1, const Secret &in_prime2, const Secret &in_exponent1, const Secret &in_exponent2, const Secret &in_coefficient, const void *in_data, unsigned int in_data_size);
 
 /// \}
 /// \name Operations
@@ -103,6 +104,11 @@ public:
 	/// \param public_exponent_value = public exponent value
 	void create_keypair(Random &random, Secret &out_private_exponent, DataBuffer &out_public_exponent, DataBuffer &out_modulus, int key_size_in_bits, int public_exponent_value);
 
+	/// \brief Get the private key parts used for decrypting with the chinese remainder theorem
+	///
+	/// Only valid after create() or create_keypair()
+	void get_crt_key(Secret &out_prime1, Secret &out_prime2, Secret &out_exponent1, Secret &out_exponent2, Secret &out_coefficient) const;
+
 /// \}
 /// \name Implementation
 /// \{
@@ -113,6 +119,8 @@ private:
 
 	static void rsaep(BigInt *msg, const BigInt *e, const BigInt *modulus, BigInt *cipher);
 	static void rsadp(BigInt *cipher, const BigInt *d, const BigInt *modulus, BigInt *msg);
+	static void rsadp(BigInt *cipher, const RSAPrivateKey &key, BigInt *msg);
+	static Secret to_secret(const BigInt &value);
 
 	// PKCS#1 v.1.5 message padding and encoding
 	// msg       - input message
@@ -141,6 +149,12 @@ private:
 	// modulus   - decryption key modulus
 	static Secret pkcs1v15_decrypt(const char *msg, int mlen, const BigInt *d, const BigInt *modulus);
 
+	// Decrypt a message using RSA with the chinese remainder theorem and PKCS#1 v1.5 padding
+	// msg       - input message (ciphertext)
+	// mlen      - length of input message, in bytes
+	// key       - private key, the modulus and the prime1, prime2, exponent1, exponent2 and coefficient parts must be set
+	static Secret pkcs1v15_decrypt(const char *msg, int mlen, const RSAPrivateKey &key);
+
 	RSAPrivateKey rsa_private_key;
 /// \}
 };
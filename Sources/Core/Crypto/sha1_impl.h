@@ -72,6 +72,7 @@ public:
 
 private:
 	void process_chunk();
+	void process_blocks(const unsigned char *data, int num_blocks);
 
 	inline unsigned int leftrotate_uint32(unsigned int value, int shift) const
 	{
@@ -91,6 +92,7 @@ private:
 	bool calculated;
 
 	bool hmac_enabled;
+	bool use_sha_ni;
 	unsigned char hmac_key_chunk[block_size];
 /// \}
 };
@@ -102,6 +102,7 @@ private:
 	}
 
 	void process_chunk();
+	void process_blocks(const unsigned char *data, int num_blocks);
 
 	ubyte32 h0, h1, h2, h3, h4, h5, h6, h7;
 
@@ -117,6 +118,7 @@ private:
 
 	cl_sha_type sha_type;
 	bool hmac_enabled;
+	bool use_sha_ni;
 	unsigned char hmac_key_chunk[block_size];
 /// \}
 };
@@ -0,0 +1,204 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2015 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    agent
+*/
+
+
+#include "Core/precomp.h"
+#include "sha_ni.h"
+#include "API/Core/System/system.h"
+
+#if !defined(CL_ARM_PLATFORM) && !defined(CL_DISABLE_SSE2)
+#define CL_SHA_NI
+#include <immintrin.h>
+#endif
+
+// GCC and Clang only allow the SHA intrinsics in functions compiled for a CPU that has them
+#if defined(CL_SHA_NI) && defined(__GNUC__)
+#define CL_SHA_NI_TARGET __attribute__((target("sha,sse4.1")))
+#else
+#define CL_SHA_NI_TARGET
+#endif
+
+namespace clan
+{
+
+bool SHA_NI::is_supported()
+{
+#ifdef CL_SHA_NI
+	static bool supported = System::detect_cpu_extension(System::sha) && System::detect_cpu_extension(System::sse4_1);
+	return supported;
+#else
+	return false;
+#endif
+}
+
+#ifdef CL_SHA_NI
+
+// Four rounds of SHA-1. msg holds the last 16 message words; the message schedule for the following rounds is
+// computed in between, as in the Intel SHA extensions reference. g is the group of four rounds (0 to 19).
+#define CL_SHA1_ROUNDS4(g, e_in, e_out) \
+	e_in = _mm_sha1nexte_epu32(e_in, msg[(g) % 4]); \
+	e_out = abcd; \
+	if ((g) >= 3 && (g) <= 18) msg[((g) + 1) % 4] = _mm_sha1msg2_epu32(msg[((g) + 1) % 4], msg[(g) % 4]); \
+	abcd = _mm_sha1rnds4_epu32(abcd, e_in, (g) / 5); \
+	if ((g) >= 1 && (g) <= 16) msg[((g) + 3) % 4] = _mm_sha1msg1_epu32(msg[((g) + 3) % 4], msg[(g) % 4]); \
+	if ((g) >= 2 && (g) <= 17) msg[((g) + 2) % 4] = _mm_xor_si128(msg[((g) + 2) % 4], msg[(g) % 4]);
+
+CL_SHA_NI_TARGET void SHA_NI::sha1_process_blocks(ubyte32 state[5], const unsigned char *data, int num_blocks)
+{
+	const __m128i byte_swap = _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+
+	__m128i abcd = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *) state), 0x1B);
+	__m128i e0 = _mm_set_epi32(state[4], 0, 0, 0);
+	__m128i e1;
+	__m128i msg[4];
+
+	for (int block = 0; block < num_blocks; block++, data += 64)
+	{
+		__m128i abcd_save = abcd;
+		__m128i e0_save = e0;
+
+		for (int i = 0; i < 4; i++)
+			msg[i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) (data + i * 16)), byte_swap);
+
+		e0 = _mm_add_epi32(e0, msg[0]);
+		e1 = abcd;
+		abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+		CL_SHA1_ROUNDS4(1, e1, e0);
+		CL_SHA1_ROUNDS4(2, e0, e1);
+		CL_SHA1_ROUNDS4(3, e1, e0);
+		CL_SHA1_ROUNDS4(4, e0, e1);
+		CL_SHA1_ROUNDS4(5, e1, e0);
+		CL_SHA1_ROUNDS4(6, e0, e1);
+		CL_SHA1_ROUNDS4(7, e1, e0);
+		CL_SHA1_ROUNDS4(8, e0, e1);
+		CL_SHA1_ROUNDS4(9, e1, e0);
+		CL_SHA1_ROUNDS4(10, e0, e1);
+		CL_SHA1_ROUNDS4(11, e1, e0);
+		CL_SHA1_ROUNDS4(12, e0, e1);
+		CL_SHA1_ROUNDS4(13, e1, e0);
+		CL_SHA1_ROUNDS4(14, e0, e1);
+		CL_SHA1_ROUNDS4(15, e1, e0);
+		CL_SHA1_ROUNDS4(16, e0, e1);
+		CL_SHA1_ROUNDS4(17, e1, e0);
+		CL_SHA1_ROUNDS4(18, e0, e1);
+		CL_SHA1_ROUNDS4(19, e1, e0);
+
+		e0 = _mm_sha1nexte_epu32(e0, e0_save);
+		abcd = _mm_add_epi32(abcd, abcd_save);
+	}
+
+	_mm_storeu_si128((__m128i *) state, _mm_shuffle_epi32(abcd, 0x1B));
+	state[4] = _mm_extract_epi32(e0, 3);
+}
+
+#undef CL_SHA1_ROUNDS4
+
+static const ubyte32 sha256_round_constants[64] =
+{
+	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+	0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+	0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+	0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+	0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+	0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+	0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+	0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+// Four rounds of SHA-256, with the message schedule computed in between as in the Intel SHA extensions reference.
+// g is the group of four rounds (0 to 15).
+#define CL_SHA256_ROUNDS4(g) \
+	tmp = _mm_add_epi32(msg[(g) % 4], _mm_loadu_si128((const __m128i *) (sha256_round_constants + (g) * 4))); \
+	state1 = _mm_sha256rnds2_epu32(state1, state0, tmp); \
+	if ((g) >= 3 && (g) <= 14) msg[((g) + 1) % 4] = _mm_sha256msg2_epu32(_mm_add_epi32(msg[((g) + 1) % 4], _mm_alignr_epi8(msg[(g) % 4], msg[((g) + 3) % 4], 4)), msg[(g) % 4]); \
+	state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(tmp, 0x0E)); \
+	if ((g) >= 1 && (g) <= 12) msg[((g) + 3) % 4] = _mm_sha256msg1_epu32(msg[((g) + 3) % 4], msg[(g) % 4]);
+
+CL_SHA_NI_TARGET void SHA_NI::sha256_process_blocks(ubyte32 state[8], const unsigned char *data, int num_blocks)
+{
+	const __m128i byte_swap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+	// The instructions want the state as ABEF and CDGH
+	__m128i tmp = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *) state), 0xB1);
+	__m128i state1 = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *) (state + 4)), 0x1B);
+	__m128i state0 = _mm_alignr_epi8(tmp, state1, 8);
+	state1 = _mm_blend_epi16(state1, tmp, 0xF0);
+	__m128i msg[4];
+
+	for (int block = 0; block < num_blocks; block++, data += 64)
+	{
+		__m128i abef_save = state0;
+		__m128i cdgh_save = state1;
+
+		for (int i = 0; i < 4; i++)
+			msg[i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) (data + i * 16)), byte_swap);
+
+		CL_SHA256_ROUNDS4(0);
+		CL_SHA256_ROUNDS4(1);
+		CL_SHA256_ROUNDS4(2);
+		CL_SHA256_ROUNDS4(3);
+		CL_SHA256_ROUNDS4(4);
+		CL_SHA256_ROUNDS4(5);
+		CL_SHA256_ROUNDS4(6);
+		CL_SHA256_ROUNDS4(7);
+		CL_SHA256_ROUNDS4(8);
+		CL_SHA256_ROUNDS4(9);
+		CL_SHA256_ROUNDS4(10);
+		CL_SHA256_ROUNDS4(11);
+		CL_SHA256_ROUNDS4(12);
+		CL_SHA256_ROUNDS4(13);
+		CL_SHA256_ROUNDS4(14);
+		CL_SHA256_ROUNDS4(15);
+
+		state0 = _mm_add_epi32(state0, abef_save);
+		state1 = _mm_add_epi32(state1, cdgh_save);
+	}
+
+	tmp = _mm_shuffle_epi32(state0, 0x1B);
+	state1 = _mm_shuffle_epi32(state1, 0xB1);
+	_mm_storeu_si128((__m128i *) state, _mm_blend_epi16(tmp, state1, 0xF0));
+	_mm_storeu_si128((__m128i *) (state + 4), _mm_alignr_epi8(state1, tmp, 8));
+}
+
+#undef CL_SHA256_ROUNDS4
+
+#else
+
+void SHA_NI::sha1_process_blocks(ubyte32 state[5], const unsigned char *data, int num_blocks)
+{
+	throw Exception("SHA instructions are not available on this platform");
+}
+
+void SHA_NI::sha256_process_blocks(ubyte32 state[8], const unsigned char *data, int num_blocks)
+{
+	throw Exception("SHA instructions are not available on this platform");
+}
+
+#endif
+
+}
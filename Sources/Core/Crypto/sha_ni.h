@@ -0,0 +1,53 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2015 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    agent
+*/
+
+
+#pragma once
+
+#include "API/Core/System/cl_platform.h"
+
+namespace clan
+{
+
+/// \brief SHA-1 and SHA-256 compression using the SHA instructions
+///
+/// The functions must only be called when is_supported() returns true.
+class SHA_NI
+{
+public:
+	/// \brief Returns true if the CPU supports the SHA instructions
+	static bool is_supported();
+
+	/// \brief Processes 64 byte blocks, updating the five SHA-1 state words (h0 to h4)
+	static void sha1_process_blocks(ubyte32 state[5], const unsigned char *data, int num_blocks);
+
+	/// \brief Processes 64 byte blocks, updating the eight SHA-256 state words (h0 to h7). Also used for SHA-224.
+	static void sha256_process_blocks(ubyte32 state[8], const unsigned char *data, int num_blocks);
+};
+
+}
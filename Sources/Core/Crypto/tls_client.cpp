@@ -58,6 +58,11 @@ int TLSClient::get_encrypted_data_available() const
 	return impl->get_encrypted_data_available();
 }
 
+bool TLSClient::is_session_resumed() const
+{
+	return impl->is_session_resumed();
+}
+
 int TLSClient::encrypt(const void *data, int size)
 {
 	return impl->encrypt(data, size);
@@ -78,4 +83,9 @@ void TLSClient::encrypted_data_consumed(int size)
 	impl->encrypted_data_consumed(size);
 }
 
+void TLSClient::enable_session_resumption(const std::string &server_name)
+{
+	impl->enable_session_resumption(server_name);
+}
+
 }
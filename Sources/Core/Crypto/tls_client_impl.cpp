@@ -36,6 +36,7 @@
 #include "API/Core/Crypto/aes256_encrypt.h"
 #include "API/Core/Crypto/aes256_decrypt.h"
 #include "API/Core/IOData/file.h"
+#include "API/Core/System/system.h"
 #include <ctime>
 #include <algorithm>
 #include "x509.h"
@@ -46,14 +47,21 @@ namespace clan
 
 TLSClient_Impl::TLSClient_Impl() :
 	recv_in_data_read_pos(0), recv_out_data_read_pos(0), send_in_data_read_pos(0), send_out_data_read_pos(0), handshake_in_read_pos(0),
-	conversation_state(cl_tls_state_send_client_hello), security_parameters(), protocol(), is_protocol_chosen()
+	conversation_state(cl_tls_state_send_client_hello), security_parameters(), protocol(), client_version(), is_protocol_chosen(), is_resumed(false)
 {
-	// Set TLS 3.1
-	protocol.major = 3;
-	protocol.minor = 1;
+	// Offer TLS 1.2 (protocol 3.3). The server may choose TLS 1.0 or 1.1 instead
+	client_version.major = 3;
+	client_version.minor = 3;
+	protocol = client_version;
 	is_protocol_chosen = false;
 
 	create_security_parameters_client_random();
+
+	// Reserve the largest sizes the buffers reach, so records are never appended into a reallocation
+	send_in_data.set_capacity(desired_buffer_size);
+	send_out_data.set_capacity(desired_buffer_size + sizeof(TLS_Record) + max_ciphertext_record_length);
+	recv_in_data.set_capacity(desired_buffer_size);
+	recv_out_data.set_capacity(desired_buffer_size + max_record_length);
 }
 
 TLSClient_Impl::~TLSClient_Impl()
@@ -83,24 +91,44 @@ int TLSClient_Impl::get_encrypted_data_available() const
 int TLSClient_Impl::encrypt(const void *data, int size)
 {
 	if (size == 0)
+	{
+		progress_conversation();	// Allows the handshake to be started before there is anything to send
 		return 0;
+	}
+
+	// With nothing queued, AEAD records are encrypted straight from the caller's data into the send buffer
+	int bytes_encrypted = 0;
+	if (conversation_state == cl_tls_state_connected && security_parameters.cipher_type == cl_tls_cipher_type_aead && (int)send_in_data.get_size() == send_in_data_read_pos)
+	{
+		while (bytes_encrypted < size && can_send_record())
+		{
+			int data_in_record = clan::min(size - bytes_encrypted, (int)max_record_length);
+			send_aead_application_record(static_cast<const char*>(data) + bytes_encrypted, data_in_record);
+			bytes_encrypted += data_in_record;
+		}
+		if (bytes_encrypted == size)
+			return bytes_encrypted;
+	}
 
 	int insert_pos = send_in_data.get_size();
 	int buffer_space_available = desired_buffer_size - insert_pos;
-	int bytes_consumed = clan::min(size, buffer_space_available);
+	int bytes_consumed = clan::min(size - bytes_encrypted, buffer_space_available);
 
 	send_in_data.set_size(insert_pos + bytes_consumed);
-	memcpy(send_in_data.get_data() + insert_pos, data, bytes_consumed);
+	memcpy(send_in_data.get_data() + insert_pos, static_cast<const char*>(data) + bytes_encrypted, bytes_consumed);
 
 	progress_conversation();
 
-	return bytes_consumed;
+	return bytes_encrypted + bytes_consumed;
 }
 
 int TLSClient_Impl::decrypt(const void *data, int size)
 {
 	if (size == 0)
+	{
+		progress_conversation();
 		return 0;
+	}
 
 	int insert_pos = recv_in_data.get_size();
 	int buffer_space_available = desired_buffer_size - insert_pos;
@@ -152,6 +180,18 @@ void TLSClient_Impl::encrypted_data_consumed(int size)
 	progress_conversation();
 }
 
+void TLSClient_Impl::enable_session_resumption(const std::string &server_name)
+{
+	if (conversation_state != cl_tls_state_send_client_hello)
+		throw Exception("TLSClient session resumption must be enabled before the handshake starts");
+	session_name = server_name;
+}
+
+bool TLSClient_Impl::is_session_resumed() const
+{
+	return is_resumed;
+}
+
 void TLSClient_Impl::progress_conversation()
 {
 	try
@@ -205,6 +245,10 @@ void TLSClient_Impl::progress_conversation()
 	catch (...)
 	{
 		conversation_state = cl_tls_state_error;
+
+		// RFC 2246 (7.2.2): A session must not be resumed after a failed connection
+		if (!session_name.empty())
+			TLSSessionCache::remove(session_name);
 		throw;
 	}
 }
@@ -220,18 +264,25 @@ bool TLSClient_Impl::send_application_data()
 	unsigned int max_record_length_gcc_fix = max_record_length;
 	unsigned int data_in_record = clan::min((unsigned int)size, max_record_length_gcc_fix);
 
-	int offset = 0;
-	int offset_tls_record = offset;					offset += sizeof(TLS_Record);
-	int offset_tls_appdata = offset;				offset += data_in_record;
+	if (security_parameters.cipher_type == cl_tls_cipher_type_aead)
+	{
+		send_aead_application_record(data, data_in_record);
+	}
+	else
+	{
+		int offset = 0;
+		int offset_tls_record = offset;					offset += sizeof(TLS_Record);
+		int offset_tls_appdata = offset;				offset += data_in_record;
 
-	Secret message(offset);
-	unsigned char *message_ptr = message.get_data();
+		Secret message(offset);
+		unsigned char *message_ptr = message.get_data();
 
-	set_tls_record(message_ptr + offset_tls_record, cl_tls_content_application_data, offset - offset_tls_record);
+		set_tls_record(message_ptr + offset_tls_record, cl_tls_content_application_data, offset - offset_tls_record);
 
-	memcpy(message_ptr + offset_tls_appdata, data, data_in_record);
+		memcpy(message_ptr + offset_tls_appdata, data, data_in_record);
 
-	send_record(message_ptr, offset);
+		send_record(message_ptr, offset);
+	}
 
 
 	send_in_data_read_pos += data_in_record;
@@ -261,7 +312,7 @@ bool TLSClient_Impl::receive_record()
 
 	int record_length;
 	record_length = record.length[0] << 8 | record.length[1];
-	if (record_length > max_record_length)
+	if (record_length > max_ciphertext_record_length)
 		throw Exception("Maximum record length exceeded when receieving");
 	if (record_length == 0)	// The TLS Record Layer receives uninterpreted data from higher layers in non-empty blocks of arbitrary size.
 		throw Exception("Received an empty block");
@@ -281,6 +332,20 @@ bool TLSClient_Impl::receive_record()
 		// We set the protocol version in ServerHello
 	}
 
+	if (security_parameters.is_receive_encrypted && security_parameters.cipher_type == cl_tls_cipher_type_aead && record.type == cl_tls_content_application_data)
+	{
+		receive_aead_application_record(record, recv_in_data.get_data<unsigned char>() + recv_in_data_read_pos + sizeof(TLS_Record), record_length);
+		recv_in_data_read_pos += sizeof(TLS_Record) + record_length;
+		if (recv_in_data_read_pos > desired_buffer_size / 2)
+		{
+			int available = recv_in_data.get_size() - recv_in_data_read_pos;
+			memmove(recv_in_data.get_data(), recv_in_data.get_data() + recv_in_data_read_pos, available);
+			recv_in_data.set_size(available);
+			recv_in_data_read_pos = 0;
+		}
+		return true;
+	}
+
 	record_data_buffer.set_size(record_length);
 	memcpy(record_data_buffer.get_data(), recv_in_data.get_data() + recv_in_data_read_pos + sizeof(TLS_Record), record_length);
 
@@ -358,7 +423,12 @@ void TLSClient_Impl::alert_data(DataBuffer record_plaintext)
 	ubyte8 *alert_data = record_plaintext.get_data<ubyte8>();
 
 	if (alert_data[0] == cl_tls_warning)
+	{
+		// "The other party MUST respond with a close_notify alert of its own and close down the connection immediately"
+		if (alert_data[1] == cl_tls_close_notify)
+			send_close_notify();
 		return;
+	}
 
 	const char *desc = "Unknown";
 
@@ -469,71 +539,84 @@ void TLSClient_Impl::handshake_data(DataBuffer record_plaintext)
 	handshake_in_data.set_size(pos + record_plaintext.get_size());
 	memcpy(handshake_in_data.get_data() + pos, record_plaintext.get_data(), record_plaintext.get_size());
 
-	// Check if we have received enough data to peek at the handshake header:
-	int available = handshake_in_data.get_size() - handshake_in_read_pos;
-	if (available < sizeof(TLS_Handshake))
-		return;
+	// Process all complete messages, as servers usually send the server hello, certificate and server hello done in one record
+	while (true)
+	{
+		// Check if we have received enough data to peek at the handshake header:
+		int available = handshake_in_data.get_size() - handshake_in_read_pos;
+		if (available < sizeof(TLS_Handshake))
+			break;
 
-	// Check if we have received enough data to read the entire handshake message:
-	TLS_Handshake &handshake = *reinterpret_cast<TLS_Handshake*>(handshake_in_data.get_data() + handshake_in_read_pos);
-	int length = handshake.length[0] << 16 | handshake.length[1] << 8 | handshake.length[2];
-	if (sizeof(TLS_Handshake) + length > available)
-		return;
+		// Check if we have received enough data to read the entire handshake message:
+		TLS_Handshake &handshake = *reinterpret_cast<TLS_Handshake*>(handshake_in_data.get_data() + handshake_in_read_pos);
+		int length = handshake.length[0] << 16 | handshake.length[1] << 8 | handshake.length[2];
+		if (sizeof(TLS_Handshake) + length > available)
+			break;
 
-	const char *data = handshake_in_data.get_data() + handshake_in_read_pos + sizeof(TLS_Handshake);
+		const char *data = handshake_in_data.get_data() + handshake_in_read_pos + sizeof(TLS_Handshake);
+		ubyte8 msg_type = handshake.msg_type;
 
-	// We got a full message.
+		// We got a full message.
 
-	// All handshake messages except handshake_finished needs to be included in the handshake hash calculation:
-	if (handshake.msg_type != cl_tls_handshake_finished)
-	{
-		hash_handshake(&handshake, length + sizeof(TLS_Handshake));
-	}
+		// All handshake messages except handshake_finished needs to be included in the handshake hash calculation:
+		if (msg_type != cl_tls_handshake_finished)
+		{
+			hash_handshake(&handshake, length + sizeof(TLS_Handshake));
+		}
 
-	// Dispatch message for further parsing:
-	switch (handshake.msg_type)
-	{
-	case cl_tls_handshake_hello_request:
-		handshake_hello_request_received(data, length);
-		break;
-	case cl_tls_handshake_client_hello:
-		handshake_client_hello_received(data, length);
-		break;
-	case cl_tls_handshake_server_hello:
-		handshake_server_hello_received(data, length);
-		break;
-	case cl_tls_handshake_certificate:
-		handshake_certificate_received(data, length);
-		break;
-	case cl_tls_handshake_server_key_exchange:
-		handshake_server_key_exchange_received(data, length);
-		break;
-	case cl_tls_handshake_certificate_request:
-		handshake_certificate_request_received(data, length);
-		break;
-	case cl_tls_handshake_server_hello_done:
-		handshake_server_hello_done_received(data, length);
-		break;
-	case cl_tls_handshake_certificate_verify:
-		handshake_certificate_verify_received(data, length);
-		break;
-	case cl_tls_handshake_client_key_exchange:
-		handshake_client_key_exchange_received(data, length);
-		break;
-	case cl_tls_handshake_finished:
-		handshake_finished_received(data, length);
-		break;
-	default:
-		throw Exception("Unknown handshake type");
+		// Dispatch message for further parsing:
+		switch (msg_type)
+		{
+		case cl_tls_handshake_hello_request:
+			handshake_hello_request_received(data, length);
+			break;
+		case cl_tls_handshake_client_hello:
+			handshake_client_hello_received(data, length);
+			break;
+		case cl_tls_handshake_server_hello:
+			handshake_server_hello_received(data, length);
+			break;
+		case cl_tls_handshake_certificate:
+			handshake_certificate_received(data, length);
+			break;
+		case cl_tls_handshake_server_key_exchange:
+			handshake_server_key_exchange_received(data, length);
+			break;
+		case cl_tls_handshake_certificate_request:
+			handshake_certificate_request_received(data, length);
+			break;
+		case cl_tls_handshake_server_hello_done:
+			handshake_server_hello_done_received(data, length);
+			break;
+		case cl_tls_handshake_certificate_verify:
+			handshake_certificate_verify_received(data, length);
+			break;
+		case cl_tls_handshake_client_key_exchange:
+			handshake_client_key_exchange_received(data, length);
+			break;
+		case cl_tls_handshake_finished:
+			handshake_finished_received(data, length);
+			break;
+		default:
+			throw Exception("Unknown handshake type");
+		}
+
+		// The verified server finished message is part of the client finished verify data when a session is resumed
+		if (msg_type == cl_tls_handshake_finished)
+		{
+			hash_handshake(handshake_in_data.get_data() + handshake_in_read_pos, length + sizeof(TLS_Handshake));
+		}
+
+		handshake_in_read_pos += sizeof(TLS_Handshake) + length;
 	}
 
-	// Remove processed handshake message from the input buffer:
-	handshake_in_read_pos += sizeof(TLS_Handshake) + length;
+	// Remove processed handshake messages from the input buffer:
 	if (handshake_in_read_pos >= desired_buffer_size / 2)
 	{
-		available = handshake_in_data.get_size() - handshake_in_read_pos;
+		int available = handshake_in_data.get_size() - handshake_in_read_pos;
 		memmove(handshake_in_data.get_data(), handshake_in_data.get_data() + handshake_in_read_pos, available);
 		handshake_in_data.set_size(available);
+		handshake_in_read_pos = 0;
 	}
 }
 
@@ -618,7 +701,9 @@ void TLSClient_Impl::handshake_server_hello_received(const void *data, int size)
 
 	ubyte8 session_id_length;
 	copy_data(&session_id_length, 1, data, size);
-	Secret session_id(session_id_length);
+	if (session_id_length > 32)
+		throw Exception("TLS invalid session id length");
+	session_id = Secret(session_id_length);
 	copy_data(session_id.get_data(), session_id_length, data, size);
 
 	byte8 buffer[3];
@@ -627,7 +712,23 @@ void TLSClient_Impl::handshake_server_hello_received(const void *data, int size)
 	select_cipher_suite(buffer[0], buffer[1]);
 	select_compression_method(buffer[2]);
 
-	conversation_state = cl_tls_state_receive_certificate;
+	// The server accepts the session offered in the client hello by returning its session id
+	const Secret &offered_session_id = offered_session.session_id;
+	is_resumed = offered_session_id.get_size() > 0 && offered_session_id.get_size() == session_id.get_size() &&
+		!memcmp(offered_session_id.get_data(), session_id.get_data(), session_id.get_size());
+
+	if (is_resumed)
+	{
+		// The server goes straight to change cipher spec and finished, using the master secret of the session
+		resume_session();
+		conversation_state = cl_tls_state_receive_change_cipher_spec;
+	}
+	else
+	{
+		if (offered_session_id.get_size() > 0)
+			TLSSessionCache::remove(session_name);
+		conversation_state = cl_tls_state_receive_certificate;
+	}
 }
 
 void TLSClient_Impl::handshake_certificate_received(const void *data, int size)
@@ -705,22 +806,21 @@ void TLSClient_Impl::handshake_finished_received(const void *data, int size)
 	copy_data(server_verify_data.get_data(), verify_data_size, data, size);
 
 	Secret client_verify_data(verify_data_size);
-
-	Secret md5_handshake_messages(16);
-	Secret sha1_handshake_messages(20);
-
-	server_handshake_md5_hash.calculate();
-	server_handshake_sha1_hash.calculate();
-
-	server_handshake_md5_hash.get_hash(md5_handshake_messages.get_data());
-	server_handshake_sha1_hash.get_hash(sha1_handshake_messages.get_data());
-
-	PRF(client_verify_data.get_data(), verify_data_size, security_parameters.master_secret, "server finished", md5_handshake_messages, sha1_handshake_messages);
+	calculate_verify_data(client_verify_data.get_data(), verify_data_size, "server finished");
 
 	if (memcmp(client_verify_data.get_data(), server_verify_data.get_data(), verify_data_size))
 		throw Exception("TLS server finished verify data failed");
 
-	conversation_state = cl_tls_state_connected;
+	if (is_resumed)
+	{
+		// In an abbreviated handshake the client sends its change cipher spec and finished last
+		conversation_state = cl_tls_state_send_change_cipher_spec;
+	}
+	else
+	{
+		store_session();
+		conversation_state = cl_tls_state_connected;
+	}
 }
 
 bool TLSClient_Impl::can_send_record() const
@@ -747,8 +847,16 @@ void TLSClient_Impl::send_record(void *data_ptr, unsigned int data_size)
 		// "the encryption and MAC functions convert TLSCompressed.fragment structures to and from block TLSCiphertext.fragment structures."
 		const unsigned char *input_ptr = (const unsigned char *) data_ptr + sizeof(TLS_Record);
 		unsigned int input_size = data_size - sizeof(TLS_Record);
-		Secret mac = calculate_mac(data_ptr, data_size, nullptr, 0, security_parameters.write_sequence_number, security_parameters.client_write_mac_secret);	// MAC includes the header and sequence number
-		DataBuffer encrypted = encrypt_data(input_ptr , input_size, mac.get_data(), mac.get_size());
+		DataBuffer encrypted;
+		if (security_parameters.cipher_type == cl_tls_cipher_type_aead)
+		{
+			encrypted = encrypt_aead_record(*record_ptr, input_ptr, input_size);
+		}
+		else
+		{
+			Secret mac = calculate_mac(data_ptr, data_size, nullptr, 0, security_parameters.write_sequence_number, security_parameters.client_write_mac_secret);	// MAC includes the header and sequence number
+			encrypted = encrypt_data(input_ptr , input_size, mac.get_data(), mac.get_size());
+		}
 
 		// Update the length
 		int new_length = encrypted.get_size();
@@ -775,11 +883,7 @@ void TLSClient_Impl::send_record(void *data_ptr, unsigned int data_size)
 void TLSClient_Impl::reset()
 {
 	security_parameters.reset();
-
-	client_handshake_md5_hash.reset();
-	client_handshake_sha1_hash.reset();
-	server_handshake_md5_hash.reset();
-	server_handshake_sha1_hash.reset();
+	handshake_messages.set_size(0);
 }
 
 void TLSClient_Impl::copy_data(void *out_data, int size, const void *&data, int &data_left)
@@ -848,14 +952,16 @@ void TLSClient_Impl::set_tls_random(unsigned char *dest_ptr, Secret &time_and_ra
 
 int TLSClient_Impl::get_session_id_length() const
 {
-	// Enough to write single NUL
-	return 1;
+	// SessionID session_id<0..32>;
+	return 1 + offered_session.session_id.get_size();
 }
 
 void TLSClient_Impl::set_session_id(unsigned char *dest_ptr) const
 {
-	// Session id's are not supported
-	*dest_ptr = 0;
+	// An empty session id asks for a new session
+	*(dest_ptr++) = offered_session.session_id.get_size();
+	if (offered_session.session_id.get_size() > 0)
+		memcpy(dest_ptr, offered_session.session_id.get_data(), offered_session.session_id.get_size());
 }
 
 int TLSClient_Impl::get_compression_methods_length() const
@@ -888,21 +994,25 @@ void TLSClient_Impl::select_compression_method(ubyte8 value)
 int TLSClient_Impl::get_cipher_suites_length() const
 {
 	// CipherSuite cipher_suites<2..2^16-1>;
-	return 2 + (4*2);	// We support 4 cipher suites, each id contains 2 bytes
+	return 2 + (7*2);	// We support 6 cipher suites and the renegotiation info signalling suite, each id contains 2 bytes
 }
 
 void TLSClient_Impl::set_cipher_suites(unsigned char *dest_ptr) const
 {
-	const int num_ciphers = 4;	// If changing, you MUST change get_cipher_suites_length
+	const int num_ciphers = 7;	// If changing, you MUST change get_cipher_suites_length
 	int length = num_ciphers * 2;
 	*(dest_ptr++) = length >> 8;
 	*(dest_ptr++) = length;
 
 	// Strongest first ... maybe that should be controlled by the user, strong and fast first
+	// The GCM suites need no separate MAC and are only offered by TLS 1.2 servers
+	*(dest_ptr++) = 0x00;	*(dest_ptr++) = 0x9D;	// TLS_RSA_WITH_AES_256_GCM_SHA384
+	*(dest_ptr++) = 0x00;	*(dest_ptr++) = 0x9C;	// TLS_RSA_WITH_AES_128_GCM_SHA256
 	*(dest_ptr++) = 0x00;	*(dest_ptr++) = 0x3D;	// TLS_RSA_WITH_AES_256_CBC_SHA256
 	*(dest_ptr++) = 0x00;	*(dest_ptr++) = 0x3C;	// TLS_RSA_WITH_AES_128_CBC_SHA256
 	*(dest_ptr++) = 0x00;	*(dest_ptr++) = 0x35;	// TLS_RSA_WITH_AES_256_CBC_SHA
 	*(dest_ptr++) = 0x00;	*(dest_ptr++) = 0x2F;	// TLS_RSA_WITH_AES_128_CBC_SHA
+	*(dest_ptr++) = 0x00;	*(dest_ptr++) = 0xFF;	// TLS_EMPTY_RENEGOTIATION_INFO_SCSV (RFC 5746), we never renegotiate
 }
 
 void TLSClient_Impl::select_cipher_suite(ubyte8 value1, ubyte8 value2)
@@ -911,6 +1021,28 @@ void TLSClient_Impl::select_cipher_suite(ubyte8 value1, ubyte8 value2)
 	{
 		switch (value2)
 		{
+			case 0x9D:	// TLS_RSA_WITH_AES_256_GCM_SHA384
+			{
+				security_parameters.cipher_type = cl_tls_cipher_type_aead;
+				security_parameters.mac_algorithm = cl_tls_mac_algorithm_null;
+				security_parameters.prf_algorithm = cl_tls_prf_algorithm_sha384;
+				security_parameters.bulk_cipher_algorithm = cl_tls_cipher_algorithm_aes256;
+				security_parameters.hash_size = 0;
+				security_parameters.iv_size = 4;	// RFC 5288 (3): The implicit part of the nonce
+				security_parameters.key_material_length = AES256_Encrypt::key_size;
+				break;
+			}
+			case 0x9C:	// TLS_RSA_WITH_AES_128_GCM_SHA256
+			{
+				security_parameters.cipher_type = cl_tls_cipher_type_aead;
+				security_parameters.mac_algorithm = cl_tls_mac_algorithm_null;
+				security_parameters.prf_algorithm = cl_tls_prf_algorithm_sha256;
+				security_parameters.bulk_cipher_algorithm = cl_tls_cipher_algorithm_aes128;
+				security_parameters.hash_size = 0;
+				security_parameters.iv_size = 4;	// RFC 5288 (3): The implicit part of the nonce
+				security_parameters.key_material_length = AES128_Encrypt::key_size;
+				break;
+			}
 			case 0x3D:	// TLS_RSA_WITH_AES_256_CBC_SHA256
 			{
 				security_parameters.mac_algorithm = cl_tls_mac_algorithm_sha256;
@@ -956,6 +1088,42 @@ void TLSClient_Impl::select_cipher_suite(ubyte8 value1, ubyte8 value2)
 	{
 		throw Exception("TLS unsupported cipher suite");
 	}
+
+	bool is_tls12_suite = security_parameters.cipher_type == cl_tls_cipher_type_aead || security_parameters.mac_algorithm == cl_tls_mac_algorithm_sha256;
+	if (is_tls12_suite && protocol.minor < 3)
+		throw Exception("TLS server selected a cipher suite that requires TLS 1.2");
+
+	security_parameters.cipher_suite[0] = value1;
+	security_parameters.cipher_suite[1] = value2;
+}
+
+void TLSClient_Impl::resume_session()
+{
+	// RFC 2246 (7.4.1.3): The server must resume the session with the same version and cipher suite
+	if (protocol.major != offered_session.protocol_major || protocol.minor != offered_session.protocol_minor ||
+		security_parameters.cipher_suite[0] != offered_session.cipher_suite[0] || security_parameters.cipher_suite[1] != offered_session.cipher_suite[1])
+		throw Exception("TLS server resumed the session with different parameters");
+
+	memcpy(security_parameters.master_secret.get_data(), offered_session.master_secret.get_data(), security_parameters.master_secret.get_size());
+	create_keys();
+}
+
+void TLSClient_Impl::store_session()
+{
+	if (session_name.empty() || session_id.get_size() == 0)
+		return;
+
+	TLSSession session;
+	session.session_id = Secret(session_id.get_size());
+	memcpy(session.session_id.get_data(), session_id.get_data(), session_id.get_size());
+	session.master_secret = Secret(security_parameters.master_secret.get_size());
+	memcpy(session.master_secret.get_data(), security_parameters.master_secret.get_data(), security_parameters.master_secret.get_size());
+	session.protocol_major = protocol.major;
+	session.protocol_minor = protocol.minor;
+	session.cipher_suite[0] = security_parameters.cipher_suite[0];
+	session.cipher_suite[1] = security_parameters.cipher_suite[1];
+	session.creation_time = System::get_time();
+	TLSSessionCache::store(session_name, session);
 }
 
 bool TLSClient_Impl::send_client_hello()
@@ -963,6 +1131,9 @@ bool TLSClient_Impl::send_client_hello()
 	if (!can_send_record())
 		return false;
 
+	if (!session_name.empty())
+		TLSSessionCache::find(session_name, offered_session);
+
 	int offset = 0;
 	int offset_tls_record = offset;					offset += sizeof(TLS_Record);
 	int offset_tls_handshake = offset;				offset += sizeof(TLS_Handshake);
@@ -1012,13 +1183,42 @@ bool TLSClient_Impl::send_client_key_exchange()
 	Secret pre_master_secret(48);
 	unsigned char *pms_ptr = pre_master_secret.get_data();
 	m_Random.get_random_bytes(pms_ptr + 2, 46);
-	pms_ptr[0] = protocol.major;	// Version number
-	pms_ptr[1] = protocol.minor;
+	pms_ptr[0] = client_version.major;	// Version number offered in the client hello (RFC 5246 7.4.7.1)
+	pms_ptr[1] = client_version.minor;
 
 	DataBuffer wrapped_pre_master_secret = RSA::encrypt(2, m_Random, server_public_exponent,  server_public_modulus, pre_master_secret);
 
 	PRF(security_parameters.master_secret.get_data(), security_parameters.master_secret.get_size(), pre_master_secret, "master secret", security_parameters.client_random, security_parameters.server_random);
 
+	create_keys();
+
+	const int wrapped_pre_master_secret_length = wrapped_pre_master_secret.get_size();
+
+	int offset = 0;
+	int offset_tls_record = offset;					offset += sizeof(TLS_Record);
+	int offset_tls_handshake = offset;				offset += sizeof(TLS_Handshake);
+	int offset_tls_encrypted_pre_master_secret_length = offset;	offset+= 2;
+	int offset_tls_encrypted_pre_master_secret = offset;	offset+= wrapped_pre_master_secret_length;
+
+	Secret message(offset);	// keep data secure
+	unsigned char *message_ptr = message.get_data();
+	set_tls_record(message_ptr + offset_tls_record, cl_tls_content_handshake, offset - offset_tls_record);
+	set_tls_handshake(message_ptr + offset_tls_handshake, cl_tls_handshake_client_key_exchange, offset - offset_tls_handshake);
+
+	memcpy(message_ptr + offset_tls_encrypted_pre_master_secret, wrapped_pre_master_secret.get_data(), wrapped_pre_master_secret_length);
+	message_ptr[offset_tls_encrypted_pre_master_secret_length] = wrapped_pre_master_secret_length >> 8;
+	message_ptr[offset_tls_encrypted_pre_master_secret_length+1] = wrapped_pre_master_secret_length;
+
+	hash_handshake( message_ptr + offset_tls_handshake, offset - offset_tls_handshake);
+
+	send_record(message_ptr, offset);
+
+	conversation_state = cl_tls_state_send_change_cipher_spec;
+	return true;
+}
+
+void TLSClient_Impl::create_keys()
+{
 	Secret key_block( 2 * (security_parameters.hash_size + security_parameters.key_material_length + security_parameters.iv_size ) );
 	PRF(key_block.get_data(), key_block.get_size(), security_parameters.master_secret, "key expansion", security_parameters.server_random, security_parameters.client_random);
 
@@ -1049,32 +1249,71 @@ bool TLSClient_Impl::send_client_key_exchange()
 	memcpy(security_parameters.server_write_iv.get_data(), key_block_ptr, security_parameters.server_write_iv.get_size());
 	key_block_ptr+=security_parameters.server_write_iv.get_size();
 
-	const int wrapped_pre_master_secret_length = wrapped_pre_master_secret.get_size();
-
-	int offset = 0;
-	int offset_tls_record = offset;					offset += sizeof(TLS_Record);
-	int offset_tls_handshake = offset;				offset += sizeof(TLS_Handshake);
-	int offset_tls_encrypted_pre_master_secret_length = offset;	offset+= 2;
-	int offset_tls_encrypted_pre_master_secret = offset;	offset+= wrapped_pre_master_secret_length;
-
-	Secret message(offset);	// keep data secure
-	unsigned char *message_ptr = message.get_data();
-	set_tls_record(message_ptr + offset_tls_record, cl_tls_content_handshake, offset - offset_tls_record);
-	set_tls_handshake(message_ptr + offset_tls_handshake, cl_tls_handshake_client_key_exchange, offset - offset_tls_handshake);
+	// The GCM ciphers keep their expanded keys for the whole connection
+	if (security_parameters.cipher_type == cl_tls_cipher_type_aead)
+	{
+		client_write_gcm.set_key(security_parameters.client_write_key.get_data(), security_parameters.client_write_key.get_size());
+		server_write_gcm.set_key(security_parameters.server_write_key.get_data(), security_parameters.server_write_key.get_size());
+	}
+}
 
-	memcpy(message_ptr + offset_tls_encrypted_pre_master_secret, wrapped_pre_master_secret.get_data(), wrapped_pre_master_secret_length);
-	message_ptr[offset_tls_encrypted_pre_master_secret_length] = wrapped_pre_master_secret_length >> 8;
-	message_ptr[offset_tls_encrypted_pre_master_secret_length+1] = wrapped_pre_master_secret_length;
+// P_hash from RFC 5246 (5): HMAC(secret, A(1) + seed) + HMAC(secret, A(2) + seed) + ..., where A(0) = seed and A(i) = HMAC(secret, A(i-1))
+template<typename HashFunction>
+static void tls12_prf(void *output_ptr, unsigned int output_size, const Secret &secret, const char *label_ptr, const Secret &seed_part1, const Secret &seed_part2)
+{
+	int label_length = strlen(label_ptr);
 
-	hash_handshake( message_ptr + offset_tls_handshake, offset - offset_tls_handshake);
+	Secret output_a(HashFunction::hash_size);
+	Secret output_b(HashFunction::hash_size);
 
-	send_record(message_ptr, offset);
+	HashFunction hash;
+	hash.set_hmac(secret.get_data(), secret.get_size());
+	hash.add(label_ptr, label_length);
+	hash.add(seed_part1.get_data(), seed_part1.get_size());
+	hash.add(seed_part2.get_data(), seed_part2.get_size());
+	hash.calculate();
+	hash.get_hash(output_a.get_data());
 
-	conversation_state = cl_tls_state_send_change_cipher_spec;
-	return true;
+	unsigned char *out_ptr = (unsigned char *) output_ptr;
+	while (output_size > 0)
+	{
+		hash.set_hmac(secret.get_data(), secret.get_size());
+		hash.add(output_a.get_data(), output_a.get_size());
+		hash.add(label_ptr, label_length);
+		hash.add(seed_part1.get_data(), seed_part1.get_size());
+		hash.add(seed_part2.get_data(), seed_part2.get_size());
+		hash.calculate();
+		hash.get_hash(output_b.get_data());
+
+		unsigned int length = min(output_size, (unsigned int) HashFunction::hash_size);
+		memcpy(out_ptr, output_b.get_data(), length);
+		out_ptr += length;
+		output_size -= length;
+
+		hash.set_hmac(secret.get_data(), secret.get_size());
+		hash.add(output_a.get_data(), output_a.get_size());
+		hash.calculate();
+		hash.get_hash(output_a.get_data());
+	}
 }
 
 void TLSClient_Impl::PRF(void *output_ptr, unsigned int output_size, const Secret &secret, const char *label_ptr, const Secret &seed_part1, const Secret &seed_part2)
+{
+	if (protocol.minor >= 3)
+	{
+		// TLS 1.2 uses the hash function of the cipher suite
+		if (security_parameters.prf_algorithm == cl_tls_prf_algorithm_sha384)
+			tls12_prf<SHA384>(output_ptr, output_size, secret, label_ptr, seed_part1, seed_part2);
+		else
+			tls12_prf<SHA256>(output_ptr, output_size, secret, label_ptr, seed_part1, seed_part2);
+	}
+	else
+	{
+		PRF_tls10(output_ptr, output_size, secret, label_ptr, seed_part1, seed_part2);
+	}
+}
+
+void TLSClient_Impl::PRF_tls10(void *output_ptr, unsigned int output_size, const Secret &secret, const char *label_ptr, const Secret &seed_part1, const Secret &seed_part2)
 {
 	const ubyte8 *secret_part1 = secret.get_data();
 	int secret_length = secret.get_size();
@@ -1194,6 +1433,21 @@ bool TLSClient_Impl::send_change_cipher_spec()
 	return true;
 }
 
+void TLSClient_Impl::send_close_notify()
+{
+	int offset = 0;
+	int offset_tls_record = offset;					offset += sizeof(TLS_Record);
+	int offset_tls_alert = offset;					offset += 2;
+
+	Secret message(offset);	// keep data secure
+	unsigned char *message_ptr = message.get_data();
+
+	set_tls_record(message_ptr + offset_tls_record, cl_tls_content_alert, offset - offset_tls_record);
+	message_ptr[offset_tls_alert] = cl_tls_warning;
+	message_ptr[offset_tls_alert + 1] = cl_tls_close_notify;
+	send_record(message_ptr, offset);
+}
+
 bool TLSClient_Impl::send_finished()
 {
 	if (!can_send_record())
@@ -1211,21 +1465,13 @@ bool TLSClient_Impl::send_finished()
 	set_tls_record(message_ptr + offset_tls_record, cl_tls_content_handshake, offset - offset_tls_record);
 	set_tls_handshake(message_ptr + offset_tls_handshake, cl_tls_handshake_finished, offset - offset_tls_handshake);
 
-	Secret md5_handshake_messages(MD5::hash_size);
-	Secret sha1_handshake_messages(SHA1::hash_size);
-
-	client_handshake_md5_hash.calculate();
-	client_handshake_sha1_hash.calculate();
-
-	client_handshake_md5_hash.get_hash(md5_handshake_messages.get_data());
-	client_handshake_sha1_hash.get_hash(sha1_handshake_messages.get_data());
-
-	PRF(message_ptr + offset_tls_finished, verify_data_size, security_parameters.master_secret, "client finished", md5_handshake_messages, sha1_handshake_messages);
+	calculate_verify_data(message_ptr + offset_tls_finished, verify_data_size, "client finished");
 
 	hash_handshake( message_ptr + offset_tls_handshake, offset - offset_tls_handshake);
 	send_record(message_ptr, offset);
 
-	conversation_state = cl_tls_state_receive_change_cipher_spec;
+	// In an abbreviated handshake the server has already sent its finished message
+	conversation_state = is_resumed ? cl_tls_state_connected : cl_tls_state_receive_change_cipher_spec;
 	return true;
 }
 
@@ -1234,6 +1480,11 @@ DataBuffer TLSClient_Impl::encrypt_data(const void *data_ptr, unsigned int data_
 	int additional_unpadded_blocks;
 	m_Random.get_random_bool() ? additional_unpadded_blocks = 1 : additional_unpadded_blocks = 0;
 
+	// TLS 1.1 and later send a random initialisation vector with each record, instead of continuing the chain (RFC 4346 6.2.3.2)
+	bool explicit_iv = protocol.minor >= 2;
+	if (explicit_iv)
+		m_Random.get_random_bytes(security_parameters.client_write_iv.get_data(), security_parameters.client_write_iv.get_size());
+
 	DataBuffer buffer;
 	if (security_parameters.bulk_cipher_algorithm == cl_tls_cipher_algorithm_aes128)
 	{
@@ -1261,6 +1512,16 @@ DataBuffer TLSClient_Impl::encrypt_data(const void *data_ptr, unsigned int data_
 	{
 		throw Exception("Unsupported cipher");
 	}
+
+	if (explicit_iv)
+	{
+		int iv_size = security_parameters.client_write_iv.get_size();
+		DataBuffer record_data(iv_size + buffer.get_size());
+		memcpy(record_data.get_data(), security_parameters.client_write_iv.get_data(), iv_size);
+		memcpy(record_data.get_data() + iv_size, buffer.get_data(), buffer.get_size());
+		return record_data;
+	}
+
 	memcpy(security_parameters.client_write_iv.get_data(), buffer.get_data() + buffer.get_size() - security_parameters.client_write_iv.get_size(), security_parameters.client_write_iv.get_size());
 	return buffer;
 
@@ -1269,15 +1530,7 @@ DataBuffer TLSClient_Impl::encrypt_data(const void *data_ptr, unsigned int data_
 Secret TLSClient_Impl::calculate_mac(const void *data_ptr, unsigned int data_size, const void *data2_ptr, unsigned int data2_size, ubyte64 sequence_number, const Secret &mac_secret)
 {
 	unsigned char sequence_number_buffer[8];
-
-	sequence_number_buffer[0] = sequence_number >> 56; 
-	sequence_number_buffer[1] = sequence_number >> 48; 
-	sequence_number_buffer[2] = sequence_number >> 40; 
-	sequence_number_buffer[3] = sequence_number >> 32; 
-	sequence_number_buffer[4] = sequence_number >> 24; 
-	sequence_number_buffer[5] = sequence_number >> 16; 
-	sequence_number_buffer[6] = sequence_number >> 8; 
-	sequence_number_buffer[7] = sequence_number; 
+	set_sequence_number(sequence_number_buffer, sequence_number);
 
 	if (security_parameters.mac_algorithm == cl_tls_mac_algorithm_sha)
 	{
@@ -1315,14 +1568,67 @@ Secret TLSClient_Impl::calculate_mac(const void *data_ptr, unsigned int data_siz
 
 void TLSClient_Impl::hash_handshake(const void *data_ptr, unsigned int data_size)
 {
-	client_handshake_md5_hash.add(data_ptr, data_size);
-	client_handshake_sha1_hash.add(data_ptr, data_size);
-	server_handshake_md5_hash.add(data_ptr, data_size);
-	server_handshake_sha1_hash.add(data_ptr, data_size);
+	int pos = handshake_messages.get_size();
+	handshake_messages.set_size(pos + data_size);
+	memcpy(handshake_messages.get_data() + pos, data_ptr, data_size);
+}
+
+void TLSClient_Impl::calculate_verify_data(void *output_ptr, unsigned int output_size, const char *label_ptr)
+{
+	if (protocol.minor >= 3)
+	{
+		// RFC 5246 (7.4.9): TLS 1.2 hashes the handshake messages with the hash function of the PRF
+		Secret handshake_hash;
+		if (security_parameters.prf_algorithm == cl_tls_prf_algorithm_sha384)
+		{
+			handshake_hash = Secret(SHA384::hash_size);
+			SHA384 sha384;
+			sha384.add(handshake_messages);
+			sha384.calculate();
+			sha384.get_hash(handshake_hash.get_data());
+		}
+		else
+		{
+			handshake_hash = Secret(SHA256::hash_size);
+			SHA256 sha256;
+			sha256.add(handshake_messages);
+			sha256.calculate();
+			sha256.get_hash(handshake_hash.get_data());
+		}
+		PRF(output_ptr, output_size, security_parameters.master_secret, label_ptr, handshake_hash, Secret());
+	}
+	else
+	{
+		Secret md5_handshake_messages(MD5::hash_size);
+		Secret sha1_handshake_messages(SHA1::hash_size);
+
+		MD5 md5;
+		md5.add(handshake_messages);
+		md5.calculate();
+		md5.get_hash(md5_handshake_messages.get_data());
+
+		SHA1 sha1;
+		sha1.add(handshake_messages);
+		sha1.calculate();
+		sha1.get_hash(sha1_handshake_messages.get_data());
+
+		PRF(output_ptr, output_size, security_parameters.master_secret, label_ptr, md5_handshake_messages, sha1_handshake_messages);
+	}
 }
 
 DataBuffer TLSClient_Impl::decrypt_data(const void *data_ptr, unsigned int data_size)
 {
+	// TLS 1.1 and later send the initialisation vector first in each record
+	if (protocol.minor >= 2)
+	{
+		unsigned int iv_size = security_parameters.server_write_iv.get_size();
+		if (data_size < iv_size)
+			throw Exception("Invalid TLS record size");
+		memcpy(security_parameters.server_write_iv.get_data(), data_ptr, iv_size);
+		data_ptr = (const unsigned char *) data_ptr + iv_size;
+		data_size -= iv_size;
+	}
+
 	DataBuffer buffer;
 	if (security_parameters.bulk_cipher_algorithm == cl_tls_cipher_algorithm_aes128)
 	{
@@ -1357,6 +1663,9 @@ DataBuffer TLSClient_Impl::decrypt_data(const void *data_ptr, unsigned int data_
 
 DataBuffer TLSClient_Impl::decrypt_record(TLS_Record &record, const DataBuffer &record_data)
 {
+	if (security_parameters.cipher_type == cl_tls_cipher_type_aead)
+		return decrypt_aead_record(record, record_data);
+
 	DataBuffer decrypted = decrypt_data(record_data.get_data(), record_data.get_size());
 
 	unsigned char *decrypted_data = (unsigned char *) decrypted.get_data();
@@ -1378,4 +1687,143 @@ DataBuffer TLSClient_Impl::decrypt_record(TLS_Record &record, const DataBuffer &
 	return decrypted;
 }
 
+DataBuffer TLSClient_Impl::encrypt_aead_record(const TLS_Record &record, const void *data_ptr, unsigned int data_size)
+{
+	// RFC 5288 (3): The record starts with the explicit part of the nonce. We use the sequence number, as a nonce must never repeat for a key
+	const int explicit_nonce_size = 8;
+
+	DataBuffer buffer(explicit_nonce_size + data_size + AES_GCM::tag_size);
+	unsigned char *buffer_ptr = buffer.get_data<unsigned char>();
+	set_sequence_number(buffer_ptr, security_parameters.write_sequence_number);
+
+	unsigned char nonce[AES_GCM::iv_size];
+	set_aead_nonce(nonce, security_parameters.client_write_iv, buffer_ptr);
+
+	unsigned char additional_data[13];
+	set_aead_additional_data(additional_data, security_parameters.write_sequence_number, record, data_size);
+
+	client_write_gcm.encrypt(nonce, additional_data, sizeof(additional_data), data_ptr, buffer_ptr + explicit_nonce_size, data_size, buffer_ptr + explicit_nonce_size + data_size);
+	return buffer;
+}
+
+DataBuffer TLSClient_Impl::decrypt_aead_record(TLS_Record &record, const DataBuffer &record_data)
+{
+	const int explicit_nonce_size = 8;
+
+	int decoded_size = record_data.get_size() - explicit_nonce_size - AES_GCM::tag_size;
+	if (decoded_size < 0)
+		throw Exception("Invalid decoded_size");
+
+	// Update the length
+	record.length[0] = decoded_size >> 8;
+	record.length[1] = decoded_size;
+
+	const unsigned char *record_data_ptr = record_data.get_data<unsigned char>();
+
+	unsigned char nonce[AES_GCM::iv_size];
+	set_aead_nonce(nonce, security_parameters.server_write_iv, record_data_ptr);
+
+	unsigned char additional_data[13];
+	set_aead_additional_data(additional_data, security_parameters.read_sequence_number, record, decoded_size);
+
+	DataBuffer decrypted(decoded_size);
+	if (!server_write_gcm.decrypt(nonce, additional_data, sizeof(additional_data), record_data_ptr + explicit_nonce_size, decrypted.get_data(), decoded_size, record_data_ptr + explicit_nonce_size + decoded_size))
+		throw Exception("TLS record authentication failed");
+
+	return decrypted;
+}
+
+void TLSClient_Impl::send_aead_application_record(const void *data_ptr, unsigned int data_size)
+{
+	const int explicit_nonce_size = 8;
+	unsigned int record_length = explicit_nonce_size + data_size + AES_GCM::tag_size;
+
+	int pos = send_out_data.get_size();
+	send_out_data.set_size(pos + sizeof(TLS_Record) + record_length);
+	unsigned char *record_ptr = send_out_data.get_data<unsigned char>() + pos;
+	unsigned char *fragment_ptr = record_ptr + sizeof(TLS_Record);
+
+	// The additional data holds the plaintext length. The record header gets the ciphertext length
+	TLS_Record record;
+	set_tls_record((unsigned char *) &record, cl_tls_content_application_data, sizeof(TLS_Record) + data_size);
+	unsigned char additional_data[13];
+	set_aead_additional_data(additional_data, security_parameters.write_sequence_number, record, data_size);
+	record.length[0] = record_length >> 8;
+	record.length[1] = record_length;
+	memcpy(record_ptr, &record, sizeof(TLS_Record));
+
+	set_sequence_number(fragment_ptr, security_parameters.write_sequence_number);
+	unsigned char nonce[AES_GCM::iv_size];
+	set_aead_nonce(nonce, security_parameters.client_write_iv, fragment_ptr);
+
+	client_write_gcm.encrypt(nonce, additional_data, sizeof(additional_data), data_ptr, fragment_ptr + explicit_nonce_size, data_size, fragment_ptr + explicit_nonce_size + data_size);
+
+	security_parameters.write_sequence_number++;
+	if (security_parameters.write_sequence_number == 0)
+		throw Exception("Sequence number wraparound");
+}
+
+void TLSClient_Impl::receive_aead_application_record(TLS_Record &record, const unsigned char *record_data_ptr, int record_length)
+{
+	if (conversation_state != cl_tls_state_connected)
+		throw Exception("Unexpected application data record received");
+
+	const int explicit_nonce_size = 8;
+	int decoded_size = record_length - explicit_nonce_size - AES_GCM::tag_size;
+	if (decoded_size < 0)
+		throw Exception("Invalid decoded_size");
+
+	record.length[0] = decoded_size >> 8;
+	record.length[1] = decoded_size;
+
+	unsigned char nonce[AES_GCM::iv_size];
+	set_aead_nonce(nonce, security_parameters.server_write_iv, record_data_ptr);
+
+	unsigned char additional_data[13];
+	set_aead_additional_data(additional_data, security_parameters.read_sequence_number, record, decoded_size);
+
+	// Decrypt straight into the application data buffer. On failure the data is discarded again
+	int pos = recv_out_data.get_size();
+	recv_out_data.set_size(pos + decoded_size);
+	if (!server_write_gcm.decrypt(nonce, additional_data, sizeof(additional_data), record_data_ptr + explicit_nonce_size, recv_out_data.get_data() + pos, decoded_size, record_data_ptr + explicit_nonce_size + decoded_size))
+	{
+		memset(recv_out_data.get_data() + pos, 0, decoded_size);
+		recv_out_data.set_size(pos);
+		throw Exception("TLS record authentication failed");
+	}
+
+	security_parameters.read_sequence_number++;
+	if (security_parameters.read_sequence_number == 0)
+		throw Exception("Sequence number wraparound");
+}
+
+void TLSClient_Impl::set_aead_nonce(unsigned char *nonce_ptr, const Secret &fixed_iv, const unsigned char *explicit_nonce_ptr) const
+{
+	memcpy(nonce_ptr, fixed_iv.get_data(), 4);
+	memcpy(nonce_ptr + 4, explicit_nonce_ptr, 8);
+}
+
+void TLSClient_Impl::set_aead_additional_data(unsigned char *dest_ptr, ubyte64 sequence_number, const TLS_Record &record, unsigned int length) const
+{
+	// RFC 5246 (6.2.3.3): seq_num + TLSCompressed.type + TLSCompressed.version + TLSCompressed.length
+	set_sequence_number(dest_ptr, sequence_number);
+	dest_ptr[8] = record.type;
+	dest_ptr[9] = record.version.major;
+	dest_ptr[10] = record.version.minor;
+	dest_ptr[11] = length >> 8;
+	dest_ptr[12] = length;
+}
+
+void TLSClient_Impl::set_sequence_number(unsigned char *dest_ptr, ubyte64 sequence_number)
+{
+	dest_ptr[0] = sequence_number >> 56;
+	dest_ptr[1] = sequence_number >> 48;
+	dest_ptr[2] = sequence_number >> 40;
+	dest_ptr[3] = sequence_number >> 32;
+	dest_ptr[4] = sequence_number >> 24;
+	dest_ptr[5] = sequence_number >> 16;
+	dest_ptr[6] = sequence_number >> 8;
+	dest_ptr[7] = sequence_number;
+}
+
 }
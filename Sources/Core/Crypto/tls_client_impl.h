@@ -35,7 +35,9 @@
 #include "API/Core/Crypto/random.h"
 #include "API/Core/Crypto/rsa.h"
 #include "API/Core/Crypto/hash_functions.h"
+#include "API/Core/Crypto/aes_gcm.h"
 #include "x509.h"
+#include "tls_session_cache.h"
 
 namespace clan
 {
@@ -61,7 +63,8 @@ enum TLS_BulkCipherAlgorithm
 enum TLS_CipherType
 {
 	cl_tls_cipher_type_stream,
-	cl_tls_cipher_type_block
+	cl_tls_cipher_type_block,
+	cl_tls_cipher_type_aead
 };
 
 enum TLS_MACAlgorithm
@@ -72,6 +75,12 @@ enum TLS_MACAlgorithm
 	cl_tls_mac_algorithm_sha256
 };
 
+enum TLS_PRFAlgorithm	// Only used by TLS 1.2. Earlier versions always combine MD5 and SHA-1
+{
+	cl_tls_prf_algorithm_sha256,
+	cl_tls_prf_algorithm_sha384
+};
+
 enum TLS_CompressionMethod
 {
 	cl_tls_compression_null = 0
@@ -171,7 +180,10 @@ public:
 		iv_size = 0;
 		is_exportable = false;
 		mac_algorithm = cl_tls_mac_algorithm_null;
+		prf_algorithm = cl_tls_prf_algorithm_sha256;
 		hash_size = 0;
+		cipher_suite[0] = 0;
+		cipher_suite[1] = 0;
 		compression_algorithm = cl_tls_compression_null;
 		master_secret = Secret(48);
 		client_random = Secret(32);
@@ -197,7 +209,9 @@ public:
 	ubyte8 iv_size;
 	bool is_exportable;
 	TLS_MACAlgorithm mac_algorithm;
+	TLS_PRFAlgorithm prf_algorithm;
 	ubyte8 hash_size;
+	ubyte8 cipher_suite[2];
 	TLS_CompressionMethod compression_algorithm;
 	Secret master_secret;
 	Secret client_random;
@@ -250,6 +264,9 @@ public:
 	void decrypted_data_consumed(int size);
 	void encrypted_data_consumed(int size);
 
+	void enable_session_resumption(const std::string &server_name);
+	bool is_session_resumed() const;
+
 private:
 	void progress_conversation();
 
@@ -278,6 +295,7 @@ private:
 	bool send_client_key_exchange();
 	bool send_change_cipher_spec();
 	bool send_finished();
+	void send_close_notify();
 	bool send_application_data();
 
 	void reset();
@@ -296,11 +314,16 @@ private:
 	int get_cipher_suites_length() const;
 	void set_cipher_suites(unsigned char *dest_ptr) const;
 	void select_cipher_suite(ubyte8 value1, ubyte8 value2);
+	void resume_session();
+	void store_session();
 	void select_compression_method(ubyte8 value);
 	void inspect_certificate(std::vector<unsigned char> &cert);
 	void set_server_public_key();
+	void create_keys();
 	void PRF(void *output_ptr, unsigned int output_size, const Secret &secret, const char *label_ptr, const Secret &seed_part1, const Secret &seed_part2);
+	void PRF_tls10(void *output_ptr, unsigned int output_size, const Secret &secret, const char *label_ptr, const Secret &seed_part1, const Secret &seed_part2);
 	void hash_handshake(const void *data_ptr, unsigned int data_size);
+	void calculate_verify_data(void *output_ptr, unsigned int output_size, const char *label_ptr);
 
 	DataBuffer decrypt_record(TLS_Record &record, const DataBuffer &record_data);
 	DataBuffer decrypt_data(const void *data_ptr, unsigned int data_size);
@@ -308,7 +331,16 @@ private:
 	Secret calculate_mac(const void *data_ptr, unsigned int data_size, const void *data2_ptr, unsigned int data2_size, ubyte64 sequence_number, const Secret &mac_secret);
 	DataBuffer encrypt_data(const void *data_ptr, unsigned int data_size, const void *mac_ptr, unsigned int mac_size);
 
-	static const unsigned int max_record_length = 2<<14;	// RFC 2246 (6.2.1)
+	DataBuffer encrypt_aead_record(const TLS_Record &record, const void *data_ptr, unsigned int data_size);
+	DataBuffer decrypt_aead_record(TLS_Record &record, const DataBuffer &record_data);
+	void send_aead_application_record(const void *data_ptr, unsigned int data_size);
+	void receive_aead_application_record(TLS_Record &record, const unsigned char *record_data_ptr, int record_length);
+	void set_aead_nonce(unsigned char *nonce_ptr, const Secret &fixed_iv, const unsigned char *explicit_nonce_ptr) const;
+	void set_aead_additional_data(unsigned char *dest_ptr, ubyte64 sequence_number, const TLS_Record &record, unsigned int length) const;
+	static void set_sequence_number(unsigned char *dest_ptr, ubyte64 sequence_number);
+
+	static const unsigned int max_record_length = 1<<14;	// RFC 2246 (6.2.1)
+	static const unsigned int max_ciphertext_record_length = max_record_length + 2048;	// RFC 2246 (6.2.3)
 	static const unsigned int max_handshake_length = 2<<24;	// RFC 2246 (implied by length in7.4)
 
 	static const int desired_buffer_size = 64*1024;
@@ -334,6 +366,7 @@ private:
 
 	TLS_SecurityParameters security_parameters;
 	TLS_ProtocolVersion protocol;
+	TLS_ProtocolVersion client_version;	// The highest version we support, as offered in the client hello
 
 	DataBuffer server_public_exponent;
 	DataBuffer server_public_modulus;
@@ -342,12 +375,17 @@ private:
 
 	Random m_Random;
 
-	MD5 client_handshake_md5_hash;
-	SHA1 client_handshake_sha1_hash;
-	MD5 server_handshake_md5_hash;
-	SHA1 server_handshake_sha1_hash;
+	DataBuffer handshake_messages;	// All handshake messages so far, for the finished message verify data
 
 	std::vector<X509> certificate_chain;
+
+	std::string session_name;	// Sessions are only cached when the server name is known
+	TLSSession offered_session;
+	Secret session_id;
+	bool is_resumed;
+
+	AES_GCM client_write_gcm;
+	AES_GCM server_write_gcm;
 };
 
 }
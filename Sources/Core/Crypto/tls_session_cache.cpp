@@ -0,0 +1,97 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2015 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    agent
+*/
+
+#include "Core/precomp.h"
+#include "tls_session_cache.h"
+#include "API/Core/System/mutex.h"
+#include "API/Core/System/system.h"
+#include <map>
+
+namespace clan
+{
+
+class TLSSessionCache_Impl
+{
+public:
+	Mutex mutex;
+	std::map<std::string, TLSSession> sessions;
+
+	static TLSSessionCache_Impl &instance()
+	{
+		static TLSSessionCache_Impl cache;
+		return cache;
+	}
+};
+
+bool TLSSessionCache::find(const std::string &server_name, TLSSession &out_session)
+{
+	TLSSessionCache_Impl &cache = TLSSessionCache_Impl::instance();
+	MutexSection mutex_lock(&cache.mutex);
+
+	auto it = cache.sessions.find(server_name);
+	if (it == cache.sessions.end())
+		return false;
+
+	if (System::get_time() - it->second.creation_time > max_session_age)
+	{
+		cache.sessions.erase(it);
+		return false;
+	}
+
+	out_session = it->second;
+	return true;
+}
+
+void TLSSessionCache::store(const std::string &server_name, const TLSSession &session)
+{
+	TLSSessionCache_Impl &cache = TLSSessionCache_Impl::instance();
+	MutexSection mutex_lock(&cache.mutex);
+
+	if ((int)cache.sessions.size() >= max_sessions && cache.sessions.find(server_name) == cache.sessions.end())
+	{
+		// Make room by dropping the oldest session
+		auto oldest = cache.sessions.begin();
+		for (auto it = cache.sessions.begin(); it != cache.sessions.end(); ++it)
+		{
+			if (it->second.creation_time < oldest->second.creation_time)
+				oldest = it;
+		}
+		cache.sessions.erase(oldest);
+	}
+
+	cache.sessions[server_name] = session;
+}
+
+void TLSSessionCache::remove(const std::string &server_name)
+{
+	TLSSessionCache_Impl &cache = TLSSessionCache_Impl::instance();
+	MutexSection mutex_lock(&cache.mutex);
+	cache.sessions.erase(server_name);
+}
+
+}
@@ -0,0 +1,73 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2015 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    agent
+*/
+
+#pragma once
+
+#include "API/Core/System/cl_platform.h"
+#include "API/Core/Crypto/secret.h"
+#include <string>
+
+namespace clan
+{
+
+/// \brief A TLS session the client can offer to resume
+class TLSSession
+{
+public:
+	TLSSession() : protocol_major(0), protocol_minor(0), creation_time(0)
+	{
+		cipher_suite[0] = 0;
+		cipher_suite[1] = 0;
+	}
+
+	Secret session_id;
+	Secret master_secret;
+	ubyte8 protocol_major;
+	ubyte8 protocol_minor;
+	ubyte8 cipher_suite[2];
+	ubyte64 creation_time;
+};
+
+/// \brief Process wide cache of the sessions established by TLSClient, indexed by server name
+class TLSSessionCache
+{
+public:
+	/// \brief Finds the session for a server. Returns false if there is none, or if it has expired
+	static bool find(const std::string &server_name, TLSSession &out_session);
+
+	/// \brief Stores the session for a server, replacing any previous session
+	static void store(const std::string &server_name, const TLSSession &session);
+
+	/// \brief Removes the session for a server
+	static void remove(const std::string &server_name);
+
+	static const int max_sessions = 256;
+	static const ubyte64 max_session_age = 24 * 60 * 60 * 1000;	// RFC 5246 (F.1.4) recommends an upper limit of 24 hours
+};
+
+}
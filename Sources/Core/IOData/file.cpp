@@ -33,6 +33,7 @@
 #include "API/Core/Text/string_help.h"
 #include "iodevice_impl.h"
 #include "iodevice_provider_file.h"
+#include "iodevice_provider_file_mapping.h"
 
 namespace clan
 {
@@ -84,6 +85,12 @@ void File::write_bytes(const std::string &filename, const DataBuffer &bytes)
 	file.close();
 }
 
+const char *File::get_mapped_data(const IODevice &device)
+{
+	const IODeviceProvider_FileMapping *provider = dynamic_cast<const IODeviceProvider_FileMapping*>(device.get_provider());
+	return provider ? provider->get_data() : nullptr;
+}
+
 /////////////////////////////////////////////////////////////////////////////
 // File Construction:
 
@@ -104,7 +111,7 @@ File::File(
 	unsigned int access,
 	unsigned int share,
 	unsigned int flags)
-: IODevice(new IODeviceProvider_File(PathHelp::normalize(filename, PathHelp::path_type_file), open_mode, access, share, flags))
+: IODevice(create_provider(PathHelp::normalize(filename, PathHelp::path_type_file), open_mode, access, share, flags))
 {
 }
 File::~File()
@@ -121,8 +128,7 @@ File::~File()
 bool File::open(
 	const std::string &filename)
 {
-	IODeviceProvider_File *provider = dynamic_cast<IODeviceProvider_File*>(impl->provider);
-	return provider->open(PathHelp::normalize(filename, PathHelp::path_type_file), open_existing, access_read, share_all, 0);
+	return open(filename, open_existing, access_read, share_all, 0);
 }
 
 bool File::open(
@@ -132,12 +138,37 @@ bool File::open(
 	unsigned int share,
 	unsigned int flags)
 {
+	// Switch provider when going between memory mapped and regular files
+	bool memory_mapped = (flags & flag_memory_mapped) != 0;
+	IODeviceProvider_FileMapping *mapping_provider = dynamic_cast<IODeviceProvider_FileMapping*>(impl->provider);
+	if (memory_mapped != (mapping_provider != nullptr))
+	{
+		close();
+		delete impl->provider;
+		impl->provider = nullptr;
+		mapping_provider = memory_mapped ? new IODeviceProvider_FileMapping() : nullptr;
+		if (mapping_provider)
+			impl->provider = mapping_provider;
+		else
+			impl->provider = new IODeviceProvider_File();
+	}
+
+	if (mapping_provider)
+		return mapping_provider->open(PathHelp::normalize(filename, PathHelp::path_type_file), open_mode, access, share, flags);
+
 	IODeviceProvider_File *provider = dynamic_cast<IODeviceProvider_File*>(impl->provider);
 	return provider->open(PathHelp::normalize(filename, PathHelp::path_type_file), open_mode, access, share, flags);
 }
 
 void File::close()
 {
+	IODeviceProvider_FileMapping *mapping_provider = dynamic_cast<IODeviceProvider_FileMapping*>(impl->provider);
+	if (mapping_provider)
+	{
+		mapping_provider->close();
+		return;
+	}
+
 	IODeviceProvider_File *provider = dynamic_cast<IODeviceProvider_File*>(impl->provider);
 	provider->close();
 }
@@ -145,4 +176,17 @@ void File::close()
 /////////////////////////////////////////////////////////////////////////////
 // File Implementation:
 
+IODeviceProvider *File::create_provider(
+	const std::string &filename,
+	OpenMode open_mode,
+	unsigned int access,
+	unsigned int share,
+	unsigned int flags)
+{
+	if (flags & flag_memory_mapped)
+		return new IODeviceProvider_FileMapping(filename, open_mode, access, share, flags);
+	else
+		return new IODeviceProvider_File(filename, open_mode, access, share, flags);
+}
+
 }
@@ -63,6 +63,12 @@ public:
 
 	int get_position() const override;
 
+#ifdef WIN32
+	HANDLE get_handle() const { return handle; }
+#else
+	int get_handle() const { return handle; }
+#endif
+
 /// \}
 /// \name Operations
 /// \{
@@ -0,0 +1,338 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2015 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    agent
+*/
+
+#include "Core/precomp.h"
+#include "API/Core/IOData/file.h"
+#include "API/Core/System/exception.h"
+#include "API/Core/Text/string_help.h"
+#include "API/Core/Text/string_format.h"
+#include "iodevice_provider_file_mapping.h"
+#include <cstdint>
+#ifndef WIN32
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace clan
+{
+
+/////////////////////////////////////////////////////////////////////////////
+// FileMapping:
+
+static const char cl_empty_file_data = 0;
+
+FileMapping::FileMapping(const std::string &filename, unsigned int share, unsigned int flags)
+: data(&cl_empty_file_data), size(0), mapped(false)
+{
+#ifdef WIN32
+	DWORD win32_share_mode = 0;
+	if (share & File::share_read)
+		win32_share_mode |= FILE_SHARE_READ;
+	if (share & File::share_write)
+		win32_share_mode |= FILE_SHARE_WRITE;
+	if (share & File::share_delete)
+		win32_share_mode |= FILE_SHARE_DELETE;
+
+	// The cache manager also uses these hints when servicing page faults in the view
+	DWORD win32_flags = 0;
+	if (flags & File::flag_random_access)
+		win32_flags |= FILE_FLAG_RANDOM_ACCESS;
+	if (flags & File::flag_sequential_scan)
+		win32_flags |= FILE_FLAG_SEQUENTIAL_SCAN;
+
+	mapping_handle = 0;
+	file_handle = CreateFile(StringHelp::utf8_to_ucs2(filename).c_str(), GENERIC_READ, win32_share_mode, 0, OPEN_EXISTING, win32_flags, 0);
+	if (file_handle == INVALID_HANDLE_VALUE)
+		throw Exception(string_format("Unable to open file '%1'", filename));
+
+	LARGE_INTEGER file_size;
+	if (GetFileSizeEx(file_handle, &file_size) == FALSE || (ubyte64) file_size.QuadPart > (ubyte64) SIZE_MAX)
+	{
+		CloseHandle(file_handle);
+		throw Exception(string_format("Unable to memory map file '%1', the size is not supported", filename));
+	}
+
+	size = (size_t) file_size.QuadPart;
+	if (size > 0)
+	{
+		mapping_handle = CreateFileMapping(file_handle, 0, PAGE_READONLY, 0, 0, 0);
+		void *view = mapping_handle ? MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0) : 0;
+		if (view == 0)
+		{
+			if (mapping_handle)
+				CloseHandle(mapping_handle);
+			CloseHandle(file_handle);
+			throw Exception(string_format("Unable to memory map file '%1'", filename));
+		}
+		data = (const char *) view;
+		mapped = true;
+	}
+#else
+	std::string filename_a = StringHelp::text_to_local8(filename);
+	int handle = ::open(filename_a.c_str(), O_RDONLY);
+	if (handle == -1)
+		throw Exception(string_format("Unable to open file '%1'", filename));
+
+	struct stat file_stat;
+	if (fstat(handle, &file_stat) == -1 || (ubyte64) file_stat.st_size > (ubyte64) SIZE_MAX)
+	{
+		::close(handle);
+		throw Exception(string_format("Unable to memory map file '%1', the size is not supported", filename));
+	}
+
+	size = (size_t) file_stat.st_size;
+	if (size > 0)
+	{
+		int map_flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+		// Fault in all pages at once rather than one page at a time on first access
+		if (flags & File::flag_will_need)
+			map_flags |= MAP_POPULATE;
+#endif
+		void *view = mmap(0, size, PROT_READ, map_flags, handle, 0);
+		if (view == MAP_FAILED)
+		{
+			::close(handle);
+			throw Exception(string_format("Unable to memory map file '%1'", filename));
+		}
+		data = (const char *) view;
+		mapped = true;
+	}
+
+	// The mapping keeps its own reference to the file
+	::close(handle);
+
+	advise(0, size, flags);
+#endif
+}
+
+FileMapping::~FileMapping()
+{
+#ifdef WIN32
+	if (mapped)
+		UnmapViewOfFile(data);
+	if (mapping_handle)
+		CloseHandle(mapping_handle);
+	CloseHandle(file_handle);
+#else
+	if (mapped)
+		munmap((void *) data, size);
+#endif
+}
+
+void FileMapping::advise(size_t offset, size_t length, unsigned int flags)
+{
+#ifdef WIN32
+	// FILE_FLAG_SEQUENTIAL_SCAN and FILE_FLAG_RANDOM_ACCESS are given when the file is opened.
+	// PrefetchVirtualMemory would do flag_will_need, but it requires Windows 8.
+#else
+	if (!mapped || length == 0)
+		return;
+
+	// madvise needs a page aligned start address
+	static const size_t page_size = sysconf(_SC_PAGESIZE);
+	size_t aligned_offset = offset - offset % page_size;
+	void *start = (void *) (data + aligned_offset);
+	size_t range = length + (offset - aligned_offset);
+
+	if (flags & File::flag_sequential_scan)
+		madvise(start, range, MADV_SEQUENTIAL);
+	else if (flags & File::flag_random_access)
+		madvise(start, range, MADV_RANDOM);
+
+	if (flags & File::flag_will_need)
+		madvise(start, range, MADV_WILLNEED);
+#endif
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// IODeviceProvider_FileMapping Construction:
+
+IODeviceProvider_FileMapping::IODeviceProvider_FileMapping()
+: offset(0), length(0), position(0)
+{
+}
+
+IODeviceProvider_FileMapping::IODeviceProvider_FileMapping(
+	const std::string &filename,
+	File::OpenMode open_mode,
+	unsigned int access,
+	unsigned int share,
+	unsigned int flags)
+: offset(0), length(0), position(0)
+{
+	bool result = open(filename, open_mode, access, share, flags);
+	if (result == false)
+		throw Exception(string_format("IODeviceProvider_FileMapping::IODeviceProvider_FileMapping(): Unable to open file '%1'", filename));
+}
+
+IODeviceProvider_FileMapping::IODeviceProvider_FileMapping(const std::shared_ptr<FileMapping> &mapping, size_t offset, int length)
+: mapping(mapping), offset(offset), length(length), position(0)
+{
+	if (length < 0 || offset > mapping->get_size() || (size_t) length > mapping->get_size() - offset)
+		throw Exception("IODeviceProvider_FileMapping: Range is outside the mapped file");
+}
+
+IODeviceProvider_FileMapping::~IODeviceProvider_FileMapping()
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// IODeviceProvider_FileMapping Attributes:
+
+int IODeviceProvider_FileMapping::get_size() const
+{
+	if (!mapping)
+		throw Exception("IODeviceProvider_FileMapping::get_size(): Unable to get file size, no file open");
+	return length;
+}
+
+int IODeviceProvider_FileMapping::get_position() const
+{
+	if (!mapping)
+		throw Exception("IODeviceProvider_FileMapping::get_position(): Unable to get file position pointer, no file open");
+	return position;
+}
+
+const char *IODeviceProvider_FileMapping::get_data() const
+{
+	return mapping ? mapping->get_data() + offset : nullptr;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// IODeviceProvider_FileMapping Operations:
+
+bool IODeviceProvider_FileMapping::open(
+	const std::string &filename,
+	File::OpenMode open_mode,
+	unsigned int access,
+	unsigned int share,
+	unsigned int flags)
+{
+	close();
+
+	if (access != File::access_read || open_mode != File::open_existing)
+		throw Exception("Memory mapped files can only be opened for reading with File::open_existing");
+
+	try
+	{
+		mapping = std::make_shared<FileMapping>(filename, share, flags);
+	}
+	catch (const Exception &)
+	{
+		return false;
+	}
+
+	// IODevice positions are int, so larger files can only be mapped in ranges
+	if (mapping->get_size() > 0x7fffffff)
+	{
+		mapping.reset();
+		throw Exception(string_format("Unable to memory map file '%1', the size is not supported", filename));
+	}
+
+	length = (int) mapping->get_size();
+	return true;
+}
+
+void IODeviceProvider_FileMapping::close()
+{
+	mapping.reset();
+	offset = 0;
+	length = 0;
+	position = 0;
+}
+
+int IODeviceProvider_FileMapping::send(const void *data, int len, bool send_all)
+{
+	throw Exception("IODeviceProvider_FileMapping::send(): Memory mapped files are read only");
+}
+
+int IODeviceProvider_FileMapping::receive(void *data, int len, bool receive_all)
+{
+	len = peek(data, len);
+	position += len;
+	return len;
+}
+
+int IODeviceProvider_FileMapping::peek(void *data, int len)
+{
+	if (!mapping)
+		throw Exception("IODeviceProvider_FileMapping::peek(): Unable to read from file, no file open");
+
+	int data_available = length - position;
+	if (len > data_available)
+		len = data_available;
+	if (len > 0)
+		memcpy(data, mapping->get_data() + offset + position, len);
+	return len;
+}
+
+bool IODeviceProvider_FileMapping::seek(int requested_position, IODevice::SeekMode mode)
+{
+	if (!mapping)
+		throw Exception("IODeviceProvider_FileMapping::seek(): Unable to get file position pointer, no file open");
+
+	int new_position = position;
+	switch (mode)
+	{
+	case IODevice::seek_set:
+		new_position = requested_position;
+		break;
+	case IODevice::seek_cur:
+		new_position += requested_position;
+		break;
+	case IODevice::seek_end:
+		new_position = length + requested_position;
+		break;
+	default:
+		return false;
+	}
+
+	if (new_position >= 0 && new_position <= length)
+	{
+		position = new_position;
+		return true;
+	}
+	else
+	{
+		return false;
+	}
+}
+
+IODeviceProvider *IODeviceProvider_FileMapping::duplicate()
+{
+	// Duplicates share the mapping and only have their own position
+	if (!mapping)
+		return new IODeviceProvider_FileMapping();
+	return new IODeviceProvider_FileMapping(mapping, offset, length);
+}
+
+}
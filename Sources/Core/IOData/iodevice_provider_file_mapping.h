@@ -0,0 +1,141 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2015 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    agent
+*/
+
+#pragma once
+
+#include "API/Core/IOData/iodevice_provider.h"
+#include "API/Core/IOData/file.h"
+#include <memory>
+
+namespace clan
+{
+
+/// \brief Read only view of a whole file mapped into memory
+class FileMapping
+{
+public:
+	/// \brief Maps a file. Throws if the file cannot be opened or mapped.
+	///
+	/// File::flag_sequential_scan, flag_random_access and flag_will_need are passed on to the OS as access hints.
+	FileMapping(const std::string &filename, unsigned int share, unsigned int flags);
+	~FileMapping();
+
+	const char *get_data() const { return data; }
+	size_t get_size() const { return size; }
+
+	/// \brief Hints the OS about how a range of the mapping is going to be read
+	void advise(size_t offset, size_t length, unsigned int flags);
+
+private:
+	FileMapping(const FileMapping &) = delete;
+	FileMapping &operator=(const FileMapping &) = delete;
+
+	const char *data;
+	size_t size;
+	bool mapped;
+#ifdef WIN32
+	HANDLE file_handle;
+	HANDLE mapping_handle;
+#endif
+};
+
+/// \brief Read only I/O device provider reading a range of a memory mapped file
+class IODeviceProvider_FileMapping : public IODeviceProvider
+{
+/// \name Construction
+/// \{
+
+public:
+	IODeviceProvider_FileMapping();
+
+	IODeviceProvider_FileMapping(
+		const std::string &filename,
+		File::OpenMode mode,
+		unsigned int access,
+		unsigned int share,
+		unsigned int flags);
+
+	/// \brief Constructs a provider reading length bytes at offset of an existing mapping
+	IODeviceProvider_FileMapping(const std::shared_ptr<FileMapping> &mapping, size_t offset, int length);
+
+	~IODeviceProvider_FileMapping();
+
+/// \}
+/// \name Attributes
+/// \{
+
+public:
+	int get_size() const override;
+
+	int get_position() const override;
+
+	/// \brief Returns the start of the mapped range, or nullptr if nothing is mapped
+	const char *get_data() const;
+
+	const std::shared_ptr<FileMapping> &get_mapping() const { return mapping; }
+
+	/// \brief Returns the offset of the range within the mapping
+	size_t get_offset() const { return offset; }
+
+/// \}
+/// \name Operations
+/// \{
+
+public:
+	bool open(
+		const std::string &filename,
+		File::OpenMode mode,
+		unsigned int access,
+		unsigned int share,
+		unsigned int flags);
+
+	void close();
+
+	int send(const void *data, int len, bool send_all) override;
+
+	int receive(void *data, int len, bool receive_all) override;
+
+	int peek(void *data, int len) override;
+
+	bool seek(int position, IODevice::SeekMode mode) override;
+
+	IODeviceProvider *duplicate() override;
+
+/// \}
+/// \name Implementation
+/// \{
+
+private:
+	std::shared_ptr<FileMapping> mapping;
+	size_t offset;
+	int length;
+	int position;
+/// \}
+};
+
+}
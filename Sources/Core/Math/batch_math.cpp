@@ -0,0 +1,310 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2015 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    agent
+*/
+
+#include "Core/precomp.h"
+#include "API/Core/Math/batch_math.h"
+#include "batch_math_simd.h"
+#include <atomic>
+
+namespace clan
+{
+
+static_assert(sizeof(Vec2f) == 2 * sizeof(float) && sizeof(Vec3f) == 3 * sizeof(float) && sizeof(Vec4f) == 4 * sizeof(float), "The kernels expect tightly packed vectors");
+
+// -1 until the CPU has been checked
+static std::atomic<int> supported_instruction_set(-1);
+static std::atomic<int> max_instruction_set(BatchMath::avx512);
+
+static BatchMath::InstructionSet detect_instruction_set()
+{
+#if defined(CL_BATCH_MATH_AVX512)
+	if (BatchMath_AVX512::is_supported())
+		return BatchMath::avx512;
+#endif
+#if defined(CL_BATCH_MATH_AVX2)
+	if (BatchMath_AVX2::is_supported())
+		return BatchMath::avx2;
+#endif
+#if defined(CL_BATCH_MATH_SSE2)
+	return BatchMath::sse2;
+#else
+	return BatchMath::scalar;
+#endif
+}
+
+static inline Vec4f *output_at(Vec4f *output, int index, int output_stride)
+{
+	return (Vec4f *)((char *)output + (size_t)index * output_stride);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// BatchMath Attributes:
+
+BatchMath::InstructionSet BatchMath::get_instruction_set()
+{
+	int supported = supported_instruction_set.load(std::memory_order_relaxed);
+	if (supported < 0)
+	{
+		// Every thread detects the same instruction set, so it does not matter which store wins
+		supported = detect_instruction_set();
+		supported_instruction_set.store(supported, std::memory_order_relaxed);
+	}
+
+	int limit = max_instruction_set.load(std::memory_order_relaxed);
+	return (InstructionSet)(supported < limit ? supported : limit);
+}
+
+void BatchMath::set_max_instruction_set(InstructionSet instruction_set)
+{
+	max_instruction_set.store(instruction_set, std::memory_order_relaxed);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// BatchMath Operations:
+
+void BatchMath::transform(const Mat4f &matrix, const Vec2f *input, Vec4f *output, int count, int output_stride)
+{
+	int i = 0;
+	switch (get_instruction_set())
+	{
+#if defined(CL_BATCH_MATH_AVX512)
+	case avx512: i = BatchMath_AVX512::transform(matrix, input, output, count, output_stride); break;
+#endif
+#if defined(CL_BATCH_MATH_AVX2)
+	case avx2: i = BatchMath_AVX2::transform(matrix, input, output, count, output_stride); break;
+#endif
+#if defined(CL_BATCH_MATH_SSE2)
+	case sse2: i = BatchMath_SSE2::transform(matrix, input, output, count, output_stride); break;
+#endif
+	default: break;
+	}
+
+	const float *m = matrix.matrix;
+	for (; i < count; i++)
+	{
+		float x = input[i].x, y = input[i].y;
+		*output_at(output, i, output_stride) = Vec4f(
+			m[0] * x + m[4] * y + m[12],
+			m[1] * x + m[5] * y + m[13],
+			m[2] * x + m[6] * y + m[14],
+			m[3] * x + m[7] * y + m[15]);
+	}
+}
+
+void BatchMath::transform(const Mat4f &matrix, const Vec3f *input, Vec4f *output, int count, int output_stride)
+{
+	int i = 0;
+	switch (get_instruction_set())
+	{
+#if defined(CL_BATCH_MATH_AVX512)
+	case avx512: i = BatchMath_AVX512::transform(matrix, input, output, count, output_stride); break;
+#endif
+#if defined(CL_BATCH_MATH_AVX2)
+	case avx2: i = BatchMath_AVX2::transform(matrix, input, output, count, output_stride); break;
+#endif
+#if defined(CL_BATCH_MATH_SSE2)
+	case sse2: i = BatchMath_SSE2::transform(matrix, input, output, count, output_stride); break;
+#endif
+	default: break;
+	}
+
+	const float *m = matrix.matrix;
+	for (; i < count; i++)
+	{
+		float x = input[i].x, y = input[i].y, z = input[i].z;
+		*output_at(output, i, output_stride) = Vec4f(
+			m[0] * x + m[4] * y + m[8] * z + m[12],
+			m[1] * x + m[5] * y + m[9] * z + m[13],
+			m[2] * x + m[6] * y + m[10] * z + m[14],
+			m[3] * x + m[7] * y + m[11] * z + m[15]);
+	}
+}
+
+void BatchMath::transform(const Mat4f &matrix, const Vec4f *input, Vec4f *output, int count, int output_stride)
+{
+	int i = 0;
+	switch (get_instruction_set())
+	{
+#if defined(CL_BATCH_MATH_AVX512)
+	case avx512: i = BatchMath_AVX512::transform(matrix, input, output, count, output_stride); break;
+#endif
+#if defined(CL_BATCH_MATH_AVX2)
+	case avx2: i = BatchMath_AVX2::transform(matrix, input, output, count, output_stride); break;
+#endif
+#if defined(CL_BATCH_MATH_SSE2)
+	case sse2: i = BatchMath_SSE2::transform(matrix, input, output, count, output_stride); break;
+#endif
+	default: break;
+	}
+
+	for (; i < count; i++)
+		*output_at(output, i, output_stride) = matrix * input[i];
+}
+
+void BatchMath::transform(const Mat3f &matrix, const Vec2f *input, Vec2f *output, int count)
+{
+	int i = 0;
+	switch (get_instruction_set())
+	{
+#if defined(CL_BATCH_MATH_AVX512)
+	case avx512: i = BatchMath_AVX512::transform(matrix, input, output, count); break;
+#endif
+#if defined(CL_BATCH_MATH_AVX2)
+	case avx2: i = BatchMath_AVX2::transform(matrix, input, output, count); break;
+#endif
+#if defined(CL_BATCH_MATH_SSE2)
+	case sse2: i = BatchMath_SSE2::transform(matrix, input, output, count); break;
+#endif
+	default: break;
+	}
+
+	for (; i < count; i++)
+		output[i] = matrix * input[i];
+}
+
+void BatchMath::transform(const Mat3f &matrix, const Vec3f *input, Vec3f *output, int count)
+{
+	// Three component vectors do not fill the wider registers well, so only SSE2 is used
+	int i = 0;
+#if defined(CL_BATCH_MATH_SSE2)
+	if (get_instruction_set() != scalar)
+		i = BatchMath_SSE2::transform(matrix, input, output, count);
+#endif
+
+	for (; i < count; i++)
+		output[i] = matrix * input[i];
+}
+
+Rectf BatchMath::bounding_box(const Vec2f *points, int count)
+{
+	if (count <= 0)
+		return Rectf();
+
+	Vec2f box_min = points[0];
+	Vec2f box_max = points[0];
+	int i = 0;
+	switch (get_instruction_set())
+	{
+#if defined(CL_BATCH_MATH_AVX512)
+	case avx512: i = BatchMath_AVX512::bounding_box(points, count, box_min, box_max); break;
+#endif
+#if defined(CL_BATCH_MATH_AVX2)
+	case avx2: i = BatchMath_AVX2::bounding_box(points, count, box_min, box_max); break;
+#endif
+#if defined(CL_BATCH_MATH_SSE2)
+	case sse2: i = BatchMath_SSE2::bounding_box(points, count, box_min, box_max); break;
+#endif
+	default: break;
+	}
+
+	for (; i < count; i++)
+	{
+		box_min = min(box_min, points[i]);
+		box_max = max(box_max, points[i]);
+	}
+	return Rectf(box_min.x, box_min.y, box_max.x, box_max.y);
+}
+
+AxisAlignedBoundingBox BatchMath::bounding_box(const Vec3f *points, int count)
+{
+	if (count <= 0)
+		return AxisAlignedBoundingBox();
+
+	Vec3f box_min = points[0];
+	Vec3f box_max = points[0];
+	int i = 0;
+#if defined(CL_BATCH_MATH_SSE2)
+	if (get_instruction_set() != scalar)
+		i = BatchMath_SSE2::bounding_box(points, count, box_min, box_max);
+#endif
+
+	for (; i < count; i++)
+	{
+		box_min = min(box_min, points[i]);
+		box_max = max(box_max, points[i]);
+	}
+	return AxisAlignedBoundingBox(box_min, box_max);
+}
+
+void BatchMath::deinterleave(const Vec2f *points, float *out_x, float *out_y, int count)
+{
+	int i = 0;
+#if defined(CL_BATCH_MATH_SSE2)
+	if (get_instruction_set() != scalar)
+		i = BatchMath_SSE2::deinterleave(points, out_x, out_y, count);
+#endif
+
+	for (; i < count; i++)
+	{
+		out_x[i] = points[i].x;
+		out_y[i] = points[i].y;
+	}
+}
+
+void BatchMath::deinterleave(const Vec4f *vectors, float *out_x, float *out_y, float *out_z, float *out_w, int count)
+{
+	int i = 0;
+#if defined(CL_BATCH_MATH_SSE2)
+	if (get_instruction_set() != scalar)
+		i = BatchMath_SSE2::deinterleave(vectors, out_x, out_y, out_z, out_w, count);
+#endif
+
+	for (; i < count; i++)
+	{
+		out_x[i] = vectors[i].x;
+		out_y[i] = vectors[i].y;
+		out_z[i] = vectors[i].z;
+		out_w[i] = vectors[i].w;
+	}
+}
+
+void BatchMath::interleave(const float *x, const float *y, Vec2f *out_points, int count)
+{
+	int i = 0;
+#if defined(CL_BATCH_MATH_SSE2)
+	if (get_instruction_set() != scalar)
+		i = BatchMath_SSE2::interleave(x, y, out_points, count);
+#endif
+
+	for (; i < count; i++)
+		out_points[i] = Vec2f(x[i], y[i]);
+}
+
+void BatchMath::interleave(const float *x, const float *y, const float *z, const float *w, Vec4f *out_vectors, int count)
+{
+	int i = 0;
+#if defined(CL_BATCH_MATH_SSE2)
+	if (get_instruction_set() != scalar)
+		i = BatchMath_SSE2::interleave(x, y, z, w, out_vectors, count);
+#endif
+
+	for (; i < count; i++)
+		out_vectors[i] = Vec4f(x[i], y[i], z[i], w[i]);
+}
+
+}
@@ -0,0 +1,180 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2015 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    agent
+*/
+
+#include "Core/precomp.h"
+#include "batch_math_simd.h"
+#include "API/Core/System/system.h"
+
+#ifdef CL_BATCH_MATH_AVX2
+#include <immintrin.h>
+
+// GCC and Clang only allow the AVX2 intrinsics in functions compiled for a CPU that has them
+#if defined(__GNUC__)
+#define CL_AVX2_TARGET __attribute__((target("avx2")))
+#else
+#define CL_AVX2_TARGET
+#endif
+
+namespace clan
+{
+
+bool BatchMath_AVX2::is_supported()
+{
+	static bool supported = System::detect_cpu_extension(System::avx2);
+	return supported;
+}
+
+static inline float *output_at(Vec4f *output, int index, int output_stride)
+{
+	return (float *)((char *)output + (size_t)index * output_stride);
+}
+
+// Stores the two vectors of a register
+CL_AVX2_TARGET static inline void store_vec4_pair(Vec4f *output, int index, int output_stride, __m256 result)
+{
+	if (output_stride == sizeof(Vec4f))
+	{
+		_mm256_storeu_ps(output_at(output, index, output_stride), result);
+	}
+	else
+	{
+		_mm_storeu_ps(output_at(output, index, output_stride), _mm256_castps256_ps128(result));
+		_mm_storeu_ps(output_at(output, index + 1, output_stride), _mm256_extractf128_ps(result, 1));
+	}
+}
+
+CL_AVX2_TARGET int BatchMath_AVX2::transform(const Mat4f &matrix, const Vec2f *input, Vec4f *output, int count, int output_stride)
+{
+	__m256 col0 = _mm256_broadcast_ps((const __m128 *)matrix.matrix);
+	__m256 col1 = _mm256_broadcast_ps((const __m128 *)(matrix.matrix + 4));
+	__m256 col3 = _mm256_broadcast_ps((const __m128 *)(matrix.matrix + 12));
+
+	// Four points per load, two points per register
+	const __m256i x01 = _mm256_setr_epi32(0, 0, 0, 0, 2, 2, 2, 2);
+	const __m256i y01 = _mm256_setr_epi32(1, 1, 1, 1, 3, 3, 3, 3);
+	const __m256i x23 = _mm256_setr_epi32(4, 4, 4, 4, 6, 6, 6, 6);
+	const __m256i y23 = _mm256_setr_epi32(5, 5, 5, 5, 7, 7, 7, 7);
+
+	int i;
+	for (i = 0; i + 4 <= count; i += 4)
+	{
+		__m256 xy = _mm256_loadu_ps(&input[i].x);
+		__m256 result01 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(col0, _mm256_permutevar8x32_ps(xy, x01)), _mm256_mul_ps(col1, _mm256_permutevar8x32_ps(xy, y01))), col3);
+		__m256 result23 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(col0, _mm256_permutevar8x32_ps(xy, x23)), _mm256_mul_ps(col1, _mm256_permutevar8x32_ps(xy, y23))), col3);
+		store_vec4_pair(output, i, output_stride, result01);
+		store_vec4_pair(output, i + 2, output_stride, result23);
+	}
+	return i;
+}
+
+CL_AVX2_TARGET int BatchMath_AVX2::transform(const Mat4f &matrix, const Vec3f *input, Vec4f *output, int count, int output_stride)
+{
+	__m256 col0 = _mm256_broadcast_ps((const __m128 *)matrix.matrix);
+	__m256 col1 = _mm256_broadcast_ps((const __m128 *)(matrix.matrix + 4));
+	__m256 col2 = _mm256_broadcast_ps((const __m128 *)(matrix.matrix + 8));
+	__m256 col3 = _mm256_broadcast_ps((const __m128 *)(matrix.matrix + 12));
+
+	// Two points (six floats) per load
+	const __m256i load_mask = _mm256_setr_epi32(-1, -1, -1, -1, -1, -1, 0, 0);
+	const __m256i x_index = _mm256_setr_epi32(0, 0, 0, 0, 3, 3, 3, 3);
+	const __m256i y_index = _mm256_setr_epi32(1, 1, 1, 1, 4, 4, 4, 4);
+	const __m256i z_index = _mm256_setr_epi32(2, 2, 2, 2, 5, 5, 5, 5);
+
+	int i;
+	for (i = 0; i + 2 <= count; i += 2)
+	{
+		__m256 xyz = _mm256_maskload_ps(&input[i].x, load_mask);
+		__m256 x = _mm256_permutevar8x32_ps(xyz, x_index);
+		__m256 y = _mm256_permutevar8x32_ps(xyz, y_index);
+		__m256 z = _mm256_permutevar8x32_ps(xyz, z_index);
+		store_vec4_pair(output, i, output_stride, _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(col0, x), _mm256_mul_ps(col1, y)), _mm256_mul_ps(col2, z)), col3));
+	}
+	return i;
+}
+
+CL_AVX2_TARGET int BatchMath_AVX2::transform(const Mat4f &matrix, const Vec4f *input, Vec4f *output, int count, int output_stride)
+{
+	__m256 col0 = _mm256_broadcast_ps((const __m128 *)matrix.matrix);
+	__m256 col1 = _mm256_broadcast_ps((const __m128 *)(matrix.matrix + 4));
+	__m256 col2 = _mm256_broadcast_ps((const __m128 *)(matrix.matrix + 8));
+	__m256 col3 = _mm256_broadcast_ps((const __m128 *)(matrix.matrix + 12));
+
+	int i;
+	for (i = 0; i + 2 <= count; i += 2)
+	{
+		__m256 v = _mm256_loadu_ps(&input[i].x);
+		__m256 x = _mm256_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0));
+		__m256 y = _mm256_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1));
+		__m256 z = _mm256_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2));
+		__m256 w = _mm256_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3));
+		store_vec4_pair(output, i, output_stride, _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(col0, x), _mm256_mul_ps(col1, y)), _mm256_mul_ps(col2, z)), _mm256_mul_ps(col3, w)));
+	}
+	return i;
+}
+
+CL_AVX2_TARGET int BatchMath_AVX2::transform(const Mat3f &matrix, const Vec2f *input, Vec2f *output, int count)
+{
+	const float *m = matrix.matrix;
+	__m256 col0 = _mm256_setr_ps(m[0], m[1], m[0], m[1], m[0], m[1], m[0], m[1]);
+	__m256 col1 = _mm256_setr_ps(m[3], m[4], m[3], m[4], m[3], m[4], m[3], m[4]);
+	__m256 col2 = _mm256_setr_ps(m[6], m[7], m[6], m[7], m[6], m[7], m[6], m[7]);
+
+	int i;
+	for (i = 0; i + 4 <= count; i += 4)
+	{
+		__m256 xy = _mm256_loadu_ps(&input[i].x);
+		__m256 x = _mm256_moveldup_ps(xy);
+		__m256 y = _mm256_movehdup_ps(xy);
+		_mm256_storeu_ps(&output[i].x, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(col0, x), _mm256_mul_ps(col1, y)), col2));
+	}
+	return i;
+}
+
+CL_AVX2_TARGET int BatchMath_AVX2::bounding_box(const Vec2f *points, int count, Vec2f &inout_min, Vec2f &inout_max)
+{
+	__m256 box_min = _mm256_castpd_ps(_mm256_broadcast_sd((const double *)&inout_min.x));
+	__m256 box_max = _mm256_castpd_ps(_mm256_broadcast_sd((const double *)&inout_max.x));
+
+	int i;
+	for (i = 0; i + 4 <= count; i += 4)
+	{
+		__m256 xy = _mm256_loadu_ps(&points[i].x);
+		box_min = _mm256_min_ps(box_min, xy);
+		box_max = _mm256_max_ps(box_max, xy);
+	}
+
+	__m128 min4 = _mm_min_ps(_mm256_castps256_ps128(box_min), _mm256_extractf128_ps(box_min, 1));
+	__m128 max4 = _mm_max_ps(_mm256_castps256_ps128(box_max), _mm256_extractf128_ps(box_max, 1));
+	_mm_storel_pi((__m64 *)&inout_min.x, _mm_min_ps(min4, _mm_movehl_ps(min4, min4)));
+	_mm_storel_pi((__m64 *)&inout_max.x, _mm_max_ps(max4, _mm_movehl_ps(max4, max4)));
+	return i;
+}
+
+}
+
+#endif
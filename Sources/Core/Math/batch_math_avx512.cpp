@@ -0,0 +1,195 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2015 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    agent
+*/
+
+#include "Core/precomp.h"
+#include "batch_math_simd.h"
+#include "API/Core/System/system.h"
+
+#ifdef CL_BATCH_MATH_AVX512
+#include <immintrin.h>
+
+// GCC and Clang only allow the AVX-512 intrinsics in functions compiled for a CPU that has them
+#if defined(__GNUC__)
+#define CL_AVX512_TARGET __attribute__((target("avx512f")))
+#else
+#define CL_AVX512_TARGET
+#endif
+
+// The AVX-512 intrinsics of GCC 12 pass _mm512_undefined_ps() as the unused merge source, which -Wall reports as
+// used uninitialized once they are inlined (GCC bug 105593, fixed in GCC 13)
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ == 12
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+namespace clan
+{
+
+bool BatchMath_AVX512::is_supported()
+{
+	static bool supported = System::detect_cpu_extension(System::avx512f);
+	return supported;
+}
+
+static inline float *output_at(Vec4f *output, int index, int output_stride)
+{
+	return (float *)((char *)output + (size_t)index * output_stride);
+}
+
+// Stores the four vectors of a register
+CL_AVX512_TARGET static inline void store_vec4_quad(Vec4f *output, int index, int output_stride, __m512 result)
+{
+	if (output_stride == sizeof(Vec4f))
+	{
+		_mm512_storeu_ps(output_at(output, index, output_stride), result);
+	}
+	else
+	{
+		_mm_storeu_ps(output_at(output, index, output_stride), _mm512_castps512_ps128(result));
+		_mm_storeu_ps(output_at(output, index + 1, output_stride), _mm512_extractf32x4_ps(result, 1));
+		_mm_storeu_ps(output_at(output, index + 2, output_stride), _mm512_extractf32x4_ps(result, 2));
+		_mm_storeu_ps(output_at(output, index + 3, output_stride), _mm512_extractf32x4_ps(result, 3));
+	}
+}
+
+// Repeats a matrix column in all four lanes
+CL_AVX512_TARGET static inline __m512 broadcast_column(const Mat4f &matrix, int offset)
+{
+	const float *column = matrix.matrix + offset;
+	return _mm512_setr4_ps(column[0], column[1], column[2], column[3]);
+}
+
+CL_AVX512_TARGET int BatchMath_AVX512::transform(const Mat4f &matrix, const Vec2f *input, Vec4f *output, int count, int output_stride)
+{
+	__m512 col0 = broadcast_column(matrix, 0);
+	__m512 col1 = broadcast_column(matrix, 4);
+	__m512 col3 = broadcast_column(matrix, 12);
+
+	// Eight points per load, four points per register
+	const __m512i x0123 = _mm512_setr_epi32(0, 0, 0, 0, 2, 2, 2, 2, 4, 4, 4, 4, 6, 6, 6, 6);
+	const __m512i y0123 = _mm512_setr_epi32(1, 1, 1, 1, 3, 3, 3, 3, 5, 5, 5, 5, 7, 7, 7, 7);
+	const __m512i x4567 = _mm512_setr_epi32(8, 8, 8, 8, 10, 10, 10, 10, 12, 12, 12, 12, 14, 14, 14, 14);
+	const __m512i y4567 = _mm512_setr_epi32(9, 9, 9, 9, 11, 11, 11, 11, 13, 13, 13, 13, 15, 15, 15, 15);
+
+	int i;
+	for (i = 0; i + 8 <= count; i += 8)
+	{
+		__m512 xy = _mm512_loadu_ps(&input[i].x);
+		__m512 result0123 = _mm512_add_ps(_mm512_add_ps(_mm512_mul_ps(col0, _mm512_permutexvar_ps(x0123, xy)), _mm512_mul_ps(col1, _mm512_permutexvar_ps(y0123, xy))), col3);
+		__m512 result4567 = _mm512_add_ps(_mm512_add_ps(_mm512_mul_ps(col0, _mm512_permutexvar_ps(x4567, xy)), _mm512_mul_ps(col1, _mm512_permutexvar_ps(y4567, xy))), col3);
+		store_vec4_quad(output, i, output_stride, result0123);
+		store_vec4_quad(output, i + 4, output_stride, result4567);
+	}
+	return i;
+}
+
+CL_AVX512_TARGET int BatchMath_AVX512::transform(const Mat4f &matrix, const Vec3f *input, Vec4f *output, int count, int output_stride)
+{
+	__m512 col0 = broadcast_column(matrix, 0);
+	__m512 col1 = broadcast_column(matrix, 4);
+	__m512 col2 = broadcast_column(matrix, 8);
+	__m512 col3 = broadcast_column(matrix, 12);
+
+	// Four points (twelve floats) per load
+	const __m512i x_index = _mm512_setr_epi32(0, 0, 0, 0, 3, 3, 3, 3, 6, 6, 6, 6, 9, 9, 9, 9);
+	const __m512i y_index = _mm512_setr_epi32(1, 1, 1, 1, 4, 4, 4, 4, 7, 7, 7, 7, 10, 10, 10, 10);
+	const __m512i z_index = _mm512_setr_epi32(2, 2, 2, 2, 5, 5, 5, 5, 8, 8, 8, 8, 11, 11, 11, 11);
+
+	int i;
+	for (i = 0; i + 4 <= count; i += 4)
+	{
+		__m512 xyz = _mm512_maskz_loadu_ps(0x0fff, &input[i].x);
+		__m512 x = _mm512_permutexvar_ps(x_index, xyz);
+		__m512 y = _mm512_permutexvar_ps(y_index, xyz);
+		__m512 z = _mm512_permutexvar_ps(z_index, xyz);
+		store_vec4_quad(output, i, output_stride, _mm512_add_ps(_mm512_add_ps(_mm512_add_ps(_mm512_mul_ps(col0, x), _mm512_mul_ps(col1, y)), _mm512_mul_ps(col2, z)), col3));
+	}
+	return i;
+}
+
+CL_AVX512_TARGET int BatchMath_AVX512::transform(const Mat4f &matrix, const Vec4f *input, Vec4f *output, int count, int output_stride)
+{
+	__m512 col0 = broadcast_column(matrix, 0);
+	__m512 col1 = broadcast_column(matrix, 4);
+	__m512 col2 = broadcast_column(matrix, 8);
+	__m512 col3 = broadcast_column(matrix, 12);
+
+	int i;
+	for (i = 0; i + 4 <= count; i += 4)
+	{
+		__m512 v = _mm512_loadu_ps(&input[i].x);
+		__m512 x = _mm512_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0));
+		__m512 y = _mm512_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1));
+		__m512 z = _mm512_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2));
+		__m512 w = _mm512_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3));
+		store_vec4_quad(output, i, output_stride, _mm512_add_ps(_mm512_add_ps(_mm512_add_ps(_mm512_mul_ps(col0, x), _mm512_mul_ps(col1, y)), _mm512_mul_ps(col2, z)), _mm512_mul_ps(col3, w)));
+	}
+	return i;
+}
+
+CL_AVX512_TARGET int BatchMath_AVX512::transform(const Mat3f &matrix, const Vec2f *input, Vec2f *output, int count)
+{
+	const float *m = matrix.matrix;
+	__m512 col0 = _mm512_setr4_ps(m[0], m[1], m[0], m[1]);
+	__m512 col1 = _mm512_setr4_ps(m[3], m[4], m[3], m[4]);
+	__m512 col2 = _mm512_setr4_ps(m[6], m[7], m[6], m[7]);
+
+	int i;
+	for (i = 0; i + 8 <= count; i += 8)
+	{
+		__m512 xy = _mm512_loadu_ps(&input[i].x);
+		__m512 x = _mm512_moveldup_ps(xy);
+		__m512 y = _mm512_movehdup_ps(xy);
+		_mm512_storeu_ps(&output[i].x, _mm512_add_ps(_mm512_add_ps(_mm512_mul_ps(col0, x), _mm512_mul_ps(col1, y)), col2));
+	}
+	return i;
+}
+
+CL_AVX512_TARGET int BatchMath_AVX512::bounding_box(const Vec2f *points, int count, Vec2f &inout_min, Vec2f &inout_max)
+{
+	__m512 box_min = _mm512_setr4_ps(inout_min.x, inout_min.y, inout_min.x, inout_min.y);
+	__m512 box_max = _mm512_setr4_ps(inout_max.x, inout_max.y, inout_max.x, inout_max.y);
+
+	int i;
+	for (i = 0; i + 8 <= count; i += 8)
+	{
+		__m512 xy = _mm512_loadu_ps(&points[i].x);
+		box_min = _mm512_min_ps(box_min, xy);
+		box_max = _mm512_max_ps(box_max, xy);
+	}
+
+	__m128 min4 = _mm_min_ps(_mm_min_ps(_mm512_castps512_ps128(box_min), _mm512_extractf32x4_ps(box_min, 1)), _mm_min_ps(_mm512_extractf32x4_ps(box_min, 2), _mm512_extractf32x4_ps(box_min, 3)));
+	__m128 max4 = _mm_max_ps(_mm_max_ps(_mm512_castps512_ps128(box_max), _mm512_extractf32x4_ps(box_max, 1)), _mm_max_ps(_mm512_extractf32x4_ps(box_max, 2), _mm512_extractf32x4_ps(box_max, 3)));
+	_mm_storel_pi((__m64 *)&inout_min.x, _mm_min_ps(min4, _mm_movehl_ps(min4, min4)));
+	_mm_storel_pi((__m64 *)&inout_max.x, _mm_max_ps(max4, _mm_movehl_ps(max4, max4)));
+	return i;
+}
+
+}
+
+#endif
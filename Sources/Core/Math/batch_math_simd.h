@@ -0,0 +1,91 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2015 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    agent
+*/
+
+#pragma once
+
+#include "API/Core/Math/batch_math.h"
+
+#if !defined(CL_ARM_PLATFORM) && !defined(CL_DISABLE_SSE2)
+#define CL_BATCH_MATH_SSE2
+#define CL_BATCH_MATH_AVX2
+#if defined(__GNUC__) || (defined(_MSC_VER) && _MSC_VER >= 1910)
+#define CL_BATCH_MATH_AVX512
+#endif
+#endif
+
+namespace clan
+{
+
+// The kernels process as many elements as fit their vector width and return how many they processed.
+// BatchMath finishes the remaining elements. The AVX2 and AVX-512 kernels must only be called when
+// is_supported() returns true.
+
+class BatchMath_SSE2
+{
+public:
+	static int transform(const Mat4f &matrix, const Vec2f *input, Vec4f *output, int count, int output_stride);
+	static int transform(const Mat4f &matrix, const Vec3f *input, Vec4f *output, int count, int output_stride);
+	static int transform(const Mat4f &matrix, const Vec4f *input, Vec4f *output, int count, int output_stride);
+	static int transform(const Mat3f &matrix, const Vec2f *input, Vec2f *output, int count);
+	static int transform(const Mat3f &matrix, const Vec3f *input, Vec3f *output, int count);
+
+	/// \brief Extends min and max (which must already hold a point) with the points
+	static int bounding_box(const Vec2f *points, int count, Vec2f &inout_min, Vec2f &inout_max);
+	static int bounding_box(const Vec3f *points, int count, Vec3f &inout_min, Vec3f &inout_max);
+
+	static int deinterleave(const Vec2f *points, float *out_x, float *out_y, int count);
+	static int deinterleave(const Vec4f *vectors, float *out_x, float *out_y, float *out_z, float *out_w, int count);
+	static int interleave(const float *x, const float *y, Vec2f *out_points, int count);
+	static int interleave(const float *x, const float *y, const float *z, const float *w, Vec4f *out_vectors, int count);
+};
+
+class BatchMath_AVX2
+{
+public:
+	static bool is_supported();
+
+	static int transform(const Mat4f &matrix, const Vec2f *input, Vec4f *output, int count, int output_stride);
+	static int transform(const Mat4f &matrix, const Vec3f *input, Vec4f *output, int count, int output_stride);
+	static int transform(const Mat4f &matrix, const Vec4f *input, Vec4f *output, int count, int output_stride);
+	static int transform(const Mat3f &matrix, const Vec2f *input, Vec2f *output, int count);
+	static int bounding_box(const Vec2f *points, int count, Vec2f &inout_min, Vec2f &inout_max);
+};
+
+class BatchMath_AVX512
+{
+public:
+	static bool is_supported();
+
+	static int transform(const Mat4f &matrix, const Vec2f *input, Vec4f *output, int count, int output_stride);
+	static int transform(const Mat4f &matrix, const Vec3f *input, Vec4f *output, int count, int output_stride);
+	static int transform(const Mat4f &matrix, const Vec4f *input, Vec4f *output, int count, int output_stride);
+	static int transform(const Mat3f &matrix, const Vec2f *input, Vec2f *output, int count);
+	static int bounding_box(const Vec2f *points, int count, Vec2f &inout_min, Vec2f &inout_max);
+};
+
+}
@@ -0,0 +1,244 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2015 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    agent
+*/
+
+#include "Core/precomp.h"
+#include "batch_math_simd.h"
+
+#ifdef CL_BATCH_MATH_SSE2
+#include <emmintrin.h>
+
+namespace clan
+{
+
+static inline float *output_at(Vec4f *output, int index, int output_stride)
+{
+	return (float *)((char *)output + (size_t)index * output_stride);
+}
+
+int BatchMath_SSE2::transform(const Mat4f &matrix, const Vec2f *input, Vec4f *output, int count, int output_stride)
+{
+	__m128 col0 = _mm_loadu_ps(matrix.matrix);
+	__m128 col1 = _mm_loadu_ps(matrix.matrix + 4);
+	__m128 col3 = _mm_loadu_ps(matrix.matrix + 12);
+
+	// Two points per load
+	int i;
+	for (i = 0; i + 2 <= count; i += 2)
+	{
+		__m128 xy = _mm_loadu_ps(&input[i].x);
+		__m128 x0 = _mm_shuffle_ps(xy, xy, _MM_SHUFFLE(0, 0, 0, 0));
+		__m128 y0 = _mm_shuffle_ps(xy, xy, _MM_SHUFFLE(1, 1, 1, 1));
+		__m128 x1 = _mm_shuffle_ps(xy, xy, _MM_SHUFFLE(2, 2, 2, 2));
+		__m128 y1 = _mm_shuffle_ps(xy, xy, _MM_SHUFFLE(3, 3, 3, 3));
+		_mm_storeu_ps(output_at(output, i, output_stride), _mm_add_ps(_mm_add_ps(_mm_mul_ps(col0, x0), _mm_mul_ps(col1, y0)), col3));
+		_mm_storeu_ps(output_at(output, i + 1, output_stride), _mm_add_ps(_mm_add_ps(_mm_mul_ps(col0, x1), _mm_mul_ps(col1, y1)), col3));
+	}
+	return i;
+}
+
+int BatchMath_SSE2::transform(const Mat4f &matrix, const Vec3f *input, Vec4f *output, int count, int output_stride)
+{
+	__m128 col0 = _mm_loadu_ps(matrix.matrix);
+	__m128 col1 = _mm_loadu_ps(matrix.matrix + 4);
+	__m128 col2 = _mm_loadu_ps(matrix.matrix + 8);
+	__m128 col3 = _mm_loadu_ps(matrix.matrix + 12);
+
+	for (int i = 0; i < count; i++)
+	{
+		__m128 x = _mm_set1_ps(input[i].x);
+		__m128 y = _mm_set1_ps(input[i].y);
+		__m128 z = _mm_set1_ps(input[i].z);
+		_mm_storeu_ps(output_at(output, i, output_stride), _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(col0, x), _mm_mul_ps(col1, y)), _mm_mul_ps(col2, z)), col3));
+	}
+	return count;
+}
+
+int BatchMath_SSE2::transform(const Mat4f &matrix, const Vec4f *input, Vec4f *output, int count, int output_stride)
+{
+	__m128 col0 = _mm_loadu_ps(matrix.matrix);
+	__m128 col1 = _mm_loadu_ps(matrix.matrix + 4);
+	__m128 col2 = _mm_loadu_ps(matrix.matrix + 8);
+	__m128 col3 = _mm_loadu_ps(matrix.matrix + 12);
+
+	for (int i = 0; i < count; i++)
+	{
+		__m128 v = _mm_loadu_ps(&input[i].x);
+		__m128 x = _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0));
+		__m128 y = _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1));
+		__m128 z = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2));
+		__m128 w = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3));
+		_mm_storeu_ps(output_at(output, i, output_stride), _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(col0, x), _mm_mul_ps(col1, y)), _mm_mul_ps(col2, z)), _mm_mul_ps(col3, w)));
+	}
+	return count;
+}
+
+int BatchMath_SSE2::transform(const Mat3f &matrix, const Vec2f *input, Vec2f *output, int count)
+{
+	// Two points per register: x' = m0*x + m3*y + m6, y' = m1*x + m4*y + m7
+	const float *m = matrix.matrix;
+	__m128 col0 = _mm_setr_ps(m[0], m[1], m[0], m[1]);
+	__m128 col1 = _mm_setr_ps(m[3], m[4], m[3], m[4]);
+	__m128 col2 = _mm_setr_ps(m[6], m[7], m[6], m[7]);
+
+	int i;
+	for (i = 0; i + 2 <= count; i += 2)
+	{
+		__m128 xy = _mm_loadu_ps(&input[i].x);
+		__m128 x = _mm_shuffle_ps(xy, xy, _MM_SHUFFLE(2, 2, 0, 0));
+		__m128 y = _mm_shuffle_ps(xy, xy, _MM_SHUFFLE(3, 3, 1, 1));
+		_mm_storeu_ps(&output[i].x, _mm_add_ps(_mm_add_ps(_mm_mul_ps(col0, x), _mm_mul_ps(col1, y)), col2));
+	}
+	return i;
+}
+
+int BatchMath_SSE2::transform(const Mat3f &matrix, const Vec3f *input, Vec3f *output, int count)
+{
+	const float *m = matrix.matrix;
+	__m128 col0 = _mm_setr_ps(m[0], m[1], m[2], 0.0f);
+	__m128 col1 = _mm_setr_ps(m[3], m[4], m[5], 0.0f);
+	__m128 col2 = _mm_setr_ps(m[6], m[7], m[8], 0.0f);
+
+	for (int i = 0; i < count; i++)
+	{
+		__m128 x = _mm_set1_ps(input[i].x);
+		__m128 y = _mm_set1_ps(input[i].y);
+		__m128 z = _mm_set1_ps(input[i].z);
+		__m128 result = _mm_add_ps(_mm_add_ps(_mm_mul_ps(col0, x), _mm_mul_ps(col1, y)), _mm_mul_ps(col2, z));
+		_mm_storel_pi((__m64 *)&output[i].x, result);
+		_mm_store_ss(&output[i].z, _mm_movehl_ps(result, result));
+	}
+	return count;
+}
+
+int BatchMath_SSE2::bounding_box(const Vec2f *points, int count, Vec2f &inout_min, Vec2f &inout_max)
+{
+	__m128 box_min = _mm_setr_ps(inout_min.x, inout_min.y, inout_min.x, inout_min.y);
+	__m128 box_max = _mm_setr_ps(inout_max.x, inout_max.y, inout_max.x, inout_max.y);
+
+	int i;
+	for (i = 0; i + 2 <= count; i += 2)
+	{
+		__m128 xy = _mm_loadu_ps(&points[i].x);
+		box_min = _mm_min_ps(box_min, xy);
+		box_max = _mm_max_ps(box_max, xy);
+	}
+
+	box_min = _mm_min_ps(box_min, _mm_movehl_ps(box_min, box_min));
+	box_max = _mm_max_ps(box_max, _mm_movehl_ps(box_max, box_max));
+	_mm_storel_pi((__m64 *)&inout_min.x, box_min);
+	_mm_storel_pi((__m64 *)&inout_max.x, box_max);
+	return i;
+}
+
+int BatchMath_SSE2::bounding_box(const Vec3f *points, int count, Vec3f &inout_min, Vec3f &inout_max)
+{
+	__m128 box_min = _mm_setr_ps(inout_min.x, inout_min.y, inout_min.z, 0.0f);
+	__m128 box_max = _mm_setr_ps(inout_max.x, inout_max.y, inout_max.z, 0.0f);
+
+	// Each load also reads the x of the following point, so the last point is left to the caller
+	int i;
+	for (i = 0; i + 1 < count; i++)
+	{
+		__m128 xyz = _mm_loadu_ps(&points[i].x);
+		box_min = _mm_min_ps(box_min, xyz);
+		box_max = _mm_max_ps(box_max, xyz);
+	}
+
+	float result[4];
+	_mm_storeu_ps(result, box_min);
+	inout_min = Vec3f(result[0], result[1], result[2]);
+	_mm_storeu_ps(result, box_max);
+	inout_max = Vec3f(result[0], result[1], result[2]);
+	return i;
+}
+
+int BatchMath_SSE2::deinterleave(const Vec2f *points, float *out_x, float *out_y, int count)
+{
+	int i;
+	for (i = 0; i + 4 <= count; i += 4)
+	{
+		__m128 xy01 = _mm_loadu_ps(&points[i].x);
+		__m128 xy23 = _mm_loadu_ps(&points[i + 2].x);
+		_mm_storeu_ps(out_x + i, _mm_shuffle_ps(xy01, xy23, _MM_SHUFFLE(2, 0, 2, 0)));
+		_mm_storeu_ps(out_y + i, _mm_shuffle_ps(xy01, xy23, _MM_SHUFFLE(3, 1, 3, 1)));
+	}
+	return i;
+}
+
+int BatchMath_SSE2::deinterleave(const Vec4f *vectors, float *out_x, float *out_y, float *out_z, float *out_w, int count)
+{
+	int i;
+	for (i = 0; i + 4 <= count; i += 4)
+	{
+		__m128 row0 = _mm_loadu_ps(&vectors[i].x);
+		__m128 row1 = _mm_loadu_ps(&vectors[i + 1].x);
+		__m128 row2 = _mm_loadu_ps(&vectors[i + 2].x);
+		__m128 row3 = _mm_loadu_ps(&vectors[i + 3].x);
+		_MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+		_mm_storeu_ps(out_x + i, row0);
+		_mm_storeu_ps(out_y + i, row1);
+		_mm_storeu_ps(out_z + i, row2);
+		_mm_storeu_ps(out_w + i, row3);
+	}
+	return i;
+}
+
+int BatchMath_SSE2::interleave(const float *x, const float *y, Vec2f *out_points, int count)
+{
+	int i;
+	for (i = 0; i + 4 <= count; i += 4)
+	{
+		__m128 x4 = _mm_loadu_ps(x + i);
+		__m128 y4 = _mm_loadu_ps(y + i);
+		_mm_storeu_ps(&out_points[i].x, _mm_unpacklo_ps(x4, y4));
+		_mm_storeu_ps(&out_points[i + 2].x, _mm_unpackhi_ps(x4, y4));
+	}
+	return i;
+}
+
+int BatchMath_SSE2::interleave(const float *x, const float *y, const float *z, const float *w, Vec4f *out_vectors, int count)
+{
+	int i;
+	for (i = 0; i + 4 <= count; i += 4)
+	{
+		__m128 row0 = _mm_loadu_ps(x + i);
+		__m128 row1 = _mm_loadu_ps(y + i);
+		__m128 row2 = _mm_loadu_ps(z + i);
+		__m128 row3 = _mm_loadu_ps(w + i);
+		_MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+		_mm_storeu_ps(&out_vectors[i].x, row0);
+		_mm_storeu_ps(&out_vectors[i + 1].x, row1);
+		_mm_storeu_ps(&out_vectors[i + 2].x, row2);
+		_mm_storeu_ps(&out_vectors[i + 3].x, row3);
+	}
+	return i;
+}
+
+}
+
+#endif
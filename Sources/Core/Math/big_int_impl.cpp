@@ -47,8 +47,11 @@
 
 #include "Core/precomp.h"
 #include "big_int_impl.h"
+#include "big_int_limbs.h"
+#include "big_int_montgomery.h"
 #include "API/Core/Math/big_int.h"
 #include <cstdlib>
+#include <algorithm>
 
 namespace clan
 {
@@ -1318,6 +1321,12 @@ void BigInt_Impl::internal_mul(const BigInt_Impl *b)
 	// Compute a = |a| * |b|
 	ubyte64   w, k = 0;
 	unsigned int   ix, jx, ua = digits_used, ub = b->digits_used;
+
+	if (ua >= limb_kernel_min_digits && ub >= limb_kernel_min_digits)
+	{
+		internal_mul_limbs(b);
+		return;
+	}
 	ubyte32 *pa;
 	const ubyte32 *pb;
 	ubyte32 *pt, *pbt;
@@ -1512,6 +1521,12 @@ void BigInt_Impl::internal_sqr()
 	unsigned int  ix, jx, kx, used = digits_used;
 	ubyte32 *pa1, *pa2, *pt, *pbt;
 
+	if (used >= limb_kernel_min_digits)
+	{
+		internal_sqr_limbs();
+		return;
+	}
+
 	BigInt_Impl tmp_impl( 2 * used);
 
 	// Left-pad with zeroes
@@ -1601,6 +1616,48 @@ void BigInt_Impl::internal_sqr()
 	tmp_impl.internal_exch(this);
 }
 
+void BigInt_Impl::internal_mul_limbs(const BigInt_Impl *b)
+{
+	// Compute a = |a| * |b| with 64-bit limbs, using Karatsuba for large operands
+	int na = BigInt_Limbs::limbs_for_digits(digits_used);
+	int nb = BigInt_Limbs::limbs_for_digits(b->digits_used);
+
+	std::vector<BigInt_Limbs::Limb> buffer(2 * (na + nb) + BigInt_Limbs::scratch_size(std::max(na, nb)));
+	BigInt_Limbs::Limb *pa = &buffer[0];
+	BigInt_Limbs::Limb *pb = pa + na;
+	BigInt_Limbs::Limb *pt = pb + nb;
+	BigInt_Limbs::from_digits(pa, na, digits, digits_used);
+	BigInt_Limbs::from_digits(pb, nb, b->digits, b->digits_used);
+	BigInt_Limbs::mul(pt, pa, na, pb, nb, pt + na + nb);
+
+	unsigned int num_digits = (na + nb) * BigInt_Limbs::digits_per_limb;
+	BigInt_Impl tmp_impl(num_digits);
+	tmp_impl.digits_used = num_digits;
+	BigInt_Limbs::to_digits(tmp_impl.digits, num_digits, pt, na + nb);
+
+	tmp_impl.internal_clamp();
+	tmp_impl.internal_exch(this);
+}
+
+void BigInt_Impl::internal_sqr_limbs()
+{
+	int n = BigInt_Limbs::limbs_for_digits(digits_used);
+
+	std::vector<BigInt_Limbs::Limb> buffer(3 * n + BigInt_Limbs::scratch_size(n));
+	BigInt_Limbs::Limb *pa = &buffer[0];
+	BigInt_Limbs::Limb *pt = pa + n;
+	BigInt_Limbs::from_digits(pa, n, digits, digits_used);
+	BigInt_Limbs::sqr(pt, pa, n, pt + 2 * n);
+
+	unsigned int num_digits = 2 * n * BigInt_Limbs::digits_per_limb;
+	BigInt_Impl tmp_impl(num_digits);
+	tmp_impl.digits_used = num_digits;
+	BigInt_Limbs::to_digits(tmp_impl.digits, num_digits, pt, 2 * n);
+
+	tmp_impl.internal_clamp();
+	tmp_impl.internal_exch(this);
+}
+
 void BigInt_Impl::exptmod(const BigInt_Impl *b, const BigInt_Impl *m, BigInt_Impl *c) const
 {
 	BigInt_Impl s, mu;
@@ -1617,6 +1674,14 @@ void BigInt_Impl::exptmod(const BigInt_Impl *b, const BigInt_Impl *m, BigInt_Imp
 
 	x.mod(m, &x);
 
+	// Odd moduli (which includes all RSA moduli and prime candidates) use Montgomery multiplication
+	if (m->isodd() && m->cmp_d(1) > 0)
+	{
+		BigInt_Montgomery montgomery(*m);
+		montgomery.exptmod(x, *b, c);
+		return;
+	}
+
 	s.set(1);
 
 	// mu = b^2k / m
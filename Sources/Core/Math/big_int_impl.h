@@ -110,6 +110,9 @@ public:
 
 	static const int default_allocated_precision;
 
+	/// \brief Multiplications where both operands have at least this many digits use BigInt_Limbs
+	static const unsigned int limb_kernel_min_digits = 8;
+
 private:
 	static const int num_bits_in_digit = (8*sizeof(ubyte32));
 	static const int num_bits_in_word = (8*sizeof(ubyte64));
@@ -168,6 +171,8 @@ private:
 
 	void internal_reduce(const BigInt_Impl *m, BigInt_Impl *mu);
 	void internal_sqr();
+	void internal_mul_limbs(const BigInt_Impl *b);
+	void internal_sqr_limbs();
 
 	bool digits_negative;	// True if the value is negative
 	unsigned int digits_alloc;		// How many digits allocated
@@ -176,6 +181,8 @@ private:
 
 	BigInt_Impl &operator=(const BigInt_Impl& other);	// Not defined
 
+	friend class BigInt_Montgomery;
+
 };
 
 }
@@ -0,0 +1,277 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2015 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    agent
+*/
+
+#include "Core/precomp.h"
+#include "big_int_limbs.h"
+#include <algorithm>
+
+namespace clan
+{
+
+void BigInt_Limbs::from_digits(Limb *limbs, int num_limbs, const ubyte32 *digits, int num_digits)
+{
+	for (int i = 0; i < num_limbs; i++)
+	{
+		Limb value = 0;
+		for (int j = 0; j < digits_per_limb; j++)
+		{
+			int digit_index = i * digits_per_limb + j;
+			if (digit_index < num_digits)
+				value |= ((Limb) digits[digit_index]) << (j * 32);
+		}
+		limbs[i] = value;
+	}
+}
+
+void BigInt_Limbs::to_digits(ubyte32 *digits, int num_digits, const Limb *limbs, int num_limbs)
+{
+	for (int i = 0; i < num_digits; i++)
+	{
+		int limb_index = i / digits_per_limb;
+		digits[i] = (limb_index < num_limbs) ? (ubyte32) (limbs[limb_index] >> ((i % digits_per_limb) * 32)) : 0;
+	}
+}
+
+void BigInt_Limbs::mul(Limb *result, const Limb *a, int na, const Limb *b, int nb, Limb *scratch)
+{
+	if (na < nb)
+	{
+		std::swap(a, b);
+		std::swap(na, nb);
+	}
+
+	if (nb < karatsuba_threshold)
+	{
+		mul_basecase(result, a, na, b, nb);
+	}
+	else if (na == nb)
+	{
+		mul_karatsuba(result, a, b, na, scratch);
+	}
+	else
+	{
+		// Unbalanced operands are multiplied in pieces the size of the smaller operand
+		memset(result, 0, (na + nb) * sizeof(Limb));
+		Limb *product = scratch;
+		scratch += 2 * nb;
+		for (int pos = 0; pos < na; pos += nb)
+		{
+			int chunk = std::min(nb, na - pos);
+			if (chunk == nb)
+				mul_karatsuba(product, a + pos, b, nb, scratch);
+			else
+				mul(product, a + pos, chunk, b, nb, scratch);
+			add_into(result + pos, na + nb - pos, product, chunk + nb);
+		}
+	}
+}
+
+void BigInt_Limbs::sqr(Limb *result, const Limb *a, int n, Limb *scratch)
+{
+	if (n < karatsuba_threshold)
+		sqr_basecase(result, a, n);
+	else
+		sqr_karatsuba(result, a, n, scratch);
+}
+
+BigInt_Limbs::Limb BigInt_Limbs::add(Limb *result, const Limb *a, const Limb *b, int n)
+{
+	Limb carry = 0;
+	for (int i = 0; i < n; i++)
+	{
+		Limb sum = a[i] + carry;
+		carry = (sum < carry);
+		sum += b[i];
+		carry += (sum < b[i]);
+		result[i] = sum;
+	}
+	return carry;
+}
+
+BigInt_Limbs::Limb BigInt_Limbs::sub(Limb *result, const Limb *a, const Limb *b, int n)
+{
+	Limb borrow = 0;
+	for (int i = 0; i < n; i++)
+	{
+		Limb value = a[i];
+		Limb diff = value - b[i] - borrow;
+		borrow = (value < b[i]) || (borrow && value == b[i]);
+		result[i] = diff;
+	}
+	return borrow;
+}
+
+int BigInt_Limbs::cmp(const Limb *a, const Limb *b, int n)
+{
+	for (int i = n - 1; i >= 0; i--)
+	{
+		if (a[i] != b[i])
+			return a[i] > b[i] ? 1 : -1;
+	}
+	return 0;
+}
+
+void BigInt_Limbs::mul_basecase(Limb *result, const Limb *a, int na, const Limb *b, int nb)
+{
+	memset(result, 0, na * sizeof(Limb));
+	for (int i = 0; i < nb; i++)
+	{
+		Limb digit = b[i];
+		Limb carry = 0;
+		Limb *row = result + i;
+		for (int j = 0; j < na; j++)
+		{
+			WideLimb w = (WideLimb) a[j] * digit + row[j] + carry;
+			row[j] = (Limb) w;
+			carry = (Limb) (w >> limb_bits);
+		}
+		row[na] = carry;
+	}
+}
+
+void BigInt_Limbs::sqr_basecase(Limb *result, const Limb *a, int n)
+{
+	// Sum the products below the diagonal once, double them and then add the squares on the diagonal
+	memset(result, 0, 2 * n * sizeof(Limb));
+	for (int i = 0; i < n; i++)
+	{
+		Limb digit = a[i];
+		Limb carry = 0;
+		for (int j = i + 1; j < n; j++)
+		{
+			WideLimb w = (WideLimb) a[j] * digit + result[i + j] + carry;
+			result[i + j] = (Limb) w;
+			carry = (Limb) (w >> limb_bits);
+		}
+		result[i + n] = carry;
+	}
+
+	Limb top_bit = 0;
+	for (int i = 0; i < 2 * n; i++)
+	{
+		Limb value = result[i];
+		result[i] = (value << 1) | top_bit;
+		top_bit = value >> (limb_bits - 1);
+	}
+
+	Limb carry = 0;
+	for (int i = 0; i < n; i++)
+	{
+		WideLimb square = (WideLimb) a[i] * a[i];
+		WideLimb w = (WideLimb) result[2 * i] + (Limb) square + carry;
+		result[2 * i] = (Limb) w;
+		w = (WideLimb) result[2 * i + 1] + (Limb) (square >> limb_bits) + (Limb) (w >> limb_bits);
+		result[2 * i + 1] = (Limb) w;
+		carry = (Limb) (w >> limb_bits);
+	}
+}
+
+void BigInt_Limbs::mul_karatsuba(Limb *result, const Limb *a, const Limb *b, int n, Limb *scratch)
+{
+	if (n < karatsuba_threshold)
+	{
+		mul_basecase(result, a, n, b, n);
+		return;
+	}
+
+	// a = a1 * B^low + a0, b = b1 * B^low + b0
+	// a * b = z2 * B^(2*low) + (z1 - z2 - z0) * B^low + z0, where z1 = (a0 + a1) * (b0 + b1)
+	int low = n / 2;
+	int high = n - low;
+
+	Limb *sum_a = scratch;
+	Limb *sum_b = sum_a + high + 1;
+	Limb *z1 = sum_b + high + 1;
+	Limb *next_scratch = z1 + 2 * (high + 1);
+
+	mul_karatsuba(result, a, b, low, next_scratch);
+	mul_karatsuba(result + 2 * low, a + low, b + low, high, next_scratch);
+
+	memcpy(sum_a, a + low, high * sizeof(Limb));
+	sum_a[high] = add_into(sum_a, high, a, low);
+	memcpy(sum_b, b + low, high * sizeof(Limb));
+	sum_b[high] = add_into(sum_b, high, b, low);
+
+	mul_karatsuba(z1, sum_a, sum_b, high + 1, next_scratch);
+	sub_from(z1, 2 * (high + 1), result, 2 * low);
+	sub_from(z1, 2 * (high + 1), result + 2 * low, 2 * high);
+	add_into(result + low, 2 * n - low, z1, std::min(2 * (high + 1), 2 * n - low));
+}
+
+void BigInt_Limbs::sqr_karatsuba(Limb *result, const Limb *a, int n, Limb *scratch)
+{
+	if (n < karatsuba_threshold)
+	{
+		sqr_basecase(result, a, n);
+		return;
+	}
+
+	int low = n / 2;
+	int high = n - low;
+
+	Limb *sum_a = scratch;
+	Limb *z1 = sum_a + high + 1;
+	Limb *next_scratch = z1 + 2 * (high + 1);
+
+	sqr_karatsuba(result, a, low, next_scratch);
+	sqr_karatsuba(result + 2 * low, a + low, high, next_scratch);
+
+	memcpy(sum_a, a + low, high * sizeof(Limb));
+	sum_a[high] = add_into(sum_a, high, a, low);
+
+	sqr_karatsuba(z1, sum_a, high + 1, next_scratch);
+	sub_from(z1, 2 * (high + 1), result, 2 * low);
+	sub_from(z1, 2 * (high + 1), result + 2 * low, 2 * high);
+	add_into(result + low, 2 * n - low, z1, std::min(2 * (high + 1), 2 * n - low));
+}
+
+BigInt_Limbs::Limb BigInt_Limbs::add_into(Limb *result, int result_size, const Limb *a, int na)
+{
+	// result += a, propagating the carry through the rest of result
+	Limb carry = add(result, result, a, na);
+	for (int i = na; carry && i < result_size; i++)
+	{
+		result[i] += carry;
+		carry = (result[i] == 0);
+	}
+	return carry;
+}
+
+BigInt_Limbs::Limb BigInt_Limbs::sub_from(Limb *result, int result_size, const Limb *a, int na)
+{
+	// result -= a, propagating the borrow through the rest of result
+	Limb borrow = sub(result, result, a, na);
+	for (int i = na; borrow && i < result_size; i++)
+	{
+		borrow = (result[i] == 0);
+		result[i]--;
+	}
+	return borrow;
+}
+
+}
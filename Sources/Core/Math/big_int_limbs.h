@@ -0,0 +1,96 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2015 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    agent
+*/
+
+#pragma once
+
+#include "API/Core/System/cl_platform.h"
+
+namespace clan
+{
+
+/// \brief Multiplication kernels working on 64-bit limbs
+///
+/// BigInt_Impl stores its digits as ubyte32, which keeps the MPI derived division and conversion code simple.
+/// The multiplications dominate exponentiation and prime generation, so they repack the digits into 64-bit limbs
+/// with 128-bit intermediate products when the compiler provides them (32-bit limbs otherwise).
+class BigInt_Limbs
+{
+public:
+#if defined(__SIZEOF_INT128__)
+	typedef ubyte64 Limb;
+	typedef unsigned __int128 WideLimb;
+#else
+	typedef ubyte32 Limb;
+	typedef ubyte64 WideLimb;
+#endif
+
+	static const int limb_bits = 8 * sizeof(Limb);
+	static const int digits_per_limb = sizeof(Limb) / sizeof(ubyte32);
+
+	/// \brief Operands with at least this many limbs are multiplied using Karatsuba
+	static const int karatsuba_threshold = 32;
+
+	/// \brief Number of limbs needed for the scratch buffer of mul() and sqr(), given the size of the largest operand
+	static int scratch_size(int num_limbs) { return 8 * num_limbs + 8 * limb_bits; }
+
+	/// \brief Number of limbs needed to hold num_digits ubyte32 digits
+	static int limbs_for_digits(int num_digits) { return (num_digits + digits_per_limb - 1) / digits_per_limb; }
+
+	/// \brief Packs num_digits ubyte32 digits into num_limbs limbs, zero padding the top limbs
+	static void from_digits(Limb *limbs, int num_limbs, const ubyte32 *digits, int num_digits);
+
+	/// \brief Unpacks limbs into num_digits ubyte32 digits
+	static void to_digits(ubyte32 *digits, int num_digits, const Limb *limbs, int num_limbs);
+
+	/// \brief result[0..na+nb) = a * b
+	///
+	/// The result may not overlap the inputs
+	static void mul(Limb *result, const Limb *a, int na, const Limb *b, int nb, Limb *scratch);
+
+	/// \brief result[0..2n) = a * a
+	static void sqr(Limb *result, const Limb *a, int n, Limb *scratch);
+
+	/// \brief result[0..n) = a + b, returns the carry
+	static Limb add(Limb *result, const Limb *a, const Limb *b, int n);
+
+	/// \brief result[0..n) = a - b, returns the borrow
+	static Limb sub(Limb *result, const Limb *a, const Limb *b, int n);
+
+	/// \brief Compare a <=> b, both n limbs long
+	static int cmp(const Limb *a, const Limb *b, int n);
+
+private:
+	static void mul_basecase(Limb *result, const Limb *a, int na, const Limb *b, int nb);
+	static void sqr_basecase(Limb *result, const Limb *a, int n);
+	static void mul_karatsuba(Limb *result, const Limb *a, const Limb *b, int n, Limb *scratch);
+	static void sqr_karatsuba(Limb *result, const Limb *a, int n, Limb *scratch);
+	static Limb add_into(Limb *result, int result_size, const Limb *a, int na);
+	static Limb sub_from(Limb *result, int result_size, const Limb *a, int na);
+};
+
+}
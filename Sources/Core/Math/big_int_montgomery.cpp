@@ -0,0 +1,200 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2015 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    agent
+*/
+
+#include "Core/precomp.h"
+#include "big_int_montgomery.h"
+#include "big_int_impl.h"
+#include <algorithm>
+
+namespace clan
+{
+
+BigInt_Montgomery::BigInt_Montgomery(const BigInt_Impl &modulus)
+{
+	num_limbs = BigInt_Limbs::limbs_for_digits(modulus.digits_used);
+	modulus_limbs.resize(num_limbs);
+	BigInt_Limbs::from_digits(&modulus_limbs[0], num_limbs, modulus.digits, modulus.digits_used);
+
+	// Newton iteration for m^-1 mod 2^limb_bits. The first guess is correct to 3 bits (m * m = 1 mod 8 for an odd m)
+	// and every step doubles the number of correct bits
+	Limb m0 = modulus_limbs[0];
+	Limb inverse = m0;
+	for (int i = 0; i < 5; i++)
+		inverse *= 2 - m0 * inverse;
+	m_inverse = 0 - inverse;
+
+	BigInt_Impl r2;
+	r2.set((ubyte32) 1);
+	r2.internal_lshd(2 * num_limbs * BigInt_Limbs::digits_per_limb);
+	r2.mod(&modulus, &r2);
+	r_squared.resize(num_limbs);
+	BigInt_Limbs::from_digits(&r_squared[0], num_limbs, r2.digits, r2.digits_used);
+
+	product.resize(2 * num_limbs + 1);
+	scratch.resize(BigInt_Limbs::scratch_size(num_limbs));
+}
+
+void BigInt_Montgomery::exptmod(const BigInt_Impl &base, const BigInt_Impl &exponent, BigInt_Impl *result)
+{
+	const int n = num_limbs;
+	int exponent_bits = exponent.significant_bits();
+
+	std::vector<Limb> x(n), acc(n), square(n);
+	BigInt_Limbs::from_digits(&x[0], n, base.digits, base.digits_used);
+	mul(&x[0], &x[0], &r_squared[0]);
+
+	// table[i] = x^(2*i + 1), the odd powers a window can end with
+	int window = window_size(exponent_bits);
+	int table_size = 1 << (window - 1);
+	std::vector<Limb> table(table_size * n);
+	memcpy(&table[0], &x[0], n * sizeof(Limb));
+	if (table_size > 1)
+	{
+		sqr(&square[0], &x[0]);
+		for (int i = 1; i < table_size; i++)
+			mul(&table[i * n], &table[(i - 1) * n], &square[0]);
+	}
+
+	// acc = 1 in Montgomery form, for the zero exponent
+	memcpy(&product[0], &r_squared[0], n * sizeof(Limb));
+	memset(&product[n], 0, n * sizeof(Limb));
+	reduce(&acc[0]);
+
+	bool started = false;
+	int bit = exponent_bits - 1;
+	while (bit >= 0)
+	{
+		if (!exponent_bit(exponent, bit))
+		{
+			if (started)
+				sqr(&acc[0], &acc[0]);
+			bit--;
+			continue;
+		}
+
+		// Take the longest window starting at this bit that ends with a one bit
+		int low_bit = std::max(bit - window + 1, 0);
+		while (!exponent_bit(exponent, low_bit))
+			low_bit++;
+
+		int value = 0;
+		for (int i = bit; i >= low_bit; i--)
+			value = (value << 1) | exponent_bit(exponent, i);
+
+		if (started)
+		{
+			for (int i = bit; i >= low_bit; i--)
+				sqr(&acc[0], &acc[0]);
+			mul(&acc[0], &acc[0], &table[(value >> 1) * n]);
+		}
+		else
+		{
+			memcpy(&acc[0], &table[(value >> 1) * n], n * sizeof(Limb));
+			started = true;
+		}
+		bit = low_bit - 1;
+	}
+
+	// Convert back from Montgomery form
+	memcpy(&product[0], &acc[0], n * sizeof(Limb));
+	memset(&product[n], 0, n * sizeof(Limb));
+	reduce(&acc[0]);
+
+	int num_digits = n * BigInt_Limbs::digits_per_limb;
+	result->zero();
+	result->internal_pad(num_digits);
+	BigInt_Limbs::to_digits(result->digits, num_digits, &acc[0], n);
+	result->internal_clamp();
+}
+
+void BigInt_Montgomery::mul(Limb *result, const Limb *a, const Limb *b)
+{
+	BigInt_Limbs::mul(&product[0], a, num_limbs, b, num_limbs, &scratch[0]);
+	reduce(result);
+}
+
+void BigInt_Montgomery::sqr(Limb *result, const Limb *a)
+{
+	BigInt_Limbs::sqr(&product[0], a, num_limbs, &scratch[0]);
+	reduce(result);
+}
+
+void BigInt_Montgomery::reduce(Limb *result)
+{
+	// Montgomery reduction of the 2n limb product: add multiples of m that clear the low limbs, then divide by R.
+	// The result is below 2m and needs at most one final subtraction
+	const int n = num_limbs;
+	const Limb *m = &modulus_limbs[0];
+	Limb *t = &product[0];
+	t[2 * n] = 0;
+
+	for (int i = 0; i < n; i++)
+	{
+		Limb u = t[i] * m_inverse;
+		Limb carry = 0;
+		Limb *row = t + i;
+		for (int j = 0; j < n; j++)
+		{
+			WideLimb w = (WideLimb) u * m[j] + row[j] + carry;
+			row[j] = (Limb) w;
+			carry = (Limb) (w >> BigInt_Limbs::limb_bits);
+		}
+		for (int k = i + n; carry; k++)
+		{
+			t[k] += carry;
+			carry = (t[k] < carry);
+		}
+	}
+
+	Limb *upper = t + n;
+	if (upper[n] || BigInt_Limbs::cmp(upper, m, n) >= 0)
+		BigInt_Limbs::sub(result, upper, m, n);
+	else
+		memcpy(result, upper, n * sizeof(Limb));
+}
+
+int BigInt_Montgomery::window_size(int exponent_bits)
+{
+	// Larger windows save multiplications, but the table of odd powers must be built first
+	if (exponent_bits > 671)
+		return 6;
+	if (exponent_bits > 239)
+		return 5;
+	if (exponent_bits > 79)
+		return 4;
+	if (exponent_bits > 23)
+		return 3;
+	return 1;
+}
+
+int BigInt_Montgomery::exponent_bit(const BigInt_Impl &exponent, int bit)
+{
+	return (exponent.digits[bit / 32] >> (bit % 32)) & 1;
+}
+
+}
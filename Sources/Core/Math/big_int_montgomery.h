@@ -0,0 +1,72 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2015 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    agent
+*/
+
+#pragma once
+
+#include "big_int_limbs.h"
+#include <vector>
+
+namespace clan
+{
+
+class BigInt_Impl;
+
+/// \brief Modular exponentiation with an odd modulus, using Montgomery multiplication
+///
+/// Numbers are kept in Montgomery form (x * R mod m, where R = 2^(limb_bits * num_limbs)) for the
+/// whole exponentiation, so every step reduces with multiplications instead of a division.
+class BigInt_Montgomery
+{
+public:
+	typedef BigInt_Limbs::Limb Limb;
+	typedef BigInt_Limbs::WideLimb WideLimb;
+
+	/// \brief Prepares the reduction constants for the modulus, which must be odd
+	BigInt_Montgomery(const BigInt_Impl &modulus);
+
+	/// \brief result = base ^ exponent (mod modulus)
+	///
+	/// Uses a sliding window over the exponent bits. base must be in the range 0 <= base < modulus.
+	void exptmod(const BigInt_Impl &base, const BigInt_Impl &exponent, BigInt_Impl *result);
+
+private:
+	void mul(Limb *result, const Limb *a, const Limb *b);
+	void sqr(Limb *result, const Limb *a);
+	void reduce(Limb *result);
+	static int window_size(int exponent_bits);
+	static int exponent_bit(const BigInt_Impl &exponent, int bit);
+
+	int num_limbs;
+	Limb m_inverse;		// -m^-1 mod 2^limb_bits
+	std::vector<Limb> modulus_limbs;
+	std::vector<Limb> r_squared;	// R^2 mod m, to convert into Montgomery form
+	std::vector<Limb> product;
+	std::vector<Limb> scratch;
+};
+
+}
@@ -56,6 +56,7 @@ void DelauneyTriangulator_Impl::triangulate()
 
 	std::vector<DelauneyTriangulator_Vertex *> vertices;
 	create_ordered_vertex_list(vertices);
+	sort_along_hilbert_curve(vertices);
 
 	// Calculate super triangle:
 
@@ -86,6 +87,7 @@ void DelauneyTriangulator_Impl::create_ordered_vertex_list(std::vector<DelauneyT
 {
 	std::vector<DelauneyTriangulator_Vertex>::size_type index_vertices, num_vertices;
 	num_vertices = input_vertices.size();
+	vertices.reserve(num_vertices);
 	for (index_vertices = 0; index_vertices < num_vertices; index_vertices++)
 	{
 		vertices.push_back(&input_vertices[index_vertices]);
@@ -95,24 +97,71 @@ void DelauneyTriangulator_Impl::create_ordered_vertex_list(std::vector<DelauneyT
 	std::sort(vertices.begin(), vertices.end(), CompareVertices());
 
 	// Remove duplicates:
-	auto it = vertices.begin();
-	if (it == vertices.end()) return;
-	float last_x = (*it)->x;
-	float last_y = (*it)->y;
-	++it;
-	while (it != vertices.end())
+	auto last = std::unique(vertices.begin(), vertices.end(), [](DelauneyTriangulator_Vertex *a, DelauneyTriangulator_Vertex *b)
 	{
-		if (last_x == (*it)->x && last_y == (*it)->y)
-		{
-			it = vertices.erase(it);
-		}
-		else
+		return a->x == b->x && a->y == b->y;
+	});
+	vertices.erase(last, vertices.end());
+}
+
+static unsigned int hilbert_curve_index(unsigned int x, unsigned int y)
+{
+	// Distance along a 65536x65536 hilbert curve. See http://en.wikipedia.org/wiki/Hilbert_curve
+	unsigned int d = 0;
+	for (unsigned int s = 1 << 15; s > 0; s >>= 1)
+	{
+		unsigned int rx = (x & s) ? 1 : 0;
+		unsigned int ry = (y & s) ? 1 : 0;
+		d += s * s * ((3 * rx) ^ ry);
+		if (ry == 0)
 		{
-			last_x = (*it)->x;
-			last_y = (*it)->y;
-			++it;
+			if (rx == 1)
+			{
+				x = 0xffff - x;
+				y = 0xffff - y;
+			}
+			std::swap(x, y);
 		}
 	}
+	return d;
+}
+
+void DelauneyTriangulator_Impl::sort_along_hilbert_curve(std::vector<DelauneyTriangulator_Vertex *> &vertices)
+{
+	// Inserting the points in the order they appear along a space filling curve keeps each new point
+	// close to the previous one. That keeps the walk in find_triangle short.
+
+	if (vertices.size() < 3)
+		return;
+
+	float min_x = vertices.front()->x;
+	float max_x = vertices.back()->x;
+	float min_y = vertices.front()->y;
+	float max_y = vertices.front()->y;
+	for (auto vertex : vertices)
+	{
+		min_y = std::min(min_y, vertex->y);
+		max_y = std::max(max_y, vertex->y);
+	}
+
+	float scale = 65535.0f / std::max(std::max(max_x - min_x, max_y - min_y), 1e-30f);
+
+	std::vector<std::pair<unsigned int, DelauneyTriangulator_Vertex *> > keys;
+	keys.reserve(vertices.size());
+	for (auto vertex : vertices)
+	{
+		unsigned int x = (unsigned int) std::min((vertex->x - min_x) * scale, 65535.0f);
+		unsigned int y = (unsigned int) std::min((vertex->y - min_y) * scale, 65535.0f);
+		keys.push_back(std::make_pair(hilbert_curve_index(x, y), vertex));
+	}
+
+	std::stable_sort(keys.begin(), keys.end(), [](const std::pair<unsigned int, DelauneyTriangulator_Vertex *> &a, const std::pair<unsigned int, DelauneyTriangulator_Vertex *> &b)
+	{
+		return a.first < b.first;
+	});
+
+	for (size_t i = 0; i < keys.size(); i++)
+		vertices[i] = keys[i].second;
 }
 
 void DelauneyTriangulator_Impl::calculate_supertriangle(std::vector<DelauneyTriangulator_Vertex *> &vertices, DelauneyTriangulator_Triangle &super_triangle)
@@ -148,18 +197,22 @@ void DelauneyTriangulator_Impl::calculate_supertriangle(std::vector<DelauneyTria
 		}
 	}
 
-	// Setup super triangle based on min/max values:
+	// Setup super triangle based on min/max values.
+	// Triangles touching the super triangle are removed at the end. The further away its vertices are,
+	// the fewer triangles along the convex hull of the points get lost that way.
 
-	super_triangle.vertex_A->x = min_x-1;
-	super_triangle.vertex_A->y = min_y-1;
+	float size = std::max(std::max(max_x - min_x, max_y - min_y), 1.0f) * 100.0f;
+
+	super_triangle.vertex_A->x = min_x - size;
+	super_triangle.vertex_A->y = min_y - size;
 	super_triangle.vertex_A->data = nullptr;
 
-	super_triangle.vertex_B->x = max_x+(max_x-min_x)+1;
-	super_triangle.vertex_B->y = min_y-1;
+	super_triangle.vertex_B->x = max_x + size * 2.0f;
+	super_triangle.vertex_B->y = min_y - size;
 	super_triangle.vertex_B->data = nullptr;
 
-	super_triangle.vertex_C->x = min_x-1;
-	super_triangle.vertex_C->y = max_y+(max_y-min_y)+1;
+	super_triangle.vertex_C->x = min_x - size;
+	super_triangle.vertex_C->y = max_y + size * 2.0f;
 	super_triangle.vertex_C->data = nullptr;
 }
 
@@ -169,185 +222,242 @@ void DelauneyTriangulator_Impl::perform_delauney_triangulation(
 	std::vector<DelauneyTriangulator_Triangle> &triangles)
 {
 /*
-	delauney triangulation algorithm:
+	delauney triangulation algorithm (Bowyer-Watson):
 
 	subroutine triangulate
 	input : vertex list
 	output : triangle list
-		initialize the triangle list
-		determine the supertriangle
-		add supertriangle vertices to the end of the vertex list
-		add the supertriangle to the triangle list
+		initialize the triangle mesh with the supertriangle
 		for each sample point in the vertex list
-			initialize the edge buffer
-			for each triangle currently in the triangle list
-				calculate the triangle circumcircle center and radius
-				if the point lies in the triangle circumcircle then
-					add the three triangle edges to the edge buffer
-					remove the triangle from the triangle list
-				endif
-			endfor
-			delete all doubly specified edges from the edge buffer
-				this leaves the edges of the enclosing polygon only
-			add to the triangle list all triangles formed between the point 
-				and the edges of the enclosing polygon
+			walk the mesh from the last added triangle to the triangle containing the point
+			starting at that triangle, flood fill across edges to all triangles whose
+				circumcircle contains the point. Together they form a star shaped cavity
+			remove the cavity triangles, keeping the edges on the border of the cavity
+			add triangles formed between the point and each border edge, linking
+				them to their neighbours
 		endfor
-		remove any triangles from the triangle list that use the supertriangle vertices
-		remove the supertriangle vertices from the vertex list
+		remove any triangles from the mesh that use the supertriangle vertices
 	end
 
+	Each triangle in the mesh knows its three neighbours, so finding the cavity only visits
+	the triangles that change. With the points inserted along a hilbert curve the walk is
+	short too, giving O(n log n) for the sort and close to O(n) for the insertions.
+
 	See http://astronomy.swin.edu.au/~pbourke/terrain/triangulate/ for more info
 */
 
 	// Reset triangle list.
 	triangles.clear();
 
-	// add supertriangle vertices to the end of the vertex list
-	triangles.push_back(super_triangle);
+	mesh_vertices.clear();
+	mesh_vertices.reserve(vertices.size() + 3);
+	mesh_vertices.push_back(super_triangle.vertex_A);
+	mesh_vertices.push_back(super_triangle.vertex_B);
+	mesh_vertices.push_back(super_triangle.vertex_C);
+	mesh_vertices.insert(mesh_vertices.end(), vertices.begin(), vertices.end());
+
+	// Add the supertriangle to the mesh:
+	DelauneyTriangulator_MeshTriangle super_mesh_triangle;
+	super_mesh_triangle.vertices[0] = 0;
+	super_mesh_triangle.vertices[1] = 1;
+	super_mesh_triangle.vertices[2] = 2;
+	super_mesh_triangle.neighbours[0] = -1;
+	super_mesh_triangle.neighbours[1] = -1;
+	super_mesh_triangle.neighbours[2] = -1;
+
+	mesh_triangles.clear();
+	mesh_triangles.reserve(vertices.size() * 2 + 1);
+	mesh_triangles.push_back(super_mesh_triangle);
+
+	triangle_stamps.assign(1, -1);
+	triangle_stamps.reserve(vertices.size() * 2 + 1);
+	vertex_triangles.resize(mesh_vertices.size());
 
 	// for each sample point in the vertex list:
-	std::vector<DelauneyTriangulator_Vertex *>::size_type index_vertices, num_vertices;
-	num_vertices = vertices.size();
-	for (index_vertices = 0; index_vertices < num_vertices; index_vertices++)
+	int last_triangle = 0;
+	int num_vertices = (int) mesh_vertices.size();
+	for (int index_vertices = 3; index_vertices < num_vertices; index_vertices++)
 	{
-		DelauneyTriangulator_Vertex *insertion_point = vertices[index_vertices];
+		last_triangle = insert_point(index_vertices, last_triangle);
+	}
 
-		// Init edge buffer
-		typedef std::pair<DelauneyTriangulator_Vertex *, DelauneyTriangulator_Vertex *> DelauneyTriangulator_Triangle_Edge;
-		std::vector<DelauneyTriangulator_Triangle_Edge> edges;
+	// remove any triangles from the triangle list that use the supertriangle vertices
+	triangles.reserve(mesh_triangles.size());
+	for (const auto &cur_triangle : mesh_triangles)
+	{
+		if (cur_triangle.vertices[0] < 3 || cur_triangle.vertices[1] < 3 || cur_triangle.vertices[2] < 3)
+			continue;
+
+		DelauneyTriangulator_Triangle triangle;
+		triangle.vertex_A = mesh_vertices[cur_triangle.vertices[0]];
+		triangle.vertex_B = mesh_vertices[cur_triangle.vertices[1]];
+		triangle.vertex_C = mesh_vertices[cur_triangle.vertices[2]];
+		triangles.push_back(triangle);
+	}
+
+	mesh_vertices.clear();
+	mesh_triangles.clear();
+}
+
+int DelauneyTriangulator_Impl::insert_point(int point, int start_triangle)
+{
+	int first_triangle = find_triangle(point, start_triangle);
 
-		// For each triangle currently in the triangle list
-		std::vector<DelauneyTriangulator_Triangle>::size_type index_triangles, num_triangles;
-		num_triangles = triangles.size();
-		for (index_triangles = 0; index_triangles < num_triangles; index_triangles++)
+	// Flood fill to all triangles whose circumcircle contain the point.
+	// The stamp marks the triangles already in the cavity.
+
+	cavity.clear();
+	cavity_edges.clear();
+	cavity.push_back(first_triangle);
+	triangle_stamps[first_triangle] = point;
+
+	for (size_t index_cavity = 0; index_cavity < cavity.size(); index_cavity++)
+	{
+		int cur_triangle = cavity[index_cavity];
+		for (int edge = 0; edge < 3; edge++)
 		{
-			DelauneyTriangulator_Triangle &cur_triangle = triangles[index_triangles];
-
-			// todo: cache circumcenter in triangle?
-			DelauneyTriangulator_Vertex circumcenter = find_circumcenter(cur_triangle);
-			float radius_x = cur_triangle.vertex_A->x-circumcenter.x;
-			float radius_y = cur_triangle.vertex_A->y-circumcenter.y;
-			float radius2 = radius_x*radius_x + radius_y*radius_y;
-
-			// Check if the point lies in the triangle circumcircle:
-			float dist_x = insertion_point->x - circumcenter.x;
-			float dist_y = insertion_point->y - circumcenter.y;
-			float dist2 = dist_x*dist_x + dist_y*dist_y;
-			if (dist2 < radius2)
+			int neighbour = mesh_triangles[cur_triangle].neighbours[edge];
+			if (neighbour != -1)
 			{
-				// Add triangle edges to edge buffer:
-				edges.push_back(DelauneyTriangulator_Triangle_Edge(cur_triangle.vertex_A, cur_triangle.vertex_B));
-				edges.push_back(DelauneyTriangulator_Triangle_Edge(cur_triangle.vertex_B, cur_triangle.vertex_C));
-				edges.push_back(DelauneyTriangulator_Triangle_Edge(cur_triangle.vertex_C, cur_triangle.vertex_A));
-
-				// Remove triange from triangle list:
-				triangles.erase(triangles.begin()+index_triangles);
-				index_triangles--;
-				num_triangles--;
+				if (triangle_stamps[neighbour] == point)
+					continue;
+
+				if (in_circumcircle(neighbour, point))
+				{
+					triangle_stamps[neighbour] = point;
+					cavity.push_back(neighbour);
+					continue;
+				}
 			}
-		}
 
-		// Delete all doubly specified edges from the edge buffer
-		// this leaves the edges of the enclosing polygon only
-		int index_edges1, index_edges2, num_edges; // intentionally integer to allow index to be negative when deleting index.
-		num_edges = (int) edges.size();
-		for (index_edges1 = 0; index_edges1 < num_edges; index_edges1++)
-		{
-			DelauneyTriangulator_Triangle_Edge &edge1 = edges[index_edges1];
-			for (index_edges2 = 0/*index_edges1+1*/; index_edges2 < num_edges; index_edges2++)
+			DelauneyTriangulator_CavityEdge cavity_edge;
+			cavity_edge.vertex_A = mesh_triangles[cur_triangle].vertices[(edge + 1) % 3];
+			cavity_edge.vertex_B = mesh_triangles[cur_triangle].vertices[(edge + 2) % 3];
+			cavity_edge.outside_triangle = neighbour;
+			cavity_edge.outside_edge = -1;
+			if (neighbour != -1)
 			{
-				if (index_edges1 == index_edges2) continue;
-				DelauneyTriangulator_Triangle_Edge &edge2 = edges[index_edges2];
-				if ((edge1.first == edge2.first && edge1.second == edge2.second) ||
-					(edge1.second == edge2.first && edge1.first == edge2.second))
+				for (int outside_edge = 0; outside_edge < 3; outside_edge++)
 				{
-					// Same edges, delete both:
-					if (index_edges1 < index_edges2)
-					{
-						edges.erase(edges.begin()+index_edges2);
-						edges.erase(edges.begin()+index_edges1);
-					}
-					else
-					{
-						edges.erase(edges.begin()+index_edges1);
-						edges.erase(edges.begin()+index_edges2);
-					}
-					num_edges -= 2;
-					index_edges1--;
-					break;
+					if (mesh_triangles[neighbour].neighbours[outside_edge] == cur_triangle)
+						cavity_edge.outside_edge = outside_edge;
 				}
 			}
+			cavity_edges.push_back(cavity_edge);
 		}
+	}
 
-		// add to the triangle list all triangles formed between the point 
-		// and the edges of the enclosing polygon
-		for (index_edges1 = 0; index_edges1 < num_edges; index_edges1++)
+	// Replace the cavity with triangles between the point and each border edge.
+	// There are always two more border edges than cavity triangles.
+
+	int new_triangle = -1;
+	for (size_t index_edges = 0; index_edges < cavity_edges.size(); index_edges++)
+	{
+		const DelauneyTriangulator_CavityEdge &cavity_edge = cavity_edges[index_edges];
+
+		if (index_edges < cavity.size())
 		{
-			DelauneyTriangulator_Triangle triangle;
-			triangle.vertex_A = edges[index_edges1].first;
-			triangle.vertex_B = edges[index_edges1].second;
-			triangle.vertex_C = insertion_point;
-			triangles.push_back(triangle);
+			new_triangle = cavity[index_edges];
 		}
+		else
+		{
+			new_triangle = (int) mesh_triangles.size();
+			mesh_triangles.push_back(DelauneyTriangulator_MeshTriangle());
+			triangle_stamps.push_back(-1);
+		}
+
+		DelauneyTriangulator_MeshTriangle &triangle = mesh_triangles[new_triangle];
+		triangle.vertices[0] = cavity_edge.vertex_A;
+		triangle.vertices[1] = cavity_edge.vertex_B;
+		triangle.vertices[2] = point;
+		triangle.neighbours[2] = cavity_edge.outside_triangle;
+		if (cavity_edge.outside_triangle != -1)
+			mesh_triangles[cavity_edge.outside_triangle].neighbours[cavity_edge.outside_edge] = new_triangle;
+
+		vertex_triangles[cavity_edge.vertex_A] = new_triangle;
 	}
 
-	// remove any triangles from the triangle list that use the supertriangle vertices
-	std::vector<DelauneyTriangulator_Triangle>::size_type index_triangles, num_triangles;
-	num_triangles = triangles.size();
-	for (index_triangles = 0; index_triangles < num_triangles; index_triangles++)
+	// Link the new triangles to each other. The edge from vertex B to the point is shared with the
+	// new triangle starting at vertex B:
+
+	for (size_t index_edges = 0; index_edges < cavity_edges.size(); index_edges++)
 	{
-		DelauneyTriangulator_Triangle &cur_triangle = triangles[index_triangles];
-
-		if (
-			cur_triangle.vertex_A == super_triangle.vertex_A ||
-			cur_triangle.vertex_A == super_triangle.vertex_B ||
-			cur_triangle.vertex_A == super_triangle.vertex_C ||
-			cur_triangle.vertex_B == super_triangle.vertex_A ||
-			cur_triangle.vertex_B == super_triangle.vertex_B ||
-			cur_triangle.vertex_B == super_triangle.vertex_C ||
-			cur_triangle.vertex_C == super_triangle.vertex_A ||
-			cur_triangle.vertex_C == super_triangle.vertex_B ||
-			cur_triangle.vertex_C == super_triangle.vertex_C)
+		int cur_triangle = vertex_triangles[cavity_edges[index_edges].vertex_A];
+		int next_triangle = vertex_triangles[cavity_edges[index_edges].vertex_B];
+		mesh_triangles[cur_triangle].neighbours[0] = next_triangle;
+		mesh_triangles[next_triangle].neighbours[1] = cur_triangle;
+	}
+
+	return new_triangle;
+}
+
+int DelauneyTriangulator_Impl::find_triangle(int point, int start_triangle) const
+{
+	// Walk towards the point, crossing any edge that has the point on its outer side.
+	// Which edge is tested first rotates, so rounding errors cannot make the walk go in circles.
+
+	int cur_triangle = start_triangle;
+	int first_edge = 0;
+	while (true)
+	{
+		const DelauneyTriangulator_MeshTriangle &triangle = mesh_triangles[cur_triangle];
+
+		int next_triangle = -1;
+		for (int i = 0; i < 3; i++)
 		{
-			// triangle share one or more points with supertriangle, remove it:
-			triangles.erase(triangles.begin()+index_triangles);
-			index_triangles--;
-			num_triangles--;
+			int edge = (first_edge + i) % 3;
+			if (triangle.neighbours[edge] != -1 && orientation(triangle.vertices[(edge + 1) % 3], triangle.vertices[(edge + 2) % 3], point) < 0.0)
+			{
+				next_triangle = triangle.neighbours[edge];
+				break;
+			}
 		}
+
+		if (next_triangle == -1)
+			return cur_triangle;
+
+		cur_triangle = next_triangle;
+		first_edge = (first_edge + 1) % 3;
 	}
 }
 
-DelauneyTriangulator_Vertex DelauneyTriangulator_Impl::find_circumcenter(
-	const DelauneyTriangulator_Triangle &triangle)
+double DelauneyTriangulator_Impl::orientation(int a, int b, int c) const
+{
+	// Positive if the points are in counter-clockwise order, negative if clockwise and zero if on a line.
+
+	const DelauneyTriangulator_Vertex *vA = mesh_vertices[a];
+	const DelauneyTriangulator_Vertex *vB = mesh_vertices[b];
+	const DelauneyTriangulator_Vertex *vC = mesh_vertices[c];
+	return ((double) vB->x - vA->x) * ((double) vC->y - vA->y) - ((double) vB->y - vA->y) * ((double) vC->x - vA->x);
+}
+
+bool DelauneyTriangulator_Impl::in_circumcircle(int triangle, int point) const
 {
-	// Subject 1.04: How do I generate a circle through three points?
-	// http://www.faqs.org/faqs/graphics/algorithms-faq/
-
-	float a_0 = triangle.vertex_A->x;
-	float a_1 = triangle.vertex_A->y;
-	float b_0 = triangle.vertex_B->x;
-	float b_1 = triangle.vertex_B->y;
-	float c_0 = triangle.vertex_C->x;
-	float c_1 = triangle.vertex_C->y;
-
-	float A = b_0 - a_0;
-	float B = b_1 - a_1;
-	float C = c_0 - a_0;
-	float D = c_1 - a_1;
-
-	float E = A*(a_0 + b_0) + B*(a_1 + b_1);
-	float F = C*(a_0 + c_0) + D*(a_1 + c_1);
-
-	float G = 2.0f*(A*(c_1 - b_1)-B*(c_0 - b_0));
-
-	float p_0 = (D*E - B*F) / G;
-	float p_1 = (A*F - C*E) / G;
-
-	DelauneyTriangulator_Vertex circumcenter;
-	circumcenter.data = nullptr;
-	circumcenter.x = p_0;
-	circumcenter.y = p_1;
-	return circumcenter;
+	// Sign of the determinant
+	//   | ax-px  ay-py  (ax-px)^2+(ay-py)^2 |
+	//   | bx-px  by-py  (bx-px)^2+(by-py)^2 |
+	//   | cx-px  cy-py  (cx-px)^2+(cy-py)^2 |
+	// which is positive when the point is inside the circumcircle of a counter-clockwise triangle.
+
+	const DelauneyTriangulator_MeshTriangle &t = mesh_triangles[triangle];
+	const DelauneyTriangulator_Vertex *vA = mesh_vertices[t.vertices[0]];
+	const DelauneyTriangulator_Vertex *vB = mesh_vertices[t.vertices[1]];
+	const DelauneyTriangulator_Vertex *vC = mesh_vertices[t.vertices[2]];
+	const DelauneyTriangulator_Vertex *vP = mesh_vertices[point];
+
+	double ax = (double) vA->x - vP->x;
+	double ay = (double) vA->y - vP->y;
+	double bx = (double) vB->x - vP->x;
+	double by = (double) vB->y - vP->y;
+	double cx = (double) vC->x - vP->x;
+	double cy = (double) vC->y - vP->y;
+
+	double a2 = ax * ax + ay * ay;
+	double b2 = bx * bx + by * by;
+	double c2 = cx * cx + cy * cy;
+
+	double det = ax * (by * c2 - b2 * cy) - ay * (bx * c2 - b2 * cx) + a2 * (bx * cy - by * cx);
+	return det > 0.0;
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -34,6 +34,25 @@
 namespace clan
 {
 
+/// \brief Triangle in the mesh built while triangulating.
+///
+/// Vertices are indices into the mesh vertex list, in counter-clockwise order.
+/// neighbours[i] is the triangle on the other side of the edge opposite vertices[i], or -1 for an outer edge.
+struct DelauneyTriangulator_MeshTriangle
+{
+	int vertices[3];
+	int neighbours[3];
+};
+
+/// \brief Edge on the border of the triangles removed when inserting a point.
+struct DelauneyTriangulator_CavityEdge
+{
+	int vertex_A;
+	int vertex_B;
+	int outside_triangle;
+	int outside_edge;
+};
+
 class DelauneyTriangulator_Impl
 {
 /// \name Construction
@@ -65,6 +84,9 @@ public:
 	void create_ordered_vertex_list(
 		std::vector<DelauneyTriangulator_Vertex *> &vertices);
 
+	void sort_along_hilbert_curve(
+		std::vector<DelauneyTriangulator_Vertex *> &vertices);
+
 	void calculate_supertriangle(
 		std::vector<DelauneyTriangulator_Vertex *> &vertices,
 		DelauneyTriangulator_Triangle &super_triangle);
@@ -74,8 +96,26 @@ public:
 		const DelauneyTriangulator_Triangle &super_triangle,
 		std::vector<DelauneyTriangulator_Triangle> &triangles);
 
-	DelauneyTriangulator_Vertex find_circumcenter(
-		const DelauneyTriangulator_Triangle &triangle);
+/// \}
+/// \name Implementation
+/// \{
+
+private:
+	int insert_point(int point, int start_triangle);
+
+	int find_triangle(int point, int start_triangle) const;
+
+	double orientation(int a, int b, int c) const;
+
+	bool in_circumcircle(int triangle, int point) const;
+
+	std::vector<DelauneyTriangulator_Vertex *> mesh_vertices;
+	std::vector<DelauneyTriangulator_MeshTriangle> mesh_triangles;
+
+	std::vector<int> triangle_stamps;
+	std::vector<int> vertex_triangles;
+	std::vector<int> cavity;
+	std::vector<DelauneyTriangulator_CavityEdge> cavity_edges;
 /// \}
 };
 
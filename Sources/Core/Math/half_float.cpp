@@ -2187,37 +2187,37 @@ unsigned short HalfFloat::offset_table[64] =
 	1024,
 	1024,
 	0,
-	0,
-	0,
-	0,
-	0,
-	0,
-	0,
-	0,
-	0,
-	0,
-	0,
-	0,
-	0,
-	0,
-	0,
-	0,
-	0,
-	0,
-	0,
-	0,
-	0,
-	0,
-	0,
-	0,
-	0,
-	0,
-	0,
-	0,
-	0,
-	0,
-	0,
-	0,
+	1024,
+	1024,
+	1024,
+	1024,
+	1024,
+	1024,
+	1024,
+	1024,
+	1024,
+	1024,
+	1024,
+	1024,
+	1024,
+	1024,
+	1024,
+	1024,
+	1024,
+	1024,
+	1024,
+	1024,
+	1024,
+	1024,
+	1024,
+	1024,
+	1024,
+	1024,
+	1024,
+	1024,
+	1024,
+	1024,
+	1024,
 };
 
 unsigned short HalfFloat::base_table[512] =
@@ -3296,6 +3296,8 @@ void generate_tables()
 	offset_table[32] = 0;
 	for (int i = 1; i < 32; i++)
 		offset_table[i] = 1024;
+	for (int i = 33; i < 64; i++)
+		offset_table[i] = 1024;
 
 	for(unsigned int i=0; i<256; ++i)
 	{
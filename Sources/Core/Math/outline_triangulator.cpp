@@ -48,6 +48,16 @@ OutlineTriangulator::~OutlineTriangulator()
 /////////////////////////////////////////////////////////////////////////////
 // OutlineTriangulator attributes:
 
+const std::vector<DelauneyTriangulator_Vertex> &OutlineTriangulator::get_vertices() const
+{
+	return impl->vertices;
+}
+
+const std::vector<DelauneyTriangulator_Triangle> &OutlineTriangulator::get_triangles() const
+{
+	return impl->triangles;
+}
+
 /////////////////////////////////////////////////////////////////////////////
 // OutlineTriangulator operations:
 
@@ -28,9 +28,8 @@
 
 #include "Core/precomp.h"
 #include "outline_triangulator_generic.h"
-#include "API/Core/Math/delauney_triangulator.h"
-#include "API/Core/Math/line_math.h"
-#include <list>
+#include "API/Core/System/exception.h"
+#include "API/Core/System/cl_platform.h"
 #include <algorithm>
 
 namespace clan
@@ -55,491 +54,619 @@ OutlineTriangulator_Impl::~OutlineTriangulator_Impl()
 
 void OutlineTriangulator_Impl::triangulate()
 {
-	// Order vertices:
-	std::vector<OutlineTriangulator_Vertex *> vertices;
-	create_ordered_vertex_list(vertices);
+/*
+	constrained delauney triangulation (Sloan):
+
+	merge the vertices at the same position
+	delauney triangulate the vertices together with a frame around them
+	for each edge in the outlines
+		if the edge is not in the mesh
+			walk from the first to the last vertex of the edge, collecting the mesh edges it crosses
+			flip crossed edges, whose two triangles form a convex quad, until none cross it
+			flip the new edges again until they are delauney
+		mark the edge as constrained
+	endfor
+	flood fill from the frame, counting the constrained edges crossed to reach each triangle
+	keep the triangles reached by crossing an odd number of them
+
+	The delauney triangulation takes O(n log n). Most outline edges are already in it,
+	and the rest only flip the triangles near them.
+	See S. W. Sloan, "A fast algorithm for generating constrained Delaunay triangulations", 1993.
+*/
 
-	// 1.  Create initial triangulation:
-	DelauneyTriangulator delauney;
-	std::vector<OutlineTriangulator_Vertex *>::size_type index_vertices, num_vertices;
-	num_vertices = vertices.size();
-	for (index_vertices = 0; index_vertices < num_vertices; index_vertices++)
-	{
-		vertices[index_vertices]->num_triangles = 0;
-		vertices[index_vertices]->extra = 0;
-		vertices[index_vertices]->triangles = nullptr;
-
-		delauney.add_vertex(
-			vertices[index_vertices]->x,
-			vertices[index_vertices]->y,
-			vertices[index_vertices]);
-	}
-	delauney.generate();
+	vertices.clear();
+	triangles.clear();
+	mesh_triangles.clear();
+	vertex_triangles.clear();
 
-	// 2.  Link triangles to vertices:
+	// 1. Merge vertices:
+	std::vector<OutlineTriangulator_Vertex *> ordered_vertices;
+	create_ordered_vertex_list(ordered_vertices);
+	if (vertices.size() < 3)
+		return;
 
-	const std::vector<DelauneyTriangulator_Triangle> &triangles = delauney.get_triangles();
+	// 2. Create initial triangulation:
+	create_mesh();
 
-	std::vector<DelauneyTriangulator_Triangle>::size_type index_triangles, num_triangles;
-	num_triangles = triangles.size();
-	for (index_triangles = 0; index_triangles < num_triangles; index_triangles++)
+	// 3. Insert the edges of each contour:
+	for (auto &polygon : polygons)
 	{
-		OutlineTriangulator_Vertex *data_A = (OutlineTriangulator_Vertex *) triangles[index_triangles].vertex_A->data;
-		OutlineTriangulator_Vertex *data_B = (OutlineTriangulator_Vertex *) triangles[index_triangles].vertex_B->data;
-		OutlineTriangulator_Vertex *data_C = (OutlineTriangulator_Vertex *) triangles[index_triangles].vertex_C->data;
-		data_A->num_triangles++;
-		data_B->num_triangles++;
-		data_C->num_triangles++;
+		for (auto &contour : polygon.contours)
+		{
+			if (contour.vertices.size() < 3)
+				continue;
+
+			for (size_t index_vertices = 0; index_vertices < contour.vertices.size(); index_vertices++)
+			{
+				int vertex_A = contour.vertices[index_vertices].mesh_vertex;
+				int vertex_B = contour.vertices[(index_vertices + 1) % contour.vertices.size()].mesh_vertex;
+				if (vertex_A != vertex_B)
+					insert_edge(vertex_A, vertex_B);
+			}
+		}
 	}
 
-	auto links = new DelauneyTriangulator_Triangle const *[num_triangles];
-	int pos = 0;
-	for (index_vertices = 0; index_vertices < num_vertices; index_vertices++)
+	// 4. Remove outside and hole triangles, and generate the final list:
+	remove_outside_triangles();
+
+	mesh_triangles.clear();
+	vertex_triangles.clear();
+}
+
+struct CompareVertices
+{
+	bool operator()(OutlineTriangulator_Vertex *a, OutlineTriangulator_Vertex *b) const
 	{
-		vertices[index_vertices]->data = links+pos;
-		pos += vertices[index_vertices]->num_triangles;
-		vertices[index_vertices]->num_triangles = 0;
+		if (a->x == b->x) return a->y < b->y;
+		return a->x < b->x;
 	}
+};
 
-	for (index_triangles = 0; index_triangles < num_triangles; index_triangles++)
+void OutlineTriangulator_Impl::create_ordered_vertex_list(std::vector<OutlineTriangulator_Vertex *> &ordered_vertices)
+{
+	for (auto &polygon : polygons)
 	{
-		OutlineTriangulator_Vertex *data_A = (OutlineTriangulator_Vertex *) triangles[index_triangles].vertex_A->data;
-		OutlineTriangulator_Vertex *data_B = (OutlineTriangulator_Vertex *) triangles[index_triangles].vertex_B->data;
-		OutlineTriangulator_Vertex *data_C = (OutlineTriangulator_Vertex *) triangles[index_triangles].vertex_C->data;
-		data_A->triangles[data_A->num_triangles++] = &triangles[index_triangles];
-		data_B->triangles[data_B->num_triangles++] = &triangles[index_triangles];
-		data_C->triangles[data_C->num_triangles++] = &triangles[index_triangles];
+		for (auto &contour : polygon.contours)
+		{
+			for (auto &vertex : contour.vertices)
+				ordered_vertices.push_back(&vertex);
+		}
 	}
 
-	// 3.  Walk contours. Check if any triangles intersect with each line segment.
-	// 3a. Add each triangle's point that intersect to vertex buffer.
-	// 3b. Divide vertices into two lists, one for left and one for right side of line segment.
-	// 3c. Delauney triangulate each point list.
-	// 3d. Update links to include new triangles.
-	// 3e. Add the resulting triangles to triangles list.
-
-	std::list<DelauneyTriangulator_Triangle const *> final_triangles;
-	for (index_triangles = 0; index_triangles < num_triangles; index_triangles++)
-		final_triangles.push_back(&triangles[index_triangles]);
-
-	std::vector<DelauneyTriangulator_Triangle const **> added_links;
-	std::vector<DelauneyTriangulator> extra_triangulations;
+	// Sort list. The stable sort keeps the data of the first vertex added at a position
+	std::stable_sort(ordered_vertices.begin(), ordered_vertices.end(), CompareVertices());
 
-	std::vector<OutlineTriangulator_Polygon>::size_type index_polygons, num_polygons;
-	num_polygons = polygons.size();
-	for (index_polygons = 0; index_polygons < num_polygons; index_polygons++)
+	// Merge duplicates:
+	for (auto vertex : ordered_vertices)
 	{
-		OutlineTriangulator_Polygon &cur_poly = polygons[index_polygons];
-		std::vector<OutlineTriangulator_Contour>::size_type index_contours, num_contours;
-		num_contours = cur_poly.contours.size();
-		for (index_contours = 0; index_contours < num_contours; index_contours++)
+		if (vertices.empty() || vertices.back().x != vertex->x || vertices.back().y != vertex->y)
 		{
-			OutlineTriangulator_Contour &cur_contour = cur_poly.contours[index_contours];
-			std::vector<OutlineTriangulator_Vertex>::size_type index_vertices, num_vertices;
-			num_vertices = cur_contour.vertices.size();
-			for (index_vertices = 1; index_vertices < num_vertices; index_vertices++)
-			{
-				OutlineTriangulator_Vertex *vertex_1 = &cur_contour.vertices[index_vertices-1];
-				OutlineTriangulator_Vertex *vertex_2 = &cur_contour.vertices[index_vertices];
-				OutlineTriangulator_Collision collision = find_colliding_triangles(vertex_1, vertex_2);
-				if (collision.triangles.empty())
-					continue;
-
-				std::vector<OutlineTriangulator_Vertex *>::size_type index_points, num_points;
+			DelauneyTriangulator_Vertex mesh_vertex;
+			mesh_vertex.x = vertex->x;
+			mesh_vertex.y = vertex->y;
+			mesh_vertex.data = vertex->data;
+			vertices.push_back(mesh_vertex);
+		}
+		vertex->mesh_vertex = (int) vertices.size() - 1;
+	}
+}
 
-				// Triangulate left and right sides:
+/////////////////////////////////////////////////////////////////////////////
+// OutlineTriangulator_Impl implementation:
 
-				DelauneyTriangulator delauney_first;
-				num_points = collision.first.size();
-				for (index_points = 0; index_points < num_points; index_points++)
-				{
-					delauney.add_vertex(
-						collision.first[index_points]->x,
-						collision.first[index_points]->y,
-						collision.first[index_points]);
-				}
-				delauney_first.generate();
+void OutlineTriangulator_Impl::create_mesh()
+{
+	// The frame puts every outline vertex inside the convex hull, and its triangles are always outside the polygons.
+	// The delauney triangulator drops triangles along the convex hull that touch its super triangle, which only
+	// affects the triangles between the frame vertices that way.
+
+	float min_x = vertices.front().x;
+	float max_x = vertices.back().x;
+	float min_y = vertices.front().y;
+	float max_y = vertices.front().y;
+	for (const auto &vertex : vertices)
+	{
+		min_y = std::min(min_y, vertex.y);
+		max_y = std::max(max_y, vertex.y);
+	}
+	float size = std::max(std::max(max_x - min_x, max_y - min_y), 1.0f);
 
-				DelauneyTriangulator delauney_second;
-				num_points = collision.second.size();
-				for (index_points = 0; index_points < num_points; index_points++)
-				{
-					delauney.add_vertex(
-						collision.second[index_points]->x,
-						collision.second[index_points]->y,
-						collision.second[index_points]);
-				}
-				delauney_second.generate();
+	frame_vertices[0].x = min_x - size;
+	frame_vertices[0].y = min_y - size;
+	frame_vertices[1].x = max_x + size;
+	frame_vertices[1].y = min_y - size;
+	frame_vertices[2].x = max_x + size;
+	frame_vertices[2].y = max_y + size;
+	frame_vertices[3].x = min_x - size;
+	frame_vertices[3].y = max_y + size;
 
-				extra_triangulations.push_back(delauney_first);
-				extra_triangulations.push_back(delauney_second);
+	DelauneyTriangulator delauney;
+	for (auto &vertex : vertices)
+		delauney.add_vertex(vertex.x, vertex.y, &vertex);
+	for (auto &vertex : frame_vertices)
+	{
+		vertex.data = nullptr;
+		delauney.add_vertex(vertex.x, vertex.y, &vertex);
+	}
+	delauney.generate();
 
-				// Remove old triangles:
+	// Convert the triangles to a mesh. The data pointer of each triangle vertex points at the mesh vertex:
 
-				std::vector<DelauneyTriangulator_Triangle *>::size_type index_old_triangles, size_old_triangles;
-				size_old_triangles = collision.triangles.size();
-				for (index_old_triangles = 0; index_old_triangles < size_old_triangles; index_old_triangles++)
-				{
-					remove_triangle(collision.triangles[index_old_triangles]);
-					final_triangles.remove(collision.triangles[index_old_triangles]);
-				}
+	int num_vertices = (int) vertices.size();
+	auto get_index = [&](const DelauneyTriangulator_Vertex *vertex) -> int
+	{
+		const DelauneyTriangulator_Vertex *mesh_vertex = (const DelauneyTriangulator_Vertex *) vertex->data;
+		for (int index_frame = 0; index_frame < 4; index_frame++)
+		{
+			if (mesh_vertex == &frame_vertices[index_frame])
+				return num_vertices + index_frame;
+		}
+		return (int) (mesh_vertex - &vertices[0]);
+	};
 
-				// Add new triangles:
+	const std::vector<DelauneyTriangulator_Triangle> &delauney_triangles = delauney.get_triangles();
+	mesh_triangles.resize(delauney_triangles.size());
+	vertex_triangles.assign(num_vertices + 4, -1);
 
-				DelauneyTriangulator_Triangle const **new_links = add_triangles(delauney_first, delauney_second);
-				added_links.push_back(new_links);
+	// Link the neighbours by finding the opposite of each directed edge in a sorted list:
+	std::vector<std::pair<ubyte64, int> > edges;
+	edges.reserve(delauney_triangles.size() * 3);
+	for (size_t index_triangles = 0; index_triangles < delauney_triangles.size(); index_triangles++)
+	{
+		OutlineTriangulator_MeshTriangle &triangle = mesh_triangles[index_triangles];
+		triangle.vertices[0] = get_index(delauney_triangles[index_triangles].vertex_A);
+		triangle.vertices[1] = get_index(delauney_triangles[index_triangles].vertex_B);
+		triangle.vertices[2] = get_index(delauney_triangles[index_triangles].vertex_C);
+		for (int edge = 0; edge < 3; edge++)
+		{
+			triangle.neighbours[edge] = -1;
+			triangle.constrained[edge] = false;
+			vertex_triangles[triangle.vertices[edge]] = (int) index_triangles;
 
-				const std::vector<DelauneyTriangulator_Triangle> &triangles1 = delauney_first.get_triangles();
-				const std::vector<DelauneyTriangulator_Triangle> &triangles2 = delauney_second.get_triangles();
-				std::vector<DelauneyTriangulator_Triangle>::size_type index_triangles, num_triangles1, num_triangles2;
-				num_triangles1 = triangles1.size();
-				num_triangles2 = triangles2.size();
-				for (index_triangles = 0; index_triangles < num_triangles1; index_triangles++)
-					final_triangles.push_back(&triangles1[index_triangles]);
-				for (index_triangles = 0; index_triangles < num_triangles2; index_triangles++)
-					final_triangles.push_back(&triangles2[index_triangles]);
-			}
+			ubyte64 key = (((ubyte64) triangle.vertices[(edge + 1) % 3]) << 32) | (ubyte64) triangle.vertices[(edge + 2) % 3];
+			edges.push_back(std::make_pair(key, (int) index_triangles * 3 + edge));
 		}
 	}
+	std::sort(edges.begin(), edges.end());
 
-	// 4. Remove outside and hole triangles.
-
-	// 5. Clean up:
-
-	delete[] links;
-	std::vector<DelauneyTriangulator_Triangle const **>::size_type index_added_links, size_added_links;
-	size_added_links = added_links.size();
-	for (index_added_links = 0; index_added_links < size_added_links; index_added_links++)
+	for (const auto &edge : edges)
 	{
-		delete[] added_links[index_added_links];
+		ubyte64 opposite_key = (edge.first >> 32) | (edge.first << 32);
+		auto opposite = std::lower_bound(edges.begin(), edges.end(), std::make_pair(opposite_key, 0));
+		if (opposite != edges.end() && opposite->first == opposite_key)
+			mesh_triangles[edge.second / 3].neighbours[edge.second % 3] = opposite->second / 3;
 	}
+}
 
-	// 6. Generate final list:
+void OutlineTriangulator_Impl::insert_edge(int vertex_A, int vertex_B)
+{
+	while (vertex_A != vertex_B)
+	{
+		int triangle, edge;
+		if (find_edge(vertex_A, vertex_B, triangle, edge))
+		{
+			toggle_constrained(triangle, edge);
+			return;
+		}
 
+		// Collect the edges crossed on the way to vertex B, or to a vertex on the line before it:
 
+		int right, left;
+		int cur_triangle = find_first_crossed_edge(vertex_A, vertex_B, right, left);
+		int end_vertex = vertex_B;
+		crossed_edges.clear();
+		while (cur_triangle != -1)
+		{
+			crossed_edges.push_back(OutlineTriangulator_Edge(right, left));
 
-}
+			int third_vertex = get_third_vertex(cur_triangle, right, left);
+			int crossed_edge = 0;
+			while (mesh_triangles[cur_triangle].vertices[crossed_edge] != third_vertex)
+				crossed_edge++;
+			if (mesh_triangles[cur_triangle].constrained[crossed_edge])
+				throw Exception("Outline edges cross each other");
 
-DelauneyTriangulator_Triangle const **OutlineTriangulator_Impl::add_triangles(
-	DelauneyTriangulator &d1,
-	DelauneyTriangulator &d2)
-{
-	const std::vector<DelauneyTriangulator_Triangle> &triangles1 = d1.get_triangles();
-	const std::vector<DelauneyTriangulator_Triangle> &triangles2 = d2.get_triangles();
-	std::vector<DelauneyTriangulator_Triangle>::size_type index_triangles, num_triangles1, num_triangles2;
-	num_triangles1 = triangles1.size();
-	for (index_triangles = 0; index_triangles < num_triangles1; index_triangles++)
-	{
-		OutlineTriangulator_Vertex *data_A = (OutlineTriangulator_Vertex *) triangles1[index_triangles].vertex_A->data;
-		OutlineTriangulator_Vertex *data_B = (OutlineTriangulator_Vertex *) triangles1[index_triangles].vertex_B->data;
-		OutlineTriangulator_Vertex *data_C = (OutlineTriangulator_Vertex *) triangles1[index_triangles].vertex_C->data;
-		data_A->extra++;
-		data_B->extra++;
-		data_C->extra++;
-	}
-	num_triangles2 = triangles2.size();
-	for (index_triangles = 0; index_triangles < num_triangles2; index_triangles++)
-	{
-		OutlineTriangulator_Vertex *data_A = (OutlineTriangulator_Vertex *) triangles2[index_triangles].vertex_A->data;
-		OutlineTriangulator_Vertex *data_B = (OutlineTriangulator_Vertex *) triangles2[index_triangles].vertex_B->data;
-		OutlineTriangulator_Vertex *data_C = (OutlineTriangulator_Vertex *) triangles2[index_triangles].vertex_C->data;
-		data_A->extra++;
-		data_B->extra++;
-		data_C->extra++;
-	}
+			int next_triangle = mesh_triangles[cur_triangle].neighbours[crossed_edge];
+			if (next_triangle == -1)
+				throw Exception("Outline edge leaves the triangulation");
 
-	const std::vector<DelauneyTriangulator_Vertex> &vertices1 = d1.get_vertices();
-	const std::vector<DelauneyTriangulator_Vertex> &vertices2 = d2.get_vertices();
-	std::vector<DelauneyTriangulator_Vertex *>::size_type index_vertices, num_vertices1, num_vertices2;
-	num_vertices1 = d1.get_vertices().size();
-	num_vertices2 = d2.get_vertices().size();
+			int next_vertex = get_third_vertex(next_triangle, right, left);
+			if (next_vertex == vertex_B)
+				break;
 
-	int links_needed = 0;
-	for (index_vertices = 0; index_vertices < num_vertices1; index_vertices++)
-	{
-		OutlineTriangulator_Vertex *v = (OutlineTriangulator_Vertex *) vertices1[index_vertices].data;
-		links_needed += v->num_triangles + v->extra;
-	}
-	for (index_vertices = 0; index_vertices < num_vertices2; index_vertices++)
-	{
-		OutlineTriangulator_Vertex *v = (OutlineTriangulator_Vertex *) vertices2[index_vertices].data;
-		links_needed += v->num_triangles + v->extra;
-	}
+			double side = orientation(vertex_A, vertex_B, next_vertex);
+			if (side == 0.0)
+			{
+				end_vertex = next_vertex;
+				break;
+			}
+			else if (side < 0.0)
+			{
+				right = next_vertex;
+			}
+			else
+			{
+				left = next_vertex;
+			}
+			cur_triangle = next_triangle;
+		}
+		if (cur_triangle == -1)
+			end_vertex = right;
 
-	auto links = new DelauneyTriangulator_Triangle const *[links_needed];
-	int pos = 0;
-	for (index_vertices = 0; index_vertices < num_vertices1; index_vertices++)
-	{
-		OutlineTriangulator_Vertex *v = (OutlineTriangulator_Vertex *) vertices1[index_vertices].data;
-		if (v->extra == 0)
-			continue;
+		// Flip the crossed edges until none of them cross the new edge:
 
-		for (int i=0; i<v->num_triangles; i++)
-			links[pos+i] = v->triangles[i];
+		new_edges.clear();
+		while (!crossed_edges.empty())
+		{
+			OutlineTriangulator_Edge crossed = crossed_edges.front();
+			crossed_edges.pop_front();
 
-		v->data = links+pos;
-		pos += v->num_triangles + v->extra;
-		v->extra = 0;
-	}
-	for (index_vertices = 0; index_vertices < num_vertices2; index_vertices++)
-	{
-		OutlineTriangulator_Vertex *v = (OutlineTriangulator_Vertex *) vertices2[index_vertices].data;
-		if (v->extra == 0)
-			continue;
+			find_edge(crossed.vertex_A, crossed.vertex_B, triangle, edge);
+			if (!is_quad_convex(triangle, edge))
+			{
+				crossed_edges.push_back(crossed);
+				continue;
+			}
 
-		for (int i=0; i<v->num_triangles; i++)
-			links[pos+i] = v->triangles[i];
+			flip_edge(triangle, edge);
+			OutlineTriangulator_Edge flipped(mesh_triangles[triangle].vertices[0], mesh_triangles[triangle].vertices[2]);
+			if (crosses(vertex_A, end_vertex, flipped))
+				crossed_edges.push_back(flipped);
+			else
+				new_edges.push_back(flipped);
+		}
 
-		v->data = links+pos;
-		pos += v->num_triangles + v->extra;
-		v->extra = 0;
-	}
+		// Restore the delauney condition for the new edges, except the inserted one:
 
-	for (index_triangles = 0; index_triangles < num_triangles1; index_triangles++)
-	{
-		OutlineTriangulator_Vertex *data_A = (OutlineTriangulator_Vertex *) triangles1[index_triangles].vertex_A->data;
-		OutlineTriangulator_Vertex *data_B = (OutlineTriangulator_Vertex *) triangles1[index_triangles].vertex_B->data;
-		OutlineTriangulator_Vertex *data_C = (OutlineTriangulator_Vertex *) triangles1[index_triangles].vertex_C->data;
-		data_A->triangles[data_A->num_triangles++] = &triangles1[index_triangles];
-		data_B->triangles[data_B->num_triangles++] = &triangles1[index_triangles];
-		data_C->triangles[data_C->num_triangles++] = &triangles1[index_triangles];
-	}
-	for (index_triangles = 0; index_triangles < num_triangles2; index_triangles++)
-	{
-		OutlineTriangulator_Vertex *data_A = (OutlineTriangulator_Vertex *) triangles2[index_triangles].vertex_A->data;
-		OutlineTriangulator_Vertex *data_B = (OutlineTriangulator_Vertex *) triangles2[index_triangles].vertex_B->data;
-		OutlineTriangulator_Vertex *data_C = (OutlineTriangulator_Vertex *) triangles2[index_triangles].vertex_C->data;
-		data_A->triangles[data_A->num_triangles++] = &triangles2[index_triangles];
-		data_B->triangles[data_B->num_triangles++] = &triangles2[index_triangles];
-		data_C->triangles[data_C->num_triangles++] = &triangles2[index_triangles];
-	}
+		bool swapped = true;
+		while (swapped)
+		{
+			swapped = false;
+			for (auto &new_edge : new_edges)
+			{
+				if ((new_edge.vertex_A == vertex_A && new_edge.vertex_B == end_vertex) || (new_edge.vertex_A == end_vertex && new_edge.vertex_B == vertex_A))
+					continue;
+
+				find_edge(new_edge.vertex_A, new_edge.vertex_B, triangle, edge);
+				int neighbour = mesh_triangles[triangle].neighbours[edge];
+				if (neighbour == -1 || mesh_triangles[triangle].constrained[edge])
+					continue;
+
+				int opposite_vertex = get_third_vertex(neighbour, new_edge.vertex_A, new_edge.vertex_B);
+				if (in_circumcircle(triangle, opposite_vertex) && is_quad_convex(triangle, edge))
+				{
+					flip_edge(triangle, edge);
+					new_edge = OutlineTriangulator_Edge(mesh_triangles[triangle].vertices[0], mesh_triangles[triangle].vertices[2]);
+					swapped = true;
+				}
+			}
+		}
+
+		if (!find_edge(vertex_A, end_vertex, triangle, edge))
+			throw Exception("Unable to insert outline edge");
+		toggle_constrained(triangle, edge);
 
-	return links;
+		vertex_A = end_vertex;
+	}
 }
 
-OutlineTriangulator_Collision OutlineTriangulator_Impl::find_colliding_triangles(
-	OutlineTriangulator_Vertex *v1,
-	OutlineTriangulator_Vertex *v2)
+int OutlineTriangulator_Impl::find_first_crossed_edge(int vertex_A, int vertex_B, int &out_right, int &out_left) const
 {
-	OutlineTriangulator_Collision collision;
+	// Look through the triangles around vertex A for the one the edge leaves through.
+	// Returns -1 with out_right set if the edge runs along a mesh edge to a vertex before vertex B.
 
-	for (int index_triangles = 0; index_triangles < v1->num_triangles; index_triangles++)
+	const DelauneyTriangulator_Vertex &a = get_mesh_vertex(vertex_A);
+	const DelauneyTriangulator_Vertex &b = get_mesh_vertex(vertex_B);
+
+	int start_triangle = vertex_triangles[vertex_A];
+	int cur_triangle = start_triangle;
+	bool clockwise = false;
+	while (true)
 	{
-		OutlineTriangulator_Vertex *vA = (OutlineTriangulator_Vertex *) v1->triangles[index_triangles]->vertex_A->data;
-		OutlineTriangulator_Vertex *vB = (OutlineTriangulator_Vertex *) v1->triangles[index_triangles]->vertex_B->data;
-		OutlineTriangulator_Vertex *vC = (OutlineTriangulator_Vertex *) v1->triangles[index_triangles]->vertex_C->data;
-
-		// If an edge is same line as the constrained line, there can be no colliding triangles:
-		if (
-			(v1 == vA && v2 == vB) ||
-			(v1 == vB && v2 == vA) ||
-			(v1 == vB && v2 == vC) ||
-			(v1 == vC && v2 == vB) ||
-			(v1 == vC && v2 == vA) ||
-			(v1 == vA && v2 == vC))
-			return collision;
-
-		bool intersectsA, intersectsB, intersectsC;
-
-		if (v1 == vA || v1 == vB || v2 == vA || v2 == vB)
-			intersectsA = false;
-		else
-			intersectsA = intersects(
-				v1->x, v1->y, v2->x, v2->y,
-				v1->triangles[index_triangles]->vertex_A->x,
-				v1->triangles[index_triangles]->vertex_A->y,
-				v1->triangles[index_triangles]->vertex_B->x,
-				v1->triangles[index_triangles]->vertex_B->y);
-
-		if (v1 == vB || v1 == vC || v2 == vB || v2 == vC)
-			intersectsB = false;
-		else
-			intersectsB = intersects(
-				v1->x, v1->y, v2->x, v2->y,
-				v1->triangles[index_triangles]->vertex_B->x,
-				v1->triangles[index_triangles]->vertex_B->y,
-				v1->triangles[index_triangles]->vertex_C->x,
-				v1->triangles[index_triangles]->vertex_C->y);
-
-		if (v1 == vC || v1 == vA || v2 == vC || v2 == vA)
-			intersectsC = false;
-		else
-			intersectsC = intersects(
-				v1->x, v1->y, v2->x, v2->y,
-				v1->triangles[index_triangles]->vertex_C->x,
-				v1->triangles[index_triangles]->vertex_C->y,
-				v1->triangles[index_triangles]->vertex_A->x,
-				v1->triangles[index_triangles]->vertex_A->y);
-
-		if (intersectsA == false && intersectsB == false && intersectsC == false)
-			continue;
-
-		// Collision. Add all points to the correct side of the intersected line:
-
-		collision.triangles.push_back(v1->triangles[index_triangles]);
-
-		if (vA == v1 || vA == v2)
-		{
-			collision.first.push_back(vA);
-			collision.second.push_back(vA);
-		}
-		else if (LineMath::point_right_of_line(vA->x, vA->y, v1->x, v1->y, v2->x, v2->y))
+		const OutlineTriangulator_MeshTriangle &triangle = mesh_triangles[cur_triangle];
+		int corner = 0;
+		while (triangle.vertices[corner] != vertex_A)
+			corner++;
+
+		int vertex_1 = triangle.vertices[(corner + 1) % 3];
+		int vertex_2 = triangle.vertices[(corner + 2) % 3];
+		double side_1 = orientation(vertex_A, vertex_B, vertex_1);
+		double side_2 = orientation(vertex_A, vertex_B, vertex_2);
+
+		for (int vertex : { vertex_1, vertex_2 })
 		{
-			collision.second.push_back(vA);
+			const DelauneyTriangulator_Vertex &v = get_mesh_vertex(vertex);
+			bool same_direction = ((double) v.x - a.x) * ((double) b.x - a.x) + ((double) v.y - a.y) * ((double) b.y - a.y) > 0.0;
+			if (orientation(vertex_A, vertex_B, vertex) == 0.0 && same_direction)
+			{
+				out_right = vertex;
+				out_left = vertex;
+				return -1;
+			}
 		}
-		else
+
+		if (side_1 < 0.0 && side_2 > 0.0)
 		{
-			collision.first.push_back(vA);
+			out_right = vertex_1;
+			out_left = vertex_2;
+			return cur_triangle;
 		}
 
-		if (vB == v1 || vB == v2)
+		int next_triangle = triangle.neighbours[clockwise ? (corner + 2) % 3 : (corner + 1) % 3];
+		if (next_triangle == -1 && !clockwise)
 		{
-			collision.first.push_back(vB);
-			collision.second.push_back(vB);
+			clockwise = true;
+			next_triangle = start_triangle;
 		}
-		else if (LineMath::point_right_of_line(vB->x, vB->y, v1->x, v1->y, v2->x, v2->y))
+		if (next_triangle == -1 || next_triangle == start_triangle)
+			throw Exception("Unable to insert outline edge");
+		cur_triangle = next_triangle;
+	}
+}
+
+bool OutlineTriangulator_Impl::find_edge(int vertex_A, int vertex_B, int &out_triangle, int &out_edge) const
+{
+	// Rotate counter-clockwise around vertex A, then clockwise if an outer edge stopped the rotation
+	int start_triangle = vertex_triangles[vertex_A];
+	int cur_triangle = start_triangle;
+	bool clockwise = false;
+	while (true)
+	{
+		const OutlineTriangulator_MeshTriangle &triangle = mesh_triangles[cur_triangle];
+		int corner = 0;
+		while (triangle.vertices[corner] != vertex_A)
+			corner++;
+
+		if (triangle.vertices[(corner + 1) % 3] == vertex_B)
 		{
-			collision.second.push_back(vB);
+			out_triangle = cur_triangle;
+			out_edge = (corner + 2) % 3;
+			return true;
 		}
-		else
+		else if (triangle.vertices[(corner + 2) % 3] == vertex_B)
 		{
-			collision.first.push_back(vB);
+			out_triangle = cur_triangle;
+			out_edge = (corner + 1) % 3;
+			return true;
 		}
 
-		if (vC == v1 || vC == v2)
+		int next_triangle = triangle.neighbours[clockwise ? (corner + 2) % 3 : (corner + 1) % 3];
+		if (next_triangle == -1 && !clockwise)
 		{
-			collision.first.push_back(vC);
-			collision.second.push_back(vC);
+			clockwise = true;
+			next_triangle = start_triangle;
 		}
-		else if (LineMath::point_right_of_line(vC->x, vC->y, v1->x, v1->y, v2->x, v2->y))
+		if (next_triangle == -1 || next_triangle == start_triangle)
+			return false;
+		cur_triangle = next_triangle;
+	}
+}
+
+int OutlineTriangulator_Impl::get_third_vertex(int triangle, int vertex_A, int vertex_B) const
+{
+	const OutlineTriangulator_MeshTriangle &t = mesh_triangles[triangle];
+	for (int corner = 0; corner < 3; corner++)
+	{
+		if (t.vertices[corner] != vertex_A && t.vertices[corner] != vertex_B)
+			return t.vertices[corner];
+	}
+	return -1;
+}
+
+bool OutlineTriangulator_Impl::crosses(int a, int b, const OutlineTriangulator_Edge &edge) const
+{
+	if (edge.vertex_A == a || edge.vertex_A == b || edge.vertex_B == a || edge.vertex_B == b)
+		return false;
+
+	return orientation(a, b, edge.vertex_A) * orientation(a, b, edge.vertex_B) < 0.0 &&
+		orientation(edge.vertex_A, edge.vertex_B, a) * orientation(edge.vertex_A, edge.vertex_B, b) < 0.0;
+}
+
+bool OutlineTriangulator_Impl::is_quad_convex(int triangle, int edge) const
+{
+	// The edge can only be flipped if both new triangles are counter-clockwise
+	const OutlineTriangulator_MeshTriangle &t = mesh_triangles[triangle];
+	int p = t.vertices[edge];
+	int q = t.vertices[(edge + 1) % 3];
+	int r = t.vertices[(edge + 2) % 3];
+	int s = get_third_vertex(t.neighbours[edge], q, r);
+	return orientation(p, q, s) > 0.0 && orientation(s, r, p) > 0.0;
+}
+
+void OutlineTriangulator_Impl::flip_edge(int triangle, int edge)
+{
+	// Triangles (p, q, r) and (s, r, q) become (p, q, s) and (s, r, p)
+
+	int neighbour = mesh_triangles[triangle].neighbours[edge];
+	OutlineTriangulator_MeshTriangle &t1 = mesh_triangles[triangle];
+	OutlineTriangulator_MeshTriangle &t2 = mesh_triangles[neighbour];
+
+	int neighbour_edge = 0;
+	while (t2.neighbours[neighbour_edge] != triangle)
+		neighbour_edge++;
+
+	int p = t1.vertices[edge];
+	int q = t1.vertices[(edge + 1) % 3];
+	int r = t1.vertices[(edge + 2) % 3];
+	int s = t2.vertices[neighbour_edge];
+
+	int neighbour_rp = t1.neighbours[(edge + 1) % 3];
+	int neighbour_pq = t1.neighbours[(edge + 2) % 3];
+	int neighbour_qs = t2.neighbours[(neighbour_edge + 1) % 3];
+	int neighbour_sr = t2.neighbours[(neighbour_edge + 2) % 3];
+	bool constrained_rp = t1.constrained[(edge + 1) % 3];
+	bool constrained_pq = t1.constrained[(edge + 2) % 3];
+	bool constrained_qs = t2.constrained[(neighbour_edge + 1) % 3];
+	bool constrained_sr = t2.constrained[(neighbour_edge + 2) % 3];
+
+	t1.vertices[0] = p;
+	t1.vertices[1] = q;
+	t1.vertices[2] = s;
+	t1.neighbours[0] = neighbour_qs;
+	t1.neighbours[1] = neighbour;
+	t1.neighbours[2] = neighbour_pq;
+	t1.constrained[0] = constrained_qs;
+	t1.constrained[1] = false;
+	t1.constrained[2] = constrained_pq;
+
+	t2.vertices[0] = s;
+	t2.vertices[1] = r;
+	t2.vertices[2] = p;
+	t2.neighbours[0] = neighbour_rp;
+	t2.neighbours[1] = triangle;
+	t2.neighbours[2] = neighbour_sr;
+	t2.constrained[0] = constrained_rp;
+	t2.constrained[1] = false;
+	t2.constrained[2] = constrained_sr;
+
+	if (neighbour_qs != -1)
+	{
+		for (int i = 0; i < 3; i++)
 		{
-			collision.second.push_back(vC);
+			if (mesh_triangles[neighbour_qs].neighbours[i] == neighbour)
+				mesh_triangles[neighbour_qs].neighbours[i] = triangle;
 		}
-		else
+	}
+	if (neighbour_rp != -1)
+	{
+		for (int i = 0; i < 3; i++)
 		{
-			collision.first.push_back(vC);
+			if (mesh_triangles[neighbour_rp].neighbours[i] == triangle)
+				mesh_triangles[neighbour_rp].neighbours[i] = neighbour;
 		}
 	}
 
-	return collision;
+	vertex_triangles[p] = triangle;
+	vertex_triangles[q] = triangle;
+	vertex_triangles[r] = neighbour;
+	vertex_triangles[s] = neighbour;
 }
 
-void OutlineTriangulator_Impl::remove_triangle(DelauneyTriangulator_Triangle const *t)
+void OutlineTriangulator_Impl::toggle_constrained(int triangle, int edge)
 {
-	for (int vertex = 0; vertex < 3; vertex++)
+	// An edge added twice cancels out, as the even-odd rule would cross it twice
+	OutlineTriangulator_MeshTriangle &t = mesh_triangles[triangle];
+	t.constrained[edge] = !t.constrained[edge];
+
+	int neighbour = t.neighbours[edge];
+	if (neighbour != -1)
 	{
-		OutlineTriangulator_Vertex *data = nullptr;
-		switch (vertex)
+		for (int i = 0; i < 3; i++)
 		{
-		case 0:
-			data = (OutlineTriangulator_Vertex *) t->vertex_A->data;
-			break;
+			if (mesh_triangles[neighbour].neighbours[i] == triangle)
+				mesh_triangles[neighbour].constrained[i] = t.constrained[edge];
+		}
+	}
+}
 
-		case 1:
-			data = (OutlineTriangulator_Vertex *) t->vertex_B->data;
-			break;
+void OutlineTriangulator_Impl::remove_outside_triangles()
+{
+	// Flood fill one level at a time, starting at the triangles touching the frame. Crossing a constrained
+	// edge moves to the next level, and the triangles on odd levels are inside the polygons.
 
-		case 2:
-			data = (OutlineTriangulator_Vertex *) t->vertex_C->data;
-			break;
+	int num_vertices = (int) vertices.size();
+	std::vector<int> levels(mesh_triangles.size(), -1);
+	std::vector<int> cur_level_triangles, next_level_triangles;
+	for (size_t index_triangles = 0; index_triangles < mesh_triangles.size(); index_triangles++)
+	{
+		const OutlineTriangulator_MeshTriangle &triangle = mesh_triangles[index_triangles];
+		if (triangle.vertices[0] >= num_vertices || triangle.vertices[1] >= num_vertices || triangle.vertices[2] >= num_vertices)
+		{
+			levels[index_triangles] = 0;
+			cur_level_triangles.push_back((int) index_triangles);
 		}
+	}
 
-		for (int index = 0; index < data->num_triangles; index++)
+	int level = 0;
+	while (!cur_level_triangles.empty())
+	{
+		for (size_t index_level = 0; index_level < cur_level_triangles.size(); index_level++)
 		{
-			if (data->triangles[index] == t)
+			const OutlineTriangulator_MeshTriangle &triangle = mesh_triangles[cur_level_triangles[index_level]];
+			for (int edge = 0; edge < 3; edge++)
 			{
-				for (int index2 = index; index2 < data->num_triangles-1; index2++)
+				int neighbour = triangle.neighbours[edge];
+				if (neighbour == -1 || levels[neighbour] != -1)
+					continue;
+
+				if (triangle.constrained[edge])
+				{
+					next_level_triangles.push_back(neighbour);
+				}
+				else
 				{
-					data->triangles[index2] = data->triangles[index2+1];
+					levels[neighbour] = level;
+					cur_level_triangles.push_back(neighbour);
 				}
-				index--;
-				data->num_triangles--;
 			}
 		}
-	}
-}
 
-struct CompareVertices
-{
-	bool operator()(OutlineTriangulator_Vertex *a, OutlineTriangulator_Vertex *b) const
-	{
-		if (a->x == b->x) return a->y < b->y;
-		return a->x < b->x;
-	}
-};
-
-void OutlineTriangulator_Impl::create_ordered_vertex_list(std::vector<OutlineTriangulator_Vertex *> &vertices)
-{
-	std::vector<OutlineTriangulator_Polygon>::size_type index_polygons, num_polygons;
-	num_polygons = polygons.size();
-	for (index_polygons = 0; index_polygons < num_polygons; index_polygons++)
-	{
-		OutlineTriangulator_Polygon &cur_poly = polygons[index_polygons];
-		std::vector<OutlineTriangulator_Contour>::size_type index_contours, num_contours;
-		num_contours = cur_poly.contours.size();
-		for (index_contours = 0; index_contours < num_contours; index_contours++)
+		level++;
+		cur_level_triangles.clear();
+		for (int neighbour : next_level_triangles)
 		{
-			OutlineTriangulator_Contour &cur_contour = cur_poly.contours[index_contours];
-			std::vector<OutlineTriangulator_Vertex>::size_type index_vertices, num_vertices;
-			num_vertices = cur_contour.vertices.size();
-			for (index_vertices = 0; index_vertices < num_vertices; index_vertices++)
+			if (levels[neighbour] == -1)
 			{
-				vertices.push_back(&cur_contour.vertices[index_vertices]);
+				levels[neighbour] = level;
+				cur_level_triangles.push_back(neighbour);
 			}
 		}
+		next_level_triangles.clear();
 	}
 
-	// Sort list:
-	std::sort(vertices.begin(), vertices.end(), CompareVertices());
-
-	// Remove duplicates:
-	auto it = vertices.begin();
-	if (it == vertices.end()) return;
-	float last_x = (*it)->x;
-	float last_y = (*it)->y;
-	++it;
-	while (it != vertices.end())
+	for (size_t index_triangles = 0; index_triangles < mesh_triangles.size(); index_triangles++)
 	{
-		if (last_x == (*it)->x && last_y == (*it)->y)
-		{
-			it = vertices.erase(it);
-		}
-		else
+		if (levels[index_triangles] % 2 == 1)
 		{
-			last_x = (*it)->x;
-			last_y = (*it)->y;
-			++it;
+			const OutlineTriangulator_MeshTriangle &cur_triangle = mesh_triangles[index_triangles];
+			DelauneyTriangulator_Triangle triangle;
+			triangle.vertex_A = &vertices[cur_triangle.vertices[0]];
+			triangle.vertex_B = &vertices[cur_triangle.vertices[1]];
+			triangle.vertex_C = &vertices[cur_triangle.vertices[2]];
+			triangles.push_back(triangle);
 		}
 	}
 }
 
-bool OutlineTriangulator_Impl::intersects( 
-	float Ax,
-	float Ay,
-	float Bx,
-	float By,
-	float Cx,
-	float Cy,
-	float Dx,
-	float Dy)
+const DelauneyTriangulator_Vertex &OutlineTriangulator_Impl::get_mesh_vertex(int index) const
 {
-	float denominator = ((Bx-Ax)*(Dy-Cy)-(By-Ay)*(Dx-Cx));	
-	
-	if( denominator == 0 ) // parallell
-	{
-		return false;
-	}
-
-	float r = ((Ay-Cy)*(Dx-Cx)-(Ax-Cx)*(Dy-Cy)) / denominator;
-	float s = ((Ay-Cy)*(Bx-Ax)-(Ax-Cx)*(By-Ay)) / denominator;
+	return index < (int) vertices.size() ? vertices[index] : frame_vertices[index - (int) vertices.size()];
+}
 
-	if( (s > 0.0 && s < 1.0) && (r > 0.0 && r < 1.0) )
-		return true;
+double OutlineTriangulator_Impl::orientation(int a, int b, int c) const
+{
+	// Positive if the points are in counter-clockwise order, negative if clockwise and zero if on a line.
 
-	return false;
+	const DelauneyTriangulator_Vertex &vA = get_mesh_vertex(a);
+	const DelauneyTriangulator_Vertex &vB = get_mesh_vertex(b);
+	const DelauneyTriangulator_Vertex &vC = get_mesh_vertex(c);
+	return ((double) vB.x - vA.x) * ((double) vC.y - vA.y) - ((double) vB.y - vA.y) * ((double) vC.x - vA.x);
 }
 
-/////////////////////////////////////////////////////////////////////////////
-// OutlineTriangulator_Impl implementation:
+bool OutlineTriangulator_Impl::in_circumcircle(int triangle, int point) const
+{
+	// Positive determinant when the point is inside the circumcircle of a counter-clockwise triangle.
+	// See DelauneyTriangulator_Impl::in_circumcircle.
+
+	const OutlineTriangulator_MeshTriangle &t = mesh_triangles[triangle];
+	const DelauneyTriangulator_Vertex &vA = get_mesh_vertex(t.vertices[0]);
+	const DelauneyTriangulator_Vertex &vB = get_mesh_vertex(t.vertices[1]);
+	const DelauneyTriangulator_Vertex &vC = get_mesh_vertex(t.vertices[2]);
+	const DelauneyTriangulator_Vertex &vP = get_mesh_vertex(point);
+
+	double ax = (double) vA.x - vP.x;
+	double ay = (double) vA.y - vP.y;
+	double bx = (double) vB.x - vP.x;
+	double by = (double) vB.y - vP.y;
+	double cx = (double) vC.x - vP.x;
+	double cy = (double) vC.y - vP.y;
+
+	double a2 = ax * ax + ay * ay;
+	double b2 = bx * bx + by * by;
+	double c2 = cx * cx + cy * cy;
+
+	double det = ax * (by * c2 - b2 * cy) - ay * (bx * c2 - b2 * cx) + a2 * (bx * cy - by * cx);
+	return det > 0.0;
+}
 
 }
@@ -29,21 +29,18 @@
 
 #pragma once
 
+#include "API/Core/Math/delauney_triangulator.h"
 #include <vector>
+#include <deque>
 
 namespace clan
 {
 
-class DelauneyTriangulator;
-class DelauneyTriangulator_Triangle;
-
 struct OutlineTriangulator_Vertex
 {
 	void *data;
 	float x, y;
-	int num_triangles;
-	int extra;
-	DelauneyTriangulator_Triangle const **triangles;
+	int mesh_vertex;
 };
 
 struct OutlineTriangulator_Contour
@@ -56,11 +53,25 @@ struct OutlineTriangulator_Polygon
 	std::vector<OutlineTriangulator_Contour> contours;
 };
 
-struct OutlineTriangulator_Collision
+/// \brief Triangle in the mesh the outlines are inserted into.
+///
+/// Vertices are indices into the mesh vertex list, in counter-clockwise order.
+/// neighbours[i] is the triangle on the other side of the edge opposite vertices[i], or -1 for an outer edge.
+/// constrained[i] is set when that edge is part of the outlines.
+struct OutlineTriangulator_MeshTriangle
+{
+	int vertices[3];
+	int neighbours[3];
+	bool constrained[3];
+};
+
+/// \brief Edge between two mesh vertices.
+struct OutlineTriangulator_Edge
 {
-	std::vector<OutlineTriangulator_Vertex *> first;
-	std::vector<OutlineTriangulator_Vertex *> second;
-	std::vector<DelauneyTriangulator_Triangle const *> triangles;
+	OutlineTriangulator_Edge(int vertex_A, int vertex_B) : vertex_A(vertex_A), vertex_B(vertex_B) { }
+
+	int vertex_A;
+	int vertex_B;
 };
 
 class OutlineTriangulator_Impl
@@ -85,7 +96,9 @@ public:
 
 	std::vector<OutlineTriangulator_Polygon> polygons;
 
-//	std::vector<OutlineTriangulator_Triangle> triangles;
+	std::vector<DelauneyTriangulator_Vertex> vertices;
+
+	std::vector<DelauneyTriangulator_Triangle> triangles;
 
 
 /// \}
@@ -93,32 +106,47 @@ public:
 /// \{
 
 public:
-	void insert_points();
-
 	void triangulate();
 
 	void create_ordered_vertex_list(
 		std::vector<OutlineTriangulator_Vertex *> &vertices);
 
-	OutlineTriangulator_Collision find_colliding_triangles(
-		OutlineTriangulator_Vertex *v1,
-		OutlineTriangulator_Vertex *v2);
-
-	void remove_triangle(DelauneyTriangulator_Triangle const *t);
-
-	DelauneyTriangulator_Triangle const **add_triangles(
-		DelauneyTriangulator &d1,
-		DelauneyTriangulator &d2);
-
-	bool intersects(
-		float Ax,
-		float Ay,
-		float Bx,
-		float By,
-		float Cx,
-		float Cy,
-		float Dx,
-		float Dy);
+/// \}
+/// \name Implementation
+/// \{
+
+private:
+	void create_mesh();
+
+	void insert_edge(int vertex_A, int vertex_B);
+
+	void remove_outside_triangles();
+
+	bool find_edge(int vertex_A, int vertex_B, int &out_triangle, int &out_edge) const;
+
+	int find_first_crossed_edge(int vertex_A, int vertex_B, int &out_right, int &out_left) const;
+
+	int get_third_vertex(int triangle, int vertex_A, int vertex_B) const;
+
+	bool crosses(int a, int b, const OutlineTriangulator_Edge &edge) const;
+
+	void flip_edge(int triangle, int edge);
+
+	bool is_quad_convex(int triangle, int edge) const;
+
+	void toggle_constrained(int triangle, int edge);
+
+	double orientation(int a, int b, int c) const;
+
+	bool in_circumcircle(int triangle, int point) const;
+
+	const DelauneyTriangulator_Vertex &get_mesh_vertex(int index) const;
+
+	DelauneyTriangulator_Vertex frame_vertices[4];
+	std::vector<OutlineTriangulator_MeshTriangle> mesh_triangles;
+	std::vector<int> vertex_triangles;
+	std::deque<OutlineTriangulator_Edge> crossed_edges;
+	std::vector<OutlineTriangulator_Edge> new_edges;
 /// \}
 };
 
@@ -40,8 +40,8 @@ RectPacker::RectPacker()
 {
 }
 
-RectPacker::RectPacker(const Size &max_group_size, AllocationPolicy policy)
-: impl(std::make_shared<RectPacker_Impl>(max_group_size))
+RectPacker::RectPacker(const Size &max_group_size, AllocationPolicy policy, PackingMethod method)
+: impl(std::make_shared<RectPacker_Impl>(max_group_size, method))
 {
 	set_allocation_policy(policy);
 }
@@ -64,6 +64,11 @@ RectPacker::AllocationPolicy RectPacker::get_allocation_policy() const
 	return impl->allocation_policy;
 }
 
+RectPacker::PackingMethod RectPacker::get_packing_method() const
+{
+	return impl->packing_method;
+}
+
 Size RectPacker::get_max_group_size() const
 {
 	return impl->max_group_size;
@@ -84,6 +89,11 @@ int RectPacker::get_group_count() const
 	return impl->root_nodes.size();
 }
 
+float RectPacker::get_occupancy(unsigned int group_index) const
+{
+	return impl->get_occupancy(group_index);
+}
+
 /////////////////////////////////////////////////////////////////////////////
 // RectPacker Operations:
 
@@ -97,4 +107,9 @@ RectPacker::AllocatedRect RectPacker::add(const Size &size)
 	return impl->add_new_node(size);
 }
 
+void RectPacker::remove(const AllocatedRect &rect)
+{
+	impl->remove(rect);
+}
+
 }
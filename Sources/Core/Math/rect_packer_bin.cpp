@@ -0,0 +1,500 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2015 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    agent
+*/
+
+#include "Core/precomp.h"
+#include "rect_packer_bin.h"
+#include <algorithm>
+#include <climits>
+
+namespace clan
+{
+
+/////////////////////////////////////////////////////////////////////////////
+// RectPackerBin:
+
+std::unique_ptr<RectPackerBin> RectPackerBin::create(const Rect &area, RectPacker::PackingMethod method)
+{
+	switch (method)
+	{
+	case RectPacker::skyline_bottom_left:
+		return std::unique_ptr<RectPackerBin>(new RectPackerBin_Skyline(area));
+	case RectPacker::max_rects:
+		return std::unique_ptr<RectPackerBin>(new RectPackerBin_MaxRects(area));
+	case RectPacker::guillotine:
+	default:
+		return std::unique_ptr<RectPackerBin>(new RectPackerBin_Guillotine(area));
+	}
+}
+
+bool RectPackerBin::insert(const Size &size, Rect &out_rect)
+{
+	if (size.width <= 0 || size.height <= 0)
+	{
+		out_rect = Rect(area.left, area.top, Size(std::max(size.width, 0), std::max(size.height, 0)));
+	}
+	else if (!allocate(size, out_rect))
+	{
+		return false;
+	}
+
+	used_rects.push_back(out_rect);
+	used_area += (ubyte64)out_rect.get_width() * out_rect.get_height();
+	return true;
+}
+
+bool RectPackerBin::remove(const Rect &rect)
+{
+	// Search from the back, as recently added rects are the most likely to be removed
+	for (size_t i = used_rects.size(); i > 0; i--)
+	{
+		if (used_rects[i - 1] == rect)
+		{
+			used_rects[i - 1] = used_rects.back();
+			used_rects.pop_back();
+			used_area -= (ubyte64)rect.get_width() * rect.get_height();
+			if (rect.get_width() > 0 && rect.get_height() > 0)
+				free(rect);
+			return true;
+		}
+	}
+	return false;
+}
+
+float RectPackerBin::get_occupancy() const
+{
+	ubyte64 total_area = (ubyte64)area.get_width() * area.get_height();
+	return total_area ? (float)((double)used_area / total_area) : 0.0f;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// RectPackerFreeList:
+
+bool RectPackerFreeList::find(const Size &size, Rect &out_rect) const
+{
+	int best_short_side = INT_MAX;
+	int best_long_side = INT_MAX;
+	for (const auto &free_rect : free_rects)
+	{
+		int leftover_width = free_rect.get_width() - size.width;
+		int leftover_height = free_rect.get_height() - size.height;
+		if (leftover_width < 0 || leftover_height < 0)
+			continue;
+
+		int short_side = std::min(leftover_width, leftover_height);
+		int long_side = std::max(leftover_width, leftover_height);
+		if (short_side < best_short_side || (short_side == best_short_side && long_side < best_long_side))
+		{
+			best_short_side = short_side;
+			best_long_side = long_side;
+			out_rect = Rect(free_rect.left, free_rect.top, size);
+		}
+	}
+	return best_short_side != INT_MAX;
+}
+
+void RectPackerFreeList::use(const Rect &rect)
+{
+	// Replace every free rect overlapping the used rect with the (up to four) maximal rects around it
+	new_rects.clear();
+	for (size_t i = 0; i < free_rects.size(); )
+	{
+		Rect free_rect = free_rects[i];
+		if (!free_rect.is_overlapped(rect))
+		{
+			i++;
+			continue;
+		}
+
+		if (rect.left > free_rect.left)
+			new_rects.push_back(Rect(free_rect.left, free_rect.top, rect.left, free_rect.bottom));
+		if (rect.right < free_rect.right)
+			new_rects.push_back(Rect(rect.right, free_rect.top, free_rect.right, free_rect.bottom));
+		if (rect.top > free_rect.top)
+			new_rects.push_back(Rect(free_rect.left, free_rect.top, free_rect.right, rect.top));
+		if (rect.bottom < free_rect.bottom)
+			new_rects.push_back(Rect(free_rect.left, rect.bottom, free_rect.right, free_rect.bottom));
+
+		free_rects[i] = free_rects.back();
+		free_rects.pop_back();
+	}
+	prune();
+}
+
+void RectPackerFreeList::prune()
+{
+	// The untouched free rects were maximal before, so only the new rects can be contained in another rect
+	size_t num_old_rects = free_rects.size();
+	for (size_t i = 0; i < new_rects.size(); i++)
+	{
+		const Rect &new_rect = new_rects[i];
+		bool contained = false;
+		for (size_t j = 0; j < num_old_rects && !contained; j++)
+			contained = free_rects[j].is_inside(new_rect);
+		for (size_t j = 0; j < new_rects.size() && !contained; j++)
+			contained = (j != i) && new_rects[j].is_inside(new_rect) && (new_rects[j] != new_rect || j < i);
+		if (!contained)
+			free_rects.push_back(new_rect);
+	}
+	new_rects.clear();
+}
+
+void RectPackerFreeList::add(const Rect &rect)
+{
+	// Join the freed rect with free rects sharing a full edge with it, so the space can hold larger rects again
+	std::vector<Rect> pending(1, rect);
+	while (!pending.empty())
+	{
+		Rect current = pending.back();
+		pending.pop_back();
+
+		bool contained = false;
+		for (const auto &free_rect : free_rects)
+		{
+			if (free_rect.is_inside(current))
+			{
+				contained = true;
+				break;
+			}
+		}
+		if (contained)
+			continue;
+
+		for (size_t i = 0; i < free_rects.size(); )
+		{
+			const Rect free_rect = free_rects[i];
+			if (current.is_inside(free_rect))
+			{
+				free_rects[i] = free_rects.back();
+				free_rects.pop_back();
+				continue;
+			}
+
+			if (free_rect.top == current.top && free_rect.bottom == current.bottom && free_rect.left <= current.right && free_rect.right >= current.left)
+				pending.push_back(Rect(std::min(free_rect.left, current.left), current.top, std::max(free_rect.right, current.right), current.bottom));
+			else if (free_rect.left == current.left && free_rect.right == current.right && free_rect.top <= current.bottom && free_rect.bottom >= current.top)
+				pending.push_back(Rect(current.left, std::min(free_rect.top, current.top), current.right, std::max(free_rect.bottom, current.bottom)));
+			i++;
+		}
+		free_rects.push_back(current);
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// RectPackerBin_Guillotine:
+
+RectPackerBin_Guillotine::RectPackerBin_Guillotine(const Rect &area) : RectPackerBin(area)
+{
+	new_node(area, -1);
+}
+
+bool RectPackerBin_Guillotine::allocate(const Size &size, Rect &out_rect)
+{
+	int index = insert(0, size);
+	if (index < 0)
+		return false;
+	out_rect = nodes[index].rect;
+	return true;
+}
+
+void RectPackerBin_Guillotine::free(const Rect &rect)
+{
+	int index = find(0, rect);
+	if (index < 0)
+		return;
+	nodes[index].used = false;
+
+	// Join free siblings back into their parent
+	int parent = nodes[index].parent;
+	while (parent >= 0)
+	{
+		const Node &child0 = nodes[nodes[parent].child[0]];
+		const Node &child1 = nodes[nodes[parent].child[1]];
+		if (child0.child[0] >= 0 || child1.child[0] >= 0 || child0.used || child1.used)
+			break;
+
+		free_nodes.push_back(nodes[parent].child[0]);
+		free_nodes.push_back(nodes[parent].child[1]);
+		nodes[parent].child[0] = -1;
+		nodes[parent].child[1] = -1;
+		parent = nodes[parent].parent;
+	}
+}
+
+int RectPackerBin_Guillotine::insert(int node_index, const Size &size)
+{
+	// If we're not a leaf
+	if (nodes[node_index].child[0] >= 0)
+	{
+		int index = insert(nodes[node_index].child[0], size);
+		if (index >= 0)
+			return index;
+		return insert(nodes[node_index].child[1], size);
+	}
+
+	Node &node = nodes[node_index];
+	if (node.used)
+		return -1;
+
+	int dw = node.rect.get_width() - size.width;
+	int dh = node.rect.get_height() - size.height;
+	if (dw < 0 || dh < 0)
+		return -1;
+
+	if (dw == 0 && dh == 0)
+	{
+		node.used = true;
+		return node_index;
+	}
+
+	// Split along the axis with the most space left. Note new_node() may move the nodes
+	Rect rect = node.rect;
+	Rect rect0, rect1;
+	if (dw > dh)
+	{
+		rect0 = Rect(rect.left, rect.top, rect.left + size.width, rect.bottom);
+		rect1 = Rect(rect.left + size.width, rect.top, rect.right, rect.bottom);
+	}
+	else
+	{
+		rect0 = Rect(rect.left, rect.top, rect.right, rect.top + size.height);
+		rect1 = Rect(rect.left, rect.top + size.height, rect.right, rect.bottom);
+	}
+	int child0 = new_node(rect0, node_index);
+	int child1 = new_node(rect1, node_index);
+	nodes[node_index].child[0] = child0;
+	nodes[node_index].child[1] = child1;
+
+	return insert(child0, size);
+}
+
+int RectPackerBin_Guillotine::find(int node_index, const Rect &rect) const
+{
+	while (nodes[node_index].child[0] >= 0)
+	{
+		int child0 = nodes[node_index].child[0];
+		node_index = nodes[child0].rect.is_inside(rect) ? child0 : nodes[node_index].child[1];
+	}
+	const Node &node = nodes[node_index];
+	return (node.used && node.rect == rect) ? node_index : -1;
+}
+
+int RectPackerBin_Guillotine::new_node(const Rect &rect, int parent)
+{
+	Node node;
+	node.rect = rect;
+	node.parent = parent;
+	node.child[0] = -1;
+	node.child[1] = -1;
+	node.used = false;
+
+	if (free_nodes.empty())
+	{
+		nodes.push_back(node);
+		return (int)nodes.size() - 1;
+	}
+
+	int index = free_nodes.back();
+	free_nodes.pop_back();
+	nodes[index] = node;
+	return index;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// RectPackerBin_Skyline:
+
+RectPackerBin_Skyline::RectPackerBin_Skyline(const Rect &area) : RectPackerBin(area)
+{
+	skyline.push_back(Segment(area.left, area.top, area.get_width()));
+}
+
+bool RectPackerBin_Skyline::allocate(const Size &size, Rect &out_rect)
+{
+	// Space wasted below the skyline or freed again is used first
+	if (!waste.empty() && waste.find(size, out_rect))
+	{
+		waste.use(out_rect);
+		return true;
+	}
+
+	// Bottom-left: the position where the rect ends highest up, preferring the narrowest segment on ties
+	int best_index = -1;
+	int best_bottom = INT_MAX;
+	int best_width = INT_MAX;
+	int best_y = 0;
+	for (unsigned int i = 0; i < skyline.size(); i++)
+	{
+		int y = fit(i, size);
+		if (y < 0)
+			continue;
+
+		int bottom = y + size.height;
+		if (bottom < best_bottom || (bottom == best_bottom && skyline[i].width < best_width))
+		{
+			best_index = i;
+			best_bottom = bottom;
+			best_width = skyline[i].width;
+			best_y = y;
+		}
+	}
+
+	if (best_index < 0)
+		return false;
+
+	out_rect = Rect(skyline[best_index].x, best_y, size);
+	place(best_index, out_rect);
+	return true;
+}
+
+void RectPackerBin_Skyline::free(const Rect &rect)
+{
+	if (!lower_skyline(rect))
+		waste.add(rect);
+}
+
+int RectPackerBin_Skyline::fit(unsigned int segment_index, const Size &size) const
+{
+	// Returns the y position a rect starting at the segment would rest at, or -1 if it does not fit
+	if (skyline[segment_index].x + size.width > area.right)
+		return -1;
+
+	int width_left = size.width;
+	int y = skyline[segment_index].y;
+	for (unsigned int i = segment_index; width_left > 0; i++)
+	{
+		y = std::max(y, skyline[i].y);
+		if (y + size.height > area.bottom)
+			return -1;
+		width_left -= skyline[i].width;
+	}
+	return y;
+}
+
+void RectPackerBin_Skyline::place(unsigned int segment_index, const Rect &rect)
+{
+	// Remember the gaps between the rect and the lower segments it covers
+	for (unsigned int i = segment_index; i < skyline.size() && skyline[i].x < rect.right; i++)
+	{
+		if (skyline[i].y < rect.top)
+			waste.add(Rect(skyline[i].x, skyline[i].y, std::min(skyline[i].x + skyline[i].width, rect.right), rect.top));
+	}
+
+	skyline.insert(skyline.begin() + segment_index, Segment(rect.left, rect.bottom, rect.get_width()));
+
+	// Cut away the segments now below the rect
+	for (unsigned int i = segment_index + 1; i < skyline.size(); )
+	{
+		Segment &segment = skyline[i];
+		if (segment.x >= rect.right)
+			break;
+
+		int covered = rect.right - segment.x;
+		if (covered < segment.width)
+		{
+			segment.x += covered;
+			segment.width -= covered;
+			break;
+		}
+		skyline.erase(skyline.begin() + i);
+	}
+
+	merge_segments();
+}
+
+bool RectPackerBin_Skyline::lower_skyline(const Rect &rect)
+{
+	// A freed rect with nothing above it gives its space back to the skyline
+	for (const auto &segment : skyline)
+	{
+		if (segment.x < rect.right && segment.x + segment.width > rect.left && segment.y != rect.bottom)
+			return false;
+	}
+
+	split_segment(rect.left);
+	split_segment(rect.right);
+	for (auto &segment : skyline)
+	{
+		if (segment.x >= rect.left && segment.x < rect.right)
+			segment.y = rect.top;
+	}
+	merge_segments();
+	return true;
+}
+
+void RectPackerBin_Skyline::split_segment(int x)
+{
+	for (unsigned int i = 0; i < skyline.size(); i++)
+	{
+		Segment &segment = skyline[i];
+		if (segment.x < x && segment.x + segment.width > x)
+		{
+			Segment right(x, segment.y, segment.x + segment.width - x);
+			segment.width = x - segment.x;
+			skyline.insert(skyline.begin() + i + 1, right);
+			return;
+		}
+	}
+}
+
+void RectPackerBin_Skyline::merge_segments()
+{
+	for (unsigned int i = 1; i < skyline.size(); )
+	{
+		if (skyline[i - 1].y == skyline[i].y)
+		{
+			skyline[i - 1].width += skyline[i].width;
+			skyline.erase(skyline.begin() + i);
+		}
+		else
+		{
+			i++;
+		}
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// RectPackerBin_MaxRects:
+
+RectPackerBin_MaxRects::RectPackerBin_MaxRects(const Rect &area) : RectPackerBin(area)
+{
+	free_list.add(area);
+}
+
+bool RectPackerBin_MaxRects::allocate(const Size &size, Rect &out_rect)
+{
+	if (!free_list.find(size, out_rect))
+		return false;
+	free_list.use(out_rect);
+	return true;
+}
+
+void RectPackerBin_MaxRects::free(const Rect &rect)
+{
+	free_list.add(rect);
+}
+
+}
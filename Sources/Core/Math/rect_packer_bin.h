@@ -0,0 +1,160 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2015 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    agent
+*/
+
+#pragma once
+
+#include "API/Core/Math/rect_packer.h"
+#include <memory>
+#include <vector>
+
+namespace clan
+{
+
+/// \brief Packs rects into a single area (one group of a RectPacker or one texture of a TextureGroup)
+class RectPackerBin
+{
+public:
+	static std::unique_ptr<RectPackerBin> create(const Rect &area, RectPacker::PackingMethod method);
+	virtual ~RectPackerBin() { }
+
+	/// \brief Finds space for a rect of the given size. Returns false if the area is full
+	bool insert(const Size &size, Rect &out_rect);
+
+	/// \brief Frees a rect previously returned by insert(). Returns false if it was not allocated here
+	bool remove(const Rect &rect);
+
+	const Rect &get_area() const { return area; }
+	int get_rect_count() const { return (int)used_rects.size(); }
+
+	/// \brief Returns the allocated area divided by the total area
+	float get_occupancy() const;
+
+protected:
+	RectPackerBin(const Rect &area) : area(area), used_area(0) { }
+
+	virtual bool allocate(const Size &size, Rect &out_rect) = 0;
+	virtual void free(const Rect &rect) = 0;
+
+	Rect area;
+
+private:
+	std::vector<Rect> used_rects;
+	ubyte64 used_area;
+};
+
+/// \brief Free rectangles in the MaxRects style: every maximal free rect is kept, and they may overlap
+class RectPackerFreeList
+{
+public:
+	/// \brief Finds the free rect that leaves the shortest leftover side. Returns false if nothing fits
+	bool find(const Size &size, Rect &out_rect) const;
+
+	/// \brief Removes the rect from the free space, splitting every free rect it overlaps
+	void use(const Rect &rect);
+
+	/// \brief Adds free space, merging it with free rects it lines up with
+	void add(const Rect &rect);
+
+	bool empty() const { return free_rects.empty(); }
+
+private:
+	void prune();
+
+	std::vector<Rect> free_rects;
+	std::vector<Rect> new_rects;
+};
+
+/// \brief Binary tree of guillotine cuts, with the nodes kept in a pool
+class RectPackerBin_Guillotine : public RectPackerBin
+{
+public:
+	RectPackerBin_Guillotine(const Rect &area);
+
+protected:
+	bool allocate(const Size &size, Rect &out_rect) override;
+	void free(const Rect &rect) override;
+
+private:
+	struct Node
+	{
+		Rect rect;
+		int parent;
+		int child[2];
+		bool used;
+	};
+
+	int insert(int node_index, const Size &size);
+	int find(int node_index, const Rect &rect) const;
+	int new_node(const Rect &rect, int parent);
+
+	std::vector<Node> nodes;
+	std::vector<int> free_nodes;
+};
+
+/// \brief Skyline bottom-left, with a MaxRects waste map for the space below the skyline
+class RectPackerBin_Skyline : public RectPackerBin
+{
+public:
+	RectPackerBin_Skyline(const Rect &area);
+
+protected:
+	bool allocate(const Size &size, Rect &out_rect) override;
+	void free(const Rect &rect) override;
+
+private:
+	struct Segment
+	{
+		Segment(int x, int y, int width) : x(x), y(y), width(width) { }
+		int x, y, width;
+	};
+
+	int fit(unsigned int segment_index, const Size &size) const;
+	void place(unsigned int segment_index, const Rect &rect);
+	bool lower_skyline(const Rect &rect);
+	void split_segment(int x);
+	void merge_segments();
+
+	std::vector<Segment> skyline;
+	RectPackerFreeList waste;
+};
+
+/// \brief MaxRects with the best short side fit
+class RectPackerBin_MaxRects : public RectPackerBin
+{
+public:
+	RectPackerBin_MaxRects(const Rect &area);
+
+protected:
+	bool allocate(const Size &size, Rect &out_rect) override;
+	void free(const Rect &rect) override;
+
+private:
+	RectPackerFreeList free_list;
+};
+
+}
@@ -25,10 +25,12 @@
 **
 **    Kenneth Gangstoe
 */
-
 #pragma once
 
 #include "API/Core/Math/rect_packer.h"
+#include "rect_packer_bin.h"
+#include <memory>
+#include <vector>
 
 namespace clan
 {
@@ -36,48 +38,22 @@ namespace clan
 class RectPacker_Impl
 {
 public:
-	class Node
-	{
-	public:
-		Node();
-		Node(const Rect &rect);
-		~Node();
-
-		int get_rect_count() const;
-
-		Node *insert(const Size &rect_size, int rect_id);
-
-		void clear();
-
-		Node *child[2];
-		Rect node_rect;
-
-	    int id;
-	};
-
-	struct RootNode
-	{
-	public:
-		int group_id;
-		Node node;
-	};
-
-public:
-	RectPacker_Impl(const Size &max_group_size);
+	RectPacker_Impl(const Size &max_group_size, RectPacker::PackingMethod method);
 	~RectPacker_Impl();
 
 	int get_total_rect_count() const;
 	int get_rect_count(unsigned int group_index) const;
+	float get_occupancy(unsigned int group_index) const;
 
 	RectPacker::AllocatedRect add_new_node(const Size &rect_size);
-	RootNode *add_new_root();
-
-	std::vector<RootNode *> root_nodes;
-	RootNode *active_root_node;
+	void remove(const RectPacker::AllocatedRect &rect);
+	RectPackerBin *add_new_root();
 
-	int next_node_id;
+	std::vector<std::unique_ptr<RectPackerBin>> root_nodes;
+	int active_root_index;
 
 	RectPacker::AllocationPolicy allocation_policy;
+	RectPacker::PackingMethod packing_method;
 
 	Size max_group_size;
 };
@@ -36,6 +36,7 @@
 #include "API/Core/XML/dom_element.h"
 #include "API/Core/Text/string_format.h"
 #include "API/Core/Text/string_help.h"
+#include "API/Core/System/profiler.h"
 #include "xml_resource_document_impl.h"
 #include <map>
 
@@ -426,6 +427,7 @@ void XMLResourceDocument::load(const std::string &fullname, const FileSystem &fs
 
 void XMLResourceDocument::load(IODevice file, const std::string &base_path, const FileSystem &fs)
 {
+	cl_profile_zone("XMLResourceDocument::load");
 	DomDocument new_document;
 	new_document.load(file);
 
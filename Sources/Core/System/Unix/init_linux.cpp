@@ -42,6 +42,7 @@
 #include "init_linux.h"
 // note: this cannot be replaced by <ctime>! (timeval needs to be defined)
 #include <sys/time.h>
+#include <time.h>
 #include <sys/stat.h>
 #include "API/Core/System/setup_core.h"
 #include "API/Core/System/system.h"
@@ -91,6 +92,13 @@ ubyte64 System::get_microseconds()
 	return (ubyte64) tv.tv_sec*(ubyte64) 1000000 + (ubyte64) tv.tv_usec;
 }
 
+ubyte64 System::get_nanoseconds()
+{
+	timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ubyte64) ts.tv_sec*(ubyte64) 1000000000 + (ubyte64) ts.tv_nsec;
+}
+
 std::string System::get_exe_path()
 {
 	char exe_file[PATH_MAX];
@@ -85,6 +85,25 @@ ubyte64 System::get_microseconds()
 	return (ubyte64) (((1000000.0 * quad_part) / perf_frequency) + 0.5);
 }
 
+ubyte64 System::get_nanoseconds()
+{
+	static LARGE_INTEGER perf_frequency;
+	static bool first_time = true;
+
+	if (first_time)
+	{
+		QueryPerformanceFrequency(&perf_frequency);
+		first_time = false;
+	}
+
+	// Split the counter into whole seconds and the remainder to avoid overflowing 64 bits
+	LARGE_INTEGER perf_counter;
+	QueryPerformanceCounter(&perf_counter);
+	ubyte64 frequency = perf_frequency.QuadPart;
+	ubyte64 counter = perf_counter.QuadPart;
+	return (counter / frequency) * (ubyte64) 1000000000 + ((counter % frequency) * (ubyte64) 1000000000) / frequency;
+}
+
 std::string System::get_exe_path()
 {
 	WCHAR exe_filename[_MAX_PATH];
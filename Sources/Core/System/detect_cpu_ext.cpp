@@ -55,6 +55,9 @@ bool System::detect_cpu_extension(CPU_ExtensionX86 ext)
 
 #define __cpuid(out, infoType)\
 	asm("cpuid": "=a" ((out)[0]), "=b" ((out)[1]), "=c" ((out)[2]), "=d" ((out)[3]): "a" (infoType));
+
+#define __cpuidex(out, infoType, subLeaf)\
+	asm("cpuid": "=a" ((out)[0]), "=b" ((out)[1]), "=c" ((out)[2]), "=d" ((out)[3]): "a" (infoType), "c" (subLeaf));
 #else
 
 #define __cpuid(out, infoType) \
@@ -64,6 +67,13 @@ bool System::detect_cpu_extension(CPU_ExtensionX86 ext)
 			"popl %%ebx" \
 		: "=a" ((out)[0]), "=r" ((out)[1]), "=c" ((out)[2]), "=d" ((out)[3]): "a" (infoType));
 
+#define __cpuidex(out, infoType, subLeaf) \
+	asm volatile(	"pushl %%ebx \n" \
+			"cpuid \n" \
+			"movl %%ebx, %1 \n" \
+			"popl %%ebx" \
+		: "=a" ((out)[0]), "=r" ((out)[1]), "=c" ((out)[2]), "=d" ((out)[3]): "a" (infoType), "c" (subLeaf));
+
 #endif
 
 #endif
@@ -73,6 +83,23 @@ bool System::detect_cpu_extension(CPU_ExtensionPPC ext)
 	throw ("Congratulations, you've just been selected to code this feature!");
 }
 
+// Returns true if the OS saves the given register state (XCR0 bits) on context switches
+static bool is_os_register_state_enabled(unsigned int xcr0_mask)
+{
+	unsigned int cpuinfo[4] = {0};
+	__cpuid((int*)cpuinfo, 0x1);
+	if ((cpuinfo[2] & (1 << 27)) == 0)	// OSXSAVE
+		return false;
+
+#ifdef __GNUC__
+	unsigned int xcr0_low, xcr0_high;
+	asm("xgetbv" : "=a" (xcr0_low), "=d" (xcr0_high) : "c" (0));
+#else
+	unsigned int xcr0_low = (unsigned int)_xgetbv(0);
+#endif
+	return (xcr0_low & xcr0_mask) == xcr0_mask;
+}
+
 bool System::detect_cpu_extension(CPU_ExtensionX86 ext)
 {
 	unsigned int cpuinfo[4] = {0};
@@ -182,6 +209,38 @@ bool System::detect_cpu_extension(CPU_ExtensionX86 ext)
 		__cpuid((int*)cpuinfo, 0x80000001);
 		return ((cpuinfo[2] & (1 << 16)) != 0);
 	}
+	else if(ext == sha)
+	{
+		__cpuid((int*)cpuinfo, 0);
+		if(cpuinfo[0] < 7)
+			return false;
+
+		__cpuidex((int*)cpuinfo, 7, 0);
+		return ((cpuinfo[1] & (1 << 29)) != 0);
+	}
+	else if(ext == pclmulqdq)
+	{
+		__cpuid((int*)cpuinfo, 0x1);
+		return ((cpuinfo[2] & (1 << 1)) != 0);
+	}
+	else if(ext == avx2)
+	{
+		__cpuid((int*)cpuinfo, 0);
+		if(cpuinfo[0] < 7)
+			return false;
+
+		__cpuidex((int*)cpuinfo, 7, 0);
+		return ((cpuinfo[1] & (1 << 5)) != 0) && is_os_register_state_enabled(0x6);	// XMM and YMM state
+	}
+	else if(ext == avx512f)
+	{
+		__cpuid((int*)cpuinfo, 0);
+		if(cpuinfo[0] < 7)
+			return false;
+
+		__cpuidex((int*)cpuinfo, 7, 0);
+		return ((cpuinfo[1] & (1 << 16)) != 0) && is_os_register_state_enabled(0xe6);	// XMM, YMM, opmask and ZMM state
+	}
 	return false;
 }
 
@@ -30,6 +30,7 @@
 #include "API/Core/System/keep_alive.h"
 #include "API/Core/System/system.h"
 #include "API/Core/System/event.h"
+#include "API/Core/System/profiler.h"
 #include <algorithm>
 
 namespace clan
@@ -95,6 +96,7 @@ void KeepAlive::process(int timeout)
 		if ( ((unsigned int) wakeup_reason) < events.size())	// (Note, wakeup_reason is >=0)
 		{
             objects[wakeup_reason]->impl->wakeup_event.reset();
+			cl_profile_zone("KeepAlive::process");
 			objects[wakeup_reason]->process();
 		}
 	}
@@ -0,0 +1,443 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2015 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    agent
+*/
+
+#include "Core/precomp.h"
+#include "API/Core/System/profiler.h"
+#include "API/Core/System/system.h"
+#include "API/Core/System/mutex.h"
+#include "API/Core/System/thread_local_storage.h"
+#include "API/Core/IOData/file.h"
+#include <vector>
+#include <cstdio>
+#ifndef WIN32
+#include <pthread.h>
+#endif
+
+namespace clan
+{
+
+std::atomic<bool> Profiler::enabled(false);
+
+class ProfilerEvent
+{
+public:
+	enum Type { type_begin_zone, type_end_zone, type_gauge, type_frame };
+
+	ubyte64 time;
+	const char *name;
+	double value;
+	int type;
+};
+
+/// \brief Event slot in the ring buffer
+///
+/// The fields are atomics so a reader may load them while the owning thread overwrites the slot.
+/// Relaxed atomic loads and stores compile to plain moves, so recording costs the same as before.
+class ProfilerEventSlot
+{
+public:
+	ProfilerEventSlot() : sequence(0), time(0), name(nullptr), value(0.0), type(0) { }
+
+	std::atomic<ubyte64> sequence;	// Position + 1 of the event stored in the slot, or 0 while it is being written
+	std::atomic<ubyte64> time;
+	std::atomic<const char *> name;
+	std::atomic<double> value;
+	std::atomic<int> type;
+};
+
+/// \brief Ring buffer of the events recorded by one thread
+///
+/// Only the owning thread writes to the buffer. Each slot works as a sequence lock: the writer clears the
+/// slot's sequence, stores the event and then publishes the sequence. A reader accepts an event only if it
+/// saw the same published sequence before and after loading it, so events being overwritten are skipped.
+class ProfilerThreadBuffer
+{
+public:
+	ProfilerThreadBuffer(int size, int thread_id) : events(size), write_position(0), clear_position(0), thread_id(thread_id) { }
+
+	void record(int type, const char *name, double value)
+	{
+		ubyte64 position = write_position.load(std::memory_order_relaxed);
+		ProfilerEventSlot &slot = events[position & (events.size() - 1)];
+		slot.sequence.store(0, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		slot.time.store(System::get_nanoseconds(), std::memory_order_relaxed);
+		slot.name.store(name, std::memory_order_relaxed);
+		slot.value.store(value, std::memory_order_relaxed);
+		slot.type.store(type, std::memory_order_relaxed);
+		slot.sequence.store(position + 1, std::memory_order_release);
+		write_position.store(position + 1, std::memory_order_release);
+	}
+
+	std::vector<ProfilerEvent> get_events() const
+	{
+		ubyte64 size = events.size();
+		ubyte64 end = write_position.load(std::memory_order_acquire);
+		ubyte64 start = end > size ? end - size : 0;
+		ubyte64 cleared = clear_position.load(std::memory_order_relaxed);
+		if (start < cleared)
+			start = cleared;
+
+		std::vector<ProfilerEvent> result;
+		result.reserve((size_t) (end - start));
+		for (ubyte64 position = start; position < end; position++)
+		{
+			const ProfilerEventSlot &slot = events[position & (size - 1)];
+			if (slot.sequence.load(std::memory_order_acquire) != position + 1)
+				continue;
+
+			ProfilerEvent event;
+			event.time = slot.time.load(std::memory_order_relaxed);
+			event.name = slot.name.load(std::memory_order_relaxed);
+			event.value = slot.value.load(std::memory_order_relaxed);
+			event.type = slot.type.load(std::memory_order_relaxed);
+
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (slot.sequence.load(std::memory_order_relaxed) == position + 1)
+				result.push_back(event);
+		}
+		return result;
+	}
+
+	void clear()
+	{
+		clear_position.store(write_position.load(std::memory_order_acquire), std::memory_order_relaxed);
+	}
+
+	std::vector<ProfilerEventSlot> events;
+	std::atomic<ubyte64> write_position;
+	std::atomic<ubyte64> clear_position;
+	int thread_id;
+	std::string thread_name;	// Protected by ProfilerRegistry::mutex
+	bool thread_exited = false;	// Protected by ProfilerRegistry::mutex
+};
+
+static void cl_profiler_thread_exit(ProfilerThreadBuffer *buffer);
+
+#ifdef WIN32
+static void WINAPI cl_profiler_thread_exit_callback(void *buffer)
+{
+	if (buffer)
+		cl_profiler_thread_exit((ProfilerThreadBuffer *) buffer);
+}
+#else
+static void cl_profiler_thread_exit_callback(void *buffer)
+{
+	cl_profiler_thread_exit((ProfilerThreadBuffer *) buffer);
+}
+#endif
+
+class ProfilerRegistry
+{
+public:
+	ProfilerRegistry()
+	{
+		// The key is only used for its destructor, which tells the registry that a thread has exited
+#ifdef WIN32
+		thread_exit_index = FlsAlloc(&cl_profiler_thread_exit_callback);
+#else
+		pthread_key_create(&thread_exit_key, &cl_profiler_thread_exit_callback);
+#endif
+	}
+
+	static ProfilerRegistry &instance()
+	{
+		// Never destroyed, as threads may still exit after the static destructors have run
+		static ProfilerRegistry *registry = new ProfilerRegistry();
+		return *registry;
+	}
+
+	/// \brief Moves the buffers of exited threads to the free list (the caller must lock the mutex)
+	///
+	/// Called once their events have been exported or cleared, or when too many are waiting.
+	void recycle_exited_buffers(size_t keep_waiting)
+	{
+		size_t num_exited = 0;
+		for (auto &buffer : buffers)
+		{
+			if (buffer->thread_exited)
+				num_exited++;
+		}
+
+		for (size_t i = 0; i < buffers.size() && num_exited > keep_waiting;)
+		{
+			if (buffers[i]->thread_exited)
+			{
+				if (free_buffers.size() < max_free_buffers)
+					free_buffers.push_back(buffers[i]);
+				buffers.erase(buffers.begin() + i);
+				num_exited--;
+			}
+			else
+			{
+				i++;
+			}
+		}
+	}
+
+	Mutex mutex;
+	std::vector<std::shared_ptr<ProfilerThreadBuffer> > buffers;	// Buffers of running threads and exited threads not exported yet
+	std::vector<std::shared_ptr<ProfilerThreadBuffer> > free_buffers;	// Buffers of exited threads, ready to be claimed by new threads
+	int buffer_size = 16384;
+	int next_thread_id = 1;
+	ubyte64 start_time = System::get_nanoseconds();
+#ifdef WIN32
+	DWORD thread_exit_index;
+#else
+	pthread_key_t thread_exit_key;
+#endif
+
+	static const size_t max_exited_buffers = 64;
+	static const size_t max_free_buffers = 16;
+};
+
+static cl_tls_variable ProfilerThreadBuffer *cl_profiler_thread_buffer = nullptr;
+
+static ProfilerThreadBuffer *cl_get_profiler_thread_buffer()
+{
+	if (!cl_profiler_thread_buffer)
+	{
+		ProfilerRegistry &registry = ProfilerRegistry::instance();
+		MutexSection mutex_lock(&registry.mutex);
+
+		// Claim the buffer of a thread that has exited, if one with the current size is free
+		std::shared_ptr<ProfilerThreadBuffer> buffer;
+		while (!registry.free_buffers.empty() && !buffer)
+		{
+			if ((int) registry.free_buffers.back()->events.size() == registry.buffer_size)
+				buffer = registry.free_buffers.back();
+			registry.free_buffers.pop_back();
+		}
+
+		if (buffer)
+		{
+			buffer->clear();
+			buffer->thread_id = registry.next_thread_id++;
+			buffer->thread_name.clear();
+			buffer->thread_exited = false;
+		}
+		else
+		{
+			buffer = std::make_shared<ProfilerThreadBuffer>(registry.buffer_size, registry.next_thread_id++);
+		}
+
+		registry.buffers.push_back(buffer);
+		cl_profiler_thread_buffer = buffer.get();
+
+#ifdef WIN32
+		FlsSetValue(registry.thread_exit_index, buffer.get());
+#else
+		pthread_setspecific(registry.thread_exit_key, buffer.get());
+#endif
+	}
+	return cl_profiler_thread_buffer;
+}
+
+static void cl_profiler_thread_exit(ProfilerThreadBuffer *buffer)
+{
+	// Runs on the exiting thread. Its events are kept until they have been exported.
+	ProfilerRegistry &registry = ProfilerRegistry::instance();
+	MutexSection mutex_lock(&registry.mutex);
+	buffer->thread_exited = true;
+	registry.recycle_exited_buffers(ProfilerRegistry::max_exited_buffers);
+
+	// A destructor running later on this thread gets a new buffer
+	cl_profiler_thread_buffer = nullptr;
+}
+
+void Profiler::set_enabled(bool enable)
+{
+	enabled.store(enable, std::memory_order_relaxed);
+}
+
+void Profiler::set_buffer_size(int events_per_thread)
+{
+	int size = 16;
+	while (size < events_per_thread)
+		size <<= 1;
+
+	ProfilerRegistry &registry = ProfilerRegistry::instance();
+	MutexSection mutex_lock(&registry.mutex);
+	registry.buffer_size = size;
+}
+
+void Profiler::set_thread_name(const std::string &name)
+{
+	ProfilerThreadBuffer *buffer = cl_get_profiler_thread_buffer();
+	MutexSection mutex_lock(&ProfilerRegistry::instance().mutex);
+	buffer->thread_name = name;
+}
+
+void Profiler::begin_zone(const char *name)
+{
+	cl_get_profiler_thread_buffer()->record(ProfilerEvent::type_begin_zone, name, 0.0);
+}
+
+void Profiler::end_zone(const char *name)
+{
+	cl_get_profiler_thread_buffer()->record(ProfilerEvent::type_end_zone, name, 0.0);
+}
+
+void Profiler::set_gauge(const char *name, double value)
+{
+	if (is_enabled())
+		cl_get_profiler_thread_buffer()->record(ProfilerEvent::type_gauge, name, value);
+}
+
+void Profiler::frame_mark(const char *name)
+{
+	if (is_enabled())
+		cl_get_profiler_thread_buffer()->record(ProfilerEvent::type_frame, name, 0.0);
+}
+
+void Profiler::clear()
+{
+	ProfilerRegistry &registry = ProfilerRegistry::instance();
+	MutexSection mutex_lock(&registry.mutex);
+	for (auto &buffer : registry.buffers)
+		buffer->clear();
+	registry.recycle_exited_buffers(0);
+}
+
+static void cl_profiler_append_string(std::string &json, const char *text)
+{
+	json += '"';
+	for (const char *c = text; *c; c++)
+	{
+		switch (*c)
+		{
+		case '"': json += "\\\""; break;
+		case '\\': json += "\\\\"; break;
+		case '\n': json += "\\n"; break;
+		case '\r': json += "\\r"; break;
+		case '\t': json += "\\t"; break;
+		default:
+			if ((unsigned char) *c < 32)
+			{
+				char escaped[8];
+				snprintf(escaped, sizeof(escaped), "\\u%04x", (unsigned int) (unsigned char) *c);
+				json += escaped;
+			}
+			else
+			{
+				json += *c;
+			}
+			break;
+		}
+	}
+	json += '"';
+}
+
+static void cl_profiler_append_event(std::string &json, const char *name, const char *phase, ubyte64 time, int thread_id)
+{
+	// Chrome traces use microseconds, the fraction keeps the nanoseconds
+	char buffer[128];
+	snprintf(buffer, sizeof(buffer), ",\"ph\":\"%s\",\"pid\":1,\"tid\":%d,\"ts\":%llu.%03u", phase, thread_id, (unsigned long long) (time / 1000), (unsigned int) (time % 1000));
+	if (json.back() == '}')
+		json += ",\n";
+	json += "{\"name\":";
+	cl_profiler_append_string(json, name);
+	json += buffer;
+}
+
+std::string Profiler::get_chrome_trace()
+{
+	ProfilerRegistry &registry = ProfilerRegistry::instance();
+	MutexSection mutex_lock(&registry.mutex);
+
+	std::string json = "{\"traceEvents\":[\n";
+	char buffer[128];
+	for (auto &thread_buffer : registry.buffers)
+	{
+		int thread_id = thread_buffer->thread_id;
+		if (!thread_buffer->thread_name.empty())
+		{
+			cl_profiler_append_event(json, "thread_name", "M", 0, thread_id);
+			json += ",\"args\":{\"name\":";
+			cl_profiler_append_string(json, thread_buffer->thread_name.c_str());
+			json += "}}";
+		}
+
+		std::vector<ProfilerEvent> events = thread_buffer->get_events();
+		std::vector<const ProfilerEvent *> open_zones;
+		for (auto &event : events)
+		{
+			ubyte64 time = event.time > registry.start_time ? event.time - registry.start_time : 0;
+			switch (event.type)
+			{
+			case ProfilerEvent::type_begin_zone:
+				open_zones.push_back(&event);
+				break;
+
+			case ProfilerEvent::type_end_zone:
+				// Zones whose start has been overwritten in the ring buffer are dropped
+				if (!open_zones.empty())
+				{
+					const ProfilerEvent *begin = open_zones.back();
+					open_zones.pop_back();
+					ubyte64 begin_time = begin->time > registry.start_time ? begin->time - registry.start_time : 0;
+					ubyte64 duration = time - begin_time;
+					cl_profiler_append_event(json, begin->name, "X", begin_time, thread_id);
+					snprintf(buffer, sizeof(buffer), ",\"dur\":%llu.%03u}", (unsigned long long) (duration / 1000), (unsigned int) (duration % 1000));
+					json += buffer;
+				}
+				break;
+
+			case ProfilerEvent::type_gauge:
+				cl_profiler_append_event(json, event.name, "C", time, thread_id);
+				snprintf(buffer, sizeof(buffer), ",\"args\":{\"value\":%.15g}}", event.value);
+				json += buffer;
+				break;
+
+			case ProfilerEvent::type_frame:
+				cl_profiler_append_event(json, event.name, "i", time, thread_id);
+				json += ",\"s\":\"g\"}";
+				break;
+			}
+		}
+
+		// Zones still running are exported as begin events without an end
+		for (auto &begin : open_zones)
+		{
+			cl_profiler_append_event(json, begin->name, "B", begin->time > registry.start_time ? begin->time - registry.start_time : 0, thread_id);
+			json += "}";
+		}
+	}
+	json += "\n],\"displayTimeUnit\":\"ns\"}\n";
+
+	// The events of exited threads have been exported, so their buffers can be used by new threads
+	registry.recycle_exited_buffers(0);
+	return json;
+}
+
+void Profiler::save_chrome_trace(const std::string &filename)
+{
+	File::write_text(filename, get_chrome_trace());
+}
+
+}
@@ -34,30 +34,35 @@
 #include "API/Core/System/mutex.h"
 #include "API/Core/System/event.h"
 #include "API/Core/System/system.h"
-#include <map>
+#include "API/Core/System/profiler.h"
+#include "timer_wheel.h"
 
 namespace clan
 {
 
-class Timer_Object
+class Timer_Object : public TimerWheelEntry
 {
 public:
-	Timer_Object() : stopped(true) {}
+	Timer_Object() : end_time(0), timeout(0), repeating(false), expired(false), queued(false), removed(false) {}
 
-	bool stopped;
-	ubyte64 end_time;
-	unsigned int timeout;
+	ubyte64 end_time;	// Nanoseconds
+	ubyte64 timeout;	// Nanoseconds
 	bool repeating;
+	bool expired;	// Callback is due in the next process()
+	bool queued;	// In Timer_Thread::expired_objects
+	bool removed;	// Delete when process() reaches it
 	std::function<void()> func_expired;
 };
 
 /////////////////////////////////////////////////////////////////////////////
 // Timer_Thread Class:
 
+// The thread only keeps the wheel moving. Expired timers are collected into a batch and their callbacks
+// are invoked from KeepAlive::process on the thread that created the first timer, as before.
 class Timer_Thread : public KeepAliveObject
 {
 public:
-	Timer_Thread() : timeout(-1), stop_thread(false)
+	Timer_Thread() : start_time(System::get_nanoseconds()), wakeup_tick(TimerWheel::no_tick), stop_thread(false)
 	{
 		thread.start(this, &Timer_Thread::timer_main);
 	}
@@ -70,107 +75,137 @@ public:
 		update_event.set();
 		thread.join();
 
-		// Delete all timer objects in the map
-		for (auto & elem : timer_objects)
+		for (auto &object : expired_objects)
 		{
-			delete elem.second;
+			if (object->removed)
+				delete object;
 		}
 	}
 
-	void start(int timer_id, unsigned int new_timeout, bool repeat)
+	Timer_Object *create_timer()
+	{
+		return new Timer_Object();
+	}
+
+	void start(Timer_Object *object, ubyte64 new_timeout, bool repeat)
 	{
 		MutexSection mutex_lock(&mutex);
 
-		Timer_Object &object = get_timer_object(timer_id);
-		object.stopped = false;
-		object.end_time = System::get_time() + new_timeout;
-		object.timeout = new_timeout;
-		object.repeating = repeat;
+		object->end_time = System::get_nanoseconds() + new_timeout;
+		object->timeout = new_timeout;
+		object->repeating = repeat;
+		object->expired = false;
+
+		ubyte64 expire_tick = get_tick(object->end_time);
+		wheel.schedule(object, expire_tick);
 
-		if ( (timeout == -1) || (new_timeout < ( (unsigned int) timeout) ) )
+		if (expire_tick < wakeup_tick)
 		{
-			// Only break into the thread when a shorter timeout is required
+			// Only break into the thread when it would sleep past this timer
+			wakeup_tick = expire_tick;
 			update_event.set();
 		}
 	}
 
-	void stop(int timer_id)
+	void stop(Timer_Object *object)
 	{
 		MutexSection mutex_lock(&mutex);
-		Timer_Object &object = get_timer_object(timer_id);
-		object.stopped = true;
+		wheel.cancel(object);
+		object->expired = false;
 	}
 
-	void remove_timer(int timer_id)
+	void remove_timer(Timer_Object *object)
 	{
-		// Remove the unused timers, to prevent memory leaks
 		MutexSection mutex_lock(&mutex);
-		auto it = timer_objects.find(timer_id);
-		if (it != timer_objects.end())
-		{
-			delete it->second;
-			timer_objects.erase(it);
-		}
+		wheel.cancel(object);
+		object->expired = false;
+		if (object->queued)
+			object->removed = true;
+		else
+			delete object;
 	}
 
 	void process() override
 	{
+		cl_profile_zone("Timer::process");
 		MutexSection mutex_lock(&mutex);
 
-		ubyte64 current_time = System::get_time();
+		std::vector<Timer_Object *> objects;
+		objects.swap(expired_objects);
 
-		// Scan for events and trigger them
-		for (auto it = timer_objects.begin(); it != timer_objects.end();)
+		// The mutex is recursive, so callbacks may start, stop and destroy timers
+		for (auto &object : objects)
 		{
-			Timer_Object &object = *(it->second);
-			++it;	// We need to update the iterator here - Because func_expired may remove the timer object
-
-			// Found a timer
-			const int grace_period = 1;	// Allow 1ms grace
-			if (object.end_time <= (current_time + grace_period))
+			object->queued = false;
+			if (object->removed)
 			{
-				if (!object.stopped)
-				{
-					if (object.repeating)
-					{
-						object.end_time += object.timeout;
-						if (object.end_time <= current_time)
-						{
-							// An event has been missed, reset the timer
-							object.end_time = current_time + object.timeout;
-						}
-					}
-					else
-					{
-						object.stopped = true;
-					}
-
-					if (object.func_expired)
-						object.func_expired();
-				}
+				delete object;
+			}
+			else if (object->expired)
+			{
+				object->expired = false;
+				if (object->func_expired)
+					object->func_expired();
 			}
 		}
+
+		if (expired_objects.empty())
+		{
+			// Keep the capacity
+			objects.clear();
+			expired_objects.swap(objects);
+		}
 	}
 
-	std::function<void()> &get_func_expired(int timer_id)
+	std::function<void()> &get_func_expired(Timer_Object *object)
 	{
-		MutexSection mutex_lock(&mutex);
-		return get_timer_object(timer_id).func_expired;
+		return object->func_expired;
 	}
 
 private:
-	Timer_Object &get_timer_object(int timer_id)
+	// Ticks of the wheel are 100 microseconds on the monotonic clock
+	enum { tick_length = 100000 };
+
+	ubyte64 get_tick(ubyte64 time) const
 	{
-		// Find existing timer
-		auto it = timer_objects.find(timer_id);
-		if (it != timer_objects.end())
+		// Round up so that timers never expire early
+		return time > start_time ? (time - start_time + tick_length - 1) / tick_length : 0;
+	}
+
+	void collect_expired_timers()
+	{
+		ubyte64 current_time = System::get_nanoseconds();
+		wheel.advance((current_time - start_time) / tick_length, wheel_expired);
+		if (wheel_expired.empty())
+			return;
+
+		bool was_empty = expired_objects.empty();
+		for (auto &entry : wheel_expired)
 		{
-			return *(it->second);
+			Timer_Object *object = static_cast<Timer_Object *>(entry);
+			if (object->repeating)
+			{
+				object->end_time += object->timeout;
+				if (object->end_time <= current_time)
+				{
+					// An event has been missed, reset the timer
+					object->end_time = current_time + object->timeout;
+				}
+				wheel.schedule(object, get_tick(object->end_time));
+			}
+
+			// Timers expiring again before process() got to them only get one callback
+			object->expired = true;
+			if (!object->queued)
+			{
+				object->queued = true;
+				expired_objects.push_back(object);
+			}
 		}
+		wheel_expired.clear();
 
-		auto object = new Timer_Object;
-		timer_objects[timer_id] = object;
-		return *object;
+		if (was_empty)
+			set_wakeup_event();
 	}
 
 	void timer_main()
@@ -182,51 +217,35 @@ private:
 			if (stop_thread)
 				break;
 
-			ubyte64 current_time = System::get_time();
-			timeout = -1;
-			bool found_timer = false;
+			collect_expired_timers();
 
-			// Scan for timers to find the next one to call
-			for (auto & elem : timer_objects)
+			int timeout = -1;
+			wakeup_tick = wheel.get_next_tick();
+			if (wakeup_tick != TimerWheel::no_tick)
 			{
-				Timer_Object &object = *(elem.second);
-				if (!object.stopped)
-				{
-					if (!found_timer)
-					{
-						// First timer in the list
-						timeout = object.end_time - current_time;
-						found_timer = true;
-					}
-					else
-					{
-						// Get the smallest timeout
-						int next_timeout = object.end_time - current_time;
-						if (next_timeout < timeout)
-						{
-							timeout = next_timeout;
-						}
-					}
-					// Force update, if a timer was missed
-					if (timeout < 1)
-						timeout = 1;
-				}
+				// Event::wait has millisecond resolution, round up to the tick
+				ubyte64 wakeup_time = start_time + wakeup_tick * tick_length;
+				ubyte64 current_time = System::get_nanoseconds();
+				ubyte64 wait_time = wakeup_time > current_time ? (wakeup_time - current_time + 999999) / 1000000 : 0;
+				timeout = wait_time < 0x7fffffff ? (int) wait_time : 0x7fffffff;
 			}
 
 			mutex_lock.unlock();
 
-			if (Event::wait(update_event, timeout) == -1)
-				set_wakeup_event();
+			Event::wait(update_event, timeout);
 		}
 	}
 
 	Thread thread;
 	Event update_event;
 	Mutex mutex;
-	int timeout;
+	TimerWheel wheel;
+	ubyte64 start_time;
+	ubyte64 wakeup_tick;
 	bool stop_thread;
 
-	std::map<int, Timer_Object *> timer_objects;
+	std::vector<TimerWheelEntry *> wheel_expired;
+	std::vector<Timer_Object *> expired_objects;
 };
 
 /////////////////////////////////////////////////////////////////////////////
@@ -235,7 +254,7 @@ private:
 class Timer_Impl
 {
 public:
-	Timer_Impl() : timeout(0), repeating(false), id(-1)
+	Timer_Impl() : timeout(0), repeating(false), object(nullptr)
 	{
 		// Create a static timer thread if none exist
 		MutexSection mutex_lock(&timer_thread_mutex);
@@ -244,15 +263,14 @@ public:
 			timer_thread = new(Timer_Thread);
 		}
 		timer_thread_instance_count++;
-		timer_thread_max_id++;
-		id = timer_thread_max_id;
+		object = timer_thread->create_timer();
 	}
 
 	~Timer_Impl()
 	{
 		// Destroy the static timer thread if this is the last timer
 		MutexSection mutex_lock(&timer_thread_mutex);
-		timer_thread->remove_timer(id);
+		timer_thread->remove_timer(object);
 		timer_thread_instance_count--;
 		if (!timer_thread_instance_count)
 		{
@@ -261,16 +279,18 @@ public:
 		}
 	}
 
-	void start(unsigned int new_timeout, bool repeat)
+	void start(ubyte64 new_timeout, bool repeat)
 	{
+		timeout = (unsigned int) (new_timeout / 1000000);
+		repeating = repeat;
 		MutexSection mutex_lock(&timer_thread_mutex);
-		timer_thread->start(id, new_timeout, repeat);
+		timer_thread->start(object, new_timeout, repeat);
 	}
 
 	void stop()
 	{
 		MutexSection mutex_lock(&timer_thread_mutex);
-		timer_thread->stop(id);
+		timer_thread->stop(object);
 	}
 
 	bool is_repeating() const { return repeating; }
@@ -279,24 +299,22 @@ public:
 	std::function<void()> &func_expired()
 	{
 		MutexSection mutex_lock(&timer_thread_mutex);
-		return timer_thread->get_func_expired(id);
+		return timer_thread->get_func_expired(object);
 	}
 
 private:
 	static Timer_Thread *timer_thread;
 	static int timer_thread_instance_count;
 	static Mutex timer_thread_mutex;
-	static int timer_thread_max_id;	// Unique timer id
 
 	unsigned int timeout;
 	bool repeating;
-	int id;
+	Timer_Object *object;
 };
 
 Timer_Thread *Timer_Impl::timer_thread = nullptr;
 int Timer_Impl::timer_thread_instance_count = 0;
 Mutex Timer_Impl::timer_thread_mutex;
-int Timer_Impl::timer_thread_max_id = 0;
 
 /////////////////////////////////////////////////////////////////////////////
 // Timer Construction:
@@ -333,7 +351,12 @@ std::function<void()> &Timer::func_expired()
 
 void Timer::start(unsigned int timeout, bool repeat)
 {
-	impl->start(timeout, repeat);
+	impl->start(((ubyte64) timeout) * 1000000, repeat);
+}
+
+void Timer::start_microseconds(ubyte64 timeout, bool repeat)
+{
+	impl->start(timeout * 1000, repeat);
 }
 
 void Timer::stop()
@@ -0,0 +1,234 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2015 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    agent
+*/
+
+#include "Core/precomp.h"
+#include "timer_wheel.h"
+#include <cstring>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace clan
+{
+
+static inline int cl_find_lowest_bit(ubyte64 value)
+{
+#ifdef _MSC_VER
+	unsigned long index;
+#ifdef _WIN64
+	_BitScanForward64(&index, value);
+#else
+	if (_BitScanForward(&index, (unsigned long) value) == 0)
+	{
+		_BitScanForward(&index, (unsigned long) (value >> 32));
+		index += 32;
+	}
+#endif
+	return (int) index;
+#else
+	return __builtin_ctzll(value);
+#endif
+}
+
+TimerWheel::TimerWheel() : current_tick(0), count(0)
+{
+	for (int level = 0; level < num_levels; level++)
+	{
+		for (int slot = 0; slot < num_slots; slot++)
+		{
+			slots[level][slot].prev = &slots[level][slot];
+			slots[level][slot].next = &slots[level][slot];
+		}
+	}
+	memset(occupied, 0, sizeof(occupied));
+}
+
+void TimerWheel::schedule(TimerWheelEntry *entry, ubyte64 expire_tick)
+{
+	if (entry->is_scheduled())
+		unlink(entry);
+	else
+		count++;
+
+	entry->expire_tick = expire_tick > current_tick ? expire_tick : current_tick + 1;
+	insert(entry);
+}
+
+void TimerWheel::cancel(TimerWheelEntry *entry)
+{
+	if (entry->is_scheduled())
+	{
+		unlink(entry);
+		entry->prev = nullptr;
+		entry->next = nullptr;
+		count--;
+	}
+}
+
+void TimerWheel::advance(ubyte64 tick, std::vector<TimerWheelEntry *> &out_expired)
+{
+	while (current_tick < tick)
+	{
+		// Nothing happens before the next tick, so the ticks in between can be skipped
+		ubyte64 next_tick = get_next_tick();
+		if (next_tick > tick)
+		{
+			current_tick = tick;
+			break;
+		}
+		current_tick = next_tick > current_tick ? next_tick : current_tick + 1;
+		process_tick(out_expired);
+	}
+}
+
+ubyte64 TimerWheel::get_next_tick() const
+{
+	if (count == 0)
+		return no_tick;
+
+	for (int level = 0; level < num_levels; level++)
+	{
+		int shift = level * level_bits;
+		int digit = (int) ((current_tick >> shift) & slot_mask);
+		ubyte64 rotation_start = (current_tick >> (shift + level_bits)) << (shift + level_bits);
+
+		// The slots after the current one are reached in this rotation of the level
+		int slot = find_occupied_slot(level, digit + 1);
+		if (slot != num_slots)
+			return rotation_start + (((ubyte64) slot) << shift);
+
+		// The others are reached in the next rotation, after the level above has been moved down
+		if (!is_level_empty(level))
+			return rotation_start + (((ubyte64) 1) << (shift + level_bits));
+	}
+	return current_tick + 1;
+}
+
+void TimerWheel::insert(TimerWheelEntry *entry)
+{
+	ubyte64 delta = entry->expire_tick - current_tick;
+	ubyte64 expire_tick = entry->expire_tick;
+
+	int level = 0;
+	while (level < num_levels - 1 && delta >= (((ubyte64) 1) << ((level + 1) * level_bits)))
+		level++;
+
+	ubyte64 top_range = ((ubyte64) 1) << (num_levels * level_bits);
+	if (delta >= top_range)
+		expire_tick = current_tick + top_range - 1;
+
+	int slot = (int) ((expire_tick >> (level * level_bits)) & slot_mask);
+	TimerWheelEntry *head = &slots[level][slot];
+	entry->next = head;
+	entry->prev = head->prev;
+	head->prev->next = entry;
+	head->prev = entry;
+	entry->wheel_slot = level * num_slots + slot;
+	occupied[level][slot / 64] |= ((ubyte64) 1) << (slot % 64);
+}
+
+void TimerWheel::unlink(TimerWheelEntry *entry)
+{
+	entry->prev->next = entry->next;
+	entry->next->prev = entry->prev;
+
+	int level = entry->wheel_slot / num_slots;
+	int slot = entry->wheel_slot % num_slots;
+	TimerWheelEntry *head = &slots[level][slot];
+	if (head->next == head)
+		occupied[level][slot / 64] &= ~(((ubyte64) 1) << (slot % 64));
+}
+
+void TimerWheel::process_tick(std::vector<TimerWheelEntry *> &out_expired)
+{
+	// Move the higher level slots reached by this tick down, starting with the lowest level
+	for (int level = 1; level < num_levels; level++)
+	{
+		if ((current_tick & ((((ubyte64) 1) << (level * level_bits)) - 1)) != 0)
+			break;
+		cascade(level, (int) ((current_tick >> (level * level_bits)) & slot_mask), out_expired);
+	}
+
+	cascade(0, (int) (current_tick & slot_mask), out_expired);
+}
+
+void TimerWheel::cascade(int level, int slot, std::vector<TimerWheelEntry *> &out_expired)
+{
+	TimerWheelEntry *head = &slots[level][slot];
+	if (head->next == head)
+		return;
+
+	// Detach the whole list first, as entries may be placed in this slot again
+	TimerWheelEntry *entry = head->next;
+	head->prev->next = nullptr;
+	head->next = head;
+	head->prev = head;
+	occupied[level][slot / 64] &= ~(((ubyte64) 1) << (slot % 64));
+
+	while (entry)
+	{
+		TimerWheelEntry *next = entry->next;
+		if (entry->expire_tick <= current_tick)
+		{
+			entry->prev = nullptr;
+			entry->next = nullptr;
+			count--;
+			out_expired.push_back(entry);
+		}
+		else
+		{
+			insert(entry);
+		}
+		entry = next;
+	}
+}
+
+int TimerWheel::find_occupied_slot(int level, int first_slot) const
+{
+	for (int word = first_slot / 64; word < bitmask_words; word++)
+	{
+		ubyte64 bits = occupied[level][word];
+		if (word == first_slot / 64)
+			bits &= ~((ubyte64) 0) << (first_slot % 64);
+		if (bits)
+			return word * 64 + cl_find_lowest_bit(bits);
+	}
+	return num_slots;
+}
+
+bool TimerWheel::is_level_empty(int level) const
+{
+	for (int word = 0; word < bitmask_words; word++)
+	{
+		if (occupied[level][word])
+			return false;
+	}
+	return true;
+}
+
+}
@@ -0,0 +1,106 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2015 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    agent
+*/
+
+#pragma once
+
+#include "API/Core/System/cl_platform.h"
+#include <vector>
+
+namespace clan
+{
+
+/// \brief Link of an entry in a TimerWheel slot
+class TimerWheelEntry
+{
+public:
+	TimerWheelEntry() : prev(nullptr), next(nullptr), expire_tick(0), wheel_slot(0) { }
+
+	bool is_scheduled() const { return next != nullptr; }
+
+	TimerWheelEntry *prev;
+	TimerWheelEntry *next;
+	ubyte64 expire_tick;
+	int wheel_slot;	// level * 256 + slot, so unlinking can update the occupancy bits
+};
+
+/// \brief Hashed hierarchical timer wheel
+///
+/// Four levels of 256 slots. Level 0 holds the entries due within 256 ticks, one slot per tick. Each higher level
+/// covers 256 times the range of the level below, and its slots are moved down a level when the ticks reach them.
+/// Entries beyond the range of the top level wait in the slot at the end of its range and are placed again from there.
+///
+/// Scheduling and cancelling are O(1). Slot occupancy is kept in bitmasks so empty ticks are skipped.
+class TimerWheel
+{
+public:
+	TimerWheel();
+
+	/// \brief Returns the last tick processed
+	ubyte64 get_current_tick() const { return current_tick; }
+
+	/// \brief Returns the number of scheduled entries
+	int get_count() const { return count; }
+
+	/// \brief Schedules an entry. Entries due at or before the current tick expire on the next tick.
+	void schedule(TimerWheelEntry *entry, ubyte64 expire_tick);
+
+	/// \brief Removes a scheduled entry
+	void cancel(TimerWheelEntry *entry);
+
+	/// \brief Processes all ticks up to and including tick, appending the entries that expired
+	void advance(ubyte64 tick, std::vector<TimerWheelEntry *> &out_expired);
+
+	/// \brief Returns the earliest tick at which advance has work to do, or no_tick if nothing is scheduled
+	ubyte64 get_next_tick() const;
+
+	static const ubyte64 no_tick = ~(ubyte64) 0;
+
+private:
+	enum
+	{
+		level_bits = 8,
+		num_slots = 1 << level_bits,
+		slot_mask = num_slots - 1,
+		num_levels = 4,
+		bitmask_words = num_slots / 64
+	};
+
+	void insert(TimerWheelEntry *entry);
+	void unlink(TimerWheelEntry *entry);
+	void process_tick(std::vector<TimerWheelEntry *> &out_expired);
+	void cascade(int level, int slot, std::vector<TimerWheelEntry *> &out_expired);
+	int find_occupied_slot(int level, int first_slot) const;
+	bool is_level_empty(int level) const;
+
+	TimerWheelEntry slots[num_levels][num_slots];
+	ubyte64 occupied[num_levels][bitmask_words];
+	ubyte64 current_tick;
+	int count;
+};
+
+}
@@ -34,12 +34,15 @@
 #include "API/Core/System/thread.h"
 #include "API/Core/System/system.h"
 #include "API/Core/System/interlocked_variable.h"
+#include "API/Core/System/profiler.h"
 #include <algorithm>
 #include "API/Core/Math/cl_math.h"
 
 namespace clan
 {
 
+static ProfilerCounter cl_work_queue_items("WorkQueue items");
+
 class WorkItemProcess : public WorkItem
 {
 public:
@@ -151,6 +154,7 @@ void WorkQueue_Impl::queue(WorkItem *item) // transfers ownership
 	queued_items.push_back(item);
 	items_queued.increment();
 	mutex_lock.unlock();
+	cl_work_queue_items.add(1);
 	work_available_event.set();
 }
 
@@ -160,11 +164,13 @@ void WorkQueue_Impl::work_completed(WorkItem *item) // transfers ownership
 	finished_items.push_back(item);
 	items_queued.increment();
 	mutex_lock.unlock();
+	cl_work_queue_items.add(1);
 	set_wakeup_event();
 }
 
 void WorkQueue_Impl::process()
 {
+	cl_profile_zone("WorkQueue::work_completed");
 	MutexSection mutex_lock(&mutex);
 	std::vector<WorkItem *> items;
 	items.swap(finished_items);
@@ -183,11 +189,13 @@ void WorkQueue_Impl::process()
 		}
 		delete items[i];
 		items_queued.decrement();
+		cl_work_queue_items.add(-1);
 	}
 }
 
 void WorkQueue_Impl::worker_main()
 {
+	Profiler::set_thread_name("WorkQueue worker");
 	while (true)
 	{
 		int wakeup_reason = Event::wait(stop_event, work_available_event);
@@ -199,7 +207,10 @@ void WorkQueue_Impl::worker_main()
 			WorkItem *item = queued_items.front();
 			queued_items.erase(queued_items.begin());
 			mutex_lock.unlock();
-			item->process_work();
+			{
+				cl_profile_zone("WorkQueue::process_work");
+				item->process_work();
+			}
 			mutex_lock.lock();
 			finished_items.push_back(item);
 			mutex_lock.unlock();
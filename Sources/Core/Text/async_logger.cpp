@@ -0,0 +1,444 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2015 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    agent
+*/
+
+#include "Core/precomp.h"
+#include "API/Core/Text/async_logger.h"
+#include "API/Core/IOData/file.h"
+#include "API/Core/System/datetime.h"
+#include "API/Core/System/event.h"
+#include "API/Core/System/exception.h"
+#include "API/Core/System/thread.h"
+#include "API/Core/System/thread_local_storage.h"
+#include "API/Core/System/profiler.h"
+#include <atomic>
+#include <thread>
+#include <ctime>
+#include <cstdio>
+
+namespace clan
+{
+
+class AsyncLogRecord
+{
+public:
+	std::atomic<ubyte64> sequence;
+	time_t time;
+	std::string type;
+	std::string text;
+};
+
+/// \brief Bounded queue of log records with a single reader
+///
+/// Each thread normally has a queue of its own. Threads beyond the number of queues share them, so writing
+/// claims a slot with a compare and swap rather than assuming a single writer. The strings in a slot keep
+/// their capacity once the writer has consumed them, so a warmed up queue does not allocate.
+class AsyncLogQueue
+{
+public:
+	AsyncLogQueue(int size) : records(new AsyncLogRecord[size]), size(size), enqueue_position(0), dequeue_position(0)
+	{
+		for (int i = 0; i < size; i++)
+			records[i].sequence.store(i, std::memory_order_relaxed);
+	}
+
+	/// \brief Queues a record, returning false if the queue is full
+	bool push(time_t time, const std::string &type, const std::string &text, bool &half_full)
+	{
+		ubyte64 position = enqueue_position.load(std::memory_order_relaxed);
+		AsyncLogRecord *record;
+		while (true)
+		{
+			record = &records[position & (size - 1)];
+			ubyte64 sequence = record->sequence.load(std::memory_order_acquire);
+			if (sequence == position)
+			{
+				if (enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+					break;
+			}
+			else if (sequence < position)
+			{
+				return false;
+			}
+			else
+			{
+				position = enqueue_position.load(std::memory_order_relaxed);
+			}
+		}
+
+		record->time = time;
+		record->type.assign(type);
+		record->text.assign(text);
+		record->sequence.store(position + 1, std::memory_order_release);
+
+		half_full = (position - dequeue_position.load(std::memory_order_relaxed) == size / 2);
+		return true;
+	}
+
+	/// \brief Returns the oldest record, or null if the queue is empty
+	const AsyncLogRecord *front() const
+	{
+		ubyte64 position = dequeue_position.load(std::memory_order_relaxed);
+		const AsyncLogRecord *record = &records[position & (size - 1)];
+		if (record->sequence.load(std::memory_order_acquire) != position + 1)
+			return nullptr;
+		return record;
+	}
+
+	/// \brief Releases the record returned by front
+	void pop()
+	{
+		ubyte64 position = dequeue_position.load(std::memory_order_relaxed);
+		records[position & (size - 1)].sequence.store(position + size, std::memory_order_release);
+		dequeue_position.store(position + 1, std::memory_order_relaxed);
+	}
+
+private:
+	std::unique_ptr<AsyncLogRecord[]> records;
+	ubyte64 size;
+	std::atomic<ubyte64> enqueue_position;
+	std::atomic<ubyte64> dequeue_position;
+};
+
+class AsyncLogger_Impl
+{
+public:
+	AsyncLogger_Impl(IODevice device, AsyncLogger::OverflowPolicy policy, int queue_size, int flush_interval);
+	~AsyncLogger_Impl();
+
+	void log(const std::string &type, const std::string &text);
+	void flush();
+
+	std::atomic<int> dropped_count;
+	int registry_slot;
+
+private:
+	void writer_main();
+	void write_records();
+	void append_record(time_t time, const std::string &type, const std::string &text);
+	void write_output();
+
+	enum { num_queues = 16, write_size = 64 * 1024 };
+
+	std::unique_ptr<AsyncLogQueue> queues[num_queues];
+	IODevice device;
+	AsyncLogger::OverflowPolicy policy;
+	int flush_interval;
+
+	Thread thread;
+	Event stop_event, wakeup_event, flushed_event;
+	std::atomic<int> flush_requested, flush_completed;
+
+	std::string output;
+	int dropped_reported;
+	byte64 unix_epoch_ticks;
+	time_t cached_time;
+	char cached_timestamp[64];
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// Lock free registry of the enabled async loggers, used by log_event:
+
+static const int cl_max_async_loggers = 8;
+static std::atomic<AsyncLogger_Impl *> cl_async_loggers[cl_max_async_loggers];
+static std::atomic<int> cl_async_logger_count(0);
+static Mutex cl_async_logger_mutex;
+
+// log_event announces itself in the reader count of the current epoch. Disabling a logger removes it from
+// the registry and then waits for the readers of both epochs in turn, so it never waits for readers that
+// started after the removal.
+static std::atomic<unsigned int> cl_async_logger_epoch(0);
+static std::atomic<int> cl_async_logger_readers[2];
+
+static cl_tls_variable int cl_async_logger_queue_index = -1;
+static std::atomic<int> cl_async_logger_next_queue_index(0);
+
+class AsyncLoggerReadSection
+{
+public:
+	AsyncLoggerReadSection() : phase(cl_async_logger_epoch.load() & 1) { cl_async_logger_readers[phase].fetch_add(1); }
+	~AsyncLoggerReadSection() { cl_async_logger_readers[phase].fetch_sub(1); }
+
+private:
+	unsigned int phase;
+};
+
+void cl_log_event_async(const std::string &type, const std::string &text)
+{
+	if (cl_async_logger_count.load(std::memory_order_acquire) == 0)
+		return;
+
+	AsyncLoggerReadSection read_section;
+	for (auto &slot : cl_async_loggers)
+	{
+		AsyncLogger_Impl *impl = slot.load();
+		if (impl)
+			impl->log(type, text);
+	}
+}
+
+static void cl_wait_for_async_logger_readers()
+{
+	for (int i = 0; i < 2; i++)
+	{
+		unsigned int phase = cl_async_logger_epoch.fetch_add(1) & 1;
+		while (cl_async_logger_readers[phase].load() != 0)
+			std::this_thread::yield();
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// AsyncLogger Construction:
+
+AsyncLogger::AsyncLogger(const std::string &filename, OverflowPolicy policy, int queue_size, int flush_interval)
+{
+	File file(filename, File::open_always, File::access_write);
+	file.seek(0, File::seek_end);
+	impl = std::make_shared<AsyncLogger_Impl>(file, policy, queue_size, flush_interval);
+
+	// The Logger constructor put us in the locked list
+	Logger::disable();
+	enable();
+}
+
+AsyncLogger::AsyncLogger(IODevice device, OverflowPolicy policy, int queue_size, int flush_interval)
+	: impl(std::make_shared<AsyncLogger_Impl>(device, policy, queue_size, flush_interval))
+{
+	Logger::disable();
+	enable();
+}
+
+AsyncLogger::~AsyncLogger()
+{
+	disable();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// AsyncLogger Attributes:
+
+int AsyncLogger::get_dropped_count() const
+{
+	return impl->dropped_count.load();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// AsyncLogger Operations:
+
+void AsyncLogger::enable()
+{
+	MutexSection mutex_lock(&cl_async_logger_mutex);
+	if (impl->registry_slot != -1)
+		return;
+
+	for (int i = 0; i < cl_max_async_loggers; i++)
+	{
+		if (!cl_async_loggers[i].load())
+		{
+			impl->registry_slot = i;
+			cl_async_loggers[i].store(impl.get());
+			cl_async_logger_count.fetch_add(1);
+			return;
+		}
+	}
+	mutex_lock.unlock();
+
+	// All slots are in use. Still works, but log_event has to take Logger::mutex for us.
+	Logger::enable();
+}
+
+void AsyncLogger::disable()
+{
+	Logger::disable();
+
+	MutexSection mutex_lock(&cl_async_logger_mutex);
+	if (impl->registry_slot == -1)
+		return;
+
+	cl_async_loggers[impl->registry_slot].store(nullptr);
+	cl_async_logger_count.fetch_sub(1);
+	impl->registry_slot = -1;
+	cl_wait_for_async_logger_readers();
+}
+
+void AsyncLogger::log(const std::string &type, const std::string &text)
+{
+	impl->log(type, text);
+}
+
+void AsyncLogger::flush()
+{
+	impl->flush();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// AsyncLogger_Impl Implementation:
+
+AsyncLogger_Impl::AsyncLogger_Impl(IODevice device, AsyncLogger::OverflowPolicy policy, int queue_size, int flush_interval)
+	: dropped_count(0), registry_slot(-1), device(device), policy(policy), flush_interval(flush_interval), flush_requested(0), flush_completed(0),
+	dropped_reported(0), unix_epoch_ticks(DateTime(1970, 1, 1).to_ticks()), cached_time(-1)
+{
+	int size = 2;
+	while (size < queue_size)
+		size <<= 1;
+	for (auto &queue : queues)
+		queue.reset(new AsyncLogQueue(size));
+
+	output.reserve(write_size * 2);
+	thread.start(this, &AsyncLogger_Impl::writer_main);
+}
+
+AsyncLogger_Impl::~AsyncLogger_Impl()
+{
+	stop_event.set();
+	thread.join();
+}
+
+void AsyncLogger_Impl::log(const std::string &type, const std::string &text)
+{
+	if (cl_async_logger_queue_index == -1)
+		cl_async_logger_queue_index = cl_async_logger_next_queue_index.fetch_add(1) % num_queues;
+	AsyncLogQueue *queue = queues[cl_async_logger_queue_index].get();
+
+	time_t now = time(nullptr);
+	bool half_full = false;
+	while (!queue->push(now, type, text, half_full))
+	{
+		if (policy == AsyncLogger::overflow_drop)
+		{
+			dropped_count.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		wakeup_event.set();
+		std::this_thread::yield();
+	}
+
+	// Writing early keeps the queue from overflowing without signalling the writer for every record
+	if (half_full)
+		wakeup_event.set();
+}
+
+void AsyncLogger_Impl::flush()
+{
+	int request = flush_requested.fetch_add(1) + 1;
+	wakeup_event.set();
+	while (true)
+	{
+		flushed_event.reset();
+		if (flush_completed.load() - request >= 0)
+			break;
+		flushed_event.wait(flush_interval);
+	}
+}
+
+void AsyncLogger_Impl::writer_main()
+{
+	Profiler::set_thread_name("AsyncLogger");
+	while (true)
+	{
+		int wakeup_reason = Event::wait(stop_event, wakeup_event, flush_interval);
+		wakeup_event.reset();
+
+		int request = flush_requested.load();
+		write_records();
+		flush_completed.store(request);
+		flushed_event.set();
+
+		if (wakeup_reason == 0)
+			break;
+	}
+}
+
+void AsyncLogger_Impl::write_records()
+{
+	cl_profile_zone("AsyncLogger::write_records");
+
+	for (auto &queue : queues)
+	{
+		while (const AsyncLogRecord *record = queue->front())
+		{
+			append_record(record->time, record->type, record->text);
+			queue->pop();
+			if (output.size() >= write_size)
+				write_output();
+		}
+	}
+
+	int dropped = dropped_count.load(std::memory_order_relaxed);
+	if (dropped != dropped_reported)
+	{
+		char text[64];
+		snprintf(text, sizeof(text), "%d records dropped, the log queue was full", dropped - dropped_reported);
+		append_record(time(nullptr), "log", text);
+		dropped_reported = dropped;
+	}
+
+	write_output();
+}
+
+void AsyncLogger_Impl::append_record(time_t time, const std::string &type, const std::string &text)
+{
+	// Same layout as Logger::get_log_string. The date only changes once a second, so it is formatted once per second.
+	if (time != cached_time)
+	{
+		static const char *months[] = { "Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec" };
+		static const char *days[] = { "Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat" };
+
+		DateTime cur_time = DateTime::get_utc_time_from_ticks(unix_epoch_ticks + ((byte64) time) * 10000000);
+		snprintf(cached_timestamp, sizeof(cached_timestamp), "%s %s %d %02d:%02d:%02d %d UTC [",
+			days[cur_time.get_day_of_week()], months[cur_time.get_month() - 1], cur_time.get_day(),
+			cur_time.get_hour(), cur_time.get_minutes(), cur_time.get_seconds(), cur_time.get_year());
+		cached_time = time;
+	}
+
+	output.append(cached_timestamp);
+	output.append(type);
+	output.append("] ", 2);
+	output.append(text);
+#ifdef WIN32
+	output.append("\r\n", 2);
+#else
+	output.append("\n", 1);
+#endif
+}
+
+void AsyncLogger_Impl::write_output()
+{
+	if (output.empty())
+		return;
+
+	try
+	{
+		device.write(output.data(), (int) output.size());
+	}
+	catch (const Exception &)
+	{
+		// Nowhere to report it. Drop the block rather than stopping the writer.
+	}
+	output.clear();
+}
+
+}
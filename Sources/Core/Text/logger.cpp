@@ -31,10 +31,16 @@
 #include "API/Core/Text/logger.h"
 #include "API/Core/Text/string_format.h"
 #include <algorithm>
+#include <atomic>
 
 namespace clan
 {
 
+void cl_log_event_async(const std::string &type, const std::string &text);
+
+// Number of loggers in Logger::instances, so log_event can skip the mutex when only async loggers are enabled
+static std::atomic<int> cl_logger_instance_count(0);
+
 /////////////////////////////////////////////////////////////////////////////
 // Logger Construction:
 
@@ -62,7 +68,10 @@ void Logger::enable()
 {
 	MutexSection mutex_lock(&Logger::mutex);
 	if (std::find(instances.begin(), instances.end(), this) == instances.end())
+	{
 		instances.push_back(this);
+		cl_logger_instance_count.store((int) instances.size());
+	}
 }
 
 void Logger::disable()
@@ -70,12 +79,15 @@ void Logger::disable()
 	MutexSection mutex_lock(&Logger::mutex);
 	auto il = std::find(instances.begin(), instances.end(), this);
 	if(il != instances.end())
+	{
 		instances.erase(il);
+		cl_logger_instance_count.store((int) instances.size());
+	}
 }
 
 StringFormat Logger::get_log_string(const std::string &type, const std::string &text)
 {
-	std::string months[] =
+	static const char *months[] =
 	{
 		"Jan",
 		"Feb",
@@ -91,7 +103,7 @@ StringFormat Logger::get_log_string(const std::string &type, const std::string &
 		"Dec"
 	};
 
-	std::string days[] =
+	static const char *days[] =
 	{
 		"Sun",
 		"Mon",
@@ -125,6 +137,11 @@ StringFormat Logger::get_log_string(const std::string &type, const std::string &
 
 void log_event(const std::string &type, const std::string &text)
 {
+	cl_log_event_async(type, text);
+
+	if (cl_logger_instance_count.load() == 0)
+		return;
+
 	MutexSection mutex_lock(&Logger::mutex);
 	if (Logger::instances.empty())
 		return;
@@ -32,6 +32,7 @@
 #include "API/Core/IOData/file.h"
 #include "API/Core/IOData/iodevice_memory.h"
 #include "API/Core/IOData/path_help.h"
+#include "API/Core/IOData/directory.h"
 #include "API/Core/Text/string_format.h"
 #include "API/Core/Text/string_help.h"
 #include "API/Core/System/mutex.h"
@@ -44,6 +45,7 @@
 #include "zip_iodevice_fileentry.h"
 #include "zip_compression_method.h"
 #include "zip_digital_signature.h"
+#include "Core/IOData/iodevice_provider_file_mapping.h"
 #include <ctime>
 
 namespace clan
@@ -57,10 +59,24 @@ ZipArchive::ZipArchive()
 {
 }
 	
-ZipArchive::ZipArchive(const std::string &filename)
+ZipArchive::ZipArchive(const std::string &filename, bool memory_mapped)
 : impl(std::make_shared<ZipArchive_Impl>())
 {
-	IODevice input = File(filename);
+	IODevice input;
+	if (memory_mapped)
+	{
+		try
+		{
+			input = File(filename, File::open_existing, File::access_read, File::share_all, File::flag_memory_mapped | File::flag_random_access);
+			impl->mapped_filename = PathHelp::make_absolute(Directory::get_current(), filename);
+		}
+		catch (const Exception &)
+		{
+			// Archives that cannot be mapped (too large, unsupported file system) are read with system calls instead
+		}
+	}
+	if (input.is_null())
+		input = File(filename);
 	impl->input = input;
 	load(input);
 }
@@ -168,6 +184,23 @@ IODevice ZipArchive::open_file(const std::string &filename)
 			case ZipFileEntry_Impl::type_file:
 			{
 				IODevice dupe = impl->input.duplicate();
+
+				// Stored entries of a memory mapped archive are read straight from the mapping
+				IODeviceProvider_FileMapping *mapping_provider = dynamic_cast<IODeviceProvider_FileMapping*>(dupe.get_provider());
+				if (mapping_provider)
+				{
+					dupe.seek(entry.impl->record.relative_offset_of_local_header, IODevice::seek_set);
+					ZipLocalFileHeader local_header;
+					local_header.load(dupe);
+					if (local_header.compression_method == zip_compress_store && (local_header.general_purpose_bit_flag & ZIP_ENCRYPTED) == 0)
+					{
+						size_t data_offset = mapping_provider->get_offset() + dupe.get_position();
+						int data_size = (int) entry.get_uncompressed_size();
+						mapping_provider->get_mapping()->advise(data_offset, data_size, File::flag_sequential_scan | File::flag_will_need);
+						return IODevice(new IODeviceProvider_FileMapping(mapping_provider->get_mapping(), data_offset, data_size));
+					}
+				}
+
 				return IODevice(new ZipIODevice_FileEntry(dupe, entry));
 			}
 
@@ -212,6 +245,10 @@ void ZipArchive::save()
 
 void ZipArchive::save(const std::string &filename)
 {
+	// Truncating the mapped archive would leave the loaded entries pointing past the end of the file
+	if (!impl->mapped_filename.empty() && ZipArchive_Impl::is_same_path(impl->mapped_filename, PathHelp::make_absolute(Directory::get_current(), filename)))
+		throw Exception(string_format("Unable to save zip archive %1. It is memory mapped by this archive", filename));
+
 	File output(filename, File::create_always, File::access_read_write);
 
 	std::vector<int> local_header_offsets;
@@ -386,6 +423,15 @@ void ZipArchive::load(IODevice &input)
 /////////////////////////////////////////////////////////////////////////////
 // ZipArchive implementation:
 
+bool ZipArchive_Impl::is_same_path(const std::string &path1, const std::string &path2)
+{
+#ifdef WIN32
+	return StringHelp::compare(path1, path2, true) == 0;
+#else
+	return path1 == path2;
+#endif
+}
+
 void ZipArchive_Impl::calc_time_and_date(byte16 &out_date, byte16 &out_time)
 {
 	ubyte32 day_of_month = 0;
@@ -52,6 +52,8 @@ public:
 
 	IODevice input;
 
+	/// \brief Absolute path of the archive if it was loaded memory mapped, empty otherwise
+	std::string mapped_filename;
 
 /// \}
 /// \name Operations
@@ -62,6 +64,8 @@ public:
 
 	static void calc_time_and_date(byte16 &out_date, byte16 &out_time);
 
+	static bool is_same_path(const std::string &path1, const std::string &path2);
+
 
 /// \}
 /// \name Implementation
@@ -32,10 +32,13 @@
 #include "API/Display/Render/render_batcher.h"
 #include "API/Display/Render/shared_gc_data.h"
 #include "API/Display/TargetProviders/graphic_context_provider.h"
+#include "API/Core/System/profiler.h"
 
 namespace clan
 {
 
+static ProfilerCounter cl_canvas_batch_flushes("Canvas batch flushes");
+
 class CanvasBatcher_Impl
 {
 public:
@@ -114,6 +117,8 @@ void CanvasBatcher_Impl::flush()
 {
 	if (active_batcher)
 	{
+		cl_profile_zone("CanvasBatcher::flush");
+		cl_canvas_batch_flushes.add(1);
 		RenderBatcher *batcher = active_batcher;
 		active_batcher = nullptr;
 		batcher->flush(current_gc);
@@ -42,38 +42,12 @@
 #include "render_batch_triangle.h"
 #include "../Render/graphic_context_impl.h"
 #include "canvas_impl.h"
+#include "image_impl.h"
 #include "API/Display/Resources/display_cache.h"
 
 namespace clan
 {
 
-class Image_Impl
-{
-public:
-	Image_Impl() :
-		color(1.0f, 1.0f, 1.0f, 1.0f),
-		scale_x(1.0f),
-		scale_y(1.0f),
-		translation_hotspot(0,0),
-		translated_hotspot(0,0),
-		translation_origin(origin_top_left) {};
-	~Image_Impl() {};
-
-	void calc_hotspot();
-
-	Colorf color;
-
-	float scale_x, scale_y;
-
-	Point translation_hotspot;
-	Origin translation_origin;
-
-	Point translated_hotspot;	// Precalculated from calc_hotspot()
-
-	Texture2D texture;
-	Rect texture_rect;
-};
-
 void Image_Impl::calc_hotspot()
 {
 	switch(translation_origin)
@@ -178,6 +152,11 @@ Resource<Image> Image::resource(Canvas &canvas, const std::string &id, const Res
 }
 
 Image Image::load(Canvas &canvas, const std::string &id, const XMLResourceDocument &doc)
+{
+	return Image_Impl::load(canvas, id, doc, [&](const std::string &filename, const FileSystem &fs) { return Texture2D(canvas, filename, fs); });
+}
+
+Image Image_Impl::load(Canvas &canvas, const std::string &id, const XMLResourceDocument &doc, const std::function<Texture2D(const std::string &filename, const FileSystem &fs)> &load_texture)
 {
 	Image image;
 
@@ -197,7 +176,7 @@ Image Image::load(Canvas &canvas, const std::string &id, const XMLResourceDocume
 		if (tag_name == "image" || tag_name == "image-file")
 		{
 			std::string image_name = cur_element.get_attribute("file");
-			Texture2D texture = Texture2D(canvas, PathHelp::combine(resource.get_base_path(), image_name), resource.get_file_system());
+			Texture2D texture = load_texture(PathHelp::combine(resource.get_base_path(), image_name), resource.get_file_system());
 
 			DomNode cur_child(cur_element.get_first_child());
 			if(cur_child.is_null()) 
@@ -0,0 +1,68 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2015 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    agent
+*/
+
+#pragma once
+
+#include "API/Display/2D/image.h"
+#include "API/Display/Render/texture_2d.h"
+#include <functional>
+
+namespace clan
+{
+
+class Image_Impl
+{
+public:
+	Image_Impl() :
+		color(1.0f, 1.0f, 1.0f, 1.0f),
+		scale_x(1.0f),
+		scale_y(1.0f),
+		translation_hotspot(0,0),
+		translation_origin(origin_top_left),
+		translated_hotspot(0,0) {};
+	~Image_Impl() {};
+
+	void calc_hotspot();
+
+	/// \brief Loads an image resource, using load_texture to get the texture of the image file
+	static Image load(Canvas &canvas, const std::string &id, const XMLResourceDocument &doc, const std::function<Texture2D(const std::string &filename, const FileSystem &fs)> &load_texture);
+
+	Colorf color;
+
+	float scale_x, scale_y;
+
+	Point translation_hotspot;
+	Origin translation_origin;
+
+	Point translated_hotspot;	// Precalculated from calc_hotspot()
+
+	Texture2D texture;
+	Rect texture_rect;
+};
+
+}
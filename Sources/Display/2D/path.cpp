@@ -33,6 +33,7 @@
 #include "../Font/font_impl.h"
 #include "canvas_impl.h"
 #include "render_batch_path.h"
+#include "API/Core/Math/batch_math.h"
 
 namespace clan
 {
@@ -183,10 +184,8 @@ namespace clan
 		for (auto & elem : impl->subpaths)
 		{
 			std::vector<Pointf> &points = elem.points;
-			for (auto & point : points)
-			{
-				point = transform * point;
-			}
+			if (!points.empty())
+				BatchMath::transform(transform, &points[0], &points[0], (int)points.size());
 		}
 		return *this;
 	}
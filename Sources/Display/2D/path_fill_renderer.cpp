@@ -33,6 +33,9 @@
 #include "API/Display/2D/subtexture.h"
 #include "API/Core/System/system.h"
 #include <algorithm>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 using namespace clan::PathConstants;
 
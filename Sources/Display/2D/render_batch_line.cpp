@@ -31,6 +31,7 @@
 #include "sprite_impl.h"
 #include "API/Display/Render/blend_state_description.h"
 #include "API/Display/2D/canvas.h"
+#include "API/Core/Math/batch_math.h"
 
 namespace clan
 {
@@ -60,12 +61,10 @@ void RenderBatchLine::draw_lines(Canvas &canvas, const Vec2f *line_positions, co
 	// We convert a line strip to a line
 	set_batcher_active(canvas, num_vertices);
 
-
+	BatchMath::transform(modelview_projection_matrix, line_positions, &vertices[position].position, num_vertices, sizeof(LineVertex));
 	for (; num_vertices > 0; num_vertices--)
 	{
 		vertices[position].color = line_color;
-		vertices[position].position = to_position(line_positions->x, line_positions->y);
-		line_positions++;
 		position++;
 	}
 }
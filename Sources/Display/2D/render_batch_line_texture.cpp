@@ -31,6 +31,7 @@
 #include "sprite_impl.h"
 #include "API/Display/Render/blend_state_description.h"
 #include "API/Display/2D/canvas.h"
+#include "API/Core/Math/batch_math.h"
 
 namespace clan
 {
@@ -41,15 +42,6 @@ RenderBatchLineTexture::RenderBatchLineTexture(GraphicContext &gc, RenderBatchBu
 	vertices = (LineTextureVertex *) batch_buffer->buffer;
 }
 
-inline Vec4f RenderBatchLineTexture::to_position(float x, float y) const
-{
-	return Vec4f(
-		modelview_projection_matrix.matrix[0*4+0]*x + modelview_projection_matrix.matrix[1*4+0]*y + modelview_projection_matrix.matrix[3*4+0],
-		modelview_projection_matrix.matrix[0*4+1]*x + modelview_projection_matrix.matrix[1*4+1]*y + modelview_projection_matrix.matrix[3*4+1],
-		modelview_projection_matrix.matrix[0*4+2]*x + modelview_projection_matrix.matrix[1*4+2]*y + modelview_projection_matrix.matrix[3*4+2],
-		modelview_projection_matrix.matrix[0*4+3]*x + modelview_projection_matrix.matrix[1*4+3]*y + modelview_projection_matrix.matrix[3*4+3]);
-}
-
 void RenderBatchLineTexture::draw_lines(Canvas &canvas, const Vec2f *line_positions, const Vec2f *texture_positions, int num_vertices, const Texture2D &texture, const Vec4f &line_color)
 {
 	if (num_vertices < 2)
@@ -60,13 +52,11 @@ void RenderBatchLineTexture::draw_lines(Canvas &canvas, const Vec2f *line_positi
 	// We convert a line strip to a line
 	set_batcher_active(canvas, num_vertices, texture);
 
-
+	BatchMath::transform(modelview_projection_matrix, line_positions, &vertices[position].position, num_vertices, sizeof(LineTextureVertex));
 	for (; num_vertices > 0; num_vertices--)
 	{
 		vertices[position].color = line_color;
-		vertices[position].position = to_position(line_positions->x, line_positions->y);
 		vertices[position].texcoord = *texture_positions;
-		line_positions++;
 		texture_positions++;
 		position++;
 	}
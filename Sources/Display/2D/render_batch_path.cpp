@@ -33,6 +33,7 @@
 #include "API/Display/Render/blend_state_description.h"
 #include "API/Display/2D/canvas.h"
 #include "API/Core/Math/quad.h"
+#include "API/Core/Math/batch_math.h"
 #include "path_impl.h"
 #include "render_batch_buffer.h"
 
@@ -42,13 +43,6 @@ namespace clan
 	{
 	}
 
-	inline Pointf RenderBatchPath::to_position(const clan::Pointf &point) const
-	{
-		return Pointf(
-			modelview_matrix.matrix[0 * 4 + 0] * point.x + modelview_matrix.matrix[1 * 4 + 0] * point.y + modelview_matrix.matrix[3 * 4 + 0],
-			modelview_matrix.matrix[0 * 4 + 1] * point.x + modelview_matrix.matrix[1 * 4 + 1] * point.y + modelview_matrix.matrix[3 * 4 + 1]);
-	}
-
 	void RenderBatchPath::fill(Canvas &canvas, const Path &path, const Brush &brush)
 	{
 		canvas.set_batcher(this);
@@ -83,32 +77,38 @@ namespace clan
 	{
 		for (const auto &subpath : path.get_impl()->subpaths)
 		{
-			clan::Pointf start_point = to_position(subpath.points[0]);
-			path_renderer->begin(start_point.x, start_point.y);
+			// Transform all points of the subpath at once, the renderer only needs x and y
+			int num_points = subpath.points.size();
+			if (transformed_points.size() < (size_t)num_points)
+				transformed_points.resize(num_points);
+			BatchMath::transform(modelview_matrix, subpath.points.data(), transformed_points.data(), num_points);
+			const Vec4f *points = transformed_points.data();
+
+			path_renderer->begin(points[0].x, points[0].y);
 
 			size_t i = 1;
 			for (PathCommand command : subpath.commands)
 			{
 				if (command == PathCommand::line)
 				{
-					clan::Pointf next_point = to_position(subpath.points[i]);
+					const Vec4f &next_point = points[i];
 					i++;
 
 					path_renderer->line(next_point.x, next_point.y);
 				}
 				else if (command == PathCommand::quadradic)
 				{
-					clan::Pointf control = to_position(subpath.points[i]);
-					clan::Pointf next_point = to_position(subpath.points[i + 1]);
+					const Vec4f &control = points[i];
+					const Vec4f &next_point = points[i + 1];
 					i += 2;
 
 					path_renderer->quadratic_bezier(control.x, control.y, next_point.x, next_point.y);
 				}
 				else if (command == PathCommand::cubic)
 				{
-					clan::Pointf control1 = to_position(subpath.points[i]);
-					clan::Pointf control2 = to_position(subpath.points[i + 1]);
-					clan::Pointf next_point = to_position(subpath.points[i + 2]);
+					const Vec4f &control1 = points[i];
+					const Vec4f &control2 = points[i + 1];
+					const Vec4f &next_point = points[i + 2];
 					i += 3;
 
 					path_renderer->cubic_bezier(control1.x, control1.y, control2.x, control2.y, next_point.x, next_point.y);
@@ -61,9 +61,8 @@ private:
 	void flush(GraphicContext &gc) override;
 	void matrix_changed(const Mat4f &modelview, const Mat4f &projection, TextureImageYAxis image_yaxis) override;
 
-	inline Pointf to_position(const clan::Pointf &point) const;
-
 	Mat4f modelview_matrix;
+	std::vector<Vec4f> transformed_points;
 	RenderBatchBuffer *batch_buffer;
 
 	PathFillRenderer fill_renderer;
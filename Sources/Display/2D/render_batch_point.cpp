@@ -31,6 +31,7 @@
 #include "sprite_impl.h"
 #include "API/Display/Render/blend_state_description.h"
 #include "API/Display/2D/canvas.h"
+#include "API/Core/Math/batch_math.h"
 
 namespace clan
 {
@@ -45,26 +46,15 @@ void RenderBatchPoint::draw_point(Canvas &canvas, Vec2f *line_positions, const V
 {
 	set_batcher_active(canvas, num_vertices);
 
-
+	BatchMath::transform(modelview_projection_matrix, line_positions, &vertices[position].position, num_vertices, sizeof(PointVertex));
 	for (; num_vertices > 0; num_vertices--)
 	{
 		vertices[position].color = point_color;
-		vertices[position].position = to_position(line_positions->x, line_positions->y);
-		line_positions++;
 		position++;
 	}
 
 }
 
-inline Vec4f RenderBatchPoint::to_position(float x, float y) const
-{
-	return Vec4f(
-		modelview_projection_matrix.matrix[0*4+0]*x + modelview_projection_matrix.matrix[1*4+0]*y + modelview_projection_matrix.matrix[3*4+0],
-		modelview_projection_matrix.matrix[0*4+1]*x + modelview_projection_matrix.matrix[1*4+1]*y + modelview_projection_matrix.matrix[3*4+1],
-		modelview_projection_matrix.matrix[0*4+2]*x + modelview_projection_matrix.matrix[1*4+2]*y + modelview_projection_matrix.matrix[3*4+2],
-		modelview_projection_matrix.matrix[0*4+3]*x + modelview_projection_matrix.matrix[1*4+3]*y + modelview_projection_matrix.matrix[3*4+3]);
-}
-
 void RenderBatchPoint::set_batcher_active(Canvas &canvas, int num_vertices)
 {
 	if (position+num_vertices > max_vertices)
@@ -51,7 +51,6 @@ private:
 		Vec4f color;
 	};
 
-	inline Vec4f to_position(float x, float y) const;
 	void set_batcher_active(Canvas &canvas, int num_vertices);
 	void flush(GraphicContext &gc) override;
 	void matrix_changed(const Mat4f &modelview, const Mat4f &projection, TextureImageYAxis image_yaxis) override;
@@ -33,6 +33,7 @@
 #include "API/Display/Render/blend_state_description.h"
 #include "API/Display/2D/canvas.h"
 #include "API/Core/Math/quad.h"
+#include "API/Core/Math/batch_math.h"
 
 namespace clan
 {
@@ -42,7 +43,7 @@ namespace clan
 int RenderBatchTriangle::max_textures = 4;
 
 RenderBatchTriangle::RenderBatchTriangle(GraphicContext &gc, RenderBatchBuffer *batch_buffer)
-: position(0), num_current_textures(0), use_glyph_program(false), batch_buffer(batch_buffer)
+: position(0), num_current_textures(0), use_glyph_program(glyph_program_none), batch_buffer(batch_buffer)
 {
 	vertices = (SpriteVertex *) batch_buffer->buffer;
 }
@@ -63,12 +64,10 @@ void RenderBatchTriangle::fill_triangle(Canvas &canvas, const Vec2f *triangle_po
 {
 	int texindex = set_batcher_active(canvas, num_vertices);
 
-
+	BatchMath::transform(modelview_projection_matrix, triangle_positions, &vertices[position].position, num_vertices, sizeof(SpriteVertex));
 	for (; num_vertices > 0; num_vertices--)
 	{
 		vertices[position].color = (*(triangle_colors++));
-		vertices[position].position = to_position(triangle_positions->x, triangle_positions->y);
-		triangle_positions++;
 		vertices[position].texcoord = Vec2f(0.0f, 0.0f);
 		vertices[position].texindex = texindex;
 		position++;
@@ -79,12 +78,10 @@ void RenderBatchTriangle::fill_triangle(Canvas &canvas, const Vec2f *triangle_po
 {
 	int texindex = set_batcher_active(canvas, num_vertices);
 
-
+	BatchMath::transform(modelview_projection_matrix, triangle_positions, &vertices[position].position, num_vertices, sizeof(SpriteVertex));
 	for (; num_vertices > 0; num_vertices--)
 	{
 		vertices[position].color = color;
-		vertices[position].position = to_position(triangle_positions->x, triangle_positions->y);
-		triangle_positions++;
 		vertices[position].texcoord = Vec2f(0.0f, 0.0f);
 		vertices[position].texindex = texindex;
 		position++;
@@ -95,11 +92,10 @@ void RenderBatchTriangle::fill_triangles(Canvas &canvas, const Vec2f *positions,
 {
 	int texindex = set_batcher_active(canvas, texture);
 
+	BatchMath::transform(modelview_projection_matrix, positions, &vertices[position].position, num_vertices, sizeof(SpriteVertex));
 	for (; num_vertices > 0; num_vertices--)
 	{
 		vertices[position].color = color;
-		vertices[position].position = to_position(positions->x, positions->y);
-		positions++;
 		vertices[position].texcoord = *(texture_positions++);
 		vertices[position].texindex = texindex;
 		position++;
@@ -111,11 +107,10 @@ void RenderBatchTriangle::fill_triangles(Canvas &canvas, const Vec2f *positions,
 {
 	int texindex = set_batcher_active(canvas, texture);
 
+	BatchMath::transform(modelview_projection_matrix, positions, &vertices[position].position, num_vertices, sizeof(SpriteVertex));
 	for (; num_vertices > 0; num_vertices--)
 	{
 		vertices[position].color = *(colors++);
-		vertices[position].position = to_position(positions->x, positions->y);
-		positions++;
 		vertices[position].texcoord = *(texture_positions++);
 		vertices[position].texindex = texindex;
 		position++;
@@ -188,7 +183,7 @@ void RenderBatchTriangle::draw_image(Canvas &canvas, const Rectf &src, const Qua
 
 void RenderBatchTriangle::draw_glyph_subpixel(Canvas &canvas, const Rectf &src, const Rectf &dest, const Colorf &color, const Texture2D &texture)
 {
-	int texindex = set_batcher_active(canvas, texture, true, color);
+	int texindex = set_batcher_active(canvas, texture, glyph_program_subpixel, color);
 
 	vertices[position+0].position = to_position(dest.left, dest.top);
 	vertices[position+1].position = to_position(dest.right, dest.top);
@@ -214,6 +209,34 @@ void RenderBatchTriangle::draw_glyph_subpixel(Canvas &canvas, const Rectf &src,
 	position += 6;
 }
 
+void RenderBatchTriangle::draw_glyph_sdf(Canvas &canvas, const Rectf &src, const Rectf &dest, const Colorf &color, const Texture2D &texture)
+{
+	int texindex = set_batcher_active(canvas, texture, glyph_program_sdf);
+
+	vertices[position+0].position = to_position(dest.left, dest.top);
+	vertices[position+1].position = to_position(dest.right, dest.top);
+	vertices[position+2].position = to_position(dest.left, dest.bottom);
+	vertices[position+3].position = to_position(dest.right, dest.top);
+	vertices[position+4].position = to_position(dest.right, dest.bottom);
+	vertices[position+5].position = to_position(dest.left, dest.bottom);
+	float src_left = (src.left)/tex_sizes[texindex].width;
+	float src_top = (src.top) / tex_sizes[texindex].height;
+	float src_right = (src.right)/tex_sizes[texindex].width;
+	float src_bottom = (src.bottom) / tex_sizes[texindex].height;
+	vertices[position+0].texcoord = Vec2f(src_left, src_top);
+	vertices[position+1].texcoord = Vec2f(src_right, src_top);
+	vertices[position+2].texcoord = Vec2f(src_left, src_bottom);
+	vertices[position+3].texcoord = Vec2f(src_right, src_top);
+	vertices[position+4].texcoord = Vec2f(src_right, src_bottom);
+	vertices[position+5].texcoord = Vec2f(src_left, src_bottom);
+	for (int i=0; i<6; i++)
+	{
+		vertices[position+i].color = Vec4f(color.r, color.g, color.b, color.a);
+		vertices[position+i].texindex = texindex;
+	}
+	position += 6;
+}
+
 void RenderBatchTriangle::fill(Canvas &canvas, float x1, float y1, float x2, float y2, const Colorf &color)
 {
 	int texindex = set_batcher_active(canvas);
@@ -243,7 +266,7 @@ inline Vec4f RenderBatchTriangle::to_position(float x, float y) const
 }
 
 
-int RenderBatchTriangle::set_batcher_active(Canvas &canvas, const Texture2D &texture, bool glyph_program, const Colorf &new_constant_color)
+int RenderBatchTriangle::set_batcher_active(Canvas &canvas, const Texture2D &texture, GlyphProgram glyph_program, const Colorf &new_constant_color)
 {
 	if (use_glyph_program != glyph_program || constant_color != new_constant_color)
 	{
@@ -282,10 +305,10 @@ int RenderBatchTriangle::set_batcher_active(Canvas &canvas, const Texture2D &tex
 
 int RenderBatchTriangle::set_batcher_active(Canvas &canvas)
 {
-	if (use_glyph_program != false)
+	if (use_glyph_program != glyph_program_none)
 	{
 		canvas.flush();
-		use_glyph_program = false;
+		use_glyph_program = glyph_program_none;
 	}
 
 	if (position == 0 || position+6 > max_vertices)
@@ -296,10 +319,10 @@ int RenderBatchTriangle::set_batcher_active(Canvas &canvas)
 
 int RenderBatchTriangle::set_batcher_active(Canvas &canvas, int num_vertices)
 {
-	if (use_glyph_program != false)
+	if (use_glyph_program != glyph_program_none)
 	{
 		canvas.flush();
-		use_glyph_program = false;
+		use_glyph_program = glyph_program_none;
 	}
 
 	if (position+num_vertices > max_vertices)
@@ -316,7 +339,7 @@ void RenderBatchTriangle::flush(GraphicContext &gc)
 {
 	if (position > 0)
 	{
-		gc.set_program_object(program_sprite);
+		gc.set_program_object(use_glyph_program == glyph_program_sdf ? program_sdf_glyph : program_sprite);
 
 		int gpu_index;
 		VertexArrayVector<SpriteVertex> gpu_vertices(batch_buffer->get_vertex_buffer(gc, gpu_index));
@@ -342,7 +365,7 @@ void RenderBatchTriangle::flush(GraphicContext &gc)
 		for (int i = 0; i < num_current_textures; i++)
 			gc.set_texture(i, current_textures[i]);
 
-		if (use_glyph_program)
+		if (use_glyph_program == glyph_program_subpixel)
 		{
 			gc.set_blend_state(glyph_blend, constant_color);
 			gc.draw_primitives(type_triangles, position, prim_array[gpu_index]);
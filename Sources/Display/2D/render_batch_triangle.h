@@ -51,6 +51,7 @@ public:
 	void draw_image(Canvas &canvas, const Rectf &src, const Rectf &dest, const Colorf &color, const Texture2D &texture);
 	void draw_image(Canvas &canvas, const Rectf &src, const Quadf &dest, const Colorf &color, const Texture2D &texture);
 	void draw_glyph_subpixel(Canvas &canvas, const Rectf &src, const Rectf &dest, const Colorf &color, const Texture2D &texture);
+	void draw_glyph_sdf(Canvas &canvas, const Rectf &src, const Rectf &dest, const Colorf &color, const Texture2D &texture);
 	void fill_triangle(Canvas &canvas, const Vec2f *triangle_positions, const Vec4f *triangle_colors, int num_vertices);
 	void fill_triangle(Canvas &canvas, const Vec2f *triangle_positions, const Colorf &color, int num_vertices);
 	void fill_triangles(Canvas &canvas, const Vec2f *positions, const Vec2f *texture_positions, int num_vertices, const Texture2D &texture, const Colorf &color);
@@ -61,6 +62,13 @@ public:
 	static int max_textures;	// For use by the GL1 target, so it can reduce the number of textures
 
 private:
+	enum GlyphProgram
+	{
+		glyph_program_none,
+		glyph_program_subpixel,
+		glyph_program_sdf
+	};
+
 	struct SpriteVertex
 	{
 		Vec4f position;
@@ -69,7 +77,7 @@ private:
 		int texindex;
 	};
 
-	int set_batcher_active(Canvas &canvas, const Texture2D &texture, bool glyph_program = false, const Colorf &constant_color = Colorf::black);
+	int set_batcher_active(Canvas &canvas, const Texture2D &texture, GlyphProgram glyph_program = glyph_program_none, const Colorf &constant_color = Colorf::black);
 	int set_batcher_active(Canvas &canvas);
 	int set_batcher_active(Canvas &canvas, int num_vertices);
 	void flush(GraphicContext &gc) override;
@@ -92,7 +100,7 @@ private:
 	Texture2D current_textures[max_number_of_texture_coords];
 	int num_current_textures;
 	Sizef tex_sizes[max_number_of_texture_coords];
-	bool use_glyph_program;
+	GlyphProgram use_glyph_program;
 	Colorf constant_color;
 	BlendState glyph_blend;
 };
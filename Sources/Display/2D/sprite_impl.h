@@ -35,6 +35,7 @@
 #include "API/Display/Render/texture_2d.h"
 #include "render_batch_triangle.h"
 #include <vector>
+#include <functional>
 
 namespace clan
 {
@@ -118,6 +119,9 @@ public:
 
 	void draw(Canvas &canvas, const Rect &p_src, const Pointf &p_dest, const Pointf &p_scale);
 
+	/// \brief Loads a sprite resource, using load_texture to get the textures of the image files
+	static Sprite load(Canvas &canvas, const std::string &id, const XMLResourceDocument &doc, const std::function<Texture2D(const std::string &filename, const FileSystem &fs)> &load_texture);
+
 	// inlined this function for performance reasons.
 	static inline Pointf calc_hotspot(Origin origin, float hotspot_x, float hotspot_y, float size_width, float size_height)
 	{
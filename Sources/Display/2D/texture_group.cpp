@@ -41,8 +41,8 @@ TextureGroup::TextureGroup()
 {
 }
 
-TextureGroup::TextureGroup(const Size &texture_sizes)
-: impl(std::make_shared<TextureGroup_Impl>(texture_sizes))
+TextureGroup::TextureGroup(const Size &texture_sizes, RectPacker::PackingMethod method)
+: impl(std::make_shared<TextureGroup_Impl>(texture_sizes, method))
 {
 	set_texture_allocation_policy(create_new_texture);
 }
@@ -25,7 +25,6 @@
 **
 **    Kenneth Gangstoe
 */
-
 #include "Display/precomp.h"
 #include "API/Display/2D/subtexture.h"
 #include "API/Core/Math/point.h"
@@ -38,20 +37,13 @@ namespace clan
 /////////////////////////////////////////////////////////////////////////////
 // TextureGroup_Impl construction:
 
-TextureGroup_Impl::TextureGroup_Impl(const Size &texture_sizes)
-: initial_texture_size(texture_sizes), active_root(nullptr), next_id(0)
+TextureGroup_Impl::TextureGroup_Impl(const Size &texture_sizes, RectPacker::PackingMethod method)
+: initial_texture_size(texture_sizes), texture_allocation_policy(TextureGroup::create_new_texture), packing_method(method), active_root(nullptr)
 {
 }
 
 TextureGroup_Impl::~TextureGroup_Impl()
 {
-	std::vector<RootNode *>::size_type index, size;
-	size = root_nodes.size();
-	for(index = 0; index < size; ++index)
-	{
-		root_nodes[index]->node.clear();
-		delete root_nodes[index];
-	}
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -60,36 +52,23 @@ TextureGroup_Impl::~TextureGroup_Impl()
 int TextureGroup_Impl::get_subtexture_count() const
 {
 	int count = 0;
-
-	std::vector<RootNode *>::size_type index, size;
-	size = root_nodes.size();
-	for(index = 0; index < size; ++index)
-		count += root_nodes[index]->node.get_subtexture_count();
-
+	for (const auto &root : root_nodes)
+		count += root->bin->get_rect_count();
 	return count;
 }
 
 int TextureGroup_Impl::get_subtexture_count(unsigned int texture_index) const
 {
-	int count = 0;
-
-	if(texture_index < root_nodes.size())
-		count = root_nodes[texture_index]->node.get_subtexture_count();
-
-	return count;
+	if (texture_index < root_nodes.size())
+		return root_nodes[texture_index]->bin->get_rect_count();
+	return 0;
 }
 
 std::vector<Texture2D> TextureGroup_Impl::get_textures() const
 {
 	std::vector<Texture2D> textures;
-	
-	std::vector<RootNode *>::size_type index, size;
-	size = root_nodes.size();
-	for(index = 0; index < size; ++index)
-	{
-		textures.push_back(root_nodes[index]->texture);
-	}
-
+	for (const auto &root : root_nodes)
+		textures.push_back(root->texture);
 	return textures;
 }
 
@@ -98,257 +77,71 @@ std::vector<Texture2D> TextureGroup_Impl::get_textures() const
 
 Subtexture TextureGroup_Impl::add_new_node(GraphicContext &context, const Size &texture_size)
 {
+	Rect rect;
 
 	// Try inserting in current active texture
-	Node *node;
-	if (!active_root)
-	{
-		// Create an initial root, if it does not exist
-		node = nullptr;
-		next_id = 1;
-	}
-	else
-	{
-		node = active_root->node.insert(texture_size, next_id);
-	}
+	if (active_root && active_root->bin->insert(texture_size, rect))
+		return Subtexture(active_root->texture, rect);
 
-	if(node == nullptr) // Couldn't find a fit in current active texture
+	// Search previous textures if policy says so
+	if (texture_allocation_policy == TextureGroup::search_previous_textures)
 	{
-		// Search previous textures if policy says so
-		if(texture_allocation_policy == TextureGroup::search_previous_textures)
-		{
-			std::vector<RootNode *>::size_type index, size;
-			size = root_nodes.size();
-			for(index = 0; index < size; ++index)
-			{
-				node = root_nodes[index]->node.insert(texture_size, next_id);
-				if(node)	// We found space in a previous texture
-					break;
-			}
-		}
-
-		if(node == nullptr) // Couldn't find a fit, so create a new texture
+		for (const auto &root : root_nodes)
 		{
-			if(texture_size.width > initial_texture_size.width || texture_size.height > initial_texture_size.height)
-			{
-				// If the specified size is greater than the initial size,  then create a texture using the specified size
-				node = add_new_root(context, texture_size)->node.insert(texture_size, next_id);
-			}
-			else
-			{
-				node = add_new_root(context, initial_texture_size)->node.insert(texture_size, next_id);
-			}
+			if (root.get() != active_root && root->bin->insert(texture_size, rect))	// We found space in a previous texture
+				return Subtexture(root->texture, rect);
 		}
-
-		if(node == nullptr)
-			throw Exception("Unable to pack Texture into TextureGroup");
 	}
 
-	next_id++;
+	// Couldn't find a fit, so create a new texture.
+	// If the specified size is greater than the initial size, then create a texture using the specified size
+	Size new_texture_size = initial_texture_size;
+	if (texture_size.width > initial_texture_size.width || texture_size.height > initial_texture_size.height)
+		new_texture_size = texture_size;
+
+	RootNode *root = add_new_root(Texture2D(context, new_texture_size), Rect(Point(0, 0), new_texture_size));
+	if (!root->bin->insert(texture_size, rect))
+		throw Exception("Unable to pack Texture into TextureGroup");
 
-	return Subtexture(active_root->texture, node->image_rect);
+	return Subtexture(root->texture, rect);
 }
 
-TextureGroup_Impl::RootNode *TextureGroup_Impl::add_new_root(GraphicContext &context, const Size &texture_size)
+TextureGroup_Impl::RootNode *TextureGroup_Impl::add_new_root(const Texture2D &texture, const Rect &rect)
 {
-	Rect rect(Point(0, 0), texture_size);
-	Node node(rect);
-
-	active_root = new RootNode();
-	active_root->texture = Texture2D(context, texture_size);
-	active_root->node = node;
-	
-	root_nodes.push_back(active_root);
+	std::unique_ptr<RootNode> root(new RootNode());
+	root->texture = texture;
+	root->bin = RectPackerBin::create(rect, packing_method);
 
+	active_root = root.get();
+	root_nodes.push_back(std::move(root));
 	return active_root;
 }
 
 void TextureGroup_Impl::insert_texture(Texture2D &texture, const Rect &texture_rect)
 {
-	Node node(texture_rect);
-
-	active_root = new RootNode();
-	active_root->texture = texture;
-	active_root->node = node;
-
-	root_nodes.push_back(active_root);
-
+	add_new_root(texture, texture_rect);
 }
 
 void TextureGroup_Impl::remove(Subtexture &subtexture)
 {
-	// Find the texture
-	Node *node = nullptr;
 	Texture2D texture = subtexture.get_texture();
 	Rect rect = subtexture.get_geometry();
 
-	std::vector<RootNode *>::size_type index, size;
-	size = root_nodes.size();
-	for(index = 0; index < size; ++index)
-	{
-		// Find a texture match
-		if (root_nodes[index]->texture == texture )
-		{
-			node = root_nodes[index]->node.find_image_rect(rect);
-			break;
-		}
-	}
-	if (node)
-	{
-		node->clear();
-		if(root_nodes[index]->node.get_subtexture_count() <= 0)
-		{
-			root_nodes[index]->node.clear();
-			delete root_nodes[index];
-			root_nodes.erase(root_nodes.begin() + index);
-		}
-		if(root_nodes.empty())
-		{
-			active_root = nullptr;
-		}
-		else
-		{
-			active_root = root_nodes.back();
-		}
-	}
-	else
-	{
-		throw Exception("Cannot find the Subtexture in the TextureGroup");
-	}
-}
-
-/////////////////////////////////////////////////////////////////////////////
-// TextureGroup_Impl::Node:
-
-TextureGroup_Impl::Node::Node()
-{
-	child[0] = nullptr;
-	child[1] = nullptr;
-
-	id = 0;
-}
-
-TextureGroup_Impl::Node::Node(const Rect &new_rect)
-{
-	node_rect = new_rect;
-
-	child[0] = nullptr;
-	child[1] = nullptr;
-
-	id = 0;
-}
-
-TextureGroup_Impl::Node::~Node()
-{
-	clear();
-}
-
-int TextureGroup_Impl::Node::get_subtexture_count() const
-{
-	int count = 0;
-
-	if(child[0])
-		count += child[0]->get_subtexture_count();
-	if(child[1])
-		count += child[1]->get_subtexture_count();
-
-	if(id)
-		count++;
-
-	return count;
-}
-
-void TextureGroup_Impl::Node::clear()
-{
-	if(child[0])
-	{
-		delete child[0];
-		child[0] = nullptr;
-	}
-	if(child[1])
-	{
-		delete child[1];
-		child[1] = nullptr;
-	}
-	id = 0;
-}
-
-TextureGroup_Impl::Node *TextureGroup_Impl::Node::insert(const Size &texture_size, int texture_id)
-{
-	// If we're not a leaf
-	if(child[0] && child[1])
-	{
-		// Try inserting into first child
-		Node *new_node = child[0]->insert(texture_size, texture_id);
-		if(new_node != nullptr)
-			return new_node;
-        
-		// No room, insert into second
-		return child[1]->insert(texture_size, texture_id);
-	}
-	else
+	// Find the texture
+	for (size_t index = 0; index < root_nodes.size(); ++index)
 	{
-		// If there's already a texture here, return
-		if (id)
-			return nullptr;
-
-		// If we're too small, return
-		if (texture_size.width > node_rect.get_width() || texture_size.height > node_rect.get_height())
-			return nullptr;
+		if (root_nodes[index]->texture != texture || !root_nodes[index]->bin->remove(rect))
+			continue;
 
-		// If we're just right, accept
-		if (texture_size.width == node_rect.get_width() && texture_size.height == node_rect.get_height())
+		if (root_nodes[index]->bin->get_rect_count() <= 0)
 		{
-			id = texture_id;
-			image_rect = node_rect;
-			return this;
-		}
-        
-		// Otherwise, decide which way to split
-		int dw = node_rect.get_width() - texture_size.width;
-		int dh = node_rect.get_height() - texture_size.height;
-
-		if (dw > dh)
-		{
-			child[0] = new Node(Rect(node_rect.left, node_rect.top, node_rect.left + texture_size.width, node_rect.bottom));
-			child[1] = new Node(Rect(node_rect.left + texture_size.width, node_rect.top, node_rect.right, node_rect.bottom));
-		}
-		else
-		{
-			child[0] = new Node(Rect(node_rect.left, node_rect.top, node_rect.right, node_rect.top + texture_size.height));
-			child[1] = new Node(Rect(node_rect.left, node_rect.top + texture_size.height, node_rect.right, node_rect.bottom));
+			root_nodes.erase(root_nodes.begin() + index);
+			active_root = root_nodes.empty() ? nullptr : root_nodes.back().get();
 		}
-        
-		// Insert into first child we created
-		return child[0]->insert(texture_size, texture_id);
+		return;
 	}
-}
-
-TextureGroup_Impl::Node *TextureGroup_Impl::Node::find_image_rect(const Rect &new_rect)
-{
-	// Check leaf
-	if(child[0])
-	{
-		Node *node = child[0]->find_image_rect(new_rect);
-		if (node)
-			return node;
-	}
-
-	if(child[1])
-	{
-		Node *node = child[1]->find_image_rect(new_rect);
-		if (node)
-			return node;
-	}
-
-	if (id == 0)
-		return nullptr;
-
-	if (image_rect == new_rect)
-		return this;
-
-	return nullptr;
 
+	throw Exception("Cannot find the Subtexture in the TextureGroup");
 }
 
 }
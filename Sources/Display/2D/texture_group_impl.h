@@ -25,12 +25,12 @@
 **
 **    Kenneth Gangstoe
 */
-
 #pragma once
 
-#include <list>
+#include <memory>
 #include "API/Display/Render/texture_2d.h"
 #include "API/Display/2D/texture_group.h"
+#include "Core/Math/rect_packer_bin.h"
 
 namespace clan
 {
@@ -41,36 +41,15 @@ class GraphicContext;
 class TextureGroup_Impl
 {
 public:
-	class Node
-	{
-	public:
-		Node();
-		Node(const Rect &rect);
-		~Node();
-
-		int get_subtexture_count() const;
-
-		Node *insert(const Size &texture_size, int texture_id);
-		Node *find_image_rect(const Rect &new_rect);
-
-		void clear();
-
-		Node *child[2];
-		Rect node_rect;
-
-	    int id;
-	    Rect image_rect;
-	};
-
 	struct RootNode
 	{
 	public:
 		Texture2D texture;
-		Node node;
+		std::unique_ptr<RectPackerBin> bin;
 	};
 
 public:
-	TextureGroup_Impl(const Size &texture_sizes);
+	TextureGroup_Impl(const Size &texture_sizes, RectPacker::PackingMethod method);
 	~TextureGroup_Impl();
 
 	int get_subtexture_count() const;
@@ -82,16 +61,16 @@ public:
 
 	Subtexture add_new_node(GraphicContext &context, const Size &texture_size);
 
-	std::vector<RootNode *> root_nodes;
+	std::vector<std::unique_ptr<RootNode>> root_nodes;
 
 	Size initial_texture_size;
 	TextureGroup::TextureAllocationPolicy texture_allocation_policy;
+	RectPacker::PackingMethod packing_method;
 
 private:
-	RootNode *add_new_root(GraphicContext &context, const Size &texture_size);
+	RootNode *add_new_root(const Texture2D &texture, const Rect &rect);
 
 	RootNode *active_root;
-	int next_id;
 };
 
 }
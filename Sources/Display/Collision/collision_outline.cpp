@@ -144,11 +144,15 @@ CollisionOutline::~CollisionOutline()
 
 std::vector<Contour> &CollisionOutline::get_contours()
 {
+	// The caller may modify the points, so the cached world points must be rebuilt
+	impl->apply_pending_translation();
+	impl->invalidate_world_points();
 	return impl->contours;
 }
 
 const std::vector<Contour> &CollisionOutline::get_contours() const
 {
+	impl->apply_pending_translation();
 	return impl->contours;
 }
 
@@ -229,6 +233,8 @@ void CollisionOutline::get_collision_info_state(bool &points, bool &normals, boo
 
 CollisionOutline CollisionOutline::clone() const
 {
+	impl->apply_pending_translation();
+
 	CollisionOutline copy;
 	copy.impl->contours.clear();
 	copy.impl->contours.reserve(impl->contours.size());
@@ -273,6 +279,7 @@ void CollisionOutline::draw(
 	Canvas &canvas)
 {
 	GraphicContext &gc = canvas.get_gc();
+	impl->apply_pending_translation();
 
 	// Draw collision outline (Contours are assumed as closed polygons, hence we use line-loop)
 	for(auto & elem : impl->contours)
@@ -309,6 +316,8 @@ void CollisionOutline::draw_sub_circles(
 	const Colorf &color,
 	Canvas &canvas)
 {
+	impl->apply_pending_translation();
+
 	// Draw the circles
 	for(auto & elem : impl->contours)
 	{
@@ -420,11 +429,13 @@ void CollisionOutline::save(const std::string &fullname) const
 void CollisionOutline::save(const std::string &filename, FileSystem &fs) const
 {
 	IODevice file = fs.open_file(filename, File::create_always, File::access_read_write);
+	impl->apply_pending_translation();
 	impl->save(file);
 }
 
 void CollisionOutline::save(IODevice &file) const
 {
+	impl->apply_pending_translation();
 	impl->save(file);
 }
 
@@ -44,9 +44,14 @@
 #include "API/Core/Math/pointset_math.h"
 #include "API/Core/Math/vec3.h"
 #include "API/Core/Math/angle.h"
+#include "API/Core/Math/batch_math.h"
 #include <cfloat>
 #include <iostream>
 
+#ifndef CL_DISABLE_SSE2
+#include <emmintrin.h>
+#endif
+
 namespace clan
 {
 
@@ -69,7 +74,10 @@ CollisionOutline_Impl::CollisionOutline_Impl()
 	collision_info_normals(false),
 	collision_info_meta(false),
 	collision_info_pen_depth(false),
-	collision_info_collect(false)
+	collision_info_collect(false),
+	transform_version(0),
+	pending_translation(0,0),
+	world_points_dirty(true)
 {
 	return;
 }
@@ -90,7 +98,10 @@ CollisionOutline_Impl::CollisionOutline_Impl(const std::vector<Contour> &new_con
 	collision_info_normals(false),
 	collision_info_meta(false),
 	collision_info_pen_depth(false),
-	collision_info_collect(false)
+	collision_info_collect(false),
+	transform_version(0),
+	pending_translation(0,0),
+	world_points_dirty(true)
 {
 	contours = new_contours;
 	width = new_base_size.width;
@@ -132,6 +143,7 @@ CollisionOutline_Impl::~CollisionOutline_Impl()
 
 void CollisionOutline_Impl::set_translation(float x, float y, bool offset_points)
 {
+	transform_version++;
 	Pointf old_position = position;
 
 	if( !offset_points )
@@ -150,84 +162,58 @@ void CollisionOutline_Impl::set_translation(float x, float y, bool offset_points
 	else
 		translation = (position - old_position);
 
-	for (auto & elem : contours)
-	{
-		Contour *contour_ptr = &elem;
-		std::vector<Pointf>::size_type point_size = contour_ptr->get_points().size();
-		for (int inner_cnt = 0; inner_cnt < point_size; inner_cnt++)
-		{
-			contour_ptr->get_points()[inner_cnt] += translation;
-		}
-	}
-
-	for (auto & elem : contours)
-	{
-		Contour *contour_ptr = &elem;
-		std::vector<Pointf>::size_type sub_circles_size = contour_ptr->get_sub_circles().size();
-		for (int inner_cnt = 0; inner_cnt < sub_circles_size; inner_cnt++)
-		{
-			contour_ptr->get_sub_circles()[inner_cnt].position += translation;
-		}
-	}
+	// The points and sub-circles are moved the next time they are needed
+	pending_translation += translation;
 
 	minimum_enclosing_disc.position += translation;
 }
 
 void CollisionOutline_Impl::rotate(const Angle &add_angle)
 {
+	transform_version++;
+	apply_pending_translation();
+	world_points_dirty = true;
 	angle += add_angle.to_degrees();
 
-	for (auto & elem : contours)
-	{
-		Contour *contour_ptr = &elem;
-		std::vector<Pointf>::size_type point_size = contour_ptr->get_points().size();
-		for (int inner_cnt = 0; inner_cnt < point_size; inner_cnt++)
-		{
-			contour_ptr->get_points()[inner_cnt].rotate(position+rotation_hotspot, add_angle);
-		}
-	}
-
-	for (auto & elem : contours)
-	{
-		Contour *contour_ptr = &elem;
-		std::vector<Pointf>::size_type sub_circles_size = contour_ptr->get_sub_circles().size();
-		for (int inner_cnt = 0; inner_cnt < sub_circles_size; inner_cnt++)
-		{
-			contour_ptr->get_sub_circles()[inner_cnt].position.rotate(position+rotation_hotspot, add_angle);
-		}
-	}
-
-	// Rotate our "radius" too
-	minimum_enclosing_disc.position.rotate(position+rotation_hotspot, add_angle);
+	rotate_around(position + rotation_hotspot, add_angle);
 }
 
 void CollisionOutline_Impl::set_angle(const Angle &angle)
 {
+	transform_version++;
+	apply_pending_translation();
+	world_points_dirty = true;
 	float rotate_angle = angle.to_degrees() - this->angle;
 	this->angle = angle.to_degrees();
 
-	for (auto & elem : contours)
-	{
-		Contour *contour_ptr = &elem;
-		std::vector<Pointf>::size_type point_size = contour_ptr->get_points().size();
-		for (int inner_cnt = 0; inner_cnt < point_size; inner_cnt++)
-		{
-			contour_ptr->get_points()[inner_cnt].rotate(position+rotation_hotspot, Angle(rotate_angle, angle_degrees));
-		}
-	}
+	rotate_around(position + rotation_hotspot, Angle(rotate_angle, angle_degrees));
+}
+
+void CollisionOutline_Impl::rotate_around(const Pointf &hotspot, const Angle &angle)
+{
+	static_assert(sizeof(Pointf) == sizeof(Vec2f), "Points are transformed as an array of Vec2f");
+
+	// x' = cos * (x - hotspot.x) - sin * (y - hotspot.y) + hotspot.x, and likewise for y'
+	float radians = angle.to_radians();
+	float sin_angle = sinf(radians);
+	float cos_angle = cosf(radians);
+	Mat3f rotation(
+		cos_angle, sin_angle, 0.0f,
+		-sin_angle, cos_angle, 0.0f,
+		hotspot.x - cos_angle * hotspot.x + sin_angle * hotspot.y, hotspot.y - sin_angle * hotspot.x - cos_angle * hotspot.y, 1.0f);
 
 	for (auto & elem : contours)
 	{
-		Contour *contour_ptr = &elem;
-		std::vector<Pointf>::size_type sub_circles_size = contour_ptr->get_sub_circles().size();
-		for (int inner_cnt = 0; inner_cnt < sub_circles_size; inner_cnt++)
-		{
-			contour_ptr->get_sub_circles()[inner_cnt].position.rotate(position+rotation_hotspot, Angle(rotate_angle, angle_degrees));
-		}
+		std::vector<Pointf> &points = elem.get_points();
+		if (!points.empty())
+			BatchMath::transform(rotation, &points[0], &points[0], points.size());
+
+		for (auto & circle : elem.get_sub_circles())
+			circle.position = rotation * circle.position;
 	}
 
 	// Rotate our "radius" too
-	minimum_enclosing_disc.position.rotate(position+rotation_hotspot, Angle(rotate_angle,angle_degrees));
+	minimum_enclosing_disc.position = rotation * minimum_enclosing_disc.position;
 }
 
 void CollisionOutline_Impl::set_scale(float new_scale_x, float new_scale_y)
@@ -235,9 +221,14 @@ void CollisionOutline_Impl::set_scale(float new_scale_x, float new_scale_y)
 	if( scale_factor.x == new_scale_x && scale_factor.y == new_scale_y )
 		return;
 
+	transform_version++;
+
 	if (new_scale_x == 0 || new_scale_y == 0)
 		return;
 
+	apply_pending_translation();
+	world_points_dirty = true;
+
 	float scale_x = new_scale_x / scale_factor.x;
 	float scale_y = new_scale_y / scale_factor.y;
 	
@@ -274,6 +265,8 @@ void CollisionOutline_Impl::set_scale(float new_scale_x, float new_scale_y)
 
 void CollisionOutline_Impl::calculate_radius()
 {
+	transform_version++;
+	apply_pending_translation();
 	std::vector<Pointf> allpoints;
 	std::vector<Contour>::iterator it;
 	for( it = contours.begin(); it != contours.end(); ++it )
@@ -301,6 +294,8 @@ void CollisionOutline_Impl::calculate_sub_circles(float radius_multiplier)
 	 *          - Break inner loop !
 	 *    - Add the subcircle to the list
 	**/
+	apply_pending_translation();
+
 	std::vector<Contour>::iterator it;
 	for( it = contours.begin(); it != contours.end(); ++it )
 	{
@@ -343,6 +338,8 @@ void CollisionOutline_Impl::calculate_sub_circles(float radius_multiplier)
 
 void CollisionOutline_Impl::calculate_smallest_enclosing_discs()
 {	
+	apply_pending_translation();
+
 	std::vector<Contour>::iterator it;
 	for( it = contours.begin(); it != contours.end(); ++it )
 	{
@@ -360,6 +357,9 @@ void CollisionOutline_Impl::calculate_smallest_enclosing_discs()
 
 void CollisionOutline_Impl::calculate_convex_hulls()
 {
+	apply_pending_translation();
+	world_points_dirty = true;
+
 	std::vector<Contour>::iterator it;
 	for( it = contours.begin(); it != contours.end(); ++it )
 	{
@@ -372,6 +372,9 @@ void CollisionOutline_Impl::calculate_convex_hulls()
 
 void CollisionOutline_Impl::optimize(unsigned char check_distance, float corner_angle)
 {
+	apply_pending_translation();
+	world_points_dirty = true;
+
 	unsigned char orig_check_distance = check_distance;
 
 	std::vector<Contour>::iterator it;
@@ -497,6 +500,55 @@ void CollisionOutline_Impl::save(IODevice &output_source) const
 	}
 }
 
+void CollisionOutline_Impl::apply_pending_translation()
+{
+	if( pending_translation.x == 0.0f && pending_translation.y == 0.0f )
+		return;
+
+	for (auto & elem : contours)
+	{
+		std::vector<Pointf> &points = elem.get_points();
+		for (auto & point : points)
+			point += pending_translation;
+
+		std::vector<OutlineCircle> &sub_circles = elem.get_sub_circles();
+		for (auto & circle : sub_circles)
+			circle.position += pending_translation;
+	}
+
+	// Move the world points along with the contours instead of building them again.
+	// The sums are the same as the ones the translated contour points got above.
+	if( !world_points_dirty )
+	{
+		for (auto & world : world_points)
+		{
+			float *x = world.x.data();
+			float *y = world.y.data();
+			size_t size = world.x.size();
+			for( size_t i = 0; i < size; ++i )
+			{
+				x[i] += pending_translation.x;
+				y[i] += pending_translation.y;
+			}
+		}
+	}
+
+	pending_translation = Pointf(0.0f, 0.0f);
+}
+
+void CollisionOutline_Impl::update_world_points()
+{
+	apply_pending_translation();
+
+	if( world_points_dirty )
+	{
+		world_points.resize(contours.size());
+		for (size_t i = 0; i < contours.size(); i++)
+			build_world_points(contours[i], world_points[i]);
+		world_points_dirty = false;
+	}
+}
+
 bool CollisionOutline_Impl::collide( const CollisionOutline &outline, bool remove_old_collision_info)
 {
 	if( collision_info_collect && remove_old_collision_info )
@@ -510,29 +562,34 @@ bool CollisionOutline_Impl::collide( const CollisionOutline &outline, bool remov
 	if( dist > (minimum_enclosing_disc.radius + outline.get_minimum_enclosing_disc().radius ))
 		return false;
 
+	CollisionOutline_Impl *other = outline.impl.get();
+	update_world_points();
+	other->update_world_points();
+
 	bool any_collisions = false;
 	// collision sub circle test
-	std::vector<Contour>::const_iterator it_contours, it_contours2;
-	for( it_contours = contours.begin(); it_contours != contours.end(); ++it_contours )
+	for( size_t index1 = 0; index1 < contours.size(); ++index1 )
 	{
-		for( it_contours2 = outline.get_contours().begin();
-			 it_contours2 != outline.get_contours().end();
-			 ++it_contours2 )
+		const Contour &contour1 = contours[index1];
+
+		for( size_t index2 = 0; index2 < other->contours.size(); ++index2 )
 		{
-			if( contours_collide( (*it_contours), (*it_contours2) ) )
+			const Contour &contour2 = other->contours[index2];
+
+			if( contours_collide(contour1, contour2, other->world_points[index2], other->minimum_enclosing_disc) )
 			{
 				if( collision_info_collect == false ) 
 					return true; // don't return info about all line intersections
 				any_collisions = true;
 			}
-			else if( do_inside_test || outline.get_inside_test() )
+			else if( do_inside_test || other->do_inside_test )
 			{
-				if( point_inside_contour((*it_contours).get_points()[0], (*it_contours2)))
+				if( point_inside_contour(contour1.get_points()[0], contour2, other->world_points[index2]) )
 				{
 					if( collision_info_collect )
 					{
 						// Add this info to the
-						collision_info.push_back(CollidingContours(&(*it_contours), &(*it_contours2), true));
+						collision_info.push_back(CollidingContours(&contour1, &contour2, true));
 					}
 					else
 					{
@@ -540,12 +597,12 @@ bool CollisionOutline_Impl::collide( const CollisionOutline &outline, bool remov
 					}
 					any_collisions = true;
 				}
-				if(point_inside_contour((*it_contours2).get_points()[0], (*it_contours)) )
+				if( point_inside_contour(contour2.get_points()[0], contour1, world_points[index1]) )
 				{
 					if( collision_info_collect )
 					{
 						// Add this info to the
-						collision_info.push_back(CollidingContours(&(*it_contours2), &(*it_contours), true));
+						collision_info.push_back(CollidingContours(&contour2, &contour1, true));
 					}
 					else
 					{
@@ -568,17 +625,18 @@ bool CollisionOutline_Impl::collide( const CollisionOutline &outline, bool remov
 }
 
 
-bool CollisionOutline_Impl::point_inside( const Pointf &point ) const
+bool CollisionOutline_Impl::point_inside( const Pointf &point )
 {
 	float dist = minimum_enclosing_disc.position.distance(point);
 	
 	if( dist > minimum_enclosing_disc.radius)
 		return false;
 
-	std::vector<Contour>::const_iterator it;	
-	for( it = contours.begin(); it != contours.end(); ++it )
+	update_world_points();
+
+	for( size_t i = 0; i < contours.size(); ++i )
 	{
-		if( point_inside_contour(point, (*it)) )
+		if( point_inside_contour(point, contours[i], world_points[i]) )
 		{
 			return true;
 		}
@@ -590,7 +648,87 @@ bool CollisionOutline_Impl::point_inside( const Pointf &point ) const
 /////////////////////////////////////////////////////////////////////////////
 // CollisionOutline_Impl Implementation:
 
-bool CollisionOutline_Impl::point_inside_contour( const Pointf &point, const Contour &contour )
+#ifndef CL_DISABLE_SSE2
+// Tests the segment p-q against the four segments (x[k],y[k])-(x[k+1],y[k+1]).
+// Performs the same arithmetic as LineSegment2f::get_intersection, returning a bit per intersecting segment.
+static inline int segment_intersection_mask(const Pointf &p, const Pointf &q, const float *x, const float *y, bool bounding_box_test)
+{
+	__m128 sx = _mm_loadu_ps(x);
+	__m128 sy = _mm_loadu_ps(y);
+	__m128 ex = _mm_loadu_ps(x + 1);
+	__m128 ey = _mm_loadu_ps(y + 1);
+
+	__m128 zero = _mm_setzero_ps();
+	__m128 one = _mm_set1_ps(1.0f);
+	__m128 mask = _mm_castsi128_ps(_mm_set1_epi32(-1));
+
+	if( bounding_box_test )
+	{
+		__m128 left   = _mm_set1_ps(min(p.x, q.x));
+		__m128 right  = _mm_set1_ps(max(p.x, q.x));
+		__m128 top    = _mm_set1_ps(min(p.y, q.y));
+		__m128 bottom = _mm_set1_ps(max(p.y, q.y));
+
+		mask = _mm_and_ps(_mm_cmple_ps(_mm_min_ps(sx, ex), right), _mm_cmpge_ps(_mm_max_ps(sx, ex), left));
+		mask = _mm_and_ps(mask, _mm_cmple_ps(_mm_min_ps(sy, ey), bottom));
+		mask = _mm_and_ps(mask, _mm_cmpge_ps(_mm_max_ps(sy, ey), top));
+		if( _mm_movemask_ps(mask) == 0 )
+			return 0;
+	}
+
+	__m128 dx = _mm_set1_ps(q.x - p.x);
+	__m128 dy = _mm_set1_ps(q.y - p.y);
+	__m128 sdx = _mm_sub_ps(ex, sx);
+	__m128 sdy = _mm_sub_ps(ey, sy);
+
+	__m128 denominator = _mm_sub_ps(_mm_mul_ps(dx, sdy), _mm_mul_ps(dy, sdx));
+	__m128 a = _mm_sub_ps(_mm_set1_ps(p.y), sy);
+	__m128 b = _mm_sub_ps(_mm_set1_ps(p.x), sx);
+	__m128 r = _mm_div_ps(_mm_sub_ps(_mm_mul_ps(a, sdx), _mm_mul_ps(b, sdy)), denominator);
+	__m128 s = _mm_div_ps(_mm_sub_ps(_mm_mul_ps(a, dx), _mm_mul_ps(b, dy)), denominator);
+
+	// We use the open interval [0;1) or (0;1] depending on the direction of the second segment
+	__m128 upwards = _mm_cmplt_ps(sy, ey);
+	__m128 s_upwards = _mm_and_ps(_mm_cmpge_ps(s, zero), _mm_cmplt_ps(s, one));
+	__m128 s_downwards = _mm_and_ps(_mm_cmpgt_ps(s, zero), _mm_cmple_ps(s, one));
+	__m128 s_inside = _mm_or_ps(_mm_and_ps(upwards, s_upwards), _mm_andnot_ps(upwards, s_downwards));
+	__m128 r_inside = _mm_and_ps(_mm_cmpge_ps(r, zero), _mm_cmple_ps(r, one));
+
+	mask = _mm_and_ps(mask, _mm_cmpneq_ps(denominator, zero));
+	mask = _mm_and_ps(mask, _mm_and_ps(s_inside, r_inside));
+	return _mm_movemask_ps(mask);
+}
+#endif
+
+void CollisionOutline_Impl::build_world_points(const Contour &contour, ContourWorldPoints &world)
+{
+	const std::vector<Pointf> &points = contour.get_points();
+	int num_points = points.size();
+
+	world.num_points = num_points;
+	world.x.clear();
+	world.y.clear();
+	if( num_points == 0 )
+		return;
+
+	// Two laps plus padding for the unaligned four-wide loads of the segment end points
+	int size = num_points * 2 + 4;
+	world.x.resize(size);
+	world.y.resize(size);
+	BatchMath::deinterleave(&points[0], &world.x[0], &world.y[0], num_points);
+	for( int i = num_points; i < size; ++i )
+	{
+		world.x[i] = world.x[i - num_points];
+		world.y[i] = world.y[i - num_points];
+	}
+}
+
+bool CollisionOutline_Impl::is_range_contiguous(const OutlineCircle &circle, int num_points)
+{
+	return circle.start <= circle.end && circle.end <= (unsigned int)(num_points * 2);
+}
+
+bool CollisionOutline_Impl::point_inside_contour( const Pointf &point, const Contour &contour, const ContourWorldPoints &world )
 {
 	// In case the contour is inside-out (the inside of a hollow polygon) it makes no sense to do this test.
 	if(contour.is_inside_contour())
@@ -615,6 +753,20 @@ bool CollisionOutline_Impl::point_inside_contour( const Pointf &point, const Con
 		if( dist <= circle.radius )
 		{
 			// test each line segment inside the circle
+#ifndef CL_DISABLE_SSE2
+			if( world.num_points == (int)points.size() && is_range_contiguous(circle, world.num_points) )
+			{
+				for( unsigned int i=circle.start; i < circle.end; i += 4 )
+				{
+					int mask = segment_intersection_mask(lineX.p, lineX.q, &world.x[i], &world.y[i], false);
+					if( circle.end - i < 4 )
+						mask &= (1 << (circle.end - i)) - 1;
+					for( ; mask; mask &= mask - 1 )
+						num_intersections_x++;
+				}
+				continue;
+			}
+#endif
 		
 			for( unsigned int i=circle.start; i != circle.end; ++i )
 			{
@@ -651,78 +803,115 @@ inline bool CollisionOutline_Impl::line_bounding_box_overlap( const std::vector<
 	return (r_left <= right && r_right >= left && r_top <= bottom && r_bottom >= top);
 }
 
-bool CollisionOutline_Impl::contours_collide(const Contour &contour1, const Contour &contour2, bool do_subcirle_test)
+bool CollisionOutline_Impl::intersect_segments(CollidingContours &metadata, const std::vector<Pointf> &points1, const std::vector<Pointf> &points2, int i, int i2, int j, int j2)
+{
+	LineSegment2f line1(points1[i], points1[i2]);
+	LineSegment2f line2(points2[j], points2[j2]);
+	Pointf dest_intercept;
+
+	bool did_intersect;
+	dest_intercept = line1.get_intersection( line2, did_intersect );
+	if( did_intersect && collision_info_collect )
+	{
+		CollisionPoint collisionpoint;
+		
+		if ( collision_info_points )
+		{
+			collisionpoint.point = dest_intercept;
+		}
+		
+		if( collision_info_normals )
+		{
+			collisionpoint.normal = line2.normal();
+		}
+		
+		if( collision_info_meta )
+		{
+			collisionpoint.contour1_line_start = i;
+			collisionpoint.contour1_line_end   = i2;
+			collisionpoint.contour2_line_start = j;
+			collisionpoint.contour2_line_end   = j2;
+			// Found by the dot-product of line1 and the perpendicular of line2:
+			{
+				Pointf line1(points1[i2].x - points1[i].x, points1[i2].y - points1[i].y);
+				Pointf line2(-(points2[j2].y - points2[j].y), points2[j2].x - points2[j].x);
+				collisionpoint.is_entry = (line1.x * line2.x + line1.y * line2.y) < 0.0;
+			}
+		}
+		metadata.points.push_back(collisionpoint);
+	}
+	return did_intersect;
+}
+
+bool CollisionOutline_Impl::contours_collide(const Contour &contour1, const Contour &contour2, const ContourWorldPoints &world2, const Circlef &disc2)
 {
 	CollidingContours metadata(&contour1, &contour2);
+
+	const std::vector<Pointf> &points1 = contour1.get_points();
+	const std::vector<Pointf> &points2 = contour2.get_points();
 	
+	int num_points1 = points1.size();
+	int num_points2 = points2.size();
+
 	std::vector<OutlineCircle>::const_iterator it_oc1, it_oc2;
 	for( it_oc1 = contour1.get_sub_circles().begin(); it_oc1 != contour1.get_sub_circles().end(); ++it_oc1 )
 	{
+		// Sub-circles outside the other outline's enclosing disc cannot hit any of its sub-circles
+		Pointf disc_delta = (*it_oc1).position - disc2.position;
+		float disc_distance = (*it_oc1).radius + disc2.radius;
+		if( disc_delta.x * disc_delta.x + disc_delta.y * disc_delta.y > disc_distance * disc_distance )
+			continue;
+
 		for( it_oc2 = contour2.get_sub_circles().begin(); it_oc2 != contour2.get_sub_circles().end(); ++it_oc2 )
 		{
-			if( do_subcirle_test ? (*it_oc1).collide(*it_oc2) : true ) // outline circles collide
+			if( (*it_oc1).collide(*it_oc2) ) // outline circles collide
 			{
 				// test each line segment inside the colliding circles
+				const OutlineCircle &circle2 = (*it_oc2);
+#ifndef CL_DISABLE_SSE2
+				bool vectorize = world2.num_points == num_points2 && is_range_contiguous(circle2, num_points2);
+#endif
 
-				const std::vector<Pointf> &points1 = contour1.get_points();
-				const std::vector<Pointf> &points2 = contour2.get_points();
-				
-				int num_points1 = points1.size();
-				int num_points2 = points2.size();
-				
 				for( unsigned int counter_i=(*it_oc1).start; counter_i != (*it_oc1).end; ++counter_i )
 				{
 					int i  = counter_i % num_points1;
 					int i2 = (counter_i+1) % num_points1;
-					
-					for( unsigned int counter_j=(*it_oc2).start; counter_j != (*it_oc2).end; ++counter_j )
+
+#ifndef CL_DISABLE_SSE2
+					if( vectorize )
 					{
-						int j  = counter_j % num_points2;
-						int j2 = (counter_j+1) % num_points2;
-						
-						if( line_bounding_box_overlap(points1, points2, i, j, i2, j2) )
+						// Four segments at a time; only the lanes that hit are redone by the exact scalar test
+						for( unsigned int counter_j=circle2.start; counter_j < circle2.end; counter_j += 4 )
 						{
-							LineSegment2f line1(points1[i], points1[i2]);
-							LineSegment2f line2(points2[j], points2[j2]);
-							Pointf dest_intercept;
+							int mask = segment_intersection_mask(points1[i], points1[i2], &world2.x[counter_j], &world2.y[counter_j], true);
+							if( circle2.end - counter_j < 4 )
+								mask &= (1 << (circle2.end - counter_j)) - 1;
 
-							bool did_intersect;
-							dest_intercept = line1.get_intersection( line2, did_intersect );
-							if( did_intersect )
+							for( int lane = 0; mask; ++lane, mask >>= 1 )
 							{
-								if( collision_info_collect )
-								{
-									CollisionPoint collisionpoint;
-									
-									if ( collision_info_points )
-									{
-										collisionpoint.point = dest_intercept;
-									}
-									
-									if( collision_info_normals )
-									{
-										collisionpoint.normal = line2.normal();
-									}
-									
-									if( collision_info_meta )
-									{
-										collisionpoint.contour1_line_start = i;
-										collisionpoint.contour1_line_end   = i2;
-										collisionpoint.contour2_line_start = j;
-										collisionpoint.contour2_line_end   = j2;
-										// Found by the dot-product of line1 and the perpendicular of line2:
-										{
-											Pointf line1(points1[i2].x - points1[i].x, points1[i2].y - points1[i].y);
-											Pointf line2(-(points2[j2].y - points2[j].y), points2[j2].x - points2[j].x);
-											collisionpoint.is_entry = (line1.x * line2.x + line1.y * line2.y) < 0.0;
-										}
-									}
-									metadata.points.push_back(collisionpoint);
-								}
-								else
+								if( (mask & 1) == 0 )
+									continue;
+
+								int j  = (counter_j+lane) % num_points2;
+								int j2 = (counter_j+lane+1) % num_points2;
+								if( intersect_segments(metadata, points1, points2, i, i2, j, j2) && !collision_info_collect )
 									return true;
 							}
 						}
+						continue;
+					}
+#endif
+
+					for( unsigned int counter_j=circle2.start; counter_j != circle2.end; ++counter_j )
+					{
+						int j  = counter_j % num_points2;
+						int j2 = (counter_j+1) % num_points2;
+						
+						if( line_bounding_box_overlap(points1, points2, i, j, i2, j2) )
+						{
+							if( intersect_segments(metadata, points1, points2, i, i2, j, j2) && !collision_info_collect )
+								return true;
+						}
 					}
 				}
 			}
@@ -36,12 +36,28 @@
 #include "API/Display/Collision/outline_circle.h"
 #include "API/Display/Collision/outline_accuracy.h"
 #include "API/Core/IOData/file_system.h"
+#include "API/Core/Math/line_segment.h"
 
 namespace clan
 {
 
 class OutlineProvider;
 
+/// \brief Structure-of-arrays copy of a contour's points in world space
+///
+/// The points are stored twice in a row (plus padding), so a segment range
+/// of a sub-circle that wraps around the end of the contour can be read
+/// contiguously by the vectorized segment tests.
+class ContourWorldPoints
+{
+public:
+	ContourWorldPoints() : num_points(0) { }
+
+	std::vector<float> x;
+	std::vector<float> y;
+	int num_points;
+};
+
 class CollisionOutline_Impl
 {
 /// \name Construction
@@ -83,6 +99,16 @@ public:
 
 	std::vector<CollidingContours> collision_info;
 
+	///< Incremented whenever the minimum enclosing disc may have changed
+	unsigned int transform_version;
+
+	///< Translation not yet applied to the contour points and sub-circles
+	Pointf pending_translation;
+
+	///< Per contour SoA copy of the points, valid unless world_points_dirty is set
+	std::vector<ContourWorldPoints> world_points;
+	bool world_points_dirty;
+
 
 /// \}
 /// \name Operations
@@ -94,13 +120,25 @@ public:
 	void set_angle(const Angle &angle);
 	void rotate(const Angle &angle);
 
+	/// \brief Moves the contour points and sub-circles by the pending translation
+	void apply_pending_translation();
+
+	/// \brief Applies any pending translation and rebuilds the SoA point cache if needed
+	///
+	/// Must be called before the contours are read. Not thread safe; the
+	/// const collision tests assume it has been called for both outlines.
+	void update_world_points();
+
+	/// \brief Flags the SoA point cache for rebuilding (the contours may have been modified)
+	void invalidate_world_points() { world_points_dirty = true; }
+
 	void optimize(unsigned char check_distance, float corner_angle);
 	void save(IODevice &file) const;
 
 	bool collide( const CollisionOutline &outline, bool remove_old_collision_info);
-	bool point_inside( const Pointf &point ) const;
-	static bool point_inside_contour( const Pointf &point, const Contour &contour);
-	bool contours_collide(const Contour &contour1, const Contour &contour2, bool do_subcirle_test=true);
+	bool point_inside( const Pointf &point );
+	static bool point_inside_contour( const Pointf &point, const Contour &contour, const ContourWorldPoints &world);
+	bool contours_collide(const Contour &contour1, const Contour &contour2, const ContourWorldPoints &world2, const Circlef &disc2);
 	static void calculate_penetration_depth(std::vector<CollidingContours> &collision_info);
 
 	void calculate_radius();
@@ -116,6 +154,11 @@ public:
 /// \name Implementation
 /// \{
 
+private:
+	bool intersect_segments(CollidingContours &metadata, const std::vector<Pointf> &points1, const std::vector<Pointf> &points2, int i, int i2, int j, int j2);
+	void rotate_around(const Pointf &hotspot, const Angle &angle);
+	static void build_world_points(const Contour &contour, ContourWorldPoints &world);
+	static bool is_range_contiguous(const OutlineCircle &circle, int num_points);
 /// \}
 };
 
@@ -0,0 +1,385 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2015 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    agent
+*/
+
+#include "Display/precomp.h"
+#include "API/Display/Collision/collision_world.h"
+#include "API/Core/System/event.h"
+#include "API/Core/System/interlocked_variable.h"
+#include "API/Core/System/mutex.h"
+#include "API/Core/System/system.h"
+#include "collision_world_impl.h"
+#include <algorithm>
+#include <cmath>
+#include <exception>
+
+namespace clan
+{
+
+/////////////////////////////////////////////////////////////////////////////
+// CollisionWorld Construction:
+
+CollisionWorld::CollisionWorld(float cell_size) : impl(std::make_shared<CollisionWorld_Impl>(cell_size))
+{
+}
+
+CollisionWorld::~CollisionWorld()
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CollisionWorld Attributes:
+
+float CollisionWorld::get_cell_size() const
+{
+	return impl->cell_size;
+}
+
+int CollisionWorld::get_outline_count() const
+{
+	return impl->outline_count;
+}
+
+CollisionOutline &CollisionWorld::get_outline(int handle)
+{
+	if (handle < 0 || handle >= (int)impl->entries.size() || !impl->entries[handle].in_use)
+		throw Exception("Invalid collision world handle");
+	return impl->entries[handle].outline;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CollisionWorld Operations:
+
+int CollisionWorld::add(const CollisionOutline &outline)
+{
+	return impl->add(outline);
+}
+
+void CollisionWorld::remove(int handle)
+{
+	impl->remove(handle);
+}
+
+void CollisionWorld::clear()
+{
+	impl->clear();
+}
+
+void CollisionWorld::update()
+{
+	impl->update();
+}
+
+const std::vector<CollisionWorldPair> &CollisionWorld::find_candidate_pairs()
+{
+	impl->update();
+	impl->find_candidate_pairs();
+	return impl->candidate_pairs;
+}
+
+const std::vector<CollisionWorldPair> &CollisionWorld::find_colliding_pairs(int num_threads)
+{
+	impl->update();
+	impl->find_candidate_pairs();
+	impl->find_colliding_pairs(num_threads);
+	return impl->colliding_pairs;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CollisionWorld_Impl Construction:
+
+CollisionWorld_Impl::CollisionWorld_Impl(float cell_size) : cell_size(cell_size)
+{
+	if (cell_size <= 0.0f)
+		throw Exception("Collision world cell size must be positive");
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CollisionWorld_Impl Operations:
+
+int CollisionWorld_Impl::add(const CollisionOutline &outline)
+{
+	int handle;
+	if (!free_handles.empty())
+	{
+		handle = free_handles.back();
+		free_handles.pop_back();
+	}
+	else
+	{
+		handle = (int)entries.size();
+		entries.push_back(Entry());
+	}
+
+	Entry &entry = entries[handle];
+	entry.outline = outline;
+	entry.in_use = true;
+	entry.transform_version = get_transform_version(outline);
+	insert_into_cells(handle);
+
+	outline_count++;
+	return handle;
+}
+
+void CollisionWorld_Impl::remove(int handle)
+{
+	if (handle < 0 || handle >= (int)entries.size() || !entries[handle].in_use)
+		throw Exception("Invalid collision world handle");
+
+	remove_from_cells(handle);
+	entries[handle] = Entry();
+	free_handles.push_back(handle);
+	outline_count--;
+}
+
+void CollisionWorld_Impl::clear()
+{
+	entries.clear();
+	free_handles.clear();
+	cells.clear();
+	candidate_pairs.clear();
+	colliding_pairs.clear();
+	outline_count = 0;
+}
+
+void CollisionWorld_Impl::update()
+{
+	for (int handle = 0; handle < (int)entries.size(); handle++)
+	{
+		Entry &entry = entries[handle];
+		if (!entry.in_use)
+			continue;
+
+		unsigned int version = get_transform_version(entry.outline);
+		if (version == entry.transform_version)
+			continue;
+		entry.transform_version = version;
+
+		int x0, y0, x1, y1;
+		get_cell_range(entry.outline.get_minimum_enclosing_disc(), x0, y0, x1, y1);
+		if (x0 != entry.cell_x0 || y0 != entry.cell_y0 || x1 != entry.cell_x1 || y1 != entry.cell_y1)
+		{
+			remove_from_cells(handle);
+			insert_into_cells(handle);
+		}
+	}
+}
+
+void CollisionWorld_Impl::find_candidate_pairs()
+{
+	candidate_pairs.clear();
+
+	for (auto &it : cells)
+	{
+		const Cell &cell = it.second;
+		const std::vector<int> &handles = cell.handles;
+		for (size_t i = 0; i < handles.size(); i++)
+		{
+			const Entry &entry1 = entries[handles[i]];
+			Circlef disc1 = entry1.outline.get_minimum_enclosing_disc();
+
+			for (size_t j = i + 1; j < handles.size(); j++)
+			{
+				const Entry &entry2 = entries[handles[j]];
+
+				// Only report the pair in the first cell both outlines share
+				if (std::max(entry1.cell_x0, entry2.cell_x0) != cell.x || std::max(entry1.cell_y0, entry2.cell_y0) != cell.y)
+					continue;
+
+				Circlef disc2 = entry2.outline.get_minimum_enclosing_disc();
+				float dx = disc2.position.x - disc1.position.x;
+				float dy = disc2.position.y - disc1.position.y;
+				float radius = disc1.radius + disc2.radius;
+				if (dx * dx + dy * dy <= radius * radius)
+					candidate_pairs.push_back(CollisionWorldPair(std::min(handles[i], handles[j]), std::max(handles[i], handles[j])));
+			}
+		}
+	}
+}
+
+/// \brief Blocks of pairs shared between the calling thread and the work queue threads
+class CollisionWorld_Job
+{
+public:
+	CollisionWorld_Job(int num_blocks) : num_blocks(num_blocks)
+	{
+		blocks_left.set(num_blocks);
+	}
+
+	int num_blocks;
+	InterlockedVariable next_block;
+	InterlockedVariable blocks_left;
+	Event done;
+
+	Mutex mutex;
+	std::exception_ptr exception;
+};
+
+void CollisionWorld_Impl::find_colliding_pairs(int num_threads)
+{
+	colliding_pairs.clear();
+
+	// CollisionOutline::collide writes collision info to the first outline, so those pairs cannot run in parallel
+	std::vector<CollisionWorldPair> parallel_pairs;
+	parallel_pairs.reserve(candidate_pairs.size());
+	for (const auto &pair : candidate_pairs)
+	{
+		CollisionOutline &outline1 = entries[pair.outline1].outline;
+		if (collects_info(outline1))
+		{
+			if (outline1.collide(entries[pair.outline2].outline))
+				colliding_pairs.push_back(pair);
+		}
+		else
+		{
+			// Bring the cached world points up to date here, since collide would otherwise do it from several threads
+			outline1.impl->update_world_points();
+			entries[pair.outline2].outline.impl->update_world_points();
+			parallel_pairs.push_back(pair);
+		}
+	}
+
+	// Split the pairs into blocks. The calling thread and the work queue threads each take the next block
+	// until none are left.
+	int num_blocks = (int)((parallel_pairs.size() + pairs_per_block - 1) / pairs_per_block);
+	if (num_threads <= 0)
+		num_threads = System::get_num_cores();
+	num_threads = std::min(num_threads, num_blocks);
+
+	std::vector<char> results(parallel_pairs.size());
+	if (num_threads <= 1)
+	{
+		for (size_t i = 0; i < parallel_pairs.size(); i++)
+			results[i] = entries[parallel_pairs[i].outline1].outline.collide(entries[parallel_pairs[i].outline2].outline) ? 1 : 0;
+	}
+	else
+	{
+		if (!work_queue)
+			work_queue.reset(new WorkQueue());
+
+		auto job = std::make_shared<CollisionWorld_Job>(num_blocks);
+		auto process_blocks = [=, &parallel_pairs, &results]()
+		{
+			while (true)
+			{
+				int block = job->next_block.increment() - 1;
+				if (block >= job->num_blocks)
+					break;
+
+				// Keep going after an exception, so the calling thread always gets to wait for all the blocks
+				try
+				{
+					size_t end = std::min((size_t)(block + 1) * pairs_per_block, parallel_pairs.size());
+					for (size_t i = (size_t)block * pairs_per_block; i < end; i++)
+						results[i] = entries[parallel_pairs[i].outline1].outline.collide(entries[parallel_pairs[i].outline2].outline) ? 1 : 0;
+				}
+				catch (...)
+				{
+					MutexSection mutex_lock(&job->mutex);
+					if (!job->exception)
+						job->exception = std::current_exception();
+				}
+
+				if (job->blocks_left.decrement() == 0)
+					job->done.set();
+			}
+		};
+
+		for (int i = 1; i < num_threads; i++)
+			work_queue->queue(process_blocks);
+		process_blocks();
+
+		job->done.wait();
+		if (job->exception)
+			std::rethrow_exception(job->exception);
+	}
+
+	for (size_t i = 0; i < parallel_pairs.size(); i++)
+	{
+		if (results[i])
+			colliding_pairs.push_back(parallel_pairs[i]);
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// CollisionWorld_Impl Implementation:
+
+void CollisionWorld_Impl::insert_into_cells(int handle)
+{
+	Entry &entry = entries[handle];
+	get_cell_range(entry.outline.get_minimum_enclosing_disc(), entry.cell_x0, entry.cell_y0, entry.cell_x1, entry.cell_y1);
+
+	for (int y = entry.cell_y0; y <= entry.cell_y1; y++)
+	{
+		for (int x = entry.cell_x0; x <= entry.cell_x1; x++)
+		{
+			Cell &cell = cells[cell_key(x, y)];
+			cell.x = x;
+			cell.y = y;
+			cell.handles.push_back(handle);
+		}
+	}
+	entry.in_grid = true;
+}
+
+void CollisionWorld_Impl::remove_from_cells(int handle)
+{
+	Entry &entry = entries[handle];
+	if (!entry.in_grid)
+		return;
+
+	for (int y = entry.cell_y0; y <= entry.cell_y1; y++)
+	{
+		for (int x = entry.cell_x0; x <= entry.cell_x1; x++)
+		{
+			auto it = cells.find(cell_key(x, y));
+			if (it == cells.end())
+				continue;
+
+			std::vector<int> &handles = it->second.handles;
+			auto it_handle = std::find(handles.begin(), handles.end(), handle);
+			if (it_handle != handles.end())
+			{
+				*it_handle = handles.back();
+				handles.pop_back();
+			}
+			if (handles.empty())
+				cells.erase(it);
+		}
+	}
+	entry.in_grid = false;
+}
+
+void CollisionWorld_Impl::get_cell_range(const Circlef &disc, int &x0, int &y0, int &x1, int &y1) const
+{
+	x0 = (int)std::floor((disc.position.x - disc.radius) / cell_size);
+	y0 = (int)std::floor((disc.position.y - disc.radius) / cell_size);
+	x1 = (int)std::floor((disc.position.x + disc.radius) / cell_size);
+	y1 = (int)std::floor((disc.position.y + disc.radius) / cell_size);
+}
+
+}
@@ -0,0 +1,108 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2015 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    agent
+*/
+
+#pragma once
+
+#include "API/Display/Collision/collision_world.h"
+#include "API/Core/System/work_queue.h"
+#include "collision_outline_generic.h"
+#include <unordered_map>
+#include <memory>
+
+namespace clan
+{
+
+class CollisionWorld_Impl
+{
+/// \name Construction
+/// \{
+
+public:
+	CollisionWorld_Impl(float cell_size);
+
+/// \}
+/// \name Attributes
+/// \{
+
+public:
+	struct Entry
+	{
+		CollisionOutline outline;
+		bool in_use = false;
+		bool in_grid = false;
+		unsigned int transform_version = 0;
+		int cell_x0 = 0, cell_y0 = 0, cell_x1 = 0, cell_y1 = 0;
+	};
+
+	struct Cell
+	{
+		int x = 0, y = 0;
+		std::vector<int> handles;
+	};
+
+	float cell_size;
+	std::vector<Entry> entries;
+	std::vector<int> free_handles;
+	int outline_count = 0;
+
+	std::unordered_map<ubyte64, Cell> cells;
+
+	std::vector<CollisionWorldPair> candidate_pairs;
+	std::vector<CollisionWorldPair> colliding_pairs;
+
+	std::unique_ptr<WorkQueue> work_queue;
+
+/// \}
+/// \name Operations
+/// \{
+
+public:
+	int add(const CollisionOutline &outline);
+	void remove(int handle);
+	void clear();
+	void update();
+	void find_candidate_pairs();
+	void find_colliding_pairs(int num_threads);
+
+/// \}
+/// \name Implementation
+/// \{
+
+private:
+	void insert_into_cells(int handle);
+	void remove_from_cells(int handle);
+	void get_cell_range(const Circlef &disc, int &x0, int &y0, int &x1, int &y1) const;
+	static ubyte64 cell_key(int x, int y) { return (static_cast<ubyte64>(static_cast<ubyte32>(x)) << 32) | static_cast<ubyte32>(y); }
+	static bool collects_info(const CollisionOutline &outline) { return outline.impl->collision_info_collect; }
+	enum { pairs_per_block = 64 };
+
+	static unsigned int get_transform_version(const CollisionOutline &outline) { return outline.impl->transform_version; }
+/// \}
+};
+
+}
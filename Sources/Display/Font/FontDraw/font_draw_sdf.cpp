@@ -0,0 +1,116 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2015 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    agent
+*/
+
+#include "Display/precomp.h"
+#include "API/Display/Font/font.h"
+#include "API/Display/Font/font_metrics.h"
+#include "API/Display/Render/graphic_context.h"
+#include "API/Core/Text/utf8_reader.h"
+#include "API/Display/2D/canvas.h"
+#include "API/Display/2D/path.h"
+#include "../../2D/canvas_impl.h"
+#include "../FontEngine/font_engine.h"
+#include "font_draw_sdf.h"
+#include "../sdf_glyph_cache.h"
+#include "../path_cache.h"
+
+namespace clan
+{
+
+	void Font_DrawSDF::init(SdfGlyphCache *cache, PathCache *fallback_cache, FontEngine *engine, float new_scaled_height)
+	{
+		sdf_cache = cache;
+		path_cache = fallback_cache;
+		font_engine = engine;
+		scaled_height = new_scaled_height;
+		font_draw_path.init(path_cache, font_engine, scaled_height);
+	}
+
+	GlyphMetrics Font_DrawSDF::get_metrics(Canvas &canvas, unsigned int glyph)
+	{
+		return path_cache->get_metrics(font_engine, canvas, glyph);
+	}
+
+	void Font_DrawSDF::draw_text(Canvas &canvas, const Pointf &position, const std::string &text, const Colorf &color, float line_spacing)
+	{
+		// The distance field program only exists for the GLSL targets
+		if (canvas.get_gc().get_shader_language() != shader_glsl)
+		{
+			font_draw_path.draw_text(canvas, position, text, color, line_spacing);
+			return;
+		}
+
+		float offset_x = 0;
+		float offset_y = 0;
+		UTF8_Reader reader(text.data(), text.length());
+		RenderBatchTriangle *batcher = canvas.impl->batcher.get_triangle_batcher();
+
+		while (!reader.is_end())
+		{
+			unsigned int glyph = reader.get_char();
+			reader.next();
+
+			if (glyph == '\n')
+			{
+				offset_x = 0;
+				offset_y += line_spacing * scaled_height;
+				continue;
+			}
+
+			Font_TextureGlyph *gptr = sdf_cache->get_glyph(canvas, font_engine, glyph);
+			if (gptr)
+			{
+				if (!gptr->texture.is_null())
+				{
+					float xp = position.x + offset_x + gptr->offset.x * scaled_height;
+					float yp = position.y + offset_y + gptr->offset.y * scaled_height;
+
+					Rectf dest_size(xp, yp, Sizef(gptr->geometry.get_size()) * scaled_height);
+					batcher->draw_glyph_sdf(canvas, gptr->geometry, dest_size, color, gptr->texture);
+				}
+				offset_x += gptr->metrics.advance.width * scaled_height;
+				offset_y += gptr->metrics.advance.height * scaled_height;
+			}
+			else
+			{
+				// The font engine cannot create distance fields, so draw this glyph as a path
+				Font_PathGlyph *path_glyph = path_cache->get_glyph(canvas, font_engine, glyph);
+				if (path_glyph)
+				{
+					const Mat4f original_transform = canvas.get_transform();
+					canvas.set_transform(original_transform * Mat4f::translate(position.x + offset_x, position.y + offset_y, 0) * Mat4f::scale(scaled_height, scaled_height, scaled_height));
+					path_glyph->path.fill(canvas, Brush(color));
+					canvas.set_transform(original_transform);
+					offset_x += path_glyph->metrics.advance.width * scaled_height;
+					offset_y += path_glyph->metrics.advance.height * scaled_height;
+				}
+			}
+		}
+	}
+
+}
@@ -80,6 +80,7 @@ public:
 	virtual DataBuffer get_databuffer() = 0;		// Get the font databuffer that was used to create the font. Empty when databuffer is not required or font registered with the OS
 	virtual const FontDescription &get_desc() const = 0;
 	virtual void load_glyph_path(unsigned int glyph_index, Path &out_path, GlyphMetrics &out_metrics) = 0;
+	virtual FontPixelBuffer get_font_glyph_sdf(int glyph, int spread) { return FontPixelBuffer(); }	// Signed distance field of the glyph outline, "spread" pixels each side of the edge. glyph is 0 when the engine cannot create distance fields
 
 };
 
@@ -36,6 +36,9 @@
 #include "font_engine_freetype.h"
 #include "API/Core/IOData/iodevice.h"
 #include "API/Display/2D/path.h"
+#include "../../2D/path_impl.h"
+#include <algorithm>
+#include <cmath>
 
 namespace clan
 {
@@ -460,6 +463,199 @@ FontPixelBuffer FontEngine_Freetype::get_font_glyph_subpixel(int glyph)
 	return font_buffer;
 }
 
+FontPixelBuffer FontEngine_Freetype::get_font_glyph_sdf(int glyph, int spread)
+{
+	FontPixelBuffer font_buffer;
+
+	// Bitmap fonts do not have outlines to measure the distance from
+	if (!FT_IS_SCALABLE(face))
+		return font_buffer;
+
+	Path path;
+	load_glyph_path(glyph, path, font_buffer.metrics);
+	font_buffer.glyph = glyph;
+
+	// Flatten the outline into line segments
+	std::vector<Pointf> edges;
+	const int curve_steps = 8;
+	for (const auto &subpath : path.get_impl()->subpaths)
+	{
+		if (subpath.commands.empty())
+			continue;
+
+		Pointf current = subpath.points[0];
+		size_t point_index = 1;
+		for (auto command : subpath.commands)
+		{
+			if (command == PathCommand::line)
+			{
+				edges.push_back(current);
+				edges.push_back(subpath.points[point_index]);
+				current = subpath.points[point_index++];
+			}
+			else if (command == PathCommand::quadradic)
+			{
+				Pointf start = current;
+				Pointf control = subpath.points[point_index];
+				Pointf end = subpath.points[point_index + 1];
+				point_index += 2;
+				for (int step = 1; step <= curve_steps; step++)
+				{
+					float t = step / (float)curve_steps;
+					float mt = 1.0f - t;
+					Pointf next = start * (mt * mt) + control * (2.0f * mt * t) + end * (t * t);
+					edges.push_back(current);
+					edges.push_back(next);
+					current = next;
+				}
+				current = end;
+			}
+			else
+			{
+				Pointf start = current;
+				Pointf control1 = subpath.points[point_index];
+				Pointf control2 = subpath.points[point_index + 1];
+				Pointf end = subpath.points[point_index + 2];
+				point_index += 3;
+				for (int step = 1; step <= curve_steps; step++)
+				{
+					float t = step / (float)curve_steps;
+					float mt = 1.0f - t;
+					Pointf next = start * (mt * mt * mt) + control1 * (3.0f * mt * mt * t) + control2 * (3.0f * mt * t * t) + end * (t * t * t);
+					edges.push_back(current);
+					edges.push_back(next);
+					current = next;
+				}
+				current = end;
+			}
+		}
+
+		if (current != subpath.points[0])
+		{
+			edges.push_back(current);
+			edges.push_back(subpath.points[0]);
+		}
+	}
+
+	if (edges.empty())
+		return font_buffer;	// For example, the space glyph
+
+	Pointf min_point = edges[0];
+	Pointf max_point = edges[0];
+	for (const auto &point : edges)
+	{
+		min_point.x = std::min(min_point.x, point.x);
+		min_point.y = std::min(min_point.y, point.y);
+		max_point.x = std::max(max_point.x, point.x);
+		max_point.y = std::max(max_point.y, point.y);
+	}
+
+	int left = (int)std::floor(min_point.x) - spread;
+	int top = (int)std::floor(min_point.y) - spread;
+	int width = (int)std::ceil(max_point.x) + spread - left;
+	int height = (int)std::ceil(max_point.y) + spread - top;
+
+	PixelBuffer pixelbuffer(width, height, tf_rgba8);
+	font_buffer.buffer = pixelbuffer;
+	font_buffer.buffer_rect = pixelbuffer.get_size();
+	font_buffer.empty_buffer = false;
+	font_buffer.offset = Point(left, top);
+
+	unsigned char *pixel_data = (unsigned char *)font_buffer.buffer.get_data();
+	int dest_pitch = font_buffer.buffer.get_pitch();
+	const int num_edges = (int)(edges.size() / 2);
+	const float scale = 0.5f / spread;
+
+	// Distances of spread pixels or more all clamp to the same value, so a pixel only has to measure the edges
+	// whose bounding box grown by spread covers it. Bucket the edges into cells of the bitmap by those boxes.
+	const int cell_size = 8;
+	int cells_x = (width + cell_size - 1) / cell_size;
+	int cells_y = (height + cell_size - 1) / cell_size;
+	std::vector<std::vector<int> > cells(cells_x * cells_y);
+	for (int edge = 0; edge < num_edges; edge++)
+	{
+		const Pointf &a = edges[edge * 2];
+		const Pointf &b = edges[edge * 2 + 1];
+		int cell_left = std::max(0, (int)std::floor((std::min(a.x, b.x) - spread - left) / cell_size));
+		int cell_right = std::min(cells_x - 1, (int)std::floor((std::max(a.x, b.x) + spread - left) / cell_size));
+		int cell_top = std::max(0, (int)std::floor((std::min(a.y, b.y) - spread - top) / cell_size));
+		int cell_bottom = std::min(cells_y - 1, (int)std::floor((std::max(a.y, b.y) + spread - top) / cell_size));
+		for (int cell_y = cell_top; cell_y <= cell_bottom; cell_y++)
+		{
+			for (int cell_x = cell_left; cell_x <= cell_right; cell_x++)
+				cells[cell_y * cells_x + cell_x].push_back(edge);
+		}
+	}
+
+	std::vector<std::pair<float, int> > crossings;
+	for (int ycnt = 0; ycnt < height; ycnt++)
+	{
+		unsigned char *dest_data = pixel_data;
+		float py = top + ycnt + 0.5f;
+
+		// Non-zero winding rule, to match PathFillMode::winding used by the glyph path.
+		// Upward edges crossing the row to the right of a pixel count +1, downward edges -1.
+		crossings.clear();
+		int winding = 0;
+		for (int edge = 0; edge < num_edges; edge++)
+		{
+			const Pointf &a = edges[edge * 2];
+			const Pointf &b = edges[edge * 2 + 1];
+			if ((a.y <= py) != (b.y <= py))
+			{
+				float crossing_x = a.x + (py - a.y) * (b.x - a.x) / (b.y - a.y);
+				int direction = b.y > a.y ? 1 : -1;
+				crossings.push_back(std::make_pair(crossing_x, direction));
+				winding += direction;
+			}
+		}
+		std::sort(crossings.begin(), crossings.end());
+		size_t next_crossing = 0;
+
+		const std::vector<int> *cell = nullptr;
+		for (int xcnt = 0; xcnt < width; xcnt++)
+		{
+			float px = left + xcnt + 0.5f;
+			while (next_crossing < crossings.size() && crossings[next_crossing].first <= px)
+				winding -= crossings[next_crossing++].second;
+
+			if (xcnt % cell_size == 0)
+				cell = &cells[(ycnt / cell_size) * cells_x + xcnt / cell_size];
+
+			float min_distance_squared = (float)(spread * spread);
+			for (int edge : *cell)
+			{
+				const Pointf &a = edges[edge * 2];
+				const Pointf &b = edges[edge * 2 + 1];
+
+				// Distance to the segment
+				float dx = b.x - a.x;
+				float dy = b.y - a.y;
+				float length_squared = dx * dx + dy * dy;
+				float t = 0.0f;
+				if (length_squared > 0.0f)
+					t = std::max(0.0f, std::min(1.0f, ((px - a.x) * dx + (py - a.y) * dy) / length_squared));
+				float cx = a.x + t * dx - px;
+				float cy = a.y + t * dy - py;
+				min_distance_squared = std::min(min_distance_squared, cx * cx + cy * cy);
+			}
+
+			float distance = std::sqrt(min_distance_squared);
+			if (winding == 0)
+				distance = -distance;
+			float value = std::max(0.0f, std::min(1.0f, 0.5f + distance * scale));
+
+			*(dest_data++) = 255;
+			*(dest_data++) = 255;
+			*(dest_data++) = 255;
+			*(dest_data++) = (unsigned char)(value * 255.0f + 0.5f);
+		}
+		pixel_data += dest_pitch;
+	}
+
+	return font_buffer;
+}
+
 /////////////////////////////////////////////////////////////////////////////
 // FontEngine_Freetype Implementation:
 
@@ -85,6 +85,8 @@ public:
 	FontPixelBuffer get_font_glyph_standard(int glyph, bool anti_alias);
 
 	FontPixelBuffer get_font_glyph_subpixel(int glyph);
+
+	FontPixelBuffer get_font_glyph_sdf(int glyph, int spread) override;
 	const FontDescription &get_desc() const override { return font_description; }
 	DataBuffer get_databuffer() override { return data_buffer; }
 
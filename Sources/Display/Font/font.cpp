@@ -259,6 +259,12 @@ void Font::set_scalable(float height_threshold)
 		impl->set_scalable(height_threshold);
 }
 
+void Font::set_distance_field(bool enable)
+{
+	if (impl)
+		impl->set_distance_field(enable);
+}
+
 GlyphMetrics Font::get_metrics(Canvas &canvas, unsigned int glyph)
 {
 	if (impl)
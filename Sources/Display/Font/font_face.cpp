@@ -60,6 +60,11 @@ namespace clan
 		return impl->get_family_name();
 	}
 
+	int FontFace::get_texture_memory_usage() const
+	{
+		return impl->get_texture_memory_usage();
+	}
+
 	void FontFace::add(const std::string &typeface_name, int height)
 	{
 		FontDescription desc;
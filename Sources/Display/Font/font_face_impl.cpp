@@ -77,7 +77,7 @@ namespace clan
 		FontMetrics font_metrics;
 	};
 
-	FontFace_Impl::FontFace_Impl(const std::string &family_name) : family_name(family_name), texture_group(Size(256, 256))
+	FontFace_Impl::FontFace_Impl(const std::string &family_name) : family_name(family_name), texture_group(Size(256, 256), RectPacker::skyline_bottom_left), sdf_texture_group(Size(512, 512), RectPacker::skyline_bottom_left)
 	{
 	}
 
@@ -115,6 +115,7 @@ namespace clan
 		font_cache.push_back(Font_Cache(engine));
 #endif
 		font_cache.back().glyph_cache->set_texture_group(texture_group);
+		font_cache.back().sdf_cache->set_texture_group(sdf_texture_group);
 	}
 
 	void FontFace_Impl::load_font(Canvas &canvas, Sprite &sprite, const std::string &glyph_list, int spacelen, bool monospace, const FontMetrics &metrics)
@@ -308,4 +309,15 @@ namespace clan
 		return font_cache.back();
 	}
 
+	int FontFace_Impl::get_texture_memory_usage() const
+	{
+		return get_texture_memory_usage(texture_group) + get_texture_memory_usage(sdf_texture_group);
+	}
+
+	int FontFace_Impl::get_texture_memory_usage(const TextureGroup &group)
+	{
+		Size size = group.get_texture_sizes();
+		return group.get_texture_count() * size.width * size.height * 4;
+	}
+
 }
@@ -38,6 +38,7 @@
 #include <map>
 #include "glyph_cache.h"
 #include "path_cache.h"
+#include "sdf_glyph_cache.h"
 
 namespace clan
 {
@@ -57,10 +58,11 @@ class Font_Cache
 {
 public:
 	Font_Cache() {}
-	Font_Cache(std::shared_ptr<FontEngine> &new_engine) : engine(new_engine), glyph_cache(std::make_shared<GlyphCache>()), path_cache(std::make_shared<PathCache>()) {}
+	Font_Cache(std::shared_ptr<FontEngine> &new_engine) : engine(new_engine), glyph_cache(std::make_shared<GlyphCache>()), path_cache(std::make_shared<PathCache>()), sdf_cache(std::make_shared<SdfGlyphCache>()) {}
 	std::shared_ptr<FontEngine> engine;
 	std::shared_ptr<GlyphCache> glyph_cache;
 	std::shared_ptr<PathCache> path_cache;
+	std::shared_ptr<SdfGlyphCache> sdf_cache;
 };
 
 class FontFace_Impl
@@ -80,9 +82,15 @@ public:
 	// Find font and copy it using the revised description
 	Font_Cache copy_font(const Font_Selected &desc);
 
+	// Texture memory used by the glyph caches (in bytes)
+	int get_texture_memory_usage() const;
+
 private:
+	static int get_texture_memory_usage(const TextureGroup &group);
+
 	std::string family_name;
 	TextureGroup texture_group;		// Shared texture group between glyph cache's
+	TextureGroup sdf_texture_group;		// Distance field atlas, shared between all sizes
 	std::vector<Font_Cache> font_cache;
 
 };
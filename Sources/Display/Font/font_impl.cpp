@@ -72,7 +72,9 @@ void Font_Impl::select_font_face()
 	{
 		// Copy the required font, setting a scalable font size
 		Font_Selected new_selected = selected_description;
-		if (selected_description.height >= selected_height_threshold)
+		if (selected_distance_field)
+			new_selected.height = SdfGlyphCache::reference_height;	// The distance field atlas is shared by all sizes
+		else if (selected_description.height >= selected_height_threshold)
 			new_selected.height = 256.0f;	// A reasonable scalable size
 
 		Font_Cache font_cache = font_face.impl->get_font(new_selected);
@@ -96,7 +98,12 @@ void Font_Impl::select_font_face()
 			scaled_height = 1.0f;
 
 		// Deterimine the correct drawing engine
-		if (selected_pathfont)
+		if (selected_distance_field && font_engine->is_automatic_recreation_allowed())
+		{
+			font_draw_sdf.init(font_cache.sdf_cache.get(), path_cache, font_engine, scaled_height);
+			font_draw = &font_draw_sdf;
+		}
+		else if (selected_pathfont)
 		{
 			font_draw_path.init(path_cache, font_engine, scaled_height);
 			font_draw = &font_draw_path;
@@ -308,4 +315,13 @@ void Font_Impl::set_scalable(float height_threshold)
 	// (Don't need to reset the font engine)
 }
 
+void Font_Impl::set_distance_field(bool enable)
+{
+	if (selected_distance_field != enable)
+	{
+		selected_distance_field = enable;
+		font_engine = nullptr;
+	}
+}
+
 }
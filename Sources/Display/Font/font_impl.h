@@ -45,6 +45,7 @@
 #include "FontDraw/font_draw_flat.h"
 #include "FontDraw/font_draw_path.h"
 #include "FontDraw/font_draw_scaled.h"
+#include "FontDraw/font_draw_sdf.h"
 
 namespace clan
 {
@@ -78,6 +79,7 @@ public:
 	void set_line_height(float height);
 	void set_style(FontStyle setting);
 	void set_scalable(float height_threshold);
+	void set_distance_field(bool enable);
 
 private:
 	void select_font_face();
@@ -87,6 +89,7 @@ private:
 	float scaled_height = 1.0f;				// Currently not implemented
 	float selected_height_threshold = 32.0f;		// Values greater or equal to this value can be drawn scaled
 	bool selected_pathfont = false;
+	bool selected_distance_field = false;
 
 	FontMetrics selected_metrics;
 
@@ -99,6 +102,7 @@ private:
 	Font_DrawFlat font_draw_flat;
 	Font_DrawScaled font_draw_scaled;
 	Font_DrawPath font_draw_path;
+	Font_DrawSDF font_draw_sdf;
 
 };
 
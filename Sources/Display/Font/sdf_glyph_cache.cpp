@@ -0,0 +1,106 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2015 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    agent
+*/
+
+#include "Display/precomp.h"
+#include "sdf_glyph_cache.h"
+#include "FontEngine/font_engine.h"
+#include "API/Display/Image/pixel_buffer.h"
+#include "API/Display/Image/pixel_buffer_help.h"
+#include "API/Display/2D/subtexture.h"
+#include "API/Display/2D/texture_group.h"
+#include "API/Display/2D/canvas.h"
+#include "API/Display/Render/texture_2d.h"
+
+namespace clan
+{
+
+/////////////////////////////////////////////////////////////////////////////
+// SdfGlyphCache Construction:
+
+SdfGlyphCache::SdfGlyphCache()
+{
+}
+
+SdfGlyphCache::~SdfGlyphCache()
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// SdfGlyphCache Attributes:
+
+Font_TextureGlyph *SdfGlyphCache::get_glyph(Canvas &canvas, FontEngine *font_engine, unsigned int glyph)
+{
+	auto it = glyph_map.find(glyph);
+	if (it != glyph_map.end())
+		return &it->second;
+
+	FontPixelBuffer pb = font_engine->get_font_glyph_sdf(glyph, spread);
+	if (!pb.glyph)	// Distance fields not supported by this font engine
+		return nullptr;
+
+	Font_TextureGlyph &font_glyph = glyph_map[glyph];
+	font_glyph.glyph = pb.glyph;
+	font_glyph.offset = pb.offset;
+	font_glyph.metrics = pb.metrics;
+
+	if (!pb.empty_buffer)
+	{
+		PixelBuffer buffer_with_border = PixelBufferHelp::add_border(pb.buffer, glyph_border_size, pb.buffer_rect);
+		GraphicContext gc = canvas.get_gc();
+		Subtexture sub_texture = texture_group.add(gc, buffer_with_border.get_size());
+		font_glyph.texture = sub_texture.get_texture();
+		font_glyph.geometry = Rect(sub_texture.get_geometry().left + glyph_border_size, sub_texture.get_geometry().top + glyph_border_size, pb.buffer_rect.get_size());
+		font_glyph.texture.set_subimage(gc, sub_texture.get_geometry().left, sub_texture.get_geometry().top, buffer_with_border, buffer_with_border.get_size());
+
+		// The distance field must be interpolated to find the glyph edge
+		font_glyph.texture.set_min_filter(filter_linear);
+		font_glyph.texture.set_mag_filter(filter_linear);
+	}
+	return &font_glyph;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// SdfGlyphCache Operations:
+
+GlyphMetrics SdfGlyphCache::get_metrics(FontEngine *font_engine, Canvas &canvas, unsigned int glyph)
+{
+	Font_TextureGlyph *gptr = get_glyph(canvas, font_engine, glyph);
+	if (gptr)
+		return gptr->metrics;
+	return GlyphMetrics();
+}
+
+void SdfGlyphCache::set_texture_group(TextureGroup &new_texture_group)
+{
+	texture_group = new_texture_group;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// SdfGlyphCache Implementation:
+
+}
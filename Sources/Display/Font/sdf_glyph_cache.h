@@ -0,0 +1,86 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2015 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    agent
+*/
+
+#pragma once
+
+#include "API/Display/Font/glyph_metrics.h"
+#include "API/Display/2D/texture_group.h"
+#include "glyph_cache.h"
+#include <map>
+
+namespace clan
+{
+
+class FontEngine;
+class Canvas;
+
+/// \brief Signed distance field glyph cache
+///
+/// Glyphs are generated once from the glyph outline at the reference height, and can then be drawn at any size
+class SdfGlyphCache
+{
+/// \name Construction
+/// \{
+public:
+	SdfGlyphCache();
+	~SdfGlyphCache();
+
+/// \}
+/// \name Attributes
+/// \{
+public:
+	/// \brief Height of the font engine that the distance fields are generated from
+	static const int reference_height = 48;
+
+	/// \brief Distance (in reference pixels) that the field extends outside and inside the glyph edge
+	static const int spread = 6;
+
+	/// \brief Get a glyph. Returns NULL if the font engine cannot create distance fields
+	Font_TextureGlyph *get_glyph(Canvas &canvas, FontEngine *font_engine, unsigned int glyph);
+
+/// \}
+/// \name Operations
+/// \{
+public:
+	GlyphMetrics get_metrics(FontEngine *font_engine, Canvas &canvas, unsigned int glyph);
+
+	void set_texture_group(TextureGroup &new_texture_group);
+
+/// \}
+/// \name Implementation
+/// \{
+private:
+	std::map<unsigned int, Font_TextureGlyph> glyph_map;
+
+	TextureGroup texture_group;
+
+	static const int glyph_border_size = 1;
+/// \}
+};
+
+}
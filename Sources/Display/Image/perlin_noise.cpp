@@ -28,6 +28,14 @@
 
 #include "Display/precomp.h"
 #include "API/Display/Image/perlin_noise.h"
+#include "API/Core/System/work_queue.h"
+#include "API/Core/System/event.h"
+#include "API/Core/System/interlocked_variable.h"
+#include "API/Core/System/system.h"
+#include "API/Core/Math/cl_math.h"
+#include "API/Core/Math/batch_math.h"
+#include "pixel_converter_impl.h"
+#include "perlin_noise_simd.h"
 #include <cstdlib>
 
 namespace clan
@@ -43,7 +51,7 @@ namespace clan
 // http://mrl.nyu.edu/~perlin/paper445.pdf - 6t5-15t4+10t3
 #define cl_s_curve(t) ( t * t * t * ( t * ( t * 6.0f - 15.0f ) + 10.0f ) )
 
-#define cl_floor_to_int(value) ( ((value)>0.0f) ? ((int)value) : ((int)value-1 ) )
+#define cl_floor_to_int(value) ( ((value)>0.0f) ? ((int)(value)) : ((int)(value)-1 ) )
 #define cl_lerp(t, a, b) ((a) + (t)*((b)-(a)))
 
 #define permutation_table_size	256
@@ -55,135 +63,166 @@ namespace clan
 #define cl_period_mask_w	permutation_table_mask
 
 
+static inline int perlin_noise_to_color(float value)
+{
+	int color= (int)((value*128.0f)+128.0f);
+	if(color>255)
+		color=255;
+	if(color<0)
+		color=0;
+	return color;
+}
+
 class PerlinNoise_PixelWriter
 {
 public:
-	virtual void line_end() = 0;
-	virtual void write_pixel(float value) = 0;
+	virtual ~PerlinNoise_PixelWriter() { }
+	virtual void write_row(void *line, const float *values, int width) = 0;
 };
 
 class PerlinNoise_PixelWriter_RGBA8 : public PerlinNoise_PixelWriter
 {
 public:
-	PerlinNoise_PixelWriter_RGBA8(PixelBuffer &pbuff) 
-		: pitch(pbuff.get_pitch() / pbuff.get_bytes_per_pixel()),
-		  current_ptr((ubyte32 *) pbuff.get_data()),
-		  line_start_ptr(current_ptr)
-	{
-	}
-
-	void line_end() override
+	void write_row(void *line, const float *values, int width) override
 	{
-		line_start_ptr += pitch;
-		current_ptr = line_start_ptr;
-	}
-
-	void write_pixel(float value) override
-	{
-		int color= (int)((value*128.0f)+128.0f);
-		if(color>255)
-			color=255;
-		if(color<0)
-			color=0;
-
-		*(current_ptr++) = color << 24 | color << 16 | color << 8 | color;
+		ubyte32 *current_ptr = (ubyte32 *) line;
+		int x = 0;
+#ifdef CL_PERLIN_NOISE_SSE2
+		x = PerlinNoise_SSE2::to_rgba8(values, current_ptr, width);
+#endif
+		for (; x < width; x++)
+		{
+			int color = perlin_noise_to_color(values[x]);
+			current_ptr[x] = color << 24 | color << 16 | color << 8 | color;
+		}
 	}
-private:
-	int pitch;
-	ubyte32 *current_ptr;
-	ubyte32 *line_start_ptr;
 };
 
 class PerlinNoise_PixelWriter_RGB8 : public PerlinNoise_PixelWriter
 {
 public:
-	PerlinNoise_PixelWriter_RGB8(PixelBuffer &pbuff) 
-		: pitch(pbuff.get_pitch()),
-		  current_ptr((ubyte8 *) pbuff.get_data()),
-		  line_start_ptr(current_ptr)
+	void write_row(void *line, const float *values, int width) override
 	{
+		ubyte8 *current_ptr = (ubyte8 *) line;
+		for (int x = 0; x < width; x++)
+		{
+			int color = perlin_noise_to_color(values[x]);
+			*(current_ptr++) = color;
+			*(current_ptr++) = color;
+			*(current_ptr++) = color;
+		}
 	}
+};
 
-	void line_end() override
+class PerlinNoise_PixelWriter_R8 : public PerlinNoise_PixelWriter
+{
+public:
+	void write_row(void *line, const float *values, int width) override
 	{
-		line_start_ptr += pitch;
-		current_ptr = line_start_ptr;
+		ubyte8 *current_ptr = (ubyte8 *) line;
+		int x = 0;
+#ifdef CL_PERLIN_NOISE_SSE2
+		x = PerlinNoise_SSE2::to_r8(values, current_ptr, width);
+#endif
+		for (; x < width; x++)
+			current_ptr[x] = perlin_noise_to_color(values[x]);
 	}
+};
 
-	void write_pixel(float value) override
+class PerlinNoise_PixelWriter_R32f : public PerlinNoise_PixelWriter
+{
+public:
+	void write_row(void *line, const float *values, int width) override
 	{
-		int color= (int)((value*128.0f)+128.0f);
-		if(color>255)
-			color=255;
-		if(color<0)
-			color=0;
-
-		*(current_ptr++) = color;
-		*(current_ptr++) = color;
-		*(current_ptr++) = color;
+		memcpy(line, values, width * sizeof(float));
 	}
-private:
-	int pitch;
-	ubyte8 *current_ptr;
-	ubyte8 *line_start_ptr;
 };
 
-class PerlinNoise_PixelWriter_R8 : public PerlinNoise_PixelWriter
+/// \brief Writes any format the pixel converter can write
+///
+/// Float and snorm formats get the noise value as is. Integer formats get the 0-255 range of
+/// the 8 bit formats and the remaining normalized formats get the same range scaled to 0-1.
+class PerlinNoise_PixelWriter_Generic : public PerlinNoise_PixelWriter
 {
 public:
-	PerlinNoise_PixelWriter_R8(PixelBuffer &pbuff) 
-		: pitch(pbuff.get_pitch()),
-		  current_ptr((ubyte8 *) pbuff.get_data()),
-		  line_start_ptr(current_ptr)
+	PerlinNoise_PixelWriter_Generic(TextureFormat texture_format)
+		: bytes_per_pixel(PixelBuffer::get_bytes_per_pixel(texture_format)), scale(128.0f / 255.0f), offset(128.0f / 255.0f)
 	{
-	}
+		PixelConverter_Impl converter;
+		writer = converter.create_writer(texture_format, System::detect_cpu_extension(System::sse2), System::detect_cpu_extension(System::sse4_1));
 
-	void line_end() override
-	{
-		line_start_ptr += pitch;
-		current_ptr = line_start_ptr;
+		switch (texture_format)
+		{
+		case tf_r8_snorm: case tf_r16_snorm: case tf_rg8_snorm: case tf_rg16_snorm: case tf_rgb8_snorm: case tf_rgb16_snorm: case tf_rgba8_snorm: case tf_rgba16_snorm:
+		case tf_r16f: case tf_rg16f: case tf_rgb16f: case tf_rgba16f: case tf_r32f: case tf_rg32f: case tf_rgb32f: case tf_rgba32f: case tf_r11f_g11f_b10f: case tf_rgb9_e5:
+		case tf_depth_component32f:
+			scale = 1.0f;
+			offset = 0.0f;
+			break;
+		case tf_r8i: case tf_r8ui: case tf_r16i: case tf_r16ui: case tf_r32i: case tf_r32ui: case tf_rg8i: case tf_rg8ui: case tf_rg16i: case tf_rg16ui: case tf_rg32i: case tf_rg32ui:
+		case tf_rgb8i: case tf_rgb8ui: case tf_rgb16i: case tf_rgb16ui: case tf_rgb32i: case tf_rgb32ui: case tf_rgba8i: case tf_rgba8ui: case tf_rgba16i: case tf_rgba16ui: case tf_rgba32i: case tf_rgba32ui:
+			scale = 128.0f;
+			offset = 128.0f;
+			break;
+		default:
+			break;
+		}
 	}
 
-	void write_pixel(float value) override
+	void write_row(void *line, const float *values, int width) override
 	{
-		int color= (int)((value*128.0f)+128.0f);
-		if(color>255)
-			color=255;
-		if(color<0)
-			color=0;
-
-		*(current_ptr++) = color;
+		// Converted in chunks through a stack buffer, as several threads write rows with the same writer
+		Vec4f pixels[chunk_size];
+		char *output = (char *) line;
+		for (int start_x = 0; start_x < width; start_x += chunk_size)
+		{
+			int count = clan::min(width - start_x, (int) chunk_size);
+			for (int x = 0; x < count; x++)
+			{
+				float value = values[start_x + x] * scale + offset;
+				pixels[x] = Vec4f(value, value, value, value);
+			}
+			writer->write(output + start_x * bytes_per_pixel, pixels, count);
+		}
 	}
+
 private:
-	int pitch;
-	ubyte8 *current_ptr;
-	ubyte8 *line_start_ptr;
+	enum { chunk_size = 256 };
+
+	std::unique_ptr<PixelWriter> writer;
+	int bytes_per_pixel;
+	float scale;
+	float offset;
 };
 
-class PerlinNoise_PixelWriter_R32f : public PerlinNoise_PixelWriter
+class PerlinNoise_Region
 {
 public:
-	PerlinNoise_PixelWriter_R32f(PixelBuffer &pbuff) 
-		: pitch(pbuff.get_pitch() / sizeof(float)),
-		  current_ptr((float *) pbuff.get_data()),
-		  line_start_ptr(current_ptr)
+	PerlinNoise_Region(int dimensions, float start_x, float end_x, float start_y, float end_y, float z_position, float w_position)
+		: dimensions(dimensions), start_x(start_x), end_x(end_x), start_y(start_y), end_y(end_y), z_position(z_position), w_position(w_position)
 	{
 	}
 
-	void line_end() override
-	{
-		line_start_ptr += pitch;
-		current_ptr = line_start_ptr;
-	}
+	int dimensions;
+	float start_x, end_x;
+	float start_y, end_y;
+	float z_position;
+	float w_position;
+};
 
-	void write_pixel(float value) override
+/// \brief Blocks of rows shared between the calling thread and the work queue threads
+class PerlinNoise_Job
+{
+public:
+	PerlinNoise_Job(int num_blocks) : num_blocks(num_blocks)
 	{
-		*(current_ptr++) = value;
+		blocks_left.set(num_blocks);
 	}
-private:
-	int pitch;
-	float *current_ptr;
-	float *line_start_ptr;
+
+	int num_blocks;
+	InterlockedVariable next_block;
+	InterlockedVariable blocks_left;
+	Event done;
 };
 
 class PerlinNoise_Impl
@@ -195,16 +234,15 @@ public:
 		width(256),
 		height(256),
 		octaves(1),
-		amplitude(1.0f)
+		amplitude(1.0f),
+		noise_type(PerlinNoise::perlin)
 	{
+		memset(permutation_table, 0, sizeof(permutation_table));
 	}
 
 	void set_permutations(const unsigned char *table, unsigned int size);
 
-	PixelBuffer create_noise4d(float start_x, float end_x, float start_y, float end_y, float z_position, float w_position);
-	PixelBuffer create_noise3d(float start_x, float end_x, float start_y, float end_y, float z_position);
-	PixelBuffer create_noise2d(float start_x, float end_x, float start_y, float end_y);
-	PixelBuffer create_noise1d(float start_x, float end_x);
+	PixelBuffer create_noise(const PerlinNoise_Region &region);
 
 public:
 	TextureFormat texture_format;
@@ -212,12 +250,13 @@ public:
 	int width;
 	int height;
 	int octaves;
+	PerlinNoise::NoiseType noise_type;
 
 private:
-	void create_noise4d(PerlinNoise_PixelWriter &writer, float start_x, float end_x, float start_y, float end_y, float z_position, float w_position);
-	void create_noise3d(PerlinNoise_PixelWriter &writer, float start_x, float end_x, float start_y, float end_y, float z_position);
-	void create_noise2d(PerlinNoise_PixelWriter &writer, float start_x, float end_x, float start_y, float end_y);
-	void create_noise1d(PerlinNoise_PixelWriter &writer, float start_x, float end_x);
+	std::unique_ptr<PerlinNoise_PixelWriter> create_writer();
+	void create_noise_rows(const PerlinNoise_Region &region, PerlinNoise_PixelWriter &writer, char *data, int pitch, int start_y, int end_y);
+	void create_noise_row(const PerlinNoise_Region &region, int y, float *values);
+	float noise(int dimensions, float x, float y, float z, float w);
 
 	inline float gradient_1d( int permutation_value, float x );
 	inline float gradient_2d( int permutation_value, float x, float y );
@@ -229,12 +268,20 @@ private:
 	float noise_3d( float x, float y, float z );
 	float noise_4d( float x, float y, float z, float w );
 
+	float simplex_1d( float x );
+	float simplex_2d( float x, float y );
+	float simplex_3d( float x, float y, float z );
+	float simplex_4d( float x, float y, float z, float w );
+
 	void setup();
 
 	bool permutation_table_set;
 
-	unsigned char permutation_table[permutation_table_size * 2];	// Table duplicated at permutation_table_size
+	unsigned char permutation_table[permutation_table_size * 2 + 4];	// Table duplicated at permutation_table_size, plus padding for the AVX2 gathers
+
+	std::unique_ptr<WorkQueue> work_queue;
 
+	enum { rows_per_block = 16 };
 };
 
 PerlinNoise::PerlinNoise() : impl(std::make_shared<PerlinNoise_Impl>())
@@ -252,22 +299,22 @@ void PerlinNoise::set_permutations(const unsigned char *table, unsigned int size
 
 PixelBuffer PerlinNoise::create_noise1d(float start_x, float end_x)
 {
-	return impl->create_noise1d(start_x, end_x);
+	return impl->create_noise(PerlinNoise_Region(1, start_x, end_x, 0.0f, 0.0f, 0.0f, 0.0f));
 }
 
 PixelBuffer PerlinNoise::create_noise2d(float start_x, float end_x, float start_y, float end_y)
 {
-	return impl->create_noise2d(start_x, end_x, start_y, end_y);
+	return impl->create_noise(PerlinNoise_Region(2, start_x, end_x, start_y, end_y, 0.0f, 0.0f));
 }
 
 PixelBuffer PerlinNoise::create_noise3d(float start_x, float end_x, float start_y, float end_y, float z_position)
 {
-	return impl->create_noise3d(start_x, end_x, start_y, end_y, z_position);
+	return impl->create_noise(PerlinNoise_Region(3, start_x, end_x, start_y, end_y, z_position, 0.0f));
 }
 
 PixelBuffer PerlinNoise::create_noise4d(float start_x, float end_x, float start_y, float end_y, float z_position, float w_position)
 {
-	return impl->create_noise4d(start_x, end_x, start_y, end_y, z_position, w_position);
+	return impl->create_noise(PerlinNoise_Region(4, start_x, end_x, start_y, end_y, z_position, w_position));
 }
 
 Size PerlinNoise::get_size() const
@@ -290,6 +337,11 @@ int PerlinNoise::get_octaves() const
 	return impl->octaves;
 }
 
+PerlinNoise::NoiseType PerlinNoise::get_noise_type() const
+{
+	return impl->noise_type;
+}
+
 void PerlinNoise::set_size(int width, int height)
 {
 	impl->width = width;
@@ -316,6 +368,11 @@ void PerlinNoise::set_octaves(int octaves)
 	impl->octaves = octaves;
 }
 
+void PerlinNoise::set_noise_type(NoiseType noise_type)
+{
+	impl->noise_type = noise_type;
+}
+
 float PerlinNoise_Impl::gradient_1d( int permutation_value, float x )
 {
 	// Find gradient between -8.0f and 8.0f (excluding 0.0f)
@@ -654,6 +711,7 @@ void PerlinNoise_Impl::set_permutations(const unsigned char *table, unsigned int
 
 		memcpy(dest, table, size_to_copy);
 		dest += size_to_copy;
+		dest_size -= size_to_copy;
 	}
 
 	// Mirror the table
@@ -677,274 +735,435 @@ void PerlinNoise_Impl::setup()
 	}
 }
 
-PixelBuffer PerlinNoise_Impl::create_noise2d(float start_x, float end_x, float start_y, float end_y)
+// Simplex noise, based on Stefan Gustavson's SimplexNoise1234.
+// It samples the corners of a simplex (a triangle in 2D, a tetrahedron in 3D) instead of a square or cube,
+// so it needs n+1 gradients per sample instead of 2^n and has no axis aligned artifacts.
+
+#define cl_simplex_F2 0.366025403f	// 0.5*(sqrt(3.0)-1.0)
+#define cl_simplex_G2 0.211324865f	// (3.0-sqrt(3.0))/6.0
+#define cl_simplex_F3 0.333333333f	// 1.0/3.0
+#define cl_simplex_G3 0.166666667f	// 1.0/6.0
+#define cl_simplex_F4 0.309016994f	// (sqrt(5.0)-1.0)/4.0
+#define cl_simplex_G4 0.138196601f	// (5.0-sqrt(5.0))/20.0
+
+float PerlinNoise_Impl::simplex_1d( float x )
 {
-	setup();
+	int i0 = cl_floor_to_int( x );
+	int i1 = i0 + 1;
+	float x0 = x - i0;
+	float x1 = x0 - 1.0f;
+
+	float t0 = 1.0f - x0 * x0;
+	t0 *= t0;
+	float n0 = t0 * t0 * gradient_1d( permutation_table[ i0 & cl_period_mask_x ], x0 );
 
-	if (texture_format == tf_rgba8)
+	float t1 = 1.0f - x1 * x1;
+	t1 *= t1;
+	float n1 = t1 * t1 * gradient_1d( permutation_table[ i1 & cl_period_mask_x ], x1 );
+
+	// Scale the result to about -1 to 1
+	return 0.395f * ( n0 + n1 );
+}
+
+float PerlinNoise_Impl::simplex_2d( float x, float y )
+{
+	// Skew the input space to find which simplex cell we are in
+	float s = ( x + y ) * cl_simplex_F2;
+	int i = cl_floor_to_int( x + s );
+	int j = cl_floor_to_int( y + s );
+
+	// Unskew the cell origin back to x,y space
+	float t = (float) ( i + j ) * cl_simplex_G2;
+	float x0 = x - ( i - t );
+	float y0 = y - ( j - t );
+
+	// Find out which of the two triangles in the cell we are in
+	int i1, j1;
+	if (x0 > y0)
 	{
-		PixelBuffer pbuff(width, height, texture_format);
-		PerlinNoise_PixelWriter_RGBA8 writer(pbuff);
-		create_noise2d(writer, start_x, end_x, start_y, end_y);
-		return pbuff;
+		i1 = 1;
+		j1 = 0;
 	}
-	if (texture_format == tf_rgb8)
+	else
 	{
-		PixelBuffer pbuff(width, height, texture_format);
-		PerlinNoise_PixelWriter_RGB8 writer(pbuff);
-		create_noise2d(writer, start_x, end_x, start_y, end_y);
-		return pbuff;
+		i1 = 0;
+		j1 = 1;
 	}
-	if (texture_format == tf_r8)
+
+	float x1 = x0 - i1 + cl_simplex_G2;
+	float y1 = y0 - j1 + cl_simplex_G2;
+	float x2 = x0 - 1.0f + 2.0f * cl_simplex_G2;
+	float y2 = y0 - 1.0f + 2.0f * cl_simplex_G2;
+
+	int ii = i & cl_period_mask_x;
+	int jj = j & cl_period_mask_y;
+
+	float n0 = 0.0f, n1 = 0.0f, n2 = 0.0f;
+
+	float t0 = 0.5f - x0 * x0 - y0 * y0;
+	if (t0 > 0.0f)
 	{
-		PixelBuffer pbuff(width, height, texture_format);
-		PerlinNoise_PixelWriter_R8 writer(pbuff);
-		create_noise2d(writer, start_x, end_x, start_y, end_y);
-		return pbuff;
+		t0 *= t0;
+		n0 = t0 * t0 * gradient_2d(permutation_table[ii + permutation_table[jj]], x0, y0);
 	}
-	if (texture_format == tf_r32f)
+
+	float t1 = 0.5f - x1 * x1 - y1 * y1;
+	if (t1 > 0.0f)
 	{
-		PixelBuffer pbuff(width, height, texture_format);
-		PerlinNoise_PixelWriter_R32f writer(pbuff);
-		create_noise2d(writer, start_x, end_x, start_y, end_y);
-		return pbuff;
+		t1 *= t1;
+		n1 = t1 * t1 * gradient_2d(permutation_table[ii + i1 + permutation_table[jj + j1]], x1, y1);
 	}
 
-	throw Exception("texture format is not supported");
+	float t2 = 0.5f - x2 * x2 - y2 * y2;
+	if (t2 > 0.0f)
+	{
+		t2 *= t2;
+		n2 = t2 * t2 * gradient_2d(permutation_table[ii + 1 + permutation_table[jj + 1]], x2, y2);
+	}
 
+	// Scale the result to about -1 to 1
+	return 44.0f * ( n0 + n1 + n2 );
 }
 
-void PerlinNoise_Impl::create_noise2d(PerlinNoise_PixelWriter &writer, float start_x, float end_x, float start_y, float end_y)
+float PerlinNoise_Impl::simplex_3d( float x, float y, float z )
 {
-	float size_x = end_x - start_x;
-	float size_y = end_y - start_y;
-	float fheight = (float) height;
-	float fwidth = (float) width;
-
-	for (int y = 0; y < height; y++)
+	// Skew the input space to find which simplex cell we are in
+	float s = ( x + y + z ) * cl_simplex_F3;
+	int i = cl_floor_to_int( x + s );
+	int j = cl_floor_to_int( y + s );
+	int k = cl_floor_to_int( z + s );
+
+	// Unskew the cell origin back to x,y,z space
+	float t = (float) ( i + j + k ) * cl_simplex_G3;
+	float x0 = x - ( i - t );
+	float y0 = y - ( j - t );
+	float z0 = z - ( k - t );
+
+	// Find out which of the six tetrahedrons in the cell we are in
+	int i1, j1, k1;	// Offsets for the second corner
+	int i2, j2, k2;	// Offsets for the third corner
+	if (x0 >= y0)
 	{
-		for (int x = 0; x < width; x++)
+		if (y0 >= z0)
 		{
-			float result = 0.0f;
-			float current_amplitude = amplitude;
-			float value_x = start_x + (((float) x) * size_x) / fwidth;
-			float value_y = start_y + (((float) y) * size_y) / fheight;
-
-			for( int i=0; i<octaves; i++ )
-			{
-				result += current_amplitude * noise_2d(value_x, value_y);
-				value_x *= 2.0f;
-				value_y *= 2.0f;
-				current_amplitude *= 0.5f;
-			}
-
-			writer.write_pixel(result);
+			i1 = 1; j1 = 0; k1 = 0; i2 = 1; j2 = 1; k2 = 0;
+		}
+		else if (x0 >= z0)
+		{
+			i1 = 1; j1 = 0; k1 = 0; i2 = 1; j2 = 0; k2 = 1;
+		}
+		else
+		{
+			i1 = 0; j1 = 0; k1 = 1; i2 = 1; j2 = 0; k2 = 1;
+		}
+	}
+	else
+	{
+		if (y0 < z0)
+		{
+			i1 = 0; j1 = 0; k1 = 1; i2 = 0; j2 = 1; k2 = 1;
+		}
+		else if (x0 < z0)
+		{
+			i1 = 0; j1 = 1; k1 = 0; i2 = 0; j2 = 1; k2 = 1;
+		}
+		else
+		{
+			i1 = 0; j1 = 1; k1 = 0; i2 = 1; j2 = 1; k2 = 0;
 		}
-		writer.line_end();
 	}
-}
 
-PixelBuffer PerlinNoise_Impl::create_noise1d(float start_x, float end_x)
-{
-	setup();
+	float x1 = x0 - i1 + cl_simplex_G3;
+	float y1 = y0 - j1 + cl_simplex_G3;
+	float z1 = z0 - k1 + cl_simplex_G3;
+	float x2 = x0 - i2 + 2.0f * cl_simplex_G3;
+	float y2 = y0 - j2 + 2.0f * cl_simplex_G3;
+	float z2 = z0 - k2 + 2.0f * cl_simplex_G3;
+	float x3 = x0 - 1.0f + 3.0f * cl_simplex_G3;
+	float y3 = y0 - 1.0f + 3.0f * cl_simplex_G3;
+	float z3 = z0 - 1.0f + 3.0f * cl_simplex_G3;
+
+	int ii = i & cl_period_mask_x;
+	int jj = j & cl_period_mask_y;
+	int kk = k & cl_period_mask_z;
 
-	if (texture_format == tf_rgba8)
+	float n0 = 0.0f, n1 = 0.0f, n2 = 0.0f, n3 = 0.0f;
+
+	float t0 = 0.5f - x0 * x0 - y0 * y0 - z0 * z0;
+	if (t0 > 0.0f)
 	{
-		PixelBuffer pbuff(width, height, texture_format);
-		PerlinNoise_PixelWriter_RGBA8 writer(pbuff);
-		create_noise1d(writer, start_x, end_x);
-		return pbuff;
+		t0 *= t0;
+		n0 = t0 * t0 * gradient_3d(permutation_table[ii + permutation_table[jj + permutation_table[kk]]], x0, y0, z0);
 	}
-	if (texture_format == tf_rgb8)
+
+	float t1 = 0.5f - x1 * x1 - y1 * y1 - z1 * z1;
+	if (t1 > 0.0f)
 	{
-		PixelBuffer pbuff(width, height, texture_format);
-		PerlinNoise_PixelWriter_RGB8 writer(pbuff);
-		create_noise1d(writer, start_x, end_x);
-		return pbuff;
+		t1 *= t1;
+		n1 = t1 * t1 * gradient_3d(permutation_table[ii + i1 + permutation_table[jj + j1 + permutation_table[kk + k1]]], x1, y1, z1);
 	}
-	if (texture_format == tf_r8)
+
+	float t2 = 0.5f - x2 * x2 - y2 * y2 - z2 * z2;
+	if (t2 > 0.0f)
 	{
-		PixelBuffer pbuff(width, height, texture_format);
-		PerlinNoise_PixelWriter_R8 writer(pbuff);
-		create_noise1d(writer, start_x, end_x);
-		return pbuff;
+		t2 *= t2;
+		n2 = t2 * t2 * gradient_3d(permutation_table[ii + i2 + permutation_table[jj + j2 + permutation_table[kk + k2]]], x2, y2, z2);
 	}
-	if (texture_format == tf_r32f)
+
+	float t3 = 0.5f - x3 * x3 - y3 * y3 - z3 * z3;
+	if (t3 > 0.0f)
 	{
-		PixelBuffer pbuff(width, height, texture_format);
-		PerlinNoise_PixelWriter_R32f writer(pbuff);
-		create_noise1d(writer, start_x, end_x);
-		return pbuff;
+		t3 *= t3;
+		n3 = t3 * t3 * gradient_3d(permutation_table[ii + 1 + permutation_table[jj + 1 + permutation_table[kk + 1]]], x3, y3, z3);
 	}
 
-	throw Exception("texture format is not supported");
-
+	// Scale the result to about -1 to 1
+	return 55.0f * ( n0 + n1 + n2 + n3 );
 }
 
-void PerlinNoise_Impl::create_noise1d(PerlinNoise_PixelWriter &writer, float start_x, float end_x)
+float PerlinNoise_Impl::simplex_4d( float x, float y, float z, float w )
 {
-	float size_x = end_x - start_x;
-	float fheight = (float) height;
-	float fwidth = (float) width;
-
-	for (int y = 0; y < height; y++)
+	// Skew the input space to find which simplex cell we are in
+	float s = ( x + y + z + w ) * cl_simplex_F4;
+	int i = cl_floor_to_int( x + s );
+	int j = cl_floor_to_int( y + s );
+	int k = cl_floor_to_int( z + s );
+	int l = cl_floor_to_int( w + s );
+
+	// Unskew the cell origin back to x,y,z,w space
+	float t = (float) ( i + j + k + l ) * cl_simplex_G4;
+	float x0 = x - ( i - t );
+	float y0 = y - ( j - t );
+	float z0 = z - ( k - t );
+	float w0 = w - ( l - t );
+
+	// The order of the coordinates decides which of the 24 simplices in the cell we are in.
+	// Rank each coordinate by how many of the others it is larger than.
+	int rank_x = 0, rank_y = 0, rank_z = 0, rank_w = 0;
+	if (x0 > y0) rank_x++; else rank_y++;
+	if (x0 > z0) rank_x++; else rank_z++;
+	if (x0 > w0) rank_x++; else rank_w++;
+	if (y0 > z0) rank_y++; else rank_z++;
+	if (y0 > w0) rank_y++; else rank_w++;
+	if (z0 > w0) rank_z++; else rank_w++;
+
+	int i1 = rank_x >= 3 ? 1 : 0, j1 = rank_y >= 3 ? 1 : 0, k1 = rank_z >= 3 ? 1 : 0, l1 = rank_w >= 3 ? 1 : 0;
+	int i2 = rank_x >= 2 ? 1 : 0, j2 = rank_y >= 2 ? 1 : 0, k2 = rank_z >= 2 ? 1 : 0, l2 = rank_w >= 2 ? 1 : 0;
+	int i3 = rank_x >= 1 ? 1 : 0, j3 = rank_y >= 1 ? 1 : 0, k3 = rank_z >= 1 ? 1 : 0, l3 = rank_w >= 1 ? 1 : 0;
+
+	float x1 = x0 - i1 + cl_simplex_G4, y1 = y0 - j1 + cl_simplex_G4, z1 = z0 - k1 + cl_simplex_G4, w1 = w0 - l1 + cl_simplex_G4;
+	float x2 = x0 - i2 + 2.0f * cl_simplex_G4, y2 = y0 - j2 + 2.0f * cl_simplex_G4, z2 = z0 - k2 + 2.0f * cl_simplex_G4, w2 = w0 - l2 + 2.0f * cl_simplex_G4;
+	float x3 = x0 - i3 + 3.0f * cl_simplex_G4, y3 = y0 - j3 + 3.0f * cl_simplex_G4, z3 = z0 - k3 + 3.0f * cl_simplex_G4, w3 = w0 - l3 + 3.0f * cl_simplex_G4;
+	float x4 = x0 - 1.0f + 4.0f * cl_simplex_G4, y4 = y0 - 1.0f + 4.0f * cl_simplex_G4, z4 = z0 - 1.0f + 4.0f * cl_simplex_G4, w4 = w0 - 1.0f + 4.0f * cl_simplex_G4;
+
+	int ii = i & cl_period_mask_x;
+	int jj = j & cl_period_mask_y;
+	int kk = k & cl_period_mask_z;
+	int ll = l & cl_period_mask_w;
+
+	float n0 = 0.0f, n1 = 0.0f, n2 = 0.0f, n3 = 0.0f, n4 = 0.0f;
+
+	float t0 = 0.5f - x0 * x0 - y0 * y0 - z0 * z0 - w0 * w0;
+	if (t0 > 0.0f)
 	{
-		for (int x = 0; x < width; x++)
-		{
-			float result = 0.0f;
-			float current_amplitude = amplitude;
-			float value_x = start_x + (((float) x) * size_x) / fwidth;
-
-			for( int i=0; i<octaves; i++ )
-			{
-				result += current_amplitude * noise_1d(value_x);
-				value_x *= 2.0f;
-				current_amplitude *= 0.5f;
-			}
-
-			writer.write_pixel(result);
-		}
-		writer.line_end();
+		t0 *= t0;
+		n0 = t0 * t0 * gradient_4d(permutation_table[ii + permutation_table[jj + permutation_table[kk + permutation_table[ll]]]], x0, y0, z0, w0);
 	}
-}
 
-PixelBuffer PerlinNoise_Impl::create_noise3d(float start_x, float end_x, float start_y, float end_y, float z_position)
-{
-	setup();
-
-	if (texture_format == tf_rgba8)
+	float t1 = 0.5f - x1 * x1 - y1 * y1 - z1 * z1 - w1 * w1;
+	if (t1 > 0.0f)
 	{
-		PixelBuffer pbuff(width, height, texture_format);
-		PerlinNoise_PixelWriter_RGBA8 writer(pbuff);
-		create_noise3d(writer, start_x, end_x, start_y, end_y, z_position);
-		return pbuff;
+		t1 *= t1;
+		n1 = t1 * t1 * gradient_4d(permutation_table[ii + i1 + permutation_table[jj + j1 + permutation_table[kk + k1 + permutation_table[ll + l1]]]], x1, y1, z1, w1);
 	}
-	if (texture_format == tf_rgb8)
+
+	float t2 = 0.5f - x2 * x2 - y2 * y2 - z2 * z2 - w2 * w2;
+	if (t2 > 0.0f)
 	{
-		PixelBuffer pbuff(width, height, texture_format);
-		PerlinNoise_PixelWriter_RGB8 writer(pbuff);
-		create_noise3d(writer, start_x, end_x, start_y, end_y, z_position);
-		return pbuff;
+		t2 *= t2;
+		n2 = t2 * t2 * gradient_4d(permutation_table[ii + i2 + permutation_table[jj + j2 + permutation_table[kk + k2 + permutation_table[ll + l2]]]], x2, y2, z2, w2);
 	}
-	if (texture_format == tf_r8)
+
+	float t3 = 0.5f - x3 * x3 - y3 * y3 - z3 * z3 - w3 * w3;
+	if (t3 > 0.0f)
 	{
-		PixelBuffer pbuff(width, height, texture_format);
-		PerlinNoise_PixelWriter_R8 writer(pbuff);
-		create_noise3d(writer, start_x, end_x, start_y, end_y, z_position);
-		return pbuff;
+		t3 *= t3;
+		n3 = t3 * t3 * gradient_4d(permutation_table[ii + i3 + permutation_table[jj + j3 + permutation_table[kk + k3 + permutation_table[ll + l3]]]], x3, y3, z3, w3);
 	}
-	if (texture_format == tf_r32f)
+
+	float t4 = 0.5f - x4 * x4 - y4 * y4 - z4 * z4 - w4 * w4;
+	if (t4 > 0.0f)
 	{
-		PixelBuffer pbuff(width, height, texture_format);
-		PerlinNoise_PixelWriter_R32f writer(pbuff);
-		create_noise3d(writer, start_x, end_x, start_y, end_y, z_position);
-		return pbuff;
+		t4 *= t4;
+		n4 = t4 * t4 * gradient_4d(permutation_table[ii + 1 + permutation_table[jj + 1 + permutation_table[kk + 1 + permutation_table[ll + 1]]]], x4, y4, z4, w4);
 	}
 
-	throw Exception("sized format is not supported");
-
+	// Scale the result to about -1 to 1
+	return 69.0f * ( n0 + n1 + n2 + n3 + n4 );
 }
 
-void PerlinNoise_Impl::create_noise3d(PerlinNoise_PixelWriter &writer, float start_x, float end_x, float start_y, float end_y, float z_position)
+float PerlinNoise_Impl::noise(int dimensions, float x, float y, float z, float w)
 {
-	float size_x = end_x - start_x;
-	float size_y = end_y - start_y;
-	float fheight = (float) height;
-	float fwidth = (float) width;
-
-	for (int y = 0; y < height; y++)
+	if (noise_type == PerlinNoise::simplex)
 	{
-		for (int x = 0; x < width; x++)
+		switch (dimensions)
 		{
-			float result = 0.0f;
-			float current_amplitude = amplitude;
-			float value_x = start_x + (((float) x) * size_x) / fwidth;
-			float value_y = start_y + (((float) y) * size_y) / fheight;
-			float value_z = z_position;
-
-			for( int i=0; i<octaves; i++ )
-			{
-				result += current_amplitude * noise_3d(value_x, value_y, value_z);
-				value_x *= 2.0f;
-				value_y *= 2.0f;
-				value_z *= 2.0f;
-				current_amplitude *= 0.5f;
-			}
-
-			writer.write_pixel(result);
+		case 1: return simplex_1d(x);
+		case 2: return simplex_2d(x, y);
+		case 3: return simplex_3d(x, y, z);
+		default: return simplex_4d(x, y, z, w);
+		}
+	}
+	else
+	{
+		switch (dimensions)
+		{
+		case 1: return noise_1d(x);
+		case 2: return noise_2d(x, y);
+		case 3: return noise_3d(x, y, z);
+		default: return noise_4d(x, y, z, w);
 		}
-		writer.line_end();
 	}
 }
 
-PixelBuffer PerlinNoise_Impl::create_noise4d(float start_x, float end_x, float start_y, float end_y, float z_position, float w_position)
+std::unique_ptr<PerlinNoise_PixelWriter> PerlinNoise_Impl::create_writer()
 {
-	setup();
-
-	if (texture_format == tf_rgba8)
+	switch (texture_format)
 	{
-		PixelBuffer pbuff(width, height, texture_format);
-		PerlinNoise_PixelWriter_RGBA8 writer(pbuff);
-		create_noise4d(writer, start_x, end_x, start_y, end_y, z_position, w_position);
-		return pbuff;
+	case tf_rgba8:
+		return std::unique_ptr<PerlinNoise_PixelWriter>(new PerlinNoise_PixelWriter_RGBA8());
+	case tf_rgb8:
+		return std::unique_ptr<PerlinNoise_PixelWriter>(new PerlinNoise_PixelWriter_RGB8());
+	case tf_r8:
+		return std::unique_ptr<PerlinNoise_PixelWriter>(new PerlinNoise_PixelWriter_R8());
+	case tf_r32f:
+		return std::unique_ptr<PerlinNoise_PixelWriter>(new PerlinNoise_PixelWriter_R32f());
+	default:
+		if (PixelBuffer::is_compressed(texture_format))
+			throw Exception("texture format is not supported");
+		return std::unique_ptr<PerlinNoise_PixelWriter>(new PerlinNoise_PixelWriter_Generic(texture_format));
 	}
-	if (texture_format == tf_rgb8)
-	{
-		PixelBuffer pbuff(width, height, texture_format);
-		PerlinNoise_PixelWriter_RGB8 writer(pbuff);
-		create_noise4d(writer, start_x, end_x, start_y, end_y, z_position, w_position);
-		return pbuff;
-	}
-	if (texture_format == tf_r8)
+}
+
+PixelBuffer PerlinNoise_Impl::create_noise(const PerlinNoise_Region &region)
+{
+	setup();
+
+	std::unique_ptr<PerlinNoise_PixelWriter> writer = create_writer();
+	PixelBuffer pbuff(width, height, texture_format);
+	char *data = (char *) pbuff.get_data();
+	int pitch = pbuff.get_pitch();
+
+	// Split the image into blocks of rows. The calling thread and the work queue threads each take the next
+	// block until none are left. Small images are not worth waking the threads for.
+
+	int num_blocks = (height + rows_per_block - 1) / rows_per_block;
+	int num_threads = clan::min(System::get_num_cores(), num_blocks);
+	if (num_threads <= 1 || width * height < 128 * 128)
 	{
-		PixelBuffer pbuff(width, height, texture_format);
-		PerlinNoise_PixelWriter_R8 writer(pbuff);
-		create_noise4d(writer, start_x, end_x, start_y, end_y, z_position, w_position);
+		create_noise_rows(region, *writer, data, pitch, 0, height);
 		return pbuff;
 	}
-	if (texture_format == tf_r32f)
+
+	if (!work_queue)
+		work_queue.reset(new WorkQueue());
+
+	auto job = std::make_shared<PerlinNoise_Job>(num_blocks);
+	auto process_blocks = [=, &region, &writer]()
 	{
-		PixelBuffer pbuff(width, height, texture_format);
-		PerlinNoise_PixelWriter_R32f writer(pbuff);
-		create_noise4d(writer, start_x, end_x, start_y, end_y, z_position, w_position);
-		return pbuff;
-	}
+		while (true)
+		{
+			int block = job->next_block.increment() - 1;
+			if (block >= job->num_blocks)
+				break;
+
+			int start_y = block * rows_per_block;
+			int end_y = clan::min(start_y + (int) rows_per_block, height);
+			create_noise_rows(region, *writer, data, pitch, start_y, end_y);
 
-	throw Exception("sized format is not supported");
+			if (job->blocks_left.decrement() == 0)
+				job->done.set();
+		}
+	};
+
+	for (int i = 1; i < num_threads; i++)
+		work_queue->queue(process_blocks);
+	process_blocks();
 
+	job->done.wait();
+	return pbuff;
+}
+
+void PerlinNoise_Impl::create_noise_rows(const PerlinNoise_Region &region, PerlinNoise_PixelWriter &writer, char *data, int pitch, int start_y, int end_y)
+{
+	std::vector<float> values(width);
+	for (int y = start_y; y < end_y; y++)
+	{
+		// 1D noise is the same on every row
+		if (region.dimensions != 1 || y == start_y)
+			create_noise_row(region, y, values.data());
+
+		writer.write_row(data + y * pitch, values.data(), width);
+	}
 }
 
-void PerlinNoise_Impl::create_noise4d(PerlinNoise_PixelWriter &writer, float start_x, float end_x, float start_y, float end_y, float z_position, float w_position)
+void PerlinNoise_Impl::create_noise_row(const PerlinNoise_Region &region, int y, float *values)
 {
-	float size_x = end_x - start_x;
-	float size_y = end_y - start_y;
+	float size_x = region.end_x - region.start_x;
+	float size_y = region.end_y - region.start_y;
 	float fheight = (float) height;
 	float fwidth = (float) width;
 
-	for (int y = 0; y < height; y++)
+	float current_amplitude = amplitude;
+	float scale = 1.0f;
+	float value_y = region.start_y + (((float) y) * size_y) / fheight;
+	float value_z = region.z_position;
+	float value_w = region.w_position;
+
+	for (int x = 0; x < width; x++)
+		values[x] = 0.0f;
+
+	BatchMath::InstructionSet instruction_set = BatchMath::get_instruction_set();
+
+	for( int i=0; i<octaves; i++ )
 	{
-		for (int x = 0; x < width; x++)
+		// The SIMD kernels handle as many pixels as they can. They give the same result as the scalar code.
+		// The instruction set is chosen the same way as for BatchMath, so set_max_instruction_set() limits both.
+		int x = 0;
+		if (noise_type == PerlinNoise::perlin && region.dimensions == 2)
 		{
-			float result = 0.0f;
-			float current_amplitude = amplitude;
-			float value_x = start_x + (((float) x) * size_x) / fwidth;
-			float value_y = start_y + (((float) y) * size_y) / fheight;
-			float value_z = z_position;
-			float value_w = w_position;
-
-			for( int i=0; i<octaves; i++ )
-			{
-				result += current_amplitude * noise_4d(value_x, value_y, value_z, value_w);
-				value_x *= 2.0f;
-				value_y *= 2.0f;
-				value_z *= 2.0f;
-				value_w *= 2.0f;
-				current_amplitude *= 0.5f;
-			}
+#ifdef CL_PERLIN_NOISE_AVX2
+			if (instruction_set >= BatchMath::avx2)
+				x = PerlinNoise_AVX2::noise_2d_row(permutation_table, values, x, width, region.start_x, size_x, fwidth, scale, value_y, current_amplitude);
+#endif
+#ifdef CL_PERLIN_NOISE_SSE2
+			if (instruction_set >= BatchMath::sse2)
+				x = PerlinNoise_SSE2::noise_2d_row(permutation_table, values, x, width, region.start_x, size_x, fwidth, scale, value_y, current_amplitude);
+#endif
+		}
+		else if (noise_type == PerlinNoise::perlin && region.dimensions == 3)
+		{
+#ifdef CL_PERLIN_NOISE_AVX2
+			if (instruction_set >= BatchMath::avx2)
+				x = PerlinNoise_AVX2::noise_3d_row(permutation_table, values, x, width, region.start_x, size_x, fwidth, scale, value_y, value_z, current_amplitude);
+#endif
+#ifdef CL_PERLIN_NOISE_SSE2
+			if (instruction_set >= BatchMath::sse2)
+				x = PerlinNoise_SSE2::noise_3d_row(permutation_table, values, x, width, region.start_x, size_x, fwidth, scale, value_y, value_z, current_amplitude);
+#endif
+		}
 
-			writer.write_pixel(result);
+		for (; x < width; x++)
+		{
+			float value_x = (region.start_x + (((float) x) * size_x) / fwidth) * scale;
+			values[x] += current_amplitude * noise(region.dimensions, value_x, value_y, value_z, value_w);
 		}
-		writer.line_end();
+
+		value_y *= 2.0f;
+		value_z *= 2.0f;
+		value_w *= 2.0f;
+		scale *= 2.0f;
+		current_amplitude *= 0.5f;
 	}
 }
 
@@ -0,0 +1,218 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2015 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    agent
+*/
+
+#include "Display/precomp.h"
+#include "perlin_noise_simd.h"
+
+#ifdef CL_PERLIN_NOISE_AVX2
+#include <immintrin.h>
+
+// GCC and Clang only allow the AVX2 intrinsics in functions compiled for a CPU that has them
+#if defined(__GNUC__)
+#define CL_AVX2_TARGET __attribute__((target("avx2")))
+#else
+#define CL_AVX2_TARGET
+#endif
+
+namespace clan
+{
+
+// Same as the SSE2 kernels with eight pixels at a time, using gathers for the permutation table lookups.
+
+CL_AVX2_TARGET static inline __m256 s_curve(__m256 t)
+{
+	__m256 t3 = _mm256_mul_ps(_mm256_mul_ps(t, t), t);
+	__m256 poly = _mm256_add_ps(_mm256_mul_ps(t, _mm256_sub_ps(_mm256_mul_ps(t, _mm256_set1_ps(6.0f)), _mm256_set1_ps(15.0f))), _mm256_set1_ps(10.0f));
+	return _mm256_mul_ps(t3, poly);
+}
+
+CL_AVX2_TARGET static inline __m256 lerp(__m256 t, __m256 a, __m256 b)
+{
+	return _mm256_add_ps(a, _mm256_mul_ps(t, _mm256_sub_ps(b, a)));
+}
+
+CL_AVX2_TARGET static inline __m256 select(__m256i mask, __m256 if_set, __m256 if_clear)
+{
+	return _mm256_blendv_ps(if_clear, if_set, _mm256_castsi256_ps(mask));
+}
+
+CL_AVX2_TARGET static inline __m256 negate_if(__m256 value, __m256i hash, int bit, int bit_index)
+{
+	__m256i sign = _mm256_slli_epi32(_mm256_and_si256(hash, _mm256_set1_epi32(bit)), 31 - bit_index);
+	return _mm256_xor_ps(value, _mm256_castsi256_ps(sign));
+}
+
+CL_AVX2_TARGET static inline __m256 gradient_2d(__m256i hash, __m256 x, __m256 y)
+{
+	__m256i swap = _mm256_cmpeq_epi32(_mm256_and_si256(hash, _mm256_set1_epi32(4)), _mm256_set1_epi32(4));
+	__m256 u = negate_if(select(swap, y, x), hash, 1, 0);
+	__m256 v = negate_if(select(swap, x, y), hash, 2, 1);
+	return _mm256_add_ps(u, _mm256_mul_ps(_mm256_set1_ps(2.0f), v));
+}
+
+CL_AVX2_TARGET static inline __m256 gradient_3d(__m256i hash, __m256 x, __m256 y, __m256 z)
+{
+	__m256i bit8 = _mm256_cmpeq_epi32(_mm256_and_si256(hash, _mm256_set1_epi32(8)), _mm256_set1_epi32(8));
+	__m256i bit4 = _mm256_cmpeq_epi32(_mm256_and_si256(hash, _mm256_set1_epi32(4)), _mm256_set1_epi32(4));
+	__m256i above_12 = _mm256_and_si256(bit8, bit4);
+	__m256 u = negate_if(select(bit8, y, x), hash, 1, 0);
+	__m256 v = negate_if(select(bit4, select(above_12, x, z), y), hash, 2, 1);
+	return _mm256_add_ps(u, v);
+}
+
+// Reads four bytes at each index, which is why the table needs padding, and keeps the first
+CL_AVX2_TARGET static inline __m256i lookup(const unsigned char *permutation_table, __m256i index, int offset)
+{
+	__m256i bytes = _mm256_i32gather_epi32((const int *)permutation_table, _mm256_add_epi32(index, _mm256_set1_epi32(offset)), 1);
+	return _mm256_and_si256(bytes, _mm256_set1_epi32(0xff));
+}
+
+struct PerlinNoise_AVX2_Row
+{
+	__m256 fx0, fx1, s;
+	__m256i ix0, ix1;
+};
+
+CL_AVX2_TARGET static inline void setup_row(PerlinNoise_AVX2_Row &row, int x, float start_x, float size_x, float width, float scale)
+{
+	__m256 pixel_x = _mm256_cvtepi32_ps(_mm256_add_epi32(_mm256_set1_epi32(x), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7)));
+	__m256 value_x = _mm256_mul_ps(_mm256_add_ps(_mm256_set1_ps(start_x), _mm256_div_ps(_mm256_mul_ps(pixel_x, _mm256_set1_ps(size_x)), _mm256_set1_ps(width))), _mm256_set1_ps(scale));
+
+	// cl_floor_to_int rounds integers and zero down to the next integer
+	__m256i positive = _mm256_castps_si256(_mm256_cmp_ps(value_x, _mm256_setzero_ps(), _CMP_GT_OQ));
+	__m256i ix0 = _mm256_sub_epi32(_mm256_sub_epi32(_mm256_cvttps_epi32(value_x), _mm256_set1_epi32(1)), positive);
+
+	row.fx0 = _mm256_sub_ps(value_x, _mm256_cvtepi32_ps(ix0));
+	row.fx1 = _mm256_sub_ps(row.fx0, _mm256_set1_ps(1.0f));
+	row.s = s_curve(row.fx0);
+
+	__m256i mask = _mm256_set1_epi32(0xff);
+	row.ix1 = _mm256_and_si256(_mm256_add_epi32(ix0, _mm256_set1_epi32(1)), mask);
+	row.ix0 = _mm256_and_si256(ix0, mask);
+}
+
+static inline int floor_to_int(float value)
+{
+	return (value > 0.0f) ? ((int)value) : ((int)value - 1);
+}
+
+static inline float s_curve(float t)
+{
+	return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f);
+}
+
+CL_AVX2_TARGET int PerlinNoise_AVX2::noise_2d_row(const unsigned char *permutation_table, float *values, int x, int count, float start_x, float size_x, float width, float scale, float y, float amplitude)
+{
+	int iy0 = floor_to_int(y);
+	float fy0_scalar = y - iy0;
+	int iy1 = (iy0 + 1) & 0xff;
+	iy0 = iy0 & 0xff;
+	int hash_y0 = permutation_table[iy0];
+	int hash_y1 = permutation_table[iy1];
+
+	__m256 fy0 = _mm256_set1_ps(fy0_scalar);
+	__m256 fy1 = _mm256_set1_ps(fy0_scalar - 1.0f);
+	__m256 t = _mm256_set1_ps(s_curve(fy0_scalar));
+	__m256 amp = _mm256_set1_ps(amplitude);
+
+	for (; x + 8 <= count; x += 8)
+	{
+		PerlinNoise_AVX2_Row row;
+		setup_row(row, x, start_x, size_x, width, scale);
+
+		__m256 nx0 = gradient_2d(lookup(permutation_table, row.ix0, hash_y0), row.fx0, fy0);
+		__m256 nx1 = gradient_2d(lookup(permutation_table, row.ix0, hash_y1), row.fx0, fy1);
+		__m256 n0 = lerp(t, nx0, nx1);
+
+		nx0 = gradient_2d(lookup(permutation_table, row.ix1, hash_y0), row.fx1, fy0);
+		nx1 = gradient_2d(lookup(permutation_table, row.ix1, hash_y1), row.fx1, fy1);
+		__m256 n1 = lerp(t, nx0, nx1);
+
+		__m256 noise = lerp(row.s, n0, n1);
+		_mm256_storeu_ps(values + x, _mm256_add_ps(_mm256_loadu_ps(values + x), _mm256_mul_ps(amp, noise)));
+	}
+	return x;
+}
+
+CL_AVX2_TARGET int PerlinNoise_AVX2::noise_3d_row(const unsigned char *permutation_table, float *values, int x, int count, float start_x, float size_x, float width, float scale, float y, float z, float amplitude)
+{
+	int iy0 = floor_to_int(y);
+	int iz0 = floor_to_int(z);
+	float fy0_scalar = y - iy0;
+	float fz0_scalar = z - iz0;
+	int iy1 = (iy0 + 1) & 0xff;
+	int iz1 = (iz0 + 1) & 0xff;
+	iy0 = iy0 & 0xff;
+	iz0 = iz0 & 0xff;
+	int hash_y0z0 = permutation_table[iy0 + permutation_table[iz0]];
+	int hash_y0z1 = permutation_table[iy0 + permutation_table[iz1]];
+	int hash_y1z0 = permutation_table[iy1 + permutation_table[iz0]];
+	int hash_y1z1 = permutation_table[iy1 + permutation_table[iz1]];
+
+	__m256 fy0 = _mm256_set1_ps(fy0_scalar);
+	__m256 fy1 = _mm256_set1_ps(fy0_scalar - 1.0f);
+	__m256 fz0 = _mm256_set1_ps(fz0_scalar);
+	__m256 fz1 = _mm256_set1_ps(fz0_scalar - 1.0f);
+	__m256 r = _mm256_set1_ps(s_curve(fz0_scalar));
+	__m256 t = _mm256_set1_ps(s_curve(fy0_scalar));
+	__m256 amp = _mm256_set1_ps(amplitude);
+
+	for (; x + 8 <= count; x += 8)
+	{
+		PerlinNoise_AVX2_Row row;
+		setup_row(row, x, start_x, size_x, width, scale);
+
+		__m256 nxy0 = gradient_3d(lookup(permutation_table, row.ix0, hash_y0z0), row.fx0, fy0, fz0);
+		__m256 nxy1 = gradient_3d(lookup(permutation_table, row.ix0, hash_y0z1), row.fx0, fy0, fz1);
+		__m256 nx0 = lerp(r, nxy0, nxy1);
+
+		nxy0 = gradient_3d(lookup(permutation_table, row.ix0, hash_y1z0), row.fx0, fy1, fz0);
+		nxy1 = gradient_3d(lookup(permutation_table, row.ix0, hash_y1z1), row.fx0, fy1, fz1);
+		__m256 nx1 = lerp(r, nxy0, nxy1);
+
+		__m256 n0 = lerp(t, nx0, nx1);
+
+		nxy0 = gradient_3d(lookup(permutation_table, row.ix1, hash_y0z0), row.fx1, fy0, fz0);
+		nxy1 = gradient_3d(lookup(permutation_table, row.ix1, hash_y0z1), row.fx1, fy0, fz1);
+		nx0 = lerp(r, nxy0, nxy1);
+
+		nxy0 = gradient_3d(lookup(permutation_table, row.ix1, hash_y1z0), row.fx1, fy1, fz0);
+		nxy1 = gradient_3d(lookup(permutation_table, row.ix1, hash_y1z1), row.fx1, fy1, fz1);
+		nx1 = lerp(r, nxy0, nxy1);
+
+		__m256 n1 = lerp(t, nx0, nx1);
+
+		__m256 noise = lerp(row.s, n0, n1);
+		_mm256_storeu_ps(values + x, _mm256_add_ps(_mm256_loadu_ps(values + x), _mm256_mul_ps(amp, noise)));
+	}
+	return x;
+}
+
+}
+
+#endif
@@ -0,0 +1,65 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2015 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    agent
+*/
+
+#pragma once
+
+#if !defined(CL_ARM_PLATFORM) && !defined(CL_DISABLE_SSE2)
+#define CL_PERLIN_NOISE_SSE2
+#define CL_PERLIN_NOISE_AVX2
+#endif
+
+namespace clan
+{
+
+// The row kernels evaluate one octave of perlin noise for a row of pixels, where y (and z) are the same for every pixel.
+// Pixel x is sampled at (start_x + x * size_x / width) * scale, which is the same sequence of float operations as
+// PerlinNoise_Impl uses, so the kernels produce exactly the same values as the scalar code.
+// The noise, times amplitude, is added to values[x]. The kernels start at pixel x and return the pixel they stopped at,
+// so the caller can finish the rest with a narrower kernel or scalar code.
+// The permutation table must have 4 bytes of padding after its 512 entries.
+
+class PerlinNoise_SSE2
+{
+public:
+	static int noise_2d_row(const unsigned char *permutation_table, float *values, int x, int count, float start_x, float size_x, float width, float scale, float y, float amplitude);
+	static int noise_3d_row(const unsigned char *permutation_table, float *values, int x, int count, float start_x, float size_x, float width, float scale, float y, float z, float amplitude);
+
+	/// \brief Converts noise values to 8 bit colors as (int)(value * 128 + 128), clamped to 0-255. Returns the number converted.
+	static int to_r8(const float *values, unsigned char *output, int count);
+	static int to_rgba8(const float *values, unsigned int *output, int count);
+};
+
+// The AVX2 kernels must only be called when BatchMath::get_instruction_set() is avx2 or wider.
+class PerlinNoise_AVX2
+{
+public:
+	static int noise_2d_row(const unsigned char *permutation_table, float *values, int x, int count, float start_x, float size_x, float width, float scale, float y, float amplitude);
+	static int noise_3d_row(const unsigned char *permutation_table, float *values, int x, int count, float start_x, float size_x, float width, float scale, float y, float z, float amplitude);
+};
+
+}
@@ -0,0 +1,246 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2015 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    agent
+*/
+
+#include "Display/precomp.h"
+#include "perlin_noise_simd.h"
+
+#ifdef CL_PERLIN_NOISE_SSE2
+#include <emmintrin.h>
+
+namespace clan
+{
+
+// These follow PerlinNoise_Impl::noise_2d and noise_3d operation for operation. See perlin_noise.cpp for the scalar versions.
+
+static inline __m128 s_curve(__m128 t)
+{
+	__m128 t3 = _mm_mul_ps(_mm_mul_ps(t, t), t);
+	__m128 poly = _mm_add_ps(_mm_mul_ps(t, _mm_sub_ps(_mm_mul_ps(t, _mm_set1_ps(6.0f)), _mm_set1_ps(15.0f))), _mm_set1_ps(10.0f));
+	return _mm_mul_ps(t3, poly);
+}
+
+static inline __m128 lerp(__m128 t, __m128 a, __m128 b)
+{
+	return _mm_add_ps(a, _mm_mul_ps(t, _mm_sub_ps(b, a)));
+}
+
+static inline __m128 select(__m128i mask, __m128 if_set, __m128 if_clear)
+{
+	__m128 m = _mm_castsi128_ps(mask);
+	return _mm_or_ps(_mm_and_ps(m, if_set), _mm_andnot_ps(m, if_clear));
+}
+
+static inline __m128 negate_if(__m128 value, __m128i hash, int bit, int bit_index)
+{
+	__m128i sign = _mm_slli_epi32(_mm_and_si128(hash, _mm_set1_epi32(bit)), 31 - bit_index);
+	return _mm_xor_ps(value, _mm_castsi128_ps(sign));
+}
+
+static inline __m128 gradient_2d(__m128i hash, __m128 x, __m128 y)
+{
+	__m128i swap = _mm_cmpeq_epi32(_mm_and_si128(hash, _mm_set1_epi32(4)), _mm_set1_epi32(4));
+	__m128 u = negate_if(select(swap, y, x), hash, 1, 0);
+	__m128 v = negate_if(select(swap, x, y), hash, 2, 1);
+	return _mm_add_ps(u, _mm_mul_ps(_mm_set1_ps(2.0f), v));
+}
+
+static inline __m128 gradient_3d(__m128i hash, __m128 x, __m128 y, __m128 z)
+{
+	__m128i bit8 = _mm_cmpeq_epi32(_mm_and_si128(hash, _mm_set1_epi32(8)), _mm_set1_epi32(8));
+	__m128i bit4 = _mm_cmpeq_epi32(_mm_and_si128(hash, _mm_set1_epi32(4)), _mm_set1_epi32(4));
+	__m128i above_12 = _mm_and_si128(bit8, bit4);
+	__m128 u = negate_if(select(bit8, y, x), hash, 1, 0);
+	__m128 v = negate_if(select(bit4, select(above_12, x, z), y), hash, 2, 1);
+	return _mm_add_ps(u, v);
+}
+
+static inline __m128i lookup(const unsigned char *permutation_table, const int *index, int offset)
+{
+	return _mm_setr_epi32(
+		permutation_table[index[0] + offset],
+		permutation_table[index[1] + offset],
+		permutation_table[index[2] + offset],
+		permutation_table[index[3] + offset]);
+}
+
+// Position, lattice cell and s-curve of four pixels along the row
+struct PerlinNoise_SSE2_Row
+{
+	PerlinNoise_SSE2_Row(int x, float start_x, float size_x, float width, float scale)
+	{
+		__m128 pixel_x = _mm_cvtepi32_ps(_mm_add_epi32(_mm_set1_epi32(x), _mm_setr_epi32(0, 1, 2, 3)));
+		__m128 value_x = _mm_mul_ps(_mm_add_ps(_mm_set1_ps(start_x), _mm_div_ps(_mm_mul_ps(pixel_x, _mm_set1_ps(size_x)), _mm_set1_ps(width))), _mm_set1_ps(scale));
+
+		// cl_floor_to_int rounds integers and zero down to the next integer
+		__m128i positive = _mm_castps_si128(_mm_cmpgt_ps(value_x, _mm_setzero_ps()));
+		__m128i ix0 = _mm_sub_epi32(_mm_sub_epi32(_mm_cvttps_epi32(value_x), _mm_set1_epi32(1)), positive);
+
+		fx0 = _mm_sub_ps(value_x, _mm_cvtepi32_ps(ix0));
+		fx1 = _mm_sub_ps(fx0, _mm_set1_ps(1.0f));
+		s = s_curve(fx0);
+
+		__m128i mask = _mm_set1_epi32(0xff);
+		_mm_storeu_si128((__m128i *)ix1, _mm_and_si128(_mm_add_epi32(ix0, _mm_set1_epi32(1)), mask));
+		_mm_storeu_si128((__m128i *)this->ix0, _mm_and_si128(ix0, mask));
+	}
+
+	__m128 fx0, fx1, s;
+	int ix0[4];
+	int ix1[4];
+};
+
+static inline int floor_to_int(float value)
+{
+	return (value > 0.0f) ? ((int)value) : ((int)value - 1);
+}
+
+static inline float s_curve(float t)
+{
+	return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f);
+}
+
+int PerlinNoise_SSE2::noise_2d_row(const unsigned char *permutation_table, float *values, int x, int count, float start_x, float size_x, float width, float scale, float y, float amplitude)
+{
+	int iy0 = floor_to_int(y);
+	float fy0_scalar = y - iy0;
+	int iy1 = (iy0 + 1) & 0xff;
+	iy0 = iy0 & 0xff;
+	int hash_y0 = permutation_table[iy0];
+	int hash_y1 = permutation_table[iy1];
+
+	__m128 fy0 = _mm_set1_ps(fy0_scalar);
+	__m128 fy1 = _mm_set1_ps(fy0_scalar - 1.0f);
+	__m128 t = _mm_set1_ps(s_curve(fy0_scalar));
+	__m128 amp = _mm_set1_ps(amplitude);
+
+	for (; x + 4 <= count; x += 4)
+	{
+		PerlinNoise_SSE2_Row row(x, start_x, size_x, width, scale);
+
+		__m128 nx0 = gradient_2d(lookup(permutation_table, row.ix0, hash_y0), row.fx0, fy0);
+		__m128 nx1 = gradient_2d(lookup(permutation_table, row.ix0, hash_y1), row.fx0, fy1);
+		__m128 n0 = lerp(t, nx0, nx1);
+
+		nx0 = gradient_2d(lookup(permutation_table, row.ix1, hash_y0), row.fx1, fy0);
+		nx1 = gradient_2d(lookup(permutation_table, row.ix1, hash_y1), row.fx1, fy1);
+		__m128 n1 = lerp(t, nx0, nx1);
+
+		__m128 noise = lerp(row.s, n0, n1);
+		_mm_storeu_ps(values + x, _mm_add_ps(_mm_loadu_ps(values + x), _mm_mul_ps(amp, noise)));
+	}
+	return x;
+}
+
+int PerlinNoise_SSE2::noise_3d_row(const unsigned char *permutation_table, float *values, int x, int count, float start_x, float size_x, float width, float scale, float y, float z, float amplitude)
+{
+	int iy0 = floor_to_int(y);
+	int iz0 = floor_to_int(z);
+	float fy0_scalar = y - iy0;
+	float fz0_scalar = z - iz0;
+	int iy1 = (iy0 + 1) & 0xff;
+	int iz1 = (iz0 + 1) & 0xff;
+	iy0 = iy0 & 0xff;
+	iz0 = iz0 & 0xff;
+	int hash_y0z0 = permutation_table[iy0 + permutation_table[iz0]];
+	int hash_y0z1 = permutation_table[iy0 + permutation_table[iz1]];
+	int hash_y1z0 = permutation_table[iy1 + permutation_table[iz0]];
+	int hash_y1z1 = permutation_table[iy1 + permutation_table[iz1]];
+
+	__m128 fy0 = _mm_set1_ps(fy0_scalar);
+	__m128 fy1 = _mm_set1_ps(fy0_scalar - 1.0f);
+	__m128 fz0 = _mm_set1_ps(fz0_scalar);
+	__m128 fz1 = _mm_set1_ps(fz0_scalar - 1.0f);
+	__m128 r = _mm_set1_ps(s_curve(fz0_scalar));
+	__m128 t = _mm_set1_ps(s_curve(fy0_scalar));
+	__m128 amp = _mm_set1_ps(amplitude);
+
+	for (; x + 4 <= count; x += 4)
+	{
+		PerlinNoise_SSE2_Row row(x, start_x, size_x, width, scale);
+
+		__m128 nxy0 = gradient_3d(lookup(permutation_table, row.ix0, hash_y0z0), row.fx0, fy0, fz0);
+		__m128 nxy1 = gradient_3d(lookup(permutation_table, row.ix0, hash_y0z1), row.fx0, fy0, fz1);
+		__m128 nx0 = lerp(r, nxy0, nxy1);
+
+		nxy0 = gradient_3d(lookup(permutation_table, row.ix0, hash_y1z0), row.fx0, fy1, fz0);
+		nxy1 = gradient_3d(lookup(permutation_table, row.ix0, hash_y1z1), row.fx0, fy1, fz1);
+		__m128 nx1 = lerp(r, nxy0, nxy1);
+
+		__m128 n0 = lerp(t, nx0, nx1);
+
+		nxy0 = gradient_3d(lookup(permutation_table, row.ix1, hash_y0z0), row.fx1, fy0, fz0);
+		nxy1 = gradient_3d(lookup(permutation_table, row.ix1, hash_y0z1), row.fx1, fy0, fz1);
+		nx0 = lerp(r, nxy0, nxy1);
+
+		nxy0 = gradient_3d(lookup(permutation_table, row.ix1, hash_y1z0), row.fx1, fy1, fz0);
+		nxy1 = gradient_3d(lookup(permutation_table, row.ix1, hash_y1z1), row.fx1, fy1, fz1);
+		nx1 = lerp(r, nxy0, nxy1);
+
+		__m128 n1 = lerp(t, nx0, nx1);
+
+		__m128 noise = lerp(row.s, n0, n1);
+		_mm_storeu_ps(values + x, _mm_add_ps(_mm_loadu_ps(values + x), _mm_mul_ps(amp, noise)));
+	}
+	return x;
+}
+
+static inline __m128i to_color(const float *values)
+{
+	__m128 color = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(values), _mm_set1_ps(128.0f)), _mm_set1_ps(128.0f));
+	return _mm_cvttps_epi32(color);
+}
+
+int PerlinNoise_SSE2::to_r8(const float *values, unsigned char *output, int count)
+{
+	int x;
+	for (x = 0; x + 16 <= count; x += 16)
+	{
+		__m128i c01 = _mm_packs_epi32(to_color(values + x), to_color(values + x + 4));
+		__m128i c23 = _mm_packs_epi32(to_color(values + x + 8), to_color(values + x + 12));
+		_mm_storeu_si128((__m128i *)(output + x), _mm_packus_epi16(c01, c23));
+	}
+	return x;
+}
+
+int PerlinNoise_SSE2::to_rgba8(const float *values, unsigned int *output, int count)
+{
+	int x;
+	for (x = 0; x + 4 <= count; x += 4)
+	{
+		__m128i c = to_color(values + x);
+		c = _mm_packus_epi16(_mm_packs_epi32(c, c), _mm_setzero_si128());
+		c = _mm_unpacklo_epi8(c, c);
+		c = _mm_unpacklo_epi16(c, c);
+		_mm_storeu_si128((__m128i *)(output + x), c);
+	}
+	return x;
+}
+
+}
+
+#endif
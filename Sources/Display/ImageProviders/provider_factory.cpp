@@ -35,6 +35,7 @@
 #include "API/Display/Image/pixel_buffer.h"
 #include "API/Core/System/exception.h"
 #include "API/Core/Text/string_help.h"
+#include "API/Core/System/profiler.h"
 #include "API/Core/IOData/path_help.h"
 
 namespace clan
@@ -73,6 +74,7 @@ PixelBuffer ImageProviderFactory::load(
 	const std::string &type,
 	bool srgb)
 {
+	cl_profile_zone("ImageProviderFactory::load");
 	if (type != "")
 	{
 		if (types.find(type) == types.end()) throw Exception("Unknown image provider type " + type);
@@ -95,6 +97,7 @@ PixelBuffer ImageProviderFactory::load(
 	const std::string &type,
 	bool srgb)
 {
+	cl_profile_zone("ImageProviderFactory::load");
 	if (types.find(type) == types.end()) throw Exception("Unknown image provider type " + type);
 
 	ImageProviderType *factory = types[type];
@@ -29,6 +29,9 @@
 #include "Display/precomp.h"
 #include "API/Display/Resources/display_cache.h"
 #include "API/Core/Resources/resource_manager.h"
+#include "API/Display/2D/sprite.h"
+#include "API/Display/2D/image.h"
+#include "API/Display/Render/texture.h"
 
 namespace clan
 {
@@ -43,4 +46,28 @@ void DisplayCache::set(ResourceManager &resources, const std::shared_ptr<Display
 	resources.set_cache("clan.display", cache);
 }
 
+Resource<Sprite> DisplayCache::get_sprite_async(Canvas &canvas, const std::string &id)
+{
+	return get_sprite(canvas, id);
+}
+
+Resource<Image> DisplayCache::get_image_async(Canvas &canvas, const std::string &id)
+{
+	return get_image(canvas, id);
+}
+
+Resource<Texture> DisplayCache::get_texture_async(GraphicContext &gc, const std::string &id)
+{
+	return get_texture(gc, id);
+}
+
+void DisplayCache::prefetch_section(Canvas &canvas, const std::string &section)
+{
+}
+
+int DisplayCache::process_async_loads(int time_budget)
+{
+	return 0;
+}
+
 }
@@ -39,8 +39,15 @@
 #include "API/Core/Text/string_help.h"
 #include "API/Core/XML/dom_element.h"
 #include "API/Core/IOData/path_help.h"
+#include "API/Core/System/system.h"
+#include "API/Core/System/profiler.h"
+#include "API/Core/Resources/xml_resource_node.h"
+#include "API/Display/ImageProviders/provider_factory.h"
+#include "API/Display/Image/image_import_description.h"
 #include "xml_display_cache.h"
 #include "../Font/font_impl.h"
+#include "../2D/sprite_impl.h"
+#include "../2D/image_impl.h"
 
 namespace clan
 {
@@ -134,4 +141,264 @@ Resource<Font> XMLDisplayCache::load_font(Canvas &canvas, const FontDescription
 	}
 }
 
+Resource<Sprite> XMLDisplayCache::get_sprite_async(Canvas &canvas, const std::string &id)
+{
+	auto it = sprites.find(id);
+	if (it != sprites.end())
+	{
+		Resource<Sprite> sprite = it->second;
+		sprite.get() = sprite.get().clone();
+		return sprite;
+	}
+
+	std::shared_ptr<AsyncLoad> load = start_async_load("sprite", id, canvas, canvas.get_gc());
+	load->sprites.push_back(Resource<Sprite>());
+	return load->sprites.back();
+}
+
+Resource<Image> XMLDisplayCache::get_image_async(Canvas &canvas, const std::string &id)
+{
+	auto it = images.find(id);
+	if (it != images.end())
+	{
+		Resource<Image> image = it->second;
+		image.get() = image.get().clone();
+		return image;
+	}
+
+	std::shared_ptr<AsyncLoad> load = start_async_load("image", id, canvas, canvas.get_gc());
+	load->images.push_back(Resource<Image>());
+	return load->images.back();
+}
+
+Resource<Texture> XMLDisplayCache::get_texture_async(GraphicContext &gc, const std::string &id)
+{
+	auto it = textures.find(id);
+	if (it != textures.end())
+		return it->second;
+
+	return start_async_load("texture", id, Canvas(), gc)->texture;
+}
+
+void XMLDisplayCache::prefetch_section(Canvas &canvas, const std::string &section)
+{
+	cl_profile_zone("XMLDisplayCache::prefetch_section");
+
+	std::string prefix = PathHelp::add_trailing_slash(section, PathHelp::path_type_virtual);
+	std::vector<std::string> names = doc.get_resource_names();
+	for (auto &name : names)
+	{
+		if (name.compare(0, prefix.length(), prefix) != 0)
+			continue;
+
+		std::string type = doc.get_resource(name).get_type();
+		if (type == "sprite")
+		{
+			if (sprites.find(name) == sprites.end())
+				start_async_load(type, name, canvas, canvas.get_gc());
+		}
+		else if (type == "image")
+		{
+			if (images.find(name) == images.end())
+				start_async_load(type, name, canvas, canvas.get_gc());
+		}
+		else if (type == "texture")
+		{
+			if (textures.find(name) == textures.end())
+				start_async_load(type, name, canvas, canvas.get_gc());
+		}
+	}
+}
+
+int XMLDisplayCache::process_async_loads(int time_budget)
+{
+	cl_profile_zone("XMLDisplayCache::process_async_loads");
+
+	MutexSection mutex_lock(&decoded_mutex);
+	upload_queue.insert(upload_queue.end(), decoded_files.begin(), decoded_files.end());
+	decoded_files.clear();
+	mutex_lock.unlock();
+
+	// Items are removed from the queues before they are processed, so an exception leaves the queues consistent
+	ubyte64 start_time = System::get_microseconds();
+	do
+	{
+		if (!finish_queue.empty())
+		{
+			std::shared_ptr<AsyncLoad> load = finish_queue.front();
+			finish_queue.erase(finish_queue.begin());
+			finish_async_load(load);
+		}
+		else if (!upload_queue.empty())
+		{
+			std::shared_ptr<AsyncFile> file = upload_queue.front();
+			upload_queue.erase(upload_queue.begin());
+			upload_async_file(file);
+		}
+		else
+		{
+			break;
+		}
+	} while (System::get_microseconds() - start_time < (ubyte64) time_budget);
+
+	return (int) async_loads.size();
+}
+
+std::shared_ptr<XMLDisplayCache::AsyncLoad> XMLDisplayCache::start_async_load(const std::string &type, const std::string &id, const Canvas &canvas, const GraphicContext &gc)
+{
+	std::string key = type + ":" + id;
+	auto it = async_loads.find(key);
+	if (it != async_loads.end())
+		return it->second;
+
+	// The resource document is only read here, on the calling thread
+	XMLResourceNode resource = doc.get_resource(id);
+	if (type == "texture" && resource.get_type() != "texture")
+		throw Exception(string_format("Resource '%1' is not of type 'texture'", id));
+
+	std::shared_ptr<AsyncLoad> load = std::make_shared<AsyncLoad>(type, id);
+	load->canvas = canvas;
+	load->gc = gc;
+	async_loads[key] = load;
+
+	FileSystem fs = resource.get_file_system();
+	if (type == "texture")
+	{
+		add_async_file(load, PathHelp::combine(resource.get_base_path(), resource.get_element().get_attribute("file")), fs);
+	}
+	else
+	{
+		// Image files of the frames. File sequences are loaded when the resource is completed.
+		DomNode cur_node = resource.get_element().get_first_child();
+		while (!cur_node.is_null())
+		{
+			if (cur_node.is_element())
+			{
+				DomElement cur_element = cur_node.to_element();
+				std::string tag_name = cur_element.get_tag_name();
+				if ((tag_name == "image" || tag_name == "image-file") && cur_element.has_attribute("file"))
+					add_async_file(load, PathHelp::combine(resource.get_base_path(), cur_element.get_attribute("file")), fs);
+			}
+			cur_node = cur_node.get_next_sibling();
+		}
+	}
+
+	if (load->files_pending == 0)
+		finish_queue.push_back(load);
+
+	return load;
+}
+
+void XMLDisplayCache::add_async_file(const std::shared_ptr<AsyncLoad> &load, const std::string &filename, const FileSystem &fs)
+{
+	// Files are shared by the loads started before the file is uploaded
+	std::shared_ptr<AsyncFile> &file = async_files[filename];
+	if (!file)
+	{
+		file = std::make_shared<AsyncFile>(filename, fs, load->gc);
+
+		work_queue.queue([this, file]()
+		{
+			decode_async_file(file);
+			MutexSection mutex_lock(&decoded_mutex);
+			decoded_files.push_back(file);
+		});
+	}
+
+	load->files.push_back(file);
+	file->loads.push_back(load);
+	load->files_pending++;
+}
+
+void XMLDisplayCache::decode_async_file(const std::shared_ptr<AsyncFile> &file)
+{
+	cl_profile_zone("XMLDisplayCache::decode_async_file");
+	try
+	{
+		// Same steps as the Texture2D file constructor, minus the upload
+		PixelBuffer pixels = ImageProviderFactory::load(file->filename, file->fs);
+		pixels = ImageImportDescription().process(pixels);
+		if (pixels.get_format() != tf_rgba8)
+			pixels = pixels.to_format(tf_rgba8);
+		file->pixels = pixels;
+	}
+	catch (Exception &e)
+	{
+		file->error = e.message;
+	}
+}
+
+void XMLDisplayCache::upload_async_file(const std::shared_ptr<AsyncFile> &file)
+{
+	cl_profile_zone("XMLDisplayCache::upload_async_file");
+
+	if (file->error.empty())
+		file->texture = Texture2D(file->gc, file->pixels, file->pixels.get_size(), false);
+	file->pixels = PixelBuffer();
+	async_files.erase(file->filename);
+
+	for (auto &weak_load : file->loads)
+	{
+		std::shared_ptr<AsyncLoad> load = weak_load.lock();
+		if (load && --load->files_pending == 0)
+			finish_queue.push_back(load);
+	}
+	file->loads.clear();
+}
+
+void XMLDisplayCache::finish_async_load(const std::shared_ptr<AsyncLoad> &load)
+{
+	cl_profile_zone("XMLDisplayCache::finish_async_load");
+
+	async_loads.erase(load->type + ":" + load->id);
+
+	for (auto &file : load->files)
+	{
+		if (!file->error.empty())
+			throw Exception(string_format("Unable to load '%1' for resource '%2': %3", file->filename, load->id, file->error));
+	}
+
+	// Textures not uploaded in advance are loaded the normal way
+	auto load_texture = [&](const std::string &filename, const FileSystem &fs) -> Texture2D
+	{
+		for (auto &file : load->files)
+		{
+			if (file->filename == filename)
+				return file->texture;
+		}
+		return Texture2D(load->gc, filename, fs);
+	};
+
+	if (load->type == "sprite")
+	{
+		auto it = sprites.find(load->id);
+		if (it == sprites.end())
+			it = sprites.insert(std::make_pair(load->id, Resource<Sprite>(Sprite_Impl::load(load->canvas, load->id, doc, load_texture)))).first;
+		for (auto &sprite : load->sprites)
+			sprite.set(it->second.get().clone());
+	}
+	else if (load->type == "image")
+	{
+		auto it = images.find(load->id);
+		if (it == images.end())
+			it = images.insert(std::make_pair(load->id, Resource<Image>(Image_Impl::load(load->canvas, load->id, doc, load_texture)))).first;
+		for (auto &image : load->images)
+			image.set(it->second.get().clone());
+	}
+	else if (load->type == "texture")
+	{
+		auto it = textures.find(load->id);
+		if (it == textures.end())
+		{
+			// Same as Texture::load
+			load->texture.set(load_texture(load->files.front()->filename, load->files.front()->fs));
+			textures[load->id] = load->texture;
+		}
+		else
+		{
+			load->texture.set(it->second.get());
+		}
+	}
+}
+
 }
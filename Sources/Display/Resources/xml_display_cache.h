@@ -30,6 +30,12 @@
 
 #include "API/Display/Resources/display_cache.h"
 #include "API/Core/Resources/xml_resource_document.h"
+#include "API/Core/System/work_queue.h"
+#include "API/Core/System/mutex.h"
+#include "API/Display/2D/canvas.h"
+#include "API/Display/Render/graphic_context.h"
+#include "API/Display/Render/texture_2d.h"
+#include "API/Display/Image/pixel_buffer.h"
 
 namespace clan
 {
@@ -45,15 +51,74 @@ public:
 	Resource<Texture> get_texture(GraphicContext &gc, const std::string &id) override;
 	Resource<Font> get_font(Canvas &canvas, const FontDescription &desc) override;
 
+	Resource<Sprite> get_sprite_async(Canvas &canvas, const std::string &id) override;
+	Resource<Image> get_image_async(Canvas &canvas, const std::string &id) override;
+	Resource<Texture> get_texture_async(GraphicContext &gc, const std::string &id) override;
+	void prefetch_section(Canvas &canvas, const std::string &section) override;
+	int process_async_loads(int time_budget) override;
+
 private:
+	class AsyncLoad;
+
+	// Image file read and decoded by a worker, then uploaded by process_async_loads
+	class AsyncFile
+	{
+	public:
+		AsyncFile(const std::string &filename, const FileSystem &fs, const GraphicContext &gc) : filename(filename), fs(fs), gc(gc) { }
+
+		std::string filename;
+		FileSystem fs;
+		GraphicContext gc;
+
+		PixelBuffer pixels;	// Set by the worker
+		std::string error;	// Set by the worker if the file could not be loaded
+
+		Texture2D texture;
+		std::vector<std::weak_ptr<AsyncLoad> > loads;	// Loads waiting for the upload
+	};
+
+	class AsyncLoad
+	{
+	public:
+		AsyncLoad(const std::string &type, const std::string &id) : type(type), id(id), files_pending(0) { }
+
+		std::string type;
+		std::string id;
+		Canvas canvas;
+		GraphicContext gc;
+
+		std::vector<std::shared_ptr<AsyncFile> > files;
+		int files_pending;
+
+		std::vector<Resource<Sprite> > sprites;	// Each requester gets its own clone
+		std::vector<Resource<Image> > images;
+		Resource<Texture> texture;
+	};
+
 	Resource<Font> load_font(Canvas &canvas, const FontDescription &desc);
 
+	std::shared_ptr<AsyncLoad> start_async_load(const std::string &type, const std::string &id, const Canvas &canvas, const GraphicContext &gc);
+	void add_async_file(const std::shared_ptr<AsyncLoad> &load, const std::string &filename, const FileSystem &fs);
+	void upload_async_file(const std::shared_ptr<AsyncFile> &file);
+	void finish_async_load(const std::shared_ptr<AsyncLoad> &load);
+	static void decode_async_file(const std::shared_ptr<AsyncFile> &file);
+
 	XMLResourceDocument doc;
 
 	std::map<std::string, Resource<Sprite> > sprites;
 	std::map<std::string, Resource<Image> > images;
 	std::map<std::string, Resource<Texture> > textures;
 	std::map<std::string, Resource<Font> > fonts;
+
+	std::map<std::string, std::shared_ptr<AsyncLoad> > async_loads;	// Key is type and id
+	std::map<std::string, std::shared_ptr<AsyncFile> > async_files;	// Files not uploaded yet, by filename
+	std::vector<std::shared_ptr<AsyncFile> > upload_queue;
+	std::vector<std::shared_ptr<AsyncLoad> > finish_queue;
+
+	Mutex decoded_mutex;
+	std::vector<std::shared_ptr<AsyncFile> > decoded_files;
+
+	WorkQueue work_queue;	// Destroyed first, so the workers are gone before the rest
 };
 
 }
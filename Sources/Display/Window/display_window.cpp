@@ -31,6 +31,7 @@
 #include "Display/precomp.h"
 #include "display_window_impl.h"
 #include "../Render/graphic_context_impl.h"
+#include "API/Core/System/profiler.h"
 
 namespace clan
 {
@@ -398,8 +399,12 @@ void DisplayWindow::update(const Rect &rect)
 
 void DisplayWindow::flip(int interval)
 {
-	impl->sig_window_flip();
-	impl->provider->flip(interval);
+	{
+		cl_profile_zone("DisplayWindow::flip");
+		impl->sig_window_flip();
+		impl->provider->flip(interval);
+	}
+	Profiler::frame_mark();
 }
 
 void DisplayWindow::show_cursor()
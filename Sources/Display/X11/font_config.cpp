@@ -74,15 +74,19 @@ std::string FontConfig::match_font(const FontDescription &desc) const
 	FcPattern * fc_match = nullptr;
 	try
 	{
-		int weight = desc.get_weight();
+		int weight = (int) desc.get_weight();
+		int slant = FC_SLANT_ROMAN;
+		if (desc.get_style() == FontStyle::italic)
+			slant = FC_SLANT_ITALIC;
+		else if (desc.get_style() == FontStyle::oblique)
+			slant = FC_SLANT_OBLIQUE;
 
 		// Build font matching pattern.
 		fc_pattern = FcPatternBuild (nullptr,
 		FC_FAMILY, FcTypeString, desc.get_typeface_name().c_str(),
 		FC_PIXEL_SIZE, FcTypeDouble, (double) std::abs(desc.get_height()),
 		FC_WEIGHT, FcTypeInteger, ((weight > 0) ? (int)(weight * (FC_WEIGHT_HEAVY/900.0)) : FC_WEIGHT_NORMAL),
-		FC_SLANT, FcTypeInteger, desc.get_italic() ? FC_SLANT_ITALIC : FC_SLANT_ROMAN,
-		FC_SPACING, FcTypeInteger, desc.get_fixed_pitch() ? FC_MONO : FC_PROPORTIONAL,
+		FC_SLANT, FcTypeInteger, slant,
 		(char*) nullptr);
 		if (!fc_pattern)
 		{
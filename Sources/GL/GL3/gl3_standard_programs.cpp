@@ -206,6 +206,113 @@ const std::string::value_type *cl_glsl_fragment_sprite =
 	"void main() { gl_FragColor = Color*sampleTexture(TexIndex, TexCoord); } ";
 
 
+// The sdf glyph program uses the sprite vertex shader. The alpha channel holds a signed distance field
+// (0.5 is the glyph edge), which is converted to coverage using the screen space derivative
+const std::string::value_type *cl_glsl15_fragment_sdf_glyph =
+	"#version 150\n"
+	"uniform sampler2D Texture0; "
+	"uniform sampler2D Texture1; "
+	"uniform sampler2D Texture2; "
+	"uniform sampler2D Texture3; "
+	"uniform sampler2D Texture4; "
+	"uniform sampler2D Texture5; "
+	"uniform sampler2D Texture6; "
+	"uniform sampler2D Texture7; "
+	"uniform sampler2D Texture8; "
+	"uniform sampler2D Texture9; "
+	"uniform sampler2D Texture10; "
+	"uniform sampler2D Texture11; "
+	"uniform sampler2D Texture12; "
+	"uniform sampler2D Texture13; "
+	"uniform sampler2D Texture14; "
+	"uniform sampler2D Texture15; "
+	"in vec4 Color; "
+	"in vec2 TexCoord; "
+	"flat in int TexIndex; "
+	"out vec4 cl_FragColor; "
+	"highp vec4 sampleTexture(int index, highp vec2 pos) "
+	"{ "
+		"switch (index) "
+		"{ "
+			"case 0: return texture(Texture0, TexCoord); "
+			"case 1: return texture(Texture1, TexCoord); "
+			"case 2: return texture(Texture2, TexCoord); "
+			"case 3: return texture(Texture3, TexCoord); "
+			"case 4: return texture(Texture4, TexCoord); "
+			"case 5: return texture(Texture5, TexCoord); "
+			"case 6: return texture(Texture6, TexCoord); "
+			"case 7: return texture(Texture7, TexCoord); "
+			"case 8: return texture(Texture8, TexCoord); "
+			"case 9: return texture(Texture9, TexCoord); "
+			"case 10: return texture(Texture10, TexCoord); "
+			"case 11: return texture(Texture11, TexCoord); "
+			"case 12: return texture(Texture12, TexCoord); "
+			"case 13: return texture(Texture13, TexCoord); "
+			"case 14: return texture(Texture14, TexCoord); "
+			"case 15: return texture(Texture15, TexCoord); "
+			"default: return vec4(1.0,1.0,1.0,1.0); "
+		"} "
+	"} "
+	"void main() "
+	"{ "
+		"float dist = sampleTexture(TexIndex, TexCoord).a; "
+		"float width = max(fwidth(dist) * 0.75, 0.001); "
+		"float coverage = smoothstep(0.5 - width, 0.5 + width, dist); "
+		"cl_FragColor = vec4(Color.rgb, Color.a * coverage); "
+	"} ";
+
+const std::string::value_type *cl_glsl_fragment_sdf_glyph =
+	"#version 130\n"
+	"uniform sampler2D Texture0; "
+	"uniform sampler2D Texture1; "
+	"uniform sampler2D Texture2; "
+	"uniform sampler2D Texture3; "
+	"uniform sampler2D Texture4; "
+	"uniform sampler2D Texture5; "
+	"uniform sampler2D Texture6; "
+	"uniform sampler2D Texture7; "
+	"uniform sampler2D Texture8; "
+	"uniform sampler2D Texture9; "
+	"uniform sampler2D Texture10; "
+	"uniform sampler2D Texture11; "
+	"uniform sampler2D Texture12; "
+	"uniform sampler2D Texture13; "
+	"uniform sampler2D Texture14; "
+	"uniform sampler2D Texture15; "
+	"in vec4 Color; "
+	"in vec2 TexCoord; "
+	"flat in int TexIndex; "
+	"vec4 sampleTexture(int index, vec2 pos) "
+	"{ "
+		"switch (index) "
+		"{ "
+			"case 0: return texture(Texture0, TexCoord); "
+			"case 1: return texture(Texture1, TexCoord); "
+			"case 2: return texture(Texture2, TexCoord); "
+			"case 3: return texture(Texture3, TexCoord); "
+			"case 4: return texture(Texture4, TexCoord); "
+			"case 5: return texture(Texture5, TexCoord); "
+			"case 6: return texture(Texture6, TexCoord); "
+			"case 7: return texture(Texture7, TexCoord); "
+			"case 8: return texture(Texture8, TexCoord); "
+			"case 9: return texture(Texture9, TexCoord); "
+			"case 10: return texture(Texture10, TexCoord); "
+			"case 11: return texture(Texture11, TexCoord); "
+			"case 12: return texture(Texture12, TexCoord); "
+			"case 13: return texture(Texture13, TexCoord); "
+			"case 14: return texture(Texture14, TexCoord); "
+			"case 15: return texture(Texture15, TexCoord); "
+			"default: return vec4(1.0,1.0,1.0,1.0); "
+		"} "
+	"} "
+	"void main() "
+	"{ "
+		"float dist = sampleTexture(TexIndex, TexCoord).a; "
+		"float width = max(fwidth(dist) * 0.75, 0.001); "
+		"float coverage = smoothstep(0.5 - width, 0.5 + width, dist); "
+		"gl_FragColor = vec4(Color.rgb, Color.a * coverage); "
+	"} ";
+
 const std::string::value_type *cl_glsl_vertex_path =
 	"#version 130\n"
 	"	in ivec4 Vertex;\n"
@@ -489,6 +596,7 @@ public:
 	ProgramObject single_texture_program;
 	ProgramObject sprite_program;
 	ProgramObject path_program;
+	ProgramObject sdf_glyph_program;
 
 };
 
@@ -542,6 +650,10 @@ GL3StandardPrograms::GL3StandardPrograms(GL3GraphicContextProvider *provider) :
 	if (!fragment_path_shader.compile())
 		throw Exception("Unable to compile the standard shader program: 'fragment path' Error:" + fragment_path_shader.get_info_log());
 
+	ShaderObject fragment_sdf_glyph_shader(provider, shadertype_fragment, use_glsl_150 ? cl_glsl15_fragment_sdf_glyph : cl_glsl_fragment_sdf_glyph);
+	if (!fragment_sdf_glyph_shader.compile())
+		throw Exception("Unable to compile the standard shader program: 'fragment sdf glyph' Error:" + fragment_sdf_glyph_shader.get_info_log());
+
 	ProgramObject color_only_program(provider);
 	color_only_program.attach(vertex_color_only_shader);
 	color_only_program.attach(fragment_color_only_shader);
@@ -613,10 +725,42 @@ GL3StandardPrograms::GL3StandardPrograms(GL3GraphicContextProvider *provider) :
 	path_program.set_uniform1i("instance_data", 1);
 	path_program.set_uniform1i("image_texture", 2);
 
+	ProgramObject sdf_glyph_program(provider);
+	sdf_glyph_program.attach(vertex_sprite_shader);
+	sdf_glyph_program.attach(fragment_sdf_glyph_shader);
+	sdf_glyph_program.bind_attribute_location(0, "Position");
+	sdf_glyph_program.bind_attribute_location(1, "Color0");
+	sdf_glyph_program.bind_attribute_location(2, "TexCoord0");
+	sdf_glyph_program.bind_attribute_location(3, "TexIndex0");
+
+	if (use_glsl_150)
+		sdf_glyph_program.bind_frag_data_location(0, "cl_FragColor");
+
+	if (!sdf_glyph_program.link())
+		throw Exception("Unable to link the standard shader program: 'sdf glyph' Error:" + sdf_glyph_program.get_info_log());
+
+	sdf_glyph_program.set_uniform1i("Texture0", 0);
+	sdf_glyph_program.set_uniform1i("Texture1", 1);
+	sdf_glyph_program.set_uniform1i("Texture2", 2);
+	sdf_glyph_program.set_uniform1i("Texture3", 3);
+	sdf_glyph_program.set_uniform1i("Texture4", 4);
+	sdf_glyph_program.set_uniform1i("Texture5", 5);
+	sdf_glyph_program.set_uniform1i("Texture6", 6);
+	sdf_glyph_program.set_uniform1i("Texture7", 7);
+	sdf_glyph_program.set_uniform1i("Texture8", 8);
+	sdf_glyph_program.set_uniform1i("Texture9", 9);
+	sdf_glyph_program.set_uniform1i("Texture10", 10);
+	sdf_glyph_program.set_uniform1i("Texture11", 11);
+	sdf_glyph_program.set_uniform1i("Texture12", 12);
+	sdf_glyph_program.set_uniform1i("Texture13", 13);
+	sdf_glyph_program.set_uniform1i("Texture14", 14);
+	sdf_glyph_program.set_uniform1i("Texture15", 15);
+
 	impl->color_only_program = color_only_program;
 	impl->single_texture_program = single_texture_program;
 	impl->sprite_program = sprite_program;
 	impl->path_program = path_program;
+	impl->sdf_glyph_program = sdf_glyph_program;
 
 	RenderBatchTriangle::max_textures = 16; // Too many hacks..
 }
@@ -633,6 +777,7 @@ ProgramObject GL3StandardPrograms::get_program_object(StandardProgram standard_p
 	case program_single_texture: return impl->single_texture_program;
 	case program_sprite: return impl->sprite_program;
 	case program_path: return impl->path_program;
+	case program_sdf_glyph: return impl->sdf_glyph_program;
 	}
 	throw Exception("Unsupported standard program");
 }
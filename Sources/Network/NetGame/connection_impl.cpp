@@ -31,6 +31,7 @@
 #include "API/Network/NetGame/connection.h"
 #include "API/Network/NetGame/connection_site.h"
 #include "API/Core/System/databuffer.h"
+#include "API/Core/System/profiler.h"
 #include "network_event.h"
 #include "network_data.h"
 #include "connection_impl.h"
@@ -119,6 +120,7 @@ SocketName NetGameConnection_Impl::get_remote_name() const
 
 void NetGameConnection_Impl::connection_main()
 {
+	Profiler::set_thread_name("NetGame connection");
 	try
 	{
 		if (!is_connected)
@@ -148,6 +150,7 @@ void NetGameConnection_Impl::connection_main()
 			}
 			else if (wakeup_reason == 1) // we got data to receive
 			{
+				cl_profile_zone("NetGameConnection receive");
 				int bytes = connection.read(receive_buffer.get_data() + bytes_received, receive_buffer.get_size() - bytes_received, false);
 				if (bytes <= 0)
 				{
@@ -171,6 +174,7 @@ void NetGameConnection_Impl::connection_main()
 			}
 			else if (wakeup_reason == 2) // we got data to send
 			{
+				cl_profile_zone("NetGameConnection send");
 				if (!send_buffer_empty)
 				{
 					int bytes = connection.write(send_buffer.get_data() + bytes_sent, send_buffer.get_size() - bytes_sent, false);
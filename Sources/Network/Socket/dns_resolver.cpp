@@ -130,6 +130,12 @@ DNSResolver::~DNSResolver()
 /////////////////////////////////////////////////////////////////////////////
 // DNSResolver Attributes:
 
+std::vector<SocketName> DNSResolver::get_dns_servers() const
+{
+	MutexSection mutex_lock(&impl->mutex);
+	return impl->dns_servers;
+}
+
 /////////////////////////////////////////////////////////////////////////////
 // DNSResolver Operations:
 
@@ -138,140 +144,80 @@ std::vector<DNSResourceRecord> DNSResolver::lookup_resource(
 		const std::string &resource_type,
 		int timeout)
 {
-	std::string dns_server = impl->dns_servers[0].get_address();
-
-	for (int i=0; i<25; i++)
+	std::vector<DNSResourceRecord> results;
+	std::string error;
+	if (impl->find_in_cache(domain_name, resource_type, results, error))
 	{
-		DNSPacket packet = perform_query(
-			domain_name, resource_type, timeout, dns_server);
-
-		if (packet.is_truncated())
-			throw Exception("Unable to lookup DNS resource; truncated DNS answer packet");
-
-		switch (packet.get_response_code())
-		{
-		case DNSPacket::response_ok:
-			break;
-		case DNSPacket::response_format_error:
-			throw Exception("Unable to lookup DNS resource; format error");
-		case DNSPacket::response_server_failure:
-			throw Exception("Unable to lookup DNS resource; server failure");
-		case DNSPacket::response_name_error:
-			throw Exception("Unable to lookup DNS resource; name error");
-		case DNSPacket::response_not_implemented:
-			throw Exception("Unable to lookup DNS resource; not implemented");
-		case DNSPacket::response_refused:
-			throw Exception("Unable to lookup DNS resource; refused");
-		default:
-			throw Exception("Unable to lookup DNS resource; unknown error");
-		}
-
-		// Does this DNS server know the answer?
-		std::string domain_name_cname;
-		std::vector<DNSResourceRecord> results;
-		int j;
-		for (j=0; j<packet.get_answer_count(); j++)
-		{
-			DNSResourceRecord record = packet.get_answer(j);
-
-			if (record.get_name() == domain_name && record.get_type() == "CNAME")
-				domain_name_cname = record.get_cname_cname();
-
-			if (record.get_name() == domain_name && record.get_type() == resource_type)
-				results.push_back(record);
-		}
-		for (j=0; j<packet.get_additional_count(); j++)
-		{
-			DNSResourceRecord record = packet.get_additional(j);
-
-			if (record.get_name() == domain_name && record.get_type() == "CNAME")
-				domain_name_cname = record.get_cname_cname();
-
-			if (record.get_name() == domain_name && record.get_type() == resource_type)
-				results.push_back(record);
-		}
-		if (!results.empty())
-			return results;
-
-		// Check for CNAME redirected answers:
-		if (!domain_name_cname.empty())
-		{
-			for (j=0; j<packet.get_answer_count(); j++)
-			{
-				DNSResourceRecord record = packet.get_answer(j);
-				if (record.get_name() == domain_name_cname && record.get_type() == resource_type)
-					results.push_back(record);
-			}
-			for (j=0; j<packet.get_additional_count(); j++)
-			{
-				DNSResourceRecord record = packet.get_additional(j);
-				if (record.get_name() == domain_name_cname && record.get_type() == resource_type)
-					results.push_back(record);
-			}
-			if (!results.empty())
-				return results;
-		}
+		if (!error.empty())
+			throw Exception(error);
+		return results;
+	}
 
-		// Does it know someone who does?
-		if (packet.get_nameserver_count() > 0)
-		{
-			DNSResourceRecord rr = packet.get_nameserver(0);
-			if (rr.get_type() != "NS")
-				throw Exception("Unable to lookup DNS resource");
-			dns_server = rr.get_ns_nsdname();
-			continue;
-		}
+	Event event_done;
+	impl->lookup(domain_name, resource_type, timeout, [&results, &error, event_done](const std::vector<DNSResourceRecord> &records, const std::string &lookup_error) mutable
+	{
+		results = records;
+		error = lookup_error;
+		event_done.set();
+	});
+	event_done.wait();
+
+	if (!error.empty())
+		throw Exception(error);
+	return results;
+}
 
-		// Looks like this resource does not exist.
-		throw Exception("DNS resource data not found");
-	}
+void DNSResolver::lookup_resource_async(
+	const std::string &domain_name,
+	const std::string &resource_type,
+	int timeout,
+	const LookupCallback &callback)
+{
+	impl->lookup(domain_name, resource_type, timeout, callback);
+}
 
-	std::vector<DNSResourceRecord> results;
+std::vector<std::string> DNSResolver::lookup_addresses(const std::string &domain_name, int timeout)
+{
+	std::vector<std::string> results;
+	std::string error;
+	Event event_done;
+	impl->lookup_addresses(domain_name, timeout, [&results, &error, event_done](const std::vector<std::string> &addresses, const std::string &lookup_error) mutable
+	{
+		results = addresses;
+		error = lookup_error;
+		event_done.set();
+	});
+	event_done.wait();
+
+	if (!error.empty())
+		throw Exception(error);
 	return results;
 }
 
+void DNSResolver::lookup_addresses_async(const std::string &domain_name, int timeout, const AddressesCallback &callback)
+{
+	impl->lookup_addresses(domain_name, timeout, callback);
+}
+
 DNSPacket DNSResolver::perform_query(
 	DNSPacket &packet,
 	int timeout,
 	const std::string &dns_server_name)
 {
-	MutexSection mutex_lock(&impl->mutex);
-	int query_id = impl->query_id++;
-	if (impl->query_id > 0xffff)
-		impl->query_id = 0;
-	packet.set_query_id(query_id);
-	impl->queries[query_id] = packet;
-	mutex_lock.unlock();
-
-	for (int i = 0; i < timeout; i += 1000)
+	DNSPacket answer;
+	std::string error;
+	Event event_done;
+	impl->send_query(packet, std::vector<SocketName>(1, SocketName(dns_server_name, "53")), timeout, [&answer, &error, event_done](const DNSPacket &query_answer, const std::string &query_error) mutable
 	{
-		SocketName dns_server(dns_server_name, "53");
-		impl->udp_socket.send(
-			packet.get_data().get_data(),
-			packet.get_data().get_size(),
-			dns_server);
-		impl->event_bound.set();
-
-		for (int j = 0; j < 10; j++)
-		{
-			System::sleep(100);
-			mutex_lock.lock();
-			std::map<int, DNSPacket>::iterator it;
-			it = impl->answers.find(query_id);
-			if (it != impl->answers.end())
-			{
-				DNSPacket result = it->second;
-				impl->answers.erase(it);
-				impl->queries.erase(impl->queries.find(query_id));
-				return result;
-			}
-			mutex_lock.unlock();
-		}
-	}
-
-	impl->queries.erase(impl->queries.find(query_id));
-	throw Exception("Unable to perform lookup");
-	return DNSPacket();
+		answer = query_answer;
+		error = query_error;
+		event_done.set();
+	});
+	event_done.wait();
+
+	if (!error.empty())
+		throw Exception(error);
+	return answer;
 }
 
 DNSPacket DNSResolver::perform_query(
@@ -290,6 +236,17 @@ DNSPacket DNSResolver::perform_query(
 	return perform_query(packet, timeout, dns_server_name);
 }
 
+void DNSResolver::set_dns_servers(const std::vector<SocketName> &dns_servers)
+{
+	MutexSection mutex_lock(&impl->mutex);
+	impl->dns_servers = dns_servers;
+}
+
+void DNSResolver::clear_cache()
+{
+	impl->clear_cache();
+}
+
 /////////////////////////////////////////////////////////////////////////////
 // DNSResolver Implementation:
 
@@ -29,16 +29,53 @@
 #include "Network/precomp.h"
 #include "dns_resolver_impl.h"
 #include "API/Core/System/databuffer.h"
+#include "API/Core/System/system.h"
+#include "API/Core/System/profiler.h"
 #include "API/Core/Text/logger.h"
+#include "API/Core/Text/string_help.h"
+#include <algorithm>
 
 namespace clan
 {
 
+/// \brief A and AAAA lookups started by lookup_addresses, completed by whichever finishes last
+class DNSResolver_AddressLookup
+{
+public:
+	void complete(int index, const std::vector<DNSResourceRecord> &records, const std::string &error)
+	{
+		MutexSection mutex_lock(&mutex);
+		results[index] = records;
+		errors[index] = error;
+		if (--lookups_left > 0)
+			return;
+		mutex_lock.unlock();
+
+		std::vector<std::string> addresses;
+		for (auto &record : results[0])
+			addresses.push_back(record.get_a_address_str());
+		for (auto &record : results[1])
+			addresses.push_back(record.get_aaaa_address_str());
+
+		if (addresses.empty() && !errors[0].empty())
+			callback(addresses, errors[0]);
+		else if (addresses.empty() && !errors[1].empty())
+			callback(addresses, errors[1]);
+		else
+			callback(addresses, std::string());
+	}
+
+	Mutex mutex;
+	int lookups_left = 2;
+	std::vector<DNSResourceRecord> results[2];
+	std::string errors[2];
+	DNSResolver::AddressesCallback callback;
+};
+
 /////////////////////////////////////////////////////////////////////////////
 // DNSResolver_Impl Construction:
 
 DNSResolver_Impl::DNSResolver_Impl()
-: query_id(0)
 {
 	thread.start(this, &DNSResolver_Impl::thread_main);
 }
@@ -47,6 +84,13 @@ DNSResolver_Impl::~DNSResolver_Impl()
 {
 	event_stop.set();
 	thread.join();
+
+	std::vector<DNSResolver_QueryCallback> callbacks;
+	for (auto &query : queries)
+		callbacks.push_back(query.second.callback);
+	queries.clear();
+	for (auto &callback : callbacks)
+		callback(DNSPacket(), "DNS resolver destroyed");
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -55,45 +99,460 @@ DNSResolver_Impl::~DNSResolver_Impl()
 /////////////////////////////////////////////////////////////////////////////
 // DNSResolver_Impl Operations:
 
+void DNSResolver_Impl::lookup(const std::string &domain_name, const std::string &resource_type, int timeout, const DNSResolver::LookupCallback &callback)
+{
+	std::string key = get_cache_key(domain_name, resource_type);
+	int question_type = DNSResourceRecord::type_to_int(resource_type);
+
+	MutexSection mutex_lock(&mutex);
+
+	auto cache_it = cache.find(key);
+	if (cache_it != cache.end())
+	{
+		if (cache_it->second.expire_time > System::get_time())
+		{
+			std::vector<DNSResourceRecord> records = cache_it->second.records;
+			std::string error = cache_it->second.error;
+			mutex_lock.unlock();
+			callback(records, error);
+			return;
+		}
+		cache.erase(cache_it);
+	}
+
+	// Join the lookup already in progress for this name
+	auto lookup_it = lookups.find(key);
+	if (lookup_it != lookups.end())
+	{
+		lookup_it->second->callbacks.push_back(callback);
+		return;
+	}
+
+	if (dns_servers.empty())
+	{
+		mutex_lock.unlock();
+		callback(std::vector<DNSResourceRecord>(), "No DNS servers");
+		return;
+	}
+
+	std::shared_ptr<DNSResolver_Lookup> lookup = std::make_shared<DNSResolver_Lookup>();
+	lookup->key = key;
+	lookup->domain_name = domain_name;
+	lookup->resource_type = resource_type;
+	lookup->question_type = question_type;
+	lookup->timeout = timeout;
+	lookup->referrals = 0;
+	lookup->callbacks.push_back(callback);
+	lookups[key] = lookup;
+	std::vector<SocketName> servers = dns_servers;
+	mutex_lock.unlock();
+
+	send_lookup_query(lookup, servers);
+}
+
+void DNSResolver_Impl::lookup_addresses(const std::string &domain_name, int timeout, const DNSResolver::AddressesCallback &callback)
+{
+	std::shared_ptr<DNSResolver_AddressLookup> address_lookup = std::make_shared<DNSResolver_AddressLookup>();
+	address_lookup->callback = callback;
+	lookup(domain_name, "A", timeout, [address_lookup](const std::vector<DNSResourceRecord> &records, const std::string &error) { address_lookup->complete(0, records, error); });
+	lookup(domain_name, "AAAA", timeout, [address_lookup](const std::vector<DNSResourceRecord> &records, const std::string &error) { address_lookup->complete(1, records, error); });
+}
+
+void DNSResolver_Impl::send_query(DNSPacket &packet, const std::vector<SocketName> &servers, int timeout, const DNSResolver_QueryCallback &callback)
+{
+	ubyte64 current_time = System::get_time();
+
+	MutexSection mutex_lock(&mutex);
+	int query_id = create_query_id();
+	packet.set_query_id(query_id);
+	DNSResolver_Query &query = queries[query_id];
+	query.packet = packet;
+	query.servers = servers;
+	query.server_index = 0;
+	query.resend_time = current_time + resend_interval;
+	query.timeout_time = current_time + timeout;
+	query.callback = callback;
+	mutex_lock.unlock();
+
+	try
+	{
+		udp_socket.send(packet.get_data().get_data(), packet.get_data().get_size(), servers[0]);
+	}
+	catch (const Exception &e)
+	{
+		mutex_lock.lock();
+		queries.erase(query_id);
+		mutex_lock.unlock();
+		callback(DNSPacket(), e.message);
+		return;
+	}
+
+	event_bound.set();
+	event_wakeup.set();
+}
+
+bool DNSResolver_Impl::find_in_cache(const std::string &domain_name, const std::string &resource_type, std::vector<DNSResourceRecord> &out_records, std::string &out_error)
+{
+	std::string key = get_cache_key(domain_name, resource_type);
+	MutexSection mutex_lock(&mutex);
+	auto it = cache.find(key);
+	if (it == cache.end() || it->second.expire_time <= System::get_time())
+		return false;
+	out_records = it->second.records;
+	out_error = it->second.error;
+	return true;
+}
+
+void DNSResolver_Impl::clear_cache()
+{
+	MutexSection mutex_lock(&mutex);
+	cache.clear();
+}
+
 void DNSResolver_Impl::thread_main()
 {
+	Profiler::set_thread_name("DNSResolver");
 	// Wait for socket to become bound. This will happen when the first query has been sent.
 	int result = Event::wait(event_stop, event_bound);
 	if (result != 1)
 		return;
 
+	Event event_read = udp_socket.get_read_event();
 	while (true)
 	{
-		Event event_read = udp_socket.get_read_event();
-		int result = Event::wait(event_stop, event_read);
-		if (result != 0)
+		event_wakeup.reset();
+		int wait_time = process_timeouts();
+
+		int result = Event::wait(event_stop, event_read, event_wakeup, wait_time);
+		if (result == 0)
+			break;
+		else if (result == 1)
 		{
-			SocketName from;
-			DataBuffer buffer(64*1024);
-			int bytes_read = udp_socket.receive(buffer.get_data(), buffer.get_size(), from);
-			buffer.set_size(bytes_read);
-			try
+			cl_profile_zone("DNSResolver::receive_answers");
+			receive_answers();
+		}
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// DNSResolver_Impl Implementation:
+
+void DNSResolver_Impl::send_lookup_query(const std::shared_ptr<DNSResolver_Lookup> &lookup, const std::vector<SocketName> &servers)
+{
+	DNSPacket packet(
+		0,
+		DNSPacket::opcode_query,
+		true,
+		lookup->domain_name,
+		lookup->question_type,
+		DNSResourceRecord::class_to_int("IN"));
+
+	send_query(packet, servers, lookup->timeout, [this, lookup](const DNSPacket &answer, const std::string &error)
+	{
+		process_lookup_answer(lookup, answer, error);
+	});
+}
+
+void DNSResolver_Impl::process_lookup_answer(const std::shared_ptr<DNSResolver_Lookup> &lookup, const DNSPacket &packet, const std::string &query_error)
+{
+	if (!query_error.empty())
+	{
+		complete_lookup(lookup, std::vector<DNSResourceRecord>(), query_error, 0);
+		return;
+	}
+
+	const std::string &domain_name = lookup->domain_name;
+	const std::string &resource_type = lookup->resource_type;
+	std::vector<DNSResourceRecord> results;
+	std::string error;
+	int ttl = 0;
+	std::string referral_server;
+
+	try
+	{
+		if (packet.is_truncated())
+			throw Exception("Unable to lookup DNS resource; truncated DNS answer packet");
+
+		// The negative answers carry the SOA record of the zone, which tells how long they may be cached (RFC 2308)
+		int negative_ttl = 0;
+		if (packet.get_nameserver_count() > 0)
+		{
+			DNSResourceRecord rr = packet.get_nameserver(0);
+			if (rr.get_type() == "SOA")
+				negative_ttl = std::min(rr.get_ttl(), (int) rr.get_soa_minimum());
+		}
+
+		switch (packet.get_response_code())
+		{
+		case DNSPacket::response_ok:
+			break;
+		case DNSPacket::response_format_error:
+			throw Exception("Unable to lookup DNS resource; format error");
+		case DNSPacket::response_server_failure:
+			throw Exception("Unable to lookup DNS resource; server failure");
+		case DNSPacket::response_name_error:
+			ttl = negative_ttl;
+			throw Exception("Unable to lookup DNS resource; name error");
+		case DNSPacket::response_not_implemented:
+			throw Exception("Unable to lookup DNS resource; not implemented");
+		case DNSPacket::response_refused:
+			throw Exception("Unable to lookup DNS resource; refused");
+		default:
+			throw Exception("Unable to lookup DNS resource; unknown error");
+		}
+
+		// Does this DNS server know the answer?
+		std::string domain_name_cname;
+		int cname_ttl = 0;
+		for (int j = 0; j < packet.get_answer_count() + packet.get_additional_count(); j++)
+		{
+			DNSResourceRecord record = j < packet.get_answer_count() ? packet.get_answer(j) : packet.get_additional(j - packet.get_answer_count());
+
+			if (record.get_name() == domain_name && record.get_type() == "CNAME")
 			{
-				DNSPacket packet(buffer);
-				MutexSection mutex_lock(&mutex);
-				int query_id = packet.get_query_id();
-				auto it = queries.find(query_id);
-				if (it != queries.end())
-					answers[query_id] = packet;
+				domain_name_cname = record.get_cname_cname();
+				cname_ttl = record.get_ttl();
 			}
-			catch (const Exception& e)
+
+			if (record.get_name() == domain_name && record.get_type() == resource_type)
 			{
-				log_event("dns", "Exception during parsing of response dns packet: %1", e.message);
+				ttl = results.empty() ? record.get_ttl() : std::min(ttl, record.get_ttl());
+				results.push_back(record);
 			}
 		}
+
+		// Check for CNAME redirected answers:
+		if (results.empty() && !domain_name_cname.empty())
+		{
+			for (int j = 0; j < packet.get_answer_count() + packet.get_additional_count(); j++)
+			{
+				DNSResourceRecord record = j < packet.get_answer_count() ? packet.get_answer(j) : packet.get_additional(j - packet.get_answer_count());
+				if (record.get_name() == domain_name_cname && record.get_type() == resource_type)
+				{
+					ttl = results.empty() ? std::min(cname_ttl, record.get_ttl()) : std::min(ttl, record.get_ttl());
+					results.push_back(record);
+				}
+			}
+		}
+
+		if (results.empty())
+		{
+			// Does it know someone who does?
+			if (packet.get_nameserver_count() > 0)
+			{
+				DNSResourceRecord rr = packet.get_nameserver(0);
+				if (rr.get_type() == "SOA")
+				{
+					ttl = negative_ttl;
+					throw Exception("DNS resource data not found");
+				}
+				if (rr.get_type() != "NS")
+					throw Exception("Unable to lookup DNS resource");
+				referral_server = rr.get_ns_nsdname();
+			}
+			else
+			{
+				// Looks like this resource does not exist.
+				throw Exception("DNS resource data not found");
+			}
+		}
+	}
+	catch (const Exception &e)
+	{
+		error = e.message;
+	}
+
+	if (!referral_server.empty())
+	{
+		if (++lookup->referrals < max_referrals)
+			send_lookup_query(lookup, std::vector<SocketName>(1, SocketName(referral_server, "53")));
 		else
+			complete_lookup(lookup, std::vector<DNSResourceRecord>(), "Unable to lookup DNS resource; too many referrals", 0);
+	}
+	else
+	{
+		complete_lookup(lookup, results, error, ttl);
+	}
+}
+
+void DNSResolver_Impl::complete_lookup(const std::shared_ptr<DNSResolver_Lookup> &lookup, const std::vector<DNSResourceRecord> &records, const std::string &error, int ttl)
+{
+	MutexSection mutex_lock(&mutex);
+	if (ttl > 0)
+		add_to_cache(lookup->key, records, error, ttl);
+	lookups.erase(lookup->key);
+	std::vector<DNSResolver::LookupCallback> callbacks;
+	callbacks.swap(lookup->callbacks);
+	mutex_lock.unlock();
+
+	for (auto &callback : callbacks)
+	{
+		try
+		{
+			callback(records, error);
+		}
+		catch (const Exception &e)
+		{
+			log_event("dns", "Exception in dns lookup callback: %1", e.message);
+		}
+	}
+}
+
+void DNSResolver_Impl::add_to_cache(const std::string &key, const std::vector<DNSResourceRecord> &records, const std::string &error, int ttl)
+{
+	ubyte64 current_time = System::get_time();
+
+	if (cache.size() >= max_cache_entries)
+	{
+		for (auto it = cache.begin(); it != cache.end();)
+		{
+			if (it->second.expire_time <= current_time)
+				it = cache.erase(it);
+			else
+				++it;
+		}
+	}
+
+	if (cache.size() >= max_cache_entries)
+	{
+		auto oldest = std::min_element(cache.begin(), cache.end(), [](const std::pair<const std::string, DNSResolver_CacheEntry> &a, const std::pair<const std::string, DNSResolver_CacheEntry> &b)
 		{
+			return a.second.expire_time < b.second.expire_time;
+		});
+		cache.erase(oldest);
+	}
+
+	DNSResolver_CacheEntry &entry = cache[key];
+	entry.records = records;
+	entry.error = error;
+	entry.expire_time = current_time + (ubyte64) std::min(ttl, (int) max_cache_ttl) * 1000;
+}
+
+int DNSResolver_Impl::process_timeouts()
+{
+	ubyte64 current_time = System::get_time();
+	std::vector<DNSPacket> resend_packets;
+	std::vector<SocketName> resend_servers;
+	std::vector<DNSResolver_QueryCallback> expired;
+	int wait_time = -1;
+
+	MutexSection mutex_lock(&mutex);
+	for (auto it = queries.begin(); it != queries.end();)
+	{
+		DNSResolver_Query &query = it->second;
+		if (query.timeout_time <= current_time)
+		{
+			expired.push_back(query.callback);
+			it = queries.erase(it);
+			continue;
+		}
+
+		if (query.resend_time <= current_time)
+		{
+			query.server_index = (query.server_index + 1) % query.servers.size();
+			query.resend_time = current_time + resend_interval;
+			resend_packets.push_back(query.packet);
+			resend_servers.push_back(query.servers[query.server_index]);
+		}
+
+		int time_left = (int) (std::min(query.resend_time, query.timeout_time) - current_time);
+		wait_time = (wait_time == -1) ? time_left : std::min(wait_time, time_left);
+		++it;
+	}
+	mutex_lock.unlock();
+
+	for (size_t i = 0; i < resend_packets.size(); i++)
+	{
+		try
+		{
+			udp_socket.send(resend_packets[i].get_data().get_data(), resend_packets[i].get_data().get_size(), resend_servers[i]);
+		}
+		catch (const Exception &e)
+		{
+			log_event("dns", "Unable to resend dns query: %1", e.message);
+		}
+	}
+
+	for (auto &callback : expired)
+		callback(DNSPacket(), "Unable to perform lookup");
+
+	return wait_time;
+}
+
+void DNSResolver_Impl::receive_answers()
+{
+	const int max_packets = 16;
+	const int max_packet_size = 4096;
+	std::vector<unsigned char> buffer(max_packets * max_packet_size);
+	UDPPacket packets[max_packets];
+	for (int i = 0; i < max_packets; i++)
+		packets[i] = UDPPacket(&buffer[i * max_packet_size], 0, max_packet_size);
+
+	while (true)
+	{
+		int received = 0;
+		try
+		{
+			received = udp_socket.receive_batch(packets, max_packets);
+		}
+		catch (const Exception &e)
+		{
+			// An ICMP port unreachable from a DNS server shows up as an error here
+			log_event("dns", "Unable to receive dns packets: %1", e.message);
+		}
+		if (received == 0)
 			break;
+
+		for (int i = 0; i < received; i++)
+		{
+			try
+			{
+				process_answer(DNSPacket(DataBuffer(packets[i].data, packets[i].size)));
+			}
+			catch (const Exception& e)
+			{
+				log_event("dns", "Exception during parsing of response dns packet: %1", e.message);
+			}
 		}
 	}
 }
 
-/////////////////////////////////////////////////////////////////////////////
-// DNSResolver_Impl Implementation:
+void DNSResolver_Impl::process_answer(const DNSPacket &packet)
+{
+	MutexSection mutex_lock(&mutex);
+	auto it = queries.find(packet.get_query_id());
+	if (it == queries.end())
+		return;
+
+	// Ignore answers to other questions, such as a late answer for a query id that has been reused
+	const DNSPacket &query_packet = it->second.packet;
+	if (packet.get_question_count() != 1 ||
+		packet.get_question_type(0) != query_packet.get_question_type(0) ||
+		StringHelp::text_to_lower(packet.get_question_name(0)) != StringHelp::text_to_lower(query_packet.get_question_name(0)))
+		return;
+
+	DNSResolver_QueryCallback callback = it->second.callback;
+	queries.erase(it);
+	mutex_lock.unlock();
+
+	callback(packet, std::string());
+}
+
+int DNSResolver_Impl::create_query_id()
+{
+	// Random ids make it harder to poison the cache with forged answers
+	while (true)
+	{
+		unsigned short query_id;
+		random.get_random_bytes((unsigned char *) &query_id, sizeof(unsigned short));
+		if (queries.find(query_id) == queries.end())
+			return query_id;
+	}
+}
+
+std::string DNSResolver_Impl::get_cache_key(const std::string &domain_name, const std::string &resource_type)
+{
+	return StringHelp::text_to_lower(domain_name) + " " + resource_type;
+}
 
 }
@@ -31,15 +31,55 @@
 #include "API/Core/System/mutex.h"
 #include "API/Core/System/thread.h"
 #include "API/Core/System/event.h"
+#include "API/Core/System/cl_platform.h"
+#include "API/Core/Crypto/random.h"
 #include "API/Network/Socket/socket_name.h"
 #include "API/Network/Socket/udp_socket.h"
 #include "API/Network/Socket/dns_packet.h"
+#include "API/Network/Socket/dns_resource_record.h"
+#include "API/Network/Socket/dns_resolver.h"
 #include <vector>
 #include <map>
+#include <functional>
 
 namespace clan
 {
 
+typedef std::function<void(const DNSPacket &answer, const std::string &error)> DNSResolver_QueryCallback;
+
+/// \brief Query sent to a DNS server that has not been answered yet
+class DNSResolver_Query
+{
+public:
+	DNSPacket packet;
+	std::vector<SocketName> servers;
+	int server_index;
+	ubyte64 resend_time;
+	ubyte64 timeout_time;
+	DNSResolver_QueryCallback callback;
+};
+
+/// \brief Resource lookup in progress, following CNAME and NS referrals
+class DNSResolver_Lookup
+{
+public:
+	std::string key;
+	std::string domain_name;
+	std::string resource_type;
+	int question_type;
+	int timeout;
+	int referrals;
+	std::vector<DNSResolver::LookupCallback> callbacks;
+};
+
+class DNSResolver_CacheEntry
+{
+public:
+	std::vector<DNSResourceRecord> records;
+	std::string error;
+	ubyte64 expire_time;
+};
+
 class DNSResolver_Impl
 {
 /// \name Construction
@@ -56,21 +96,33 @@ public:
 /// \{
 
 public:
-	int query_id;
-
 	std::vector<SocketName> dns_servers;
 
-	std::map<int, DNSPacket> queries;
+	std::map<int, DNSResolver_Query> queries;
+
+	std::map<std::string, std::shared_ptr<DNSResolver_Lookup> > lookups;
 
-	std::map<int, DNSPacket> answers;
+	std::map<std::string, DNSResolver_CacheEntry> cache;
 
 	UDPSocket udp_socket;
 
+	Random random;
+
 	Mutex mutex;
 
 	Thread thread;
 
-	Event event_stop, event_bound;
+	Event event_stop, event_bound, event_wakeup;
+
+	/// \brief Time between resending unanswered queries, rotating through the DNS servers
+	static const int resend_interval = 1000;
+
+	static const int max_referrals = 25;
+
+	static const int max_cache_entries = 4096;
+
+	/// \brief Cached answers are kept for at most a day, even if the server gave a longer time to live
+	static const int max_cache_ttl = 24 * 60 * 60;
 
 
 /// \}
@@ -78,6 +130,11 @@ public:
 /// \{
 
 public:
+	void lookup(const std::string &domain_name, const std::string &resource_type, int timeout, const DNSResolver::LookupCallback &callback);
+	void lookup_addresses(const std::string &domain_name, int timeout, const DNSResolver::AddressesCallback &callback);
+	void send_query(DNSPacket &packet, const std::vector<SocketName> &servers, int timeout, const DNSResolver_QueryCallback &callback);
+	bool find_in_cache(const std::string &domain_name, const std::string &resource_type, std::vector<DNSResourceRecord> &out_records, std::string &out_error);
+	void clear_cache();
 	void thread_main();
 
 
@@ -86,6 +143,15 @@ public:
 /// \{
 
 private:
+	void send_lookup_query(const std::shared_ptr<DNSResolver_Lookup> &lookup, const std::vector<SocketName> &servers);
+	void process_lookup_answer(const std::shared_ptr<DNSResolver_Lookup> &lookup, const DNSPacket &packet, const std::string &query_error);
+	void complete_lookup(const std::shared_ptr<DNSResolver_Lookup> &lookup, const std::vector<DNSResourceRecord> &records, const std::string &error, int ttl);
+	void add_to_cache(const std::string &key, const std::vector<DNSResourceRecord> &records, const std::string &error, int ttl);
+	int process_timeouts();
+	void receive_answers();
+	void process_answer(const DNSPacket &packet);
+	int create_query_id();
+	static std::string get_cache_key(const std::string &domain_name, const std::string &resource_type);
 /// \}
 };
 
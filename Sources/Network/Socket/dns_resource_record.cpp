@@ -231,6 +231,49 @@ std::string DNSResourceRecord::get_a_address_str() const
 	return str_addr;
 }
 
+std::string DNSResourceRecord::get_aaaa_address_str() const
+{
+	if (impl->packet.get_data().get_size() < impl->rdata_offset + 16)
+		throw Exception("Premature end of resource data section");
+	const unsigned char *address = (const unsigned char *) impl->packet.get_data().get_data() + impl->rdata_offset;
+
+	int groups[8];
+	for (int i = 0; i < 8; i++)
+		groups[i] = (address[i * 2] << 8) | address[i * 2 + 1];
+
+	// Replace the longest run of zero groups with :: as described in RFC 5952
+	int zeros_start = -1, zeros_length = 0;
+	for (int i = 0; i < 8;)
+	{
+		int length = 0;
+		while (i + length < 8 && groups[i + length] == 0)
+			length++;
+		if (length > 1 && length > zeros_length)
+		{
+			zeros_start = i;
+			zeros_length = length;
+		}
+		i += length > 0 ? length : 1;
+	}
+
+	std::string str_addr;
+	for (int i = 0; i < 8; i++)
+	{
+		if (i == zeros_start)
+		{
+			str_addr += "::";
+			i += zeros_length - 1;
+			continue;
+		}
+		if (!str_addr.empty() && str_addr[str_addr.length() - 1] != ':')
+			str_addr += ":";
+		char group[8];
+		snprintf(group, 8, "%x", groups[i]);
+		str_addr += group;
+	}
+	return str_addr;
+}
+
 unsigned int DNSResourceRecord::get_wks_address() const
 {
 	if (impl->packet.get_data().get_size() < impl->rdata_offset + 4)
@@ -323,6 +366,7 @@ static RRType rr_types[] =
 	{"MINFO", 14,  "mailbox or mail list information"},
 	{"MX",    15,  "mail exchange"},
 	{"TXT",   16,  "text strings"},
+	{"AAAA",  28,  "an IPv6 host address"},
 	{"AXFR",  252, "qtype: A request for a transfer of an entire zone"},
 	{"MAILB", 253, "qtype: A request for mailbox-related records (MB, MG or MR)"},
 	{"MAILA", 254, "qtype: A request for mail agent RRs (Obsolete - see MX)"},
@@ -29,10 +29,15 @@
 #include "Network/precomp.h"
 #include "iodevice_provider_tcp_connection.h"
 #include "API/Network/Socket/socket_name.h"
+#include "API/Network/Socket/tcp_connection.h"
+#include "API/Core/IOData/file.h"
 #include "API/Core/System/event.h"
 #include "API/Core/Text/string_format.h"
 #include "API/Core/Text/string_help.h"
 #include "API/Core/Text/logger.h"
+#ifndef WIN32
+#include "Core/IOData/iodevice_provider_file.h"
+#endif
 
 namespace clan
 {
@@ -132,7 +137,11 @@ void IODeviceProvider_TCPConnection::disconnect_abortive()
 
 void IODeviceProvider_TCPConnection::disconnect_graceful()
 {
-	socket.disconnect_graceful(timeout);
+	// A graceful close keeps transmitting queued data, which may still reference buffers sent with zero-copy
+	if (socket.wait_zero_copy_completions(timeout))
+		socket.disconnect_graceful(timeout);
+	else
+		socket.disconnect_abortive();
 }
 
 void IODeviceProvider_TCPConnection::set_nodelay(bool enable)
@@ -145,6 +154,11 @@ void IODeviceProvider_TCPConnection::set_keep_alive(bool enable, int timeout, in
 	socket.set_keep_alive(enable, timeout, interval);
 }
 
+bool IODeviceProvider_TCPConnection::set_zero_copy(bool enable)
+{
+	return socket.set_zero_copy(enable);
+}
+
 int IODeviceProvider_TCPConnection::send(const void *data, int len, bool send_all)
 {
 	if (!send_all)
@@ -193,6 +207,128 @@ int IODeviceProvider_TCPConnection::peek(void *data, int len)
 	return socket.peek(data, len);
 }
 
+int IODeviceProvider_TCPConnection::send_vector(const SocketBuffer *buffers, int count, bool send_all)
+{
+	if (!send_all)
+	{
+		return socket.send_vector(buffers, count);
+	}
+
+	// Partial sends leave the remaining buffers in this copy, adjusted to start where the send stopped
+	std::vector<SocketBuffer> remaining(buffers, buffers + count);
+	int pos = 0;
+	int index = 0;
+	while (index < count)
+	{
+		if (remaining[index].size == 0)
+		{
+			index++;
+			continue;
+		}
+
+		if (!write_event.wait(timeout))
+			throw Exception("Send timed out");
+		int sent = socket.send_vector(&remaining[index], count - index);
+		pos += sent;
+
+		while (sent > 0)
+		{
+			int length = std::min(sent, remaining[index].size);
+			remaining[index].data = (char *) remaining[index].data + length;
+			remaining[index].size -= length;
+			sent -= length;
+			if (remaining[index].size == 0)
+				index++;
+		}
+	}
+	return pos;
+}
+
+int IODeviceProvider_TCPConnection::send_zero_copy(const DataBuffer &buffer, bool send_all)
+{
+	if (!send_all)
+		return socket.send_zero_copy(buffer, 0);
+
+	int pos = 0;
+	while (pos < (int) buffer.get_size())
+	{
+		if (!write_event.wait(timeout))
+			throw Exception("Send timed out");
+		pos += socket.send_zero_copy(buffer, pos);
+	}
+	return pos;
+}
+
+int IODeviceProvider_TCPConnection::receive_vector(const SocketBuffer *buffers, int count, bool receive_all)
+{
+	if (!receive_all)
+		return socket.receive_vector(buffers, count);
+
+	std::vector<SocketBuffer> remaining(buffers, buffers + count);
+	int pos = 0;
+	int index = 0;
+	while (index < count)
+	{
+		if (remaining[index].size == 0)
+		{
+			index++;
+			continue;
+		}
+
+		if (!read_event.wait(timeout))
+			throw Exception("Receive timed out");
+		int received = socket.receive_vector(&remaining[index], count - index);
+		if (received == 0)
+			throw Exception("Unable to receive all data: connection closed by peer");
+		pos += received;
+
+		while (received > 0)
+		{
+			int length = std::min(received, remaining[index].size);
+			remaining[index].data = (char *) remaining[index].data + length;
+			remaining[index].size -= length;
+			received -= length;
+			if (remaining[index].size == 0)
+				index++;
+		}
+	}
+	return pos;
+}
+
+int IODeviceProvider_TCPConnection::send_file(File &file, int offset, int length)
+{
+#ifdef WIN32
+	// Read the file through a buffer, restoring the position afterwards
+	int position = file.get_position();
+	file.seek(offset);
+	char buffer[16*1024];
+	int pos = 0;
+	while (pos < length)
+	{
+		int bytes_read = file.read(buffer, std::min(length - pos, (int) sizeof(buffer)), true);
+		if (bytes_read == 0)
+			throw Exception("File is shorter than the requested length");
+		send(buffer, bytes_read, true);
+		pos += bytes_read;
+	}
+	file.seek(position);
+	return pos;
+#else
+	IODeviceProvider_File *file_provider = dynamic_cast<IODeviceProvider_File*>(file.get_provider());
+	if (file_provider == nullptr)
+		throw Exception("File is not open");
+
+	int pos = 0;
+	while (pos < length)
+	{
+		if (!write_event.wait(timeout))
+			throw Exception("Send timed out");
+		pos += socket.send_file(file_provider->get_handle(), offset + pos, length - pos);
+	}
+	return pos;
+#endif
+}
+
 IODeviceProvider *IODeviceProvider_TCPConnection::duplicate()
 {
 	throw Exception("IODeviceProvider_TCPConnection::duplicate() - duplicate not supported for TCP connections.");
@@ -42,7 +42,9 @@ namespace clan
 {
 
 class SocketName;
+class SocketBuffer;
 class Event;
+class File;
 
 class IODeviceProvider_TCPConnection : public IODeviceProvider
 {
@@ -67,6 +69,7 @@ public:
 	SocketName get_remote_name() const;
 	Event get_read_event();
 	Event get_write_event();
+	bool is_zero_copy_enabled() const { return socket.is_zero_copy_enabled(); }
 
 /// \}
 /// \name Operations
@@ -80,9 +83,14 @@ public:
 	void disconnect_abortive();
 	void set_nodelay(bool enable);
 	void set_keep_alive(bool enable, int timeout, int interval);
+	bool set_zero_copy(bool enable);
 	int send(const void *data, int len, bool send_all) override;
 	int receive(void *data, int len, bool receive_all) override;
 	int peek(void *data, int len) override;
+	int send_vector(const SocketBuffer *buffers, int count, bool send_all);
+	int receive_vector(const SocketBuffer *buffers, int count, bool receive_all);
+	int send_file(File &file, int offset, int length);
+	int send_zero_copy(const DataBuffer &buffer, bool send_all);
 	IODeviceProvider *duplicate() override;
 
 /// \}
@@ -90,6 +90,12 @@ Event TCPConnection::get_read_event()
 	return provider->get_read_event();
 }
 
+bool TCPConnection::is_zero_copy_enabled() const
+{
+	const IODeviceProvider_TCPConnection *provider = dynamic_cast<const IODeviceProvider_TCPConnection*>(impl->provider);
+	return provider->is_zero_copy_enabled();
+}
+
 Event TCPConnection::get_write_event()
 {
 	IODeviceProvider_TCPConnection *provider = dynamic_cast<IODeviceProvider_TCPConnection*>(impl->provider);
@@ -141,6 +147,36 @@ void TCPConnection::set_keep_alive(bool enable, int timeout, int interval)
 	provider->set_keep_alive(enable, timeout, interval);
 }
 
+int TCPConnection::send(const SocketBuffer *buffers, int count, bool send_all)
+{
+	IODeviceProvider_TCPConnection *provider = dynamic_cast<IODeviceProvider_TCPConnection*>(impl->provider);
+	return provider->send_vector(buffers, count, send_all);
+}
+
+int TCPConnection::receive(const SocketBuffer *buffers, int count, bool receive_all)
+{
+	IODeviceProvider_TCPConnection *provider = dynamic_cast<IODeviceProvider_TCPConnection*>(impl->provider);
+	return provider->receive_vector(buffers, count, receive_all);
+}
+
+int TCPConnection::send_file(File &file, int offset, int length)
+{
+	IODeviceProvider_TCPConnection *provider = dynamic_cast<IODeviceProvider_TCPConnection*>(impl->provider);
+	return provider->send_file(file, offset, length);
+}
+
+int TCPConnection::send_zero_copy(const DataBuffer &buffer, bool send_all)
+{
+	IODeviceProvider_TCPConnection *provider = dynamic_cast<IODeviceProvider_TCPConnection*>(impl->provider);
+	return provider->send_zero_copy(buffer, send_all);
+}
+
+bool TCPConnection::set_zero_copy(bool enable)
+{
+	IODeviceProvider_TCPConnection *provider = dynamic_cast<IODeviceProvider_TCPConnection*>(impl->provider);
+	return provider->set_zero_copy(enable);
+}
+
 /////////////////////////////////////////////////////////////////////////////
 // TCPConnection Implementation:
 
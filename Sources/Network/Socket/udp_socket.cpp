@@ -31,10 +31,41 @@
 #include "API/Network/Socket/socket_name.h"
 #include "API/Core/System/event.h"
 #include "udp_socket_impl.h"
+#ifndef WIN32
+#include <sys/socket.h>
+#include <netinet/in.h>
+#endif
 
 namespace clan
 {
 
+/////////////////////////////////////////////////////////////////////////////
+// UDPPacket Attributes:
+
+SocketName UDPPacket::get_name() const
+{
+	sockaddr_in addr;
+	memset(&addr, 0, sizeof(sockaddr_in));
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(address);
+	addr.sin_port = htons(port);
+
+	SocketName name;
+	name.from_sockaddr(AF_INET, (sockaddr *) &addr, sizeof(sockaddr_in));
+	return name;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// UDPPacket Operations:
+
+void UDPPacket::set_name(const SocketName &name)
+{
+	sockaddr_in addr;
+	name.to_sockaddr(AF_INET, (sockaddr *) &addr, sizeof(sockaddr_in));
+	address = ntohl(addr.sin_addr.s_addr);
+	port = ntohs(addr.sin_port);
+}
+
 /////////////////////////////////////////////////////////////////////////////
 // UDPSocket Construction:
 
@@ -80,6 +111,11 @@ Event UDPSocket::get_write_event()
 	return impl->get_write_event();
 }
 
+bool UDPSocket::is_segmentation_offload_supported() const
+{
+	return impl->is_segmentation_offload_supported();
+}
+
 /////////////////////////////////////////////////////////////////////////////
 // UDPSocket Operations:
 
@@ -93,6 +129,16 @@ void UDPSocket::set_handle(int socket, bool close_socket)
 	impl->set_handle(socket, close_socket);
 }
 
+bool UDPSocket::set_reuse_port(bool enable)
+{
+	return impl->set_reuse_port(enable);
+}
+
+bool UDPSocket::set_receive_coalescing(bool enable)
+{
+	return impl->set_receive_coalescing(enable);
+}
+
 int UDPSocket::send(const void *data, int len, const SocketName &to)
 {
 	return impl->send(data, len, to);
@@ -108,6 +154,16 @@ int UDPSocket::peek(void *data, int len, SocketName &out_from)
 	return impl->peek(data, len, out_from);
 }
 
+int UDPSocket::send_batch(const UDPPacket *packets, int count)
+{
+	return impl->send_batch(packets, count);
+}
+
+int UDPSocket::receive_batch(UDPPacket *packets, int count)
+{
+	return impl->receive_batch(packets, count);
+}
+
 /////////////////////////////////////////////////////////////////////////////
 // UDPSocket Implementation:
 
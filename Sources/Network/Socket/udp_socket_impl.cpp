@@ -90,7 +90,7 @@ int UDPSocket_Impl::get_handle() const
 
 SocketName UDPSocket_Impl::get_local_name() const
 {
-	return SocketName();
+	return socket.get_local_name();
 }
 
 Event UDPSocket_Impl::get_read_event()
@@ -103,6 +103,11 @@ Event UDPSocket_Impl::get_write_event()
 	return write_event;
 }
 
+bool UDPSocket_Impl::is_segmentation_offload_supported() const
+{
+	return socket.is_segmentation_offload_supported();
+}
+
 /////////////////////////////////////////////////////////////////////////////
 // UDPSocket_Impl Operations:
 
@@ -120,6 +125,16 @@ void UDPSocket_Impl::set_handle(int sock, bool close_sock)
 #endif
 }
 
+bool UDPSocket_Impl::set_reuse_port(bool enable)
+{
+	return socket.set_reuse_port(enable);
+}
+
+bool UDPSocket_Impl::set_receive_coalescing(bool enable)
+{
+	return socket.set_receive_coalescing(enable);
+}
+
 int UDPSocket_Impl::send(const void *data, int len, const SocketName &to)
 {
 	return socket.send_to(data, len, to);
@@ -135,6 +150,16 @@ int UDPSocket_Impl::peek(void *data, int len, SocketName &out_from)
 	return socket.peek_from(data, len, out_from);
 }
 
+int UDPSocket_Impl::send_batch(const UDPPacket *packets, int count)
+{
+	return socket.send_batch(packets, count);
+}
+
+int UDPSocket_Impl::receive_batch(UDPPacket *packets, int count)
+{
+	return socket.receive_batch(packets, count);
+}
+
 /////////////////////////////////////////////////////////////////////////////
 // UDPSocket_Impl Implementation:
 
@@ -44,6 +44,7 @@ namespace clan
 
 class SocketName;
 class Event;
+class UDPPacket;
 
 class UDPSocket_Impl
 {
@@ -66,6 +67,7 @@ public:
 	SocketName get_local_name() const;
 	Event get_read_event();
 	Event get_write_event();
+	bool is_segmentation_offload_supported() const;
 
 
 /// \}
@@ -75,9 +77,13 @@ public:
 public:
 	void bind(const SocketName &local_name, bool force_bind = true);
 	void set_handle(int socket, bool close_socket);
+	bool set_reuse_port(bool enable);
+	bool set_receive_coalescing(bool enable);
 	int send(const void *data, int len, const SocketName &to);
 	int receive(void *data, int len, SocketName &out_from);
 	int peek(void *data, int len, SocketName &out_from);
+	int send_batch(const UDPPacket *packets, int count);
+	int receive_batch(UDPPacket *packets, int count);
 
 
 /// \}
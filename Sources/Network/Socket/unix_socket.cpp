@@ -30,6 +30,11 @@
 #include "unix_socket.h"
 #include "API/Core/Text/string_format.h"
 #include "API/Network/Socket/socket_name.h"
+#include "API/Network/Socket/udp_socket.h"
+#include "API/Network/Socket/tcp_connection.h"
+#include <algorithm>
+#include <limits.h>
+#include <poll.h>
 #include <sys/time.h>
 #include <sys/types.h>
 #include <sys/socket.h>
@@ -43,16 +48,47 @@
 # define SOL_TCP IPPROTO_TCP    // Fix for BSD systems. --NDT
 #endif
 
+#include <sys/uio.h>
+
+#ifdef __linux__
+#include <netinet/udp.h>
+#include <stdint.h>
+#include <sys/sendfile.h>
+#include <linux/errqueue.h>
+#ifndef SOL_UDP
+#define SOL_UDP 17
+#endif
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103	// Older headers lack the segmentation offload options, but the kernel may still support them
+#endif
+#ifndef UDP_GRO
+#define UDP_GRO 104
+#endif
+#ifndef SO_ZEROCOPY
+#define SO_ZEROCOPY 60
+#endif
+#ifndef MSG_ZEROCOPY
+#define MSG_ZEROCOPY 0x4000000
+#endif
+#ifndef SO_EE_ORIGIN_ZEROCOPY
+#define SO_EE_ORIGIN_ZEROCOPY 5
+#endif
+#endif
+
+#ifndef IOV_MAX
+#define IOV_MAX 16
+#endif
+
 namespace clan
 {
 
 UnixSocket::UnixSocket()
-: handle(-1), close_handle_flag(true)
+: handle(-1), close_handle_flag(true), zero_copy(false), zero_copy_sequence(0)
 {
 }
 
 UnixSocket::UnixSocket(int handle)
-: handle(handle), close_handle_flag(true)
+: handle(handle), close_handle_flag(true), zero_copy(false), zero_copy_sequence(0)
 {
 	set_nonblocking();
 }
@@ -67,6 +103,8 @@ void UnixSocket::set_handle(SOCKET new_handle, bool new_close_handle)
 	close_handle();
 	handle = new_handle;
 	close_handle_flag = new_close_handle;
+	zero_copy = false;
+	zero_copy_sequence = 0;
 }
 
 void UnixSocket::create_tcp()
@@ -86,6 +124,7 @@ void UnixSocket::close_handle()
 	if (handle != -1 && close_handle_flag)
 		close(handle);
 	handle = -1;
+	zero_copy_pending.clear();
 }
 
 void UnixSocket::disconnect_graceful(int timeout)
@@ -156,6 +195,53 @@ void UnixSocket::set_keep_alive(bool enable, int timeout, int interval)
 #endif
 }
 
+bool UnixSocket::set_reuse_port(bool enable)
+{
+#ifdef SO_REUSEPORT
+	int value = enable ? 1 : 0;
+	int result = setsockopt(handle, SOL_SOCKET, SO_REUSEPORT, (const char *) &value, sizeof(int));
+	return result == 0;
+#else
+	return false;
+#endif
+}
+
+bool UnixSocket::set_receive_coalescing(bool enable)
+{
+#ifdef __linux__
+	int value = enable ? 1 : 0;
+	int result = setsockopt(handle, SOL_UDP, UDP_GRO, (const char *) &value, sizeof(int));
+	return result == 0;
+#else
+	return false;
+#endif
+}
+
+bool UnixSocket::is_segmentation_offload_supported() const
+{
+#ifdef __linux__
+	int value = 0;
+	socklen_t length = sizeof(int);
+	int result = getsockopt(handle, SOL_UDP, UDP_SEGMENT, (char *) &value, &length);
+	return result == 0;
+#else
+	return false;
+#endif
+}
+
+bool UnixSocket::set_zero_copy(bool enable)
+{
+#ifdef __linux__
+	int value = enable ? 1 : 0;
+	if (setsockopt(handle, SOL_SOCKET, SO_ZEROCOPY, &value, sizeof(int)) == -1)
+		return !enable;
+	zero_copy = enable;
+	return true;
+#else
+	return !enable;
+#endif
+}
+
 void UnixSocket::bind(const SocketName &socketname, bool reuse_address)
 {
 	if (reuse_address)
@@ -248,7 +334,7 @@ int UnixSocket::receive_from(void *data, int size, SocketName &out_socketname)
 	socklen_t addr_size = sizeof(sockaddr_in);
 	int result = ::recvfrom(handle, (char *) data, size, 0, (sockaddr *) &new_addr, &addr_size);
 	throw_if_failed(result);
-	out_socketname.from_sockaddr(AF_INET, (sockaddr *) &new_addr, size);
+	out_socketname.from_sockaddr(AF_INET, (sockaddr *) &new_addr, addr_size);
 	return result;
 }
 
@@ -259,12 +345,13 @@ int UnixSocket::peek_from(void *data, int size, SocketName &out_socketname)
 	socklen_t addr_size = sizeof(sockaddr_in);
 	int result = ::recvfrom(handle, (char *) data, size, MSG_PEEK, (sockaddr *) &new_addr, &addr_size);
 	throw_if_failed(result);
-	out_socketname.from_sockaddr(AF_INET, (sockaddr *) &new_addr, size);
+	out_socketname.from_sockaddr(AF_INET, (sockaddr *) &new_addr, addr_size);
 	return result;
 }
 
 int UnixSocket::send(const void *data, int size)
 {
+	reap_zero_copy_completions();
 	int result = ::send(handle, (const char *) data, size, 0);
 	if (result == -1)
 	{
@@ -307,6 +394,363 @@ int UnixSocket::send_to(const void *data, int size, const SocketName &socketname
 	}
 }
 
+// recvmmsg and sendmmsg move up to this many datagrams per system call
+static const int max_batch_messages = 64;
+
+int UnixSocket::receive_batch(UDPPacket *packets, int count)
+{
+	int received = 0;
+#ifdef __linux__
+	mmsghdr messages[max_batch_messages];
+	iovec buffers[max_batch_messages];
+	sockaddr_in addresses[max_batch_messages];
+	union
+	{
+		cmsghdr header;
+		char buffer[CMSG_SPACE(sizeof(int))];
+	} controls[max_batch_messages];
+
+	while (received < count)
+	{
+		int batch_size = std::min(count - received, max_batch_messages);
+		memset(messages, 0, sizeof(mmsghdr) * batch_size);
+		for (int i = 0; i < batch_size; i++)
+		{
+			buffers[i].iov_base = packets[received + i].data;
+			buffers[i].iov_len = packets[received + i].capacity;
+			messages[i].msg_hdr.msg_name = &addresses[i];
+			messages[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+			messages[i].msg_hdr.msg_iov = &buffers[i];
+			messages[i].msg_hdr.msg_iovlen = 1;
+			messages[i].msg_hdr.msg_control = &controls[i];
+			messages[i].msg_hdr.msg_controllen = sizeof(controls[i]);
+		}
+
+		int result = ::recvmmsg(handle, messages, batch_size, 0, nullptr);
+		if (result == -1)
+		{
+			int errorcode = errno;
+			if (errorcode == EWOULDBLOCK || received > 0)
+				break;
+			throw Exception(error_to_string(errorcode));
+		}
+
+		for (int i = 0; i < result; i++)
+		{
+			UDPPacket &packet = packets[received + i];
+			packet.size = messages[i].msg_len;
+			packet.address = ntohl(addresses[i].sin_addr.s_addr);
+			packet.port = ntohs(addresses[i].sin_port);
+			packet.segment_size = 0;
+			for (cmsghdr *control = CMSG_FIRSTHDR(&messages[i].msg_hdr); control; control = CMSG_NXTHDR(&messages[i].msg_hdr, control))
+			{
+				if (control->cmsg_level == SOL_UDP && control->cmsg_type == UDP_GRO)
+					memcpy(&packet.segment_size, CMSG_DATA(control), sizeof(int));
+			}
+		}
+
+		received += result;
+		if (result < batch_size)
+			break;
+	}
+#else
+	while (received < count)
+	{
+		UDPPacket &packet = packets[received];
+		sockaddr_in addr;
+		memset(&addr, 0, sizeof(sockaddr_in));
+		socklen_t addr_size = sizeof(sockaddr_in);
+		int result = ::recvfrom(handle, (char *) packet.data, packet.capacity, 0, (sockaddr *) &addr, &addr_size);
+		if (result == -1)
+		{
+			int errorcode = errno;
+			if (errorcode == EWOULDBLOCK || received > 0)
+				break;
+			throw Exception(error_to_string(errorcode));
+		}
+
+		packet.size = result;
+		packet.address = ntohl(addr.sin_addr.s_addr);
+		packet.port = ntohs(addr.sin_port);
+		packet.segment_size = 0;
+		received++;
+	}
+#endif
+	return received;
+}
+
+int UnixSocket::send_batch(const UDPPacket *packets, int count)
+{
+	int sent = 0;
+#ifdef __linux__
+	mmsghdr messages[max_batch_messages];
+	iovec buffers[max_batch_messages];
+	sockaddr_in addresses[max_batch_messages];
+	union
+	{
+		cmsghdr header;
+		char buffer[CMSG_SPACE(sizeof(uint16_t))];
+	} controls[max_batch_messages];
+
+	while (sent < count)
+	{
+		int batch_size = std::min(count - sent, max_batch_messages);
+		memset(messages, 0, sizeof(mmsghdr) * batch_size);
+		memset(addresses, 0, sizeof(sockaddr_in) * batch_size);
+		for (int i = 0; i < batch_size; i++)
+		{
+			const UDPPacket &packet = packets[sent + i];
+			addresses[i].sin_family = AF_INET;
+			addresses[i].sin_addr.s_addr = htonl(packet.address);
+			addresses[i].sin_port = htons(packet.port);
+			buffers[i].iov_base = packet.data;
+			buffers[i].iov_len = packet.size;
+			messages[i].msg_hdr.msg_name = &addresses[i];
+			messages[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+			messages[i].msg_hdr.msg_iov = &buffers[i];
+			messages[i].msg_hdr.msg_iovlen = 1;
+
+			if (packet.segment_size > 0)
+			{
+				messages[i].msg_hdr.msg_control = &controls[i];
+				messages[i].msg_hdr.msg_controllen = sizeof(controls[i]);
+				cmsghdr *control = CMSG_FIRSTHDR(&messages[i].msg_hdr);
+				control->cmsg_level = SOL_UDP;
+				control->cmsg_type = UDP_SEGMENT;
+				control->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+				uint16_t segment_size = packet.segment_size;
+				memcpy(CMSG_DATA(control), &segment_size, sizeof(uint16_t));
+			}
+		}
+
+		int result = ::sendmmsg(handle, messages, batch_size, 0);
+		if (result == -1)
+		{
+			int errorcode = errno;
+			if (errorcode == EWOULDBLOCK || sent > 0)
+				break;
+			throw Exception(error_to_string(errorcode));
+		}
+
+		sent += result;
+		if (result < batch_size)
+			break;
+	}
+#else
+	while (sent < count)
+	{
+		const UDPPacket &packet = packets[sent];
+		if (packet.segment_size > 0)
+			throw Exception("UDP segmentation offload is not supported on this platform");
+
+		sockaddr_in addr;
+		memset(&addr, 0, sizeof(sockaddr_in));
+		addr.sin_family = AF_INET;
+		addr.sin_addr.s_addr = htonl(packet.address);
+		addr.sin_port = htons(packet.port);
+		int result = ::sendto(handle, (const char *) packet.data, packet.size, 0, (const sockaddr *) &addr, sizeof(sockaddr_in));
+		if (result == -1)
+		{
+			int errorcode = errno;
+			if (errorcode == EWOULDBLOCK || sent > 0)
+				break;
+			throw Exception(error_to_string(errorcode));
+		}
+		sent++;
+	}
+#endif
+	return sent;
+}
+
+int UnixSocket::receive_vector(const SocketBuffer *buffers, int count)
+{
+	iovec vectors[IOV_MAX];
+	msghdr msg;
+	memset(&msg, 0, sizeof(msghdr));
+	msg.msg_iov = vectors;
+	msg.msg_iovlen = std::min(count, (int) IOV_MAX);
+	for (int i = 0; i < (int) msg.msg_iovlen; i++)
+	{
+		vectors[i].iov_base = buffers[i].data;
+		vectors[i].iov_len = buffers[i].size;
+	}
+
+	int result = ::recvmsg(handle, &msg, 0);
+	throw_if_failed(result);
+	return result;
+}
+
+int UnixSocket::send_vector(const SocketBuffer *buffers, int count)
+{
+	iovec vectors[IOV_MAX];
+	msghdr msg;
+	memset(&msg, 0, sizeof(msghdr));
+	msg.msg_iov = vectors;
+	msg.msg_iovlen = std::min(count, (int) IOV_MAX);
+	for (int i = 0; i < (int) msg.msg_iovlen; i++)
+	{
+		vectors[i].iov_base = buffers[i].data;
+		vectors[i].iov_len = buffers[i].size;
+	}
+
+	reap_zero_copy_completions();
+	int result = ::sendmsg(handle, &msg, 0);
+	if (result == -1)
+	{
+		int errorcode = errno;
+		if (errorcode == EWOULDBLOCK)
+			return 0;
+		throw Exception(error_to_string(errorcode));
+	}
+	return result;
+}
+
+int UnixSocket::send_file(int file_handle, int offset, int length)
+{
+#ifdef __linux__
+	off_t file_offset = offset;
+	ssize_t result = ::sendfile(handle, file_handle, &file_offset, length);
+	if (result == -1)
+	{
+		int errorcode = errno;
+		if (errorcode == EWOULDBLOCK)
+			return 0;
+		if (errorcode != EINVAL && errorcode != ENOSYS)
+			throw Exception(error_to_string(errorcode));
+		// The file system does not support sendfile, so copy through a buffer instead
+	}
+	else
+	{
+		if (result == 0 && length > 0)
+			throw Exception("File is shorter than the requested length");
+		return (int) result;
+	}
+#endif
+
+	char buffer[16*1024];
+	ssize_t bytes_read = ::pread(file_handle, buffer, std::min(length, (int) sizeof(buffer)), offset);
+	if (bytes_read == -1)
+		throw Exception(error_to_string(errno));
+	if (bytes_read == 0 && length > 0)
+		throw Exception("File is shorter than the requested length");
+	return send(buffer, (int) bytes_read);
+}
+
+int UnixSocket::send_zero_copy(const DataBuffer &buffer, int offset)
+{
+	reap_zero_copy_completions();
+
+	const char *data = buffer.get_data() + offset;
+	int size = (int) buffer.get_size() - offset;
+
+	int result;
+#ifdef __linux__
+	// Pinning the pages only pays off for large sends
+	const int zero_copy_threshold = 16*1024;
+	if (zero_copy && size >= zero_copy_threshold)
+	{
+		result = ::send(handle, data, size, MSG_ZEROCOPY);
+		if (result > 0)
+		{
+			// The kernel numbers each zero-copy send, and the buffer must stay alive until it reports that number as completed
+			ZeroCopyBuffer pending;
+			pending.sequence = zero_copy_sequence++;
+			pending.buffer = buffer;
+			pending.released = false;
+			zero_copy_pending.push_back(pending);
+		}
+		else if (result == -1 && errno == ENOBUFS)
+		{
+			result = ::send(handle, data, size, 0);	// Out of memory for pinning pages, copy instead
+		}
+	}
+	else
+	{
+		result = ::send(handle, data, size, 0);
+	}
+#else
+	result = ::send(handle, data, size, 0);
+#endif
+
+	if (result == -1)
+	{
+		int errorcode = errno;
+		if (errorcode == EWOULDBLOCK)
+			return 0;
+		throw Exception(error_to_string(errorcode));
+	}
+	return result;
+}
+
+bool UnixSocket::wait_zero_copy_completions(int timeout)
+{
+	reap_zero_copy_completions();
+	while (!zero_copy_pending.empty())
+	{
+		// Completions are queued on the socket error queue, which poll always reports as POLLERR
+		pollfd fd;
+		fd.fd = handle;
+		fd.events = 0;
+		fd.revents = 0;
+		int result = ::poll(&fd, 1, timeout);
+		throw_if_failed(result);
+		if (result == 0)
+			return false;
+
+		size_t pending = zero_copy_pending.size();
+		reap_zero_copy_completions();
+		if (pending == zero_copy_pending.size())
+		{
+			int error = 0;
+			socklen_t length = sizeof(int);
+			getsockopt(handle, SOL_SOCKET, SO_ERROR, (char *) &error, &length);
+			if (error != 0)
+				throw Exception(error_to_string(error));
+		}
+	}
+	return true;
+}
+
+void UnixSocket::reap_zero_copy_completions()
+{
+#ifdef __linux__
+	while (!zero_copy_pending.empty())
+	{
+		char control[128];
+		msghdr msg;
+		memset(&msg, 0, sizeof(msghdr));
+		msg.msg_control = control;
+		msg.msg_controllen = sizeof(control);
+		if (::recvmsg(handle, &msg, MSG_ERRQUEUE) == -1)
+			break;
+
+		for (cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg))
+		{
+			if ((cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR) || (cmsg->cmsg_level == SOL_IPV6 && cmsg->cmsg_type == IPV6_RECVERR))
+			{
+				// Each notification covers the range of sends numbered ee_info to ee_data
+				const sock_extended_err *err = (const sock_extended_err *) CMSG_DATA(cmsg);
+				if (err->ee_origin == SO_EE_ORIGIN_ZEROCOPY)
+					release_zero_copy_range(err->ee_info, err->ee_data);
+			}
+		}
+
+		// Notifications can arrive out of order, so only drop buffers from the front once all before them are released
+		while (!zero_copy_pending.empty() && zero_copy_pending.front().released)
+			zero_copy_pending.pop_front();
+	}
+#endif
+}
+
+void UnixSocket::release_zero_copy_range(unsigned int first, unsigned int last)
+{
+	for (auto &pending : zero_copy_pending)
+	{
+		if (pending.sequence - first <= last - first)
+			pending.released = true;
+	}
+}
+
 void UnixSocket::close_send()
 {
 	shutdown(handle, SHUT_WR);
@@ -28,6 +28,9 @@
 
 #pragma once
 
+#include "API/Core/System/databuffer.h"
+#include <deque>
+
 #ifndef SOCKET
 typedef int SOCKET;
 #endif
@@ -36,6 +39,8 @@ namespace clan
 {
 
 class SocketName;
+class UDPPacket;
+class SocketBuffer;
 
 class UnixSocket
 {
@@ -55,6 +60,12 @@ public:
 	void set_nodelay(bool enable);
 	void set_keep_alive(bool enable, int timeout, int interval);
 
+	bool set_reuse_port(bool enable);
+	bool set_receive_coalescing(bool enable);
+	bool is_segmentation_offload_supported() const;
+	bool set_zero_copy(bool enable);
+	bool is_zero_copy_enabled() const { return zero_copy; }
+
 	void bind(const SocketName &socketname, bool reuse_address);
 
 	void listen(int backlog);
@@ -70,16 +81,27 @@ public:
 	int send(const void *data, int size);
 	void close_send();
 
+	int receive_vector(const SocketBuffer *buffers, int count);
+	int send_vector(const SocketBuffer *buffers, int count);
+	int send_file(int file_handle, int offset, int length);
+	int send_zero_copy(const DataBuffer &buffer, int offset);
+	bool wait_zero_copy_completions(int timeout);
+
 	int receive_from(void *data, int size, SocketName &out_socketname);
 	int peek_from(void *data, int size, SocketName &out_socketname);
 	int send_to(const void *data, int size, const SocketName &socketname);
 
+	int receive_batch(UDPPacket *packets, int count);
+	int send_batch(const UDPPacket *packets, int count);
+
 	int get_handle() const { return handle; }
 
 private:
 	void create_socket_handle(int type);
 	void close_handle();
 	void set_nonblocking();
+	void reap_zero_copy_completions();
+	void release_zero_copy_range(unsigned int first, unsigned int last);
 
 	void throw_if_invalid(int result) const;
 	void throw_if_failed(int result) const;
@@ -88,6 +110,17 @@ private:
 
 	int handle;
 	bool close_handle_flag;
+
+	struct ZeroCopyBuffer
+	{
+		unsigned int sequence;
+		DataBuffer buffer;
+		bool released;
+	};
+
+	bool zero_copy;
+	unsigned int zero_copy_sequence;
+	std::deque<ZeroCopyBuffer> zero_copy_pending;
 };
 
 }
@@ -30,6 +30,8 @@
 #include "win32_socket.h"
 #include "API/Core/Text/string_format.h"
 #include "API/Network/Socket/socket_name.h"
+#include "API/Network/Socket/udp_socket.h"
+#include "API/Network/Socket/tcp_connection.h"
 #include <in6addr.h>
 #include <mstcpip.h>
 
@@ -176,6 +178,27 @@ void Win32Socket::set_keep_alive(bool enable, int timeout, int interval)
 	}
 }
 
+bool Win32Socket::set_reuse_port(bool enable)
+{
+	// SO_REUSEADDR on Windows lets another socket steal the port instead of sharing the load
+	return false;
+}
+
+bool Win32Socket::set_receive_coalescing(bool enable)
+{
+	return false;
+}
+
+bool Win32Socket::is_segmentation_offload_supported() const
+{
+	return false;
+}
+
+bool Win32Socket::set_zero_copy(bool enable)
+{
+	return !enable;
+}
+
 void Win32Socket::bind(const SocketName &socketname, bool reuse_address)
 {
 	if (reuse_address)
@@ -263,7 +286,7 @@ int Win32Socket::receive_from(void *data, int size, SocketName &out_socketname)
 	int addr_size = sizeof(sockaddr_in);
 	int result = ::recvfrom(handle, (char *) data, size, 0, (sockaddr *) &new_addr, &addr_size);
 	throw_if_failed(result);
-	out_socketname.from_sockaddr(AF_INET, (sockaddr *) &new_addr, size);
+	out_socketname.from_sockaddr(AF_INET, (sockaddr *) &new_addr, addr_size);
 	reset_receive();
 	return result;
 }
@@ -283,7 +306,7 @@ int Win32Socket::peek_from(void *data, int size, SocketName &out_socketname)
 	int addr_size = sizeof(sockaddr_in);
 	int result = ::recvfrom(handle, (char *) data, size, MSG_PEEK, (sockaddr *) &new_addr, &addr_size);
 	throw_if_failed(result);
-	out_socketname.from_sockaddr(AF_INET, (sockaddr *) &new_addr, size);
+	out_socketname.from_sockaddr(AF_INET, (sockaddr *) &new_addr, addr_size);
 	reset_receive();
 	return result;
 }
@@ -334,6 +357,112 @@ int Win32Socket::send_to(const void *data, int size, const SocketName &socketnam
 	}
 }
 
+int Win32Socket::receive_batch(UDPPacket *packets, int count)
+{
+	int received = 0;
+	while (received < count)
+	{
+		UDPPacket &packet = packets[received];
+		sockaddr_in addr;
+		memset(&addr, 0, sizeof(sockaddr_in));
+		int addr_size = sizeof(sockaddr_in);
+		int result = ::recvfrom(handle, (char *) packet.data, packet.capacity, 0, (sockaddr *) &addr, &addr_size);
+		if (result == SOCKET_ERROR)
+		{
+			int errorcode = WSAGetLastError();
+			if (errorcode == WSAEWOULDBLOCK || received > 0)
+				break;
+			throw Exception(error_to_string(errorcode));
+		}
+
+		packet.size = result;
+		packet.address = ntohl(addr.sin_addr.s_addr);
+		packet.port = ntohs(addr.sin_port);
+		packet.segment_size = 0;
+		received++;
+	}
+	reset_receive();
+	return received;
+}
+
+int Win32Socket::send_batch(const UDPPacket *packets, int count)
+{
+	int sent = 0;
+	while (sent < count)
+	{
+		const UDPPacket &packet = packets[sent];
+		if (packet.segment_size > 0)
+			throw Exception("UDP segmentation offload is not supported on this platform");
+
+		sockaddr_in addr;
+		memset(&addr, 0, sizeof(sockaddr_in));
+		addr.sin_family = AF_INET;
+		addr.sin_addr.s_addr = htonl(packet.address);
+		addr.sin_port = htons(packet.port);
+		int result = ::sendto(handle, (const char *) packet.data, packet.size, 0, (const sockaddr *) &addr, sizeof(sockaddr_in));
+		if (result == SOCKET_ERROR)
+		{
+			int errorcode = WSAGetLastError();
+			if (errorcode == WSAEWOULDBLOCK)
+			{
+				reset_send();
+				break;
+			}
+			if (sent > 0)
+				break;
+			throw Exception(error_to_string(errorcode));
+		}
+		sent++;
+	}
+	return sent;
+}
+
+int Win32Socket::receive_vector(const SocketBuffer *buffers, int count)
+{
+	const int max_buffers = 64;
+	WSABUF wsa_buffers[max_buffers];
+	if (count > max_buffers)
+		count = max_buffers;
+	for (int i = 0; i < count; i++)
+	{
+		wsa_buffers[i].buf = (char *) buffers[i].data;
+		wsa_buffers[i].len = buffers[i].size;
+	}
+
+	DWORD bytes_received = 0, flags = 0;
+	int result = WSARecv(handle, wsa_buffers, count, &bytes_received, &flags, 0, 0);
+	throw_if_failed(result);
+	reset_receive();
+	return bytes_received;
+}
+
+int Win32Socket::send_vector(const SocketBuffer *buffers, int count)
+{
+	const int max_buffers = 64;
+	WSABUF wsa_buffers[max_buffers];
+	if (count > max_buffers)
+		count = max_buffers;
+	for (int i = 0; i < count; i++)
+	{
+		wsa_buffers[i].buf = (char *) buffers[i].data;
+		wsa_buffers[i].len = buffers[i].size;
+	}
+
+	DWORD bytes_sent = 0;
+	int result = WSASend(handle, wsa_buffers, count, &bytes_sent, 0, 0, 0);
+	if (result == SOCKET_ERROR)
+	{
+		int errorcode = WSAGetLastError();
+		if (errorcode == WSAEWOULDBLOCK)
+		{
+			reset_send();
+			return 0;
+		}
+		throw Exception(error_to_string(errorcode));
+	}
+	return bytes_sent;
+}
+
 void Win32Socket::close_send()
 {
 	shutdown(handle, SD_SEND);
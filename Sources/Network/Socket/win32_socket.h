@@ -28,10 +28,14 @@
 
 #pragma once
 
+#include "API/Core/System/databuffer.h"
+
 namespace clan
 {
 
 class SocketName;
+class UDPPacket;
+class SocketBuffer;
 
 class Win32Socket
 {
@@ -51,6 +55,12 @@ public:
 	void set_nodelay(bool enable);
 	void set_keep_alive(bool enable, int timeout, int interval);
 
+	bool set_reuse_port(bool enable);
+	bool set_receive_coalescing(bool enable);
+	bool is_segmentation_offload_supported() const;
+	bool set_zero_copy(bool enable);
+	bool is_zero_copy_enabled() const { return false; }
+
 	void bind(const SocketName &socketname, bool reuse_address);
 
 	void listen(int backlog);
@@ -66,10 +76,18 @@ public:
 	int send(const void *data, int size);
 	void close_send();
 
+	int receive_vector(const SocketBuffer *buffers, int count);
+	int send_vector(const SocketBuffer *buffers, int count);
+	int send_zero_copy(const DataBuffer &buffer, int offset) { return send(buffer.get_data() + offset, (int) buffer.get_size() - offset); }
+	bool wait_zero_copy_completions(int timeout) { return true; }
+
 	int receive_from(void *data, int size, SocketName &out_socketname);
 	int peek_from(void *data, int size, SocketName &out_socketname);
 	int send_to(const void *data, int size, const SocketName &socketname);
 
+	int receive_batch(UDPPacket *packets, int count);
+	int send_batch(const UDPPacket *packets, int count);
+
 	HANDLE get_event_handle() const { return event_handle; }
 	void process_events();
 
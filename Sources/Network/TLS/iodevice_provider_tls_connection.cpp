@@ -42,7 +42,7 @@ namespace clan
 // IODeviceProvider_TLSConnection Construction:
 
 IODeviceProvider_TLSConnection::IODeviceProvider_TLSConnection()
-	: read_buffer(16*1024), read_buffer_pos(0)
+	: read_buffer(64*1024), eof(false), timeout(15000)
 {
 }
 	
@@ -60,7 +60,17 @@ IODeviceProvider_TLSConnection::~IODeviceProvider_TLSConnection()
 void IODeviceProvider_TLSConnection::connect(TCPConnection &device)
 {
 	connected_device = device;
-	read_buffer_pos = 0;
+	read_buffer = RingBuffer(64*1024);
+	eof = false;
+
+	// Reconnecting to the same server resumes the previous TLS session
+	SocketName remote_name = device.get_remote_name();
+	tls_client = TLSClient();
+	tls_client.enable_session_resumption(remote_name.get_address() + ":" + remote_name.get_port());
+
+	// Send the client hello right away, so the handshake overlaps with whatever the caller does next
+	tls_client.encrypt(nullptr, 0);
+	update_io_buffers();
 }
 
 void IODeviceProvider_TLSConnection::disconnect()
@@ -72,37 +82,56 @@ void IODeviceProvider_TLSConnection::disconnect()
 int IODeviceProvider_TLSConnection::send(const void *data, int len, bool send_all)
 {
 	int pos = 0;
-	do
+	while (true)
 	{
-		update_io_buffers(send_all);
-
+		// TLSClient encrypts as many records as its send buffer holds, and they are then written with one call
 		pos += tls_client.encrypt(static_cast<const char*>(data) + pos, len - pos);
-
-		update_io_buffers(send_all);
-
-	} while (send_all && pos != len);
-	return pos;
+		bool progress = update_io_buffers();
+
+		if (pos == len && tls_client.get_encrypted_data_available() == 0)
+			return pos;
+		if (!send_all)
+			return pos;
+		if (!progress)
+			wait_for_io();
+	}
 }
 
 int IODeviceProvider_TLSConnection::receive(void *data, int len, bool receive_all)
 {
 	int pos = 0;
-	do
+	while (true)
 	{
-		update_io_buffers(receive_all);
-
-		int bytes_available = clan::min(tls_client.get_decrypted_data_available(), len);
-		memcpy(static_cast<char*>(data) + pos, tls_client.get_decrypted_data(), bytes_available);
-
-		update_io_buffers(receive_all);
-
-	} while (receive_all && pos != len);
-	return pos;
+		int bytes_available = clan::min(tls_client.get_decrypted_data_available(), len - pos);
+		if (bytes_available)
+		{
+			memcpy(static_cast<char*>(data) + pos, tls_client.get_decrypted_data(), bytes_available);
+			tls_client.decrypted_data_consumed(bytes_available);
+			pos += bytes_available;
+		}
+
+		if (pos == len || (pos > 0 && !receive_all))
+			return pos;
+
+		if (!update_io_buffers() && tls_client.get_decrypted_data_available() == 0)
+		{
+			if (eof)
+			{
+				if (receive_all)
+					throw Exception("Unable to receive all data: connection closed by peer");
+				return pos;
+			}
+			wait_for_io();
+		}
+	}
 }
 
 int IODeviceProvider_TLSConnection::peek(void *data, int len)
 {
-	throw Exception("Not implemented");
+	update_io_buffers();
+	int bytes_available = clan::min(tls_client.get_decrypted_data_available(), len);
+	memcpy(data, tls_client.get_decrypted_data(), bytes_available);
+	return bytes_available;
 }
 
 IODeviceProvider *IODeviceProvider_TLSConnection::duplicate()
@@ -113,28 +142,56 @@ IODeviceProvider *IODeviceProvider_TLSConnection::duplicate()
 /////////////////////////////////////////////////////////////////////////////
 // IODeviceProvider_TLSConnection Implementation:
 
-void IODeviceProvider_TLSConnection::update_io_buffers(bool wait)
+bool IODeviceProvider_TLSConnection::update_io_buffers()
 {
-	// Pass on any encrypted data ready to be sent:
-	if (tls_client.get_encrypted_data_available() != 0)
+	bool progress = false;
+
+	// Pass on all encrypted data ready to be sent:
+	while (tls_client.get_encrypted_data_available() != 0)
 	{
-		int written = connected_device.write(tls_client.get_encrypted_data(), tls_client.get_encrypted_data_available(), wait);
+		int written = connected_device.write(tls_client.get_encrypted_data(), tls_client.get_encrypted_data_available(), false);
+		if (written == 0)
+			break;
 		tls_client.encrypted_data_consumed(written);
+		progress = true;
 	}
 
-	// Read incoming data:
-	if (read_buffer_pos != read_buffer.get_size())
+	// Read ahead as far as the ring buffer allows:
+	while (!eof && read_buffer.get_write_size() != 0 && connected_device.get_read_event().wait(0))
 	{
-		read_buffer_pos += connected_device.read(read_buffer.get_data() + read_buffer_pos, read_buffer.get_size() - read_buffer_pos, false);
+		int received = connected_device.read(read_buffer.get_write_pos(), read_buffer.get_write_size(), false);
+		if (received == 0)
+			eof = true;
+		else
+			read_buffer.write(received);
+		progress = true;
 	}
 
-	// Pass any available incoming data to TLSClient for decryption:
-	if (read_buffer_pos != 0)
+	// Pass the incoming data to TLSClient for decryption:
+	while (read_buffer.get_read_size() != 0)
 	{
-		int tcp_bytes_read = tls_client.decrypt(read_buffer.get_data(), read_buffer_pos);
-		memmove(read_buffer.get_data(), read_buffer.get_data() + tcp_bytes_read, read_buffer_pos - tcp_bytes_read);
-		read_buffer_pos = 0;
+		int tcp_bytes_read = tls_client.decrypt(read_buffer.get_read_pos(), read_buffer.get_read_size());
+		if (tcp_bytes_read == 0)
+			break;
+		read_buffer.read(tcp_bytes_read);
+		progress = true;
 	}
+
+	return progress;
+}
+
+void IODeviceProvider_TLSConnection::wait_for_io()
+{
+	std::vector<Event> events;
+	if (!eof && read_buffer.get_write_size() != 0)
+		events.push_back(connected_device.get_read_event());
+	if (tls_client.get_encrypted_data_available() != 0)
+		events.push_back(connected_device.get_write_event());
+
+	if (events.empty())
+		throw Exception("TLS connection stalled: the received data is not being read");
+	if (Event::wait(events, timeout) < 0)
+		throw Exception("TLS connection timed out");
 }
 
 }
@@ -35,6 +35,7 @@
 #include "API/Core/IOData/iodevice.h"
 #include "API/Core/IOData/iodevice_provider.h"
 #include "API/Core/Crypto/tls_client.h"
+#include "Network/Web/ring_buffer.h"
 
 namespace clan
 {
@@ -67,13 +68,15 @@ public:
 /// \name Implementation
 /// \{
 private:
-	void update_io_buffers(bool wait);
+	bool update_io_buffers();
+	void wait_for_io();
 
 	TCPConnection connected_device;
 	TLSClient tls_client;
 
-	DataBuffer read_buffer;
-	int read_buffer_pos;
+	RingBuffer read_buffer;
+	bool eof;
+	int timeout;
 /// \}
 };
 
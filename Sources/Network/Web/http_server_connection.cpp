@@ -270,8 +270,8 @@ void HTTPServerConnection::write_response_headers(const std::string &headers)
 			else if (name == "Vary")
 				vary_line = true;
 
-			impl->connection.write(line.data(), line.length(), true);
-			impl->connection.write("\r\n", 2, true);
+			SocketBuffer buffers[2] = { SocketBuffer(line.data(), line.length()), SocketBuffer("\r\n", 2) };
+			impl->connection.send(buffers, 2, true);
 		}
 	}
 
@@ -297,24 +297,27 @@ void HTTPServerConnection::write_response_data(const DataBuffer &data)
 		throw Exception("Cannot write reponse data if manual writing has been performed first.");
 	if (!impl->writing_header)
 		write_response_headers(std::string());
+	if (impl->written_content_length >= 0 && data.get_size() != impl->written_content_length)
+		throw Exception("HTTP Content-Length in header does not match response data size!");
+
+	// Send the end of the header and the data with one system call:
+	std::string length;
+	SocketBuffer buffers[3];
+	int count = 0;
 	if (impl->writing_header)
 	{
 		if (impl->written_content_length == -1)
 		{
-			std::string length;
 			length.append("Content-Length: ");
 			length.append(StringHelp::int_to_local8(data.get_size()));
 			length.append("\r\n");
-			impl->connection.write(length.data(), length.length(), true);
+			buffers[count++] = SocketBuffer(length.data(), length.length());
 		}
-		impl->connection.write("\r\n", 2, true);
+		buffers[count++] = SocketBuffer("\r\n", 2);
 	}
 	impl->writing_header = false;
-	if (impl->written_content_length >= 0 && data.get_size() != impl->written_content_length)
-		throw Exception("HTTP Content-Length in header does not match response data size!");
-
-	// Header should be ok.  Write the actual data:
-	impl->connection.write(data.get_data(), data.get_size(), true);
+	buffers[count++] = SocketBuffer(data.get_data(), data.get_size());
+	impl->connection.send(buffers, count, true);
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -31,6 +31,7 @@
 #include "API/Core/Text/string_help.h"
 #include "API/Core/Text/string_format.h"
 #include "API/Core/Text/logger.h"
+#include "API/Core/System/profiler.h"
 #include "API/Network/Web/http_server_connection.h"
 #include "http_server_impl.h"
 #include "http_server_connection_impl.h"
@@ -60,8 +61,8 @@ HTTPServer_Impl::~HTTPServer_Impl()
 
 void HTTPServer_Impl::write_line(TCPConnection &connection, const std::string &line)
 {
-	connection.send(line.data(), line.length(), true);
-	connection.send("\r\n", 2, true);
+	SocketBuffer buffers[2] = { SocketBuffer(line.data(), line.length()), SocketBuffer("\r\n", 2) };
+	connection.send(buffers, 2, true);
 }
 
 bool HTTPServer_Impl::read_line(TCPConnection &connection, std::string &out_line)
@@ -126,6 +127,7 @@ bool HTTPServer_Impl::read_lines(TCPConnection &connection, std::string &out_hea
 
 void HTTPServer_Impl::accept_thread_main()
 {
+	Profiler::set_thread_name("HTTPServer accept");
 	while (true)
 	{
 		MutexSection mutex_lock(&mutex);
@@ -157,6 +159,8 @@ void HTTPServer_Impl::accept_thread_main()
 
 void HTTPServer_Impl::connection_thread_main(TCPConnection connection)
 {
+	Profiler::set_thread_name("HTTPServer connection");
+	cl_profile_zone("HTTPServer connection");
 	try
 	{
 		std::string request;
@@ -51,12 +51,15 @@ char *RingBuffer::get_write_pos()
 
 size_t RingBuffer::get_write_size()
 {
+	if (length == size)
+		return 0;
+
 	size_t end_pos = pos + length;
 	if (end_pos >= size)
 		end_pos -= size;
 
-	if (pos < end_pos)
-		return end_pos - pos;
+	if (end_pos < pos)
+		return pos - end_pos;
 	else
 		return size - end_pos;
 }
@@ -54,12 +54,11 @@ inline void WebResponse_Impl::send_request(TCPConnection &connection)
 		request_header += string_format("%1: %2\r\n", elem.first, elem.second);
 	request_header += "\r\n";
 
-	connection.send(request_header.data(), request_header.length(), true);
-	connection.set_nodelay(true);
+	SocketBuffer buffers[2] = { SocketBuffer(request_header.data(), request_header.length()), SocketBuffer() };
 	if (!request->body.is_null())
-		connection.send(request->body.get_data(), request->body.get_size(), true);
-	else
-		connection.send(nullptr, 0);
+		buffers[1] = SocketBuffer(request->body.get_data(), request->body.get_size());
+	connection.set_nodelay(true);
+	connection.send(buffers, 2, true);
 }
 
 inline void WebResponse_Impl::read_response(TCPConnection &connection)
@@ -2,6 +2,8 @@
 #include "Sound/precomp.h"
 #include "API/Sound/AudioWorld/audio_object.h"
 #include "API/Sound/AudioWorld/audio_world.h"
+#include "API/Sound/SoundProviders/soundprovider.h"
+#include "API/Sound/SoundProviders/soundprovider_session.h"
 #include "audio_object_impl.h"
 #include "audio_world_impl.h"
 
@@ -59,7 +61,22 @@ bool AudioObject::is_ambience() const
 
 bool AudioObject::is_playing() const
 {
-	return impl && !impl->session.is_null() && impl->session.is_playing();
+	if (!impl || !impl->playing)
+		return false;
+	else if (impl->virtual_voice)
+		return true;
+	else
+		return !impl->session.is_null() && impl->session.is_playing();
+}
+
+bool AudioObject::is_virtual() const
+{
+	return impl && impl->playing && impl->virtual_voice;
+}
+
+float AudioObject::get_priority() const
+{
+	return impl->priority;
 }
 
 void AudioObject::set_position(const Vec3f &position)
@@ -82,14 +99,21 @@ void AudioObject::set_volume(float volume)
 	impl->volume = volume;
 }
 
+void AudioObject::set_priority(float priority)
+{
+	impl->priority = priority;
+}
+
 void AudioObject::set_sound(const SoundBuffer &buffer)
 {
 	impl->sound = buffer;
+	impl->sound_length = -1;
 }
 
 void AudioObject::set_sound(const std::string &id)
 {
 	impl->sound = SoundBuffer::resource(id, impl->world->resources);
+	impl->sound_length = -1;
 }
 
 void AudioObject::set_looping(bool loop)
@@ -106,10 +130,33 @@ void AudioObject::play()
 {
 	if (!impl->ambience || impl->world->play_ambience)
 	{
-		impl->session = impl->sound.prepare(impl->looping);
-		impl->world->update_session(impl.get());
-		impl->session.play();
-		impl->world->active_objects.push_back(*this);
+		stop();
+
+		impl->playing = true;
+		impl->virtual_position = 0.0;
+		impl->world->calculate_volume(impl.get());
+
+		// Start as a virtual voice if it cannot be heard or the budget is used up; the next update may promote it
+		if (impl->current_volume * impl->priority < impl->world->audibility_threshold || impl->world->num_real_voices >= impl->world->max_real_voices)
+		{
+			impl->virtual_voice = true;
+			impl->update_sound_info();
+		}
+		else
+		{
+			impl->virtual_voice = false;
+			impl->session = impl->sound.prepare(impl->looping);
+			impl->world->update_session(impl.get());
+			impl->session.play();
+			impl->world->num_real_voices++;
+		}
+
+		// Restarting an object that is still in the active list keeps its place there
+		if (!impl->in_active_list)
+		{
+			impl->in_active_list = true;
+			impl->world->active_objects.push_back(*this);
+		}
 	}
 }
 
@@ -119,13 +166,20 @@ void AudioObject::stop()
 	{
 		impl->session.stop();
 		impl->session = SoundBuffer_Session();
+		impl->world->num_real_voices--;
+	}
+	if (impl)
+	{
+		impl->playing = false;
+		impl->virtual_voice = false;
 	}
 }
 
 /////////////////////////////////////////////////////////////////////////////
 
 AudioObject_Impl::AudioObject_Impl(AudioWorld_Impl *world)
-: world(world), attenuation_begin(0.0f), attenuation_end(0.0f), volume(1.0f), looping(false), ambience(false)
+: world(world), attenuation_begin(0.0f), attenuation_end(0.0f), volume(1.0f), looping(false), ambience(false), priority(1.0f),
+  playing(false), in_active_list(false), virtual_voice(false), wants_real_voice(false), virtual_position(0.0), sound_length(-1), sound_frequency(0), current_volume(0.0f), current_pan(0.0f)
 {
 	it = world->objects.insert(world->objects.end(), this);
 }
@@ -134,3 +188,23 @@ AudioObject_Impl::~AudioObject_Impl()
 {
 	world->objects.erase(it);
 }
+
+void AudioObject_Impl::update_sound_info()
+{
+	if (sound_length != -1)
+		return;
+
+	if (!session.is_null())
+	{
+		sound_length = session.get_length();
+		sound_frequency = session.get_frequency();
+	}
+	else
+	{
+		SoundProvider *provider = sound.get_provider();
+		SoundProvider_Session *provider_session = provider->begin_session();
+		sound_length = provider_session->get_num_samples();
+		sound_frequency = provider_session->get_frequency();
+		provider->end_session(provider_session);
+	}
+}
@@ -44,6 +44,8 @@ public:
 	AudioObject_Impl(AudioWorld_Impl *world);
 	~AudioObject_Impl();
 
+	void update_sound_info();
+
 	AudioWorld_Impl *world;
 	std::list<AudioObject_Impl *>::iterator it;
 
@@ -53,8 +55,20 @@ public:
 	float volume;
 	bool looping;
 	bool ambience;
+	float priority;
 	SoundBuffer sound;
 	SoundBuffer_Session session;
+
+	bool playing;
+	bool in_active_list;
+	bool virtual_voice;
+	bool wants_real_voice;
+	double virtual_position;
+	int sound_length;
+	int sound_frequency;
+
+	float current_volume;
+	float current_pan;
 };
 
 }
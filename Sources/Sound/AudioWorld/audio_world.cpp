@@ -4,8 +4,11 @@
 #include "API/Sound/AudioWorld/audio_object.h"
 #include "API/Sound/soundbuffer.h"
 #include "API/Core/Math/cl_math.h"
+#include "API/Core/System/system.h"
 #include "audio_world_impl.h"
 #include "audio_object_impl.h"
+#include <algorithm>
+#include <cmath>
 
 namespace clan
 {
@@ -19,6 +22,7 @@ void AudioWorld::set_listener(const Vec3f &position, const Quaternionf &orientat
 {
 	impl->listener_position = position;
 	impl->listener_orientation = orientation;
+	impl->listener_ear_vector = orientation.rotate_vector(Vec3f(1.0f, 0.0f, 0.0f));
 }
 
 bool AudioWorld::is_ambience_enabled() const
@@ -36,30 +40,124 @@ bool AudioWorld::is_reverse_stereo_enabled() const
 	return impl->reverse_stereo;
 }
 
+void AudioWorld::set_max_real_voices(int count)
+{
+	impl->max_real_voices = count;
+}
+
+int AudioWorld::get_max_real_voices() const
+{
+	return impl->max_real_voices;
+}
+
+void AudioWorld::set_audibility_threshold(float volume)
+{
+	impl->audibility_threshold = volume;
+}
+
+float AudioWorld::get_audibility_threshold() const
+{
+	return impl->audibility_threshold;
+}
+
+AudioWorldStats AudioWorld::get_stats() const
+{
+	return impl->stats;
+}
+
 void AudioWorld::update()
 {
-	for (auto it = impl->objects.begin(); it != impl->objects.end(); ++it)
-	{
-		impl->update_session(*it);
-	}
+	ubyte64 start_time = System::get_microseconds();
+	ubyte64 elapsed = impl->last_update_time != 0 ? start_time - impl->last_update_time : 0;
+	impl->last_update_time = start_time;
+
+	AudioWorldStats stats;
 
+	// Drop the objects that stopped and score the rest
+	impl->voice_candidates.clear();
 	for (auto it = impl->active_objects.begin(); it != impl->active_objects.end(); )
 	{
-		if (it->impl->session.is_playing())
+		AudioObject_Impl *obj = it->impl.get();
+
+		bool still_playing = obj->playing;
+		if (still_playing && obj->virtual_voice)
+		{
+			still_playing = impl->advance_virtual(obj, elapsed);
+		}
+		else if (still_playing && !obj->session.is_playing())
+		{
+			obj->session = SoundBuffer_Session();
+			impl->num_real_voices--;
+			still_playing = false;
+		}
+
+		if (still_playing)
 		{
+			impl->calculate_volume(obj);
+			impl->voice_candidates.push_back(std::make_pair(obj->current_volume * obj->priority, obj));
 			++it;
 		}
 		else
 		{
+			obj->playing = false;
+			obj->in_active_list = false;
 			it = impl->active_objects.erase(it);
 		}
 	}
+
+	// Pick the most audible objects for the real voices
+	auto audible_end = std::partition(impl->voice_candidates.begin(), impl->voice_candidates.end(),
+		[&](const std::pair<float, AudioObject_Impl *> &candidate) { return candidate.first >= impl->audibility_threshold; });
+	auto real_end = audible_end;
+	if (audible_end - impl->voice_candidates.begin() > impl->max_real_voices)
+	{
+		real_end = impl->voice_candidates.begin() + std::max(impl->max_real_voices, 0);
+		std::nth_element(impl->voice_candidates.begin(), real_end, audible_end,
+			[](const std::pair<float, AudioObject_Impl *> &a, const std::pair<float, AudioObject_Impl *> &b) { return a.first > b.first; });
+	}
+	for (auto it = impl->voice_candidates.begin(); it != impl->voice_candidates.end(); ++it)
+		it->second->wants_real_voice = it < real_end;
+
+	// Demote first so the real voice count never exceeds the budget
+	for (auto &candidate : impl->voice_candidates)
+	{
+		AudioObject_Impl *obj = candidate.second;
+		if (!obj->wants_real_voice && !obj->virtual_voice)
+		{
+			impl->demote(obj);
+			stats.demoted_voices++;
+		}
+	}
+
+	for (auto &candidate : impl->voice_candidates)
+	{
+		AudioObject_Impl *obj = candidate.second;
+		if (obj->wants_real_voice && obj->virtual_voice)
+		{
+			impl->promote(obj);
+			stats.promoted_voices++;
+		}
+
+		if (obj->virtual_voice)
+		{
+			stats.virtual_voices++;
+		}
+		else
+		{
+			impl->update_session(obj);
+			stats.real_voices++;
+			stats.mixed_samples_per_second += obj->session.get_frequency();
+		}
+	}
+
+	stats.update_time = (int)(System::get_microseconds() - start_time);
+	impl->stats = stats;
 }
 
 /////////////////////////////////////////////////////////////////////////////
 
 AudioWorld_Impl::AudioWorld_Impl(const ResourceManager &resources)
-: play_ambience(true), reverse_stereo(false), resources(resources)
+: listener_ear_vector(1.0f, 0.0f, 0.0f), play_ambience(true), reverse_stereo(false), resources(resources), max_real_voices(32), audibility_threshold(0.001f), num_real_voices(0), last_update_time(0)
 {
 }
 
@@ -67,7 +165,7 @@ AudioWorld_Impl::~AudioWorld_Impl()
 {
 }
 
-void AudioWorld_Impl::update_session(AudioObject_Impl *obj)
+void AudioWorld_Impl::calculate_volume(AudioObject_Impl *obj)
 {
 	if (obj->attenuation_begin != obj->attenuation_end)
 	{
@@ -77,22 +175,59 @@ void AudioWorld_Impl::update_session(AudioObject_Impl *obj)
 
 		// Calculate pan from ear angle
 		Vec3f sound_direction = Vec3f::normalize(obj->position - listener_position);
-		Vec3f ear_vector = listener_orientation.rotate_vector(Vec3f(1.0f, 0.0f, 0.0f));
-		float pan = Vec3f::dot(ear_vector, sound_direction);
+		float pan = Vec3f::dot(listener_ear_vector, sound_direction);
 		if (reverse_stereo)
 			pan = -pan;
 
 		// Final volume needs to stay the same no matter the panning direction
-		float volume = (0.5f + std::abs(pan) * 0.5f) * t * obj->volume;
-
-		obj->session.set_volume(volume);
-		obj->session.set_pan(pan);
+		obj->current_volume = (0.5f + std::abs(pan) * 0.5f) * t * obj->volume;
+		obj->current_pan = pan;
 	}
 	else
 	{
-		obj->session.set_volume(obj->volume);
-		obj->session.set_pan(0.0f);
+		obj->current_volume = obj->volume;
+		obj->current_pan = 0.0f;
+	}
+}
+
+void AudioWorld_Impl::update_session(AudioObject_Impl *obj)
+{
+	// Uses the volume and pan from the last calculate_volume call
+	obj->session.set_volume(obj->current_volume);
+	obj->session.set_pan(obj->current_pan);
+}
+
+void AudioWorld_Impl::promote(AudioObject_Impl *obj)
+{
+	obj->session = obj->sound.prepare(obj->looping);
+	obj->session.set_position((int)obj->virtual_position);
+	obj->session.set_volume(obj->current_volume);
+	obj->session.set_pan(obj->current_pan);
+	obj->session.play();
+	obj->virtual_voice = false;
+	num_real_voices++;
+}
+
+void AudioWorld_Impl::demote(AudioObject_Impl *obj)
+{
+	obj->update_sound_info();
+	obj->virtual_position = obj->session.get_position();
+	obj->session.stop();
+	obj->session = SoundBuffer_Session();
+	obj->virtual_voice = true;
+	num_real_voices--;
+}
+
+bool AudioWorld_Impl::advance_virtual(AudioObject_Impl *obj, ubyte64 elapsed_microseconds)
+{
+	obj->virtual_position += elapsed_microseconds * (obj->sound_frequency / 1000000.0);
+	if (obj->virtual_position >= obj->sound_length)
+	{
+		if (!obj->looping || obj->sound_length <= 0)
+			return false;
+		obj->virtual_position = std::fmod(obj->virtual_position, (double)obj->sound_length);
 	}
+	return true;
 }
 
 }
@@ -29,9 +29,12 @@
 #pragma once
 
 #include <list>
+#include <vector>
+#include "API/Core/System/cl_platform.h"
 #include "API/Core/Math/vec3.h"
 #include "API/Core/Math/quaternion.h"
 #include "API/Core/Resources/resource_manager.h"
+#include "API/Sound/AudioWorld/audio_world.h"
 
 namespace clan
 {
@@ -45,16 +48,28 @@ public:
 	~AudioWorld_Impl();
 
 	void update_session(AudioObject_Impl *obj);
+	void calculate_volume(AudioObject_Impl *obj);
+	void promote(AudioObject_Impl *obj);
+	void demote(AudioObject_Impl *obj);
+	bool advance_virtual(AudioObject_Impl *obj, ubyte64 elapsed_microseconds);
 
 	std::list<AudioObject_Impl *> objects;
 	std::list<AudioObject> active_objects;
 
 	Vec3f listener_position;
 	Quaternionf listener_orientation;
+	Vec3f listener_ear_vector;
 	bool play_ambience;
 	bool reverse_stereo;
 
 	ResourceManager resources;
+
+	int max_real_voices;
+	float audibility_threshold;
+	int num_real_voices;
+	ubyte64 last_update_time;
+	AudioWorldStats stats;
+	std::vector<std::pair<float, AudioObject_Impl *> > voice_candidates;
 };
 
 }
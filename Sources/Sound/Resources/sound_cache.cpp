@@ -30,6 +30,7 @@
 #include "Sound/precomp.h"
 #include "API/Sound/Resources/sound_cache.h"
 #include "API/Core/Resources/resource_manager.h"
+#include "API/Sound/soundbuffer.h"
 
 namespace clan
 {
@@ -44,4 +45,9 @@ void SoundCache::set(ResourceManager &resources, const std::shared_ptr<SoundCach
 	resources.set_cache("clan.sound", cache);
 }
 
+Resource<SoundBuffer> SoundCache::get_sound_async(const std::string &id)
+{
+	return get_sound(id);
+}
+
 }
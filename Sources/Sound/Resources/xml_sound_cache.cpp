@@ -33,6 +33,8 @@
 #include "API/Core/Text/string_help.h"
 #include "API/Core/XML/dom_element.h"
 #include "API/Core/IOData/path_help.h"
+#include "API/Core/Text/logger.h"
+#include "API/Core/Resources/xml_resource_node.h"
 #include "xml_sound_cache.h"
 
 namespace clan
@@ -58,4 +60,58 @@ Resource<SoundBuffer> XMLSoundCache::get_sound(const std::string &id)
 	return sound;
 }
 
+Resource<SoundBuffer> XMLSoundCache::get_sound_async(const std::string &id)
+{
+	auto it = sounds.find(id);
+	if (it != sounds.end())
+		return it->second;
+
+	it = async_sounds.find(id);
+	if (it != async_sounds.end())
+		return it->second;
+
+	// The resource document is only read here, on the calling thread
+	XMLResourceNode resource = doc.get_resource(id);
+	std::string filename = PathHelp::combine(resource.get_base_path(), resource.get_element().get_attribute("file"));
+	std::string sound_format = resource.get_element().get_attribute("format");
+	bool streamed = (resource.get_element().get_attribute("stream", "no") == "yes");
+	FileSystem fs = resource.get_file_system();
+
+	Resource<SoundBuffer> sound;
+	async_sounds[id] = sound;
+
+	work_queue.queue([=]()
+	{
+		SoundBuffer loaded_sound;
+		std::string error;
+		try
+		{
+			loaded_sound = SoundBuffer(filename, streamed, fs, sound_format);
+			if (!loaded_sound.get_provider())
+				error = "Unknown sample format";
+		}
+		catch (Exception &e)
+		{
+			error = e.message;
+		}
+
+		work_queue.work_completed([=]()
+		{
+			// Failed sounds are left out of the cache, so get_sound reports the error
+			async_sounds.erase(id);
+			if (!error.empty())
+			{
+				log_event("debug", "Unable to load sound '%1': %2", id, error);
+				return;
+			}
+
+			Resource<SoundBuffer> completed_sound = sound;
+			completed_sound.set(loaded_sound);
+			sounds[id] = completed_sound;
+		});
+	});
+
+	return sound;
+}
+
 }
@@ -31,6 +31,7 @@
 
 #include "API/Sound/Resources/sound_cache.h"
 #include "API/Core/Resources/xml_resource_document.h"
+#include "API/Core/System/work_queue.h"
 
 namespace clan
 {
@@ -42,11 +43,15 @@ public:
 	~XMLSoundCache();
 
 	Resource<SoundBuffer> get_sound(const std::string &id) override;
+	Resource<SoundBuffer> get_sound_async(const std::string &id) override;
 
 private:
 	XMLResourceDocument doc;
 
 	std::map<std::string, Resource<SoundBuffer> > sounds;
+	std::map<std::string, Resource<SoundBuffer> > async_sounds;	// Sounds being loaded by the work queue
+
+	WorkQueue work_queue;	// Destroyed first, so the workers are gone before the rest
 };
 
 }
@@ -0,0 +1,71 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2015 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    agent
+*/
+
+
+#include "Sound/precomp.h"
+#include "API/Sound/SoundFilters/biquadfilter.h"
+#include "biquadfilter_provider.h"
+
+namespace clan
+{
+
+BiquadFilter::BiquadFilter(BiquadFilterType type, float cutoff_frequency, float q, int mixing_frequency)
+: SoundFilter(new BiquadFilterProvider(type, cutoff_frequency, q, mixing_frequency))
+{
+}
+
+BiquadFilter::~BiquadFilter()
+{
+}
+
+BiquadFilterProvider *BiquadFilter::get_provider() const
+{
+	return static_cast <BiquadFilterProvider *> (SoundFilter::get_provider());
+}
+
+BiquadFilterType BiquadFilter::get_type() const
+{
+	return get_provider()->get_type();
+}
+
+float BiquadFilter::get_cutoff_frequency() const
+{
+	return get_provider()->get_cutoff_frequency();
+}
+
+float BiquadFilter::get_q() const
+{
+	return get_provider()->get_q();
+}
+
+void BiquadFilter::set_response(BiquadFilterType type, float cutoff_frequency, float q)
+{
+	get_provider()->set_response(type, cutoff_frequency, q);
+}
+
+}
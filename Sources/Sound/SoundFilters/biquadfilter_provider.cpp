@@ -0,0 +1,154 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2015 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    agent
+*/
+
+
+#include "Sound/precomp.h"
+#include "biquadfilter_provider.h"
+#include "API/Core/Math/cl_math.h"
+#include <cmath>
+
+namespace clan
+{
+
+BiquadFilterProvider::BiquadFilterProvider(BiquadFilterType type, float cutoff_frequency, float q, int mixing_frequency)
+: type(type), cutoff_frequency(cutoff_frequency), q(q), mixing_frequency(mixing_frequency)
+{
+	for (int c=0; c<2; c++)
+	{
+		z1[c] = 0.0f;
+		z2[c] = 0.0f;
+	}
+	calculate_coefficients();
+}
+
+BiquadFilterProvider::~BiquadFilterProvider()
+{
+}
+
+BiquadFilterType BiquadFilterProvider::get_type() const
+{
+	MutexSection mutex_lock(&mutex);
+	return type;
+}
+
+float BiquadFilterProvider::get_cutoff_frequency() const
+{
+	MutexSection mutex_lock(&mutex);
+	return cutoff_frequency;
+}
+
+float BiquadFilterProvider::get_q() const
+{
+	MutexSection mutex_lock(&mutex);
+	return q;
+}
+
+void BiquadFilterProvider::set_response(BiquadFilterType new_type, float new_cutoff_frequency, float new_q)
+{
+	MutexSection mutex_lock(&mutex);
+	type = new_type;
+	cutoff_frequency = new_cutoff_frequency;
+	q = new_q;
+	calculate_coefficients();
+}
+
+void BiquadFilterProvider::filter(float **sample_data, int num_samples, int channels)
+{
+	MutexSection mutex_lock(&mutex);
+
+	// The recursion makes every output sample depend on the previous one, so the filter runs as a scalar loop
+	// (transposed direct form II). Stereo runs both channels in the same loop to overlap their dependency chains.
+	if (channels >= 2)
+	{
+		float *left = sample_data[0];
+		float *right = sample_data[1];
+		float l1 = z1[0], l2 = z2[0];
+		float r1 = z1[1], r2 = z2[1];
+		for (int i=0; i<num_samples; i++)
+		{
+			float xl = left[i];
+			float xr = right[i];
+			float yl = b0 * xl + l1;
+			float yr = b0 * xr + r1;
+			l1 = b1 * xl - a1 * yl + l2;
+			r1 = b1 * xr - a1 * yr + r2;
+			l2 = b2 * xl - a2 * yl;
+			r2 = b2 * xr - a2 * yr;
+			left[i] = yl;
+			right[i] = yr;
+		}
+		z1[0] = l1; z2[0] = l2;
+		z1[1] = r1; z2[1] = r2;
+	}
+	else if (channels == 1)
+	{
+		float *data = sample_data[0];
+		float s1 = z1[0], s2 = z2[0];
+		for (int i=0; i<num_samples; i++)
+		{
+			float x = data[i];
+			float y = b0 * x + s1;
+			s1 = b1 * x - a1 * y + s2;
+			s2 = b2 * x - a2 * y;
+			data[i] = y;
+		}
+		z1[0] = s1; z2[0] = s2;
+	}
+
+	// Flush the state to zero when it decays into denormals, which are very slow on x86
+	for (int c=0; c<2; c++)
+	{
+		if (std::abs(z1[c]) < 1.0e-15f) z1[c] = 0.0f;
+		if (std::abs(z2[c]) < 1.0e-15f) z2[c] = 0.0f;
+	}
+}
+
+void BiquadFilterProvider::calculate_coefficients()
+{
+	float frequency = clamp(cutoff_frequency, 1.0f, mixing_frequency * 0.49f);
+	float w0 = 2.0f * PI * frequency / mixing_frequency;
+	float cos_w0 = std::cos(w0);
+	float alpha = std::sin(w0) / (2.0f * max(q, 0.01f));
+
+	float a0 = 1.0f + alpha;
+	if (type == biquad_lowpass)
+	{
+		b0 = (1.0f - cos_w0) * 0.5f / a0;
+		b1 = (1.0f - cos_w0) / a0;
+	}
+	else
+	{
+		b0 = (1.0f + cos_w0) * 0.5f / a0;
+		b1 = -(1.0f + cos_w0) / a0;
+	}
+	b2 = b0;
+	a1 = -2.0f * cos_w0 / a0;
+	a2 = (1.0f - alpha) / a0;
+}
+
+}
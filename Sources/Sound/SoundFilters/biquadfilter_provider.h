@@ -0,0 +1,65 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2015 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    agent
+*/
+
+
+#pragma once
+
+#include "API/Sound/SoundProviders/soundfilter_provider.h"
+#include "API/Sound/SoundFilters/biquadfilter.h"
+#include "API/Core/System/mutex.h"
+
+namespace clan
+{
+
+class BiquadFilterProvider : public SoundFilterProvider
+{
+public:
+	BiquadFilterProvider(BiquadFilterType type, float cutoff_frequency, float q, int mixing_frequency);
+	~BiquadFilterProvider();
+
+	void filter(float **sample_data, int num_samples, int channels) override;
+
+	BiquadFilterType get_type() const;
+	float get_cutoff_frequency() const;
+	float get_q() const;
+	void set_response(BiquadFilterType type, float cutoff_frequency, float q);
+
+private:
+	void calculate_coefficients();
+
+	mutable Mutex mutex;
+	BiquadFilterType type;
+	float cutoff_frequency;
+	float q;
+	int mixing_frequency;
+
+	float b0, b1, b2, a1, a2;
+	float z1[2], z2[2];
+};
+
+}
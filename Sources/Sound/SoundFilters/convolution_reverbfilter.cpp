@@ -0,0 +1,66 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2015 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    agent
+*/
+
+
+#include "Sound/precomp.h"
+#include "API/Sound/SoundFilters/convolution_reverbfilter.h"
+#include "convolution_reverbfilter_provider.h"
+
+namespace clan
+{
+
+ConvolutionReverbFilter::ConvolutionReverbFilter(const std::vector<float> &impulse_response, float wet, float dry, int partition_size)
+: SoundFilter(new ConvolutionReverbFilterProvider(impulse_response, wet, dry, partition_size))
+{
+}
+
+ConvolutionReverbFilter::~ConvolutionReverbFilter()
+{
+}
+
+ConvolutionReverbFilterProvider *ConvolutionReverbFilter::get_provider() const
+{
+	return static_cast <ConvolutionReverbFilterProvider *> (SoundFilter::get_provider());
+}
+
+float ConvolutionReverbFilter::get_wet() const
+{
+	return get_provider()->get_wet();
+}
+
+float ConvolutionReverbFilter::get_dry() const
+{
+	return get_provider()->get_dry();
+}
+
+void ConvolutionReverbFilter::set_mix(float wet, float dry)
+{
+	get_provider()->set_mix(wet, dry);
+}
+
+}
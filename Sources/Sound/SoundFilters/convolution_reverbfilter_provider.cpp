@@ -0,0 +1,196 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2015 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    agent
+*/
+
+
+#include "Sound/precomp.h"
+#include "convolution_reverbfilter_provider.h"
+#include <algorithm>
+#include <cstring>
+
+#ifndef CL_DISABLE_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace clan
+{
+
+ConvolutionReverbFilterProvider::ConvolutionReverbFilterProvider(const std::vector<float> &impulse_response, float wet, float dry, int partition_size)
+: wet(wet), dry(dry), partition_size(partition_size), fft(partition_size * 2), delay_line_pos(0), fill(0)
+{
+	num_partitions = std::max((int)(impulse_response.size() + partition_size - 1) / partition_size, 1);
+
+	// Round the number of bins up to a multiple of four so the spectrum multiplication needs no scalar tail
+	bin_stride = (fft.get_num_bins() + 3) & ~3;
+
+	// The impulse response partitions are zero padded to the FFT size and transformed once
+	impulse_real.resize(num_partitions * bin_stride);
+	impulse_imag.resize(num_partitions * bin_stride);
+	std::vector<float> padded(partition_size * 2);
+	for (int p = 0; p < num_partitions; p++)
+	{
+		std::fill(padded.begin(), padded.end(), 0.0f);
+		int start = p * partition_size;
+		int length = std::min((int)impulse_response.size() - start, partition_size);
+		if (length > 0)
+			std::copy(impulse_response.begin() + start, impulse_response.begin() + start + length, padded.begin());
+		fft.forward(padded.data(), impulse_real.data() + p * bin_stride, impulse_imag.data() + p * bin_stride);
+	}
+
+	for (int c = 0; c < 2; c++)
+	{
+		history[c].resize(partition_size * 2);
+		delay_line_real[c].resize(num_partitions * bin_stride);
+		delay_line_imag[c].resize(num_partitions * bin_stride);
+		output[c].resize(partition_size);
+	}
+
+	accum_real.resize(bin_stride);
+	accum_imag.resize(bin_stride);
+	time_domain.resize(partition_size * 2);
+}
+
+ConvolutionReverbFilterProvider::~ConvolutionReverbFilterProvider()
+{
+}
+
+float ConvolutionReverbFilterProvider::get_wet() const
+{
+	MutexSection mutex_lock(&mutex);
+	return wet;
+}
+
+float ConvolutionReverbFilterProvider::get_dry() const
+{
+	MutexSection mutex_lock(&mutex);
+	return dry;
+}
+
+void ConvolutionReverbFilterProvider::set_mix(float new_wet, float new_dry)
+{
+	MutexSection mutex_lock(&mutex);
+	wet = new_wet;
+	dry = new_dry;
+}
+
+void ConvolutionReverbFilterProvider::filter(float **sample_data, int num_samples, int channels)
+{
+	MutexSection mutex_lock(&mutex);
+
+	if (channels > 2)
+		channels = 2;
+
+	int i = 0;
+	while (i < num_samples)
+	{
+		int run = std::min(num_samples - i, partition_size - fill);
+
+		for (int c = 0; c < channels; c++)
+		{
+			float *data = sample_data[c] + i;
+			float *input = history[c].data() + partition_size + fill;
+			const float *reverb = output[c].data() + fill;
+
+			memcpy(input, data, sizeof(float) * run);
+
+			int k = 0;
+#ifndef CL_DISABLE_SSE2
+			__m128 wet0 = _mm_set1_ps(wet);
+			__m128 dry0 = _mm_set1_ps(dry);
+			for (; k + 4 <= run; k += 4)
+			{
+				__m128 s = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(data + k), dry0), _mm_mul_ps(_mm_loadu_ps(reverb + k), wet0));
+				_mm_storeu_ps(data + k, s);
+			}
+#endif
+			for (; k < run; k++)
+				data[k] = data[k] * dry + reverb[k] * wet;
+		}
+
+		i += run;
+		fill += run;
+		if (fill == partition_size)
+		{
+			for (int c = 0; c < channels; c++)
+				convolve_partition(c);
+			delay_line_pos = (delay_line_pos + 1) % num_partitions;
+			fill = 0;
+		}
+	}
+}
+
+void ConvolutionReverbFilterProvider::convolve_partition(int c)
+{
+	// Uniformly partitioned overlap-save: transform the last two input partitions, then multiply the spectra of the
+	// last num_partitions inputs with the matching impulse response partitions and sum them in the frequency domain.
+	fft.forward(history[c].data(), delay_line_real[c].data() + delay_line_pos * bin_stride, delay_line_imag[c].data() + delay_line_pos * bin_stride);
+
+	std::fill(accum_real.begin(), accum_real.end(), 0.0f);
+	std::fill(accum_imag.begin(), accum_imag.end(), 0.0f);
+	for (int p = 0; p < num_partitions; p++)
+	{
+		int slot = delay_line_pos - p;
+		if (slot < 0)
+			slot += num_partitions;
+
+		multiply_add_spectrum(
+			delay_line_real[c].data() + slot * bin_stride, delay_line_imag[c].data() + slot * bin_stride,
+			impulse_real.data() + p * bin_stride, impulse_imag.data() + p * bin_stride,
+			accum_real.data(), accum_imag.data(), bin_stride);
+	}
+
+	fft.inverse(accum_real.data(), accum_imag.data(), time_domain.data());
+
+	// The second half is free of circular wrap-around
+	memcpy(output[c].data(), time_domain.data() + partition_size, sizeof(float) * partition_size);
+	memcpy(history[c].data(), history[c].data() + partition_size, sizeof(float) * partition_size);
+}
+
+void ConvolutionReverbFilterProvider::multiply_add_spectrum(const float *a_real, const float *a_imag, const float *b_real, const float *b_imag, float *out_real, float *out_imag, int size)
+{
+	int i = 0;
+#ifndef CL_DISABLE_SSE2
+	for (; i + 4 <= size; i += 4)
+	{
+		__m128 ar = _mm_loadu_ps(a_real + i);
+		__m128 ai = _mm_loadu_ps(a_imag + i);
+		__m128 br = _mm_loadu_ps(b_real + i);
+		__m128 bi = _mm_loadu_ps(b_imag + i);
+		__m128 re = _mm_sub_ps(_mm_mul_ps(ar, br), _mm_mul_ps(ai, bi));
+		__m128 im = _mm_add_ps(_mm_mul_ps(ar, bi), _mm_mul_ps(ai, br));
+		_mm_storeu_ps(out_real + i, _mm_add_ps(_mm_loadu_ps(out_real + i), re));
+		_mm_storeu_ps(out_imag + i, _mm_add_ps(_mm_loadu_ps(out_imag + i), im));
+	}
+#endif
+	for (; i < size; i++)
+	{
+		out_real[i] += a_real[i] * b_real[i] - a_imag[i] * b_imag[i];
+		out_imag[i] += a_real[i] * b_imag[i] + a_imag[i] * b_real[i];
+	}
+}
+
+}
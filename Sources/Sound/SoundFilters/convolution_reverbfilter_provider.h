@@ -0,0 +1,79 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2015 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    agent
+*/
+
+
+#pragma once
+
+#include "API/Sound/SoundProviders/soundfilter_provider.h"
+#include "API/Core/System/mutex.h"
+#include "sound_fft.h"
+#include <vector>
+
+namespace clan
+{
+
+class ConvolutionReverbFilterProvider : public SoundFilterProvider
+{
+public:
+	ConvolutionReverbFilterProvider(const std::vector<float> &impulse_response, float wet, float dry, int partition_size);
+	~ConvolutionReverbFilterProvider();
+
+	void filter(float **sample_data, int num_samples, int channels) override;
+
+	float get_wet() const;
+	float get_dry() const;
+	void set_mix(float wet, float dry);
+
+private:
+	void convolve_partition(int channel);
+	static void multiply_add_spectrum(const float *a_real, const float *a_imag, const float *b_real, const float *b_imag, float *out_real, float *out_imag, int size);
+
+	mutable Mutex mutex;
+	float wet;
+	float dry;
+
+	int partition_size;
+	int num_partitions;
+	int bin_stride;
+	SoundFFT fft;
+
+	std::vector<float> impulse_real, impulse_imag;
+
+	// Per channel: the last two partitions of input, the spectra of the last num_partitions input partitions
+	// (a ring indexed by delay_line_pos) and the reverberated output of the previous partition.
+	std::vector<float> history[2];
+	std::vector<float> delay_line_real[2], delay_line_imag[2];
+	std::vector<float> output[2];
+	int delay_line_pos;
+	int fill;
+
+	std::vector<float> accum_real, accum_imag;
+	std::vector<float> time_domain;
+};
+
+}
@@ -31,6 +31,10 @@
 #include "echofilter_provider.h"
 #include <memory.h>
 
+#ifndef CL_DISABLE_SSE2
+#include <emmintrin.h>
+#endif
+
 namespace clan
 {
 
@@ -64,12 +68,35 @@ void EchoFilterProvider::filter(float **sample_data, int num_samples, int channe
 
 		pos = start_pos;
 
-		for (int i=0; i<num_samples; i++)
+		// Every position in the delay line is only touched once per pass, so the samples can be processed
+		// four at a time as long as the run does not wrap around the end of the buffer
+		int i = 0;
+		while (i < num_samples)
 		{
-			work_buffer[pos] /= shift_factor;
-			work_buffer[pos] += data[i];
-			data[i] = work_buffer[pos];
-			pos++;
+			int run = num_samples - i;
+			if (run > buffer_size - pos)
+				run = buffer_size - pos;
+
+			float *work = work_buffer + pos;
+			float *input = data + i;
+			int j = 0;
+#ifndef CL_DISABLE_SSE2
+			__m128 factor = _mm_set1_ps(shift_factor);
+			for (; j + 4 <= run; j += 4)
+			{
+				__m128 w = _mm_add_ps(_mm_div_ps(_mm_loadu_ps(work + j), factor), _mm_loadu_ps(input + j));
+				_mm_storeu_ps(work + j, w);
+				_mm_storeu_ps(input + j, w);
+			}
+#endif
+			for (; j < run; j++)
+			{
+				work[j] = work[j] / shift_factor + input[j];
+				input[j] = work[j];
+			}
+
+			i += run;
+			pos += run;
 			if (pos == buffer_size) pos = 0;
 		}
 	}
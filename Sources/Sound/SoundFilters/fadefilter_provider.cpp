@@ -29,6 +29,11 @@
 
 #include "Sound/precomp.h"
 #include "fadefilter_provider.h"
+#include "API/Sound/sound_sse.h"
+
+#ifndef CL_DISABLE_SSE2
+#include <emmintrin.h>
+#endif
 
 namespace clan
 {
@@ -80,23 +85,52 @@ void FadeFilterProvider::fade_to_volume(float volume, int duration)
 
 void FadeFilterProvider::filter(float **sample_data, int num_samples, int channels)
 {
-	for (int i=0; i<num_samples; i++)
+	if (speed == 0.0f)
 	{
 		for (int j=0; j<channels; j++)
+			SoundSSE::multiply_float(sample_data[j], num_samples, cur_volume);
+		return;
+	}
+
+	// The volume changes by speed for every sample until it reaches the new volume. As the ramp is monotonic,
+	// clamping each sample's volume to the target gives the same result as stopping the ramp when it gets there.
+	float start_volume = cur_volume;
+	float min_volume = speed > 0.0f ? start_volume : new_volume;
+	float max_volume = speed > 0.0f ? new_volume : start_volume;
+
+	for (int j=0; j<channels; j++)
+	{
+		float *data = sample_data[j];
+		int i = 0;
+#ifndef CL_DISABLE_SSE2
+		__m128 volume = _mm_add_ps(_mm_set1_ps(start_volume), _mm_mul_ps(_mm_set1_ps(speed), _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f)));
+		__m128 step = _mm_set1_ps(speed * 4.0f);
+		__m128 low = _mm_set1_ps(min_volume);
+		__m128 high = _mm_set1_ps(max_volume);
+		for (; i + 4 <= num_samples; i += 4)
 		{
-			sample_data[j][i] = (sample_data[j][i] * cur_volume);
+			__m128 v = _mm_min_ps(_mm_max_ps(volume, low), high);
+			_mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), v));
+			volume = _mm_add_ps(volume, step);
 		}
-
-		// change volume for every second sample (because data is in stereo).
-		cur_volume += speed;
-		if (
-			(speed > 0 && cur_volume > new_volume) ||
-			(speed < 0 && cur_volume < new_volume))
+#endif
+		for (; i < num_samples; i++)
 		{
-			cur_volume = new_volume;
-			speed = 0;
+			float v = start_volume + speed * i;
+			if (v < min_volume) v = min_volume;
+			if (v > max_volume) v = max_volume;
+			data[i] *= v;
 		}
 	}
+
+	cur_volume = start_volume + speed * num_samples;
+	if (
+		(speed > 0 && cur_volume >= new_volume) ||
+		(speed < 0 && cur_volume <= new_volume))
+	{
+		cur_volume = new_volume;
+		speed = 0;
+	}
 }
 
 }
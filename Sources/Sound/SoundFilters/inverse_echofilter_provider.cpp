@@ -36,6 +36,10 @@
 #include <string.h>
 #endif
 
+#ifndef CL_DISABLE_SSE2
+#include <emmintrin.h>
+#endif
+
 namespace clan
 {
 
@@ -59,32 +63,64 @@ InverseEchoFilterProvider::~InverseEchoFilterProvider()
 void InverseEchoFilterProvider::filter(float **sample_data, int num_samples, int channels)
 {
 	int start_pos = pos;
+	int delay = buffer_size / 4;
 
 	for (int c=0; c<2; c++)
 	{
 		if (c == channels) break;
 
+		float *data = sample_data[c];
 		float *work_buffer = buffer[c];
 
 		pos = start_pos;
 
-		int delay = buffer_size / 4;
-		for (int i=0; i<num_samples; i++)
+		// Runs never exceed the tap delay, so the taps behind the current sample are never written by the run itself.
+		// The run is also cut where the write position or one of the taps wraps around the end of the buffer.
+		int i = 0;
+		while (i < num_samples)
 		{
-			work_buffer[pos] = sample_data[c][i];
-
-			int res = 0;
+			int taps[4];
+			int run = num_samples - i;
+			if (delay > 0 && run > delay)
+				run = delay;
 			for (int j=0; j<4; j++)
 			{
-				int p = pos+delay*j;
-				if (p >= buffer_size) p -= buffer_size;
-
-				res += work_buffer[p] / (5-j);
+				taps[j] = pos + delay*j;
+				if (taps[j] >= buffer_size) taps[j] -= buffer_size;
+				if (run > buffer_size - taps[j])
+					run = buffer_size - taps[j];
 			}
 
-			sample_data[c][i] = res;
+			float *input = data + i;
+			memcpy(work_buffer + pos, input, sizeof(float) * run);
+
+			const float *tap0 = work_buffer + taps[0];
+			const float *tap1 = work_buffer + taps[1];
+			const float *tap2 = work_buffer + taps[2];
+			const float *tap3 = work_buffer + taps[3];
+
+			int k = 0;
+#ifndef CL_DISABLE_SSE2
+			__m128 scale0 = _mm_set1_ps(1.0f / 5.0f);
+			__m128 scale1 = _mm_set1_ps(1.0f / 4.0f);
+			__m128 scale2 = _mm_set1_ps(1.0f / 3.0f);
+			__m128 scale3 = _mm_set1_ps(1.0f / 2.0f);
+			for (; k + 4 <= run; k += 4)
+			{
+				__m128 res = _mm_mul_ps(_mm_loadu_ps(tap0 + k), scale0);
+				res = _mm_add_ps(res, _mm_mul_ps(_mm_loadu_ps(tap1 + k), scale1));
+				res = _mm_add_ps(res, _mm_mul_ps(_mm_loadu_ps(tap2 + k), scale2));
+				res = _mm_add_ps(res, _mm_mul_ps(_mm_loadu_ps(tap3 + k), scale3));
+				_mm_storeu_ps(input + k, res);
+			}
+#endif
+			for (; k < run; k++)
+			{
+				input[k] = tap0[k] * (1.0f / 5.0f) + tap1[k] * (1.0f / 4.0f) + tap2[k] * (1.0f / 3.0f) + tap3[k] * (1.0f / 2.0f);
+			}
 
-			pos++;
+			i += run;
+			pos += run;
 			if (pos == buffer_size) pos = 0;
 		}
 	}
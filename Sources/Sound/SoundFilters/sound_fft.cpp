@@ -0,0 +1,204 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2015 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    agent
+*/
+
+
+#include "Sound/precomp.h"
+#include "sound_fft.h"
+#include <cmath>
+
+#ifndef CL_DISABLE_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace clan
+{
+
+SoundFFT::SoundFFT(int size)
+: size(size), half(size / 2)
+{
+	if (size < 8 || (size & (size - 1)) != 0)
+		throw Exception("FFT size must be a power of two");
+
+	int bits = 0;
+	while ((1 << bits) < half)
+		bits++;
+
+	bit_reverse.resize(half);
+	for (int i = 0; i < half; i++)
+	{
+		int reversed = 0;
+		for (int b = 0; b < bits; b++)
+		{
+			if (i & (1 << b))
+				reversed |= 1 << (bits - 1 - b);
+		}
+		bit_reverse[i] = reversed;
+	}
+
+	// Twiddle factors for each butterfly stage, stored at offset stage_size-1 so that every stage reads them contiguously
+	const double pi = 3.14159265358979323846;
+	twiddle_real.resize(half);
+	twiddle_imag.resize(half);
+	for (int stage_size = 1; stage_size < half; stage_size *= 2)
+	{
+		for (int j = 0; j < stage_size; j++)
+		{
+			double angle = -pi * j / stage_size;
+			twiddle_real[stage_size - 1 + j] = (float)std::cos(angle);
+			twiddle_imag[stage_size - 1 + j] = (float)std::sin(angle);
+		}
+	}
+
+	split_real.resize(half + 1);
+	split_imag.resize(half + 1);
+	for (int k = 0; k <= half; k++)
+	{
+		double angle = -2.0 * pi * k / size;
+		split_real[k] = (float)std::cos(angle);
+		split_imag[k] = (float)std::sin(angle);
+	}
+
+	work_real.resize(half);
+	work_imag.resize(half);
+}
+
+void SoundFFT::forward(const float *input, float *out_real, float *out_imag)
+{
+	// Even samples go into the real part and odd samples into the imaginary part of a half size complex FFT
+	for (int k = 0; k < half; k++)
+	{
+		work_real[bit_reverse[k]] = input[2 * k];
+		work_imag[bit_reverse[k]] = input[2 * k + 1];
+	}
+
+	transform();
+
+	// Split the result into the spectra of the even and odd samples and combine them
+	for (int k = 0; k <= half; k++)
+	{
+		int index = k == half ? 0 : k;
+		int mirror = k == 0 ? 0 : half - k;
+		float zr = work_real[index];
+		float zi = work_imag[index];
+		float cr = work_real[mirror];
+		float ci = -work_imag[mirror];
+
+		float even_real = (zr + cr) * 0.5f;
+		float even_imag = (zi + ci) * 0.5f;
+		float odd_real = (zi - ci) * 0.5f;
+		float odd_imag = (cr - zr) * 0.5f;
+
+		float wr = split_real[k];
+		float wi = split_imag[k];
+		out_real[k] = even_real + wr * odd_real - wi * odd_imag;
+		out_imag[k] = even_imag + wr * odd_imag + wi * odd_real;
+	}
+}
+
+void SoundFFT::inverse(const float *in_real, const float *in_imag, float *output)
+{
+	// Rebuild the half size complex spectrum and transform its conjugate, which gives the conjugated inverse
+	for (int k = 0; k < half; k++)
+	{
+		float xr = in_real[k];
+		float xi = in_imag[k];
+		float cr = in_real[half - k];
+		float ci = -in_imag[half - k];
+
+		float even_real = xr + cr;
+		float even_imag = xi + ci;
+		float dr = xr - cr;
+		float di = xi - ci;
+		float wr = split_real[k];
+		float wi = split_imag[k];
+		float odd_real = dr * wr + di * wi;
+		float odd_imag = di * wr - dr * wi;
+
+		work_real[bit_reverse[k]] = even_real - odd_imag;
+		work_imag[bit_reverse[k]] = -(even_imag + odd_real);
+	}
+
+	transform();
+
+	float scale = 1.0f / size;
+	for (int k = 0; k < half; k++)
+	{
+		output[2 * k] = work_real[k] * scale;
+		output[2 * k + 1] = -work_imag[k] * scale;
+	}
+}
+
+void SoundFFT::transform()
+{
+	float *re = work_real.data();
+	float *im = work_imag.data();
+
+	for (int stage_size = 1; stage_size < half; stage_size *= 2)
+	{
+		const float *wr = twiddle_real.data() + stage_size - 1;
+		const float *wi = twiddle_imag.data() + stage_size - 1;
+
+		for (int start = 0; start < half; start += stage_size * 2)
+		{
+			float *ar = re + start;
+			float *ai = im + start;
+			float *br = ar + stage_size;
+			float *bi = ai + stage_size;
+
+			int j = 0;
+#ifndef CL_DISABLE_SSE2
+			for (; j + 4 <= stage_size; j += 4)
+			{
+				__m128 twr = _mm_loadu_ps(wr + j);
+				__m128 twi = _mm_loadu_ps(wi + j);
+				__m128 xr = _mm_loadu_ps(br + j);
+				__m128 xi = _mm_loadu_ps(bi + j);
+				__m128 tr = _mm_sub_ps(_mm_mul_ps(xr, twr), _mm_mul_ps(xi, twi));
+				__m128 ti = _mm_add_ps(_mm_mul_ps(xr, twi), _mm_mul_ps(xi, twr));
+				__m128 yr = _mm_loadu_ps(ar + j);
+				__m128 yi = _mm_loadu_ps(ai + j);
+				_mm_storeu_ps(br + j, _mm_sub_ps(yr, tr));
+				_mm_storeu_ps(bi + j, _mm_sub_ps(yi, ti));
+				_mm_storeu_ps(ar + j, _mm_add_ps(yr, tr));
+				_mm_storeu_ps(ai + j, _mm_add_ps(yi, ti));
+			}
+#endif
+			for (; j < stage_size; j++)
+			{
+				float tr = br[j] * wr[j] - bi[j] * wi[j];
+				float ti = br[j] * wi[j] + bi[j] * wr[j];
+				br[j] = ar[j] - tr;
+				bi[j] = ai[j] - ti;
+				ar[j] += tr;
+				ai[j] += ti;
+			}
+		}
+	}
+}
+
+}
@@ -0,0 +1,66 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2015 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    agent
+*/
+
+
+#pragma once
+
+#include <vector>
+
+namespace clan
+{
+
+/// \brief Real input FFT used by the convolution filter
+///
+/// Spectra are stored as separate real and imaginary arrays (size/2+1 bins) so that multiplying spectra can be
+/// done four bins at a time. The real transform is computed with a complex FFT of half the size.
+class SoundFFT
+{
+public:
+	SoundFFT(int size);
+
+	int get_size() const { return size; }
+	int get_num_bins() const { return half + 1; }
+
+	/// \brief Transforms size samples into get_num_bins() bins
+	void forward(const float *input, float *out_real, float *out_imag);
+
+	/// \brief Transforms get_num_bins() bins back into size samples (including the 1/size scaling)
+	void inverse(const float *in_real, const float *in_imag, float *output);
+
+private:
+	void transform();
+
+	int size;
+	int half;
+	std::vector<int> bit_reverse;
+	std::vector<float> twiddle_real, twiddle_imag;
+	std::vector<float> split_real, split_imag;
+	std::vector<float> work_real, work_imag;
+};
+
+}
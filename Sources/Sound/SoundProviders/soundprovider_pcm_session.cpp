@@ -0,0 +1,118 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2015 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    agent
+*/
+
+#include "Sound/precomp.h"
+#include "soundprovider_pcm_session.h"
+#include "Sound/soundbuffer_pcm_cache.h"
+#include <cstring>
+
+namespace clan
+{
+
+/////////////////////////////////////////////////////////////////////////////
+// SoundProvider_PCM_Session construction:
+
+SoundProvider_PCM_Session::SoundProvider_PCM_Session(const std::shared_ptr<SoundPCM> &pcm)
+: pcm(pcm), position(0), end_position(pcm->num_samples)
+{
+}
+
+SoundProvider_PCM_Session::~SoundProvider_PCM_Session()
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// SoundProvider_PCM_Session attributes:
+
+int SoundProvider_PCM_Session::get_num_samples() const
+{
+	return pcm->num_samples;
+}
+
+int SoundProvider_PCM_Session::get_frequency() const
+{
+	return pcm->frequency;
+}
+
+int SoundProvider_PCM_Session::get_num_channels() const
+{
+	return pcm->channels.size();
+}
+
+int SoundProvider_PCM_Session::get_position() const
+{
+	return position;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// SoundProvider_PCM_Session operations:
+
+bool SoundProvider_PCM_Session::eof() const
+{
+	return position >= end_position;
+}
+
+void SoundProvider_PCM_Session::stop()
+{
+}
+
+bool SoundProvider_PCM_Session::play()
+{
+	return true;
+}
+
+bool SoundProvider_PCM_Session::set_position(int pos)
+{
+	if (pos < 0 || pos > pcm->num_samples)
+		return false;
+	position = pos;
+	return true;
+}
+
+bool SoundProvider_PCM_Session::set_end_position(int pos)
+{
+	if (pos < 0 || pos > pcm->num_samples)
+		return false;
+	end_position = pos;
+	return true;
+}
+
+int SoundProvider_PCM_Session::get_data(float **data_ptr, int data_requested)
+{
+	int samples = end_position - position;
+	if (samples > data_requested) samples = data_requested;
+	if (samples <= 0) return 0;
+
+	for (size_t i = 0; i < pcm->channels.size(); i++)
+		memcpy(data_ptr[i], &pcm->channels[i][position], samples * sizeof(float));
+
+	position += samples;
+	return samples;
+}
+
+}
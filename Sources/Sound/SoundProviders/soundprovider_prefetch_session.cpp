@@ -0,0 +1,282 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2015 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    agent
+*/
+
+#include "Sound/precomp.h"
+#include "soundprovider_prefetch_session.h"
+#include "Sound/sound_counters.h"
+#include "API/Sound/SoundProviders/soundprovider.h"
+#include "API/Core/System/system.h"
+#include <algorithm>
+#include <cstring>
+
+namespace clan
+{
+
+/////////////////////////////////////////////////////////////////////////////
+// SoundProvider_Prefetch_Session construction:
+
+SoundProvider_Prefetch_Session::SoundProvider_Prefetch_Session(SoundProvider *provider, SoundProvider_Session *session)
+: provider(provider), session(session), read_pos(0), write_pos(0), source_eof(false)
+{
+	num_channels = session->get_num_channels();
+	frequency = session->get_frequency();
+	position = session->get_position();
+
+	// About a second of decoded data
+	ring_size = std::max(frequency, chunk_size * 4);
+	ring.resize(num_channels, std::vector<float>(ring_size));
+	chunk.resize(num_channels, std::vector<float>(chunk_size));
+
+	// Decode the start right away, so the first fragments mixed do not wait for the worker
+	for (int i = 0; i < 2; i++)
+		decode_ahead();
+
+	SoundPrefetchWorker::instance().add(this);
+}
+
+SoundProvider_Prefetch_Session::~SoundProvider_Prefetch_Session()
+{
+	SoundPrefetchWorker::instance().remove(this);
+	provider->end_session(session);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// SoundProvider_Prefetch_Session attributes:
+
+int SoundProvider_Prefetch_Session::get_num_samples() const
+{
+	MutexSection decoder_lock(&decoder_mutex);
+	return session->get_num_samples();
+}
+
+int SoundProvider_Prefetch_Session::get_frequency() const
+{
+	return frequency;
+}
+
+int SoundProvider_Prefetch_Session::get_num_channels() const
+{
+	return num_channels;
+}
+
+int SoundProvider_Prefetch_Session::get_position() const
+{
+	MutexSection ring_lock(&ring_mutex);
+	return position;
+}
+
+bool SoundProvider_Prefetch_Session::needs_data() const
+{
+	MutexSection ring_lock(&ring_mutex);
+	return !source_eof && (write_pos - read_pos) + chunk_size <= (ubyte64)ring_size;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// SoundProvider_Prefetch_Session operations:
+
+bool SoundProvider_Prefetch_Session::set_looping(bool loop)
+{
+	MutexSection decoder_lock(&decoder_mutex);
+	return session->set_looping(loop);
+}
+
+bool SoundProvider_Prefetch_Session::eof() const
+{
+	MutexSection ring_lock(&ring_mutex);
+	return source_eof && read_pos == write_pos;
+}
+
+void SoundProvider_Prefetch_Session::stop()
+{
+	MutexSection decoder_lock(&decoder_mutex);
+	session->stop();
+}
+
+bool SoundProvider_Prefetch_Session::play()
+{
+	MutexSection decoder_lock(&decoder_mutex);
+	return session->play();
+}
+
+bool SoundProvider_Prefetch_Session::set_position(int pos)
+{
+	MutexSection decoder_lock(&decoder_mutex);
+	if (!session->set_position(pos))
+		return false;
+
+	MutexSection ring_lock(&ring_mutex);
+	read_pos = 0;
+	write_pos = 0;
+	source_eof = false;
+	position = pos;
+	ring_lock.unlock();
+	decoder_lock.unlock();
+
+	SoundPrefetchWorker::instance().wake_up();
+	return true;
+}
+
+bool SoundProvider_Prefetch_Session::set_end_position(int pos)
+{
+	MutexSection decoder_lock(&decoder_mutex);
+	return session->set_end_position(pos);
+}
+
+int SoundProvider_Prefetch_Session::get_data(float **data_ptr, int data_requested)
+{
+	int written = 0;
+	while (true)
+	{
+		MutexSection ring_lock(&ring_mutex);
+		int available = (int)(write_pos - read_pos);
+		int samples = std::min(available, data_requested - written);
+		while (samples > 0)
+		{
+			int ring_offset = (int)(read_pos % ring_size);
+			int block = std::min(samples, ring_size - ring_offset);
+			for (int i = 0; i < num_channels; i++)
+				memcpy(data_ptr[i] + written, &ring[i][ring_offset], block * sizeof(float));
+			read_pos += block;
+			position += block;
+			written += block;
+			samples -= block;
+		}
+		bool reached_end = source_eof;
+		bool running_low = (write_pos - read_pos) * 2 < (ubyte64)ring_size;
+		ring_lock.unlock();
+
+		if (running_low && !reached_end)
+			SoundPrefetchWorker::instance().wake_up();
+
+		if (written == data_requested || reached_end)
+			break;
+
+		// The worker fell behind; decode the rest here
+		SoundCounters::prefetch_underruns++;
+		if (!decode_ahead())
+			break;
+	}
+	return written;
+}
+
+bool SoundProvider_Prefetch_Session::decode_ahead()
+{
+	MutexSection decoder_lock(&decoder_mutex);
+
+	MutexSection ring_lock(&ring_mutex);
+	if (source_eof || (write_pos - read_pos) + chunk_size > (ubyte64)ring_size)
+		return false;
+	ring_lock.unlock();
+
+	std::vector<float *> chunk_ptrs(num_channels);
+	for (int i = 0; i < num_channels; i++)
+		chunk_ptrs[i] = &chunk[i][0];
+	int samples = num_channels > 0 ? session->get_data(chunk_ptrs.data(), chunk_size) : 0;
+	bool reached_end = num_channels == 0 || session->eof();
+
+	ring_lock.lock();
+	int chunk_offset = 0;
+	while (chunk_offset < samples)
+	{
+		int ring_offset = (int)(write_pos % ring_size);
+		int block = std::min(samples - chunk_offset, ring_size - ring_offset);
+		for (int i = 0; i < num_channels; i++)
+			memcpy(&ring[i][ring_offset], &chunk[i][chunk_offset], block * sizeof(float));
+		write_pos += block;
+		chunk_offset += block;
+	}
+	source_eof = reached_end;
+	return samples > 0 || reached_end;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// SoundPrefetchWorker construction:
+
+SoundPrefetchWorker::SoundPrefetchWorker()
+: wake_up_event(false)
+{
+	thread.start(this, &SoundPrefetchWorker::worker_main);
+}
+
+SoundPrefetchWorker::~SoundPrefetchWorker()
+{
+	stop_event.set();
+	thread.join();
+}
+
+SoundPrefetchWorker &SoundPrefetchWorker::instance()
+{
+	static SoundPrefetchWorker worker;
+	return worker;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// SoundPrefetchWorker operations:
+
+void SoundPrefetchWorker::add(SoundProvider_Prefetch_Session *session)
+{
+	MutexSection mutex_lock(&mutex);
+	sessions.push_back(session);
+	mutex_lock.unlock();
+	wake_up();
+}
+
+void SoundPrefetchWorker::remove(SoundProvider_Prefetch_Session *session)
+{
+	MutexSection mutex_lock(&mutex);
+	sessions.erase(std::remove(sessions.begin(), sessions.end(), session), sessions.end());
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// SoundPrefetchWorker implementation:
+
+void SoundPrefetchWorker::worker_main()
+{
+	while (Event::wait(stop_event, wake_up_event, 10) != 0)
+	{
+		// Round robin over the sessions, a chunk each, until every ring buffer is full
+		bool decoded = true;
+		while (decoded && !stop_event.wait(0))
+		{
+			decoded = false;
+			MutexSection mutex_lock(&mutex);
+			for (auto session : sessions)
+			{
+				if (session->needs_data())
+				{
+					ubyte64 start_time = System::get_microseconds();
+					if (session->decode_ahead())
+						decoded = true;
+					SoundCounters::decode_time += System::get_microseconds() - start_time;
+				}
+			}
+		}
+	}
+}
+
+}
@@ -0,0 +1,142 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2015 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    agent
+*/
+
+#pragma once
+
+#include "API/Sound/SoundProviders/soundprovider_session.h"
+#include "API/Core/System/cl_platform.h"
+#include "API/Core/System/mutex.h"
+#include "API/Core/System/thread.h"
+#include "API/Core/System/event.h"
+#include <vector>
+
+namespace clan
+{
+
+class SoundProvider;
+
+/// \brief Decodes a provider session ahead of the mixer into a ring buffer
+///
+/// A shared worker thread keeps the ring buffer filled, so the mixer thread only copies samples.
+/// If the ring buffer runs dry the mixer decodes the missing samples itself.
+class SoundProvider_Prefetch_Session : public SoundProvider_Session
+{
+/// \name Construction
+/// \{
+
+public:
+	SoundProvider_Prefetch_Session(SoundProvider *provider, SoundProvider_Session *session);
+	~SoundProvider_Prefetch_Session();
+
+
+/// \}
+/// \name Attributes
+/// \{
+
+public:
+	int get_num_samples() const override;
+	int get_frequency() const override;
+	int get_num_channels() const override;
+	int get_position() const override;
+
+	/// \brief Returns true if the ring buffer is not full and the source has more data
+	bool needs_data() const;
+
+
+/// \}
+/// \name Operations
+/// \{
+
+public:
+	bool set_looping(bool loop) override;
+	bool eof() const override;
+	void stop() override;
+	bool play() override;
+	bool set_position(int pos) override;
+	bool set_end_position(int pos) override;
+	int get_data(float **data_ptr, int data_requested) override;
+
+	/// \brief Decodes up to one chunk into the ring buffer
+	///
+	/// \return False if no samples were added and the end was not reached
+	bool decode_ahead();
+
+
+/// \}
+/// \name Implementation
+/// \{
+
+private:
+	SoundProvider *provider;
+	SoundProvider_Session *session;
+	int num_channels;
+	int frequency;
+
+	/// \brief Held while calling the wrapped session
+	mutable Mutex decoder_mutex;
+
+	/// \brief Held while accessing the ring buffer
+	mutable Mutex ring_mutex;
+
+	std::vector< std::vector<float> > ring;
+	std::vector< std::vector<float> > chunk;
+	int ring_size;
+	ubyte64 read_pos;
+	ubyte64 write_pos;
+	bool source_eof;
+	int position;
+
+	static const int chunk_size = 4096;
+/// \}
+};
+
+/// \brief Worker thread feeding all prefetch sessions
+class SoundPrefetchWorker
+{
+public:
+	static SoundPrefetchWorker &instance();
+	~SoundPrefetchWorker();
+
+	void add(SoundProvider_Prefetch_Session *session);
+	void remove(SoundProvider_Prefetch_Session *session);
+
+	/// \brief Wakes up the worker thread
+	void wake_up() { wake_up_event.set(); }
+
+private:
+	SoundPrefetchWorker();
+	void worker_main();
+
+	Mutex mutex;
+	std::vector<SoundProvider_Prefetch_Session *> sessions;
+	Thread thread;
+	Event stop_event;
+	Event wake_up_event;
+};
+
+}
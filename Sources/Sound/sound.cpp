@@ -30,6 +30,8 @@
 #include "Sound/precomp.h"
 #include "API/Sound/sound.h"
 #include "API/Sound/soundoutput.h"
+#include "soundbuffer_pcm_cache.h"
+#include "sound_counters.h"
 #include <memory>
 
 namespace clan
@@ -60,4 +62,49 @@ void Sound::select_output(const SoundOutput &output)
 	cl_current_output = output.impl;
 }
 
+/////////////////////////////////////////////////////////////////////////////
+// Decoding:
+
+std::atomic<ubyte64> SoundCounters::decode_time(0);
+std::atomic<ubyte64> SoundCounters::mixer_decode_time(0);
+std::atomic<ubyte64> SoundCounters::mix_time(0);
+std::atomic<int> SoundCounters::mixed_fragments(0);
+std::atomic<int> SoundCounters::pcm_cache_hits(0);
+std::atomic<int> SoundCounters::pcm_cache_misses(0);
+std::atomic<int> SoundCounters::prefetch_underruns(0);
+
+void Sound::set_pcm_cache_budget(int bytes)
+{
+	SoundPCMCache::instance().set_budget(bytes);
+}
+
+int Sound::get_pcm_cache_budget()
+{
+	return SoundPCMCache::instance().get_budget();
+}
+
+void Sound::set_pcm_cache_max_samples(int samples)
+{
+	SoundPCMCache::instance().set_max_samples(samples);
+}
+
+int Sound::get_pcm_cache_max_samples()
+{
+	return SoundPCMCache::instance().get_max_samples();
+}
+
+SoundStatistics Sound::get_statistics()
+{
+	SoundStatistics stats;
+	stats.decode_time = SoundCounters::decode_time;
+	stats.mixer_decode_time = SoundCounters::mixer_decode_time;
+	stats.mix_time = SoundCounters::mix_time;
+	stats.mixed_fragments = SoundCounters::mixed_fragments;
+	stats.pcm_cache_hits = SoundCounters::pcm_cache_hits;
+	stats.pcm_cache_misses = SoundCounters::pcm_cache_misses;
+	stats.pcm_cache_memory = SoundPCMCache::instance().get_memory_used();
+	stats.prefetch_underruns = SoundCounters::prefetch_underruns;
+	return stats;
+}
+
 }
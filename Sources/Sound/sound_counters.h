@@ -0,0 +1,56 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2015 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    agent
+*/
+
+#pragma once
+
+#include <atomic>
+#include "API/Core/System/cl_platform.h"
+
+namespace clan
+{
+
+/// \brief Counters behind Sound::get_statistics
+class SoundCounters
+{
+public:
+	/// \brief Microseconds spent decoding outside the mixer thread
+	static std::atomic<ubyte64> decode_time;
+
+	/// \brief Microseconds spent fetching sample data from providers on the mixer thread
+	static std::atomic<ubyte64> mixer_decode_time;
+
+	/// \brief Microseconds spent mixing fragments, including mixer_decode_time
+	static std::atomic<ubyte64> mix_time;
+
+	static std::atomic<int> mixed_fragments;
+	static std::atomic<int> pcm_cache_hits;
+	static std::atomic<int> pcm_cache_misses;
+	static std::atomic<int> prefetch_underruns;
+};
+
+}
@@ -66,6 +66,7 @@ SoundBuffer::SoundBuffer(
 : impl(std::make_shared<SoundBuffer_Impl>())
 {
 	impl->provider = SoundProviderFactory::load(fullname, streamed, sound_format);
+	impl->streamed = streamed;
 }
 
 SoundBuffer::SoundBuffer(
@@ -76,6 +77,7 @@ SoundBuffer::SoundBuffer(
 : impl(std::make_shared<SoundBuffer_Impl>())
 {
 	impl->provider = SoundProviderFactory::load(filename, streamed, fs, type);
+	impl->streamed = streamed;
 }
 
 SoundBuffer::SoundBuffer(
@@ -85,6 +87,7 @@ SoundBuffer::SoundBuffer(
 : impl(std::make_shared<SoundBuffer_Impl>())
 {
 	impl->provider = SoundProviderFactory::load(file, streamed, type);
+	impl->streamed = streamed;
 }
 
 SoundBuffer::~SoundBuffer()
@@ -117,6 +120,7 @@ SoundBuffer SoundBuffer::load(const std::string &id, const XMLResourceDocument &
 
 	if (!sound.impl->provider)
 		throw Exception("Unknown sample format");
+	sound.impl->streamed = streamed;
 	return sound;
 }
 
@@ -28,6 +28,9 @@
 
 #include "Sound/precomp.h"
 #include "soundbuffer_impl.h"
+#include "soundbuffer_pcm_cache.h"
+#include "SoundProviders/soundprovider_pcm_session.h"
+#include "SoundProviders/soundprovider_prefetch_session.h"
 #include "API/Sound/SoundProviders/soundprovider.h"
 #include "API/Sound/soundfilter.h"
 
@@ -39,12 +42,13 @@ namespace clan
 
 SoundBuffer_Impl::SoundBuffer_Impl() :
 	provider(nullptr),
-	volume(1.0f), pan(0.0f)
+	volume(1.0f), pan(0.0f), streamed(false), pcm_uncacheable(false)
 {
 }
 	
 SoundBuffer_Impl::~SoundBuffer_Impl()
 {
+	SoundPCMCache::instance().remove(this);
 	if(provider)
 		delete provider;
 }
@@ -56,6 +60,21 @@ SoundBuffer_Impl::~SoundBuffer_Impl()
 /////////////////////////////////////////////////////////////////////////////
 // SoundBuffer_Impl operations:
 
+SoundProvider_Session *SoundBuffer_Impl::begin_session()
+{
+	std::shared_ptr<SoundPCM> decoded = SoundPCMCache::instance().find_or_decode(this);
+	if (decoded)
+		return new SoundProvider_PCM_Session(decoded);
+	else
+		return new SoundProvider_Prefetch_Session(provider, provider->begin_session());
+}
+
+void SoundBuffer_Impl::end_session(SoundProvider_Session *session)
+{
+	// Both session types own the provider session (if any) they read from
+	delete session;
+}
+
 /////////////////////////////////////////////////////////////////////////////
 // SoundBuffer_Impl implementation:
 
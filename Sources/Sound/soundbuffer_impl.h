@@ -29,13 +29,17 @@
 #pragma once
 
 #include <vector>
+#include <list>
+#include <memory>
 #include "API/Core/System/mutex.h"
 
 namespace clan
 {
 
 class SoundProvider;
+class SoundProvider_Session;
 class SoundFilter;
+class SoundPCM;
 
 class SoundBuffer_Impl
 {
@@ -63,13 +67,24 @@ public:
 
 	mutable Mutex mutex;
 
+	/// \brief Streamed buffers are never decoded into the PCM cache
+	bool streamed;
+
+	/// \brief Decoded sample data, owned by the SoundPCMCache
+	std::shared_ptr<SoundPCM> pcm;
+	std::list<SoundBuffer_Impl *>::iterator pcm_it;
+	bool pcm_uncacheable;
+
 
 /// \}
 /// \name Operations
 /// \{
 
 public:
+	/// \brief Starts a session reading cached PCM data if possible, or decoding ahead on the prefetch worker
+	SoundProvider_Session *begin_session();
 
+	void end_session(SoundProvider_Session *session);
 
 /// \}
 /// \name Implementation
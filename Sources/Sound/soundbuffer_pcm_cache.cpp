@@ -0,0 +1,217 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2015 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    agent
+*/
+
+#include "Sound/precomp.h"
+#include "soundbuffer_pcm_cache.h"
+#include "soundbuffer_impl.h"
+#include "sound_counters.h"
+#include "API/Sound/SoundProviders/soundprovider.h"
+#include "API/Sound/SoundProviders/soundprovider_session.h"
+#include "API/Core/System/system.h"
+
+namespace clan
+{
+
+/////////////////////////////////////////////////////////////////////////////
+// SoundPCMCache construction:
+
+SoundPCMCache::SoundPCMCache()
+: budget(16*1024*1024), max_samples(10*44100), memory_used(0)
+{
+}
+
+SoundPCMCache &SoundPCMCache::instance()
+{
+	static SoundPCMCache cache;
+	return cache;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// SoundPCMCache attributes:
+
+int SoundPCMCache::get_budget() const
+{
+	MutexSection mutex_lock(&mutex);
+	return budget;
+}
+
+int SoundPCMCache::get_max_samples() const
+{
+	MutexSection mutex_lock(&mutex);
+	return max_samples;
+}
+
+int SoundPCMCache::get_memory_used() const
+{
+	MutexSection mutex_lock(&mutex);
+	return memory_used;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// SoundPCMCache operations:
+
+std::shared_ptr<SoundPCM> SoundPCMCache::find_or_decode(SoundBuffer_Impl *buffer)
+{
+	MutexSection mutex_lock(&mutex);
+	if (buffer->pcm)
+	{
+		buffers.splice(buffers.begin(), buffers, buffer->pcm_it);
+		SoundCounters::pcm_cache_hits++;
+		return buffer->pcm;
+	}
+
+	if (buffer->streamed || buffer->pcm_uncacheable || budget <= 0)
+		return std::shared_ptr<SoundPCM>();
+	mutex_lock.unlock();
+
+	// The caller holds the buffer mutex, so the same buffer is never decoded twice at once
+	std::shared_ptr<SoundPCM> pcm = decode(buffer->provider);
+
+	mutex_lock.lock();
+	SoundCounters::pcm_cache_misses++;
+	if (!pcm)
+	{
+		buffer->pcm_uncacheable = true;
+		return pcm;
+	}
+
+	buffer->pcm = pcm;
+	buffer->pcm_it = buffers.insert(buffers.begin(), buffer);
+	memory_used += pcm->get_memory_size();
+	evict();
+
+	// Do not decode it again on every play if it does not fit the budget by itself
+	if (!buffer->pcm)
+		buffer->pcm_uncacheable = true;
+	return pcm;
+}
+
+void SoundPCMCache::remove(SoundBuffer_Impl *buffer)
+{
+	MutexSection mutex_lock(&mutex);
+	if (buffer->pcm)
+	{
+		memory_used -= buffer->pcm->get_memory_size();
+		buffers.erase(buffer->pcm_it);
+		buffer->pcm.reset();
+	}
+}
+
+void SoundPCMCache::set_budget(int bytes)
+{
+	MutexSection mutex_lock(&mutex);
+	budget = bytes;
+	evict();
+}
+
+void SoundPCMCache::set_max_samples(int samples)
+{
+	MutexSection mutex_lock(&mutex);
+	max_samples = samples;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// SoundPCMCache implementation:
+
+std::shared_ptr<SoundPCM> SoundPCMCache::decode(SoundProvider *provider)
+{
+	ubyte64 start_time = System::get_microseconds();
+
+	MutexSection mutex_lock(&mutex);
+	int limit = max_samples;
+	mutex_lock.unlock();
+
+	std::shared_ptr<SoundPCM> pcm(std::make_shared<SoundPCM>());
+	SoundProvider_Session *session = provider->begin_session();
+	pcm->frequency = session->get_frequency();
+	int num_channels = session->get_num_channels();
+	pcm->channels.resize(num_channels);
+
+	// Use the length as a hint if the provider knows it
+	int length = session->get_num_samples();
+	if (length > limit)
+	{
+		provider->end_session(session);
+		return std::shared_ptr<SoundPCM>();
+	}
+	if (length > 0)
+	{
+		for (auto &channel : pcm->channels)
+			channel.reserve(length);
+	}
+
+	const int chunk_size = 4096;
+	std::vector<float *> chunk_ptrs(num_channels);
+	session->play();
+	while (num_channels > 0 && !session->eof())
+	{
+		if (pcm->num_samples > limit)
+		{
+			provider->end_session(session);
+			return std::shared_ptr<SoundPCM>();
+		}
+
+		for (int i = 0; i < num_channels; i++)
+		{
+			pcm->channels[i].resize(pcm->num_samples + chunk_size);
+			chunk_ptrs[i] = &pcm->channels[i][pcm->num_samples];
+		}
+
+		int written = session->get_data(&chunk_ptrs[0], chunk_size);
+		pcm->num_samples += written;
+		if (written == 0)
+			break;
+	}
+	provider->end_session(session);
+
+	if (pcm->num_samples > limit)
+		return std::shared_ptr<SoundPCM>();
+
+	for (auto &channel : pcm->channels)
+	{
+		channel.resize(pcm->num_samples);
+		channel.shrink_to_fit();
+	}
+
+	SoundCounters::decode_time += System::get_microseconds() - start_time;
+	return pcm;
+}
+
+void SoundPCMCache::evict()
+{
+	// Drop the least recently used decoded data; sessions playing it keep their own reference
+	while (memory_used > budget && !buffers.empty())
+	{
+		SoundBuffer_Impl *buffer = buffers.back();
+		memory_used -= buffer->pcm->get_memory_size();
+		buffer->pcm.reset();
+		buffers.pop_back();
+	}
+}
+
+}
@@ -0,0 +1,113 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2015 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    agent
+*/
+
+#pragma once
+
+#include <vector>
+#include <list>
+#include <memory>
+#include "API/Core/System/mutex.h"
+
+namespace clan
+{
+
+class SoundBuffer_Impl;
+class SoundProvider;
+
+/// \brief Fully decoded sample data of a short sound
+class SoundPCM
+{
+public:
+	SoundPCM() : frequency(0), num_samples(0) { }
+
+	int frequency;
+	int num_samples;
+	std::vector< std::vector<float> > channels;
+
+	int get_memory_size() const { return num_samples * (int)channels.size() * sizeof(float); }
+};
+
+/// \brief Memory budgeted cache of decoded short sounds, shared by all sound buffers
+///
+/// The decoded data is stored in the SoundBuffer_Impl itself. The cache tracks the buffers in least
+/// recently used order and drops the oldest decoded data when the memory budget is exceeded.
+class SoundPCMCache
+{
+/// \name Construction
+/// \{
+
+public:
+	static SoundPCMCache &instance();
+
+/// \}
+/// \name Attributes
+/// \{
+
+public:
+	int get_budget() const;
+	int get_max_samples() const;
+	int get_memory_used() const;
+
+/// \}
+/// \name Operations
+/// \{
+
+public:
+	/// \brief Returns the decoded data of the buffer, decoding it if it is short enough
+	///
+	/// Returns null for streamed buffers and sounds longer than the maximum number of samples.
+	std::shared_ptr<SoundPCM> find_or_decode(SoundBuffer_Impl *buffer);
+
+	/// \brief Removes a buffer being destroyed from the cache
+	void remove(SoundBuffer_Impl *buffer);
+
+	void set_budget(int bytes);
+	void set_max_samples(int samples);
+
+/// \}
+/// \name Implementation
+/// \{
+
+private:
+	SoundPCMCache();
+
+	std::shared_ptr<SoundPCM> decode(SoundProvider *provider);
+	void evict();
+
+	mutable Mutex mutex;
+
+	/// \brief Buffers with decoded data, most recently used first
+	std::list<SoundBuffer_Impl *> buffers;
+
+	int budget;
+	int max_samples;
+	int memory_used;
+/// \}
+};
+
+}
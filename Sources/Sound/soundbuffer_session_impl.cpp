@@ -35,6 +35,8 @@
 #include "API/Sound/SoundProviders/soundprovider.h"
 #include "API/Sound/SoundProviders/soundprovider_session.h"
 #include "API/Core/Text/logger.h"
+#include "API/Core/System/system.h"
+#include "sound_counters.h"
 
 namespace clan
 {
@@ -47,7 +49,7 @@ SoundBuffer_Session_Impl::SoundBuffer_Session_Impl(SoundBuffer &soundbuffer, boo
 {
 	volume = soundbuffer.get_volume();
 	pan = soundbuffer.get_pan();
-	provider_session = soundbuffer.get_provider()->begin_session();
+	provider_session = soundbuffer.impl->begin_session();
 	provider_session->set_looping(looping);
 	frequency = provider_session->get_frequency();
 
@@ -60,13 +62,14 @@ SoundBuffer_Session_Impl::SoundBuffer_Session_Impl(SoundBuffer &soundbuffer, boo
 	for (int i=0; i<num_buffer_channels; i++) float_buffer_data[i] = new float[num_buffer_samples];
 
 	float_buffer_data_offsetted.resize(num_buffer_channels);
+	filter_block_data.resize(num_buffer_channels);
 }
 
 SoundBuffer_Session_Impl::~SoundBuffer_Session_Impl()
 {
 	if (provider_session)
 	{
-		soundbuffer.get_provider()->end_session(provider_session);
+		soundbuffer.impl->end_session(provider_session);
 	}
 
 	for (int j=0; j < num_buffer_channels; ++j) delete[] float_buffer_data[j];
@@ -94,6 +97,8 @@ bool SoundBuffer_Session_Impl::mix_to(float **sample_data, float **temp_data, in
 
 void SoundBuffer_Session_Impl::get_data()
 {
+	ubyte64 start_time = System::get_microseconds();
+
 	int num_session_channels = provider_session->get_num_channels();
 	if (num_session_channels != num_buffer_channels)
 	{
@@ -142,6 +147,8 @@ void SoundBuffer_Session_Impl::get_data()
 
 		buffer_samples_written = num_buffer_samples - samples_left;
 	}
+
+	SoundCounters::mixer_decode_time += System::get_microseconds() - start_time;
 }
 
 void SoundBuffer_Session_Impl::get_data_in_mixer_frequency(int num_samples, float **temp_data)
@@ -191,9 +198,31 @@ void SoundBuffer_Session_Impl::get_data_in_mixer_frequency(int num_samples, floa
 
 void SoundBuffer_Session_Impl::run_filters(float **temp_data, int num_samples)
 {
-	for (auto & elem : filters)
+	if (filters.empty())
+		return;
+
+	if (filters.size() == 1)
 	{
-		elem.filter(temp_data, num_samples, num_buffer_channels);
+		filters[0].filter(temp_data, num_samples, num_buffer_channels);
+		return;
+	}
+
+	// Run the whole filter chain on one block at a time, so the samples stay in the L1 cache between filters
+	// instead of every filter streaming through the entire fragment
+	const int block_size = 256;
+	for (int offset = 0; offset < num_samples; offset += block_size)
+	{
+		int block_samples = num_samples - offset;
+		if (block_samples > block_size)
+			block_samples = block_size;
+
+		for (int chan = 0; chan < num_buffer_channels; chan++)
+			filter_block_data[chan] = temp_data[chan] + offset;
+
+		for (auto & elem : filters)
+		{
+			elem.filter(filter_block_data.data(), block_samples, num_buffer_channels);
+		}
 	}
 }
 
@@ -105,6 +105,7 @@ private:
 	float **float_buffer_data;
 
 	std::vector<float*> float_buffer_data_offsetted;
+	std::vector<float*> filter_block_data;
 
 	/// \brief Size of temporary channel buffers.
 	int num_buffer_samples;
@@ -32,6 +32,9 @@
 #include "API/Sound/soundfilter.h"
 #include <algorithm>
 #include "API/Sound/sound_sse.h"
+#include "API/Core/System/system.h"
+#include "API/Core/System/profiler.h"
+#include "sound_counters.h"
 
 namespace clan
 {
@@ -115,6 +118,9 @@ void SoundOutput_Impl::stop_mixer_thread()
 
 void SoundOutput_Impl::mix_fragment()
 {
+	cl_profile_zone("SoundOutput::mix_fragment");
+	ubyte64 start_time = System::get_microseconds();
+
 	resize_mix_buffers();
 	clear_mix_buffers();
 	fill_mix_buffers();
@@ -122,6 +128,9 @@ void SoundOutput_Impl::mix_fragment()
 	apply_master_volume_on_mix_buffers();
 	clamp_mix_buffers();
 	SoundSSE::pack_float_stereo(mix_buffers, mix_buffer_size, stereo_buffer);
+
+	SoundCounters::mix_time += System::get_microseconds() - start_time;
+	SoundCounters::mixed_fragments++;
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -130,6 +139,7 @@ void SoundOutput_Impl::mix_fragment()
 void SoundOutput_Impl::mixer_thread()
 {
     mixer_thread_starting();
+	Profiler::set_thread_name("Sound mixer");
     
 	while (if_continue_mixing())
 	{
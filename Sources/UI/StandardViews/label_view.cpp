@@ -61,6 +61,11 @@ namespace clan
 
 	LabelView::LabelView() : impl(new LabelViewImpl())
 	{
+		impl->text_style.set_style_changed([this]()
+		{
+			impl->font = Font();
+			set_needs_layout();
+		});
 	}
 
 	std::string LabelView::text() const
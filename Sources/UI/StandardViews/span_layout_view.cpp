@@ -51,6 +51,8 @@ namespace clan
 		std::vector<std::shared_ptr<View>> subviews_copy = subviews();
 		for (auto &view : subviews_copy)
 			view->remove_from_super();
+
+		set_needs_layout();
 	}
 
 	void SpanLayoutView::add_text(const std::string &text, const TextStyle &style)
@@ -64,6 +66,7 @@ namespace clan
 	{
 		View::add_subview(view);
 		impl->set_last_baseline_offset(baseline_offset);
+		set_needs_layout();
 	}
 
 	void SpanLayoutView::subview_added(const std::shared_ptr<View> &view)
@@ -186,9 +186,9 @@ namespace clan
 					float obj_x = x;
 					float obj_y = y + metrics.ascent + object.baseline_offset;
 
-					float obj_width = object.view->get_preferred_width(canvas);
-					float obj_height = object.view->get_preferred_height(canvas, obj_width);
-					float obj_baseline_offset = object.view->get_first_baseline_offset(canvas, obj_width);
+					float obj_width = object.view->measure_preferred_width(canvas);
+					float obj_height = object.view->measure_preferred_height(canvas, obj_width);
+					float obj_baseline_offset = object.view->measure_first_baseline_offset(canvas, obj_width);
 
 					if (obj_baseline_offset == 0.0f) // Hmm, do we need get_first_baseline_offset to be able to return that there is no baseline?
 						obj_baseline_offset = obj_height;
@@ -238,7 +238,7 @@ namespace clan
 			}
 			else if (object.type == SpanObjectType::view)
 			{
-				x += object.view->get_preferred_width(canvas);
+				x += object.view->measure_preferred_width(canvas);
 			}
 		}
 		return x;
@@ -345,9 +345,9 @@ namespace clan
 			}
 			else if (object.type == SpanObjectType::view)
 			{
-				float obj_width = object.view->get_preferred_width(canvas);
-				float obj_height = object.view->get_preferred_height(canvas, obj_width);
-				float obj_baseline_offset = object.view->get_first_baseline_offset(canvas, obj_width);
+				float obj_width = object.view->measure_preferred_width(canvas);
+				float obj_height = object.view->measure_preferred_height(canvas, obj_width);
+				float obj_baseline_offset = object.view->measure_first_baseline_offset(canvas, obj_width);
 
 				if (obj_baseline_offset == 0.0f) // Hmm, do we need get_first_baseline_offset to be able to return that there is no baseline?
 					obj_baseline_offset = obj_height;
@@ -50,6 +50,12 @@ namespace clan
 		set_focus_policy(FocusPolicy::accept);
 		set_cursor(StandardCursor::ibeam);
 
+		impl->text_style.set_style_changed([this]()
+		{
+			impl->font = Font();
+			set_needs_layout();
+		});
+
 		slots.connect(sig_key_press(), impl.get(), &TextFieldViewImpl::on_key_press);
 		slots.connect(sig_key_release(), impl.get(), &TextFieldViewImpl::on_key_release);
 		slots.connect(sig_pointer_press(), impl.get(), &TextFieldViewImpl::on_pointer_press);
@@ -82,7 +88,7 @@ namespace clan
 		impl->cursor_pos = impl->text.size();
 		impl->scroll_pos = 0.0f;
 
-		set_needs_render();
+		impl->text_changed();
 	}
 
 	std::string TextFieldView::placeholder() const
@@ -684,7 +690,7 @@ namespace clan
 			text.erase(text.begin() + new_cursor_pos, text.begin() + cursor_pos);
 			cursor_pos = new_cursor_pos;
 
-			textfield->set_needs_render();
+			text_changed();
 		}
 	}
 
@@ -706,7 +712,7 @@ namespace clan
 			cursor_pos = start;
 			text.erase(text.begin() + start, text.begin() + start + length);
 
-			textfield->set_needs_render();
+			text_changed();
 		}
 		else if (cursor_pos < text.length())
 		{
@@ -721,7 +727,7 @@ namespace clan
 			utf8_reader.set_position(cursor_pos);
 			text.erase(text.begin() + cursor_pos, text.begin() + cursor_pos + utf8_reader.get_char_length());
 
-			textfield->set_needs_render();
+			text_changed();
 		}
 	}
 
@@ -769,7 +775,7 @@ namespace clan
 
 			cursor_pos = std::min(cursor_pos, text.size());
 
-			textfield->set_needs_render();
+			text_changed();
 		}
 	}
 
@@ -827,7 +833,16 @@ namespace clan
 		text = text.substr(0, cursor_pos) + new_text + text.substr(cursor_pos);
 		cursor_pos += new_text.size();
 
-		textfield->set_needs_render();
+		text_changed();
+	}
+
+	void TextFieldViewImpl::text_changed()
+	{
+		// The preferred width of the text field depends on the text when no width is specified
+		if (textfield->box_style.is_width_auto())
+			textfield->set_needs_layout();
+		else
+			textfield->set_needs_render();
 	}
 
 	void TextFieldViewImpl::set_text_selection(size_t start, size_t length)
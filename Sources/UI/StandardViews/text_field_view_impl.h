@@ -60,6 +60,7 @@ namespace clan
 		void paste();
 		void undo();
 		void add(std::string new_text);
+		void text_changed();
 
 		void start_blink();
 		void stop_blink();
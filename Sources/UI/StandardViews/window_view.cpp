@@ -37,6 +37,7 @@
 #include "API/Display/2D/canvas.h"
 #include "UI/View/positioned_layout.h"
 #include "window_view_impl.h"
+#include <cmath>
 
 namespace clan
 {
@@ -95,7 +96,24 @@ namespace clan
 
 	void WindowView::set_needs_render()
 	{
-		impl->window.request_repaint(impl->window.get_viewport());
+		View::set_needs_render();
+		impl->add_damage(impl->window.get_viewport());
+	}
+
+	bool WindowView::retained_rendering_enabled() const
+	{
+		return impl->retained_rendering;
+	}
+
+	void WindowView::set_retained_rendering_enabled(bool value)
+	{
+		if (value != impl->retained_rendering)
+			impl->set_retained_rendering(value);
+	}
+
+	void WindowView::render_damaged(const Rectf &box)
+	{
+		impl->add_damage(Rect((int)std::floor(box.left), (int)std::floor(box.top), (int)std::ceil(box.right), (int)std::ceil(box.bottom)));
 	}
 
 	bool WindowView::local_root()
@@ -35,6 +35,7 @@
 #include "API/Display/Window/input_event.h"
 #include "API/Display/Window/input_context.h"
 #include "API/Display/2D/canvas.h"
+#include "API/Display/Render/blend_state_description.h"
 #include "window_view_impl.h"
 
 namespace clan
@@ -73,16 +74,102 @@ namespace clan
 		window.request_repaint(window.get_viewport());
 	}
 
+	void WindowView_Impl::add_damage(const Rect &box)
+	{
+		if (is_damaged)
+		{
+			damage_box.bounding_rect(box);
+		}
+		else
+		{
+			damage_box = box;
+			is_damaged = true;
+		}
+
+		if (!is_painting)
+			window.request_repaint(box);
+	}
+
 	void WindowView_Impl::on_paint(const clan::Rect &box)
 	{
-		canvas.clear(clan::Colorf::transparent);
+		is_painting = true;
 
 		window_view->set_geometry(BoxGeometry::from_margin_box(window_view->box_style, window.get_viewport()));
 		window_view->layout(canvas);
-		window_view->render(canvas);
+
+		if (retained_rendering)
+		{
+			paint_retained();
+		}
+		else
+		{
+			is_damaged = false;
+			canvas.clear(clan::Colorf::transparent);
+			window_view->render(canvas);
+		}
+
+		is_painting = false;
 
 		canvas.flush();
 		window.flip();
+
+		// Views that were invalidated while rendering need another paint
+		if (is_damaged)
+			window.request_repaint(damage_box);
+	}
+
+	void WindowView_Impl::paint_retained()
+	{
+		Size size = window.get_viewport().get_size();
+		if (surface_texture.is_null() || surface_texture.get_size() != size)
+		{
+			surface_texture = Texture2D(canvas, size);
+			surface_frame_buffer = FrameBuffer(canvas);
+			surface_frame_buffer.attach_color(0, surface_texture);
+			surface_canvas = Canvas(canvas, surface_frame_buffer);
+			surface_image = Image(surface_texture, Rect(Point(), size));
+			add_damage(Rect(Point(), size));
+		}
+
+		if (copy_blend_state.is_null())
+		{
+			BlendStateDescription blend_desc;
+			blend_desc.enable_blending(false);
+			copy_blend_state = BlendState(canvas, blend_desc);
+		}
+
+		if (is_damaged)
+		{
+			// Take the damage before rendering. Damage added while rendering is kept for the next paint
+			Rect clip_box = damage_box;
+			is_damaged = false;
+			clip_box.clip(Rect(Point(), size));
+			if (clip_box.get_width() > 0 && clip_box.get_height() > 0)
+			{
+				surface_canvas.set_cliprect(clip_box);
+				surface_canvas.clear(clan::Colorf::transparent);
+				window_view->render(surface_canvas);
+				surface_canvas.reset_cliprect();
+				surface_canvas.flush();
+			}
+		}
+
+		canvas.set_blend_state(copy_blend_state);
+		surface_image.draw(canvas, 0.0f, 0.0f);
+		canvas.reset_blend_state();
+	}
+
+	void WindowView_Impl::set_retained_rendering(bool enable)
+	{
+		retained_rendering = enable;
+		if (!enable)
+		{
+			surface_canvas = Canvas();
+			surface_image = Image();
+			surface_frame_buffer = FrameBuffer();
+			surface_texture = Texture2D();
+		}
+		add_damage(window.get_viewport());
 	}
 
 	void WindowView_Impl::on_window_close()
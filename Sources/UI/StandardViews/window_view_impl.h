@@ -29,6 +29,10 @@
 #pragma once
 
 #include "API/Display/Window/display_window.h"
+#include "API/Display/2D/image.h"
+#include "API/Display/Render/blend_state.h"
+#include "API/Display/Render/frame_buffer.h"
+#include "API/Display/Render/texture_2d.h"
 
 namespace clan
 {
@@ -50,7 +54,22 @@ namespace clan
 
 		std::shared_ptr<View> hot_view;
 
+		void add_damage(const Rect &box);
+		void set_retained_rendering(bool enable);
+
+		// Retained copy of the window contents. Only the damaged area is rendered again on paint
+		bool retained_rendering = false;
+		Texture2D surface_texture;
+		FrameBuffer surface_frame_buffer;
+		Canvas surface_canvas;
+		Image surface_image;
+		BlendState copy_blend_state;
+		Rect damage_box;
+		bool is_damaged = false;
+		bool is_painting = false;
+
 	private:
+		void paint_retained();
 		void on_window_size_changed();
 		void on_window_render(Canvas &canvas);
 		void on_window_key_event(KeyEvent &e);
@@ -44,7 +44,9 @@ namespace clan
 
 	BoxStyle &BoxStyle::operator =(const BoxStyle &copy)
 	{
+		std::function<void()> style_changed = impl->style_changed;
 		impl = copy.impl;
+		if (style_changed) style_changed();
 		return *this;
 	}
 
@@ -41,6 +41,14 @@ namespace clan
 	{
 	}
 
+	TextStyle &TextStyle::operator =(const TextStyle &copy)
+	{
+		std::function<void()> style_changed = impl->style_changed;
+		impl = copy.impl;
+		if (style_changed) style_changed();
+		return *this;
+	}
+
 	void TextStyle::set_font(const std::string &family, float size)
 	{
 		set_font(family, size, 0.0f);
@@ -56,6 +64,7 @@ namespace clan
 	void TextStyle::set_font_family(const std::string &family)
 	{
 		impl->family = family;
+		if (impl->style_changed) impl->style_changed();
 	}
 
 	std::string TextStyle::family() const
@@ -66,6 +75,7 @@ namespace clan
 	void TextStyle::set_size(float size)
 	{
 		impl->size = size;
+		if (impl->style_changed) impl->style_changed();
 	}
 
 	float TextStyle::size() const
@@ -81,6 +91,7 @@ namespace clan
 	void TextStyle::set_line_height(float height)
 	{
 		impl->line_height = height;
+		if (impl->style_changed) impl->style_changed();
 	}
 
 	float TextStyle::line_height() const
@@ -101,6 +112,7 @@ namespace clan
 	void TextStyle::set_weight(FontWeight weight)
 	{
 		impl->weight = weight;
+		if (impl->style_changed) impl->style_changed();
 	}
 
 	FontWeight TextStyle::weight() const
@@ -111,16 +123,19 @@ namespace clan
 	void TextStyle::set_style_normal()
 	{
 		impl->style = FontStyle::normal;
+		if (impl->style_changed) impl->style_changed();
 	}
 
 	void TextStyle::set_style_italic()
 	{
 		impl->style = FontStyle::italic;
+		if (impl->style_changed) impl->style_changed();
 	}
 
 	void TextStyle::set_style_oblique()
 	{
 		impl->style = FontStyle::oblique;
+		if (impl->style_changed) impl->style_changed();
 	}
 
 	bool TextStyle::is_style_normal() const
@@ -141,6 +156,7 @@ namespace clan
 	void TextStyle::set_color(const Colorf &color)
 	{
 		impl->color = color;
+		if (impl->style_changed) impl->style_changed();
 	}
 
 	Colorf TextStyle::color() const
@@ -159,6 +175,7 @@ namespace clan
 		impl->shadow.vert_offset = vert_offset;
 		impl->shadow.blur_radius = blur_radius;
 		impl->shadow.color = color;
+		if (impl->style_changed) impl->style_changed();
 	}
 
 	bool TextStyle::has_shadow() const
@@ -189,16 +206,19 @@ namespace clan
 	void TextStyle::set_transform_none()
 	{
 		impl->transform = TextTransform::none;
+		if (impl->style_changed) impl->style_changed();
 	}
 
 	void TextStyle::set_transform_uppercase()
 	{
 		impl->transform = TextTransform::uppercase;
+		if (impl->style_changed) impl->style_changed();
 	}
 
 	void TextStyle::set_transform_lowercase()
 	{
 		impl->transform = TextTransform::lowercase;
+		if (impl->style_changed) impl->style_changed();
 	}
 
 	bool TextStyle::is_transform_none() const
@@ -219,11 +239,13 @@ namespace clan
 	void TextStyle::set_target_opaque()
 	{
 		impl->subpixel = true;
+		if (impl->style_changed) impl->style_changed();
 	}
 
 	void TextStyle::set_target_transparent()
 	{
 		impl->subpixel = false;
+		if (impl->style_changed) impl->style_changed();
 	}
 
 	bool TextStyle::is_target_opaque() const
@@ -247,4 +269,9 @@ namespace clan
 		font_desc.set_subpixel(impl->subpixel);
 		return Font::resource(canvas, font_desc, UIThread::get_resources());
 	}
+
+	void TextStyle::set_style_changed(const std::function<void()> &callback)
+	{
+		impl->style_changed = callback;
+	}
 }
@@ -29,6 +29,7 @@
 #pragma once
 
 #include "API/Display/2D/color.h"
+#include <functional>
 
 namespace clan
 {
@@ -68,6 +69,7 @@ namespace clan
 		TextShadow shadow;
 		TextTransform transform = TextTransform::none;
 		bool subpixel = true;
+		std::function<void()> style_changed;
 	};
 
 	class TextBlockStyleImpl
@@ -46,7 +46,7 @@ namespace clan
 				margin_box_width += subview->box_style.margin_left();
 				margin_box_width += subview->box_style.border_left();
 				margin_box_width += subview->box_style.padding_left();
-				margin_box_width += subview->get_preferred_width(canvas);
+				margin_box_width += subview->measure_preferred_width(canvas);
 				margin_box_width += subview->box_style.padding_right();
 				margin_box_width += subview->box_style.border_right();
 				margin_box_width += subview->box_style.margin_right();
@@ -69,7 +69,7 @@ namespace clan
 				height += subview->box_style.margin_top();
 				height += subview->box_style.border_top();
 				height += subview->box_style.padding_top();
-				height += subview->get_preferred_height(canvas, width);
+				height += subview->measure_preferred_height(canvas, width);
 				height += subview->box_style.padding_bottom();
 				height += subview->box_style.border_bottom();
 				height += subview->box_style.margin_bottom();
@@ -84,7 +84,7 @@ namespace clan
 		for (const auto & subview : subviews)
 		{
 			if (!(subview)->hidden())
-				return (subview)->get_first_baseline_offset(canvas, width);
+				return (subview)->measure_first_baseline_offset(canvas, width);
 		}
 		return 0.0f;
 	}
@@ -95,7 +95,7 @@ namespace clan
 		for (auto it = subviews.rbegin(); it != subviews.rend(); ++it)
 		{
 			if (!(*it)->hidden())
-				return (*it)->get_last_baseline_offset(canvas, width);
+				return (*it)->measure_last_baseline_offset(canvas, width);
 		}
 		return 0.0f;
 	}
@@ -129,7 +129,7 @@ namespace clan
 					}
 				}
 
-				float subview_height = subview->get_preferred_height(canvas, subview_width);
+				float subview_height = subview->measure_preferred_height(canvas, subview_width);
 
 				y += subview->box_style.margin_top();
 				y += subview->box_style.border_top();
@@ -142,7 +142,7 @@ namespace clan
 				y += subview->box_style.border_bottom();
 				y += subview->box_style.margin_bottom();
 
-				subview->layout_subviews(canvas);
+				subview->layout(canvas);
 			}
 		}
 	}
@@ -47,7 +47,7 @@ namespace clan
 				width += subview->box_style.border_left();
 				width += subview->box_style.padding_left();
 				if (subview->box_style.is_flex_basis_auto())
-					width += subview->get_preferred_width(canvas);
+					width += subview->measure_preferred_width(canvas);
 				else
 					width += subview->box_style.flex_basis();
 				width += subview->box_style.padding_right();
@@ -84,7 +84,7 @@ namespace clan
 				total_shrink_factor += subview->box_style.flex_shrink();
 
 				if (subview->box_style.is_flex_basis_auto())
-					basis_width += subview->get_preferred_width(canvas);
+					basis_width += subview->measure_preferred_width(canvas);
 				else
 					basis_width += subview->box_style.flex_basis();
 			}
@@ -101,7 +101,7 @@ namespace clan
 			{
 				float subview_width = subview->box_style.flex_basis();
 				if (subview->box_style.is_flex_basis_auto())
-					subview_width = subview->get_preferred_width(canvas);
+					subview_width = subview->measure_preferred_width(canvas);
 
 				if (free_space < 0.0f && total_shrink_factor != 0.0f)
 					subview_width += subview->box_style.flex_shrink() * free_space / total_shrink_factor;
@@ -114,7 +114,7 @@ namespace clan
 				margin_box_height += subview->box_style.margin_top();
 				margin_box_height += subview->box_style.border_top();
 				margin_box_height += subview->box_style.padding_top();
-				margin_box_height += subview->get_preferred_height(canvas, subview_width);
+				margin_box_height += subview->measure_preferred_height(canvas, subview_width);
 				margin_box_height += subview->box_style.padding_bottom();
 				margin_box_height += subview->box_style.border_bottom();
 				margin_box_height += subview->box_style.margin_bottom();
@@ -130,7 +130,7 @@ namespace clan
 		for (const auto & subview : subviews)
 		{
 			if (!(subview)->hidden())
-				return (subview)->get_first_baseline_offset(canvas, width);
+				return (subview)->measure_first_baseline_offset(canvas, width);
 		}
 		return 0.0f;
 	}
@@ -141,7 +141,7 @@ namespace clan
 		for (auto it = subviews.rbegin(); it != subviews.rend(); ++it)
 		{
 			if (!(*it)->hidden())
-				return (*it)->get_last_baseline_offset(canvas, width);
+				return (*it)->measure_last_baseline_offset(canvas, width);
 		}
 		return 0.0f;
 	}
@@ -169,7 +169,7 @@ namespace clan
 				total_shrink_factor += subview->box_style.flex_shrink();
 
 				if (subview->box_style.is_flex_basis_auto())
-					basis_width += subview->get_preferred_width(canvas);
+					basis_width += subview->measure_preferred_width(canvas);
 				else
 					basis_width += subview->box_style.flex_basis();
 			}
@@ -186,7 +186,7 @@ namespace clan
 			{
 				float subview_width = subview->box_style.flex_basis();
 				if (subview->box_style.is_flex_basis_auto())
-					subview_width = subview->get_preferred_width(canvas);
+					subview_width = subview->measure_preferred_width(canvas);
 
 				if (free_space < 0.0f && total_shrink_factor != 0.0f)
 					subview_width += subview->box_style.flex_shrink() * free_space / total_shrink_factor;
@@ -205,7 +205,7 @@ namespace clan
 				bottom_noncontent += subview->box_style.border_bottom();
 				bottom_noncontent += subview->box_style.padding_bottom();
 
-				float subview_height = subview->get_preferred_height(canvas, subview_width);
+				float subview_height = subview->measure_preferred_height(canvas, subview_width);
 				float available_margin = view->geometry().content.get_height() - subview_height - top_noncontent - bottom_noncontent;
 
 				if (subview->box_style.is_margin_top_auto() && subview->box_style.is_margin_bottom_auto())
@@ -247,7 +247,7 @@ namespace clan
 				x += subview->box_style.border_right();
 				x += subview->box_style.margin_right();
 
-				subview->layout_subviews(canvas);
+				subview->layout(canvas);
 			}
 		}
 	}
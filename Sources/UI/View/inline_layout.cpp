@@ -45,7 +45,7 @@ namespace clan
 				width += view->box_style.margin_left();
 				width += view->box_style.border_left();
 				width += view->box_style.padding_left();
-				width += view->get_preferred_width(canvas);
+				width += view->measure_preferred_width(canvas);
 				width += view->box_style.padding_right();
 				width += view->box_style.border_right();
 				width += view->box_style.margin_right();
@@ -67,8 +67,8 @@ namespace clan
 		{
 			if (subview->box_style.is_static() && !subview->hidden())
 			{
-				float subview_width = subview->get_preferred_width(canvas);
-				float subview_height = subview->get_preferred_height(canvas, subview_width);
+				float subview_width = subview->measure_preferred_width(canvas);
+				float subview_height = subview->measure_preferred_height(canvas, subview_width);
 
 				float margin_box_width = 0.0f;
 				margin_box_width += subview->box_style.margin_left();
@@ -109,7 +109,7 @@ namespace clan
 		for (const std::shared_ptr<View> &subview : view->subviews())
 		{
 			if (!subview->hidden())
-				offset = clan::min(offset, subview->get_first_baseline_offset(canvas, width));
+				offset = clan::min(offset, subview->measure_first_baseline_offset(canvas, width));
 		}
 		return offset;
 	}
@@ -120,7 +120,7 @@ namespace clan
 		for (const std::shared_ptr<View> &subview : view->subviews())
 		{
 			if (!subview->hidden())
-				offset = clan::min(offset, subview->get_last_baseline_offset(canvas, width));
+				offset = clan::min(offset, subview->measure_last_baseline_offset(canvas, width));
 		}
 		return offset;
 	}
@@ -135,8 +135,8 @@ namespace clan
 		{
 			if (subview->box_style.is_static() && !subview->hidden())
 			{
-				float subview_width = subview->get_preferred_width(canvas);
-				float subview_height = subview->get_preferred_height(canvas, subview_width);
+				float subview_width = subview->measure_preferred_width(canvas);
+				float subview_height = subview->measure_preferred_height(canvas, subview_width);
 
 				float margin_box_width = 0.0f;
 				margin_box_width += subview->box_style.margin_left();
@@ -181,7 +181,7 @@ namespace clan
 
 				line_height = clan::max(line_height, margin_box_height);
 
-				subview->layout_subviews(canvas);
+				subview->layout(canvas);
 			}
 		}
 	}
@@ -73,9 +73,10 @@ namespace clan
 
 				layout_from_containing_box(canvas, subview.get(), offset_initial_containing_box);
 			}
-			else
+			else if (subview->needs_layout())
 			{
-				layout_subviews(canvas, subview.get());
+				// Static subviews are normally laid out by the flow layout of this view. This catches the ones it did not reach
+				subview->layout(canvas);
 			}
 		}
 	}
@@ -103,17 +104,17 @@ namespace clan
 		else if (!view->box_style.is_left_auto())
 		{
 			x = view->box_style.left();
-			width = view->get_preferred_width(canvas);
+			width = view->measure_preferred_width(canvas);
 		}
 		else if (!view->box_style.is_right_auto())
 		{
-			width = view->get_preferred_width(canvas);
+			width = view->measure_preferred_width(canvas);
 			x = containing_box.get_width() - view->box_style.right() - width;
 		}
 		else
 		{
 			x = 0.0f;
-			width = view->get_preferred_width(canvas);
+			width = view->measure_preferred_width(canvas);
 		}
 
 		float y = 0.0f;
@@ -137,17 +138,17 @@ namespace clan
 		else if (!view->box_style.is_top_auto())
 		{
 			y = view->box_style.top();
-			height = view->get_preferred_height(canvas, width);
+			height = view->measure_preferred_height(canvas, width);
 		}
 		else if (!view->box_style.is_bottom_auto())
 		{
-			height = view->get_preferred_height(canvas, width);
+			height = view->measure_preferred_height(canvas, width);
 			y = containing_box.get_height() - view->box_style.bottom() - height;
 		}
 		else
 		{
 			y = 0.0f;
-			height = view->get_preferred_height(canvas, width);
+			height = view->measure_preferred_height(canvas, width);
 		}
 
 		return BoxGeometry::from_content_box(view->box_style, Rectf::xywh(x, y, width, height));
@@ -156,6 +157,6 @@ namespace clan
 	void PositionedLayout::layout_from_containing_box(Canvas &canvas, View *view, const Rectf &containing_box)
 	{
 		view->set_geometry(get_geometry(canvas, view, containing_box));
-		view->layout_subviews(canvas);
+		view->layout(canvas);
 	}
 }
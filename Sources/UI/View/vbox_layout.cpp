@@ -48,7 +48,7 @@ namespace clan
 				margin_box_width += subview->box_style.border_left();
 				margin_box_width += subview->box_style.padding_left();
 				if (subview->box_style.is_flex_basis_auto())
-					margin_box_width += subview->get_preferred_width(canvas);
+					margin_box_width += subview->measure_preferred_width(canvas);
 				else
 					margin_box_width += subview->box_style.flex_basis();
 				margin_box_width += subview->box_style.padding_right();
@@ -95,7 +95,7 @@ namespace clan
 				height += subview->box_style.margin_top();
 				height += subview->box_style.border_top();
 				height += subview->box_style.padding_top();
-				height += subview->get_preferred_height(canvas, subview_width);
+				height += subview->measure_preferred_height(canvas, subview_width);
 				height += subview->box_style.padding_bottom();
 				height += subview->box_style.border_bottom();
 				height += subview->box_style.margin_bottom();
@@ -110,7 +110,7 @@ namespace clan
 		for (const auto & subview : subviews)
 		{
 			if (!(subview)->hidden())
-				return (subview)->get_first_baseline_offset(canvas, width);
+				return (subview)->measure_first_baseline_offset(canvas, width);
 		}
 		return 0.0f;
 	}
@@ -121,7 +121,7 @@ namespace clan
 		for (auto it = subviews.rbegin(); it != subviews.rend(); ++it)
 		{
 			if (!(*it)->hidden())
-				return (*it)->get_last_baseline_offset(canvas, width);
+				return (*it)->measure_last_baseline_offset(canvas, width);
 		}
 		return 0.0f;
 	}
@@ -149,7 +149,7 @@ namespace clan
 				total_shrink_factor += subview->box_style.flex_shrink();
 
 				if (subview->box_style.is_flex_basis_auto())
-					basis_height += subview->get_preferred_height(canvas, view->geometry().content.get_width());
+					basis_height += subview->measure_preferred_height(canvas, view->geometry().content.get_width());
 				else
 					basis_height += subview->box_style.flex_basis();
 			}
@@ -188,7 +188,7 @@ namespace clan
 
 				float subview_height = subview->box_style.flex_basis();
 				if (subview->box_style.is_flex_basis_auto())
-					subview_height = subview->get_preferred_height(canvas, subview_width);
+					subview_height = subview->measure_preferred_height(canvas, subview_width);
 
 				if (free_space < 0.0f && total_shrink_factor != 0.0f)
 					subview_height += subview->box_style.flex_shrink() * free_space / total_shrink_factor;
@@ -208,7 +208,7 @@ namespace clan
 				y += subview->box_style.border_bottom();
 				y += subview->box_style.margin_bottom();
 
-				subview->layout_subviews(canvas);
+				subview->layout(canvas);
 			}
 		}
 	}
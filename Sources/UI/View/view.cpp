@@ -29,6 +29,7 @@
 #include "UI/precomp.h"
 #include "API/UI/View/view.h"
 #include "API/Display/2D/canvas.h"
+#include "API/Display/Render/blend_state_description.h"
 #include "API/Display/Window/display_window.h"
 #include "API/UI/Events/event.h"
 #include "API/UI/Events/activation_change_event.h"
@@ -44,6 +45,7 @@
 #include "hbox_layout.h"
 #include "positioned_layout.h"
 #include <algorithm>
+#include <cmath>
 
 namespace clan
 {
@@ -120,20 +122,54 @@ namespace clan
 
 	void View::set_needs_layout()
 	{
-		impl->_needs_layout = true;
+		bool crosses_local_root = false;
+		View *view = this;
+		while (true)
+		{
+			view->impl->_needs_layout = true;
+			view->impl->clear_measurement_cache();
 
-		View *super = superview();
-		if (super)
-			super->set_needs_layout();
-		else
-			set_needs_render();
+			View *super = view->superview();
+			if (!super)
+				break;
+			if (view->local_root())
+				crosses_local_root = true;
+			view = super;
+		}
+
+		set_needs_render();
+		if (crosses_local_root)
+			view->set_needs_render();
 	}
 
 	void View::set_needs_render()
 	{
-		View *super = superview();
-		if (super)
-			super->set_needs_render();
+		impl->render_cache_valid = false;
+
+		// A subview is reporting its own area to the root view
+		if (impl->render_from_subview)
+			return;
+
+		// Invalidate the render caches containing this view and report the area to the root view
+		Rectf box = impl->_geometry.border_box();
+		View *view = this;
+		while (!view->local_root() && view->superview())
+		{
+			view = view->superview();
+			view->impl->render_cache_valid = false;
+			box.translate(view->impl->_geometry.content.get_top_left());
+
+			// Let ancestors overriding set_needs_render know, without each of them damaging its whole area
+			if (!view->local_root() && view->superview())
+			{
+				view->impl->render_from_subview = true;
+				view->set_needs_render();
+				view->impl->render_from_subview = false;
+			}
+		}
+
+		if (view != this)
+			view->render_damaged(box);
 	}
 
 	const BoxGeometry &View::geometry() const
@@ -145,8 +181,17 @@ namespace clan
 	{
 		if (impl->_geometry.content != geometry.content)
 		{
+			set_needs_render();
 			impl->_geometry = geometry;
-			set_needs_layout();
+			set_needs_render();
+
+			// A new size only invalidates the placement of the subviews, not the measurements of this view or its ancestors
+			View *view = this;
+			while (view)
+			{
+				view->impl->_needs_layout = true;
+				view = view->superview();
+			}
 		}
 	}
 
@@ -154,19 +199,101 @@ namespace clan
 	{
 		box_style.render(canvas, geometry());
 
-		Mat4f old_transform = canvas.get_transform();
-		Pointf translate = impl->_geometry.content.get_top_left();
-		canvas.set_transform(old_transform * Mat4f::translate(translate.x, translate.y, 0));
+		if (impl->render_cache_enabled)
+		{
+			impl->render_cached(this, canvas);
+		}
+		else
+		{
+			Mat4f old_transform = canvas.get_transform();
+			Pointf translate = impl->_geometry.content.get_top_left();
+			canvas.set_transform(old_transform * Mat4f::translate(translate.x, translate.y, 0));
+
+			render_content(canvas);
+			impl->render_subviews(canvas);
 
-		render_content(canvas);
+			canvas.set_transform(old_transform);
+		}
+	}
+
+	bool View::render_cache_enabled() const
+	{
+		return impl->render_cache_enabled;
+	}
 
-		for (std::shared_ptr<View> &view : impl->_subviews)
+	void View::set_render_cache_enabled(bool value)
+	{
+		if (value != impl->render_cache_enabled)
 		{
-			if (!view->hidden() && !view->local_root())
-				view->render(canvas);
+			impl->render_cache_enabled = value;
+			if (!value)
+			{
+				impl->render_cache_canvas = Canvas();
+				impl->render_cache_texture = Texture2D();
+				impl->render_cache_frame_buffer = FrameBuffer();
+				impl->render_cache_image = Image();
+			}
+			set_needs_render();
+		}
+	}
+
+	int View::render_cache_hits() const
+	{
+		return impl->render_cache_hits;
+	}
+
+	int View::render_cache_misses() const
+	{
+		return impl->render_cache_misses;
+	}
+
+	float View::measure_preferred_width(Canvas &canvas)
+	{
+		if (!impl->_preferred_width_valid)
+		{
+			impl->_preferred_width = get_preferred_width(canvas);
+			impl->_preferred_width_valid = true;
 		}
+		return impl->_preferred_width;
+	}
+
+	float View::measure_preferred_height(Canvas &canvas, float width)
+	{
+		auto it = impl->_preferred_height.find(width);
+		if (it != impl->_preferred_height.end())
+			return it->second;
+
+		float height = get_preferred_height(canvas, width);
+		if (impl->_preferred_height.size() >= ViewImpl::max_cached_widths)
+			impl->_preferred_height.clear();
+		impl->_preferred_height[width] = height;
+		return height;
+	}
+
+	float View::measure_first_baseline_offset(Canvas &canvas, float width)
+	{
+		auto it = impl->_first_baseline_offset.find(width);
+		if (it != impl->_first_baseline_offset.end())
+			return it->second;
+
+		float offset = get_first_baseline_offset(canvas, width);
+		if (impl->_first_baseline_offset.size() >= ViewImpl::max_cached_widths)
+			impl->_first_baseline_offset.clear();
+		impl->_first_baseline_offset[width] = offset;
+		return offset;
+	}
+
+	float View::measure_last_baseline_offset(Canvas &canvas, float width)
+	{
+		auto it = impl->_last_baseline_offset.find(width);
+		if (it != impl->_last_baseline_offset.end())
+			return it->second;
 
-		canvas.set_transform(old_transform);
+		float offset = get_last_baseline_offset(canvas, width);
+		if (impl->_last_baseline_offset.size() >= ViewImpl::max_cached_widths)
+			impl->_last_baseline_offset.clear();
+		impl->_last_baseline_offset[width] = offset;
+		return offset;
 	}
 
 	float View::get_preferred_width(Canvas &canvas)
@@ -236,8 +363,8 @@ namespace clan
 		{
 			layout_subviews(canvas);
 			PositionedLayout::layout_subviews(canvas, this);
+			impl->_needs_layout = false;
 		}
-		impl->_needs_layout = false;
 	}
 
 	void View::layout_local()
@@ -646,6 +773,84 @@ namespace clan
 
 	/////////////////////////////////////////////////////////////////////////
 
+	void ViewImpl::clear_measurement_cache()
+	{
+		_preferred_width_valid = false;
+		_preferred_height.clear();
+		_first_baseline_offset.clear();
+		_last_baseline_offset.clear();
+	}
+
+	void ViewImpl::render_subviews(Canvas &canvas)
+	{
+		// Skip subviews outside the clipping rectangle, such as the damaged area set by WindowView
+		const Mat4f &transform = canvas.get_transform();
+		Rectf clip_box = canvas.get_cliprect();
+
+		for (std::shared_ptr<View> &view : _subviews)
+		{
+			if (view->hidden() || view->local_root())
+				continue;
+
+			Rectf box = view->geometry().border_box();
+			Vec4f top_left = transform * Vec4f(box.left, box.top, 0.0f, 1.0f);
+			Vec4f bottom_right = transform * Vec4f(box.right, box.bottom, 0.0f, 1.0f);
+			if (clip_box.is_overlapped(Rectf(top_left.x, top_left.y, bottom_right.x, bottom_right.y)))
+				view->render(canvas);
+		}
+	}
+
+	void ViewImpl::render_cached(View *view, Canvas &canvas)
+	{
+		Rectf border_box = _geometry.border_box();
+		Size size((int)std::ceil(border_box.get_width()), (int)std::ceil(border_box.get_height()));
+		if (size.width <= 0 || size.height <= 0)
+			return;
+
+		if (render_cache_texture.is_null() || render_cache_texture.get_size() != size)
+		{
+			render_cache_texture = Texture2D(canvas, size);
+			render_cache_frame_buffer = FrameBuffer(canvas);
+			render_cache_frame_buffer.attach_color(0, render_cache_texture);
+			render_cache_canvas = Canvas(canvas, render_cache_frame_buffer);
+			render_cache_image = Image(render_cache_texture, Rect(Point(), size));
+			render_cache_valid = false;
+
+			if (render_cache_blend_state.is_null())
+			{
+				// The texture holds premultiplied alpha, as the default blend function is applied against a transparent background
+				BlendStateDescription blend_desc;
+				blend_desc.set_blend_function(blend_one, blend_one_minus_src_alpha, blend_one, blend_one_minus_src_alpha);
+				render_cache_blend_state = BlendState(canvas, blend_desc);
+			}
+		}
+
+		if (render_cache_valid)
+		{
+			render_cache_hits++;
+		}
+		else
+		{
+			render_cache_misses++;
+
+			canvas.flush();
+			render_cache_canvas.clear(Colorf::transparent);
+			Pointf translate = _geometry.content.get_top_left() - border_box.get_top_left();
+			render_cache_canvas.set_transform(Mat4f::translate(translate.x, translate.y, 0));
+
+			view->render_content(render_cache_canvas);
+			render_subviews(render_cache_canvas);
+
+			render_cache_canvas.set_transform(Mat4f::identity());
+			render_cache_canvas.flush();
+			render_cache_valid = true;
+		}
+
+		canvas.set_blend_state(render_cache_blend_state);
+		render_cache_image.draw(canvas, Rectf(border_box.get_top_left(), Sizef(size)));
+		canvas.reset_blend_state();
+	}
+
 	void ViewImpl::inverse_bubble(EventUI *e)
 	{
 		if (_superview)
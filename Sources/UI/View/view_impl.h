@@ -30,7 +30,13 @@
 #include "API/UI/View/focus_policy.h"
 #include "API/Display/Window/cursor.h"
 #include "API/Display/Window/cursor_description.h"
+#include "API/Display/2D/canvas.h"
+#include "API/Display/2D/image.h"
+#include "API/Display/Render/blend_state.h"
+#include "API/Display/Render/frame_buffer.h"
+#include "API/Display/Render/texture_2d.h"
 #include "../Animation/animation_group.h"
+#include <map>
 
 namespace clan
 {
@@ -57,6 +63,16 @@ namespace clan
 
 		bool _needs_layout = true;
 
+		void clear_measurement_cache();
+
+		// Measurement cache, keyed by the content width passed to the measure functions:
+		static const size_t max_cached_widths = 8;
+		bool _preferred_width_valid = false;
+		float _preferred_width = 0.0f;
+		std::map<float, float> _preferred_height;
+		std::map<float, float> _first_baseline_offset;
+		std::map<float, float> _last_baseline_offset;
+
 		Signal<void(ActivationChangeEvent &)> _sig_activated[4];
 		Signal<void(ActivationChangeEvent &)> _sig_deactivated[4];
 		Signal<void(CloseEvent &)> _sig_close[4];
@@ -73,6 +89,21 @@ namespace clan
 		Signal<void(KeyEvent &)> _sig_key_press[4];
 		Signal<void(KeyEvent &)> _sig_key_release[4];
 
+		void render_subviews(Canvas &canvas);
+		void render_cached(View *view, Canvas &canvas);
+
+		// Render cache of the border box area, excluding the box style:
+		bool render_cache_enabled = false;
+		bool render_cache_valid = false;
+		bool render_from_subview = false;
+		Canvas render_cache_canvas;
+		Texture2D render_cache_texture;
+		FrameBuffer render_cache_frame_buffer;
+		Image render_cache_image;
+		BlendState render_cache_blend_state;
+		int render_cache_hits = 0;
+		int render_cache_misses = 0;
+
 		// Root view variables:
 		View *_owner_view = nullptr;
 		View *_focus_view = nullptr;
@@ -0,0 +1,196 @@
+#include <ClanLib/core.h>
+#include <thread>
+#include <atomic>
+#include "../../test_check.h"
+using namespace clan;
+
+// Checks ordering, overflow handling and flushing of AsyncLogger and measures log_event throughput
+// from several threads against FileLogger.
+
+const int num_threads = 8;
+
+// Device collecting everything written to it. Writes can be held back to make the log queues fill up.
+class CaptureDevice : public IODeviceProvider
+{
+public:
+	CaptureDevice() : writes(0)
+	{
+		write_allowed.set();
+	}
+
+	int send(const void *data, int len, bool send_all) override
+	{
+		write_started.set();
+		write_allowed.wait();
+		MutexSection mutex_lock(&mutex);
+		text.append((const char *) data, len);
+		writes++;
+		return len;
+	}
+
+	int receive(void *data, int len, bool receive_all) override { return 0; }
+	int peek(void *data, int len) override { return 0; }
+	IODeviceProvider *duplicate() override { throw Exception("Not supported"); }
+
+	std::string get_text()
+	{
+		MutexSection mutex_lock(&mutex);
+		return text;
+	}
+
+	Event write_allowed, write_started;
+	std::atomic<int> writes;
+
+private:
+	Mutex mutex;
+	std::string text;
+};
+
+void test_ordering()
+{
+	Console::write_line("Checking that records from each thread are written in order");
+
+	CaptureDevice *capture = new CaptureDevice();
+	IODevice device(capture);
+	AsyncLogger logger(device, AsyncLogger::overflow_block, 64);
+
+	const int records_per_thread = 5000;
+	std::vector<std::thread> threads;
+	for (int i = 0; i < num_threads; i++)
+	{
+		threads.push_back(std::thread([i]()
+		{
+			for (int j = 0; j < records_per_thread; j++)
+				log_event(string_format("thread%1", i), "record %1", j);
+		}));
+	}
+	for (auto &thread : threads)
+		thread.join();
+	logger.flush();
+
+	std::vector<std::string> lines = StringHelp::split_text(capture->get_text(), "\n");
+	check(lines.size() == num_threads * records_per_thread, string_format("%1 lines written", (int) lines.size()));
+	check(logger.get_dropped_count() == 0, "Records were dropped with overflow_block");
+	check(capture->writes < (int) lines.size() / 10, "Records were not written in batches");
+
+	std::vector<int> next_record(num_threads);
+	for (auto &line : lines)
+	{
+		std::string::size_type type_start = line.find(" UTC [thread");
+		check(type_start != std::string::npos && line.length() > 20, "Malformed line: " + line);
+		int thread_index = StringHelp::text_to_int(line.substr(type_start + 12, 1));
+		int record = StringHelp::text_to_int(line.substr(line.find("record ") + 7));
+		check(record == next_record[thread_index]++, string_format("Thread %1 record %2 is out of order", thread_index, record));
+	}
+}
+
+void test_overflow()
+{
+	Console::write_line("Checking overflow_drop");
+
+	CaptureDevice *capture = new CaptureDevice();
+	IODevice device(capture);
+	AsyncLogger logger(device, AsyncLogger::overflow_drop, 4);
+
+	// Hold the writer in a write so nothing is drained while the queue fills up
+	capture->write_allowed.reset();
+	log_event("test", "first");
+	check(capture->write_started.wait(1000), "Writer did not start writing");
+
+	for (int i = 0; i < 10; i++)
+		log_event("test", "overflow %1", i);
+	check(logger.get_dropped_count() == 6, string_format("%1 records dropped by a queue of 4", logger.get_dropped_count()));
+
+	capture->write_allowed.set();
+	logger.flush();
+	std::string text = capture->get_text();
+	check(text.find("overflow 3") != std::string::npos && text.find("overflow 4") == std::string::npos, "Wrong records kept");
+	check(text.find("[log] 6 records dropped") != std::string::npos, "Dropped records were not reported");
+}
+
+void test_file()
+{
+	Console::write_line("Checking logging to a file");
+
+	std::string filename = "asynclogger_test.log";
+	if (FileHelp::file_exists(filename))
+		FileHelp::delete_file(filename);
+
+	{
+		AsyncLogger logger(filename);
+		log_event("info", "first line");
+	}
+	{
+		AsyncLogger logger(filename);
+		log_event("info", "second line");
+	}
+
+	std::vector<std::string> lines = StringHelp::split_text(File::read_text(filename), "\n");
+	FileHelp::delete_file(filename);
+	check(lines.size() == 2, "Log file was not appended to");
+	check(lines[0].find(" UTC [info] first line") != std::string::npos && lines[1].find("[info] second line") != std::string::npos, "Wrong log file contents");
+}
+
+void benchmark(const std::string &name, Logger *logger)
+{
+	const int records_per_thread = 20000;
+	ubyte64 start_time = System::get_microseconds();
+	std::vector<std::thread> threads;
+	for (int i = 0; i < num_threads; i++)
+	{
+		threads.push_back(std::thread([i]()
+		{
+			for (int j = 0; j < records_per_thread; j++)
+				log_event("benchmark", "thread %1 record %2 of the benchmark", i, j);
+		}));
+	}
+	for (auto &thread : threads)
+		thread.join();
+	ubyte64 log_time = System::get_microseconds() - start_time;
+
+	AsyncLogger *async_logger = dynamic_cast<AsyncLogger *>(logger);
+	if (async_logger)
+		async_logger->flush();
+	ubyte64 total_time = System::get_microseconds() - start_time;
+
+	double records = num_threads * records_per_thread;
+	Console::write_line("   %1 %2 krecords/s logging, %3 krecords/s written, %4 dropped", name, (int) (records * 1000.0 / log_time), (int) (records * 1000.0 / total_time), async_logger ? async_logger->get_dropped_count() : 0);
+}
+
+int main(int, char**)
+{
+	SetupCore setup_core;
+
+	try
+	{
+		test_ordering();
+		test_overflow();
+		test_file();
+
+		Console::write_line("log_event from %1 threads:", num_threads);
+		std::string filename = "asynclogger_benchmark.log";
+		{
+			FileLogger logger(filename);
+			benchmark("FileLogger                 ", &logger);
+		}
+		FileHelp::delete_file(filename);
+		{
+			AsyncLogger logger(filename, AsyncLogger::overflow_block);
+			benchmark("AsyncLogger, overflow_block", &logger);
+		}
+		FileHelp::delete_file(filename);
+		{
+			AsyncLogger logger(filename, AsyncLogger::overflow_drop);
+			benchmark("AsyncLogger, overflow_drop ", &logger);
+		}
+		FileHelp::delete_file(filename);
+
+		Console::write_line("Tests passed");
+	}
+	catch (Exception &e)
+	{
+		Console::write_line("Failed: %1", e.message);
+		return 1;
+	}
+	return 0;
+}
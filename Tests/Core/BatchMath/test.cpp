@@ -0,0 +1,91 @@
+#include <ClanLib/core.h>
+using namespace clan;
+
+// Micro-benchmarks of the BatchMath functions with each instruction set the CPU supports.
+// Results are in millions of vectors per second, on arrays small enough to stay in the L1 or L2 cache.
+
+const int num_points = 4096;
+const int num_repeats = 2000;
+
+struct Vertex
+{
+	Vec4f position;
+	Vec2f texcoord;
+	Vec4f color;
+	int texindex;
+};
+
+std::vector<Vec2f> points2(num_points);
+std::vector<Vec3f> points3(num_points);
+std::vector<Vec4f> points4(num_points);
+std::vector<Vec4f> output4(num_points);
+std::vector<Vec3f> output3(num_points);
+std::vector<Vec2f> output2(num_points);
+std::vector<Vertex> vertices(num_points);
+std::vector<float> soa_x(num_points), soa_y(num_points), soa_z(num_points), soa_w(num_points);
+Mat4f mat4 = Mat4f::ortho_2d(0.0f, 1920.0f, 1080.0f, 0.0f, handed_left, clip_negative_positive_w) * Mat4f::rotate(Angle(10.0f, angle_degrees), 0.0f, 0.0f, 1.0f, true);
+Mat3f mat3(0.8f, 0.6f, 0.0f, -0.6f, 0.8f, 0.0f, 100.0f, 50.0f, 1.0f);
+float sink = 0.0f;
+
+template<typename Func>
+void benchmark(const char *name, Func func)
+{
+	func();
+	ubyte64 start_time = System::get_microseconds();
+	for (int i = 0; i < num_repeats; i++)
+		func();
+	ubyte64 end_time = System::get_microseconds();
+	Console::write_line("  %1 %2 M/s", name, (int)((double)num_points * num_repeats / (end_time - start_time + 1)));
+}
+
+void benchmark_to_position()
+{
+	// The per-vertex loop the render batchers used before
+	benchmark("Vec2f -> vertex (to_position loop)  ", [] {
+		for (int i = 0; i < num_points; i++)
+			vertices[i].position = mat4 * Vec4f(points2[i].x, points2[i].y, 0.0f, 1.0f);
+	});
+}
+
+void benchmark_instruction_set()
+{
+	benchmark("Mat4f * Vec2f -> Vec4f              ", [] { BatchMath::transform(mat4, &points2[0], &output4[0], num_points); });
+	benchmark("Mat4f * Vec2f -> vertex             ", [] { BatchMath::transform(mat4, &points2[0], &vertices[0].position, num_points, sizeof(Vertex)); });
+	benchmark("Mat4f * Vec3f -> Vec4f              ", [] { BatchMath::transform(mat4, &points3[0], &output4[0], num_points); });
+	benchmark("Mat4f * Vec4f -> Vec4f              ", [] { BatchMath::transform(mat4, &points4[0], &output4[0], num_points); });
+	benchmark("Mat3f * Vec2f -> Vec2f              ", [] { BatchMath::transform(mat3, &points2[0], &output2[0], num_points); });
+	benchmark("Mat3f * Vec3f -> Vec3f              ", [] { BatchMath::transform(mat3, &points3[0], &output3[0], num_points); });
+	benchmark("bounding_box(Vec2f)                 ", [] { sink += BatchMath::bounding_box(&points2[0], num_points).right; });
+	benchmark("bounding_box(Vec3f)                 ", [] { sink += BatchMath::bounding_box(&points3[0], num_points).aabb_max.x; });
+	benchmark("deinterleave(Vec2f)                 ", [] { BatchMath::deinterleave(&points2[0], &soa_x[0], &soa_y[0], num_points); });
+	benchmark("interleave(Vec2f)                   ", [] { BatchMath::interleave(&soa_x[0], &soa_y[0], &output2[0], num_points); });
+	benchmark("deinterleave(Vec4f)                 ", [] { BatchMath::deinterleave(&points4[0], &soa_x[0], &soa_y[0], &soa_z[0], &soa_w[0], num_points); });
+	benchmark("interleave(Vec4f)                   ", [] { BatchMath::interleave(&soa_x[0], &soa_y[0], &soa_z[0], &soa_w[0], &output4[0], num_points); });
+}
+
+int main(int, char**)
+{
+	SetupCore setup_core;
+
+	for (int i = 0; i < num_points; i++)
+	{
+		points4[i] = Vec4f((i * 37 % 1920) * 1.0f, (i * 91 % 1080) * 1.0f, (i % 7) * 0.5f, 1.0f);
+		points3[i] = Vec3f(points4[i].x, points4[i].y, points4[i].z);
+		points2[i] = Vec2f(points4[i].x, points4[i].y);
+	}
+
+	const char *names[] = { "scalar", "SSE2", "AVX2", "AVX-512" };
+	benchmark_to_position();
+
+	BatchMath::InstructionSet supported = BatchMath::get_instruction_set();
+	for (int set = BatchMath::scalar; set <= supported; set++)
+	{
+		BatchMath::set_max_instruction_set((BatchMath::InstructionSet)set);
+		Console::write_line("%1:", names[set]);
+		benchmark_instruction_set();
+	}
+
+	if (sink == 1.0f)
+		Console::write_line("");
+	return 0;
+}
@@ -72,6 +72,7 @@ int TestApp::main(const std::vector<std::string> &args)
 		test_aes128();
 		test_aes192();
 		test_aes256();
+		test_aes_gcm();
 		test_sha1();
 		test_sha224();
 		test_sha256();
@@ -79,6 +80,7 @@ int TestApp::main(const std::vector<std::string> &args)
 		test_sha512();
 		test_sha512_224();
 		test_sha512_256();
+		test_benchmark();
 
 		Console::write_line("All Tests Complete");
 		console.display_close_message();
@@ -69,6 +69,8 @@ private:
 	void test_aes192_helper(const char *key_ptr, const char *iv_ptr, const char *plaintext_ptr, const char *ciphertext_ptr);
 	void test_aes256();
 	void test_aes256_helper(const char *key_ptr, const char *iv_ptr, const char *plaintext_ptr, const char *ciphertext_ptr);
+	void test_aes_gcm();
+	void test_aes_gcm_helper(const char *key_ptr, const char *iv_ptr, const char *aad_ptr, const char *plaintext_ptr, const char *ciphertext_ptr, const char *tag_ptr);
 	void convert_ascii(const char *src, std::vector<unsigned char> &dest);
 
 	void test_rsa();
@@ -88,6 +90,7 @@ private:
 	void test_hash(const SHA512_224 &sha512_224, const char *hash_text);
 	void test_sha512_256();
 	void test_hash(const SHA512_256 &sha512_256, const char *hash_text);
+	void test_benchmark();
 public:
 	void fail() const;
 
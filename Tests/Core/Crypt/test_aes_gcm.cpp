@@ -0,0 +1,167 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2015 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    agent
+*/
+
+#include "test.h"
+
+void TestApp::test_aes_gcm()
+{
+	Console::write_line(" Header: aes_gcm.h");
+	Console::write_line("  Class: AES_GCM");
+
+	// Test data from the GCM specification (test cases 2, 4, 10 and 16)
+	// http://csrc.nist.gov/groups/ST/toolkit/BCM/documents/proposedmodes/gcm/gcm-revised-spec.pdf
+
+	test_aes_gcm_helper(
+		"00000000000000000000000000000000",	// KEY
+		"000000000000000000000000",	// IV
+		"",	// AAD
+		"00000000000000000000000000000000",	// PLAINTEXT
+		"0388dace60b6a392f328c2b971b2fe78",	// CIPHERTEXT
+		"ab6e47d42cec13bdf53a67b21257bddf"	// TAG
+		);
+
+	test_aes_gcm_helper(
+		"feffe9928665731c6d6a8f9467308308",	// KEY
+		"cafebabefacedbaddecaf888",	// IV
+		"feedfacedeadbeeffeedfacedeadbeef"	// AAD
+		"abaddad2",
+		"d9313225f88406e5a55909c5aff5269a"	// PLAINTEXT
+		"86a7a9531534f7da2e4c303d8a318a72"
+		"1c3c0c95956809532fcf0e2449a6b525"
+		"b16aedf5aa0de657ba637b39",
+		"42831ec2217774244b7221b784d0d49c"	// CIPHERTEXT
+		"e3aa212f2c02a4e035c17e2329aca12e"
+		"21d514b25466931c7d8f6a5aac84aa05"
+		"1ba30b396a0aac973d58e091",
+		"5bc94fbc3221a5db94fae95ae7121a47"	// TAG
+		);
+
+	test_aes_gcm_helper(
+		"feffe9928665731c6d6a8f9467308308"	// KEY
+		"feffe9928665731c",
+		"cafebabefacedbaddecaf888",	// IV
+		"feedfacedeadbeeffeedfacedeadbeef"	// AAD
+		"abaddad2",
+		"d9313225f88406e5a55909c5aff5269a"	// PLAINTEXT
+		"86a7a9531534f7da2e4c303d8a318a72"
+		"1c3c0c95956809532fcf0e2449a6b525"
+		"b16aedf5aa0de657ba637b39",
+		"3980ca0b3c00e841eb06fac4872a2757"	// CIPHERTEXT
+		"859e1ceaa6efd984628593b40ca1e19c"
+		"7d773d00c144c525ac619d18c84a3f47"
+		"18e2448b2fe324d9ccda2710",
+		"2519498e80f1478f37ba55bd6d27618c"	// TAG
+		);
+
+	test_aes_gcm_helper(
+		"feffe9928665731c6d6a8f9467308308"	// KEY
+		"feffe9928665731c6d6a8f9467308308",
+		"cafebabefacedbaddecaf888",	// IV
+		"feedfacedeadbeeffeedfacedeadbeef"	// AAD
+		"abaddad2",
+		"d9313225f88406e5a55909c5aff5269a"	// PLAINTEXT
+		"86a7a9531534f7da2e4c303d8a318a72"
+		"1c3c0c95956809532fcf0e2449a6b525"
+		"b16aedf5aa0de657ba637b39",
+		"522dc1f099567d07f47f37a32a84427d"	// CIPHERTEXT
+		"643a8cdcbfe5c0c97598a2bd2555d1aa"
+		"8cb08e48590dbb3da7b08b1056828838"
+		"c5f61e6393ba7a0abcc9f662",
+		"76fc6ece0f4e1768cddf8853bb2d551b"	// TAG
+		);
+
+	// Round trip every length up to a few blocks, so the partial block and the 4 block GHASH paths are all used
+	std::vector<unsigned char> key;
+	std::vector<unsigned char> iv;
+	convert_ascii("2B7E151628AED2A6ABF7158809CF4F3C", key);
+	convert_ascii("000102030405060708090A0B", iv);
+
+	AES_GCM aes_gcm;
+	aes_gcm.set_key(&key[0], key.size());
+
+	const int test_data_length = 128;
+	unsigned char test_data[test_data_length];
+	unsigned char encrypted[test_data_length];
+	unsigned char decrypted[test_data_length];
+	unsigned char tag[AES_GCM::tag_size];
+	for (int cnt=0; cnt<test_data_length; cnt++)
+	{
+		test_data[cnt] = (unsigned char) cnt;
+
+		aes_gcm.encrypt(&iv[0], test_data, cnt, test_data, encrypted, cnt+1, tag);
+		if (!aes_gcm.decrypt(&iv[0], test_data, cnt, encrypted, decrypted, cnt+1, tag))
+			fail();
+		if (memcmp(test_data, decrypted, cnt+1))
+			fail();
+
+		// Any change to the ciphertext, the additional data or the tag must be detected
+		encrypted[cnt] ^= 1;
+		if (aes_gcm.decrypt(&iv[0], test_data, cnt, encrypted, decrypted, cnt+1, tag))
+			fail();
+		encrypted[cnt] ^= 1;
+		if (cnt > 0 && aes_gcm.decrypt(&iv[0], test_data, cnt - 1, encrypted, decrypted, cnt+1, tag))
+			fail();
+		tag[cnt % AES_GCM::tag_size] ^= 0x80;
+		if (aes_gcm.decrypt(&iv[0], test_data, cnt, encrypted, decrypted, cnt+1, tag))
+			fail();
+	}
+}
+
+void TestApp::test_aes_gcm_helper(const char *key_ptr, const char *iv_ptr, const char *aad_ptr, const char *plaintext_ptr, const char *ciphertext_ptr, const char *tag_ptr)
+{
+	std::vector<unsigned char> key;
+	std::vector<unsigned char> iv;
+	std::vector<unsigned char> aad;
+	std::vector<unsigned char> plaintext;
+	std::vector<unsigned char> ciphertext;
+	std::vector<unsigned char> tag;
+
+	convert_ascii(key_ptr, key);
+	convert_ascii(iv_ptr, iv);
+	convert_ascii(aad_ptr, aad);
+	convert_ascii(plaintext_ptr, plaintext);
+	convert_ascii(ciphertext_ptr, ciphertext);
+	convert_ascii(tag_ptr, tag);
+
+	AES_GCM aes_gcm;
+	aes_gcm.set_key(&key[0], key.size());
+
+	std::vector<unsigned char> buffer(plaintext.size());
+	unsigned char out_tag[AES_GCM::tag_size];
+	aes_gcm.encrypt(&iv[0], aad.data(), aad.size(), &plaintext[0], &buffer[0], plaintext.size(), out_tag);
+	if (memcmp(&buffer[0], &ciphertext[0], ciphertext.size()))
+		fail();
+	if (memcmp(out_tag, &tag[0], AES_GCM::tag_size))
+		fail();
+
+	// Decrypt in place
+	if (!aes_gcm.decrypt(&iv[0], aad.data(), aad.size(), &buffer[0], &buffer[0], buffer.size(), &tag[0]))
+		fail();
+	if (memcmp(&buffer[0], &plaintext[0], plaintext.size()))
+		fail();
+}
@@ -0,0 +1,207 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2015 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    agent
+**    (if your name is missing here, please add it)
+*/
+
+#include "test.h"
+
+// Throughput of the hash functions and ciphers on large buffers, as when hashing or encrypting asset bundles.
+// The million 'a' vectors and the bulk against byte by byte comparisons check the multi-block paths.
+
+template<typename HashType>
+std::string hash_data(const std::vector<unsigned char> &data, int add_size)
+{
+	HashType hash;
+	for (size_t pos = 0; pos < data.size(); pos += add_size)
+		hash.add(&data[pos], (int) std::min((size_t) add_size, data.size() - pos));
+	hash.calculate();
+	return hash.get_hash(true);
+}
+
+template<typename EncryptType>
+DataBuffer encrypt_data(const std::vector<unsigned char> &key, const std::vector<unsigned char> &iv, const std::vector<unsigned char> &data, int add_size)
+{
+	EncryptType encrypt;
+	encrypt.set_iv(&iv[0]);
+	encrypt.set_key(&key[0]);
+	for (size_t pos = 0; pos < data.size(); pos += add_size)
+		encrypt.add(&data[pos], (int) std::min((size_t) add_size, data.size() - pos));
+	encrypt.calculate();
+	return encrypt.get_data();
+}
+
+template<typename DecryptType>
+DataBuffer decrypt_data(const std::vector<unsigned char> &key, const std::vector<unsigned char> &iv, const DataBuffer &data, int add_size)
+{
+	DecryptType decrypt;
+	decrypt.set_iv(&iv[0]);
+	decrypt.set_key(&key[0]);
+	int size = data.get_size();
+	for (int pos = 0; pos < size; pos += add_size)
+		decrypt.add(data.get_data() + pos, min(add_size, size - pos));
+	if (!decrypt.calculate())
+		throw Exception("Decryption failed");
+	return decrypt.get_data();
+}
+
+static std::string megabytes_per_second(size_t bytes, ubyte64 microseconds)
+{
+	return string_format("%1 MB/s", (int) (bytes / (double) max(microseconds, (ubyte64) 1)));
+}
+
+template<typename HashType>
+void benchmark_hash(const char *name, const std::vector<unsigned char> &data)
+{
+	ubyte64 start_time = System::get_microseconds();
+	hash_data<HashType>(data, (int) data.size());
+	ubyte64 end_time = System::get_microseconds();
+	Console::write_line(string_format("   %1 %2", name, megabytes_per_second(data.size(), end_time - start_time)));
+}
+
+template<typename EncryptType, typename DecryptType>
+void benchmark_cipher(const char *name, int key_size, const std::vector<unsigned char> &data)
+{
+	std::vector<unsigned char> key(key_size), iv(16);
+	for (int i = 0; i < key_size; i++)
+		key[i] = (unsigned char) (i * 7);
+
+	// Check that adding all the data at once gives the same result as adding it in odd sized pieces
+	std::vector<unsigned char> small_data(data.begin(), data.begin() + 100000);
+	DataBuffer bulk = encrypt_data<EncryptType>(key, iv, small_data, (int) small_data.size());
+	DataBuffer pieces = encrypt_data<EncryptType>(key, iv, small_data, 13);
+	if (bulk.get_size() != pieces.get_size() || memcmp(bulk.get_data(), pieces.get_data(), bulk.get_size()) != 0)
+		throw Exception(string_format("%1 encryption differs between bulk and piecewise add()", name));
+	DataBuffer bulk_decrypted = decrypt_data<DecryptType>(key, iv, bulk, bulk.get_size());
+	DataBuffer pieces_decrypted = decrypt_data<DecryptType>(key, iv, bulk, 13);
+	if (bulk_decrypted.get_size() != (int) small_data.size() || memcmp(bulk_decrypted.get_data(), &small_data[0], small_data.size()) != 0)
+		throw Exception(string_format("%1 bulk decryption failed", name));
+	if (pieces_decrypted.get_size() != (int) small_data.size() || memcmp(pieces_decrypted.get_data(), &small_data[0], small_data.size()) != 0)
+		throw Exception(string_format("%1 piecewise decryption failed", name));
+
+	ubyte64 start_time = System::get_microseconds();
+	DataBuffer encrypted = encrypt_data<EncryptType>(key, iv, data, (int) data.size());
+	ubyte64 encrypted_time = System::get_microseconds();
+	DataBuffer decrypted = decrypt_data<DecryptType>(key, iv, encrypted, encrypted.get_size());
+	ubyte64 end_time = System::get_microseconds();
+
+	if (decrypted.get_size() != (int) data.size() || memcmp(decrypted.get_data(), &data[0], data.size()) != 0)
+		throw Exception(string_format("%1 round trip failed", name));
+
+	Console::write_line(string_format("   %1 CBC encrypt %2, decrypt %3", name,
+		megabytes_per_second(data.size(), encrypted_time - start_time),
+		megabytes_per_second(data.size(), end_time - encrypted_time)));
+}
+
+static void benchmark_exptmod(Random &random, int key_size_in_bits)
+{
+	std::vector<unsigned char> bytes(key_size_in_bits / 8);
+	random.get_random_bytes(&bytes[0], bytes.size());
+	bytes[0] |= 0x80;
+	bytes.back() |= 1;
+	BigInt modulus;
+	modulus.read_unsigned_octets(&bytes[0], bytes.size());
+
+	random.get_random_bytes(&bytes[0], bytes.size());
+	BigInt exponent;
+	exponent.read_unsigned_octets(&bytes[0], bytes.size());
+
+	bytes[0] &= 0x7f;
+	BigInt base;
+	base.read_unsigned_octets(&bytes[0], bytes.size());
+
+	const int iterations = 8;
+	BigInt result;
+	ubyte64 start_time = System::get_microseconds();
+	for (int i = 0; i < iterations; i++)
+		base.exptmod(&exponent, &modulus, &result);
+	ubyte64 end_time = System::get_microseconds();
+	Console::write_line(string_format("   %1-bit exptmod %2 ms", key_size_in_bits, (end_time - start_time) / 1000.0 / iterations));
+}
+
+static void benchmark_rsa(Random &random, int key_size_in_bits)
+{
+	Secret private_exponent, prime1, prime2, exponent1, exponent2, coefficient;
+	DataBuffer public_exponent, modulus;
+	ubyte64 start_time = System::get_microseconds();
+	RSA::create_keypair(random, private_exponent, public_exponent, modulus, prime1, prime2, exponent1, exponent2, coefficient, key_size_in_bits);
+	ubyte64 keypair_time = System::get_microseconds();
+
+	Secret message(32);
+	random.get_random_bytes(message.get_data(), message.get_size());
+	DataBuffer encrypted = RSA::encrypt(2, random, public_exponent, modulus, message);
+
+	ubyte64 decrypt_start_time = System::get_microseconds();
+	RSA::decrypt(private_exponent, modulus, encrypted);
+	ubyte64 decrypt_time = System::get_microseconds();
+	RSA::decrypt(prime1, prime2, exponent1, exponent2, coefficient, encrypted);
+	ubyte64 decrypt_crt_time = System::get_microseconds();
+
+	Console::write_line(string_format("   RSA-%1 create keypair %2 ms, decrypt %3 ms, decrypt (CRT) %4 ms", key_size_in_bits,
+		(keypair_time - start_time) / 1000.0, (decrypt_time - decrypt_start_time) / 1000.0, (decrypt_crt_time - decrypt_time) / 1000.0));
+}
+
+void TestApp::test_benchmark()
+{
+	Console::write_line(" Benchmark: hashes and ciphers on 32 MB");
+
+	std::vector<unsigned char> million_a(1000000, 'a');
+	if (hash_data<SHA1>(million_a, (int) million_a.size()) != "34AA973CD4C4DAA4F61EEB2BDBAD27316534016F")
+		fail();
+	if (hash_data<SHA1>(million_a, 1000) != "34AA973CD4C4DAA4F61EEB2BDBAD27316534016F")
+		fail();
+	if (hash_data<SHA256>(million_a, (int) million_a.size()) != "CDC76E5C9914FB9281A1C7E284D73E67F1809A48A497200E046D39CCC7112CD0")
+		fail();
+	if (hash_data<SHA256>(million_a, 37) != "CDC76E5C9914FB9281A1C7E284D73E67F1809A48A497200E046D39CCC7112CD0")
+		fail();
+	if (hash_data<SHA224>(million_a, 1000) != "20794655980C91D8BBB4C1EA97618A4BF03F42581948B2EE4EE7AD67")
+		fail();
+
+	std::vector<unsigned char> data(32 * 1024 * 1024);
+	for (size_t i = 0; i < data.size(); i++)
+		data[i] = (unsigned char) (i * 2654435761u >> 24);
+
+	Console::write_line(string_format("   AES instructions: %1, SHA instructions: %2",
+		System::detect_cpu_extension(System::aes) ? "yes" : "no",
+		System::detect_cpu_extension(System::sha) ? "yes" : "no"));
+
+	benchmark_hash<MD5>("MD5    ", data);
+	benchmark_hash<SHA1>("SHA-1  ", data);
+	benchmark_hash<SHA224>("SHA-224", data);
+	benchmark_hash<SHA256>("SHA-256", data);
+	benchmark_hash<SHA384>("SHA-384", data);
+	benchmark_hash<SHA512>("SHA-512", data);
+
+	benchmark_cipher<AES128_Encrypt, AES128_Decrypt>("AES-128", 16, data);
+	benchmark_cipher<AES192_Encrypt, AES192_Decrypt>("AES-192", 24, data);
+	benchmark_cipher<AES256_Encrypt, AES256_Decrypt>("AES-256", 32, data);
+
+	Console::write_line(" Benchmark: RSA");
+	Random random;
+	benchmark_exptmod(random, 2048);
+	benchmark_exptmod(random, 4096);
+	benchmark_rsa(random, 2048);
+}
@@ -118,6 +118,27 @@ void TestApp::test_rsa()
 	if (memcmp(server.m_CryptKey.get_data(), client.m_CryptKey.get_data(), server.m_CryptKey.get_size()))
 		fail();
 
+	Console::write_line("   ... Decrypting with the chinese remainder theorem");
+	{
+		Random random;
+		Secret private_exponent, prime1, prime2, exponent1, exponent2, coefficient;
+		DataBuffer public_exponent, modulus;
+		RSA::create_keypair(random, private_exponent, public_exponent, modulus, prime1, prime2, exponent1, exponent2, coefficient);
+
+		Secret message(32);
+		random.get_random_bytes(message.get_data(), message.get_size());
+		DataBuffer encrypted = RSA::encrypt(2, random, public_exponent, modulus, message);
+
+		Secret decrypted = RSA::decrypt(private_exponent, modulus, encrypted);
+		Secret decrypted_crt = RSA::decrypt(prime1, prime2, exponent1, exponent2, coefficient, encrypted);
+		Secret decrypted_crt_raw = RSA::decrypt(prime1, prime2, exponent1, exponent2, coefficient, encrypted.get_data(), encrypted.get_size());
+		if (decrypted.get_size() != message.get_size() || decrypted_crt.get_size() != message.get_size() || decrypted_crt_raw.get_size() != message.get_size())
+			fail();
+		if (memcmp(decrypted.get_data(), message.get_data(), message.get_size()))
+			fail();
+		if (memcmp(decrypted_crt.get_data(), message.get_data(), message.get_size()))
+			fail();
+		if (memcmp(decrypted_crt_raw.get_data(), message.get_data(), message.get_size()))
+			fail();
+	}
 }
-
-
@@ -0,0 +1,229 @@
+#include <ClanLib/core.h>
+#include "../../test_check.h"
+using namespace clan;
+
+// Checks memory mapped File access and stored zip entries served from the mapping, and measures the time it takes
+// to load a content set through regular reads and through the mappings.
+
+const std::string content_dir = "mappedfile_content";
+const std::string content_zip = "mappedfile_content.zip";
+const int num_content_files = 400;
+const int content_file_size = 128 * 1024;
+
+DataBuffer create_content(int index, int size)
+{
+	DataBuffer data(size);
+	for (int i = 0; i < size; i++)
+		data.get_data()[i] = (char) ((i * 31 + index * 7) >> 3);
+	return data;
+}
+
+bool equals(const char *data, const DataBuffer &expected)
+{
+	return data && memcmp(data, expected.get_data(), expected.get_size()) == 0;
+}
+
+void test_file()
+{
+	Console::write_line("Checking memory mapped files");
+
+	std::string filename = "mappedfile_test.bin";
+	DataBuffer content = create_content(1, 10000);
+	File::write_bytes(filename, content);
+
+	File file(filename, File::open_existing, File::access_read, File::share_all, File::flag_memory_mapped | File::flag_sequential_scan);
+	check(file.get_size() == 10000, "Wrong size");
+	check(equals(File::get_mapped_data(file), content), "Wrong mapped data");
+
+	char buffer[100];
+	check(file.peek(buffer, 100) == 100 && memcmp(buffer, content.get_data(), 100) == 0, "Wrong peeked data");
+	check(file.get_position() == 0, "Peek moved the position");
+	check(file.read(buffer, 100) == 100 && memcmp(buffer, content.get_data(), 100) == 0, "Wrong data read");
+	check(file.get_position() == 100, "Read did not move the position");
+
+	check(file.seek(-50, IODevice::seek_end) && file.get_position() == 9950, "seek_end failed");
+	check(file.read(buffer, 100, false) == 50 && memcmp(buffer, content.get_data() + 9950, 50) == 0, "Read past the end");
+	check(!file.seek(1, IODevice::seek_cur), "Seeked past the end");
+
+	IODevice copy = file.duplicate();
+	check(copy.get_position() == 0 && File::get_mapped_data(copy) == File::get_mapped_data(file), "Duplicate does not share the mapping");
+
+	bool write_failed = false;
+	try
+	{
+		file.write(buffer, 1);
+	}
+	catch (Exception &)
+	{
+		write_failed = true;
+	}
+	check(write_failed, "Wrote to a memory mapped file");
+
+	bool open_always_failed = false;
+	try
+	{
+		File created("mappedfile_created.bin", File::open_always, File::access_read, File::share_all, File::flag_memory_mapped);
+	}
+	catch (Exception &)
+	{
+		open_always_failed = true;
+	}
+	check(open_always_failed && !FileHelp::file_exists("mappedfile_created.bin"), "Mapped a file with open_always");
+
+	// Reopening switches between the regular and memory mapped providers
+	check(file.open(filename), "Unable to reopen file");
+	check(File::get_mapped_data(file) == nullptr && file.read(buffer, 100) == 100 && memcmp(buffer, content.get_data(), 100) == 0, "Regular reopen failed");
+	check(file.open(filename, File::open_existing, File::access_read, File::share_all, File::flag_memory_mapped | File::flag_will_need), "Unable to reopen file mapped");
+	check(equals(File::get_mapped_data(file), content), "Wrong mapped data after reopen");
+	check(!file.open("mappedfile_missing.bin", File::open_existing, File::access_read, File::share_all, File::flag_memory_mapped), "Opened a missing file");
+	file.close();
+	copy = IODevice();
+
+	File::write_bytes(filename, DataBuffer());
+	File empty(filename, File::open_existing, File::access_read, File::share_all, File::flag_memory_mapped);
+	check(empty.get_size() == 0 && File::get_mapped_data(empty) != nullptr && empty.read(buffer, 1, false) == 0, "Empty file failed");
+	empty.close();
+
+	FileHelp::delete_file(filename);
+}
+
+void create_content_set()
+{
+	Directory::create(content_dir);
+	ZipArchive archive;
+	for (int i = 0; i < num_content_files; i++)
+	{
+		std::string filename = string_format("%1/file%2.bin", content_dir, i);
+		File::write_bytes(filename, create_content(i, content_file_size));
+		archive.add_file(filename, string_format("file%1.bin", i));
+	}
+	archive.save(content_zip);
+}
+
+void remove_content_set()
+{
+	Directory::remove(content_dir, true);
+	if (FileHelp::file_exists(content_zip))
+		FileHelp::delete_file(content_zip);
+}
+
+void test_zip()
+{
+	Console::write_line("Checking stored zip entries");
+
+	ZipArchive archive(content_zip, true);
+	for (int i = 0; i < num_content_files; i += 37)
+	{
+		DataBuffer content = create_content(i, content_file_size);
+		IODevice entry = archive.open_file(string_format("file%1.bin", i));
+		check(entry.get_size() == content_file_size, "Wrong entry size");
+		check(equals(File::get_mapped_data(entry), content), "Entry is not served from the mapping");
+
+		DataBuffer data(entry.get_size());
+		check(entry.read(data.get_data(), data.get_size()) == content_file_size && memcmp(data.get_data(), content.get_data(), content_file_size) == 0, "Wrong entry data read");
+	}
+
+	// Archives on other devices still go through the regular entry reader
+	IODevice input = File(content_zip);
+	ZipArchive unmapped(input);
+	IODevice entry = unmapped.open_file("file1.bin");
+	check(File::get_mapped_data(entry) == nullptr, "Unmapped archive returned a mapped entry");
+	DataBuffer data(entry.get_size());
+	entry.read(data.get_data(), data.get_size());
+	DataBuffer content = create_content(1, content_file_size);
+	check(memcmp(data.get_data(), content.get_data(), content_file_size) == 0, "Wrong unmapped entry data");
+
+	// Mapping is opt-in for archives loaded by filename
+	ZipArchive regular(content_zip);
+	check(File::get_mapped_data(regular.open_file("file1.bin")) == nullptr, "Archive was mapped without asking for it");
+
+	// Saving over the mapped archive would truncate the file under the mapping
+	bool save_failed = false;
+	try
+	{
+		archive.save(content_zip);
+	}
+	catch (Exception &)
+	{
+		save_failed = true;
+	}
+	check(save_failed, "Saving over the mapped archive did not fail");
+	check(equals(File::get_mapped_data(archive.open_file("file1.bin")), content), "Mapped archive changed by failed save");
+}
+
+unsigned int checksum(const char *data, int size)
+{
+	unsigned int sum = 0;
+	for (int i = 0; i < size; i += 64)
+		sum += (unsigned char) data[i];
+	return sum;
+}
+
+void benchmark(const std::string &name, const std::function<unsigned int(int)> &load_file)
+{
+	ubyte64 start_time = System::get_microseconds();
+	unsigned int sum = 0;
+	for (int i = 0; i < num_content_files; i++)
+		sum += load_file(i);
+	ubyte64 time = System::get_microseconds() - start_time;
+	Console::write_line("   %1 %2 ms (checksum %3)", name, (int) (time / 1000), (int) sum);
+}
+
+int main(int, char**)
+{
+	SetupCore setup_core;
+
+	try
+	{
+		test_file();
+
+		create_content_set();
+		test_zip();
+
+		Console::write_line("Loading %1 files of %2 KB:", num_content_files, content_file_size / 1024);
+		benchmark("File::read_bytes          ", [](int i)
+		{
+			DataBuffer data = File::read_bytes(string_format("%1/file%2.bin", content_dir, i));
+			return checksum(data.get_data(), data.get_size());
+		});
+		benchmark("flag_memory_mapped        ", [](int i)
+		{
+			File file(string_format("%1/file%2.bin", content_dir, i), File::open_existing, File::access_read, File::share_all, File::flag_memory_mapped | File::flag_sequential_scan);
+			return checksum(File::get_mapped_data(file), file.get_size());
+		});
+		benchmark("flag_will_need            ", [](int i)
+		{
+			File file(string_format("%1/file%2.bin", content_dir, i), File::open_existing, File::access_read, File::share_all, File::flag_memory_mapped | File::flag_sequential_scan | File::flag_will_need);
+			return checksum(File::get_mapped_data(file), file.get_size());
+		});
+		{
+			IODevice input = File(content_zip);
+			ZipArchive archive(input);
+			benchmark("Zip entries, read         ", [&](int i)
+			{
+				IODevice entry = archive.open_file(string_format("file%1.bin", i));
+				DataBuffer data(entry.get_size());
+				entry.read(data.get_data(), data.get_size());
+				return checksum(data.get_data(), data.get_size());
+			});
+		}
+		{
+			ZipArchive archive(content_zip, true);
+			benchmark("Zip entries, memory mapped", [&](int i)
+			{
+				IODevice entry = archive.open_file(string_format("file%1.bin", i));
+				return checksum(File::get_mapped_data(entry), entry.get_size());
+			});
+		}
+
+		remove_content_set();
+		Console::write_line("Tests passed");
+	}
+	catch (Exception &e)
+	{
+		remove_content_set();
+		Console::write_line("Failed: %1", e.message);
+		return 1;
+	}
+	return 0;
+}
@@ -84,6 +84,7 @@ int TestApp::main(const std::vector<std::string> &args)
 		test_line_segment3();
 		test_triangle();
 		test_rect();
+		test_batch_math();
 	
 		Console::write_line("All Tests Complete");
 		console.display_close_message();
@@ -0,0 +1,157 @@
+/*
+**  ClanLib SDK
+**  Copyright (c) 1997-2015 The ClanLib Team
+**
+**  This software is provided 'as-is', without any express or implied
+**  warranty.  In no event will the authors be held liable for any damages
+**  arising from the use of this software.
+**
+**  Permission is granted to anyone to use this software for any purpose,
+**  including commercial applications, and to alter it and redistribute it
+**  freely, subject to the following restrictions:
+**
+**  1. The origin of this software must not be misrepresented; you must not
+**     claim that you wrote the original software. If you use this software
+**     in a product, an acknowledgment in the product documentation would be
+**     appreciated but is not required.
+**  2. Altered source versions must be plainly marked as such, and must not be
+**     misrepresented as being the original software.
+**  3. This notice may not be removed or altered from any source distribution.
+**
+**  Note: Some of the libraries ClanLib may link to may have additional
+**  requirements or restrictions.
+**
+**  File Author(s):
+**
+**    agent
+**    (if your name is missing here, please add it)
+*/
+
+#include "test.h"
+
+// Compares each instruction set against the scalar operators, for every remainder after the vector width
+
+static bool is_equal(float a, float b)
+{
+	return fabs(a - b) <= 0.0001f * max(1.0f, fabs(b));
+}
+
+static bool is_equal(const Vec2f &a, const Vec2f &b) { return is_equal(a.x, b.x) && is_equal(a.y, b.y); }
+static bool is_equal(const Vec3f &a, const Vec3f &b) { return is_equal(a.x, b.x) && is_equal(a.y, b.y) && is_equal(a.z, b.z); }
+static bool is_equal(const Vec4f &a, const Vec4f &b) { return is_equal(a.x, b.x) && is_equal(a.y, b.y) && is_equal(a.z, b.z) && is_equal(a.w, b.w); }
+
+void TestApp::test_batch_math()
+{
+	Console::write_line(" Header: batch_math.h");
+
+	const int max_count = 37;
+	std::vector<Vec4f> input4(max_count);
+	std::vector<Vec3f> input3(max_count);
+	std::vector<Vec2f> input2(max_count);
+	for (int i = 0; i < max_count; i++)
+	{
+		// Scattered, so the extremes of the bounding boxes end up in different lanes
+		input4[i] = Vec4f((i * 7 % 37) * 1.5f - 20.0f, 7.0f - (i * 11 % 37) * 0.25f, (i * 5 % 37) * 0.5f, 1.0f + (i % 3));
+		input3[i] = Vec3f(input4[i].x, input4[i].y, input4[i].z);
+		input2[i] = Vec2f(input4[i].x, input4[i].y);
+	}
+
+	Mat4f mat4 = Mat4f::perspective(60.0f, 1.5f, 0.1f, 100.0f, handed_left, clip_negative_positive_w) * Mat4f::translate(3.0f, -2.0f, 5.0f) * Mat4f::rotate(Angle(30.0f, angle_degrees), 0.0f, 0.0f, 1.0f, true);
+	Mat3f mat3(0.8f, 0.6f, 0.1f, -0.6f, 0.8f, 0.2f, 12.0f, -4.0f, 1.0f);
+
+	BatchMath::InstructionSet supported = BatchMath::get_instruction_set();
+	for (int set = BatchMath::scalar; set <= supported; set++)
+	{
+		BatchMath::set_max_instruction_set((BatchMath::InstructionSet)set);
+		Console::write_line(string_format("   Instruction set: %1", set));
+
+		for (int count = 0; count <= max_count; count++)
+		{
+			std::vector<Vec4f> output4(max_count + 1, Vec4f(-1.0f));
+			BatchMath::transform(mat4, &input2[0], &output4[0], count);
+			for (int i = 0; i < count; i++)
+			{
+				if (!is_equal(output4[i], mat4 * Vec4f(input2[i].x, input2[i].y, 0.0f, 1.0f))) fail();
+			}
+			if (output4[count] != Vec4f(-1.0f)) fail();
+
+			BatchMath::transform(mat4, &input3[0], &output4[0], count);
+			for (int i = 0; i < count; i++)
+			{
+				if (!is_equal(output4[i], mat4 * Vec4f(input3[i].x, input3[i].y, input3[i].z, 1.0f))) fail();
+			}
+			if (output4[count] != Vec4f(-1.0f)) fail();
+
+			BatchMath::transform(mat4, &input4[0], &output4[0], count);
+			for (int i = 0; i < count; i++)
+			{
+				if (!is_equal(output4[i], mat4 * input4[i])) fail();
+			}
+			if (output4[count] != Vec4f(-1.0f)) fail();
+
+			std::vector<Vec2f> output2(input2);
+			BatchMath::transform(mat3, &output2[0], &output2[0], count);
+			for (int i = 0; i < max_count; i++)
+			{
+				if (!is_equal(output2[i], i < count ? mat3 * input2[i] : input2[i])) fail();
+			}
+
+			std::vector<Vec3f> output3(max_count + 1, Vec3f(-1.0f));
+			BatchMath::transform(mat3, &input3[0], &output3[0], count);
+			for (int i = 0; i < count; i++)
+			{
+				if (!is_equal(output3[i], mat3 * input3[i])) fail();
+			}
+			if (output3[count] != Vec3f(-1.0f)) fail();
+
+			if (count > 0)
+			{
+				Rectf box = BatchMath::bounding_box(&input2[0], count);
+				AxisAlignedBoundingBox box3 = BatchMath::bounding_box(&input3[0], count);
+				Vec2f expected_min = input2[0], expected_max = input2[0];
+				Vec3f expected_min3 = input3[0], expected_max3 = input3[0];
+				for (int i = 1; i < count; i++)
+				{
+					expected_min = min(expected_min, input2[i]);
+					expected_max = max(expected_max, input2[i]);
+					expected_min3 = min(expected_min3, input3[i]);
+					expected_max3 = max(expected_max3, input3[i]);
+				}
+				if (box != Rectf(expected_min.x, expected_min.y, expected_max.x, expected_max.y)) fail();
+				if (box3.aabb_min != expected_min3 || box3.aabb_max != expected_max3) fail();
+			}
+
+			std::vector<float> x(count + 1), y(count + 1), z(count + 1), w(count + 1);
+			BatchMath::deinterleave(&input2[0], &x[0], &y[0], count);
+			std::vector<Vec2f> points(count + 1);
+			BatchMath::interleave(&x[0], &y[0], &points[0], count);
+			for (int i = 0; i < count; i++)
+			{
+				if (x[i] != input2[i].x || y[i] != input2[i].y || points[i] != input2[i]) fail();
+			}
+
+			BatchMath::deinterleave(&input4[0], &x[0], &y[0], &z[0], &w[0], count);
+			std::vector<Vec4f> vectors(count + 1);
+			BatchMath::interleave(&x[0], &y[0], &z[0], &w[0], &vectors[0], count);
+			for (int i = 0; i < count; i++)
+			{
+				if (x[i] != input4[i].x || y[i] != input4[i].y || z[i] != input4[i].z || w[i] != input4[i].w || vectors[i] != input4[i]) fail();
+			}
+		}
+
+		// Writing into an interleaved vertex array
+		struct Vertex
+		{
+			Vec4f position;
+			Vec2f texcoord;
+		};
+		std::vector<Vertex> vertices(max_count);
+		BatchMath::transform(mat4, &input2[0], &vertices[0].position, max_count, sizeof(Vertex));
+		for (int i = 0; i < max_count; i++)
+		{
+			if (!is_equal(vertices[i].position, mat4 * Vec4f(input2[i].x, input2[i].y, 0.0f, 1.0f))) fail();
+		}
+	}
+	BatchMath::set_max_instruction_set(BatchMath::avx512);
+	if (BatchMath::bounding_box((const Vec2f *)nullptr, 0) != Rectf()) fail();
+}
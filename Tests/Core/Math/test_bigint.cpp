@@ -330,4 +330,64 @@ void TestApp::test_bigint(void)
 		if (!value.is_even())
 			fail();
 	}
+
+	Console::write_line("   Function: large operator * and sqr()");
+	{
+		// Large enough for the Karatsuba multiplication, with unbalanced sizes
+		BigInt value1;
+		BigInt value2;
+		for (int i = 0; i < 4000; i += 3)
+			value1.set_bit(i, 1);
+		for (int i = 0; i < 2500; i += 7)
+			value2.set_bit(i, 1);
+
+		BigInt product = value1 * value2;
+		BigInt quotient = product / value2;
+		if (quotient.cmp(&value1) != 0)
+			fail();
+		BigInt remainder = product % value2;
+		if (remainder.cmp_z() != 0)
+			fail();
+
+		BigInt square;
+		value1.sqr(&square);
+		BigInt square_product = value1 * value1;
+		if (square.cmp(&square_product) != 0)
+			fail();
+	}
+
+	Console::write_line("   Function: exptmod()");
+	{
+		BigInt base(3);
+		BigInt exponent(200);
+		BigInt modulus(1000003);
+		BigInt result;
+		base.exptmod(&exponent, &modulus, &result);
+		ubyte32 value;
+		result.get(value);
+		if (value != 333986)	// 3^200 mod 1000003
+			fail();
+
+		// Fermat's little theorem with the prime 2^521 - 1
+		BigInt prime;
+		for (int i = 0; i < 521; i++)
+			prime.set_bit(i, 1);
+		BigInt prime_minus_one = prime - 1;
+		BigInt large_base(123456789);
+		large_base.exptmod(&prime_minus_one, &prime, &result);
+		if (result.cmp_d(1) != 0)
+			fail();
+
+		// The odd modulus (Montgomery) and even modulus (Barrett) paths must agree
+		BigInt odd_modulus = prime * BigInt(1000003);
+		BigInt even_modulus = odd_modulus * 2;
+		BigInt large_exponent = prime - 12345;
+		BigInt odd_result, even_result;
+		large_base.exptmod(&large_exponent, &odd_modulus, &odd_result);
+		large_base.exptmod(&large_exponent, &even_modulus, &even_result);
+		even_result.mod(&odd_modulus, &even_result);
+		if (odd_result.cmp(&even_result) != 0)
+			fail();
+	}
 }
+
@@ -0,0 +1,267 @@
+#include <ClanLib/core.h>
+#include <thread>
+#include <set>
+#include <atomic>
+#include "../../test_check.h"
+using namespace clan;
+
+// Checks the zones, counters and frame markers recorded by Profiler and the exported Chrome trace,
+// and measures the cost of a zone with the profiler enabled and disabled.
+
+std::vector<JsonValue> get_trace_events()
+{
+	JsonValue trace = JsonValue::from_json(Profiler::get_chrome_trace());
+	return trace["traceEvents"].get_items();
+}
+
+std::vector<JsonValue> find_events(const std::vector<JsonValue> &events, const std::string &name, const std::string &phase)
+{
+	std::vector<JsonValue> found;
+	for (auto &event : events)
+	{
+		if (event.get_members().at("name").to_string() == name && event.get_members().at("ph").to_string() == phase)
+			found.push_back(event);
+	}
+	return found;
+}
+
+double get_number(const JsonValue &event, const char *key)
+{
+	return event.get_members().at(key).to_double();
+}
+
+void test_zones()
+{
+	Console::write_line("Checking nested zones");
+
+	Profiler::clear();
+	Profiler::set_thread_name("Main thread");
+	{
+		cl_profile_zone("Outer");
+		for (int i = 0; i < 3; i++)
+		{
+			cl_profile_zone("Inner");
+			System::sleep(1);
+		}
+		Profiler::set_gauge("Gauge", 2.5);
+	}
+	Profiler::frame_mark();
+
+	std::vector<JsonValue> events = get_trace_events();
+	std::vector<JsonValue> outer = find_events(events, "Outer", "X");
+	std::vector<JsonValue> inner = find_events(events, "Inner", "X");
+	check(outer.size() == 1 && inner.size() == 3, "Wrong number of zones");
+
+	double outer_start = get_number(outer[0], "ts");
+	double outer_end = outer_start + get_number(outer[0], "dur");
+	for (auto &zone : inner)
+	{
+		double start = get_number(zone, "ts");
+		check(get_number(zone, "dur") >= 900.0, "Zone is shorter than the sleep inside it");
+		check(start >= outer_start && start + get_number(zone, "dur") <= outer_end, "Inner zone is not inside the outer zone");
+		check(get_number(zone, "tid") == get_number(outer[0], "tid"), "Zones were recorded on different threads");
+	}
+
+	std::vector<JsonValue> gauges = find_events(events, "Gauge", "C");
+	check(gauges.size() == 1 && gauges[0]["args"]["value"].to_double() == 2.5, "Gauge is missing");
+	std::vector<JsonValue> frames = find_events(events, "Frame", "i");
+	check(frames.size() == 1 && get_number(frames[0], "ts") >= outer_end, "Frame marker is missing");
+
+	std::vector<JsonValue> names = find_events(events, "thread_name", "M");
+	check(names.size() == 1 && names[0]["args"]["name"].to_string() == "Main thread", "Thread name is missing");
+}
+
+void test_disabled()
+{
+	Console::write_line("Checking that nothing is recorded while disabled");
+
+	Profiler::clear();
+	Profiler::set_enabled(false);
+	{
+		cl_profile_zone("Disabled");
+		Profiler::frame_mark();
+	}
+	Profiler::set_enabled(true);
+	check(find_events(get_trace_events(), "Disabled", "X").empty(), "Zone was recorded while disabled");
+	check(find_events(get_trace_events(), "Frame", "i").empty(), "Frame was recorded while disabled");
+}
+
+void test_threads()
+{
+	Console::write_line("Checking zones and counters on several threads");
+
+	Profiler::clear();
+	const int num_threads = 4;
+	const int zones_per_thread = 1000;
+	ProfilerCounter counter("Counter");
+	std::vector<std::thread> threads;
+	for (int i = 0; i < num_threads; i++)
+	{
+		threads.push_back(std::thread([&]()
+		{
+			for (int j = 0; j < zones_per_thread; j++)
+			{
+				cl_profile_zone("Thread zone \"quoted\"");
+				counter.add();
+			}
+		}));
+	}
+	for (auto &thread : threads)
+		thread.join();
+
+	std::vector<JsonValue> events = get_trace_events();
+	std::vector<JsonValue> zones = find_events(events, "Thread zone \"quoted\"", "X");
+	check(zones.size() == num_threads * zones_per_thread, string_format("%1 zones recorded", (int) zones.size()));
+
+	std::set<int> thread_ids;
+	for (auto &zone : zones)
+		thread_ids.insert((int) get_number(zone, "tid"));
+	check(thread_ids.size() == num_threads, "Threads share a thread id");
+
+	double last_value = 0.0;
+	for (auto &sample : find_events(events, "Counter", "C"))
+		last_value = max(last_value, sample["args"]["value"].to_double());
+	check(counter.get() == num_threads * zones_per_thread && last_value == counter.get(), "Counter has the wrong value");
+}
+
+void test_wraparound()
+{
+	Console::write_line("Checking that the ring buffer keeps the most recent events");
+
+	Profiler::clear();
+	Profiler::set_buffer_size(100);
+	std::thread thread([]()
+	{
+		Profiler::set_thread_name("Small buffer");
+		cl_profile_zone("Unfinished");
+		for (int i = 0; i < 1000; i++)
+		{
+			cl_profile_zone("Wrapped");
+		}
+		Profiler::frame_mark("Last");
+	});
+	thread.join();
+	Profiler::set_buffer_size(16384);
+
+	std::vector<JsonValue> events = get_trace_events();
+	int wrapped = (int) find_events(events, "Wrapped", "X").size();
+	check(wrapped == 63, string_format("%1 zones kept in a 128 event buffer", wrapped));
+	check(find_events(events, "Last", "i").size() == 1, "Most recent event is missing");
+	check(find_events(events, "Unfinished", "X").empty() && find_events(events, "Unfinished", "B").empty(), "Overwritten zone start was exported");
+}
+
+void test_unfinished()
+{
+	Console::write_line("Checking zones that are still running");
+
+	Profiler::clear();
+	cl_profile_zone("Running");
+	check(find_events(get_trace_events(), "Running", "B").size() == 1, "Running zone was not exported");
+}
+
+void test_exited_threads()
+{
+	Console::write_line("Checking that exited threads are exported once and their buffers reused");
+
+	Profiler::clear();
+	for (int round = 0; round < 50; round++)
+	{
+		for (int i = 0; i < 4; i++)
+		{
+			std::thread thread([=]()
+			{
+				Profiler::set_thread_name(string_format("Round %1", round));
+				cl_profile_zone("Short lived");
+			});
+			thread.join();
+		}
+
+		std::vector<JsonValue> events = get_trace_events();
+		check(find_events(events, "Short lived", "X").size() == 4, "Zones of exited threads were not exported exactly once");
+		for (auto &name : find_events(events, "thread_name", "M"))
+			check(name["args"]["name"].to_string() != string_format("Round %1", round - 1), "Exited thread was exported twice");
+	}
+}
+
+void test_export_while_recording()
+{
+	Console::write_line("Checking exports while another thread records");
+
+	Profiler::clear();
+	Profiler::set_buffer_size(256);
+	std::atomic<bool> stop(false);
+	std::thread thread([&]()
+	{
+		while (!stop.load())
+		{
+			cl_profile_zone("Busy");
+			Profiler::set_gauge("Busy gauge", 1.0);
+		}
+	});
+
+	for (int i = 0; i < 200; i++)
+	{
+		for (auto &event : get_trace_events())
+		{
+			std::string name = event.get_members().at("name").to_string();
+			check(name == "Busy" || name == "Busy gauge" || name == "thread_name", "Torn event name: " + name);
+			if (name == "Busy" && event.get_members().at("ph").to_string() == "X")
+				check(get_number(event, "dur") >= 0.0 && get_number(event, "dur") < 1.0e6, "Torn zone duration");
+			if (name == "Busy gauge")
+				check(event["args"]["value"].to_double() == 1.0, "Torn gauge value");
+		}
+	}
+
+	stop.store(true);
+	thread.join();
+	Profiler::set_buffer_size(16384);
+	Profiler::clear();
+}
+
+void benchmark(bool enabled)
+{
+	Profiler::set_enabled(enabled);
+	Profiler::clear();
+
+	const int iterations = 1000000;
+	ubyte64 start_time = System::get_nanoseconds();
+	for (int i = 0; i < iterations; i++)
+	{
+		cl_profile_zone("Benchmark");
+	}
+	ubyte64 end_time = System::get_nanoseconds();
+	Console::write_line("   %1 %2 ns per zone", enabled ? "enabled: " : "disabled:", (end_time - start_time) / (double) iterations);
+}
+
+int main(int, char**)
+{
+	SetupCore setup_core;
+
+	try
+	{
+		Profiler::set_enabled(true);
+		test_zones();
+		test_disabled();
+		test_threads();
+		test_wraparound();
+		test_unfinished();
+		test_exited_threads();
+		test_export_while_recording();
+
+		Console::write_line("Zone cost:");
+		benchmark(false);
+		benchmark(true);
+
+		ubyte64 start_time = System::get_microseconds();
+		std::string trace = Profiler::get_chrome_trace();
+		Console::write_line("   exporting %1 KB of trace took %2 ms", (int) (trace.size() / 1024), (System::get_microseconds() - start_time) / 1000.0);
+
+		Console::write_line("Tests passed");
+	}
+	catch (Exception &e)
+	{
+		Console::write_line("Failed: %1", e.message);
+		return 1;
+	}
+	return 0;
+}
@@ -1,6 +1,94 @@
 #include <ClanLib/core.h>
+#include <algorithm>
 using namespace clan;
 
+// Packs a sequence of rect sizes with each packing method, reporting inserts per second and the
+// occupancy of the filled groups. Then every second rect is removed and added again, which should
+// mostly end up in the freed space rather than in new groups.
+
+std::vector<Size> create_sizes(int count, int min_size, int max_size, bool square)
+{
+	std::vector<Size> sizes;
+	unsigned int seed = 12345;
+	for (int i = 0; i < count; i++)
+	{
+		seed = seed * 1103515245 + 12345;
+		int width = min_size + (seed >> 16) % (max_size - min_size + 1);
+		seed = seed * 1103515245 + 12345;
+		int height = square ? width : min_size + (seed >> 16) % (max_size - min_size + 1);
+		sizes.push_back(Size(width, height));
+	}
+	return sizes;
+}
+
+bool is_valid(std::vector<RectPacker::AllocatedRect> rects, const Size &group_size)
+{
+	std::sort(rects.begin(), rects.end(), [](const RectPacker::AllocatedRect &a, const RectPacker::AllocatedRect &b) {
+		return a.group_index != b.group_index ? a.group_index < b.group_index : a.rect.left < b.rect.left;
+	});
+
+	Rect area(Point(0, 0), group_size);
+	for (size_t i = 0; i < rects.size(); i++)
+	{
+		if (!area.is_inside(rects[i].rect))
+			return false;
+		for (size_t j = i + 1; j < rects.size() && rects[j].group_index == rects[i].group_index && rects[j].rect.left < rects[i].rect.right; j++)
+		{
+			if (rects[i].rect.is_overlapped(rects[j].rect))
+				return false;
+		}
+	}
+	return true;
+}
+
+float get_full_group_occupancy(RectPacker &packer)
+{
+	// The last group is still being filled
+	int full_groups = std::max(packer.get_group_count() - 1, 1);
+	float occupancy = 0.0f;
+	for (int i = 0; i < full_groups; i++)
+		occupancy += packer.get_occupancy(i);
+	return occupancy / full_groups;
+}
+
+void benchmark(const char *name, RectPacker::PackingMethod method, const Size &group_size, const std::vector<Size> &sizes)
+{
+	RectPacker packer(group_size, RectPacker::create_new_group, method);
+	std::vector<RectPacker::AllocatedRect> rects;
+
+	ubyte64 start_time = System::get_microseconds();
+	for (const auto &size : sizes)
+		rects.push_back(packer.add(size));
+	ubyte64 end_time = System::get_microseconds();
+	int groups = packer.get_group_count();
+	float occupancy = get_full_group_occupancy(packer);
+	bool valid = is_valid(rects, group_size);
+
+	// Free every second rect and add them again
+	packer.set_allocation_policy(RectPacker::search_previous_groups);
+	for (size_t i = 1; i < rects.size(); i += 2)
+		packer.remove(rects[i]);
+	ubyte64 reinsert_start_time = System::get_microseconds();
+	for (size_t i = 1; i < rects.size(); i += 2)
+		rects[i] = packer.add(sizes[i]);
+	ubyte64 reinsert_end_time = System::get_microseconds();
+	valid = valid && is_valid(rects, group_size) && packer.get_total_rect_count() == (int)rects.size();
+
+	std::cout << "  " << name << ": " << groups << " groups, occupancy " << (int)(occupancy * 100.0f) << "%, "
+		<< (int)(sizes.size() / ((end_time - start_time + 1) / 1000000.0)) << " inserts/sec. "
+		<< "Reinserted: " << packer.get_group_count() << " groups, occupancy " << (int)(get_full_group_occupancy(packer) * 100.0f) << "%, "
+		<< (int)(sizes.size() / 2 / ((reinsert_end_time - reinsert_start_time + 1) / 1000000.0)) << " inserts/sec"
+		<< (valid ? "" : " - OVERLAPPING RECTS") << std::endl;
+}
+
+void benchmark_methods(const char *name, const Size &group_size, const std::vector<Size> &sizes)
+{
+	std::cout << std::endl << "Benchmark " << name << ":" << std::endl;
+	benchmark("guillotine         ", RectPacker::guillotine, group_size, sizes);
+	benchmark("skyline_bottom_left", RectPacker::skyline_bottom_left, group_size, sizes);
+	benchmark("max_rects          ", RectPacker::max_rects, group_size, sizes);
+}
+
 int main(void)
 {
 	SetupCore setup_core;
@@ -97,6 +185,32 @@ int main(void)
 	{
 		std::cout << "Expected: " << e.message.c_str() << std::endl;		
 	}
+
+	try
+	{
+		std::cout << std::endl << "Testing remove:" << std::endl;
+
+		RectPacker packer(Size(100,100), RectPacker::fail_if_full, RectPacker::skyline_bottom_left);
+		RectPacker::AllocatedRect allocation1 = packer.add(Size(100,50));
+		RectPacker::AllocatedRect allocation2 = packer.add(Size(100,50));
+		packer.remove(allocation1);
+		RectPacker::AllocatedRect allocation3 = packer.add(Size(50,50));
+		RectPacker::AllocatedRect allocation4 = packer.add(Size(50,50));
+
+		std::cout << "Expected: Allocation OK" << std::endl;
+		std::cout << "allocation3: Id: " << allocation3.group_index << " Pos: " << allocation3.rect.left << ", " << allocation3.rect.top << std::endl;
+		std::cout << "allocation4: Id: " << allocation4.group_index << " Pos: " << allocation4.rect.left << ", " << allocation4.rect.top << std::endl;
+		std::cout << "occupancy: " << packer.get_occupancy() << std::endl;
+	}
+	catch (Exception &e)
+	{
+		std::cout << "Did not expect: Allocation failed: " << e.message.c_str() << std::endl;		
+	}
+
+	benchmark_methods("glyphs (20000 rects of 6-32 pixels into 512x512)", Size(512, 512), create_sizes(20000, 6, 32, false));
+	benchmark_methods("sprites (5000 rects of 16-128 pixels into 2048x2048)", Size(2048, 2048), create_sizes(5000, 16, 128, false));
+	benchmark_methods("tiles (20000 squares of 8-24 pixels into 1024x1024)", Size(1024, 1024), create_sizes(20000, 8, 24, true));
+
 	return 0;
 }
 
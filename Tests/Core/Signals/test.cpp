@@ -0,0 +1,183 @@
+#include <ClanLib/core.h>
+#include "../../test_check.h"
+using namespace clan;
+
+// Checks connecting, disconnecting and emitting signals, also from within the callbacks, and measures
+// the cost of an emit for different numbers of slots.
+
+class Receiver
+{
+public:
+	Receiver() : total(0) { }
+	void on_value(int value) { total += value; }
+	int total;
+};
+
+void test_emit()
+{
+	Console::write_line("Checking emit order and arguments");
+
+	Signal<void(int, const std::string &)> signal;
+	std::string calls;
+	Slot slot1 = signal.connect([&](int value, const std::string &text) { calls += string_format("a%1%2 ", value, text); });
+	Slot slot2 = signal.connect([&](int value, const std::string &text) { calls += string_format("b%1%2 ", value, text); });
+
+	Receiver receiver;
+	Signal<void(int)> member_signal;
+	Slot slot3 = member_signal.connect(&receiver, &Receiver::on_value);
+
+	signal(1, "x");
+	signal(2, std::string("y"));
+	member_signal(5);
+	member_signal(6);
+	check(calls == "a1x b1x a2y b2y ", "Wrong calls: " + calls);
+	check(receiver.total == 11, "Member function was not called");
+}
+
+void test_disconnect()
+{
+	Console::write_line("Checking disconnecting slots");
+
+	Signal<void()> signal;
+	std::string calls;
+	std::vector<Slot> slots;
+	for (int i = 0; i < 10; i++)
+		slots.push_back(signal.connect([&calls, i]() { calls += string_format("%1", i); }));
+
+	slots[3] = Slot();
+	slots[7] = Slot();
+	signal();
+	check(calls == "01245689", "Wrong calls after disconnecting: " + calls);
+
+	// Enough slots are removed for the list to be compacted
+	calls.clear();
+	for (int i = 0; i < 8; i++)
+		slots[i] = Slot();
+	slots.push_back(signal.connect([&]() { calls += "n"; }));
+	signal();
+	check(calls == "89n", "Wrong calls after compacting: " + calls);
+
+	// A slot outliving its signal
+	Slot late_slot;
+	{
+		Signal<void()> local_signal;
+		late_slot = local_signal.connect([]() { });
+	}
+	late_slot = Slot();
+
+	// The callback is destroyed when the slot is
+	std::shared_ptr<int> counter = std::make_shared<int>(0);
+	Slot slot = signal.connect([counter]() { });
+	check(counter.use_count() == 2, "Callback was not stored");
+	slot = Slot();
+	check(counter.use_count() == 1, "Callback was not destroyed on disconnect");
+}
+
+void test_changes_during_emit()
+{
+	Console::write_line("Checking changes to the signal during emit");
+
+	Signal<void()> signal;
+	std::string calls;
+	Slot slot_a, slot_b, slot_c, slot_added;
+
+	// a disconnects itself and b, and connects a new slot. c emits again, which invokes the new slot.
+	slot_a = signal.connect([&]()
+	{
+		calls += "a";
+		slot_a = Slot();
+		slot_b = Slot();
+		slot_added = signal.connect([&]() { calls += "n"; });
+		calls += "a";	// The running callback is still alive
+	});
+	slot_b = signal.connect([&]() { calls += "b"; });
+	slot_c = signal.connect([&]() { calls += "c"; if (calls.length() < 4) signal(); });
+
+	signal();
+	check(calls == "aaccn", "Wrong calls: " + calls);
+
+	calls.clear();
+	slot_c = Slot();
+	signal();
+	check(calls == "n", "Wrong calls on the second emit: " + calls);
+
+	// A callback destroying its own signal
+	Signal<void()> *owned_signal = new Signal<void()>();
+	int count = 0;
+	Slot slot_delete = owned_signal->connect([&]() { count++; delete owned_signal; });
+	Slot slot_after = owned_signal->connect([&]() { count++; });
+	(*owned_signal)();
+	check(count == 2, "Emit did not complete after the signal was destroyed");
+
+	// A throwing callback leaves the signal usable
+	Signal<void()> throwing_signal;
+	bool thrown = false;
+	Slot slot_throw = throwing_signal.connect([&]() { if (!thrown) { thrown = true; slot_throw = Slot(); throw Exception("Test"); } });
+	try
+	{
+		throwing_signal();
+	}
+	catch (Exception &)
+	{
+	}
+	Slot slot_next = throwing_signal.connect([&]() { count++; });
+	throwing_signal();
+	check(thrown && count == 3, "Signal did not recover from a throwing callback");
+}
+
+void benchmark()
+{
+	Console::write_line("Emit cost:");
+
+	int total = 0;
+	for (int num_slots : { 0, 1, 4, 16, 64, 256 })
+	{
+		Signal<void(int)> signal;
+		std::vector<Slot> slots;
+		for (int i = 0; i < num_slots; i++)
+			slots.push_back(signal.connect([&total](int value) { total += value; }));
+
+		const int iterations = 2000000 / (num_slots + 1);
+		ubyte64 start_time = System::get_nanoseconds();
+		for (int i = 0; i < iterations; i++)
+			signal(1);
+		ubyte64 elapsed = System::get_nanoseconds() - start_time;
+		Console::write_line("   %1 slots: %2 ns per emit", num_slots, (int) (elapsed / iterations));
+	}
+	check(total > 0, "No slots were invoked");
+
+	const int num_slots = 100000;
+	Signal<void(int)> signal;
+	std::vector<Slot> slots;
+	ubyte64 start_time = System::get_nanoseconds();
+	for (int i = 0; i < num_slots; i++)
+		slots.push_back(signal.connect([&total](int value) { total += value; }));
+	ubyte64 connected_time = System::get_nanoseconds();
+	for (int i = 0; i < num_slots; i += 2)
+		slots[i] = Slot();
+	for (int i = num_slots - 1; i > 0; i -= 2)
+		slots[i] = Slot();
+	ubyte64 disconnected_time = System::get_nanoseconds();
+	Console::write_line("   %1 slots: connect %2 ns, disconnect %3 ns per slot", num_slots, (int) ((connected_time - start_time) / num_slots), (int) ((disconnected_time - connected_time) / num_slots));
+}
+
+int main(int, char**)
+{
+	SetupCore setup_core;
+
+	try
+	{
+		test_emit();
+		test_disconnect();
+		test_changes_during_emit();
+		benchmark();
+
+		Console::write_line("Tests passed");
+	}
+	catch (Exception &e)
+	{
+		Console::write_line("Failed: %1", e.message);
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,142 @@
+#include <ClanLib/core.h>
+#include "../../test_check.h"
+using namespace clan;
+
+// Checks Timer expiry, repeating, stopping and sub-millisecond timeouts, and measures starting, stopping
+// and expiring 100k timers.
+
+// Processes timer callbacks until the condition is true or the timeout has passed
+template<typename Condition>
+bool process_until(Condition condition, int timeout)
+{
+	ubyte64 end_time = System::get_time() + timeout;
+	while (!condition())
+	{
+		if (System::get_time() > end_time)
+			return false;
+		KeepAlive::process(1);
+	}
+	return true;
+}
+
+void test_single_shot()
+{
+	Console::write_line("Checking single shot timers");
+
+	int count = 0;
+	Timer timer;
+	timer.func_expired() = [&]() { count++; };
+
+	ubyte64 start_time = System::get_microseconds();
+	timer.start(20, false);
+	check(process_until([&]() { return count > 0; }, 1000), "Timer did not expire");
+	ubyte64 elapsed = System::get_microseconds() - start_time;
+	check(elapsed >= 20000, string_format("Timer expired early, after %1 us", (int) elapsed));
+
+	KeepAlive::process(50);
+	check(count == 1, "Single shot timer expired more than once");
+}
+
+void test_repeating()
+{
+	Console::write_line("Checking repeating timers");
+
+	int count = 0;
+	Timer timer;
+	timer.func_expired() = [&]() { if (++count == 5) timer.stop(); };
+	timer.start(5, true);
+	check(timer.is_repeating() && timer.get_timeout() == 5, "Wrong timer attributes");
+	check(process_until([&]() { return count == 5; }, 1000), "Repeating timer did not expire five times");
+
+	KeepAlive::process(50);
+	check(count == 5, "Timer expired after being stopped in its callback");
+
+	timer.start(5, false);
+	check(process_until([&]() { return count == 6; }, 1000), "Timer did not restart");
+}
+
+void test_stop()
+{
+	Console::write_line("Checking stopped and destroyed timers");
+
+	int count = 0;
+	Timer timer;
+	timer.func_expired() = [&]() { count++; };
+	timer.start(10, false);
+	timer.stop();
+
+	{
+		Timer destroyed_timer;
+		destroyed_timer.func_expired() = [&]() { count++; };
+		destroyed_timer.start(10, false);
+	}
+
+	KeepAlive::process(50);
+	check(count == 0, "Stopped timer expired");
+}
+
+void test_microseconds()
+{
+	Console::write_line("Checking sub-millisecond timers");
+
+	std::vector<ubyte64> expire_times;
+	Timer short_timer, long_timer;
+	ubyte64 start_time = System::get_nanoseconds();
+	short_timer.func_expired() = [&]() { expire_times.push_back(System::get_nanoseconds() - start_time); };
+	long_timer.func_expired() = [&]() { expire_times.push_back(System::get_nanoseconds() - start_time); };
+	long_timer.start_microseconds(2700, false);
+	short_timer.start_microseconds(2300, false);
+
+	check(process_until([&]() { return expire_times.size() == 2; }, 1000), "Timers did not expire");
+	check(expire_times[0] >= 2300000 && expire_times[1] >= 2700000, "Timer expired early");
+}
+
+void benchmark()
+{
+	const int num_timers = 100000;
+	Console::write_line("Benchmarking %1 timers:", num_timers);
+
+	std::vector<Timer> timers(num_timers);
+	int count = 0;
+	for (auto &timer : timers)
+		timer.func_expired() = [&]() { count++; };
+
+	ubyte64 start_time = System::get_microseconds();
+	for (int i = 0; i < num_timers; i++)
+		timers[i].start(10000 + i % 1000, false);
+	ubyte64 started_time = System::get_microseconds();
+	for (auto &timer : timers)
+		timer.stop();
+	ubyte64 stopped_time = System::get_microseconds();
+	Console::write_line("   start %1 ns per timer, stop %2 ns per timer", (int) ((started_time - start_time) * 1000 / num_timers), (int) ((stopped_time - started_time) * 1000 / num_timers));
+
+	// Spread the timeouts over half a second
+	start_time = System::get_microseconds();
+	for (int i = 0; i < num_timers; i++)
+		timers[i].start(1 + i % 500, false);
+	check(process_until([&]() { return count == num_timers; }, 5000), string_format("%1 of %2 timers expired", count, num_timers));
+	ubyte64 expired_time = System::get_microseconds() - start_time;
+	Console::write_line("   all timers spread over 500 ms expired after %1 ms", (int) (expired_time / 1000));
+}
+
+int main(int, char**)
+{
+	SetupCore setup_core;
+
+	try
+	{
+		test_single_shot();
+		test_repeating();
+		test_stop();
+		test_microseconds();
+		benchmark();
+
+		Console::write_line("Tests passed");
+	}
+	catch (Exception &e)
+	{
+		Console::write_line("Failed: %1", e.message);
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,335 @@
+#include <ClanLib/core.h>
+#include <map>
+#include <set>
+#include <functional>
+#include <cfloat>
+using namespace clan;
+
+// Benchmarks the delauney and outline triangulators with 1k, 10k and 100k points.
+// The delauney triangulations are checked by testing every inner edge against the circumcircle of its neighbour.
+// The outline triangulations are checked for the covered area, the outline edges and, for the small ones, which
+// points end up inside the triangles.
+
+static double orientation(const DelauneyTriangulator_Vertex *a, const DelauneyTriangulator_Vertex *b, const DelauneyTriangulator_Vertex *c)
+{
+	return ((double)b->x - a->x) * ((double)c->y - a->y) - ((double)b->y - a->y) * ((double)c->x - a->x);
+}
+
+static bool strictly_in_circumcircle(const DelauneyTriangulator_Triangle &t, const DelauneyTriangulator_Vertex *p)
+{
+	double ax = (double)t.vertex_A->x - p->x, ay = (double)t.vertex_A->y - p->y;
+	double bx = (double)t.vertex_B->x - p->x, by = (double)t.vertex_B->y - p->y;
+	double cx = (double)t.vertex_C->x - p->x, cy = (double)t.vertex_C->y - p->y;
+	double a2 = ax * ax + ay * ay, b2 = bx * bx + by * by, c2 = cx * cx + cy * cy;
+	double det = ax * (by * c2 - b2 * cy) - ay * (bx * c2 - b2 * cx) + a2 * (bx * cy - by * cx);
+	double scale = (a2 + b2 + c2) * (a2 + b2 + c2);
+	return det > scale * 1e-10;
+}
+
+static void check_triangulation(DelauneyTriangulator &triangulator)
+{
+	const std::vector<DelauneyTriangulator_Triangle> &triangles = triangulator.get_triangles();
+	if (triangles.empty())
+		throw Exception("No triangles generated");
+
+	typedef std::pair<const DelauneyTriangulator_Vertex *, const DelauneyTriangulator_Vertex *> Edge;
+	std::map<Edge, size_t> edges;
+	for (size_t i = 0; i < triangles.size(); i++)
+	{
+		const DelauneyTriangulator_Triangle &t = triangles[i];
+		if (orientation(t.vertex_A, t.vertex_B, t.vertex_C) <= 0.0)
+			throw Exception("Triangle is not counter-clockwise");
+
+		const DelauneyTriangulator_Vertex *v[3] = { t.vertex_A, t.vertex_B, t.vertex_C };
+		for (int j = 0; j < 3; j++)
+		{
+			if (!edges.insert(std::make_pair(Edge(v[j], v[(j + 1) % 3]), i)).second)
+				throw Exception("Edge used twice in the same direction");
+		}
+	}
+
+	for (const auto &edge : edges)
+	{
+		auto opposite = edges.find(Edge(edge.first.second, edge.first.first));
+		if (opposite == edges.end())
+			continue;
+
+		const DelauneyTriangulator_Triangle &t = triangles[opposite->second];
+		const DelauneyTriangulator_Vertex *p = t.vertex_A;
+		if (p == edge.first.first || p == edge.first.second)
+			p = t.vertex_B;
+		if (p == edge.first.first || p == edge.first.second)
+			p = t.vertex_C;
+		if (strictly_in_circumcircle(triangles[edge.second], p))
+			throw Exception("Triangulation is not delauney");
+	}
+}
+
+static void benchmark_delauney(const char *name, const std::vector<Vec2f> &points)
+{
+	DelauneyTriangulator triangulator;
+	for (size_t i = 0; i < points.size(); i++)
+		triangulator.add_vertex(points[i].x, points[i].y, nullptr);
+
+	ubyte64 start_time = System::get_microseconds();
+	triangulator.generate();
+	ubyte64 end_time = System::get_microseconds();
+
+	check_triangulation(triangulator);
+	Console::write_line("  %1 %2 points: %3 triangles in %4 ms", name, (int)points.size(), (int)triangulator.get_triangles().size(), (end_time - start_time) / 1000.0);
+}
+
+static double polygon_area(const std::vector<Vec2f> &contour)
+{
+	double area = 0.0;
+	for (size_t i = 0; i < contour.size(); i++)
+	{
+		const Vec2f &a = contour[i];
+		const Vec2f &b = contour[(i + 1) % contour.size()];
+		area += (double)a.x * b.y - (double)b.x * a.y;
+	}
+	return std::abs(area) * 0.5;
+}
+
+static bool inside_contours(const std::vector<std::vector<Vec2f> > &contours, const Vec2f &p)
+{
+	// Even-odd rule
+	bool inside = false;
+	for (const auto &contour : contours)
+	{
+		for (size_t i = 0, j = contour.size() - 1; i < contour.size(); j = i++)
+		{
+			if ((contour[i].y > p.y) != (contour[j].y > p.y) && p.x < (contour[j].x - contour[i].x) * (p.y - contour[i].y) / (contour[j].y - contour[i].y) + contour[i].x)
+				inside = !inside;
+		}
+	}
+	return inside;
+}
+
+static void check_outline_triangles(const OutlineTriangulator &triangulator, const std::vector<std::vector<Vec2f> > &contours, double expected_area, bool check_coverage)
+{
+	const std::vector<DelauneyTriangulator_Triangle> &triangles = triangulator.get_triangles();
+	if (triangles.empty())
+		throw Exception("No outline triangles generated");
+
+	typedef std::pair<Vec2f, Vec2f> Edge;
+	auto less_edge = [](const Edge &a, const Edge &b)
+	{
+		if (a.first.x != b.first.x) return a.first.x < b.first.x;
+		if (a.first.y != b.first.y) return a.first.y < b.first.y;
+		if (a.second.x != b.second.x) return a.second.x < b.second.x;
+		return a.second.y < b.second.y;
+	};
+	std::set<Edge, decltype(less_edge)> edges(less_edge);
+
+	double area = 0.0;
+	for (const auto &t : triangles)
+	{
+		double triangle_area = orientation(t.vertex_A, t.vertex_B, t.vertex_C) * 0.5;
+		if (triangle_area <= 0.0)
+			throw Exception("Outline triangle is not counter-clockwise");
+		area += triangle_area;
+
+		const DelauneyTriangulator_Vertex *v[3] = { t.vertex_A, t.vertex_B, t.vertex_C };
+		for (int j = 0; j < 3; j++)
+			edges.insert(Edge(Vec2f(v[j]->x, v[j]->y), Vec2f(v[(j + 1) % 3]->x, v[(j + 1) % 3]->y)));
+	}
+
+	if (std::abs(area - expected_area) > expected_area * 1e-6)
+		throw Exception(string_format("Outline triangles cover an area of %1, expected %2", (float)area, (float)expected_area));
+
+	// Every outline edge must be an edge of a triangle, or a line of them where the edge passes through other vertices
+	std::function<bool(const Vec2f &, const Vec2f &)> has_edge = [&](const Vec2f &a, const Vec2f &b)
+	{
+		if (edges.find(Edge(a, b)) != edges.end() || edges.find(Edge(b, a)) != edges.end())
+			return true;
+
+		for (auto it = edges.lower_bound(Edge(a, Vec2f(-FLT_MAX, -FLT_MAX))); it != edges.end() && it->first == a; ++it)
+		{
+			const Vec2f &c = it->second;
+			double cross = ((double)b.x - a.x) * ((double)c.y - a.y) - ((double)b.y - a.y) * ((double)c.x - a.x);
+			double along = ((double)b.x - a.x) * ((double)c.x - a.x) + ((double)b.y - a.y) * ((double)c.y - a.y);
+			double length2 = ((double)b.x - a.x) * ((double)b.x - a.x) + ((double)b.y - a.y) * ((double)b.y - a.y);
+			if (cross == 0.0 && along > 0.0 && along < length2)
+				return has_edge(c, b);
+		}
+		return false;
+	};
+
+	for (const auto &contour : contours)
+	{
+		for (size_t i = 0; i < contour.size(); i++)
+		{
+			if (!has_edge(contour[i], contour[(i + 1) % contour.size()]))
+				throw Exception("Outline edge missing in the triangles");
+		}
+	}
+
+	if (check_coverage)
+	{
+		// Points inside the outline must be in exactly one triangle, points outside in none
+		unsigned int seed = 4711;
+		for (int i = 0; i < 2000; i++)
+		{
+			seed = seed * 1103515245 + 12345;
+			float x = (seed >> 8) / 16777216.0f * 2600.0f - 1300.0f;
+			seed = seed * 1103515245 + 12345;
+			float y = (seed >> 8) / 16777216.0f * 2600.0f - 1300.0f;
+			DelauneyTriangulator_Vertex p;
+			p.x = x;
+			p.y = y;
+
+			int hits = 0;
+			for (const auto &t : triangles)
+			{
+				if (orientation(t.vertex_A, t.vertex_B, &p) > 0.0 && orientation(t.vertex_B, t.vertex_C, &p) > 0.0 && orientation(t.vertex_C, t.vertex_A, &p) > 0.0)
+					hits++;
+			}
+
+			if (hits != (inside_contours(contours, Vec2f(x, y)) ? 1 : 0))
+				throw Exception("Outline triangles do not cover the polygon");
+		}
+	}
+}
+
+static void benchmark_outline(int num_points)
+{
+	// Star shaped outline with a hole, like a glyph or a path in the editor
+	std::vector<std::vector<Vec2f> > contours(2);
+	for (int i = 0; i < num_points / 2; i++)
+	{
+		float angle = i * 2.0f * PI / (num_points / 2);
+		float radius = 1000.0f + 200.0f * std::sin(angle * 17.0f);
+		contours[0].push_back(Vec2f(radius * std::cos(angle), radius * std::sin(angle)));
+		contours[1].push_back(Vec2f(300.0f * std::cos(-angle), 300.0f * std::sin(-angle)));
+	}
+
+	std::vector<Vec2f> first_triangles;
+	for (int run = 0; run < 2; run++)
+	{
+		OutlineTriangulator triangulator;
+		for (const auto &contour : contours)
+		{
+			for (const auto &point : contour)
+				triangulator.add_vertex(point.x, point.y, nullptr);
+			triangulator.next_contour();
+		}
+
+		ubyte64 start_time = System::get_microseconds();
+		triangulator.generate();
+		ubyte64 end_time = System::get_microseconds();
+
+		if (run == 0)
+		{
+			check_outline_triangles(triangulator, contours, polygon_area(contours[0]) - polygon_area(contours[1]), num_points <= 1000);
+			for (const auto &t : triangulator.get_triangles())
+			{
+				first_triangles.push_back(Vec2f(t.vertex_A->x, t.vertex_A->y));
+				first_triangles.push_back(Vec2f(t.vertex_B->x, t.vertex_B->y));
+				first_triangles.push_back(Vec2f(t.vertex_C->x, t.vertex_C->y));
+			}
+			Console::write_line("  star %1 points: %2 triangles in %3 ms", num_points, (int)triangulator.get_triangles().size(), (end_time - start_time) / 1000.0);
+		}
+		else
+		{
+			// The same input must give the same triangles in the same order
+			const std::vector<DelauneyTriangulator_Triangle> &triangles = triangulator.get_triangles();
+			if (triangles.size() * 3 != first_triangles.size())
+				throw Exception("Outline triangulation is not deterministic");
+			for (size_t i = 0; i < triangles.size(); i++)
+			{
+				if (Vec2f(triangles[i].vertex_A->x, triangles[i].vertex_A->y) != first_triangles[i * 3] ||
+					Vec2f(triangles[i].vertex_B->x, triangles[i].vertex_B->y) != first_triangles[i * 3 + 1] ||
+					Vec2f(triangles[i].vertex_C->x, triangles[i].vertex_C->y) != first_triangles[i * 3 + 2])
+					throw Exception("Outline triangulation is not deterministic");
+			}
+		}
+	}
+}
+
+static void check_outline_shapes()
+{
+	// Two squares, one with an extra vertex along an edge, a triangle touching a smaller one at a vertex in the
+	// middle of its long edge, and a thin concave comb whose teeth cut through the delauney triangles
+	std::vector<std::vector<Vec2f> > contours;
+	contours.push_back({ Vec2f(400.0f, -1200.0f), Vec2f(1200.0f, -1200.0f), Vec2f(400.0f, -400.0f) });
+	contours.push_back({ Vec2f(800.0f, -800.0f), Vec2f(1000.0f, -700.0f), Vec2f(900.0f, -600.0f) });
+	contours.push_back({ Vec2f(-1200.0f, -1200.0f), Vec2f(-400.0f, -1200.0f), Vec2f(-400.0f, -800.0f), Vec2f(-400.0f, -400.0f), Vec2f(-1200.0f, -400.0f) });
+	contours.push_back({ Vec2f(400.0f, 400.0f), Vec2f(1200.0f, 400.0f), Vec2f(1200.0f, 1200.0f), Vec2f(400.0f, 1200.0f) });
+	std::vector<Vec2f> comb;
+	comb.push_back(Vec2f(-1200.0f, 0.0f));
+	for (int i = 0; i < 10; i++)
+	{
+		comb.push_back(Vec2f(-1200.0f + i * 100.0f, 300.0f));
+		comb.push_back(Vec2f(-1150.0f + i * 100.0f, 300.0f));
+		comb.push_back(Vec2f(-1150.0f + i * 100.0f, 10.0f));
+		comb.push_back(Vec2f(-1100.0f + i * 100.0f, 10.0f));
+	}
+	comb.push_back(Vec2f(-200.0f, 0.0f));
+	contours.push_back(comb);
+
+	OutlineTriangulator triangulator;
+	double area = 0.0;
+	for (const auto &contour : contours)
+	{
+		for (const auto &point : contour)
+			triangulator.add_vertex(point.x, point.y, nullptr);
+		triangulator.next_polygon();
+		area += polygon_area(contour);
+	}
+	triangulator.generate();
+	check_outline_triangles(triangulator, contours, area, true);
+	Console::write_line("  squares and comb: %1 triangles", (int)triangulator.get_triangles().size());
+}
+
+int main(int, char **)
+{
+	try
+	{
+		SetupCore setup_core;
+
+		Console::write_line("Delauney triangulator:");
+
+		const int sizes[] = { 1000, 10000, 100000 };
+		for (int size : sizes)
+		{
+			std::vector<Vec2f> points(size);
+			unsigned int seed = 12345;
+			for (size_t i = 0; i < points.size(); i++)
+			{
+				seed = seed * 1103515245 + 12345;
+				float x = (seed >> 8) / 16777216.0f * 4096.0f;
+				seed = seed * 1103515245 + 12345;
+				float y = (seed >> 8) / 16777216.0f * 4096.0f;
+				points[i] = Vec2f(x, y);
+			}
+			benchmark_delauney("random", points);
+		}
+
+		for (int size : sizes)
+		{
+			// Grid points have four points on every circumcircle
+			int width = (int)std::sqrt((float)size);
+			std::vector<Vec2f> points;
+			for (int y = 0; y < size / width; y++)
+			{
+				for (int x = 0; x < width; x++)
+					points.push_back(Vec2f((float)x, (float)y));
+			}
+			benchmark_delauney("grid  ", points);
+		}
+
+		Console::write_line("Outline triangulator:");
+		check_outline_shapes();
+		for (int size : sizes)
+			benchmark_outline(size);
+
+		Console::write_line("Tests passed");
+	}
+	catch (Exception &e)
+	{
+		Console::write_line("Failed: %1", e.message);
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,159 @@
+#include <ClanLib/core.h>
+#include <ClanLib/display.h>
+#include <ClanLib/gl.h>
+#include "../../test_check.h"
+using namespace clan;
+
+// Loads a generated level of sprites, images and textures synchronously and in the background,
+// measuring the level load time and the worst frame time while the level loads.
+
+const std::string content_dir = "asyncresources_content";
+const int num_files = 120;
+
+void create_content()
+{
+	Directory::create(content_dir);
+
+	// Noise compresses badly, so decoding takes a while
+	unsigned int seed = 1234;
+	for (int i = 0; i < num_files; i++)
+	{
+		PixelBuffer pixels(512, 512, tf_rgba8);
+		unsigned int *data = pixels.get_data<unsigned int>();
+		for (int j = 0; j < 512 * 512; j++)
+		{
+			seed = seed * 1103515245 + 12345;
+			data[j] = (seed >> 8) | 0xff000000;
+		}
+		PNGProvider::save(pixels, PathHelp::combine(content_dir, string_format("image%1.png", i)));
+	}
+
+	// Every file is used by two resources to exercise the sharing of in-flight files
+	std::string xml = "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n<resources>\n<section name=\"Level\">\n";
+	for (int i = 0; i < num_files; i++)
+	{
+		xml += string_format("<sprite name=\"Sprite%1\"><image file=\"image%1.png\"><grid pos=\"0,0\" size=\"64,64\" array=\"4,4\"/></image></sprite>\n", i);
+		xml += string_format("<image name=\"Image%1\"><image file=\"image%1.png\"/></image>\n", i);
+	}
+	xml += "<section name=\"Textures\">\n";
+	for (int i = 0; i < num_files; i += 4)
+		xml += string_format("<texture name=\"Texture%1\" file=\"image%1.png\"/>\n", i);
+	xml += "</section>\n</section>\n</resources>\n";
+	File::write_text(PathHelp::combine(content_dir, "resources.xml"), xml);
+}
+
+void delete_content()
+{
+	Directory::remove(content_dir, true);
+}
+
+class FrameTimer
+{
+public:
+	FrameTimer() : start_time(System::get_microseconds()), last_time(start_time), worst_frame(0), frames(0) { }
+
+	void frame()
+	{
+		ubyte64 current_time = System::get_microseconds();
+		worst_frame = max(worst_frame, current_time - last_time);
+		last_time = current_time;
+		frames++;
+	}
+
+	void print(const std::string &name)
+	{
+		Console::write_line("   %1 level load %2 ms, worst frame %3 ms, %4 frames", name, (int) ((last_time - start_time) / 1000), (int) (worst_frame / 1000), frames);
+	}
+
+	ubyte64 start_time, last_time, worst_frame;
+	int frames;
+};
+
+void draw_frame(DisplayWindow &window, Canvas &canvas, int frame)
+{
+	canvas.clear(Colorf::black);
+	canvas.fill_rect(Rectf(0.0f, 0.0f, (float) (frame % 400), 20.0f), Colorf::white);
+	window.flip(0);
+	KeepAlive::process();
+}
+
+void load_sync(DisplayWindow &window, Canvas &canvas)
+{
+	XMLResourceDocument doc(PathHelp::combine(content_dir, "resources.xml"));
+	ResourceManager resources = XMLResourceManager::create(doc);
+
+	FrameTimer timer;
+	draw_frame(window, canvas, 0);
+	for (auto &name : doc.get_resource_names_of_type("sprite"))
+		Sprite::resource(canvas, name, resources);
+	for (auto &name : doc.get_resource_names_of_type("image"))
+		Image::resource(canvas, name, resources);
+	for (auto &name : doc.get_resource_names_of_type("texture"))
+		Texture::resource(canvas.get_gc(), name, resources);
+	draw_frame(window, canvas, 1);
+	timer.frame();
+	timer.print("synchronous:                 ");
+}
+
+void load_async(DisplayWindow &window, Canvas &canvas, int time_budget)
+{
+	XMLResourceDocument doc(PathHelp::combine(content_dir, "resources.xml"));
+	ResourceManager resources = XMLResourceManager::create(doc);
+	DisplayCache &cache = DisplayCache::get(resources);
+
+	FrameTimer timer;
+	std::vector<Resource<Sprite> > sprites;
+	for (auto &name : doc.get_resource_names_of_type("sprite"))
+		sprites.push_back(cache.get_sprite_async(canvas, name));
+	cache.prefetch_section(canvas, "Level");
+
+	int frame = 0;
+	while (cache.process_async_loads(time_budget) > 0)
+	{
+		draw_frame(window, canvas, frame++);
+		timer.frame();
+	}
+	timer.frame();
+	timer.print(string_format("async, %1 ms upload budget:", time_budget / 1000));
+
+	for (auto &sprite : sprites)
+		check(sprite.updated() && sprite.get().get_frame_count() == 16, "Sprite was not loaded");
+
+	// Prefetched resources now come from the cache
+	ubyte64 start_time = System::get_microseconds();
+	for (auto &name : doc.get_resource_names_of_type("image"))
+		check(!Image::resource(canvas, name, resources).get().is_null(), "Image was not loaded");
+	for (auto &name : doc.get_resource_names_of_type("texture"))
+		check(!Texture::resource(canvas.get_gc(), name, resources).get().is_null(), "Texture was not loaded");
+	Console::write_line("   getting the prefetched resources took %1 ms", (int) ((System::get_microseconds() - start_time) / 1000));
+}
+
+int main(int, char**)
+{
+	SetupCore setup_core;
+	SetupDisplay setup_display;
+	SetupGL setup_gl;
+
+	try
+	{
+		Console::write_line("Creating %1 images", num_files);
+		create_content();
+
+		DisplayWindow window("Async resource loading", 800, 600);
+		Canvas canvas(window);
+
+		load_sync(window, canvas);
+		load_async(window, canvas, 2000);
+		load_async(window, canvas, 8000);
+
+		delete_content();
+		Console::write_line("Tests passed");
+	}
+	catch (Exception &e)
+	{
+		delete_content();
+		Console::write_line("Failed: %1", e.message);
+		return 1;
+	}
+	return 0;
+}
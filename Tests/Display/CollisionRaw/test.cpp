@@ -0,0 +1,145 @@
+#include <ClanLib/core.h>
+#include <ClanLib/display.h>
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+using namespace clan;
+
+// Times the narrowphase of large accuracy_raw outlines (as traced from bitmaps) and checks it against testing every segment pair
+
+CollisionOutline create_outline(float radius, int num_points)
+{
+	Contour contour;
+	for (int i = 0; i < num_points; i++)
+	{
+		float angle = 2.0f * PI * i / num_points;
+		float r = radius * (0.8f + 0.2f * std::sin(angle * 12.0f));
+		contour.get_points().push_back(Pointf(radius + r * std::cos(angle), radius + r * std::sin(angle)));
+	}
+
+	std::vector<Contour> contours;
+	contours.push_back(contour);
+	int size = (int)std::ceil(radius * 2.0f);
+	return CollisionOutline(contours, Size(size, size), accuracy_raw);
+}
+
+float random_float(float max_value)
+{
+	return max_value * (std::rand() / (float)RAND_MAX);
+}
+
+size_t count_intersections(const CollisionOutline &outline1, const CollisionOutline &outline2)
+{
+	const std::vector<Pointf> &points1 = outline1.get_contours()[0].get_points();
+	const std::vector<Pointf> &points2 = outline2.get_contours()[0].get_points();
+	size_t count = 0;
+	for (size_t i = 0; i < points1.size(); i++)
+	{
+		LineSegment2f line1(points1[i], points1[(i + 1) % points1.size()]);
+		for (size_t j = 0; j < points2.size(); j++)
+		{
+			LineSegment2f line2(points2[j], points2[(j + 1) % points2.size()]);
+			bool intersect;
+			line1.get_intersection(line2, intersect);
+			if (intersect)
+				count++;
+		}
+	}
+	return count;
+}
+
+int main(int argc, char **argv)
+{
+	const int num_outlines = 64;
+	const int num_points = 2000;
+	const int num_steps = 20;
+	const float world_size = 400.0f;
+
+	CollisionOutline prototype = create_outline(100.0f, num_points);
+
+	std::vector<CollisionOutline> outlines;
+	for (int i = 0; i < num_outlines; i++)
+	{
+		CollisionOutline outline = prototype.clone();
+		outline.set_translation(random_float(world_size), random_float(world_size));
+		outlines.push_back(outline);
+	}
+
+	uint64_t move_time = 0;
+	uint64_t collide_time = 0;
+	size_t num_collisions = 0;
+	for (int step = 0; step < num_steps; step++)
+	{
+		uint64_t start_time = System::get_microseconds();
+		for (int i = 0; i < num_outlines; i++)
+		{
+			Pointf pos = outlines[i].get_translation() + Pointf(random_float(2.0f) - 1.0f, random_float(2.0f) - 1.0f);
+			outlines[i].set_translation(pos.x, pos.y);
+		}
+		uint64_t moved_time = System::get_microseconds();
+		for (int i = 0; i < num_outlines; i++)
+		{
+			for (int j = i + 1; j < num_outlines; j++)
+			{
+				if (outlines[i].collide(outlines[j]))
+					num_collisions++;
+			}
+		}
+		uint64_t end_time = System::get_microseconds();
+
+		move_time += moved_time - start_time;
+		collide_time += end_time - moved_time;
+	}
+
+	// Collect every intersection point and compare with the plain segment-segment tests (the first outlines only, as those are slow)
+	const int num_checked = 8;
+	uint64_t collect_start = System::get_microseconds();
+	size_t num_points_found = 0;
+	for (int i = 0; i < num_checked; i++)
+	{
+		outlines[i].enable_collision_info(true);
+		for (int j = i + 1; j < num_outlines; j++)
+		{
+			outlines[i].collide(outlines[j]);
+			for (const auto &info : outlines[i].get_collision_info())
+				num_points_found += info.points.size();
+		}
+		outlines[i].enable_collision_info(false);
+	}
+	uint64_t collect_time = System::get_microseconds() - collect_start;
+
+	uint64_t reference_start = System::get_microseconds();
+	size_t num_points_expected = 0;
+	for (int i = 0; i < num_checked; i++)
+	{
+		for (int j = i + 1; j < num_outlines; j++)
+			num_points_expected += count_intersections(outlines[i], outlines[j]);
+	}
+	uint64_t reference_time = System::get_microseconds() - reference_start;
+
+	// Points inside the outlines
+	uint64_t inside_start = System::get_microseconds();
+	size_t num_inside = 0;
+	for (int i = 0; i < 100000; i++)
+	{
+		if (outlines[i % num_outlines].point_inside(Pointf(random_float(world_size + 200.0f), random_float(world_size + 200.0f))))
+			num_inside++;
+	}
+	uint64_t inside_time = System::get_microseconds() - inside_start;
+
+	int num_pairs = num_outlines * (num_outlines - 1) / 2;
+	std::cout << num_outlines << " outlines of " << num_points << " points, " << num_pairs << " pairs, " << num_steps << " steps" << std::endl;
+	std::cout << "Move:          " << move_time / num_steps << " us/step" << std::endl;
+	std::cout << "Collide:       " << collide_time / num_steps << " us/step, " << num_collisions / num_steps << " colliding pairs" << std::endl;
+	std::cout << "Collect info:  " << collect_time << " us, " << num_points_found << " intersection points" << std::endl;
+	std::cout << "Every segment: " << reference_time << " us, " << num_points_expected << " intersection points" << std::endl;
+	std::cout << "Point inside:  " << inside_time << " us for 100000 points, " << num_inside << " inside" << std::endl;
+
+	if (num_points_found != num_points_expected)
+	{
+		std::cout << "Intersection points do not match!" << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,94 @@
+#include <ClanLib/core.h>
+#include <ClanLib/display.h>
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+using namespace clan;
+
+// Moves 10k outlines around and compares the CollisionWorld broadphase against testing every pair
+
+CollisionOutline create_outline(float radius, int num_points)
+{
+	Contour contour;
+	for (int i = 0; i < num_points; i++)
+	{
+		float angle = 2.0f * PI * i / num_points;
+		contour.get_points().push_back(Pointf(radius + radius * std::cos(angle), radius + radius * std::sin(angle)));
+	}
+
+	std::vector<Contour> contours;
+	contours.push_back(contour);
+	int size = (int)std::ceil(radius * 2.0f);
+	return CollisionOutline(contours, Size(size, size), accuracy_raw);
+}
+
+float random_float(float max_value)
+{
+	return max_value * (std::rand() / (float)RAND_MAX);
+}
+
+int main(int argc, char **argv)
+{
+	const int num_outlines = 10000;
+	const int num_steps = 20;
+	const float world_size = 4000.0f;
+
+	CollisionOutline prototype = create_outline(8.0f, 16);
+
+	std::vector<CollisionOutline> outlines;
+	std::vector<Pointf> velocities;
+	CollisionWorld world(32.0f);
+	for (int i = 0; i < num_outlines; i++)
+	{
+		CollisionOutline outline = prototype.clone();
+		outline.set_translation(random_float(world_size), random_float(world_size));
+		outlines.push_back(outline);
+		velocities.push_back(Pointf(random_float(4.0f) - 2.0f, random_float(4.0f) - 2.0f));
+		world.add(outline);
+	}
+
+	ubyte64 move_time = 0;
+	ubyte64 candidate_time = 0;
+	ubyte64 narrowphase_time = 0;
+	size_t num_candidates = 0;
+	size_t num_collisions = 0;
+	for (int step = 0; step < num_steps; step++)
+	{
+		ubyte64 start_time = System::get_microseconds();
+		for (int i = 0; i < num_outlines; i++)
+		{
+			Pointf pos = outlines[i].get_translation() + velocities[i];
+			outlines[i].set_translation(pos.x, pos.y);
+		}
+		ubyte64 moved_time = System::get_microseconds();
+		num_candidates += world.find_candidate_pairs().size();
+		ubyte64 candidates_found_time = System::get_microseconds();
+		num_collisions += world.find_colliding_pairs().size();
+		ubyte64 end_time = System::get_microseconds();
+
+		move_time += moved_time - start_time;
+		candidate_time += candidates_found_time - moved_time;
+		narrowphase_time += end_time - candidates_found_time;
+	}
+
+	// Every pair, as games without a broadphase would do it
+	ubyte64 brute_force_start = System::get_microseconds();
+	size_t brute_force_collisions = 0;
+	for (int i = 0; i < num_outlines; i++)
+	{
+		for (int j = i + 1; j < num_outlines; j++)
+		{
+			if (outlines[i].collide(outlines[j]))
+				brute_force_collisions++;
+		}
+	}
+	ubyte64 brute_force_time = System::get_microseconds() - brute_force_start;
+
+	std::cout << num_outlines << " outlines, " << num_steps << " steps" << std::endl;
+	std::cout << "Move:          " << move_time / num_steps << " us/step" << std::endl;
+	std::cout << "Broadphase:    " << candidate_time / num_steps << " us/step, " << num_candidates / num_steps << " candidate pairs" << std::endl;
+	std::cout << "Narrowphase:   " << narrowphase_time / num_steps << " us/step, " << num_collisions / num_steps << " colliding pairs" << std::endl;
+	std::cout << "Every pair:    " << brute_force_time << " us/step, " << brute_force_collisions << " colliding pairs" << std::endl;
+
+	return 0;
+}
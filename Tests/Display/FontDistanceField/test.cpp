@@ -0,0 +1,125 @@
+#include <ClanLib/core.h>
+#include <ClanLib/application.h>
+#include <ClanLib/display.h>
+#include <ClanLib/gl.h>
+using namespace clan;
+
+// Compares the signed distance field glyph atlas with the per-size glyph caches,
+// drawing the same text at many zoom levels
+class App
+{
+public:
+	int start(const std::vector<std::string> &args);
+
+private:
+	uint64_t draw_zoom_levels(Canvas &canvas, DisplayWindow &window, std::vector<Font> &fonts);
+	void on_input_up(const InputEvent &key);
+	void on_window_close();
+
+private:
+	bool quit;
+};
+
+class Program
+{
+public:
+	static int main(const std::vector<std::string> &args)
+	{
+		SetupCore setup_core;
+		SetupDisplay setup_display;
+		SetupGL setup_gl;
+
+		App app;
+		int retval = app.start(args);
+		return retval;
+	}
+};
+
+Application app(&Program::main);
+
+int App::start(const std::vector<std::string> &args)
+{
+	quit = false;
+
+	DisplayWindow window("ClanLib Distance Field Font Test", 1024, 768);
+	Slot slot_quit = window.sig_window_close().connect(this, &App::on_window_close);
+	Slot slot_input_up = (window.get_ic().get_keyboard()).sig_key_up().connect(this, &App::on_input_up);
+
+	Canvas canvas(window);
+
+	FontFace sized_face("Sans");
+	sized_face.add("Sans", 16);
+	FontFace sdf_face("Sans");
+	sdf_face.add("Sans", 16);
+
+	std::vector<Font> sized_fonts;
+	std::vector<Font> sdf_fonts;
+	for (int height = 8; height <= 96; height += 4)
+	{
+		Font sized_font(sized_face, height);
+		sized_font.set_scalable(1000.0f);	// Force a glyph cache for every size
+		sized_fonts.push_back(sized_font);
+
+		Font sdf_font(sdf_face, height);
+		sdf_font.set_distance_field();
+		sdf_fonts.push_back(sdf_font);
+	}
+
+	// First frame creates the glyphs
+	uint64_t sized_create_time = draw_zoom_levels(canvas, window, sized_fonts);
+	uint64_t sdf_create_time = draw_zoom_levels(canvas, window, sdf_fonts);
+
+	const int num_frames = 100;
+	uint64_t sized_draw_time = 0;
+	uint64_t sdf_draw_time = 0;
+	for (int frame = 0; frame < num_frames && !quit; frame++)
+	{
+		sized_draw_time += draw_zoom_levels(canvas, window, sized_fonts);
+		sdf_draw_time += draw_zoom_levels(canvas, window, sdf_fonts);
+		KeepAlive::process();
+	}
+
+	Console::write_line("%1 zoom levels", (int)sized_fonts.size());
+	Console::write_line("Per-size glyph caches: atlas memory %1 KB, first frame %2 ms, draw %3 us/frame", sized_face.get_texture_memory_usage() / 1024, (int)(sized_create_time / 1000), (int)(sized_draw_time / num_frames));
+	Console::write_line("Distance field atlas:  atlas memory %1 KB, first frame %2 ms, draw %3 us/frame", sdf_face.get_texture_memory_usage() / 1024, (int)(sdf_create_time / 1000), (int)(sdf_draw_time / num_frames));
+
+	while (!quit)
+	{
+		draw_zoom_levels(canvas, window, sdf_fonts);
+		KeepAlive::process();
+	}
+
+	return 0;
+}
+
+uint64_t App::draw_zoom_levels(Canvas &canvas, DisplayWindow &window, std::vector<Font> &fonts)
+{
+	canvas.clear(Colorf::white);
+
+	uint64_t start_time = System::get_microseconds();
+	float ypos = 0.0f;
+	for (auto &font : fonts)
+	{
+		ypos += font.get_font_metrics().get_height() * 0.5f;
+		font.draw_text(canvas, 10.0f, ypos, "The quick brown fox jumps over the lazy dog", Colorf::black);
+	}
+	canvas.flush();
+	window.get_gc().flush();
+	uint64_t end_time = System::get_microseconds();
+
+	window.flip(0);
+	return end_time - start_time;
+}
+
+void App::on_input_up(const InputEvent &key)
+{
+	if(key.id == keycode_escape)
+	{
+		quit = true;
+	}
+}
+
+void App::on_window_close()
+{
+	quit = true;
+}
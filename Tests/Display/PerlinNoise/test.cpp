@@ -0,0 +1,224 @@
+#include <ClanLib/core.h>
+#include <ClanLib/display.h>
+using namespace clan;
+
+// Checks the vectorized and threaded noise generation against a copy of the original scalar code,
+// then benchmarks 1024x1024 images with 6 octaves.
+
+unsigned char permutations[256];
+
+// The original per pixel perlin noise
+class ReferenceNoise
+{
+public:
+	ReferenceNoise()
+	{
+		for (int i = 0; i < 512; i++)
+			p[i] = permutations[i & 255];
+	}
+
+	static int floor_to_int(float value) { return (value > 0.0f) ? ((int)value) : ((int)value - 1); }
+	static float s_curve(float t) { return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f); }
+	static float lerp(float t, float a, float b) { return a + t * (b - a); }
+
+	static float gradient_2d(int h, float x, float y)
+	{
+		float u = (h & 4) ? y : x;
+		float v = (h & 4) ? x : y;
+		if (h & 1) u = -u;
+		if (h & 2) v = -v;
+		return u + (2.0f * v);
+	}
+
+	static float gradient_3d(int h, float x, float y, float z)
+	{
+		h = h & 15;
+		float u = (h & 8) ? y : x;
+		float v = (h & 4) ? ((h >= 12) ? x : z) : y;
+		if (h & 1) u = -u;
+		if (h & 2) v = -v;
+		return u + v;
+	}
+
+	float noise_2d(float x, float y)
+	{
+		int ix0 = floor_to_int(x), iy0 = floor_to_int(y);
+		float fx0 = x - ix0, fy0 = y - iy0, fx1 = fx0 - 1.0f, fy1 = fy0 - 1.0f;
+		int ix1 = (ix0 + 1) & 0xff, iy1 = (iy0 + 1) & 0xff;
+		ix0 &= 0xff; iy0 &= 0xff;
+		float t = s_curve(fy0), s = s_curve(fx0);
+		float n0 = lerp(t, gradient_2d(p[ix0 + p[iy0]], fx0, fy0), gradient_2d(p[ix0 + p[iy1]], fx0, fy1));
+		float n1 = lerp(t, gradient_2d(p[ix1 + p[iy0]], fx1, fy0), gradient_2d(p[ix1 + p[iy1]], fx1, fy1));
+		return lerp(s, n0, n1);
+	}
+
+	float noise_3d(float x, float y, float z)
+	{
+		int ix0 = floor_to_int(x), iy0 = floor_to_int(y), iz0 = floor_to_int(z);
+		float fx0 = x - ix0, fy0 = y - iy0, fz0 = z - iz0, fx1 = fx0 - 1.0f, fy1 = fy0 - 1.0f, fz1 = fz0 - 1.0f;
+		int ix1 = (ix0 + 1) & 0xff, iy1 = (iy0 + 1) & 0xff, iz1 = (iz0 + 1) & 0xff;
+		ix0 &= 0xff; iy0 &= 0xff; iz0 &= 0xff;
+		float r = s_curve(fz0), t = s_curve(fy0), s = s_curve(fx0);
+		float nx0 = lerp(r, gradient_3d(p[ix0 + p[iy0 + p[iz0]]], fx0, fy0, fz0), gradient_3d(p[ix0 + p[iy0 + p[iz1]]], fx0, fy0, fz1));
+		float nx1 = lerp(r, gradient_3d(p[ix0 + p[iy1 + p[iz0]]], fx0, fy1, fz0), gradient_3d(p[ix0 + p[iy1 + p[iz1]]], fx0, fy1, fz1));
+		float n0 = lerp(t, nx0, nx1);
+		nx0 = lerp(r, gradient_3d(p[ix1 + p[iy0 + p[iz0]]], fx1, fy0, fz0), gradient_3d(p[ix1 + p[iy0 + p[iz1]]], fx1, fy0, fz1));
+		nx1 = lerp(r, gradient_3d(p[ix1 + p[iy1 + p[iz0]]], fx1, fy1, fz0), gradient_3d(p[ix1 + p[iy1 + p[iz1]]], fx1, fy1, fz1));
+		float n1 = lerp(t, nx0, nx1);
+		return lerp(s, n0, n1);
+	}
+
+	float pixel(int dimensions, int x, int y, int width, int height, float start_x, float end_x, float start_y, float end_y, float z, int octaves, float amplitude)
+	{
+		float result = 0.0f;
+		float value_x = start_x + (((float)x) * (end_x - start_x)) / (float)width;
+		float value_y = start_y + (((float)y) * (end_y - start_y)) / (float)height;
+		for (int i = 0; i < octaves; i++)
+		{
+			result += amplitude * (dimensions == 2 ? noise_2d(value_x, value_y) : noise_3d(value_x, value_y, z));
+			value_x *= 2.0f;
+			value_y *= 2.0f;
+			z *= 2.0f;
+			amplitude *= 0.5f;
+		}
+		return result;
+	}
+
+	unsigned char p[512];
+};
+
+static PixelBuffer create(PerlinNoise &noise, int dimensions, float start_x, float end_x, float start_y, float end_y, float z)
+{
+	return dimensions == 2 ? noise.create_noise2d(start_x, end_x, start_y, end_y) : noise.create_noise3d(start_x, end_x, start_y, end_y, z);
+}
+
+static void test_against_reference(int dimensions, int width, int height, int octaves)
+{
+	const float start_x = -3.5f, end_x = 9.25f, start_y = -1.0f, end_y = 4.0f, z = 2.75f, amplitude = 0.8f;
+
+	PerlinNoise noise;
+	noise.set_permutations(permutations);
+	noise.set_size(width, height);
+	noise.set_octaves(octaves);
+	noise.set_amplitude(amplitude);
+	noise.set_format(tf_r32f);
+	PixelBuffer values = create(noise, dimensions, start_x, end_x, start_y, end_y, z);
+
+	noise.set_format(tf_r8);
+	PixelBuffer r8 = create(noise, dimensions, start_x, end_x, start_y, end_y, z);
+	noise.set_format(tf_rgba8);
+	PixelBuffer rgba8 = create(noise, dimensions, start_x, end_x, start_y, end_y, z);
+	noise.set_format(tf_rgba16f);
+	PixelBuffer rgba16f = create(noise, dimensions, start_x, end_x, start_y, end_y, z);
+
+	ReferenceNoise reference;
+	for (int y = 0; y < height; y++)
+	{
+		const float *line = (const float *)values.get_line(y);
+		const unsigned char *line_r8 = (const unsigned char *)r8.get_line(y);
+		const unsigned int *line_rgba8 = (const unsigned int *)rgba8.get_line(y);
+		const HalfFloat *line_rgba16f = (const HalfFloat *)rgba16f.get_line(y);
+		for (int x = 0; x < width; x++)
+		{
+			float expected = reference.pixel(dimensions, x, y, width, height, start_x, end_x, start_y, end_y, z, octaves, amplitude);
+			if (line[x] != expected)
+				throw Exception(string_format("%1D noise differs at %2,%3: %4, expected %5", dimensions, x, y, line[x], expected));
+
+			int color = clamp((int)((expected * 128.0f) + 128.0f), 0, 255);
+			if (line_r8[x] != color || line_rgba8[x] != (unsigned int)color * 0x01010101)
+				throw Exception(string_format("%1D noise 8 bit color differs at %2,%3", dimensions, x, y));
+
+			if (std::abs(line_rgba16f[x * 4 + 3].to_float() - expected) > 0.002f)
+				throw Exception(string_format("%1D noise half float differs at %2,%3: %4, expected %5", dimensions, x, y, line_rgba16f[x * 4 + 3].to_float(), expected));
+		}
+	}
+}
+
+static void test_simplex()
+{
+	for (int dimensions = 1; dimensions <= 4; dimensions++)
+	{
+		PerlinNoise noise;
+		noise.set_permutations(permutations);
+		noise.set_noise_type(PerlinNoise::simplex);
+		noise.set_format(tf_r32f);
+		noise.set_size(300, 200);
+		PixelBuffer pbuff;
+		switch (dimensions)
+		{
+		case 1: pbuff = noise.create_noise1d(0.0f, 10.0f); break;
+		case 2: pbuff = noise.create_noise2d(0.0f, 10.0f, 0.0f, 5.0f); break;
+		case 3: pbuff = noise.create_noise3d(0.0f, 10.0f, 0.0f, 5.0f, 1.5f); break;
+		case 4: pbuff = noise.create_noise4d(0.0f, 10.0f, 0.0f, 5.0f, 1.5f, 0.5f); break;
+		}
+
+		float min_value = 0.0f, max_value = 0.0f;
+		for (int y = 0; y < 200; y++)
+		{
+			const float *line = (const float *)pbuff.get_line(y);
+			for (int x = 0; x < 300; x++)
+			{
+				min_value = clan::min(min_value, line[x]);
+				max_value = clan::max(max_value, line[x]);
+				if (x > 0 && std::abs(line[x] - line[x - 1]) > 0.25f)
+					throw Exception(string_format("%1D simplex noise is not continuous", dimensions));
+			}
+		}
+		if (min_value < -1.1f || max_value > 1.1f || max_value - min_value < 0.5f)
+			throw Exception(string_format("%1D simplex noise range is %2 to %3", dimensions, min_value, max_value));
+	}
+}
+
+static void benchmark(const char *name, PerlinNoise::NoiseType type, int dimensions, TextureFormat format)
+{
+	PerlinNoise noise;
+	noise.set_permutations(permutations);
+	noise.set_noise_type(type);
+	noise.set_format(format);
+	noise.set_size(1024, 1024);
+	noise.set_octaves(6);
+	create(noise, dimensions, 0.0f, 16.0f, 0.0f, 16.0f, 0.5f);
+
+	const int iterations = 5;
+	ubyte64 start_time = System::get_microseconds();
+	for (int i = 0; i < iterations; i++)
+		create(noise, dimensions, 0.0f, 16.0f, 0.0f, 16.0f, 0.5f);
+	ubyte64 end_time = System::get_microseconds();
+	Console::write_line("  %1 %2 Mpixels/s", name, (int)(1024.0 * 1024.0 * iterations / (end_time - start_time)));
+}
+
+int main(int, char **)
+{
+	try
+	{
+		SetupCore setup_core;
+
+		for (int i = 0; i < 256; i++)
+			permutations[i] = (unsigned char)((i * 167 + 13) & 0xff);
+
+		Console::write_line("Checking perlin noise against the scalar code");
+		test_against_reference(2, 1021, 67, 6);
+		test_against_reference(3, 1021, 67, 6);
+		test_against_reference(2, 13, 300, 3);
+		test_against_reference(3, 300, 300, 1);
+
+		Console::write_line("Checking simplex noise");
+		test_simplex();
+
+		Console::write_line("1024x1024, 6 octaves on %1 cores:", System::get_num_cores());
+		benchmark("perlin 2D r32f   ", PerlinNoise::perlin, 2, tf_r32f);
+		benchmark("perlin 2D rgba8  ", PerlinNoise::perlin, 2, tf_rgba8);
+		benchmark("perlin 3D r32f   ", PerlinNoise::perlin, 3, tf_r32f);
+		benchmark("simplex 2D r32f  ", PerlinNoise::simplex, 2, tf_r32f);
+		benchmark("simplex 3D r32f  ", PerlinNoise::simplex, 3, tf_r32f);
+		benchmark("perlin 2D rgba16f", PerlinNoise::perlin, 2, tf_rgba16f);
+
+		Console::write_line("Tests passed");
+	}
+	catch (Exception &e)
+	{
+		Console::write_line("Failed: %1", e.message);
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,342 @@
+#include <ClanLib/core.h>
+#include <ClanLib/network.h>
+#include <thread>
+#include <atomic>
+#include "../../test_check.h"
+using namespace clan;
+
+// Runs DNSResolver against a stub DNS server on the loopback interface and measures cached lookups.
+
+class StubDNSServer
+{
+public:
+	StubDNSServer(const std::string &port = "0") : queries_received(0), stop(false)
+	{
+		socket.bind(SocketName("127.0.0.1", port));
+		name = socket.get_local_name();
+		thread = std::thread([this]() { run(); });
+	}
+
+	~StubDNSServer()
+	{
+		stop = true;
+		thread.join();
+	}
+
+	int get_query_count(const std::string &question)
+	{
+		MutexSection mutex_lock(&mutex);
+		return query_counts[question];
+	}
+
+	SocketName name;
+	std::atomic<int> queries_received;
+
+private:
+	void run()
+	{
+		unsigned char buffer[512];
+		while (!stop)
+		{
+			if (!socket.get_read_event().wait(50))
+				continue;
+
+			UDPPacket packet(buffer, 0, sizeof(buffer));
+			while (socket.receive_batch(&packet, 1) == 1)
+			{
+				DNSPacket query(DataBuffer(packet.data, packet.size));
+				std::string question = string_format("%1 %2", query.get_question_name(0), DNSResourceRecord::type_from_int(query.get_question_type(0)));
+				{
+					MutexSection mutex_lock(&mutex);
+					query_counts[question]++;
+				}
+				queries_received++;
+
+				std::vector<unsigned char> response = answer(packet, query, question);
+				if (!response.empty())
+				{
+					UDPPacket reply(&response[0], (int) response.size(), (int) response.size());
+					reply.address = packet.address;
+					reply.port = packet.port;
+					socket.send_batch(&reply, 1);
+				}
+			}
+		}
+	}
+
+	std::vector<unsigned char> answer(const UDPPacket &packet, const DNSPacket &query, const std::string &question)
+	{
+		const unsigned char *query_data = (const unsigned char *) packet.data;
+		std::vector<unsigned char> response(query_data, query_data + packet.size);
+		response[2] = 0x81;	// Response, recursion desired
+		response[3] = 0x80;	// Recursion available
+
+		int answer_count = 0, nameserver_count = 0;
+		if (question == "host.test A")
+		{
+			answer_count += add_record(response, "", 1, 1, { 10, 0, 0, 1 });
+			answer_count += add_record(response, "", 1, 1, { 10, 0, 0, 2 });
+		}
+		else if (question == "host.test AAAA")
+		{
+			answer_count += add_record(response, "", 28, 1, { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1 });
+		}
+		else if (question == "alias.test A")
+		{
+			answer_count += add_record(response, "", 5, 300, encode_name("target.test"));
+			answer_count += add_record(response, "target.test", 1, 300, { 10, 0, 0, 3 });
+		}
+		else if (question == "slow.test A")
+		{
+			System::sleep(200);
+			answer_count += add_record(response, "", 1, 300, { 10, 0, 0, 4 });
+		}
+		else if (question == "ipv4only.test A")
+		{
+			answer_count += add_record(response, "", 1, 300, { 10, 0, 0, 5 });
+		}
+		else if (question == "ipv4only.test AAAA")
+		{
+			nameserver_count += add_soa_record(response, 60);
+		}
+		else if (question == "loop.test A")
+		{
+			// Refers to the server on the standard port, which refers to itself
+			nameserver_count += add_record(response, "loop.test", 2, 300, encode_name("127.0.0.1"));
+		}
+		else if (question.substr(0, 4) == "drop")
+		{
+			return std::vector<unsigned char>();
+		}
+		else
+		{
+			response[3] |= 3;	// Name error
+			nameserver_count += add_soa_record(response, 60);
+		}
+
+		response[7] = answer_count;
+		response[9] = nameserver_count;
+		return response;
+	}
+
+	static std::vector<unsigned char> encode_name(const std::string &name)
+	{
+		std::vector<unsigned char> encoded;
+		std::vector<std::string> labels = StringHelp::split_text(name, ".");
+		for (auto &label : labels)
+		{
+			encoded.push_back((unsigned char) label.length());
+			encoded.insert(encoded.end(), label.begin(), label.end());
+		}
+		encoded.push_back(0);
+		return encoded;
+	}
+
+	static int add_record(std::vector<unsigned char> &response, const std::string &name, int type, int ttl, const std::vector<unsigned char> &rdata)
+	{
+		if (name.empty())
+		{
+			// Pointer to the question name
+			response.push_back(0xc0);
+			response.push_back(12);
+		}
+		else
+		{
+			std::vector<unsigned char> encoded = encode_name(name);
+			response.insert(response.end(), encoded.begin(), encoded.end());
+		}
+		unsigned char fields[10] = { 0, (unsigned char) type, 0, 1, (unsigned char) (ttl >> 24), (unsigned char) (ttl >> 16), (unsigned char) (ttl >> 8), (unsigned char) ttl, (unsigned char) (rdata.size() >> 8), (unsigned char) rdata.size() };
+		response.insert(response.end(), fields, fields + 10);
+		response.insert(response.end(), rdata.begin(), rdata.end());
+		return 1;
+	}
+
+	static int add_soa_record(std::vector<unsigned char> &response, int minimum)
+	{
+		std::vector<unsigned char> rdata = encode_name("ns.test");
+		std::vector<unsigned char> rname = encode_name("admin.test");
+		rdata.insert(rdata.end(), rname.begin(), rname.end());
+		int values[5] = { 1, 3600, 600, 86400, minimum };
+		for (int value : values)
+		{
+			rdata.push_back((unsigned char) (value >> 24));
+			rdata.push_back((unsigned char) (value >> 16));
+			rdata.push_back((unsigned char) (value >> 8));
+			rdata.push_back((unsigned char) value);
+		}
+		return add_record(response, "test", 6, 3600, rdata);
+	}
+
+	UDPSocket socket;
+	std::thread thread;
+	std::atomic<bool> stop;
+	Mutex mutex;
+	std::map<std::string, int> query_counts;
+};
+
+void test_lookups(DNSResolver &resolver, StubDNSServer &server)
+{
+	Console::write_line("Checking lookups");
+
+	std::vector<DNSResourceRecord> records = resolver.lookup_resource("host.test", "A", 2000);
+	check(records.size() == 2 && records[0].get_a_address_str() == "10.0.0.1" && records[1].get_a_address_str() == "10.0.0.2", "Wrong answer for host.test");
+
+	records = resolver.lookup_resource("alias.test", "A", 2000);
+	check(records.size() == 1 && records[0].get_a_address_str() == "10.0.0.3", "CNAME was not followed");
+
+	std::vector<std::string> addresses = resolver.lookup_addresses("host.test", 2000);
+	check(addresses.size() == 3 && addresses[0] == "10.0.0.1" && addresses[2] == "2001:db8::1", "Wrong addresses for host.test");
+
+	addresses = resolver.lookup_addresses("ipv4only.test", 2000);
+	check(addresses.size() == 1 && addresses[0] == "10.0.0.5", "Wrong addresses for ipv4only.test");
+
+	bool failed = false;
+	try
+	{
+		resolver.lookup_resource("missing.test", "A", 2000);
+	}
+	catch (Exception &)
+	{
+		failed = true;
+	}
+	check(failed, "Lookup of a missing name did not fail");
+}
+
+void test_cache(DNSResolver &resolver, StubDNSServer &server)
+{
+	Console::write_line("Checking the cache");
+
+	// Answers and name errors are served from the cache
+	int queries = server.queries_received;
+	resolver.lookup_resource("alias.test", "A", 2000);
+	try
+	{
+		resolver.lookup_resource("missing.test", "A", 2000);
+	}
+	catch (Exception &)
+	{
+	}
+	check(server.queries_received == queries, "Cached answers were queried again");
+
+	// host.test has a TTL of one second
+	System::sleep(1100);
+	resolver.lookup_resource("host.test", "A", 2000);
+	check(server.queries_received == queries + 1, "Expired answer was not queried again");
+
+	resolver.clear_cache();
+	resolver.lookup_resource("alias.test", "A", 2000);
+	check(server.get_query_count("alias.test A") == 2, "clear_cache did not remove answers");
+}
+
+void test_coalescing(DNSResolver &resolver, StubDNSServer &server)
+{
+	Console::write_line("Checking request coalescing");
+
+	const int num_lookups = 10;
+	std::atomic<int> completed(0);
+	Event event_done;
+	for (int i = 0; i < num_lookups; i++)
+	{
+		resolver.lookup_resource_async("slow.test", "A", 2000, [&](const std::vector<DNSResourceRecord> &records, const std::string &error)
+		{
+			if (error.empty() && records.size() == 1 && ++completed == num_lookups)
+				event_done.set();
+		});
+	}
+	check(event_done.wait(2000), "Coalesced lookups did not complete");
+	check(server.get_query_count("slow.test A") == 1, string_format("%1 queries sent for coalesced lookups", server.get_query_count("slow.test A")));
+}
+
+void test_timeout(DNSResolver &resolver, StubDNSServer &server)
+{
+	Console::write_line("Checking timeouts");
+
+	ubyte64 start_time = System::get_time();
+	std::string error;
+	Event event_done;
+	resolver.lookup_resource_async("drop.test", "A", 1500, [&](const std::vector<DNSResourceRecord> &records, const std::string &lookup_error)
+	{
+		error = lookup_error;
+		event_done.set();
+	});
+	check(event_done.wait(3000) && !error.empty(), "Lookup did not time out");
+	ubyte64 elapsed = System::get_time() - start_time;
+	check(elapsed >= 1400 && elapsed < 2000, string_format("Lookup timed out after %1 ms", (int) elapsed));
+	check(server.get_query_count("drop.test A") == 2, "Query was not resent");
+}
+
+void test_referral_loop(DNSResolver &resolver)
+{
+	Console::write_line("Checking referral loops");
+
+	// Referrals are always sent to port 53
+	std::unique_ptr<StubDNSServer> referred_server;
+	try
+	{
+		referred_server.reset(new StubDNSServer("53"));
+	}
+	catch (Exception &)
+	{
+		Console::write_line("   skipped, unable to bind port 53");
+		return;
+	}
+
+	std::vector<DNSResourceRecord> records;
+	std::string error;
+	Event event_done;
+	resolver.lookup_resource_async("loop.test", "A", 5000, [&](const std::vector<DNSResourceRecord> &lookup_records, const std::string &lookup_error)
+	{
+		records = lookup_records;
+		error = lookup_error;
+		event_done.set();
+	});
+	check(event_done.wait(5000), "Referral loop did not complete");
+	check(records.empty() && error.find("too many referrals") != std::string::npos, "Referral loop did not fail: " + error);
+	check(referred_server->get_query_count("loop.test A") == 24, string_format("%1 referrals followed", referred_server->get_query_count("loop.test A")));
+}
+
+void benchmark(DNSResolver &resolver)
+{
+	resolver.clear_cache();
+	ubyte64 start_time = System::get_microseconds();
+	resolver.lookup_resource("alias.test", "A", 2000);
+	ubyte64 uncached_time = System::get_microseconds() - start_time;
+
+	const int iterations = 100000;
+	start_time = System::get_microseconds();
+	for (int i = 0; i < iterations; i++)
+		resolver.lookup_resource("alias.test", "A", 2000);
+	ubyte64 cached_time = System::get_microseconds() - start_time;
+
+	Console::write_line("   uncached lookup %1 us, cached lookup %2 us", (int) uncached_time, cached_time / (double) iterations);
+}
+
+int main(int, char**)
+{
+	SetupCore setup_core;
+	SetupNetwork setup_network;
+
+	try
+	{
+		StubDNSServer server;
+		DNSResolver resolver;
+		resolver.set_dns_servers(std::vector<SocketName>(1, server.name));
+
+		test_lookups(resolver, server);
+		test_cache(resolver, server);
+		test_coalescing(resolver, server);
+		test_timeout(resolver, server);
+		test_referral_loop(resolver);
+
+		Console::write_line("Lookups against the loopback stub server:");
+		benchmark(resolver);
+
+		Console::write_line("Tests passed");
+	}
+	catch (Exception &e)
+	{
+		Console::write_line("Failed: %1", e.message);
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,253 @@
+#include <ClanLib/core.h>
+#include <ClanLib/network.h>
+#include <thread>
+#include <functional>
+#include "../../test_check.h"
+using namespace clan;
+
+// Checks the vectored TCPConnection::send/receive, send_file and zero-copy sends on the loopback
+// interface, and measures small header + large body responses sent in different ways.
+
+const SocketName server_name("127.0.0.1", "21543");
+const std::string temp_filename("tcpscattergather.tmp");
+
+// Runs the sender on another thread, so neither side blocks on a full socket buffer
+void run_concurrently(const std::function<void()> &sender, const std::function<void()> &receiver)
+{
+	std::string send_error;
+	std::thread send_thread([&]()
+	{
+		try
+		{
+			sender();
+		}
+		catch (Exception &e)
+		{
+			send_error = e.message;
+		}
+	});
+
+	std::string receive_error;
+	try
+	{
+		receiver();
+	}
+	catch (Exception &e)
+	{
+		receive_error = e.message;
+	}
+	send_thread.join();
+
+	check(send_error.empty(), "Sending failed: " + send_error);
+	check(receive_error.empty(), "Receiving failed: " + receive_error);
+}
+
+class ConnectedPair
+{
+public:
+	ConnectedPair() : listen(server_name)
+	{
+		std::thread connect_thread([&]() { client = TCPConnection(server_name); });
+		bool connected = listen.get_accept_event().wait(5000);
+		if (connected)
+			server = listen.accept();
+		connect_thread.join();
+		check(connected, "Connection attempt timed out");
+	}
+
+	TCPListen listen;
+	TCPConnection server;
+	TCPConnection client;
+};
+
+std::vector<unsigned char> make_data(int size, int seed)
+{
+	std::vector<unsigned char> data(size);
+	for (int i = 0; i < size; i++)
+		data[i] = (unsigned char) (i * 7 + seed + (i >> 8));
+	return data;
+}
+
+void test_vectored()
+{
+	Console::write_line("Checking vectored send and receive");
+	ConnectedPair pair;
+
+	// Large enough that the sends and receives are split up
+	std::vector<unsigned char> header = make_data(100, 1), empty, body = make_data(4 * 1024 * 1024 + 3, 2), trailer = make_data(5, 3);
+	SocketBuffer send_buffers[4] = { SocketBuffer(&header[0], 100), SocketBuffer(nullptr, 0), SocketBuffer(&body[0], (int) body.size()), SocketBuffer(&trailer[0], 5) };
+	int total = 100 + (int) body.size() + 5;
+
+	std::vector<unsigned char> received_header(33), received_body(total - 33);
+	SocketBuffer receive_buffers[2] = { SocketBuffer(&received_header[0], 33), SocketBuffer(&received_body[0], (int) received_body.size()) };
+	int sent = 0, received = 0;
+	run_concurrently(
+		[&]() { sent = pair.client.send(send_buffers, 4, true); },
+		[&]() { received = pair.server.receive(receive_buffers, 2, true); });
+
+	check(sent == total && received == total, string_format("Sent %1 and received %2 of %3 bytes", sent, received, total));
+
+	std::vector<unsigned char> expected(header);
+	expected.insert(expected.end(), body.begin(), body.end());
+	expected.insert(expected.end(), trailer.begin(), trailer.end());
+	check(memcmp(&received_header[0], &expected[0], 33) == 0 && memcmp(&received_body[0], &expected[33], total - 33) == 0, "Received data differs");
+}
+
+void test_send_file()
+{
+	Console::write_line("Checking send_file");
+	ConnectedPair pair;
+
+	std::vector<unsigned char> contents = make_data(300000, 4);
+	File::write_bytes(temp_filename, DataBuffer(&contents[0], (int) contents.size()));
+	File file(temp_filename);
+	file.seek(10);
+
+	const int offset = 1234, length = 250000;
+	int sent = 0;
+	std::vector<unsigned char> received(length);
+	run_concurrently(
+		[&]() { sent = pair.client.send_file(file, offset, length); },
+		[&]() { pair.server.receive(&received[0], length, true); });
+
+	check(sent == length && memcmp(&received[0], &contents[offset], length) == 0, "File data differs");
+	check(file.get_position() == 10, "send_file moved the file position");
+
+	bool failed = false;
+	try
+	{
+		pair.client.send_file(file, 299990, 100);
+	}
+	catch (Exception &)
+	{
+		failed = true;
+	}
+	check(failed, "Sending past the end of the file did not fail");
+}
+
+void test_zero_copy()
+{
+	ConnectedPair pair;
+	if (!pair.client.set_zero_copy(true))
+	{
+		Console::write_line("Zero-copy sends not supported, skipping");
+		return;
+	}
+	Console::write_line("Checking zero-copy sends");
+	check(pair.client.is_zero_copy_enabled(), "Zero-copy was not enabled");
+
+	std::vector<unsigned char> received(1024 * 1024);
+	for (int round = 0; round < 4; round++)
+	{
+		// The connection keeps a reference to each buffer until the kernel releases it
+		std::vector<unsigned char> data = make_data((int) received.size(), 5 + round);
+		DataBuffer buffer(&data[0], (unsigned int) data.size());
+		run_concurrently(
+			[&]() { check(pair.client.send_zero_copy(buffer) == (int) data.size(), "Zero-copy send was incomplete"); },
+			[&]() { pair.server.receive(&received[0], (int) received.size(), true); });
+		check(received == data, "Zero-copy data differs");
+	}
+
+	// The other sends copy, so their buffers may be reused as soon as they return
+	std::vector<unsigned char> data = make_data((int) received.size(), 9), expected = data;
+	run_concurrently(
+		[&]() { pair.client.send(&data[0], (int) data.size(), true); data[0] ^= 0xff; },
+		[&]() { pair.server.receive(&received[0], (int) received.size(), true); });
+	check(received == expected, "Copied data differs");
+
+	pair.client.disconnect_graceful();
+}
+
+enum SendMethod
+{
+	method_two_sends,
+	method_vectored,
+	method_send_file,
+	method_zero_copy
+};
+
+void benchmark(SendMethod method, int body_size)
+{
+	ConnectedPair pair;
+	if (method == method_zero_copy && !pair.client.set_zero_copy(true))
+		return;
+
+	std::string header = "HTTP/1.1 200 OK\r\nServer: ClanLib HTTP Server\r\nConnection: keep-alive\r\nContent-Type: application/octet-stream\r\nContent-Length: " + StringHelp::int_to_text(body_size) + "\r\n\r\n";
+	std::vector<unsigned char> body = make_data(body_size, 6);
+	DataBuffer body_buffer(&body[0], body_size);
+	File::write_bytes(temp_filename, body_buffer);
+	File file(temp_filename);
+
+	const int responses = 2000;
+	int response_size = (int) header.length() + body_size;
+	std::thread receive_thread([&]()
+	{
+		std::vector<char> buffer(256 * 1024);
+		ubyte64 total = 0;
+		while (total < (ubyte64) responses * response_size)
+			total += pair.server.receive(&buffer[0], (int) buffer.size(), false);
+	});
+
+	ubyte64 start_time = System::get_microseconds();
+	for (int i = 0; i < responses; i++)
+	{
+		if (method == method_two_sends)
+		{
+			pair.client.send(header.data(), (int) header.length(), true);
+			pair.client.send(&body[0], body_size, true);
+		}
+		else if (method == method_send_file)
+		{
+			pair.client.send(header.data(), (int) header.length(), true);
+			pair.client.send_file(file, 0, body_size);
+		}
+		else if (method == method_zero_copy)
+		{
+			pair.client.send(header.data(), (int) header.length(), true);
+			pair.client.send_zero_copy(body_buffer);
+		}
+		else
+		{
+			SocketBuffer buffers[2] = { SocketBuffer(header.data(), (int) header.length()), SocketBuffer(&body[0], body_size) };
+			pair.client.send(buffers, 2, true);
+		}
+	}
+	receive_thread.join();
+	ubyte64 elapsed = System::get_microseconds() - start_time;
+
+	const char *names[] = { "send + send        ", "vectored send      ", "send + send_file   ", "send + zero-copy   " };
+	int calls = (method == method_vectored) ? 1 : 2;
+	Console::write_line("   %1 %2 calls/response, %3 responses/s, %4 MB/s", names[method], calls, (int) (responses * 1000000.0 / elapsed), (int) ((double) responses * response_size / elapsed));
+}
+
+int main(int, char**)
+{
+	SetupCore setup_core;
+	SetupNetwork setup_network;
+
+	try
+	{
+		test_vectored();
+		test_send_file();
+		test_zero_copy();
+
+		int body_sizes[] = { 4 * 1024, 64 * 1024, 1024 * 1024 };
+		for (int body_size : body_sizes)
+		{
+			Console::write_line("Responses with a %1 byte body on loopback:", body_size);
+			benchmark(method_two_sends, body_size);
+			benchmark(method_vectored, body_size);
+			benchmark(method_send_file, body_size);
+			benchmark(method_zero_copy, body_size);
+		}
+
+		FileHelp::delete_file(temp_filename);
+		Console::write_line("Tests passed");
+	}
+	catch (Exception &e)
+	{
+		Console::write_line("Failed: %1", e.message);
+		return 1;
+	}
+	return 0;
+}
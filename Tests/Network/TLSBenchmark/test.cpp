@@ -0,0 +1,190 @@
+#include <ClanLib/core.h>
+#include <ClanLib/network.h>
+using namespace clan;
+
+// Measures TLS handshakes and throughput against a local test server. For example:
+//
+//   openssl req -x509 -newkey rsa:2048 -nodes -keyout key.pem -out cert.pem -subj /CN=localhost
+//   head -c 16777216 /dev/urandom > large.bin
+//   echo hello > small.txt
+//   openssl s_server -accept 4433 -cert cert.pem -key key.pem -WWW -cipher AES128-GCM-SHA256
+//
+// and then run "tlsbenchmark localhost 4433". Use -cipher AES128-SHA to compare with a CBC suite.
+// OpenSSL 3 also needs @SECLEVEL=0 in the cipher list to accept RSA key exchange from this client.
+//
+// For the upload benchmark, start a second server that discards what it receives and pass its port as well:
+//
+//   openssl s_server -accept 4434 -cert cert.pem -key key.pem -quiet -cipher AES128-GCM-SHA256 > /dev/null
+
+const int num_handshakes = 50;
+
+int transfer(const SocketName &server, TLSClient &tls, const std::string &path)
+{
+	std::string request = string_format("GET /%1 HTTP/1.0\r\n\r\n", path);
+
+	TCPConnection connection(server);
+	connection.set_nodelay(true);
+	tls.encrypt(request.data(), request.length());
+
+	const int max_buffer_size = 16*1024;
+	char buffer[max_buffer_size];
+	int buffer_pos = 0;
+	int buffer_size = 0;
+	bool eof = false;
+	int bytes_received = 0;
+	while (true)
+	{
+		bool should_continue;
+		do
+		{
+			should_continue = false;
+			if (tls.get_encrypted_data_available() && connection.get_write_event().wait(0))
+			{
+				int bytes_sent = connection.write(tls.get_encrypted_data(), tls.get_encrypted_data_available(), false);
+				tls.encrypted_data_consumed(bytes_sent);
+				should_continue = true;
+			}
+
+			if (tls.get_decrypted_data_available())
+			{
+				bytes_received += tls.get_decrypted_data_available();
+				tls.decrypted_data_consumed(tls.get_decrypted_data_available());
+				should_continue = true;
+			}
+
+			if (buffer_size < max_buffer_size && !eof && connection.get_read_event().wait(0))
+			{
+				int bytes_read = connection.read(buffer + buffer_size, max_buffer_size - buffer_size, false);
+				buffer_size += bytes_read;
+				if (bytes_read == 0)
+					eof = true;
+				else
+					should_continue = true;
+			}
+
+			if (buffer_pos < buffer_size)
+			{
+				buffer_pos += tls.decrypt(buffer + buffer_pos, buffer_size - buffer_pos);
+				if (buffer_pos == buffer_size)
+				{
+					buffer_pos = 0;
+					buffer_size = 0;
+				}
+				should_continue = true;
+			}
+
+		} while(should_continue);
+
+		if (eof)
+			break;
+
+		std::vector<Event> wait_events;
+		if (buffer_size < max_buffer_size)
+			wait_events.push_back(connection.get_read_event());
+		if (tls.get_encrypted_data_available())
+			wait_events.push_back(connection.get_write_event());
+
+		Event::wait(wait_events);
+	}
+	return bytes_received;
+}
+
+void benchmark_handshakes(const SocketName &server, bool resume)
+{
+	std::string session_name = server.get_address() + ":" + server.get_port();
+	if (resume)
+	{
+		// Establish the session the other connections resume
+		TLSClient tls;
+		tls.enable_session_resumption(session_name);
+		transfer(server, tls, "small.txt");
+	}
+
+	int num_resumed = 0;
+	ubyte64 start_time = System::get_microseconds();
+	for (int i = 0; i < num_handshakes; i++)
+	{
+		TLSClient tls;
+		if (resume)
+			tls.enable_session_resumption(session_name);
+		if (transfer(server, tls, "small.txt") == 0)
+			throw Exception("No response from the server");
+		if (tls.is_session_resumed())
+			num_resumed++;
+	}
+	ubyte64 end_time = System::get_microseconds();
+
+	Console::write_line("%1 handshakes: %2 ms per connection (%3 of %4 resumed)", resume ? "Resumed" : "Full", (end_time - start_time) / 1000.0 / num_handshakes, num_resumed, num_handshakes);
+}
+
+void benchmark_throughput(const SocketName &server)
+{
+	TLSClient tls;
+	ubyte64 start_time = System::get_microseconds();
+	int bytes_received = transfer(server, tls, "large.bin");
+	ubyte64 end_time = System::get_microseconds();
+
+	Console::write_line("Download: %1 bytes, %2 MB/s", bytes_received, bytes_received / (double)(end_time - start_time));
+}
+
+void benchmark_connection_download(const SocketName &server)
+{
+	ubyte64 start_time = System::get_microseconds();
+	TCPConnection connection(server);
+	connection.set_nodelay(true);
+	TLSConnection tls(connection);
+
+	std::string request("GET /large.bin HTTP/1.0\r\n\r\n");
+	tls.send(request.data(), request.length(), true);
+
+	std::vector<char> buffer(64*1024);
+	int bytes_received = 0;
+	while (true)
+	{
+		int received = tls.receive(&buffer[0], buffer.size(), false);
+		if (received == 0)
+			break;
+		bytes_received += received;
+	}
+	ubyte64 end_time = System::get_microseconds();
+
+	Console::write_line("TLSConnection download: %1 bytes, %2 MB/s", bytes_received, bytes_received / (double)(end_time - start_time));
+}
+
+void benchmark_connection_upload(const SocketName &server)
+{
+	TCPConnection connection(server);
+	connection.set_nodelay(true);
+	TLSConnection tls(connection);
+
+	const int total_size = 64*1024*1024;
+	std::vector<char> buffer(256*1024, 'x');
+	ubyte64 start_time = System::get_microseconds();
+	for (int pos = 0; pos < total_size; pos += buffer.size())
+		tls.send(&buffer[0], buffer.size(), true);
+	ubyte64 end_time = System::get_microseconds();
+
+	Console::write_line("TLSConnection upload: %1 bytes, %2 MB/s", total_size, total_size / (double)(end_time - start_time));
+}
+
+int main(int argc, char **argv)
+{
+	SetupCore setup_core;
+	SetupNetwork setup_network;
+	try
+	{
+		SocketName server(argc > 1 ? argv[1] : "localhost", argc > 2 ? argv[2] : "4433");
+		benchmark_handshakes(server, false);
+		benchmark_handshakes(server, true);
+		benchmark_throughput(server);
+		benchmark_connection_download(server);
+		if (argc > 3)
+			benchmark_connection_upload(SocketName(server.get_address(), argv[3]));
+	}
+	catch (Exception e)
+	{
+		Console::write_line(e.message);
+		return 1;
+	}
+	return 0;
+}
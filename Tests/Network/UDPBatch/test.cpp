@@ -0,0 +1,269 @@
+#include <ClanLib/core.h>
+#include <ClanLib/network.h>
+#include <thread>
+#include <atomic>
+using namespace clan;
+
+// Checks UDPSocket::send_batch and receive_batch on the loopback interface and measures
+// packets per second against one datagram per system call.
+
+const int packet_size = 64;
+const int batch_size = 64;
+
+class PacketBuffers
+{
+public:
+	PacketBuffers(int count, int capacity) : storage(count * capacity), packets(count)
+	{
+		for (int i = 0; i < count; i++)
+			packets[i] = UDPPacket(&storage[i * capacity], 0, capacity);
+	}
+
+	std::vector<unsigned char> storage;
+	std::vector<UDPPacket> packets;
+};
+
+SocketName bind_loopback(UDPSocket &socket)
+{
+	socket.bind(SocketName("127.0.0.1", "0"));
+	return socket.get_local_name();
+}
+
+int receive_all(UDPSocket &socket, UDPPacket *packets, int count)
+{
+	int received = 0;
+	while (received < count && socket.get_read_event().wait(1000))
+		received += socket.receive_batch(packets + received, count - received);
+	return received;
+}
+
+void test_batch()
+{
+	Console::write_line("Checking send_batch and receive_batch");
+
+	UDPSocket receiver, sender;
+	SocketName receiver_name = bind_loopback(receiver);
+	SocketName sender_name = bind_loopback(sender);
+
+	UDPPacket nothing[4];
+	if (receiver.receive_batch(nothing, 4) != 0)
+		throw Exception("receive_batch did not return 0 on an empty socket");
+
+	const int count = 200;
+	PacketBuffers outgoing(count, 1024), incoming(count, 1024);
+	for (int i = 0; i < count; i++)
+	{
+		UDPPacket &packet = outgoing.packets[i];
+		packet.set_name(receiver_name);
+		packet.size = 4 + (i * 7) % 1000;
+		unsigned char *data = (unsigned char *) packet.data;
+		for (int j = 0; j < packet.size; j++)
+			data[j] = (unsigned char) (i + j);
+	}
+
+	// Stay well below the default socket receive buffer size
+	const int chunk_size = 50;
+	for (int chunk = 0; chunk < count; chunk += chunk_size)
+	{
+		int sent = 0;
+		while (sent < chunk_size)
+			sent += sender.send_batch(&outgoing.packets[chunk + sent], chunk_size - sent);
+
+		if (receive_all(receiver, &incoming.packets[chunk], chunk_size) != chunk_size)
+			throw Exception("Not all datagrams arrived");
+	}
+
+	for (int i = 0; i < count; i++)
+	{
+		const UDPPacket &packet = incoming.packets[i];
+		if (packet.size != outgoing.packets[i].size || memcmp(packet.data, outgoing.packets[i].data, packet.size) != 0)
+			throw Exception(string_format("Datagram %1 differs", i));
+		if (!(packet.get_name() == sender_name))
+			throw Exception(string_format("Datagram %1 came from %2:%3", i, packet.get_name().get_address(), packet.get_name().get_port()));
+	}
+}
+
+void test_segmentation()
+{
+	UDPSocket receiver, sender;
+	SocketName receiver_name = bind_loopback(receiver);
+	bind_loopback(sender);
+
+	if (!sender.is_segmentation_offload_supported())
+	{
+		Console::write_line("Segmentation offload not supported, skipping");
+		return;
+	}
+	Console::write_line("Checking segmentation offload");
+
+	std::vector<unsigned char> buffer(10500);
+	for (size_t i = 0; i < buffer.size(); i++)
+		buffer[i] = (unsigned char) (i / 1000);
+
+	UDPPacket packet(&buffer[0], (int) buffer.size(), (int) buffer.size());
+	packet.set_name(receiver_name);
+	packet.segment_size = 1000;
+	if (sender.send_batch(&packet, 1) != 1)
+		throw Exception("Segmented send failed");
+
+	PacketBuffers incoming(16, 2048);
+	if (receive_all(receiver, &incoming.packets[0], 11) != 11)
+		throw Exception("Segmented send did not arrive as 11 datagrams");
+	for (int i = 0; i < 11; i++)
+	{
+		const UDPPacket &segment = incoming.packets[i];
+		if (segment.size != (i < 10 ? 1000 : 500) || ((unsigned char *) segment.data)[0] != i)
+			throw Exception(string_format("Segment %1 is wrong", i));
+	}
+
+	if (receiver.set_receive_coalescing(true))
+	{
+		Console::write_line("Checking receive coalescing");
+		if (sender.send_batch(&packet, 1) != 1)
+			throw Exception("Segmented send failed");
+
+		PacketBuffers coalesced(16, 65536);
+		int bytes = 0;
+		while (bytes < (int) buffer.size() && receiver.get_read_event().wait(1000))
+		{
+			int received = receiver.receive_batch(&coalesced.packets[0], 16);
+			for (int i = 0; i < received; i++)
+			{
+				const UDPPacket &merged = coalesced.packets[i];
+				if (merged.segment_size != 0 && merged.segment_size != 1000)
+					throw Exception(string_format("Unexpected segment size %1", merged.segment_size));
+				if (memcmp(merged.data, &buffer[bytes], merged.size) != 0)
+					throw Exception("Coalesced data differs");
+				bytes += merged.size;
+			}
+		}
+		if (bytes != (int) buffer.size())
+			throw Exception("Coalesced datagrams are missing data");
+	}
+}
+
+void test_reuse_port()
+{
+	const int num_sockets = 4;
+	std::vector<UDPSocket> receivers(num_sockets);
+	if (!receivers[0].set_reuse_port(true))
+	{
+		Console::write_line("SO_REUSEPORT not supported, skipping");
+		return;
+	}
+	Console::write_line("Checking SO_REUSEPORT sharding");
+
+	SocketName name = bind_loopback(receivers[0]);
+	for (int i = 1; i < num_sockets; i++)
+	{
+		receivers[i].set_reuse_port(true);
+		receivers[i].bind(name);
+	}
+
+	// The kernel picks the socket from a hash of the source address, so send from many ports
+	const int num_senders = 64;
+	std::vector<UDPSocket> senders(num_senders);
+	unsigned char data[packet_size] = { 0 };
+	for (auto &sender : senders)
+	{
+		bind_loopback(sender);
+		sender.send(data, packet_size, name);
+	}
+
+	std::atomic<int> total(0);
+	std::vector<int> counts(num_sockets);
+	std::vector<std::thread> threads;
+	for (int i = 0; i < num_sockets; i++)
+	{
+		threads.push_back(std::thread([&, i]()
+		{
+			PacketBuffers incoming(batch_size, packet_size);
+			int received;
+			while ((received = receivers[i].receive_batch(&incoming.packets[0], batch_size)) > 0)
+				counts[i] += received;
+			total += counts[i];
+		}));
+	}
+	for (auto &thread : threads)
+		thread.join();
+
+	int sockets_used = 0;
+	for (int i = 0; i < num_sockets; i++)
+	{
+		if (counts[i] > 0)
+			sockets_used++;
+	}
+	if (total != num_senders || sockets_used < 2)
+		throw Exception(string_format("%1 datagrams spread over %2 sockets", (int) total, sockets_used));
+	Console::write_line("   %1 datagrams spread over %2 sockets: %3 %4 %5 %6", num_senders, num_sockets, counts[0], counts[1], counts[2], counts[3]);
+}
+
+void benchmark(bool batched)
+{
+	UDPSocket receiver, sender;
+	SocketName receiver_name = bind_loopback(receiver);
+	bind_loopback(sender);
+
+	PacketBuffers outgoing(batch_size, packet_size), incoming(batch_size, packet_size);
+	for (auto &packet : outgoing.packets)
+	{
+		packet.set_name(receiver_name);
+		packet.size = packet_size;
+	}
+
+	const int rounds = 5000;
+	ubyte64 start_time = System::get_microseconds();
+	int total = 0;
+	SocketName from;
+	for (int round = 0; round < rounds; round++)
+	{
+		if (batched)
+		{
+			sender.send_batch(&outgoing.packets[0], batch_size);
+			total += receive_all(receiver, &incoming.packets[0], batch_size);
+		}
+		else
+		{
+			for (int i = 0; i < batch_size; i++)
+				sender.send(outgoing.packets[i].data, packet_size, receiver_name);
+			for (int i = 0; i < batch_size; i++)
+			{
+				if (receiver.get_read_event().wait(1000))
+				{
+					receiver.receive(incoming.packets[i].data, packet_size, from);
+					total++;
+				}
+			}
+		}
+	}
+	ubyte64 end_time = System::get_microseconds();
+
+	if (total != rounds * batch_size)
+		throw Exception(string_format("Lost %1 datagrams", rounds * batch_size - total));
+	Console::write_line("   %1 %2 kpackets/s", batched ? "send_batch/receive_batch" : "send/receive            ", (int) (total * 1000.0 / (end_time - start_time)));
+}
+
+int main(int, char**)
+{
+	SetupCore setup_core;
+	SetupNetwork setup_network;
+
+	try
+	{
+		test_batch();
+		test_segmentation();
+		test_reuse_port();
+
+		Console::write_line("%1 byte datagrams on loopback, %2 per round:", packet_size, batch_size);
+		benchmark(false);
+		benchmark(true);
+
+		Console::write_line("Tests passed");
+	}
+	catch (Exception &e)
+	{
+		Console::write_line("Failed: %1", e.message);
+		return 1;
+	}
+	return 0;
+}
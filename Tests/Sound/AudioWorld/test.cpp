@@ -0,0 +1,88 @@
+#include <ClanLib/core.h>
+#include <ClanLib/sound.h>
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+using namespace clan;
+
+// Plays 10k looping emitters spread over a large level and walks the listener through it, with and without a real voice budget
+
+float random_float(float max_value)
+{
+	return max_value * (std::rand() / (float)RAND_MAX);
+}
+
+void run(int max_real_voices, float audibility_threshold, const SoundBuffer &sound)
+{
+	const int num_emitters = 10000;
+	const int num_frames = 200;
+	const float level_size = 5000.0f;
+
+	std::srand(1);
+
+	ResourceManager resources;
+	AudioWorld world(resources);
+	world.set_max_real_voices(max_real_voices);
+	world.set_audibility_threshold(audibility_threshold);
+	world.set_listener(Vec3f(0.0f), Quaternionf());
+
+	std::vector<AudioObject> emitters;
+	for (int i = 0; i < num_emitters; i++)
+	{
+		AudioObject emitter(world);
+		emitter.set_sound(sound);
+		emitter.set_position(Vec3f(random_float(level_size), 0.0f, random_float(level_size)));
+		emitter.set_attenuation_begin(10.0f);
+		emitter.set_attenuation_end(200.0f);
+		emitter.set_priority(0.5f + random_float(1.0f));
+		emitter.set_looping(true);
+		emitter.play();
+		emitters.push_back(emitter);
+	}
+
+	int64_t update_time = 0;
+	int64_t real_voices = 0;
+	int64_t virtual_voices = 0;
+	int64_t promoted = 0;
+	int64_t mixed = 0;
+	for (int frame = 0; frame < num_frames; frame++)
+	{
+		float t = frame / (float)num_frames;
+		world.set_listener(Vec3f(t * level_size, 0.0f, level_size * 0.5f), Quaternionf());
+		world.update();
+
+		AudioWorldStats stats = world.get_stats();
+		update_time += stats.update_time;
+		real_voices += stats.real_voices;
+		virtual_voices += stats.virtual_voices;
+		promoted += stats.promoted_voices;
+		mixed += stats.mixed_samples_per_second;
+	}
+
+	std::cout << "Budget " << max_real_voices << ": "
+		<< update_time / num_frames << " us/update, "
+		<< real_voices / num_frames << " real, "
+		<< virtual_voices / num_frames << " virtual, "
+		<< promoted / num_frames << " promoted per update, "
+		<< mixed / num_frames / 1000 << "k samples/s to mix" << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+	SetupCore setup_core;
+	SetupSound setup_sound;
+
+	// Without a sound device the output does not start its mixer thread, so only the voice management is timed
+	SoundOutput output(44100);
+
+	std::vector<short> samples(22050);
+	for (size_t i = 0; i < samples.size(); i++)
+		samples[i] = (short)(std::sin(i * 0.05f) * 8000.0f);
+	SoundBuffer sound(new SoundProvider_Raw(&samples[0], samples.size(), 2, false, 22050));
+
+	run(10000, 0.0f, sound);
+	run(64, 0.001f, sound);
+	run(32, 0.001f, sound);
+
+	return 0;
+}
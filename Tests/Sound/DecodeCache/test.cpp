@@ -0,0 +1,59 @@
+#include <ClanLib/core.h>
+#include <ClanLib/sound.h>
+#include <iostream>
+using namespace clan;
+
+// Starts many sessions of a short Vorbis sound with and without the decoded PCM cache, and streams it through the prefetch worker
+
+ubyte64 start_sessions(SoundBuffer &sound, int count)
+{
+	ubyte64 start_time = System::get_microseconds();
+	for (int i = 0; i < count; i++)
+	{
+		SoundBuffer_Session session = sound.prepare();
+		session.set_volume(0.5f);
+	}
+	return System::get_microseconds() - start_time;
+}
+
+void print_statistics(const std::string &title)
+{
+	SoundStatistics stats = Sound::get_statistics();
+	std::cout << title << ": "
+		<< "decode " << stats.decode_time << " us, "
+		<< "decode on mixer " << stats.mixer_decode_time << " us, "
+		<< "mix " << stats.mix_time << " us (" << stats.mixed_fragments << " fragments), "
+		<< "cache " << stats.pcm_cache_hits << " hits / " << stats.pcm_cache_misses << " misses / " << stats.pcm_cache_memory / 1024 << " KB, "
+		<< stats.prefetch_underruns << " underruns" << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+	SetupCore setup_core;
+	SetupSound setup_sound;
+
+	// Without a sound device the output has no mixer thread, and only the decoding side is measured
+	SoundOutput output(44100);
+
+	const std::string filename = "../../../Examples/Sound/Sound/Resources/cheer1.ogg";
+	const int num_sessions = 200;
+
+	Sound::set_pcm_cache_budget(0);
+	SoundBuffer uncached(filename);
+	ubyte64 uncached_time = start_sessions(uncached, num_sessions);
+	std::cout << "Uncached: " << uncached_time / num_sessions << " us per session start" << std::endl;
+
+	Sound::set_pcm_cache_budget(16 * 1024 * 1024);
+	SoundBuffer cached(filename);
+	ubyte64 first_time = start_sessions(cached, 1);
+	ubyte64 cached_time = start_sessions(cached, num_sessions);
+	std::cout << "Cached: " << first_time << " us to decode, then " << cached_time / num_sessions << " us per session start" << std::endl;
+
+	SoundBuffer streamed(filename, true);
+	SoundBuffer_Session session = streamed.play(true);
+	System::sleep(1000);
+	session.stop();
+
+	print_statistics("Statistics");
+	return 0;
+}
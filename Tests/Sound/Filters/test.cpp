@@ -0,0 +1,209 @@
+#include <ClanLib/core.h>
+#include <ClanLib/sound.h>
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+using namespace clan;
+
+// Checks the sound filters against straightforward implementations and measures their cost in ns per sample
+
+float random_float(float max_value)
+{
+	return max_value * (std::rand() / (float)RAND_MAX);
+}
+
+std::vector<float> random_signal(int length)
+{
+	std::vector<float> signal(length);
+	for (auto &sample : signal)
+		sample = random_float(2.0f) - 1.0f;
+	return signal;
+}
+
+// Feeds the signal to the filter in uneven chunks, like fragments of different sizes would
+std::vector<float> run_filter(SoundFilter &filter, const std::vector<float> &signal)
+{
+	std::vector<float> data = signal;
+	int chunk_sizes[] = { 1, 7, 300, 1024, 33, 4096 };
+	int pos = 0;
+	for (int i = 0; pos < (int)data.size(); i++)
+	{
+		int size = std::min(chunk_sizes[i % 6], (int)data.size() - pos);
+		float *channels[1] = { data.data() + pos };
+		filter.filter(channels, size, 1);
+		pos += size;
+	}
+	return data;
+}
+
+float max_difference(const std::vector<float> &a, const std::vector<float> &b)
+{
+	float diff = 0.0f;
+	for (size_t i = 0; i < a.size(); i++)
+		diff = std::max(diff, std::abs(a[i] - b[i]));
+	return diff;
+}
+
+bool check(const char *name, float diff, float tolerance)
+{
+	std::cout << name << ": max difference " << diff << std::endl;
+	if (diff > tolerance)
+	{
+		std::cout << name << " does not match the reference!" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+std::vector<float> reference_echo(const std::vector<float> &signal, int buffer_size, float shift_factor)
+{
+	std::vector<float> work(buffer_size), result(signal.size());
+	int pos = 0;
+	for (size_t i = 0; i < signal.size(); i++)
+	{
+		work[pos] /= shift_factor;
+		work[pos] += signal[i];
+		result[i] = work[pos];
+		pos = (pos + 1) % buffer_size;
+	}
+	return result;
+}
+
+std::vector<float> reference_inverse_echo(const std::vector<float> &signal, int buffer_size)
+{
+	std::vector<float> work(buffer_size), result(signal.size());
+	int pos = 0;
+	int delay = buffer_size / 4;
+	for (size_t i = 0; i < signal.size(); i++)
+	{
+		work[pos] = signal[i];
+		float res = 0.0f;
+		for (int j = 0; j < 4; j++)
+			res += work[(pos + delay * j) % buffer_size] / (5 - j);
+		result[i] = res;
+		pos = (pos + 1) % buffer_size;
+	}
+	return result;
+}
+
+std::vector<float> reference_convolution(const std::vector<float> &signal, const std::vector<float> &impulse_response, int delay)
+{
+	std::vector<float> result(signal.size());
+	for (int i = delay; i < (int)signal.size(); i++)
+	{
+		double sum = 0.0;
+		for (int j = 0; j < (int)impulse_response.size() && j <= i - delay; j++)
+			sum += signal[i - delay - j] * (double)impulse_response[j];
+		result[i] = (float)sum;
+	}
+	return result;
+}
+
+std::vector<float> create_impulse_response(int length)
+{
+	std::vector<float> impulse_response(length);
+	for (int i = 0; i < length; i++)
+		impulse_response[i] = (random_float(2.0f) - 1.0f) * std::exp(-6.0f * i / length);
+	return impulse_response;
+}
+
+double benchmark(SoundFilter filter, int fragment_size)
+{
+	const int total_samples = 4 * 1024 * 1024;
+	std::vector<float> source = random_signal(fragment_size);
+	std::vector<float> left(fragment_size), right(fragment_size);
+	float *channels[2] = { left.data(), right.data() };
+
+	// The fragment is refilled every time, as filtering the same data over and over would end in denormals
+	ubyte64 start_time = System::get_microseconds();
+	for (int pos = 0; pos < total_samples; pos += fragment_size)
+	{
+		left = source;
+		right = source;
+		filter.filter(channels, fragment_size, 2);
+	}
+	ubyte64 end_time = System::get_microseconds();
+	return (end_time - start_time) * 1000.0 / total_samples;
+}
+
+double benchmark_chain(std::vector<SoundFilter> &chain, int fragment_size, int block_size)
+{
+	const int total_samples = 4 * 1024 * 1024;
+	std::vector<float> source = random_signal(fragment_size);
+	std::vector<float> left(fragment_size), right(fragment_size);
+
+	ubyte64 start_time = System::get_microseconds();
+	for (int pos = 0; pos < total_samples; pos += fragment_size)
+	{
+		left = source;
+		right = source;
+		for (int offset = 0; offset < fragment_size; offset += block_size)
+		{
+			float *channels[2] = { left.data() + offset, right.data() + offset };
+			for (auto &filter : chain)
+				filter.filter(channels, block_size, 2);
+		}
+	}
+	ubyte64 end_time = System::get_microseconds();
+	return (end_time - start_time) * 1000.0 / total_samples;
+}
+
+int main(int argc, char **argv)
+{
+	bool ok = true;
+	std::srand(1);
+	std::vector<float> signal = random_signal(100000);
+
+	EchoFilter echo(5000, 2.0f);
+	ok &= check("Echo", max_difference(run_filter(echo, signal), reference_echo(signal, 5000, 2.0f)), 0.0f);
+
+	InverseEchoFilter inverse_echo(4001);
+	ok &= check("Inverse echo", max_difference(run_filter(inverse_echo, signal), reference_inverse_echo(signal, 4001)), 1.0e-4f);
+
+	FadeFilter fade(0.0f);
+	fade.fade_to_volume(1.0f, 1000);
+	std::vector<float> faded = run_filter(fade, std::vector<float>(signal.size(), 1.0f));
+	float fade_diff = 0.0f;
+	for (int i = 0; i < (int)faded.size(); i++)
+		fade_diff = std::max(fade_diff, std::abs(faded[i] - std::min(i / 22050.0f, 1.0f)));
+	ok &= check("Fade", fade_diff, 1.0e-4f);
+
+	BiquadFilter lowpass(biquad_lowpass, 1000.0f);
+	BiquadFilter highpass(biquad_highpass, 1000.0f);
+	std::vector<float> dc(44100, 1.0f);
+	ok &= check("Low-pass DC gain", std::abs(run_filter(lowpass, dc).back() - 1.0f), 1.0e-3f);
+	ok &= check("High-pass DC gain", std::abs(run_filter(highpass, dc).back()), 1.0e-3f);
+
+	std::vector<float> short_impulse_response = create_impulse_response(3000);
+	std::vector<float> short_signal(signal.begin(), signal.begin() + 20000);
+	ConvolutionReverbFilter reverb(short_impulse_response, 1.0f, 0.0f, 256);
+	ok &= check("Convolution", max_difference(run_filter(reverb, short_signal), reference_convolution(short_signal, short_impulse_response, 256)), 1.0e-3f);
+
+	const int fragment_size = 4096;
+	std::cout << std::endl << "Stereo, " << fragment_size << " samples per fragment:" << std::endl;
+	std::cout << "Echo:                     " << benchmark(EchoFilter(), fragment_size) << " ns/sample" << std::endl;
+	std::cout << "Inverse echo:             " << benchmark(InverseEchoFilter(), fragment_size) << " ns/sample" << std::endl;
+	FadeFilter fading(0.0f);
+	fading.fade_to_volume(1.0f, 1000000);
+	std::cout << "Fade (ramping):           " << benchmark(fading, fragment_size) << " ns/sample" << std::endl;
+	std::cout << "Fade (constant):          " << benchmark(FadeFilter(0.5f), fragment_size) << " ns/sample" << std::endl;
+	std::cout << "Biquad low-pass:          " << benchmark(BiquadFilter(biquad_lowpass, 2000.0f), fragment_size) << " ns/sample" << std::endl;
+	std::cout << "Biquad high-pass:         " << benchmark(BiquadFilter(biquad_highpass, 200.0f), fragment_size) << " ns/sample" << std::endl;
+
+	std::vector<float> impulse_response = create_impulse_response(2 * 44100);
+	int partition_sizes[] = { 256, 512, 2048 };
+	for (int partition_size : partition_sizes)
+		std::cout << "Reverb 2s, partition " << partition_size << ": " << benchmark(ConvolutionReverbFilter(impulse_response, 0.3f, 1.0f, partition_size), fragment_size) << " ns/sample" << std::endl;
+
+	// The same chain as separate passes over the whole fragment and fused into 256 sample blocks
+	std::vector<SoundFilter> chain;
+	chain.push_back(EchoFilter());
+	chain.push_back(BiquadFilter(biquad_lowpass, 2000.0f));
+	chain.push_back(FadeFilter(0.8f));
+	chain.push_back(InverseEchoFilter());
+	int large_fragment = 16 * 1024;
+	std::cout << "Chain of 4, separate:     " << benchmark_chain(chain, large_fragment, large_fragment) << " ns/sample" << std::endl;
+	std::cout << "Chain of 4, fused:        " << benchmark_chain(chain, large_fragment, 256) << " ns/sample" << std::endl;
+
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,137 @@
+#include <ClanLib/core.h>
+#include <ClanLib/application.h>
+#include <ClanLib/display.h>
+#include <ClanLib/gl.h>
+#include <ClanLib/ui.h>
+using namespace clan;
+
+// Builds a view tree with 10k views and times the layout pass after a single label change,
+// compared to a relayout where every measurement has been invalidated
+class App
+{
+public:
+	int start(const std::vector<std::string> &args);
+
+private:
+	std::shared_ptr<View> create_tree(std::vector<std::shared_ptr<LabelView>> &labels);
+	uint64_t time_layout(Canvas &canvas, View *root);
+};
+
+class Program
+{
+public:
+	static int main(const std::vector<std::string> &args)
+	{
+		SetupCore setup_core;
+		SetupDisplay setup_display;
+		SetupGL setup_gl;
+
+		App app;
+		int retval = app.start(args);
+		return retval;
+	}
+};
+
+Application app(&Program::main);
+
+int App::start(const std::vector<std::string> &args)
+{
+	DisplayWindow window("ClanLib Layout Cache Test", 1024, 768);
+	Canvas canvas(window);
+
+	std::vector<std::shared_ptr<LabelView>> labels;
+	std::shared_ptr<View> root = create_tree(labels);
+	root->set_geometry(BoxGeometry::from_margin_box(root->box_style, Rectf(0.0f, 0.0f, 1024.0f, 768.0f)));
+
+	int num_views = 1;
+	std::vector<View *> stack = { root.get() };
+	while (!stack.empty())
+	{
+		View *view = stack.back();
+		stack.pop_back();
+		for (const auto &subview : view->subviews())
+		{
+			stack.push_back(subview.get());
+			num_views++;
+		}
+	}
+
+	uint64_t first_time = time_layout(canvas, root.get());
+
+	const int num_iterations = 100;
+	uint64_t single_change_time = 0;
+	for (int i = 0; i < num_iterations; i++)
+	{
+		labels[(i * 7919) % labels.size()]->set_text(string_format("Changed label %1", i));
+		single_change_time += time_layout(canvas, root.get());
+	}
+
+	const int num_full_iterations = 10;
+	uint64_t full_time = 0;
+	for (int i = 0; i < num_full_iterations; i++)
+	{
+		for (auto &label : labels)
+			label->set_needs_layout();
+		full_time += time_layout(canvas, root.get());
+	}
+
+	Console::write_line("%1 views, %2 labels", num_views, (int)labels.size());
+	Console::write_line("First layout:               %1 us", (int)first_time);
+	Console::write_line("Layout after label change:  %1 us", (int)(single_change_time / num_iterations));
+	Console::write_line("Layout after invalidating all measurements: %1 us", (int)(full_time / num_full_iterations));
+
+	// Style changes made after a layout must reach the cached measurements
+	LabelView *label = labels[0].get();
+	float old_width = label->measure_preferred_width(canvas);
+	label->text_style().set_size(22.0f);
+	float text_style_width = label->measure_preferred_width(canvas);
+	label->box_style.set_width(500.0f);
+	float box_style_width = label->measure_preferred_width(canvas);
+	if (!(text_style_width > old_width) || box_style_width != 500.0f)
+	{
+		Console::write_line("Failed: style changes did not invalidate the cached measurements");
+		return 1;
+	}
+
+	return 0;
+}
+
+std::shared_ptr<View> App::create_tree(std::vector<std::shared_ptr<LabelView>> &labels)
+{
+	auto root = std::make_shared<View>();
+	root->box_style.set_layout_vbox();
+
+	for (int section_index = 0; section_index < 10; section_index++)
+	{
+		auto section = std::make_shared<View>();
+		section->box_style.set_layout_block();
+		section->box_style.set_padding(4.0f);
+		root->add_subview(section);
+
+		for (int row_index = 0; row_index < 30; row_index++)
+		{
+			auto row = std::make_shared<View>();
+			row->box_style.set_layout_hbox();
+			section->add_subview(row);
+
+			for (int cell_index = 0; cell_index < 33; cell_index++)
+			{
+				auto label = std::make_shared<LabelView>();
+				label->text_style().set_font("Sans", 11.0f);
+				label->set_text(string_format("Label %1.%2.%3", section_index, row_index, cell_index));
+				label->box_style.set_flex(1.0f, 1.0f);
+				row->add_subview(label);
+				labels.push_back(label);
+			}
+		}
+	}
+
+	return root;
+}
+
+uint64_t App::time_layout(Canvas &canvas, View *root)
+{
+	uint64_t start_time = System::get_microseconds();
+	root->layout(canvas);
+	return System::get_microseconds() - start_time;
+}
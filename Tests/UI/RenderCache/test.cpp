@@ -0,0 +1,160 @@
+#include <ClanLib/core.h>
+#include <ClanLib/application.h>
+#include <ClanLib/display.h>
+#include <ClanLib/gl.h>
+#include <ClanLib/ui.h>
+using namespace clan;
+
+// Renders a dashboard of mostly static panels where one label changes every frame,
+// with and without the per view render cache, and clipped to the changed label like WindowView does
+// when retained rendering is enabled
+class App
+{
+public:
+	int start(const std::vector<std::string> &args);
+
+private:
+	std::shared_ptr<View> create_dashboard(std::vector<std::shared_ptr<View>> &panels, std::vector<std::shared_ptr<LabelView>> &labels);
+	uint64_t render_frames(Canvas &canvas, DisplayWindow &window, View *root, std::vector<std::shared_ptr<LabelView>> &labels, int num_frames, bool clip_to_damage);
+	static Rect get_damage_box(View *view);
+	void on_window_close();
+
+private:
+	bool quit;
+};
+
+class Program
+{
+public:
+	static int main(const std::vector<std::string> &args)
+	{
+		SetupCore setup_core;
+		SetupDisplay setup_display;
+		SetupGL setup_gl;
+
+		App app;
+		int retval = app.start(args);
+		return retval;
+	}
+};
+
+Application app(&Program::main);
+
+int App::start(const std::vector<std::string> &args)
+{
+	quit = false;
+
+	DisplayWindow window("ClanLib Render Cache Test", 1024, 768);
+	Slot slot_quit = window.sig_window_close().connect(this, &App::on_window_close);
+	Canvas canvas(window);
+
+	std::vector<std::shared_ptr<View>> panels;
+	std::vector<std::shared_ptr<LabelView>> labels;
+	std::shared_ptr<View> root = create_dashboard(panels, labels);
+	root->set_geometry(BoxGeometry::from_margin_box(root->box_style, Rectf(0.0f, 0.0f, 1024.0f, 768.0f)));
+	root->layout(canvas);
+
+	const int num_frames = 200;
+	uint64_t uncached_time = render_frames(canvas, window, root.get(), labels, num_frames, false);
+
+	for (auto &panel : panels)
+		panel->set_render_cache_enabled();
+	uint64_t cached_time = render_frames(canvas, window, root.get(), labels, num_frames, false);
+
+	int hits = 0;
+	int misses = 0;
+	for (auto &panel : panels)
+	{
+		hits += panel->render_cache_hits();
+		misses += panel->render_cache_misses();
+	}
+
+	for (auto &panel : panels)
+		panel->set_render_cache_enabled(false);
+	uint64_t clipped_time = render_frames(canvas, window, root.get(), labels, num_frames, true);
+
+	Console::write_line("%1 panels, %2 labels, one label changed per frame", (int)panels.size(), (int)labels.size());
+	Console::write_line("Without render cache: %1 us/frame", (int)(uncached_time / num_frames));
+	Console::write_line("With render cache:    %1 us/frame, %2 hits, %3 misses", (int)(cached_time / num_frames), hits, misses);
+	Console::write_line("Clipped to the damage: %1 us/frame", (int)(clipped_time / num_frames));
+
+	return 0;
+}
+
+std::shared_ptr<View> App::create_dashboard(std::vector<std::shared_ptr<View>> &panels, std::vector<std::shared_ptr<LabelView>> &labels)
+{
+	auto root = std::make_shared<View>();
+	root->box_style.set_layout_vbox();
+
+	for (int row_index = 0; row_index < 8; row_index++)
+	{
+		auto row = std::make_shared<View>();
+		row->box_style.set_layout_hbox();
+		row->box_style.set_flex(1.0f, 1.0f);
+		root->add_subview(row);
+
+		for (int column_index = 0; column_index < 8; column_index++)
+		{
+			auto panel = std::make_shared<View>();
+			panel->box_style.set_layout_block();
+			panel->box_style.set_flex(1.0f, 1.0f);
+			panel->box_style.set_margin(2.0f);
+			panel->box_style.set_padding(4.0f);
+			panel->box_style.set_background(Colorf(240, 240, 240));
+			panel->box_style.set_border(Colorf(200, 200, 200), 1.0f);
+			row->add_subview(panel);
+			panels.push_back(panel);
+
+			for (int line_index = 0; line_index < 6; line_index++)
+			{
+				auto label = std::make_shared<LabelView>();
+				label->text_style().set_font("Sans", 11.0f);
+				label->text_style().set_color(Colorf::black);
+				label->set_text(string_format("Value %1.%2: %3", row_index, column_index, line_index * 17));
+				panel->add_subview(label);
+				labels.push_back(label);
+			}
+		}
+	}
+
+	return root;
+}
+
+uint64_t App::render_frames(Canvas &canvas, DisplayWindow &window, View *root, std::vector<std::shared_ptr<LabelView>> &labels, int num_frames, bool clip_to_damage)
+{
+	uint64_t total_time = 0;
+	for (int frame = 0; frame < num_frames && !quit; frame++)
+	{
+		LabelView *label = labels[(frame * 7919) % labels.size()].get();
+		label->set_text(string_format("Changed %1", frame));
+
+		uint64_t start_time = System::get_microseconds();
+		root->layout(canvas);
+		if (clip_to_damage)
+			canvas.set_cliprect(get_damage_box(label));
+		canvas.clear(Colorf::white);
+		root->render(canvas);
+		canvas.reset_cliprect();
+		canvas.flush();
+		window.get_gc().flush();
+		total_time += System::get_microseconds() - start_time;
+
+		window.flip(0);
+		KeepAlive::process();
+	}
+	return total_time;
+}
+
+// Border box of the view in the coordinate system of the root view, as set_needs_render reports it
+Rect App::get_damage_box(View *view)
+{
+	Rectf box = view->geometry().border_box();
+	for (View *parent = view->superview(); parent; parent = parent->superview())
+		box.translate(parent->geometry().content.get_top_left());
+	return Rect((int)std::floor(box.left), (int)std::floor(box.top), (int)std::ceil(box.right), (int)std::ceil(box.bottom));
+}
+
+void App::on_window_close()
+{
+	quit = true;
+}